@@ -0,0 +1,411 @@
+/*
+    pybind11/async.h: Binding C++ functions as awaitables, which run on an executor with the
+    GIL released
+
+    Copyright (c) 2024 The pybind Community.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE file.
+*/
+
+#pragma once
+
+#include "pybind11.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+PYBIND11_NAMESPACE_BEGIN(PYBIND11_NAMESPACE)
+
+/// Runs the C++ functions bound with `module_::def_async()`. `submit()` is called with the GIL
+/// held, and must run every task it is given exactly once, on a thread other than the caller.
+/// The tasks acquire the GIL themselves when they complete.
+class executor {
+public:
+    executor() = default;
+    executor(const executor &) = delete;
+    executor &operator=(const executor &) = delete;
+    virtual ~executor() = default;
+
+    virtual void submit(std::function<void()> task) = 0;
+};
+
+/// An executor running the tasks on a fixed number of threads, in the order they were submitted
+class thread_pool_executor : public executor {
+public:
+    explicit thread_pool_executor(size_t num_threads = std::thread::hardware_concurrency()) {
+        num_threads = (std::max)(num_threads, size_t{1});
+        m_threads.reserve(num_threads);
+        for (size_t i = 0; i < num_threads; ++i) {
+            m_threads.emplace_back([this]() { work(); });
+        }
+    }
+
+    /// Waits for the tasks submitted before. Completing them needs the GIL, so the pool must not
+    /// be destroyed while the GIL is held (e.g. use `gil_scoped_release`).
+    ~thread_pool_executor() override {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_ready.notify_all();
+        for (auto &thread : m_threads) {
+            thread.join();
+        }
+    }
+
+    void submit(std::function<void()> task) override {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_tasks.push_back(std::move(task));
+        }
+        m_ready.notify_one();
+    }
+
+    size_t num_threads() const { return m_threads.size(); }
+
+private:
+    void work() {
+        for (;;) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_ready.wait(lock, [this]() { return m_stopping || !m_tasks.empty(); });
+                if (m_tasks.empty()) {
+                    return;
+                }
+                task = std::move(m_tasks.front());
+                m_tasks.pop_front();
+            }
+            task();
+        }
+    }
+
+    std::mutex m_mutex;
+    std::condition_variable m_ready;
+    std::deque<std::function<void()>> m_tasks;
+    bool m_stopping = false;
+    std::vector<std::thread> m_threads;
+};
+
+/// Runs work that needs the GIL, submitted from any number of C++ threads, in batches: rather
+/// than every thread acquiring the GIL for its own call, one consumer acquires it once and runs
+/// everything that was queued meanwhile. The consumer is a thread of the executor, or, for an
+/// executor constructed with `own_thread = false`, whoever calls `drain()` with the GIL held
+/// (e.g. a periodic callback of an asyncio event loop). `submit()` and `call()` never need the
+/// GIL; they push the work onto a lock-free list and return a `std::future` of its result.
+class python_executor {
+public:
+    explicit python_executor(bool own_thread = true) {
+        if (own_thread) {
+            m_thread = std::thread([this]() { work(); });
+        }
+    }
+
+    python_executor(const python_executor &) = delete;
+    python_executor &operator=(const python_executor &) = delete;
+
+    /// Runs the work submitted before, with an own thread. Since that needs the GIL, the executor
+    /// must not be destroyed while the GIL is held (e.g. use `gil_scoped_release`). Without an
+    /// own thread, work that was not drained is dropped, and its futures report a broken promise.
+    ~python_executor() {
+        if (m_thread.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stopping = true;
+            }
+            m_ready.notify_one();
+            m_thread.join();
+        }
+        delete_tasks(m_head.exchange(nullptr));
+    }
+
+    /// Queues `f()` to be run with the GIL held; its result or exception is passed to the future
+    template <typename F>
+    auto submit(F &&f) -> std::future<decltype(f())> {
+        using Return = decltype(f());
+        auto packaged = std::make_shared<std::packaged_task<Return()>>(std::forward<F>(f));
+        auto future = packaged->get_future();
+        push(new task{[packaged]() { (*packaged)(); }, nullptr});
+        return future;
+    }
+
+    /// Queues a call of the Python callable `fn` with `args`, which are copied and converted to
+    /// Python in the consumer, as is the result to `Return`. `fn` is borrowed and must stay alive
+    /// until the call has run.
+    template <typename Return = void, typename... Args>
+    std::future<Return> call(handle fn, Args &&...args) {
+        static_assert(!detail::is_pyobject<Return>::value,
+                      "python_executor::call() returns C++ values, which can be used without "
+                      "the GIL");
+        auto arguments = std::make_tuple(std::forward<Args>(args)...);
+        return submit([fn, arguments]() -> Return {
+            return call_with(fn, arguments, detail::make_index_sequence<sizeof...(Args)>{})
+                .template cast<Return>();
+        });
+    }
+
+    /// Runs the queued work, and the work queued meanwhile, until there is none left, and
+    /// returns how many calls were run. The GIL must be held.
+    size_t drain() {
+        size_t count = 0;
+        while (task *batch = take_all()) {
+            while (batch != nullptr) {
+                std::unique_ptr<task> current(batch);
+                batch = batch->next;
+                current->run();
+                ++count;
+            }
+        }
+        return count;
+    }
+
+private:
+    struct task {
+        std::function<void()> run;
+        task *next;
+    };
+
+    template <typename Tuple, size_t... Is>
+    static object call_with(handle fn, const Tuple &arguments, detail::index_sequence<Is...>) {
+        return fn(std::get<Is>(arguments)...);
+    }
+
+    void push(task *t) {
+        task *head = m_head.load(std::memory_order_relaxed);
+        do {
+            t->next = head;
+        } while (!m_head.compare_exchange_weak(
+            head, t, std::memory_order_release, std::memory_order_relaxed));
+        // Only the first task after the consumer has emptied the list needs to wake it up
+        if (head == nullptr && m_thread.joinable()) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_ready.notify_one();
+        }
+    }
+
+    /// Takes the whole list at once, reversed into the order in which the tasks were submitted
+    task *take_all() {
+        task *t = m_head.exchange(nullptr, std::memory_order_acquire);
+        task *ordered = nullptr;
+        while (t != nullptr) {
+            task *next = t->next;
+            t->next = ordered;
+            ordered = t;
+            t = next;
+        }
+        return ordered;
+    }
+
+    static void delete_tasks(task *t) {
+        while (t != nullptr) {
+            task *next = t->next;
+            delete t;
+            t = next;
+        }
+    }
+
+    void work() {
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_ready.wait(lock, [this]() {
+                    return m_stopping || m_head.load(std::memory_order_acquire) != nullptr;
+                });
+                if (m_stopping && m_head.load(std::memory_order_acquire) == nullptr) {
+                    return;
+                }
+            }
+            gil_scoped_acquire gil;
+            drain();
+        }
+    }
+
+    std::atomic<task *> m_head{nullptr};
+    std::mutex m_mutex;
+    std::condition_variable m_ready;
+    bool m_stopping = false;
+    std::thread m_thread;
+};
+
+/// Annotation for `module_::def_async()`: runs the function on the given executor, which must
+/// outlive the function, rather than on the default thread pool
+struct async_executor {
+    executor *value;
+    explicit async_executor(executor &value) : value(&value) {}
+};
+
+PYBIND11_NAMESPACE_BEGIN(detail)
+
+template <>
+struct process_attribute<async_executor> : process_attribute_default<async_executor> {};
+
+/// The thread pool running `def_async` functions without an `async_executor`, with a thread per
+/// core. Like the internals, it is never destroyed: its threads may still need the GIL when
+/// static objects are destroyed.
+inline executor &get_default_executor() {
+    static auto *pool = new thread_pool_executor();
+    return *pool;
+}
+
+inline executor *find_async_executor() { return nullptr; }
+
+template <typename... Extra>
+executor *find_async_executor(const async_executor &annotation, const Extra &...) {
+    return annotation.value;
+}
+
+template <typename T, typename... Extra>
+executor *find_async_executor(const T &, const Extra &...extra) {
+    return find_async_executor(extra...);
+}
+
+/// Returns the Python exception that `error` is translated into when it leaves a bound function
+inline object exception_to_python(const std::exception_ptr &error) {
+    try {
+        cpp_function([error]() { std::rethrow_exception(error); })();
+    } catch (error_already_set &e) {
+        return e.value();
+    }
+    pybind11_fail("exception_to_python(): the exception was not translated");
+}
+
+/// The Python side of a call to a `def_async` function: its `asyncio.Future`, and the event loop
+/// the future belongs to
+struct async_completion {
+    object loop;
+    object future;
+
+    /// Sets the result of the future (or its exception, if `failed`) from the thread running the
+    /// event loop, unless it was cancelled meanwhile. Called with the GIL held; drops the
+    /// references to the loop and the future, so that they are not released without the GIL.
+    void complete(const object &value, bool failed) {
+        cpp_function set_unless_done([](const object &future, const object &value, bool failed) {
+            if (!future.attr("done")().cast<bool>()) {
+                future.attr(failed ? "set_exception" : "set_result")(value);
+            }
+        });
+        try {
+            loop.attr("call_soon_threadsafe")(set_unless_done, future, value, failed);
+        } catch (error_already_set &e) {
+            // The event loop was closed before the call completed
+            e.discard_as_unraisable("pybind11::detail::async_completion::complete");
+        }
+        loop = object();
+        future = object();
+    }
+};
+
+/// The result of the C++ function, which is kept until the GIL is acquired to cast it
+template <typename Return>
+struct async_result {
+    std::unique_ptr<Return> value;
+
+    template <typename Func, typename Tuple, size_t... Is>
+    void run(Func &f, Tuple &args, index_sequence<Is...>) {
+        value.reset(new Return(f(std::move(std::get<Is>(args))...)));
+    }
+
+    object cast() {
+        return reinterpret_steal<object>(make_caster<Return>::cast(
+            std::move(*value), return_value_policy::automatic, handle()));
+    }
+};
+
+template <>
+struct async_result<void> {
+    template <typename Func, typename Tuple, size_t... Is>
+    void run(Func &f, Tuple &args, index_sequence<Is...>) {
+        f(std::move(std::get<Is>(args))...);
+    }
+
+    object cast() { return none(); }
+};
+
+/// A call to a `def_async` function, with copies of its arguments
+template <typename Func, typename Return, typename... Args>
+struct async_call : async_completion {
+    Func f;
+    std::tuple<typename std::decay<Args>::type...> args;
+    async_result<typename std::decay<Return>::type> result;
+
+    template <typename... CallArgs>
+    async_call(const Func &f, object loop, object future, CallArgs &&...call_args)
+        : async_completion{std::move(loop), std::move(future)}, f(f),
+          args(std::forward<CallArgs>(call_args)...) {}
+
+    /// Runs the function on the calling thread, which must not hold the GIL
+    void run() {
+        std::exception_ptr error;
+        try {
+            result.run(f, args, make_index_sequence<sizeof...(Args)>());
+        } catch (...) {
+            error = std::current_exception();
+        }
+        gil_scoped_acquire gil;
+        object value;
+        if (!error) {
+            try {
+                value = result.cast();
+            } catch (...) {
+                error = std::current_exception();
+            }
+        }
+        if (error) {
+            complete(exception_to_python(error), true);
+        } else {
+            complete(value, false);
+        }
+    }
+};
+
+/// The function that `module_::def_async()` binds in place of `Func`: it submits the call to the
+/// executor and returns an `asyncio.Future` for its result
+template <typename Func, typename Return, typename... Args>
+class async_function<Func, Return(Args...)> {
+    static_assert(!any_of<std::is_base_of<handle, intrinsic_t<Args>>...>::value,
+                  "def_async() functions run without the GIL and cannot take Python objects");
+    static_assert(
+        !any_of<all_of<std::is_lvalue_reference<Args>,
+                       negation<std::is_const<remove_reference_t<Args>>>>...>::value,
+        "def_async() functions get copies of their arguments and cannot take non-const "
+        "references");
+    static_assert(!any_of<std::is_pointer<remove_reference_t<Args>>...>::value,
+                  "def_async() functions run after the call returns and cannot take pointers into "
+                  "the caller's objects");
+    static_assert(!std::is_base_of<handle, intrinsic_t<Return>>::value,
+                  "def_async() functions run without the GIL and cannot return Python objects");
+
+public:
+    template <typename F, typename... Extra>
+    explicit async_function(F &&f, const Extra &...extra)
+        : m_f(std::forward<F>(f)), m_executor(find_async_executor(extra...)) {}
+
+    object operator()(Args... args) const {
+        object loop = module_::import("asyncio").attr("get_running_loop")();
+        object future = loop.attr("create_future")();
+        auto call = std::make_shared<async_call<Func, Return, Args...>>(
+            m_f, loop, future, std::forward<Args>(args)...);
+        executor &exec = m_executor != nullptr ? *m_executor : get_default_executor();
+        exec.submit([call]() { call->run(); });
+        return future;
+    }
+
+private:
+    Func m_f;
+    executor *m_executor;
+};
+
+PYBIND11_NAMESPACE_END(detail)
+PYBIND11_NAMESPACE_END(PYBIND11_NAMESPACE)
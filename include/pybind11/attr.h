@@ -78,6 +78,14 @@ struct multiple_inheritance {};
 /// Annotation which enables dynamic attributes, i.e. adds `__dict__` to a class
 struct dynamic_attr {};
 
+/// Annotation which reserves attributes with the given names in the instances of a class, like
+/// `__slots__` in Python: the values are stored at fixed offsets inside the instance, which needs
+/// less memory than a `__dict__` and is faster to access
+struct slots {
+    std::vector<const char *> names;
+    slots(std::initializer_list<const char *> names) : names(names) {}
+};
+
 /// Annotation which enables the buffer protocol for a type
 struct buffer_protocol {};
 
@@ -115,9 +123,57 @@ struct module_local {
     constexpr explicit module_local(bool v = true) : value(v) {}
 };
 
+/// Annotation for value-like classes whose instances should not be tracked in pybind11's
+/// registry of C++ pointers to Python instances. This makes creating and destroying instances
+/// cheaper, but returning a pointer or reference to an existing C++ object then always creates
+/// a new Python object, and pybind11 will not find Python overrides of virtual functions.
+/// Ignored unless `PYBIND11_INTERNALS_VERSION` is 6 or higher.
+struct no_instance_registry {};
+
+/// Annotation for classes whose instances can not be part of a reference cycle, i.e. hold no
+/// references to Python objects. Their type is guaranteed not to be tracked by Python's cyclic
+/// garbage collector, so that large numbers of instances do not slow down its collections.
+/// Registering the class fails if it has a `__dict__` (`py::dynamic_attr()`) or its type would
+/// otherwise be garbage collected.
+struct no_gc {};
+
+/// Annotation for classes whose instances should store the C++ value inside the Python object,
+/// instead of in a separate heap allocation, when pybind11 creates the value itself (by
+/// constructing it with `py::init<...>()` or by copying or moving a returned value). Only has an
+/// effect for classes with the default `std::unique_ptr` holder, no trampoline class, at most one
+/// base class and an alignment of at most 8; otherwise it is ignored. Also ignored unless
+/// `PYBIND11_INTERNALS_VERSION` is 6 or higher.
+struct inline_storage {};
+
+/// Annotation for `py::init<Args...>()` on a final class: calling the class with exactly the
+/// positional arguments of the constructor creates the instance and constructs the C++ object
+/// directly, without going through `__init__` and the function dispatcher. Other calls (keyword
+/// arguments, a different number of arguments) are unaffected. The annotation is ignored if the
+/// class has other `__init__` overloads, and on Python < 3.9 and PyPy.
+struct fast_init {};
+
+/// Annotation for `def_readwrite()` and `def_readonly()` of arithmetic and `bool` members: the
+/// attribute is a descriptor which reads and writes the member at its offset in the C++ value,
+/// like the member descriptors of built-in types, instead of a property calling getter and setter
+/// functions. With `def_readwrite_static()` and `def_readonly_static()`, the descriptor reads and
+/// writes the static variable at its address. Ignored on PyPy.
+struct native_member {};
+
+/// Annotation for `def_readonly_static()`: the value is converted once, when the attribute is
+/// defined, and stored in the class dictionary, so that reading it is a plain attribute lookup.
+/// Only for constants: later changes of the C++ variable are not seen from Python, and assigning
+/// the attribute replaces it instead of raising an error.
+struct static_constant {};
+
 /// Annotation to mark enums as an arithmetic type
 struct arithmetic {};
 
+/// Annotation for `py::enum_`: casting a C++ value which has been added with `value()` to Python
+/// returns the object of that value instead of a new instance, and comparisons, `hash()` and
+/// `int()` of values read the C++ value in the type slots instead of calling the methods (except
+/// on PyPy).
+struct fast_enum {};
+
 /// Mark a function for addition at the beginning of the existing overload chain instead of the end
 struct prepend {};
 
@@ -173,12 +229,14 @@ struct undefined_t;
 template <op_id id, op_type ot, typename L = undefined_t, typename R = undefined_t>
 struct op_;
 void keep_alive_impl(size_t Nurse, size_t Patient, function_call &call, handle ret);
+struct overload_cache;
 
 /// Internal data structure which holds metadata about a keyword argument
 struct argument_record {
     const char *name;  ///< Argument name
     const char *descr; ///< Human-readable version of the argument value
     handle value;      ///< Associated Python object
+    handle name_obj;   ///< Interned Python string of the name (set when the function is created)
     bool convert : 1;  ///< True if the argument is allowed to convert when loading
     bool none : 1;     ///< True if None is allowed when loading
 
@@ -192,7 +250,8 @@ struct function_record {
     function_record()
         : is_constructor(false), is_new_style_constructor(false), is_stateless(false),
           is_operator(false), is_method(false), is_setter(false), has_args(false),
-          has_kwargs(false), prepend(false) {}
+          has_kwargs(false), prepend(false), loads_by_type(false), returns_error(false),
+          show_signatures(false), show_user_docstrings(false) {}
 
     /// Function name
     char *name = nullptr; /* why no C++ strings? They generate heavier code.. */
@@ -200,9 +259,13 @@ struct function_record {
     // User-specified documentation string
     char *doc = nullptr;
 
-    /// Human-readable version of the function signature
+    /// Human-readable version of the function signature, generated when it is first needed
     char *signature = nullptr;
 
+    /// The `descr` text and types that `signature` is generated from
+    const char *signature_text = nullptr;
+    const std::type_info *const *signature_types = nullptr;
+
     /// List of registered keyword arguments
     std::vector<argument_record> args;
 
@@ -245,6 +308,18 @@ struct function_record {
     /// True if this function is to be inserted at the beginning of the overload resolution chain
     bool prepend : 1;
 
+    /// True if loading the arguments without conversions only depends on their Python types
+    bool loads_by_type : 1;
+
+    /// True if the return value can be an error which is raised as it is when the conversion to
+    /// Python fails with a Python error set (see `casts_to_error`)
+    bool returns_error : 1;
+
+    /// The `options` in effect when the last overload was added, which apply to the docstring of
+    /// the overload chain; only used in its first record
+    bool show_signatures : 1;
+    bool show_user_docstrings : 1;
+
     /// Number of arguments (including py::args and/or py::kwargs, if present)
     std::uint16_t nargs;
 
@@ -266,13 +341,17 @@ struct function_record {
 
     /// Pointer to next overload
     function_record *next = nullptr;
+
+    /// Overload resolution cache, only used in the first record of an overload chain
+    overload_cache *cache = nullptr;
 };
 
 /// Special data structure which (temporarily) holds metadata about a bound class
 struct type_record {
     PYBIND11_NOINLINE type_record()
         : multiple_inheritance(false), dynamic_attr(false), buffer_protocol(false),
-          default_holder(true), module_local(false), is_final(false) {}
+          default_holder(true), module_local(false), is_final(false),
+          no_instance_registry(false), inline_storage(false), no_gc(false) {}
 
     /// Handle to the parent scope
     handle scope;
@@ -313,6 +392,9 @@ struct type_record {
     /// Custom type setup.
     custom_type_setup::callback custom_type_setup_callback;
 
+    /// Names of the attribute slots reserved in the instances
+    std::vector<const char *> slot_names;
+
     /// Multiple inheritance marker
     bool multiple_inheritance : 1;
 
@@ -331,6 +413,15 @@ struct type_record {
     /// Is the class inheritable from python classes?
     bool is_final : 1;
 
+    /// Are the instances of the class kept out of the instance registry?
+    bool no_instance_registry : 1;
+
+    /// Are values stored inside the instances of the class?
+    bool inline_storage : 1;
+
+    /// Must the instances of the class stay out of the garbage collector?
+    bool no_gc : 1;
+
     PYBIND11_NOINLINE void add_base(const std::type_info &base, void *(*caster)(void *) ) {
         auto *base_info = detail::get_type_info(base, false);
         if (!base_info) {
@@ -576,6 +667,13 @@ struct process_attribute<dynamic_attr> : process_attribute_default<dynamic_attr>
     static void init(const dynamic_attr &, type_record *r) { r->dynamic_attr = true; }
 };
 
+template <>
+struct process_attribute<slots> : process_attribute_default<slots> {
+    static void init(const slots &s, type_record *r) {
+        r->slot_names.insert(r->slot_names.end(), s.names.begin(), s.names.end());
+    }
+};
+
 template <>
 struct process_attribute<custom_type_setup> {
     static void init(const custom_type_setup &value, type_record *r) {
@@ -603,6 +701,35 @@ struct process_attribute<module_local> : process_attribute_default<module_local>
     static void init(const module_local &l, type_record *r) { r->module_local = l.value; }
 };
 
+template <>
+struct process_attribute<no_instance_registry> : process_attribute_default<no_instance_registry> {
+    static void init(const no_instance_registry &, type_record *r) {
+        r->no_instance_registry = true;
+    }
+};
+
+template <>
+struct process_attribute<inline_storage> : process_attribute_default<inline_storage> {
+    static void init(const inline_storage &, type_record *r) { r->inline_storage = true; }
+};
+
+template <>
+struct process_attribute<no_gc> : process_attribute_default<no_gc> {
+    static void init(const no_gc &, type_record *r) { r->no_gc = true; }
+};
+
+/// Process a 'fast_init' attribute (handled by `py::init` itself)
+template <>
+struct process_attribute<fast_init> : process_attribute_default<fast_init> {};
+
+/// Process a 'native_member' attribute (handled by `def_readwrite()` and `def_readonly()`)
+template <>
+struct process_attribute<native_member> : process_attribute_default<native_member> {};
+
+/// Process a 'static_constant' attribute (handled by `def_readonly_static()`)
+template <>
+struct process_attribute<static_constant> : process_attribute_default<static_constant> {};
+
 /// Process a 'prepend' attribute, putting this at the beginning of the overload chain
 template <>
 struct process_attribute<prepend> : process_attribute_default<prepend> {
@@ -613,6 +740,10 @@ struct process_attribute<prepend> : process_attribute_default<prepend> {
 template <>
 struct process_attribute<arithmetic> : process_attribute_default<arithmetic> {};
 
+/// Process a 'fast_enum' attribute for enums (does nothing here)
+template <>
+struct process_attribute<fast_enum> : process_attribute_default<fast_enum> {};
+
 template <typename... Ts>
 struct process_attribute<call_guard<Ts...>> : process_attribute_default<call_guard<Ts...>> {};
 
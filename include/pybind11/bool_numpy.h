@@ -0,0 +1,218 @@
+/*
+    pybind11/bool_numpy.h: Conversion of std::vector<bool> and std::bitset (as py::bool_array)
+    to and from NumPy bool arrays, and packing of bools into bytes
+
+    Copyright (c) 2024 The pybind Community.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE file.
+*/
+
+#pragma once
+
+#include "numpy.h"
+
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+PYBIND11_NAMESPACE_BEGIN(PYBIND11_NAMESPACE)
+
+/** \rst
+    A ``std::vector<bool>`` or ``std::bitset<N>`` that is converted to and from a one-dimensional
+    ``numpy.bool_`` array (one byte per element), without a Python ``bool`` per element. It is
+    loaded from any one-dimensional buffer of bools or bytes in the same way, where every nonzero
+    byte is ``true``. With conversions allowed, other NumPy arrays are converted to bools by NumPy
+    first, and other sequences are loaded element by element. A ``std::bitset<N>`` only loads
+    sequences of exactly ``N`` items.
+\endrst */
+template <typename Bits>
+class bool_array {
+public:
+    bool_array() = default;
+    explicit bool_array(Bits value) : value_(std::move(value)) {}
+
+    Bits &get() { return value_; }
+    const Bits &get() const { return value_; }
+    Bits &operator*() { return value_; }
+    const Bits &operator*() const { return value_; }
+    Bits *operator->() { return &value_; }
+    const Bits *operator->() const { return &value_; }
+
+private:
+    Bits value_;
+};
+
+/// Wraps `bits` to be returned as a `numpy.bool_` array
+template <typename Bits>
+bool_array<Bits> as_bool_array(Bits bits) {
+    return bool_array<Bits>(std::move(bits));
+}
+
+PYBIND11_NAMESPACE_BEGIN(detail)
+
+template <typename Alloc>
+bool resize_bools(std::vector<bool, Alloc> &bits, size_t size) {
+    bits.assign(size, false);
+    return true;
+}
+template <size_t N>
+bool resize_bools(std::bitset<N> &bits, size_t size) {
+    bits.reset();
+    return size == N;
+}
+
+/// Loads a one-dimensional buffer of bools or bytes (NumPy `bool_` and `uint8` arrays, `bytes`,
+/// `memoryview`, ...) with one read per item; any nonzero byte is taken as `true`
+template <typename Bits>
+bool load_bool_buffer(handle src, Bits &bits) {
+    if (!PyObject_CheckBuffer(src.ptr())) {
+        return false;
+    }
+    auto *view = new Py_buffer();
+    if (PyObject_GetBuffer(src.ptr(), view, PyBUF_FORMAT | PyBUF_STRIDES) != 0) {
+        delete view;
+        PyErr_Clear();
+        return false;
+    }
+    buffer_info info(view);
+    if (info.ndim != 1
+        || !(info.item_type_is_equivalent_to<bool>()
+             || info.item_type_is_equivalent_to<std::uint8_t>())) {
+        return false;
+    }
+    const auto size = static_cast<size_t>(info.shape[0]);
+    if (!resize_bools(bits, size)) {
+        return false;
+    }
+    const auto stride = info.strides[0];
+    const auto *data = static_cast<const unsigned char *>(info.ptr);
+    for (size_t i = 0; i < size; ++i) {
+        if (data[static_cast<ssize_t>(i) * stride] != 0) {
+            bits[i] = true;
+        }
+    }
+    return true;
+}
+
+template <typename Bits>
+class type_caster<bool_array<Bits>> {
+    using value_conv = make_caster<bool>;
+
+public:
+    bool load(handle src, bool convert) {
+        Bits &bits = *value;
+        if (load_bool_buffer(src, bits)) {
+            return true;
+        }
+        if (convert && is_loaded_numpy_array(src)) {
+            auto arr = array_t<bool, array::forcecast>::ensure(src);
+            return arr && load_bool_buffer(arr, bits);
+        }
+        if (!isinstance<sequence>(src) || isinstance<str>(src)) {
+            return false;
+        }
+        auto s = reinterpret_borrow<sequence>(src);
+        if (!resize_bools(bits, s.size())) {
+            return false;
+        }
+        size_t i = 0;
+        for (auto it : s) {
+            value_conv conv;
+            if (!conv.load(it, convert)) {
+                return false;
+            }
+            bits[i++] = cast_op<bool>(conv);
+        }
+        return true;
+    }
+
+    static handle
+    cast(const bool_array<Bits> &src, return_value_policy /* policy */, handle /* parent */) {
+        const size_t size = src->size();
+        array_t<bool> arr(static_cast<ssize_t>(size));
+        bool *out = arr.mutable_data();
+        for (size_t i = 0; i < size; ++i) {
+            out[i] = (*src)[i];
+        }
+        return arr.release();
+    }
+
+    PYBIND11_TYPE_CASTER(bool_array<Bits>, handle_type_name<array_t<bool>>::name);
+};
+
+template <typename Bits>
+array_t<std::uint8_t> pack_bools(const Bits &bits) {
+    const size_t size = bits.size();
+    array_t<std::uint8_t> packed(static_cast<ssize_t>((size + 7) / 8));
+    std::uint8_t *out = packed.mutable_data();
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        *out++ = static_cast<std::uint8_t>(
+            (unsigned(bits[i]) << 7) | (unsigned(bits[i + 1]) << 6) | (unsigned(bits[i + 2]) << 5)
+            | (unsigned(bits[i + 3]) << 4) | (unsigned(bits[i + 4]) << 3)
+            | (unsigned(bits[i + 5]) << 2) | (unsigned(bits[i + 6]) << 1) | unsigned(bits[i + 7]));
+    }
+    if (i < size) {
+        unsigned byte = 0;
+        for (unsigned shift = 7; i < size; ++i, --shift) {
+            byte |= unsigned(bits[i]) << shift;
+        }
+        *out = static_cast<std::uint8_t>(byte);
+    }
+    return packed;
+}
+
+PYBIND11_NAMESPACE_END(detail)
+
+/// Packs bools into bytes like `numpy.packbits`: eight per byte, the first one in the most
+/// significant bit, and the last byte padded with zeros
+template <typename Alloc>
+array_t<std::uint8_t> pack_bits(const std::vector<bool, Alloc> &bits) {
+    return detail::pack_bools(bits);
+}
+template <size_t N>
+array_t<std::uint8_t> pack_bits(const std::bitset<N> &bits) {
+    return detail::pack_bools(bits);
+}
+
+/// Unpacks the bytes of `packed` into a `numpy.bool_` array like `numpy.unpackbits`, the most
+/// significant bit first. Only the first `count` bits are kept, or all of them if `count` is
+/// negative; throws if `packed` has fewer bits than that.
+inline array_t<bool>
+unpack_bits(const array_t<std::uint8_t, array::c_style | array::forcecast> &packed,
+            ssize_t count = -1) {
+    const ssize_t available = packed.size() * 8;
+    if (count < 0) {
+        count = available;
+    } else if (count > available) {
+        throw value_error("unpack_bits(): " + std::to_string(packed.size())
+                          + " bytes do not hold " + std::to_string(count) + " bits");
+    }
+    // Each byte is expanded into its eight bools at once, from a table built on first use
+    static const auto table = [] {
+        std::array<std::array<std::uint8_t, 8>, 256> result{};
+        for (unsigned byte = 0; byte < 256; ++byte) {
+            for (unsigned bit = 0; bit < 8; ++bit) {
+                result[byte][bit] = static_cast<std::uint8_t>((byte >> (7 - bit)) & 1u);
+            }
+        }
+        return result;
+    }();
+    array_t<bool> bits(count);
+    auto *out = reinterpret_cast<unsigned char *>(bits.mutable_data());
+    const std::uint8_t *in = packed.data();
+    const ssize_t whole = count / 8;
+    for (ssize_t i = 0; i < whole; ++i) {
+        std::memcpy(out + i * 8, table[in[i]].data(), 8);
+    }
+    if (count % 8 != 0) {
+        std::memcpy(out + whole * 8, table[in[whole]].data(), static_cast<size_t>(count % 8));
+    }
+    return bits;
+}
+
+PYBIND11_NAMESPACE_END(PYBIND11_NAMESPACE)
@@ -182,6 +182,14 @@ private:
     bool ownview = false;
 };
 
+/// The format string of `T` for the buffer protocol (see `format_descriptor`), computed once per
+/// type; the pointer stays valid, e.g. for `def_buffer()` callbacks that fill `Py_buffer`
+template <typename T>
+const char *buffer_format() {
+    static const std::string format = format_descriptor<T>::format();
+    return format.c_str();
+}
+
 PYBIND11_NAMESPACE_BEGIN(detail)
 
 template <typename T, typename SFINAE>
@@ -12,11 +12,13 @@
 
 #include "detail/common.h"
 #include "detail/descr.h"
+#include "detail/small_vector.h"
 #include "detail/type_caster_base.h"
 #include "detail/typeid.h"
 #include "pytypes.h"
 
 #include <array>
+#include <cstdint>
 #include <cstring>
 #include <functional>
 #include <iosfwd>
@@ -25,6 +27,7 @@
 #include <string>
 #include <tuple>
 #include <type_traits>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -120,6 +123,37 @@ using is_std_char_type = any_of<std::is_same<CharT, char>, /* std::string */
                                 std::is_same<CharT, wchar_t>   /* std::wstring */
                                 >;
 
+/// Reads an instance of exactly `int` whose value fits in a `long long`, which is what nearly all
+/// integer arguments are, without any calls that can set an error. On CPython 3.12+ the value of
+/// a small ("compact") int is read straight from the object.
+inline bool exact_int_as_long_long(PyObject *src, long long &result) {
+    if (!PyLong_CheckExact(src)) {
+        return false;
+    }
+#if !defined(PYPY_VERSION) && PY_VERSION_HEX >= 0x030C0000
+    auto *op = reinterpret_cast<PyLongObject *>(src);
+    if (PyUnstable_Long_IsCompact(op)) {
+        result = static_cast<long long>(PyUnstable_Long_CompactValue(op));
+        return true;
+    }
+#endif
+    int overflow = 0;
+    result = PyLong_AsLongLongAndOverflow(src, &overflow);
+    return overflow == 0;
+}
+
+template <typename T, enable_if_t<std::is_signed<T>::value, int> = 0>
+bool long_long_fits(long long value) {
+    return static_cast<long long>(static_cast<T>(value)) == value;
+}
+
+template <typename T, enable_if_t<!std::is_signed<T>::value, int> = 0>
+bool long_long_fits(long long value) {
+    return value >= 0
+           && static_cast<unsigned long long>(static_cast<T>(value))
+                  == static_cast<unsigned long long>(value);
+}
+
 template <typename T>
 struct type_caster<T, enable_if_t<std::is_arithmetic<T>::value && !is_std_char_type<T>::value>> {
     using _py_type_0 = conditional_t<sizeof(T) <= sizeof(long), long, long long>;
@@ -136,6 +170,24 @@ public:
             return false;
         }
 
+        // Exact `float` and `int` instances need neither conversions nor error checks
+        if (std::is_floating_point<T>::value) {
+            if (PyFloat_CheckExact(src.ptr())) {
+                value = (T) PyFloat_AS_DOUBLE(src.ptr());
+                return true;
+            }
+        } else {
+            long long exact_value = 0;
+            if (exact_int_as_long_long(src.ptr(), exact_value)) {
+                // A value out of range is rejected by the general path below too
+                if (!long_long_fits<T>(exact_value)) {
+                    return false;
+                }
+                value = (T) exact_value;
+                return true;
+            }
+        }
+
 #if !defined(PYPY_VERSION)
         auto index_check = [](PyObject *o) { return PyIndex_Check(o); };
 #else
@@ -391,6 +443,16 @@ struct string_caster {
             return load_raw(load_src);
         }
 
+#if !defined(PYPY_VERSION)
+        // Compact ASCII strings store their characters as UTF-8 already (it is the most common
+        // case for e.g. identifiers and tokens)
+        if (UTF_N == 8 && is_compact_ascii(load_src.ptr())) {
+            value = StringType(reinterpret_cast<const CharT *>(PyUnicode_DATA(load_src.ptr())),
+                               static_cast<size_t>(PyUnicode_GET_LENGTH(load_src.ptr())));
+            return true;
+        }
+#endif
+
         // For UTF-8 we avoid the need for a temporary `bytes` object by using
         // `PyUnicode_AsUTF8AndSize`.
         if (UTF_N == 8) {
@@ -448,8 +510,46 @@ struct string_caster {
     PYBIND11_TYPE_CASTER(StringType, const_name(PYBIND11_STRING_NAME));
 
 private:
+#if !defined(PYPY_VERSION)
+    // Checks eight bytes at a time for a set high bit
+    static bool is_ascii(const char *buffer, size_t size) {
+        constexpr std::uint64_t high_bits = UINT64_C(0x8080808080808080);
+        size_t i = 0;
+        for (; i + 8 <= size; i += 8) {
+            std::uint64_t word = 0;
+            std::memcpy(&word, buffer + i, 8);
+            if ((word & high_bits) != 0) {
+                return false;
+            }
+        }
+        for (; i < size; ++i) {
+            if ((static_cast<unsigned char>(buffer[i]) & 0x80) != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static bool is_compact_ascii(PyObject *str) {
+#    if PY_VERSION_HEX < 0x030C0000
+        if (!PyUnicode_IS_READY(str)) {
+            return false;
+        }
+#    endif
+        return PyUnicode_IS_COMPACT_ASCII(str);
+    }
+#endif
+
     static handle decode_utfN(const char *buffer, ssize_t nbytes) {
 #if !defined(PYPY_VERSION)
+        if (UTF_N == 8 && is_ascii(buffer, static_cast<size_t>(nbytes))) {
+            // ASCII is by far the most common case, and needs no decoding at all
+            PyObject *s = PyUnicode_New(nbytes, 127);
+            if (s != nullptr) {
+                std::memcpy(PyUnicode_DATA(s), buffer, static_cast<size_t>(nbytes));
+            }
+            return s;
+        }
         return UTF_N == 8    ? PyUnicode_DecodeUTF8(buffer, nbytes, nullptr)
                : UTF_N == 16 ? PyUnicode_DecodeUTF16(buffer, nbytes, nullptr, nullptr)
                              : PyUnicode_DecodeUTF32(buffer, nbytes, nullptr, nullptr);
@@ -520,6 +620,11 @@ struct type_caster<CharT, enable_if_t<is_std_char_type<CharT>::value>> {
     using StringType = std::basic_string<CharT>;
     using StringCaster = make_caster<StringType>;
     StringCaster str_caster;
+    // For single-byte characters, the null-terminated UTF-8 buffer cached by a `str` is used
+    // as-is instead of copying it into `str_caster`; it lives as long as the `str` does. It must
+    // not be modified, so it is only borrowed for a `const CharT *`.
+    const CharT *utf8 = nullptr;
+    size_t utf8_size = 0;
     bool none = false;
     CharT one_char = 0;
 
@@ -536,6 +641,16 @@ public:
             none = true;
             return true;
         }
+        if (StringCaster::UTF_N == 8 && PyUnicode_Check(src.ptr())) {
+            Py_ssize_t size = -1;
+            utf8 = reinterpret_cast<const CharT *>(PyUnicode_AsUTF8AndSize(src.ptr(), &size));
+            if (!utf8) {
+                PyErr_Clear();
+                return false;
+            }
+            utf8_size = static_cast<size_t>(size);
+            return true;
+        }
         return str_caster.load(src, convert);
     }
 
@@ -557,16 +672,38 @@ public:
         return StringCaster::cast(StringType(1, src), policy, parent);
     }
 
+    explicit operator const CharT *() {
+        if (none) {
+            return nullptr;
+        }
+        if (utf8) {
+            return utf8;
+        }
+        return static_cast<StringType &>(str_caster).c_str();
+    }
     explicit operator CharT *() {
-        return none ? nullptr : const_cast<CharT *>(static_cast<StringType &>(str_caster).c_str());
+        if (none) {
+            return nullptr;
+        }
+        auto &str = static_cast<StringType &>(str_caster);
+        if (utf8) {
+            str.assign(utf8, utf8_size);
+            utf8 = nullptr;
+        }
+        return const_cast<CharT *>(str.c_str());
     }
     explicit operator CharT &() {
         if (none) {
             throw value_error("Cannot convert None to a character");
         }
 
-        auto &value = static_cast<StringType &>(str_caster);
-        size_t str_len = value.size();
+        const CharT *value = utf8;
+        size_t str_len = utf8_size;
+        if (!utf8) {
+            auto &str = static_cast<StringType &>(str_caster);
+            value = str.c_str();
+            str_len = str.size();
+        }
         if (str_len == 0) {
             throw value_error("Cannot convert empty string to a character");
         }
@@ -619,7 +756,10 @@ public:
 
     static constexpr auto name = const_name(PYBIND11_STRING_NAME);
     template <typename _T>
-    using cast_op_type = pybind11::detail::cast_op_type<_T>;
+    using cast_op_type = conditional_t<std::is_same<remove_cv_t<remove_reference_t<_T>>,
+                                                    const CharT *>::value,
+                                       const CharT *,
+                                       pybind11::detail::cast_op_type<_T>>;
 };
 
 // Base implementation for std::tuple and std::pair
@@ -734,6 +874,24 @@ struct holder_helper {
     static auto get(const T &p) -> decltype(p.get()) { return p.get(); }
 };
 
+/// The holder returned by value whose class can move it into the new instance, instead of copying
+/// it (see `copyable_holder_caster::cast`)
+inline const void *&movable_holder() {
+    static thread_local const void *holder = nullptr;
+    return holder;
+}
+
+struct movable_holder_scope {
+    explicit movable_holder_scope(const void *holder) : previous(movable_holder()) {
+        movable_holder() = holder;
+    }
+    ~movable_holder_scope() { movable_holder() = previous; }
+    movable_holder_scope(const movable_holder_scope &) = delete;
+    movable_holder_scope &operator=(const movable_holder_scope &) = delete;
+
+    const void *previous;
+};
+
 /// Type caster for holder types like std::shared_ptr, etc.
 /// The SFINAE hook is provided to help work around the current lack of support
 /// for smart-pointer interoperability. Please consider it an implementation
@@ -754,18 +912,40 @@ public:
         return base::template load_impl<copyable_holder_caster<type, holder_type>>(src, convert);
     }
 
+    // Parameters taking the holder by const reference borrow the holder of the instance, and
+    // parameters taking it by value are copied from there once. Other parameters (non-const
+    // references and pointers) get a copy owned by the caster, as they could modify it.
+    template <typename T>
+    using cast_op_type = conditional_t<
+        std::is_same<remove_reference_t<T>, const holder_type>::value,
+        const holder_type &,
+        conditional_t<std::is_same<remove_reference_t<T>, holder_type>::value
+                          && !std::is_lvalue_reference<T>::value,
+                      holder_type,
+                      detail::cast_op_type<T>>>;
+
     explicit operator type *() { return this->value; }
     // static_cast works around compiler error with MSVC 17 and CUDA 10.2
     // see issue #2180
     explicit operator type &() { return *(static_cast<type *>(this->value)); }
-    explicit operator holder_type *() { return std::addressof(holder); }
-    explicit operator holder_type &() { return holder; }
+    explicit operator holder_type *() { return std::addressof(owned_holder()); }
+    explicit operator holder_type &() { return owned_holder(); }
+    explicit operator const holder_type &() { return loaded_holder(); }
+    explicit operator holder_type() { return loaded_holder(); }
 
     static handle cast(const holder_type &src, return_value_policy, handle) {
         const auto *ptr = holder_helper<holder_type>::get(src);
         return type_caster_base<type>::cast_holder(ptr, &src);
     }
 
+    // A returned holder is moved into a new instance instead of being copied (which takes an
+    // atomic reference count increment and decrement for `std::shared_ptr`)
+    static handle cast(holder_type &&src, return_value_policy, handle) {
+        const auto *ptr = holder_helper<holder_type>::get(src);
+        movable_holder_scope scope(std::addressof(src));
+        return type_caster_base<type>::cast_holder(ptr, std::addressof(src));
+    }
+
 protected:
     friend class type_caster_generic;
     void check_holder_compat() {
@@ -777,7 +957,8 @@ protected:
     bool load_value(value_and_holder &&v_h) {
         if (v_h.holder_constructed()) {
             value = v_h.value_ptr();
-            holder = v_h.template holder<holder_type>();
+            // Borrowed: the instance outlives the call that the argument is loaded for
+            instance_holder = std::addressof(v_h.template holder<holder_type>());
             return true;
         }
         throw cast_error("Unable to cast from non-held to held instance (T& to Holder<T>) "
@@ -803,7 +984,7 @@ protected:
             copyable_holder_caster sub_caster(*cast.first);
             if (sub_caster.load(src, convert)) {
                 value = cast.second(sub_caster.value);
-                holder = holder_type(sub_caster.holder, (type *) value);
+                holder = holder_type(sub_caster.loaded_holder(), (type *) value);
                 return true;
             }
         }
@@ -812,13 +993,76 @@ protected:
 
     static bool try_direct_conversions(handle) { return false; }
 
+    const holder_type &loaded_holder() const {
+        return instance_holder != nullptr ? *instance_holder : holder;
+    }
+
+    holder_type &owned_holder() {
+        if (instance_holder != nullptr) {
+            holder = *instance_holder;
+            instance_holder = nullptr;
+        }
+        return holder;
+    }
+
     holder_type holder;
+    const holder_type *instance_holder = nullptr;
 };
 
 /// Specialize for the common std::shared_ptr, so users don't need to
 template <typename T>
 class type_caster<std::shared_ptr<T>> : public copyable_holder_caster<T, std::shared_ptr<T>> {};
 
+PYBIND11_NAMESPACE_END(detail)
+
+/// A holder like `std::shared_ptr` for types with an intrusive reference count, used as e.g.
+/// `py::class_<T, py::intrusive_holder<T>>`. The count is managed with the functions
+/// `intrusive_ptr_add_ref(T *)` and `intrusive_ptr_release(T *)`, which are found by
+/// argument-dependent lookup (as for `boost::intrusive_ptr`). Unlike `std::shared_ptr`, it needs
+/// no separately allocated control block, and a raw pointer to an instance can be returned to
+/// Python (or taken over from it) at any time, since the count is part of the instance.
+template <typename T>
+class intrusive_holder {
+public:
+    using element_type = T;
+
+    intrusive_holder() = default;
+    explicit intrusive_holder(T *ptr) : m_ptr(ptr) {
+        if (m_ptr != nullptr) {
+            intrusive_ptr_add_ref(m_ptr);
+        }
+    }
+    intrusive_holder(const intrusive_holder &other) : intrusive_holder(other.m_ptr) {}
+    template <typename U, detail::enable_if_t<std::is_convertible<U *, T *>::value, int> = 0>
+    // NOLINTNEXTLINE(google-explicit-constructor)
+    intrusive_holder(const intrusive_holder<U> &other) : intrusive_holder(other.get()) {}
+    intrusive_holder(intrusive_holder &&other) noexcept : m_ptr(other.m_ptr) {
+        other.m_ptr = nullptr;
+    }
+    ~intrusive_holder() {
+        if (m_ptr != nullptr) {
+            intrusive_ptr_release(m_ptr);
+        }
+    }
+    intrusive_holder &operator=(intrusive_holder other) noexcept {
+        std::swap(m_ptr, other.m_ptr);
+        return *this;
+    }
+
+    T *get() const { return m_ptr; }
+    T &operator*() const { return *m_ptr; }
+    T *operator->() const { return m_ptr; }
+    explicit operator bool() const { return m_ptr != nullptr; }
+
+private:
+    T *m_ptr = nullptr;
+};
+
+PYBIND11_NAMESPACE_BEGIN(detail)
+
+template <typename T>
+class type_caster<intrusive_holder<T>> : public copyable_holder_caster<T, intrusive_holder<T>> {};
+
 /// Type caster for holder types like std::unique_ptr.
 /// Please consider the SFINAE hook an implementation detail, as explained
 /// in the comment for the copyable_holder_caster.
@@ -848,6 +1092,9 @@ struct always_construct_holder {
     static constexpr bool value = Value;
 };
 
+template <typename T>
+struct always_construct_holder<intrusive_holder<T>> : std::true_type {};
+
 /// Create a specialization for custom holder types (silently ignores std::shared_ptr)
 #define PYBIND11_DECLARE_HOLDER_TYPE(type, holder_type, ...)                                      \
     PYBIND11_NAMESPACE_BEGIN(PYBIND11_NAMESPACE)                                                  \
@@ -944,6 +1191,57 @@ struct pyobject_caster {
 template <typename T>
 class type_caster<T, enable_if_t<is_pyobject<T>::value>> : public pyobject_caster<T> {};
 
+/// Whether `Caster` inherits the `load` of `type_caster_generic`, as the casters of bound classes
+/// do (unless they are custom casters replacing it, e.g. to inspect the value)
+template <typename Caster, typename SFINAE = void>
+struct uses_generic_load : std::false_type {};
+template <typename Caster>
+struct uses_generic_load<Caster, void_t<decltype(&Caster::load)>>
+    : std::is_same<decltype(&Caster::load), bool (type_caster_generic::*)(handle, bool)> {};
+
+/// Tells whether `Caster::load(src, false)` (i.e. without conversions) succeeds or fails only
+/// depending on the Python type of `src`, not on its value. The dispatcher relies on this to skip
+/// overloads that are known not to match a given combination of argument types.
+template <typename Caster, typename SFINAE = void>
+struct loads_by_type : uses_generic_load<Caster> {};
+template <typename T>
+struct loads_by_type<type_caster<T>, enable_if_t<std::is_floating_point<T>::value>>
+    : std::true_type {};
+/// Wrappers whose `check_` only looks at the Python type. Others, like `array_t` (which also
+/// checks the dtype and flags of the array), may accept some objects of a type and not others.
+template <typename T, typename... Types>
+using is_one_of = any_of<std::is_same<T, Types>...>;
+template <typename T>
+struct loads_by_type<type_caster<T>,
+                     enable_if_t<is_one_of<T,
+                                           handle,
+                                           object,
+                                           str,
+                                           bytes,
+                                           bytearray,
+                                           bool_,
+                                           int_,
+                                           float_,
+                                           none,
+                                           tuple,
+                                           list,
+                                           dict,
+                                           anyset,
+                                           set,
+                                           frozenset,
+                                           slice,
+                                           capsule,
+                                           type,
+                                           memoryview>::value>> : std::true_type {};
+template <>
+struct loads_by_type<type_caster<bool>> : std::true_type {};
+
+/// Tells whether `Caster::cast` can return a null handle with a Python error set which is meant to
+/// be raised as it is from the bound function (e.g. for `py::result<T>`), rather than to report a
+/// failed conversion of the return value.
+template <typename Caster, typename SFINAE = void>
+struct casts_to_error : std::false_type {};
+
 // Our conditions for enabling moving are quite restrictive:
 // At compile time:
 // - T needs to be a non-const, non-pointer, non-reference type
@@ -1010,6 +1308,242 @@ struct return_value_policy_override<
     }
 };
 
+PYBIND11_NAMESPACE_END(detail)
+
+/// A Python exception which a bound function raises by returning it as the error of a
+/// `py::result<T>`, e.g. `return py::error(PyExc_KeyError, py::int_(key));`.
+class error {
+public:
+    error(handle type, object value)
+        : m_type(reinterpret_borrow<object>(type)), m_value(std::move(value)) {}
+    error(handle type, const char *message) : error(type, str(message)) {}
+    error(handle type, const std::string &message) : error(type, str(message)) {}
+
+    handle type() const { return m_type; }
+    const object &value() const { return m_value; }
+
+    /// Sets the Python error indicator to this exception
+    void restore() const {
+        if (PyTuple_Check(m_value.ptr())) {
+            // A tuple would be taken for the arguments of the exception
+            auto args = reinterpret_steal<object>(PyTuple_Pack(1, m_value.ptr()));
+            if (args) {
+                PyErr_SetObject(m_type.ptr(), args.ptr());
+            }
+        } else {
+            PyErr_SetObject(m_type.ptr(), m_value.ptr());
+        }
+    }
+
+private:
+    object m_type;
+    object m_value;
+};
+
+/// The return value of a bound function which either is a `T` or a Python exception to raise
+/// (see `py::error`). Unlike a thrown C++ exception, the error does not unwind the stack and does
+/// not go through the registered exception translators.
+template <typename T>
+class result {
+    static_assert(!std::is_void<T>::value && !std::is_reference<T>::value,
+                  "py::result<T> needs an object type; use py::result<py::none> for no value");
+
+public:
+    // NOLINTNEXTLINE(google-explicit-constructor)
+    result(const T &value) : m_has_value(true) { new (&m_value) T(value); }
+    // NOLINTNEXTLINE(google-explicit-constructor)
+    result(T &&value) : m_has_value(true) { new (&m_value) T(std::move(value)); }
+    // NOLINTNEXTLINE(google-explicit-constructor)
+    result(pybind11::error error) : m_has_value(false) {
+        new (&m_error) pybind11::error(std::move(error));
+    }
+    result(const result &other) : m_has_value(other.m_has_value) {
+        if (m_has_value) {
+            new (&m_value) T(other.m_value);
+        } else {
+            new (&m_error) pybind11::error(other.m_error);
+        }
+    }
+    result(result &&other) noexcept(std::is_nothrow_move_constructible<T>::value)
+        : m_has_value(other.m_has_value) {
+        if (m_has_value) {
+            new (&m_value) T(std::move(other.m_value));
+        } else {
+            new (&m_error) pybind11::error(std::move(other.m_error));
+        }
+    }
+    result &operator=(result other) {
+        destroy();
+        m_has_value = other.m_has_value;
+        if (m_has_value) {
+            new (&m_value) T(std::move(other.m_value));
+        } else {
+            new (&m_error) pybind11::error(std::move(other.m_error));
+        }
+        return *this;
+    }
+    ~result() { destroy(); }
+
+    bool has_value() const { return m_has_value; }
+    explicit operator bool() const { return m_has_value; }
+
+    T &value() & { return m_value; }
+    const T &value() const & { return m_value; }
+    T &&value() && { return std::move(m_value); }
+
+    const pybind11::error &error() const { return m_error; }
+
+private:
+    void destroy() {
+        if (m_has_value) {
+            m_value.~T();
+        } else {
+            m_error.~error();
+        }
+    }
+
+    bool m_has_value;
+    union {
+        T m_value;
+        pybind11::error m_error;
+    };
+};
+
+#ifndef PYBIND11_INTERNED_CACHE_SIZE
+#    define PYBIND11_INTERNED_CACHE_SIZE 4096
+#endif
+
+/// The return value of a bound function which is returned as an interned Python `str` from a
+/// per-module cache, so that returning the same string again only takes a reference count
+/// increment. `T` is `std::string` or `std::string_view`, for which the cache is keyed by the
+/// content, or `const char *`, which must point to a string that is never freed or changed (such
+/// as a literal), as the cache is keyed by its address. Once the cache holds
+/// `PYBIND11_INTERNED_CACHE_SIZE` strings, it is emptied and filled up again.
+template <typename T>
+class interned {
+public:
+    // NOLINTNEXTLINE(google-explicit-constructor)
+    interned(T value) : m_value(std::move(value)) {}
+
+    const T &value() const { return m_value; }
+
+private:
+    T m_value;
+};
+
+PYBIND11_NAMESPACE_BEGIN(detail)
+
+/// Raises the error of a `py::result<T>` by setting it and returning a null handle, which the
+/// dispatcher passes on to Python instead of reporting a failed conversion.
+template <typename T>
+class type_caster<result<T>> {
+    using value_conv = make_caster<T>;
+
+public:
+    static constexpr auto name = value_conv::name;
+
+    template <typename Result>
+    static handle cast(Result &&src, return_value_policy policy, handle parent) {
+        if (!src.has_value()) {
+            src.error().restore();
+            return handle();
+        }
+        return value_conv::cast(std::forward<Result>(src).value(),
+                                return_value_policy_override<T>::policy(policy),
+                                parent);
+    }
+};
+
+template <typename T>
+struct casts_to_error<type_caster<result<T>>> : std::true_type {};
+
+/// The interned `str` objects returned for `py::interned<T>`, by content or by address. They are
+/// kept in the `local_internals` of the current interpreter, since Python objects can not be
+/// shared between interpreters, and released by `finalize_interpreter()`.
+class interned_str_cache {
+public:
+    /// A new reference to the string cached for `key`, created by `make` if there is none
+    template <typename Key, typename Make>
+    static handle lookup(const Key &key, Make &&make) {
+        auto &locals = get_local_internals();
+#if defined(Py_GIL_DISABLED)
+        std::unique_lock<pymutex> lock(locals.interned_mutex);
+#endif
+        auto &strings = cache_of(locals, key);
+        auto it = strings.find(key);
+        if (it != strings.end()) {
+            return handle(it->second).inc_ref();
+        }
+        PyObject *str = make().ptr();
+        PyUnicode_InternInPlace(&str);
+        if (strings.size() >= PYBIND11_INTERNED_CACHE_SIZE) {
+            release(strings);
+        }
+        strings.emplace(key, handle(str).inc_ref().ptr());
+        return str;
+    }
+
+    /// Releases the strings cached for the current interpreter
+    static void clear() {
+        auto &locals = get_local_internals();
+#if defined(Py_GIL_DISABLED)
+        std::unique_lock<pymutex> lock(locals.interned_mutex);
+#endif
+        release(locals.interned_strings);
+        release(locals.interned_pointers);
+    }
+
+private:
+    static std::unordered_map<std::string, PyObject *> &cache_of(local_internals &locals,
+                                                                 const std::string &) {
+        return locals.interned_strings;
+    }
+    static std::unordered_map<const void *, PyObject *> &cache_of(local_internals &locals,
+                                                                  const void *) {
+        return locals.interned_pointers;
+    }
+
+    template <typename Map>
+    static void release(Map &strings) {
+        for (auto &entry : strings) {
+            Py_DECREF(entry.second);
+        }
+        strings.clear();
+    }
+};
+
+inline const std::string &interned_key(const std::string &value) { return value; }
+inline const void *interned_key(const char *value) { return value; }
+template <typename StringView>
+std::string interned_key(const StringView &value) {
+    return std::string(value.data(), value.size());
+}
+
+template <typename T>
+class type_caster<interned<T>> {
+    using value_conv = make_caster<T>;
+    using key_type = conditional_t<std::is_pointer<T>::value, const void *, std::string>;
+
+public:
+    static constexpr auto name = value_conv::name;
+
+    static handle cast(const interned<T> &src, return_value_policy /* policy */, handle parent) {
+        if (is_null(src.value())) {
+            return none().release();
+        }
+        return interned_str_cache::lookup<key_type>(interned_key(src.value()), [&] {
+            return value_conv::cast(src.value(), return_value_policy::copy, parent);
+        });
+    }
+
+private:
+    static bool is_null(const char *value) { return value == nullptr; }
+    template <typename U>
+    static bool is_null(const U &) {
+        return false;
+    }
+};
+
 // Basic python -> C++ casting; throws if casting fails
 template <typename T, typename SFINAE>
 type_caster<T, SFINAE> &load_type(type_caster<T, SFINAE> &conv, const handle &handle) {
@@ -1087,6 +1621,38 @@ T cast(Object &&obj) {
     return obj.release().ptr();
 }
 
+#ifdef PYBIND11_HAS_OPTIONAL
+/// Like `cast<T>()`, but returns `std::nullopt` if the object cannot be converted to `T`, instead
+/// of throwing a `cast_error`.
+template <typename T, detail::enable_if_t<!detail::is_pyobject<T>::value, int> = 0>
+std::optional<T> try_cast(const handle &handle) {
+    using namespace detail;
+    static_assert(!std::is_reference<T>::value, "try_cast<T>() needs a non-reference type");
+    make_caster<T> conv;
+    if (!conv.load(handle, true)) {
+        return std::nullopt;
+    }
+    if constexpr (!std::is_pointer<T>::value
+                  && std::is_base_of<type_caster_base<intrinsic_t<T>>, make_caster<T>>::value) {
+        // None is loaded as a null pointer, which only converts to pointers
+        if (conv.value == nullptr) {
+            return std::nullopt;
+        }
+    }
+    return cast_op<T>(std::move(conv));
+}
+
+/// Like `cast<T>()` for Python types, but returns `std::nullopt` if the object is not an instance
+/// of `T` instead of converting it.
+template <typename T, detail::enable_if_t<detail::is_pyobject<T>::value, int> = 0>
+std::optional<T> try_cast(const handle &handle) {
+    if (!isinstance<T>(handle)) {
+        return std::nullopt;
+    }
+    return reinterpret_borrow<T>(handle);
+}
+#endif
+
 // C++ type -> py::object
 template <typename T, detail::enable_if_t<!detail::is_pyobject<T>::value, int> = 0>
 object cast(T &&value,
@@ -1272,6 +1838,158 @@ tuple make_tuple(Args &&...args_) {
     return result;
 }
 
+PYBIND11_NAMESPACE_BEGIN(detail)
+
+/// Extracts an const lvalue reference or rvalue reference for U based on the type of T (e.g. for
+/// forwarding a container element).  Typically used indirect via forwarded_type(), below.
+template <typename T, typename U>
+using forwarded_type = conditional_t<std::is_lvalue_reference<T>::value,
+                                     remove_reference_t<U> &,
+                                     remove_reference_t<U> &&>;
+
+/// Forwards a value U as rvalue or lvalue according to whether T is rvalue or lvalue; typically
+/// used for forwarding a container's elements.
+template <typename T, typename U>
+constexpr forwarded_type<T, U> forward_like(U &&u) {
+    return std::forward<detail::forwarded_type<T, U>>(std::forward<U>(u));
+}
+
+PYBIND11_NAMESPACE_BEGIN(adl)
+using std::begin;
+// Unqualified, so that `std::begin()` overloads declared later (e.g. for valarray) are found
+template <typename Container>
+auto begin_of(Container &container) -> decltype(begin(container)) {
+    return begin(container);
+}
+PYBIND11_NAMESPACE_END(adl)
+
+/// Returns the begin iterator of `container` if `T` is an lvalue reference, or a
+/// `std::move_iterator` for it otherwise, to forward the elements of a container the same way as
+/// `forward_like<T>()`.
+template <typename T,
+          typename Container,
+          enable_if_t<std::is_lvalue_reference<T>::value, int> = 0>
+auto forwarding_begin(Container &container) -> decltype(adl::begin_of(container)) {
+    return adl::begin_of(container);
+}
+template <typename T,
+          typename Container,
+          enable_if_t<!std::is_lvalue_reference<T>::value, int> = 0>
+auto forwarding_begin(Container &container)
+    -> std::move_iterator<decltype(adl::begin_of(container))> {
+    return std::make_move_iterator(adl::begin_of(container));
+}
+
+inline void set_sequence_item(list &l, size_t index, object &&item) {
+    PyList_SET_ITEM(l.ptr(), (ssize_t) index, item.release().ptr()); // steals a reference
+}
+
+inline void set_sequence_item(tuple &t, size_t index, object &&item) {
+    PyTuple_SET_ITEM(t.ptr(), (ssize_t) index, item.release().ptr()); // steals a reference
+}
+
+/// Makes a list or tuple of the `size` elements starting at `first`, each converted with the
+/// caster of `Value`. The sequence is allocated at its final size and the converted elements are
+/// stolen into it. Returns a null object if an element cannot be converted. Used by the `list`
+/// and `tuple` range constructors and the STL casters; pass a `std::move_iterator` to move the
+/// elements.
+template <typename Sequence, typename Value, typename Iterator>
+object cast_sequence(Iterator first, size_t size, return_value_policy policy, handle parent) {
+    Sequence result(size);
+    for (size_t index = 0; index < size; ++index, ++first) {
+        auto item = reinterpret_steal<object>(make_caster<Value>::cast(*first, policy, parent));
+        if (!item) {
+            return object();
+        }
+        set_sequence_item(result, index, std::move(item));
+    }
+    return reinterpret_steal<object>(result.release());
+}
+
+/// Like `cast_sequence`, for a dict of the `size` pairs starting at `first`
+template <typename Key, typename Value, typename Iterator>
+object cast_dict(Iterator first,
+                 size_t size,
+                 return_value_policy policy_key,
+                 return_value_policy policy_value,
+                 handle parent) {
+#if !defined(PYPY_VERSION) && PY_VERSION_HEX < 0x030D0000
+    // Sized for all items up front, so that it is not resized while being filled
+    auto result = reinterpret_steal<dict>(_PyDict_NewPresized(static_cast<ssize_t>(size)));
+    if (!result) {
+        return object();
+    }
+#else
+    dict result;
+#endif
+    for (size_t index = 0; index < size; ++index, ++first) {
+        auto &&kv = *first;
+        auto key = reinterpret_steal<object>(make_caster<Key>::cast(
+            forward_like<decltype(kv)>(kv.first), policy_key, parent));
+        auto value = reinterpret_steal<object>(make_caster<Value>::cast(
+            forward_like<decltype(kv)>(kv.second), policy_value, parent));
+        if (!key || !value || PyDict_SetItem(result.ptr(), key.ptr(), value.ptr()) != 0) {
+            return object();
+        }
+    }
+    return reinterpret_steal<object>(result.release());
+}
+
+template <typename Iterator>
+size_t range_size(Iterator first, Iterator last) {
+    auto size = std::distance(first, last);
+    if (size < 0) {
+        pybind11_fail("Invalid iterator range");
+    }
+    return static_cast<size_t>(size);
+}
+
+template <typename T>
+[[noreturn]] void throw_unable_to_convert_element() {
+#if !defined(PYBIND11_DETAILED_ERROR_MESSAGES)
+    throw cast_error("Unable to convert an element of the range to Python object (#define "
+                     "PYBIND11_DETAILED_ERROR_MESSAGES or compile in debug mode for details)");
+#else
+    throw cast_error("Unable to convert an element of the range of type '" + type_id<T>()
+                     + "' to Python object");
+#endif
+}
+
+PYBIND11_NAMESPACE_END(detail)
+
+template <typename Iterator>
+list list::from_range(Iterator first, Iterator last, return_value_policy policy) {
+    using value_type = decltype(*first);
+    auto result = detail::cast_sequence<list, value_type>(
+        first, detail::range_size(first, last), policy, handle());
+    if (!result) {
+        detail::throw_unable_to_convert_element<value_type>();
+    }
+    return reinterpret_steal<list>(result.release());
+}
+
+template <typename Iterator>
+tuple tuple::from_range(Iterator first, Iterator last, return_value_policy policy) {
+    using value_type = decltype(*first);
+    auto result = detail::cast_sequence<tuple, value_type>(
+        first, detail::range_size(first, last), policy, handle());
+    if (!result) {
+        detail::throw_unable_to_convert_element<value_type>();
+    }
+    return reinterpret_steal<tuple>(result.release());
+}
+
+template <typename Iterator>
+dict dict::from_pairs(Iterator first, Iterator last, return_value_policy policy) {
+    using value_type = decltype(*first);
+    auto result = detail::cast_dict<decltype((*first).first), decltype((*first).second)>(
+        first, detail::range_size(first, last), policy, policy, handle());
+    if (!result) {
+        detail::throw_unable_to_convert_element<value_type>();
+    }
+    return reinterpret_steal<dict>(result.release());
+}
+
 /// \ingroup annotations
 /// Annotation for arguments
 struct arg {
@@ -1394,14 +2112,17 @@ struct function_record;
 struct function_call {
     function_call(const function_record &f, handle p); // Implementation in attr.h
 
+    /// Calls with up to this many arguments do not allocate memory for the argument lists
+    static constexpr size_t inline_args = 8;
+
     /// The function data:
     const function_record &func;
 
-    /// Arguments passed to the function:
-    std::vector<handle> args;
+    /// Arguments passed to the function (stored inline for up to `inline_args` arguments):
+    small_vector<handle, inline_args> args;
 
     /// The `convert` value the arguments should be loaded with
-    std::vector<bool> args_convert;
+    small_vector<bool, inline_args> args_convert;
 
     /// Extra references for the optional `py::args` and/or `py::kwargs` arguments (which, if
     /// present, are also in `args` but without a reference).
@@ -1412,8 +2133,44 @@ struct function_call {
 
     /// If this is a call to an initializer, this argument contains `self`
     handle init_self;
+
+    /// Set when `function_record::impl` returns `PYBIND11_TRY_NEXT_OVERLOAD` because the
+    /// arguments could not be loaded or cast. The function itself may also throw a
+    /// `reference_cast_error`, which is reported in the same way, but it must not then be called
+    /// again.
+    bool args_failed = false;
 };
 
+#if defined(PYBIND11_COMPACT_DISPATCH)
+/// The `load` of an argument caster, called through a table by `load_args_erased()`
+using erased_load_fn = bool (*)(void *caster, handle src, bool convert);
+
+template <typename Caster>
+bool erased_load(void *caster, handle src, bool convert) {
+    return static_cast<Caster *>(caster)->load(src, convert);
+}
+
+/// The casters of bound classes (see `uses_generic_load`) are all loaded by the same function,
+/// based on the `type_info` they hold
+template <typename Caster>
+using erased_load_caster
+    = conditional_t<uses_generic_load<Caster>::value, type_caster_generic, Caster>;
+
+/// Loads the arguments of a call with the `loaders` of their `casters`, out of line of the
+/// dispatcher, which only keeps the typed call of the function
+PYBIND11_NOINLINE bool load_args_erased(function_call &call,
+                                        void *const *casters,
+                                        const erased_load_fn *loaders,
+                                        size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        if (!loaders[i](casters[i], call.args[i], call.args_convert[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+#endif
+
 /// Helper class which loads arguments for C++ functions called from Python
 template <typename... Args>
 class argument_loader {
@@ -1442,42 +2199,74 @@ public:
 
     bool load_args(function_call &call) { return load_impl_sequence(call, indices{}); }
 
+    /// Calls `f` with the loaded arguments. If casting them throws a `reference_cast_error`,
+    /// `*cast_failed` (if given) is set, to tell it from one thrown by `f`.
     template <typename Return, typename Guard, typename Func>
     // NOLINTNEXTLINE(readability-const-return-type)
-    enable_if_t<!std::is_void<Return>::value, Return> call(Func &&f) && {
+    enable_if_t<!std::is_void<Return>::value, Return> call(Func &&f,
+                                                           bool *cast_failed = nullptr) && {
         return std::move(*this).template call_impl<remove_cv_t<Return>>(
-            std::forward<Func>(f), indices{}, Guard{});
+            std::forward<Func>(f), indices{}, Guard{}, cast_failed);
     }
 
     template <typename Return, typename Guard, typename Func>
-    enable_if_t<std::is_void<Return>::value, void_type> call(Func &&f) && {
+    enable_if_t<std::is_void<Return>::value, void_type> call(Func &&f,
+                                                             bool *cast_failed = nullptr) && {
         std::move(*this).template call_impl<remove_cv_t<Return>>(
-            std::forward<Func>(f), indices{}, Guard{});
+            std::forward<Func>(f), indices{}, Guard{}, cast_failed);
         return void_type();
     }
 
 private:
     static bool load_impl_sequence(function_call &, index_sequence<>) { return true; }
 
+#if defined(PYBIND11_COMPACT_DISPATCH)
+    // Only passes the addresses of the casters to `load_args_erased()`, with a constant table of
+    // their loaders, so that no loading code is compiled for each signature
+    template <size_t... Is>
+    PYBIND11_ALWAYS_INLINE bool load_impl_sequence(function_call &call, index_sequence<Is...>) {
+        static constexpr erased_load_fn loaders[]
+            = {&erased_load<erased_load_caster<make_caster<Args>>>...};
+        void *const casters[] = {static_cast<erased_load_caster<make_caster<Args>> *>(
+            &std::get<Is>(argcasters))...};
+        return load_args_erased(call, casters, loaders, sizeof...(Is));
+    }
+#else
     template <size_t... Is>
     bool load_impl_sequence(function_call &call, index_sequence<Is...>) {
-#ifdef __cpp_fold_expressions
+#    if defined(__cpp_fold_expressions)
         if ((... || !std::get<Is>(argcasters).load(call.args[Is], call.args_convert[Is]))) {
             return false;
         }
-#else
+#    else
         for (bool r : {std::get<Is>(argcasters).load(call.args[Is], call.args_convert[Is])...}) {
             if (!r) {
                 return false;
             }
         }
-#endif
+#    endif
         return true;
     }
+#endif
 
     template <typename Return, typename Func, size_t... Is, typename Guard>
-    Return call_impl(Func &&f, index_sequence<Is...>, Guard &&) && {
-        return std::forward<Func>(f)(cast_op<Args>(std::move(std::get<Is>(argcasters)))...);
+    Return call_impl(Func &&f, index_sequence<Is...>, Guard &&, bool *cast_failed) && {
+        (void) cast_failed; // Unused without arguments
+        return std::forward<Func>(f)(
+            cast_arg<Args>(std::move(std::get<Is>(argcasters)), cast_failed)...);
+    }
+
+    template <typename Arg, typename Caster>
+    static auto cast_arg(Caster &&caster, bool *cast_failed)
+        -> decltype(cast_op<Arg>(std::forward<Caster>(caster))) {
+        try {
+            return cast_op<Arg>(std::forward<Caster>(caster));
+        } catch (reference_cast_error &) {
+            if (cast_failed != nullptr) {
+                *cast_failed = true;
+            }
+            throw;
+        }
     }
 
     std::tuple<make_caster<Args>...> argcasters;
@@ -1510,6 +2299,27 @@ private:
     tuple m_args;
 };
 
+[[noreturn]] inline void nameless_argument_error() {
+    throw type_error(
+        "Got kwargs without a name; only named arguments "
+        "may be passed via py::arg() to a python function call. "
+        "(#define PYBIND11_DETAILED_ERROR_MESSAGES or compile in debug mode for details)");
+}
+[[noreturn]] inline void nameless_argument_error(const std::string &type) {
+    throw type_error("Got kwargs without a name of type '" + type
+                     + "'; only named "
+                       "arguments may be passed via py::arg() to a python function call. ");
+}
+[[noreturn]] inline void multiple_values_error() {
+    throw type_error(
+        "Got multiple values for keyword argument "
+        "(#define PYBIND11_DETAILED_ERROR_MESSAGES or compile in debug mode for details)");
+}
+
+[[noreturn]] inline void multiple_values_error(const std::string &name) {
+    throw type_error("Got multiple values for keyword argument '" + name + "'");
+}
+
 /// Helper class which collects positional, keyword, * and ** arguments for a Python function call
 template <return_value_policy policy>
 class unpacking_collector {
@@ -1603,31 +2413,147 @@ private:
         }
     }
 
-    [[noreturn]] static void nameless_argument_error() {
-        throw type_error(
-            "Got kwargs without a name; only named arguments "
-            "may be passed via py::arg() to a python function call. "
-            "(#define PYBIND11_DETAILED_ERROR_MESSAGES or compile in debug mode for details)");
-    }
-    [[noreturn]] static void nameless_argument_error(const std::string &type) {
-        throw type_error("Got kwargs without a name of type '" + type
-                         + "'; only named "
-                           "arguments may be passed via py::arg() to a python function call. ");
+private:
+    tuple m_args;
+    dict m_kwargs;
+};
+
+#if defined(PYBIND11_HAS_VECTORCALL)
+/// Helper class which collects the positional and keyword arguments of a Python function call
+/// into an array, to pass them with the vectorcall protocol instead of in a tuple and a dict
+template <return_value_policy policy, typename... Args>
+class vectorcall_collector {
+    static constexpr size_t n_args = sizeof...(Args);
+    static constexpr size_t n_kwargs = constexpr_sum(is_keyword<Args>::value...);
+
+public:
+    explicit vectorcall_collector(Args &&...values) {
+        size_t i = 0;
+        using expander = int[];
+        (void) expander{0, (process(i++, std::forward<Args>(values)), 0)...};
     }
-    [[noreturn]] static void multiple_values_error() {
-        throw type_error(
-            "Got multiple values for keyword argument "
-            "(#define PYBIND11_DETAILED_ERROR_MESSAGES or compile in debug mode for details)");
+
+    /// Call a Python function and pass the collected arguments
+    object call(PyObject *ptr) const {
+        // The slot in front of the arguments may be used by the callee (e.g. for `self`)
+        std::array<PyObject *, n_args + 1> args = pointers(nullptr);
+        return result(PyObject_Vectorcall(ptr,
+                                          &args[1],
+                                          (n_args - n_kwargs) | PY_VECTORCALL_ARGUMENTS_OFFSET,
+                                          kwnames().ptr()));
     }
 
-    [[noreturn]] static void multiple_values_error(const std::string &name) {
-        throw type_error("Got multiple values for keyword argument '" + name + "'");
+    /// Call the method `name` of `self`, without creating a bound method object for it
+    object call_method(handle self, handle name) const {
+        std::array<PyObject *, n_args + 1> args = pointers(self.ptr());
+        return result(PyObject_VectorcallMethod(name.ptr(),
+                                                args.data(),
+                                                (n_args - n_kwargs + 1)
+                                                    | PY_VECTORCALL_ARGUMENTS_OFFSET,
+                                                kwnames().ptr()));
     }
 
 private:
-    tuple m_args;
-    dict m_kwargs;
+    template <typename T>
+    void process(size_t i, T &&x) {
+        m_values[i] = reinterpret_steal<object>(
+            detail::make_caster<T>::cast(std::forward<T>(x), policy, {}));
+        if (!m_values[i]) {
+#if !defined(PYBIND11_DETAILED_ERROR_MESSAGES)
+            throw cast_error_unable_to_convert_call_arg(std::to_string(i));
+#else
+            throw cast_error_unable_to_convert_call_arg(std::to_string(i), type_id<T>());
+#endif
+        }
+    }
+
+    void process(size_t i, arg_v a) {
+        if (!a.name) {
+#if !defined(PYBIND11_DETAILED_ERROR_MESSAGES)
+            nameless_argument_error();
+#else
+            nameless_argument_error(a.type);
+#endif
+        }
+        if (!a.value) {
+#if !defined(PYBIND11_DETAILED_ERROR_MESSAGES)
+            throw cast_error_unable_to_convert_call_arg(a.name);
+#else
+            throw cast_error_unable_to_convert_call_arg(a.name, a.type);
+#endif
+        }
+        m_values[i] = std::move(a.value);
+        m_names[i - (n_args - n_kwargs)] = a.name;
+    }
+
+    std::array<PyObject *, n_args + 1> pointers(PyObject *first) const {
+        std::array<PyObject *, n_args + 1> result{{first}};
+        for (size_t i = 0; i < n_args; ++i) {
+            result[i + 1] = m_values[i].ptr();
+        }
+        return result;
+    }
+
+    // Returns the tuple of keyword argument names, or null if there are none. The names are
+    // nearly always the same for a given combination of argument types (e.g. from `"x"_a`), so
+    // the tuple made for the last call is kept for the next one, as long as the interpreter lives.
+    object kwnames() const {
+        if (n_kwargs == 0) {
+            return object();
+        }
+        static std::array<std::string, n_kwargs> cached_names;
+        static PyObject *cached = nullptr;
+        static size_t cached_generation = 0;
+        const size_t generation = interpreter_lifetime::get().current();
+        bool same = generation != 0 && generation == cached_generation;
+        for (size_t i = 0; same && i < n_kwargs; ++i) {
+            same = cached_names[i] == m_names[i];
+        }
+        if (same) {
+            return reinterpret_borrow<object>(cached);
+        }
+        tuple names(n_kwargs);
+        for (size_t i = 0; i < n_kwargs; ++i) {
+            for (size_t j = 0; j < i; ++j) {
+                if (std::strcmp(m_names[i], m_names[j]) == 0) {
+#if !defined(PYBIND11_DETAILED_ERROR_MESSAGES)
+                    multiple_values_error();
+#else
+                    multiple_values_error(m_names[i]);
+#endif
+                }
+            }
+            PyObject *name = PyUnicode_InternFromString(m_names[i]);
+            if (!name) {
+                throw error_already_set();
+            }
+            PyTuple_SET_ITEM(names.ptr(), (ssize_t) i, name);
+        }
+        if (generation != 0) {
+            // A tuple of an earlier generation may have been freed with its interpreter
+            if (generation == cached_generation) {
+                Py_XDECREF(cached);
+            }
+            cached = names.inc_ref().ptr();
+            cached_generation = generation;
+            for (size_t i = 0; i < n_kwargs; ++i) {
+                cached_names[i] = m_names[i];
+            }
+        }
+        return reinterpret_steal<object>(names.release());
+    }
+
+    static object result(PyObject *result) {
+        if (!result) {
+            throw error_already_set();
+        }
+        return reinterpret_steal<object>(result);
+    }
+
+    std::array<object, n_args> m_values;
+    std::array<const char *, n_kwargs> m_names{};
 };
+#endif
 
 // [workaround(intel)] Separate function required here
 // We need to put this into a separate function because the Intel compiler
@@ -1661,6 +2587,61 @@ unpacking_collector<policy> collect_arguments(Args &&...args) {
     return unpacking_collector<policy>(std::forward<Args>(args)...);
 }
 
+template <typename... Args>
+constexpr bool args_need_unpacking() {
+    return any_of<is_s_unpacking<Args>..., is_ds_unpacking<Args>...>::value;
+}
+
+#if defined(PYBIND11_HAS_VECTORCALL)
+/// Call a Python function with arguments without * or ** unpacking, through vectorcall
+template <return_value_policy policy,
+          typename... Args,
+          enable_if_t<!args_need_unpacking<Args...>(), int> = 0>
+object call_object(handle callable, Args &&...args) {
+    static_assert(constexpr_last<is_positional, Args...>()
+                      < constexpr_first<is_keyword, Args...>(),
+                  "Invalid function call: positional args must precede keywords");
+    return vectorcall_collector<policy, Args...>(std::forward<Args>(args)...)
+        .call(callable.ptr());
+}
+
+/// Call the method `name` of `self`, through vectorcall if the arguments need no unpacking
+template <return_value_policy policy,
+          typename... Args,
+          enable_if_t<!args_need_unpacking<Args...>(), int> = 0>
+object call_method(handle self, handle name, Args &&...args) {
+    static_assert(constexpr_last<is_positional, Args...>()
+                      < constexpr_first<is_keyword, Args...>(),
+                  "Invalid function call: positional args must precede keywords");
+    return vectorcall_collector<policy, Args...>(std::forward<Args>(args)...)
+        .call_method(self, name);
+}
+#endif
+
+/// Call a Python function with any arguments
+template <return_value_policy policy,
+          typename... Args
+#if defined(PYBIND11_HAS_VECTORCALL)
+          ,
+          enable_if_t<args_need_unpacking<Args...>(), int> = 0
+#endif
+          >
+object call_object(handle callable, Args &&...args) {
+    return collect_arguments<policy>(std::forward<Args>(args)...).call(callable.ptr());
+}
+
+/// Call the method `name` of `self` with any arguments
+template <return_value_policy policy,
+          typename... Args
+#if defined(PYBIND11_HAS_VECTORCALL)
+          ,
+          enable_if_t<args_need_unpacking<Args...>(), int> = 0
+#endif
+          >
+object call_method(handle self, handle name, Args &&...args) {
+    return call_object<policy>(getattr(self, name), std::forward<Args>(args)...);
+}
+
 template <typename Derived>
 template <return_value_policy policy, typename... Args>
 object object_api<Derived>::operator()(Args &&...args) const {
@@ -1669,7 +2650,59 @@ object object_api<Derived>::operator()(Args &&...args) const {
         pybind11_fail("pybind11::object_api<>::operator() PyGILState_Check() failure.");
     }
 #endif
-    return detail::collect_arguments<policy>(std::forward<Args>(args)...).call(derived().ptr());
+    return call_object<policy>(derived().ptr(), std::forward<Args>(args)...);
+}
+
+// Calls the object an accessor refers to
+template <return_value_policy policy, typename Policy, typename Key, typename... Args>
+object call_accessed(Policy, handle obj, const Key &key, object &cache, Args &&...args) {
+    if (!cache) {
+        cache = Policy::get(obj, key);
+    }
+    return call_object<policy>(cache, std::forward<Args>(args)...);
+}
+
+// Attributes that have not been looked up yet are called as methods
+template <return_value_policy policy, typename... Args>
+object call_accessed(accessor_policies::obj_attr,
+                     handle obj,
+                     const object &key,
+                     object &cache,
+                     Args &&...args) {
+    if (cache) {
+        return call_object<policy>(cache, std::forward<Args>(args)...);
+    }
+    return call_method<policy>(obj, key, std::forward<Args>(args)...);
+}
+
+template <return_value_policy policy, typename... Args>
+object call_accessed(accessor_policies::str_attr,
+                     handle obj,
+                     const char *key,
+                     object &cache,
+                     Args &&...args) {
+    if (cache) {
+        return call_object<policy>(cache, std::forward<Args>(args)...);
+    }
+    // Interned, like the names of attributes in Python code, so that the method cache of the type
+    // can find it
+    PyObject *name = PyUnicode_InternFromString(key);
+    if (name == nullptr) {
+        throw error_already_set();
+    }
+    return call_method<policy>(
+        obj, reinterpret_steal<object>(name), std::forward<Args>(args)...);
+}
+
+template <typename Policy>
+template <return_value_policy policy, typename... Args>
+object accessor<Policy>::operator()(Args &&...args) const {
+#ifndef NDEBUG
+    if (!PyGILState_Check()) {
+        pybind11_fail("pybind11::object_api<>::operator() PyGILState_Check() failure.");
+    }
+#endif
+    return call_accessed<policy>(Policy{}, obj, key, cache, std::forward<Args>(args)...);
 }
 
 template <typename Derived>
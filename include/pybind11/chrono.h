@@ -14,6 +14,7 @@
 
 #include <chrono>
 #include <cmath>
+#include <cstdint>
 #include <ctime>
 #include <datetime.h>
 #include <mutex>
@@ -210,6 +211,126 @@ public:
     PYBIND11_TYPE_CASTER(type, const_name("datetime.datetime"));
 };
 
+// Days since 1970-01-01 of a date in the proleptic Gregorian calendar, and back, without the
+// time zone conversions of `std::mktime` and `std::localtime` (H. Hinnant's algorithms)
+inline std::int64_t days_from_civil(std::int64_t y, unsigned m, unsigned d) {
+    y -= m <= 2 ? 1 : 0;
+    const std::int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const auto yoe = static_cast<unsigned>(y - era * 400);
+    const unsigned doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<std::int64_t>(doe) - 719468;
+}
+
+inline void civil_from_days(std::int64_t z, std::int64_t &y, unsigned &m, unsigned &d) {
+    z += 719468;
+    const std::int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const auto doe = static_cast<unsigned>(z - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    d = doy - (153 * mp + 2) / 5 + 1;
+    m = mp < 10 ? mp + 3 : mp - 9;
+    y = static_cast<std::int64_t>(yoe) + era * 400 + (m <= 2 ? 1 : 0);
+}
+
+PYBIND11_NAMESPACE_END(detail)
+
+/** \rst
+    A time point of `std::chrono::system_clock` which is converted to and from a
+    ``datetime.datetime`` in UTC. Unlike plain time points, which are converted to naive datetimes
+    in the local time zone, it needs no `std::localtime` or `std::mktime` calls. It is returned as
+    an aware datetime (with ``datetime.timezone.utc``); aware datetimes are converted to UTC when
+    they are loaded, and naive ones are taken to be in UTC already.
+ \endrst */
+template <typename Duration = std::chrono::system_clock::duration>
+class utc_time_point : public std::chrono::time_point<std::chrono::system_clock, Duration> {
+public:
+    using time_point = std::chrono::time_point<std::chrono::system_clock, Duration>;
+
+    utc_time_point() = default;
+    // NOLINTNEXTLINE(google-explicit-constructor)
+    utc_time_point(const time_point &tp) : time_point(tp) {}
+};
+
+PYBIND11_NAMESPACE_BEGIN(detail)
+
+template <typename Duration>
+class type_caster<utc_time_point<Duration>> {
+public:
+    using type = utc_time_point<Duration>;
+
+    bool load(handle src, bool) {
+        using namespace std::chrono;
+
+        // Lazy initialise the PyDateTime import
+        if (!PyDateTimeAPI) {
+            PyDateTime_IMPORT;
+        }
+
+        if (!src || !PyDate_Check(src.ptr())) {
+            return false;
+        }
+        auto days = days_from_civil(PyDateTime_GET_YEAR(src.ptr()),
+                                    static_cast<unsigned>(PyDateTime_GET_MONTH(src.ptr())),
+                                    static_cast<unsigned>(PyDateTime_GET_DAY(src.ptr())));
+        microseconds since_epoch = duration_cast<microseconds>(hours(24) * days);
+        if (PyDateTime_Check(src.ptr())) {
+            since_epoch += hours(PyDateTime_DATE_GET_HOUR(src.ptr()))
+                           + minutes(PyDateTime_DATE_GET_MINUTE(src.ptr()))
+                           + seconds(PyDateTime_DATE_GET_SECOND(src.ptr()))
+                           + microseconds(PyDateTime_DATE_GET_MICROSECOND(src.ptr()));
+            if (_PyDateTime_HAS_TZINFO(src.ptr())) {
+                object offset = src.attr("utcoffset")();
+                if (PyDelta_Check(offset.ptr())) {
+                    since_epoch -= duration_cast<microseconds>(
+                        hours(24) * PyDateTime_DELTA_GET_DAYS(offset.ptr())
+                        + seconds(PyDateTime_DELTA_GET_SECONDS(offset.ptr()))
+                        + microseconds(PyDateTime_DELTA_GET_MICROSECONDS(offset.ptr())));
+                }
+            }
+        }
+        value = typename type::time_point(duration_cast<Duration>(since_epoch));
+        return true;
+    }
+
+    static handle cast(const type &src, return_value_policy /* policy */, handle /* parent */) {
+        using namespace std::chrono;
+
+        // Lazy initialise the PyDateTime import
+        if (!PyDateTimeAPI) {
+            PyDateTime_IMPORT;
+        }
+
+        using days_t = duration<std::int64_t, std::ratio<86400>>;
+        auto since_epoch = src.time_since_epoch();
+        auto days = duration_cast<days_t>(since_epoch);
+        if (days > since_epoch) {
+            days -= days_t(1);
+        }
+        auto us = duration_cast<microseconds>(since_epoch - days).count();
+        std::int64_t year = 0;
+        unsigned month = 0;
+        unsigned day = 0;
+        civil_from_days(days.count(), year, month, day);
+#if PY_VERSION_HEX >= 0x03070000
+        PyObject *tz = PyDateTime_TimeZone_UTC;
+#else
+        PyObject *tz = Py_None;
+#endif
+        return PyDateTimeAPI->DateTime_FromDateAndTime(static_cast<int>(year),
+                                                       static_cast<int>(month),
+                                                       static_cast<int>(day),
+                                                       static_cast<int>(us / 3600000000),
+                                                       static_cast<int>(us / 60000000 % 60),
+                                                       static_cast<int>(us / 1000000 % 60),
+                                                       static_cast<int>(us % 1000000),
+                                                       tz,
+                                                       PyDateTimeAPI->DateTimeType);
+    }
+    PYBIND11_TYPE_CASTER(type, const_name("datetime.datetime"));
+};
+
 // Other clocks that are not the system clock are not measured as datetime.datetime objects
 // since they are not measured on calendar time. So instead we just make them timedeltas
 // Or if they have passed us a time as a float we convert that
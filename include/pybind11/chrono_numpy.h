@@ -0,0 +1,269 @@
+/*
+    pybind11/chrono_numpy.h: Conversion of std::chrono durations and time points to and from
+    NumPy's timedelta64 and datetime64 arrays
+
+    Copyright (c) 2024 The pybind Community.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE file.
+*/
+
+#pragma once
+
+#include "chrono.h"
+#include "numpy.h"
+
+#include <chrono>
+#include <cstdint>
+#include <ratio>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(PYBIND11_HAS_SPAN)
+#    include <span>
+#endif
+
+PYBIND11_NAMESPACE_BEGIN(PYBIND11_NAMESPACE)
+PYBIND11_NAMESPACE_BEGIN(detail)
+
+/// The NumPy unit of a `std::chrono` period; not defined for periods without one
+template <typename Period>
+struct npy_time_unit;
+template <>
+struct npy_time_unit<std::nano> {
+    static constexpr auto name = const_name("ns");
+};
+template <>
+struct npy_time_unit<std::micro> {
+    static constexpr auto name = const_name("us");
+};
+template <>
+struct npy_time_unit<std::milli> {
+    static constexpr auto name = const_name("ms");
+};
+template <>
+struct npy_time_unit<std::ratio<1>> {
+    static constexpr auto name = const_name("s");
+};
+template <>
+struct npy_time_unit<std::ratio<60>> {
+    static constexpr auto name = const_name("m");
+};
+template <>
+struct npy_time_unit<std::ratio<3600>> {
+    static constexpr auto name = const_name("h");
+};
+template <>
+struct npy_time_unit<std::ratio<86400>> {
+    static constexpr auto name = const_name("D");
+};
+template <>
+struct npy_time_unit<std::ratio<604800>> {
+    static constexpr auto name = const_name("W");
+};
+
+/// The unit of a duration which has the layout of NumPy's 64-bit timedelta64 and datetime64
+template <typename Duration, typename SFINAE = void>
+struct npy_duration_unit {};
+template <typename Rep, typename Period>
+struct npy_duration_unit<std::chrono::duration<Rep, Period>,
+                         enable_if_t<std::is_integral<Rep>::value
+                                     && !std::is_same<Rep, bool>::value
+                                     && sizeof(Rep) == sizeof(std::int64_t)>>
+    : npy_time_unit<typename Period::type> {};
+
+template <typename Duration, typename SFINAE = void>
+struct has_npy_duration_unit : std::false_type {};
+template <typename Duration>
+struct has_npy_duration_unit<Duration, void_t<decltype(npy_duration_unit<Duration>::name)>>
+    : std::true_type {};
+
+/// Durations and `system_clock` time points are stored as they are in timedelta64 and datetime64
+/// arrays; both count from 1970-01-01 UTC and have no time zone.
+template <typename T>
+struct is_npy_chrono : std::false_type {};
+template <typename Rep, typename Period>
+struct is_npy_chrono<std::chrono::duration<Rep, Period>>
+    : has_npy_duration_unit<std::chrono::duration<Rep, Period>> {};
+template <typename Duration>
+struct is_npy_chrono<std::chrono::time_point<std::chrono::system_clock, Duration>>
+    : has_npy_duration_unit<Duration> {};
+
+template <typename Rep, typename Period>
+struct npy_format_descriptor<
+    std::chrono::duration<Rep, Period>,
+    enable_if_t<is_npy_chrono<std::chrono::duration<Rep, Period>>::value>> {
+private:
+    using unit = npy_duration_unit<std::chrono::duration<Rep, Period>>;
+
+public:
+    static constexpr auto name = const_name("numpy.timedelta64[") + unit::name + const_name("]");
+    static pybind11::dtype dtype() {
+        static constexpr auto unit_name = unit::name;
+        return pybind11::dtype(std::string("m8[") + unit_name.text + "]");
+    }
+};
+
+template <typename Duration>
+struct npy_format_descriptor<
+    std::chrono::time_point<std::chrono::system_clock, Duration>,
+    enable_if_t<
+        is_npy_chrono<std::chrono::time_point<std::chrono::system_clock, Duration>>::value>> {
+private:
+    using unit = npy_duration_unit<Duration>;
+
+public:
+    static constexpr auto name = const_name("numpy.datetime64[") + unit::name + const_name("]");
+    static pybind11::dtype dtype() {
+        static constexpr auto unit_name = unit::name;
+        return pybind11::dtype(std::string("M8[") + unit_name.text + "]");
+    }
+};
+
+template <typename Container>
+struct npy_chrono_value {};
+template <typename Value, typename Alloc>
+struct npy_chrono_value<std::vector<Value, Alloc>> {
+    using type = Value;
+};
+#if defined(PYBIND11_HAS_SPAN)
+template <typename T>
+struct npy_chrono_value<std::span<T>> {
+    using type = remove_cv_t<T>;
+};
+#endif
+
+PYBIND11_NAMESPACE_END(detail)
+
+/** \rst
+    A ``std::vector`` of durations or ``system_clock`` time points that is converted to and from
+    a one-dimensional ``numpy.timedelta64`` or ``numpy.datetime64`` array with a single copy,
+    without a Python object per element. The rep must be a 64-bit integer, and NumPy must have a
+    unit for the period. The unit of a loaded array must be that of the vector, unless NumPy can
+    convert the array without losing precision (e.g. seconds to nanoseconds); other sequences,
+    such as lists of ``datetime.timedelta``, are loaded element by element.
+
+    With C++20, a ``std::span`` of such a type instead borrows the memory of a contiguous array
+    with exactly its unit. Returning one copies it into an array.
+\endrst */
+template <typename Container>
+class chrono_array {
+    static_assert(
+        detail::is_npy_chrono<typename detail::npy_chrono_value<Container>::type>::value,
+        "chrono_array needs durations or time points with a 64-bit integer representation and "
+        "a period that NumPy has a unit for");
+
+public:
+    chrono_array() = default;
+    explicit chrono_array(Container value) : value_(std::move(value)) {}
+
+    Container &get() { return value_; }
+    const Container &get() const { return value_; }
+    Container &operator*() { return value_; }
+    const Container &operator*() const { return value_; }
+    Container *operator->() { return &value_; }
+    const Container *operator->() const { return &value_; }
+
+private:
+    Container value_;
+};
+
+/// Wraps `times` to be returned as a `numpy.timedelta64` or `numpy.datetime64` array
+template <typename Container>
+chrono_array<Container> as_chrono_array(Container times) {
+    return chrono_array<Container>(std::move(times));
+}
+
+PYBIND11_NAMESPACE_BEGIN(detail)
+
+template <typename Value, typename Alloc>
+class type_caster<chrono_array<std::vector<Value, Alloc>>> {
+    using Vector = std::vector<Value, Alloc>;
+    using array_type = array_t<Value, array::c_style>;
+    using value_conv = make_caster<Value>;
+
+public:
+    bool load(handle src, bool convert) {
+        Vector &times = *value;
+        if (is_loaded_numpy_array(src)) {
+            array_type arr;
+            if (array_type::check_(src)) {
+                arr = reinterpret_borrow<array_type>(src);
+            } else if (convert) {
+                arr = array_type::ensure(src);
+            }
+            if (!arr || arr.ndim() != 1) {
+                return false;
+            }
+            const Value *data = arr.data();
+            times.assign(data, data + arr.size());
+            return true;
+        }
+        if (!isinstance<sequence>(src) || isinstance<bytes>(src) || isinstance<str>(src)) {
+            return false;
+        }
+        auto s = reinterpret_borrow<sequence>(src);
+        times.clear();
+        times.reserve(s.size());
+        for (auto it : s) {
+            value_conv conv;
+            if (!conv.load(it, convert)) {
+                return false;
+            }
+            times.push_back(cast_op<Value &&>(std::move(conv)));
+        }
+        return true;
+    }
+
+    static handle cast(const chrono_array<Vector> &src,
+                       return_value_policy /* policy */,
+                       handle /* parent */) {
+        return array_t<Value>(static_cast<ssize_t>(src->size()), src->data()).release();
+    }
+
+    PYBIND11_TYPE_CASTER(chrono_array<Vector>, handle_type_name<array_t<Value>>::name);
+};
+
+#if defined(PYBIND11_HAS_SPAN)
+/// Borrows the memory of the array, like spans of arithmetic types borrow buffers (which NumPy
+/// does not export for these dtypes)
+template <typename T>
+class type_caster<chrono_array<std::span<T>>> {
+    using value_type = remove_cv_t<T>;
+    using array_type = array_t<value_type, array::c_style>;
+
+public:
+    bool load(handle src, bool) {
+        if (!is_loaded_numpy_array(src) || !array_type::check_(src)) {
+            return false;
+        }
+        auto arr = reinterpret_borrow<array_type>(src);
+        if (arr.ndim() != 1 || (!std::is_const<T>::value && !arr.writeable())) {
+            return false;
+        }
+        const auto size = static_cast<size_t>(arr.size());
+        if (size == 0) {
+            value = chrono_array<std::span<T>>();
+            return true;
+        }
+        if (reinterpret_cast<std::uintptr_t>(arr.data()) % alignof(value_type) != 0) {
+            return false;
+        }
+        loader_life_support::add_patient(src);
+        value = as_chrono_array(std::span<T>(const_cast<value_type *>(arr.data()), size));
+        return true;
+    }
+
+    static handle cast(const chrono_array<std::span<T>> &src,
+                       return_value_policy /* policy */,
+                       handle /* parent */) {
+        return array_type(static_cast<ssize_t>(src->size()), src->data()).release();
+    }
+
+    PYBIND11_TYPE_CASTER(chrono_array<std::span<T>>, handle_type_name<array_type>::name);
+};
+#endif
+
+PYBIND11_NAMESPACE_END(detail)
+PYBIND11_NAMESPACE_END(PYBIND11_NAMESPACE)
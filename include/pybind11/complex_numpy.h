@@ -0,0 +1,109 @@
+/*
+    pybind11/complex_numpy.h: Conversion of vectors of std::complex to and from NumPy's complex64
+    and complex128 arrays
+
+    Copyright (c) 2024 The pybind Community.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE file.
+*/
+
+#pragma once
+
+#include "complex.h"
+#include "numpy.h"
+
+#include <complex>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+PYBIND11_NAMESPACE_BEGIN(PYBIND11_NAMESPACE)
+PYBIND11_NAMESPACE_BEGIN(detail)
+
+/// Converts a vector of complex numbers to a one-dimensional complex NumPy array with a single
+/// copy, without creating a Python `complex` for each element. Objects exporting a
+/// one-dimensional buffer with exactly the item type of the vector (e.g. `complex128` arrays for
+/// `std::complex<double>`) are loaded with a single copy as well; with conversions allowed, other
+/// NumPy arrays (such as `complex64` or `float64` ones) are converted by NumPy first. Any other
+/// sequence is still loaded element by element.
+template <typename Vector, typename Value>
+struct npy_complex_vector_caster {
+    using value_conv = make_caster<Value>;
+    using array_type = array_t<Value, array::c_style | array::forcecast>;
+
+    bool load(handle src, bool convert) {
+        if (load_buffer(src)) {
+            return true;
+        }
+        if (convert && is_loaded_numpy_array(src)) {
+            auto arr = array_type::ensure(src);
+            if (!arr || arr.ndim() != 1) {
+                return false;
+            }
+            const Value *data = arr.data();
+            value.assign(data, data + arr.size());
+            return true;
+        }
+        if (!isinstance<sequence>(src) || isinstance<bytes>(src) || isinstance<str>(src)) {
+            return false;
+        }
+        auto s = reinterpret_borrow<sequence>(src);
+        value.clear();
+        value.reserve(s.size());
+        for (auto it : s) {
+            value_conv conv;
+            if (!conv.load(it, convert)) {
+                return false;
+            }
+            value.push_back(cast_op<Value &&>(std::move(conv)));
+        }
+        return true;
+    }
+
+    template <typename T>
+    static handle cast(T &&src, return_value_policy /* policy */, handle /* parent */) {
+        return array_t<Value>(static_cast<ssize_t>(src.size()), src.data()).release();
+    }
+
+    PYBIND11_TYPE_CASTER(Vector, handle_type_name<array_t<Value>>::name);
+
+private:
+    bool load_buffer(handle src) {
+        if (!PyObject_CheckBuffer(src.ptr())) {
+            return false;
+        }
+        auto *view = new Py_buffer();
+        if (PyObject_GetBuffer(src.ptr(), view, PyBUF_FORMAT | PyBUF_STRIDES) != 0) {
+            delete view;
+            PyErr_Clear();
+            return false;
+        }
+        buffer_info info(view);
+        if (info.ndim != 1 || !info.item_type_is_equivalent_to<Value>()) {
+            return false;
+        }
+        const auto size = static_cast<size_t>(info.shape[0]);
+        const auto stride = info.strides[0];
+        const auto *data = static_cast<const char *>(info.ptr);
+        value.clear();
+        if (stride == static_cast<ssize_t>(sizeof(Value))
+            && reinterpret_cast<std::uintptr_t>(data) % alignof(Value) == 0) {
+            const auto *first = reinterpret_cast<const Value *>(data);
+            value.assign(first, first + size);
+            return true;
+        }
+        value.resize(size);
+        for (size_t i = 0; i < size; ++i) {
+            std::memcpy(&value[i], data + static_cast<ssize_t>(i) * stride, sizeof(Value));
+        }
+        return true;
+    }
+};
+
+template <typename T, typename Alloc>
+struct type_caster<std::vector<std::complex<T>, Alloc>>
+    : npy_complex_vector_caster<std::vector<std::complex<T>, Alloc>, std::complex<T>> {};
+
+PYBIND11_NAMESPACE_END(detail)
+PYBIND11_NAMESPACE_END(PYBIND11_NAMESPACE)
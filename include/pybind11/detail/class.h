@@ -11,6 +11,18 @@
 
 #include "../attr.h"
 #include "../options.h"
+#include "tracing.h"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#if PY_VERSION_HEX < 0x030C0000
+#    include <structmember.h>
+#    define PYBIND11_T_OBJECT_EX T_OBJECT_EX
+#else
+#    define PYBIND11_T_OBJECT_EX Py_T_OBJECT_EX
+#endif
 
 PYBIND11_NAMESPACE_BEGIN(PYBIND11_NAMESPACE)
 PYBIND11_NAMESPACE_BEGIN(detail)
@@ -130,6 +142,299 @@ class pybind11_static_property(property):
 
 #endif // PYPY
 
+constexpr const char *native_static_member_type_name = "pybind11_native_static_member";
+
+/// Whether `obj` is the descriptor of a static member, from any module (each module has its own
+/// descriptor types, so they are recognized by their name)
+inline bool is_native_static_member(PyObject *obj) {
+    return std::strcmp(Py_TYPE(obj)->tp_name, native_static_member_type_name) == 0;
+}
+
+#if !defined(PYPY_VERSION)
+
+/// The descriptor created by `def_readwrite()` and `def_readonly()` with `py::native_member()`.
+/// Like the member descriptors of built-in types, it reads and writes the member directly at its
+/// offset in the C++ value, instead of calling getter and setter functions through a property.
+/// The static variables of `def_readwrite_static()` and `def_readonly_static()` have descriptors
+/// of another type with the same layout, which read and write the variable at `address`.
+struct native_member_descr {
+    PyObject_HEAD
+    /// The bound class, and its type_info: the member is at `offset` in its C++ values
+    PyTypeObject *owner;
+    const type_info *tinfo;
+    ssize_t offset;
+    /// The static variable, for static members (then `offset` is unused)
+    void *address;
+    PyObject *name;
+    PyObject *doc;
+    /// The C++ type of the member, for error messages
+    const char *type_name;
+    PyObject *(*get)(const void *member);
+    /// Returns false if the value can not be converted; null for read-only members
+    bool (*set)(void *member, PyObject *value);
+};
+
+template <typename D>
+PyObject *native_member_get(const void *member) {
+    return make_caster<D>::cast(
+               *static_cast<const D *>(member), return_value_policy::copy, handle())
+        .ptr();
+}
+
+template <typename D>
+bool native_member_set(void *member, PyObject *value) {
+    make_caster<D> conv;
+    if (!conv.load(value, true)) {
+        return false;
+    }
+    *static_cast<D *>(member) = cast_op<D>(conv);
+    return true;
+}
+
+template <typename D>
+const char *native_member_type_name() {
+    static constexpr auto name = make_caster<D>::name;
+    return name.text;
+}
+
+/// Returns the address of the member in `obj`, or sets a Python error and returns null
+inline void *native_member_ptr(native_member_descr *self, PyObject *obj) {
+    void *value = nullptr;
+    if (Py_TYPE(obj) == self->owner) {
+        // The class itself is the only (or the first) type of the instance
+        value = reinterpret_cast<instance *>(obj)
+                    ->get_value_and_holder(self->tinfo, /*throw_if_missing=*/false)
+                    .value_ptr();
+    } else if (PyObject_TypeCheck(obj, self->owner)) {
+        // Instances of derived classes may have the value at another address
+        type_caster_generic caster(self->tinfo);
+        if (caster.load(obj, /*convert=*/false)) {
+            value = caster.value;
+        }
+    } else {
+        PyErr_Format(PyExc_TypeError,
+                     "descriptor '%U' for '%s' objects doesn't apply to a '%s' object",
+                     self->name,
+                     self->owner->tp_name,
+                     Py_TYPE(obj)->tp_name);
+        return nullptr;
+    }
+    if (value == nullptr) {
+        PyErr_Format(PyExc_TypeError,
+                     "'%s' object is not initialized (its __init__ was not called)",
+                     Py_TYPE(obj)->tp_name);
+        return nullptr;
+    }
+    return static_cast<char *>(value) + self->offset;
+}
+
+extern "C" inline PyObject *pybind11_native_member_get(PyObject *self, PyObject *obj, PyObject *) {
+    if (obj == nullptr) {
+        return handle(self).inc_ref().ptr();
+    }
+    auto *descr = reinterpret_cast<native_member_descr *>(self);
+    void *member = native_member_ptr(descr, obj);
+    return member != nullptr ? descr->get(member) : nullptr;
+}
+
+extern "C" inline int pybind11_native_member_set(PyObject *self, PyObject *obj, PyObject *value) {
+    auto *descr = reinterpret_cast<native_member_descr *>(self);
+    if (descr->set == nullptr) {
+        PyErr_SetString(PyExc_AttributeError, "readonly attribute");
+        return -1;
+    }
+    if (value == nullptr) {
+        PyErr_SetString(PyExc_AttributeError, "can't delete attribute");
+        return -1;
+    }
+    void *member = native_member_ptr(descr, obj);
+    if (member == nullptr) {
+        return -1;
+    }
+    if (!descr->set(member, value)) {
+        PyErr_Format(PyExc_TypeError,
+                     "%s.%U: incompatible value %R (expected %s)",
+                     descr->owner->tp_name,
+                     descr->name,
+                     value,
+                     descr->type_name);
+        return -1;
+    }
+    return 0;
+}
+
+extern "C" inline PyObject *pybind11_native_static_get(PyObject *self, PyObject *, PyObject *) {
+    auto *descr = reinterpret_cast<native_member_descr *>(self);
+    return descr->get(descr->address);
+}
+
+extern "C" inline int pybind11_native_static_set(PyObject *self, PyObject *, PyObject *value) {
+    auto *descr = reinterpret_cast<native_member_descr *>(self);
+    if (descr->set == nullptr) {
+        PyErr_SetString(PyExc_AttributeError, "readonly attribute");
+        return -1;
+    }
+    if (value == nullptr) {
+        PyErr_SetString(PyExc_AttributeError, "can't delete attribute");
+        return -1;
+    }
+    if (!descr->set(descr->address, value)) {
+        PyErr_Format(PyExc_TypeError,
+                     "%s.%U: incompatible value %R (expected %s)",
+                     descr->owner->tp_name,
+                     descr->name,
+                     value,
+                     descr->type_name);
+        return -1;
+    }
+    return 0;
+}
+
+extern "C" inline int pybind11_native_member_traverse(PyObject *self, visitproc visit, void *arg) {
+    Py_VISIT(reinterpret_cast<native_member_descr *>(self)->owner);
+#    if PY_VERSION_HEX >= 0x03090000
+    Py_VISIT(Py_TYPE(self));
+#    endif
+    return 0;
+}
+
+extern "C" inline void pybind11_native_member_dealloc(PyObject *self) {
+    auto *descr = reinterpret_cast<native_member_descr *>(self);
+    auto *type = Py_TYPE(self);
+    PyObject_GC_UnTrack(self);
+    Py_XDECREF(descr->owner);
+    Py_XDECREF(descr->name);
+    Py_XDECREF(descr->doc);
+    type->tp_free(self);
+    Py_DECREF(type);
+}
+
+extern "C" inline PyObject *pybind11_native_member_repr(PyObject *self) {
+    auto *descr = reinterpret_cast<native_member_descr *>(self);
+    return PyUnicode_FromFormat("<native %smember '%U' of '%s' objects>",
+                                descr->address != nullptr ? "static " : "",
+                                descr->name,
+                                descr->owner->tp_name);
+}
+
+extern "C" inline PyObject *pybind11_native_member_get_name(PyObject *self, void *) {
+    return handle(reinterpret_cast<native_member_descr *>(self)->name).inc_ref().ptr();
+}
+
+extern "C" inline PyObject *pybind11_native_member_get_doc(PyObject *self, void *) {
+    PyObject *doc = reinterpret_cast<native_member_descr *>(self)->doc;
+    return handle(doc != nullptr ? doc : Py_None).inc_ref().ptr();
+}
+
+extern "C" inline PyObject *pybind11_native_member_get_objclass(PyObject *self, void *) {
+    auto *owner = (PyObject *) reinterpret_cast<native_member_descr *>(self)->owner;
+    return handle(owner).inc_ref().ptr();
+}
+
+/// Creates the type of `native_member_descr`, for members of instances or for static members.
+/// Return value: New reference.
+inline PyTypeObject *make_native_member_type(bool is_static) {
+    const char *name = is_static ? native_static_member_type_name : "pybind11_native_member";
+    auto name_obj = reinterpret_steal<object>(PYBIND11_FROM_STRING(name));
+
+    static PyGetSetDef getset[] = {
+        {"__name__", pybind11_native_member_get_name, nullptr, nullptr, nullptr},
+        {"__doc__", pybind11_native_member_get_doc, nullptr, nullptr, nullptr},
+        {"__objclass__", pybind11_native_member_get_objclass, nullptr, nullptr, nullptr},
+        {nullptr, nullptr, nullptr, nullptr, nullptr}};
+
+    /* Danger zone: from now (and until PyType_Ready), make sure to
+       issue no Python C API calls which could potentially invoke the
+       garbage collector (the GC will call type_traverse(), which will in
+       turn find the newly constructed type in an invalid state) */
+    auto *heap_type = (PyHeapTypeObject *) PyType_Type.tp_alloc(&PyType_Type, 0);
+    if (!heap_type) {
+        pybind11_fail("make_native_member_type(): error allocating type!");
+    }
+
+    heap_type->ht_name = name_obj.inc_ref().ptr();
+#    ifdef PYBIND11_BUILTIN_QUALNAME
+    heap_type->ht_qualname = name_obj.inc_ref().ptr();
+#    endif
+
+    auto *type = &heap_type->ht_type;
+    type->tp_name = name;
+    type->tp_basicsize = static_cast<ssize_t>(sizeof(native_member_descr));
+    type->tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HEAPTYPE | Py_TPFLAGS_HAVE_GC;
+    type->tp_dealloc = pybind11_native_member_dealloc;
+    type->tp_traverse = pybind11_native_member_traverse;
+    type->tp_repr = pybind11_native_member_repr;
+    type->tp_getset = getset;
+    type->tp_descr_get = is_static ? pybind11_native_static_get : pybind11_native_member_get;
+    type->tp_descr_set = is_static ? pybind11_native_static_set : pybind11_native_member_set;
+
+    if (PyType_Ready(type) < 0) {
+        pybind11_fail("make_native_member_type(): failure in PyType_Ready()!");
+    }
+
+    setattr((PyObject *) type, "__module__", str("pybind11_builtins"));
+    PYBIND11_SET_OLDPY_QUALNAME(type, name_obj);
+
+    return type;
+}
+
+/// Creates a `native_member_descr` for the member of type `D` at `offset` in the values of
+/// the class `owner`. Return value: New reference.
+template <typename D>
+object make_native_member(handle owner, ssize_t offset, const char *name, const char *doc,
+                          bool readonly) {
+    auto &type = get_local_internals().native_member_type;
+    if (type == nullptr) {
+        type = make_native_member_type(/*is_static=*/false);
+    }
+    auto *owner_type = (PyTypeObject *) owner.ptr();
+    auto *tinfo = get_type_info(owner_type);
+    auto result = reinterpret_steal<object>(PyType_GenericAlloc(type, 0));
+    if (!result) {
+        throw error_already_set();
+    }
+    auto *descr = reinterpret_cast<native_member_descr *>(result.ptr());
+    descr->owner = type_incref(owner_type);
+    descr->tinfo = tinfo;
+    descr->offset = offset;
+    descr->address = nullptr;
+    descr->name = str(name).release().ptr();
+    descr->doc = doc != nullptr ? str(doc).release().ptr() : nullptr;
+    descr->type_name = native_member_type_name<D>();
+    descr->get = &native_member_get<D>;
+    descr->set = readonly ? nullptr : &native_member_set<D>;
+    return result;
+}
+
+/// Creates a `native_member_descr` for the static variable of type `D` at `address`, in the class
+/// `owner`. Return value: New reference.
+template <typename D>
+object make_native_static_member(
+    handle owner, D *address, const char *name, const char *doc, bool readonly) {
+    auto &type = get_local_internals().native_static_member_type;
+    if (type == nullptr) {
+        type = make_native_member_type(/*is_static=*/true);
+    }
+    auto *owner_type = (PyTypeObject *) owner.ptr();
+    auto result = reinterpret_steal<object>(PyType_GenericAlloc(type, 0));
+    if (!result) {
+        throw error_already_set();
+    }
+    auto *descr = reinterpret_cast<native_member_descr *>(result.ptr());
+    descr->owner = type_incref(owner_type);
+    descr->tinfo = get_type_info(owner_type);
+    descr->offset = 0;
+    descr->address = const_cast<remove_cv_t<D> *>(address);
+    descr->name = str(name).release().ptr();
+    descr->doc = doc != nullptr ? str(doc).release().ptr() : nullptr;
+    descr->type_name = native_member_type_name<remove_cv_t<D>>();
+    descr->get = &native_member_get<remove_cv_t<D>>;
+    descr->set = readonly ? nullptr : &native_member_set<remove_cv_t<D>>;
+    return result;
+}
+
+#endif // PYPY
+
 /** Types with static properties need to handle `Type.static_prop = x` in a specific way.
     By default, Python replaces the `static_property` itself, but for wrapped C++ types
     we need to call `static_property.__set__()` in order to propagate the new value to
@@ -143,10 +448,13 @@ extern "C" inline int pybind11_meta_setattro(PyObject *obj, PyObject *name, PyOb
     //   1. `Type.static_prop = value`             --> descr_set: `Type.static_prop.__set__(value)`
     //   2. `Type.static_prop = other_static_prop` --> setattro:  replace existing `static_prop`
     //   3. `Type.regular_attribute = value`       --> setattro:  regular attribute assignment
+    // Native static members (see `native_member_descr`) are handled like static properties.
     auto *const static_prop = (PyObject *) get_internals().static_property_type;
-    const auto call_descr_set = (descr != nullptr) && (value != nullptr)
-                                && (PyObject_IsInstance(descr, static_prop) != 0)
-                                && (PyObject_IsInstance(value, static_prop) == 0);
+    const auto call_descr_set
+        = (descr != nullptr) && (value != nullptr)
+          && ((PyObject_IsInstance(descr, static_prop) != 0
+               && PyObject_IsInstance(value, static_prop) == 0)
+              || (is_native_static_member(descr) && !is_native_static_member(value)));
     if (call_descr_set) {
         // Call `static_property.__set__()` instead of replacing the `static_property`.
 #if !defined(PYPY_VERSION)
@@ -160,6 +468,15 @@ extern "C" inline int pybind11_meta_setattro(PyObject *obj, PyObject *name, PyOb
         }
 #endif
     } else {
+#if defined(PYBIND11_HAS_VECTORCALL)
+        // A new `__init__` or `__new__` replaces the constructor installed by `py::fast_init()`.
+        auto *type = (PyTypeObject *) obj;
+        if (type->tp_vectorcall != nullptr && PyUnicode_Check(name)
+            && (PyUnicode_CompareWithASCIIString(name, "__init__") == 0
+                || PyUnicode_CompareWithASCIIString(name, "__new__") == 0)) {
+            type->tp_vectorcall = nullptr;
+        }
+#endif
         // Replace existing attribute.
         return PyType_Type.tp_setattro(obj, name, value);
     }
@@ -206,41 +523,62 @@ extern "C" inline PyObject *pybind11_meta_call(PyObject *type, PyObject *args, P
     return self;
 }
 
-/// Cleanup the type-info for a pybind11-registered type.
-extern "C" inline void pybind11_meta_dealloc(PyObject *obj) {
-    auto *type = (PyTypeObject *) obj;
-    auto &internals = get_internals();
-
-    // A pybind11-registered type will:
-    // 1) be found in internals.registered_types_py
-    // 2) have exactly one associated `detail::type_info`
-    auto found_type = internals.registered_types_py.find(type);
-    if (found_type != internals.registered_types_py.end() && found_type->second.size() == 1
-        && found_type->second[0]->type == type) {
-
-        auto *tinfo = found_type->second[0];
-        auto tindex = std::type_index(*tinfo->cpptype);
-        internals.direct_conversions.erase(tindex);
-
-        if (tinfo->module_local) {
-            get_local_internals().registered_types_cpp.erase(tindex);
+/// Forgets the cached results of `get_override()` for a type that is being destroyed.
+inline void clear_override_cache(internals &internals, const PyObject *type) {
+#if PYBIND11_INTERNALS_VERSION > 5
+    auto &cache = internals.override_cache;
+#else
+    auto &cache = internals.inactive_override_cache;
+#endif
+    // Actually just `std::erase_if`, but that's only available in C++20
+    for (auto it = cache.begin(), last = cache.end(); it != last;) {
+#if PYBIND11_INTERNALS_VERSION > 5
+        const PyObject *cached_type = it->first.first;
+#else
+        const PyObject *cached_type = it->first;
+#endif
+        if (cached_type == type) {
+            it = cache.erase(it);
         } else {
-            internals.registered_types_cpp.erase(tindex);
+            ++it;
         }
-        internals.registered_types_py.erase(tinfo->type);
+    }
+}
 
-        // Actually just `std::erase_if`, but that's only available in C++20
-        auto &cache = internals.inactive_override_cache;
-        for (auto it = cache.begin(), last = cache.end(); it != last;) {
-            if (it->first == (PyObject *) tinfo->type) {
-                it = cache.erase(it);
+/// Cleanup the type-info for a pybind11-registered type.
+extern "C" inline void pybind11_meta_dealloc(PyObject *obj) {
+    with_internals([obj](internals &internals) {
+        auto *type = (PyTypeObject *) obj;
+
+        // A pybind11-registered type will:
+        // 1) be found in internals.registered_types_py
+        // 2) have exactly one associated `detail::type_info`
+        auto found_type = internals.registered_types_py.find(type);
+        if (found_type != internals.registered_types_py.end() && found_type->second.size() == 1
+            && found_type->second[0]->type == type) {
+
+            auto *tinfo = found_type->second[0];
+            auto tindex = std::type_index(*tinfo->cpptype);
+            internals.direct_conversions.erase(tindex);
+
+            if (tinfo->module_local) {
+                get_local_internals().registered_types_cpp.erase(tindex);
             } else {
-                ++it;
+                internals.registered_types_cpp.erase(tindex);
             }
-        }
+            internals.registered_types_py.erase(tinfo->type);
+#if defined(PYBIND11_HAS_TYPE_INFO_CACHE)
+            invalidate_type_info_caches(internals);
+#endif
 
-        delete tinfo;
-    }
+            clear_override_cache(internals, (PyObject *) tinfo->type);
+
+#if PYBIND11_INTERNALS_VERSION > 5
+            delete tinfo->enum_values;
+#endif
+            delete tinfo;
+        }
+    });
 
     PyType_Type.tp_dealloc(obj);
 }
@@ -270,8 +608,17 @@ inline PyTypeObject *make_default_metaclass() {
     type->tp_name = name;
     type->tp_base = type_incref(&PyType_Type);
     type->tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE | Py_TPFLAGS_HEAPTYPE;
+#if defined(PYBIND11_HAS_TYPE_INFO_SLOT)
+    type->tp_basicsize = static_cast<ssize_t>(sizeof(pybind11_heap_type));
+#endif
 
     type->tp_call = pybind11_meta_call;
+#if defined(PYBIND11_HAS_VECTORCALL)
+    // Types may set `tp_vectorcall` to be called without `pybind11_meta_call` (see
+    // `py::fast_init()`); for the others it is null, and calls go through `tp_call`.
+    type->tp_flags |= Py_TPFLAGS_HAVE_VECTORCALL;
+    type->tp_vectorcall_offset = offsetof(PyTypeObject, tp_vectorcall);
+#endif
 
     type->tp_setattro = pybind11_meta_setattro;
     type->tp_getattro = pybind11_meta_getattro;
@@ -288,6 +635,53 @@ inline PyTypeObject *make_default_metaclass() {
     return type;
 }
 
+#if PYBIND11_INTERNALS_VERSION > 5
+/// Appends the registered C++ bases of `tinfo` to `out`, depth-first, for
+/// `type_info::base_casts`. `from` is the index that their casts apply to.
+inline void collect_base_casts(const detail::type_info *tinfo,
+                               size_t from,
+                               std::vector<base_cast> &out) {
+    for (handle h : reinterpret_borrow<tuple>(tinfo->type->tp_bases)) {
+        if (auto *parent_tinfo = get_type_info((PyTypeObject *) h.ptr())) {
+            for (auto &c : parent_tinfo->implicit_casts) {
+                if (c.first == tinfo->cpptype) {
+                    out.push_back({parent_tinfo, from, c.second});
+                    collect_base_casts(parent_tinfo, out.size(), out);
+                    break;
+                }
+            }
+        }
+    }
+}
+
+/// For multiple inheritance types we need to register/deregister base pointers for any base
+/// classes with pointers that are difference from the instance value pointer so that we can
+/// correctly recognize an offset base class pointer. This calls a function with any offset base
+/// ptrs.
+inline void traverse_offset_bases(void *valueptr,
+                                  const detail::type_info *tinfo,
+                                  instance *self,
+                                  bool (*f)(void * /*parentptr*/, instance * /*self*/)) {
+    const auto &bases = tinfo->base_casts;
+    // ptrs[0] is the value pointer, ptrs[i + 1] the pointer to bases[i]
+    void *small_ptrs[16];
+    std::vector<void *> large_ptrs;
+    void **ptrs = small_ptrs;
+    if (bases.size() >= 16) {
+        large_ptrs.resize(bases.size() + 1);
+        ptrs = large_ptrs.data();
+    }
+    ptrs[0] = valueptr;
+    for (size_t i = 0; i < bases.size(); ++i) {
+        auto *childptr = ptrs[bases[i].from];
+        auto *parentptr = bases[i].cast(childptr);
+        if (parentptr != childptr) {
+            f(parentptr, self);
+        }
+        ptrs[i + 1] = parentptr;
+    }
+}
+#else
 /// For multiple inheritance types we need to recursively register/deregister base pointers for any
 /// base classes with pointers that are difference from the instance value pointer so that we can
 /// correctly recognize an offset base class pointer. This calls a function with any offset base
@@ -311,31 +705,32 @@ inline void traverse_offset_bases(void *valueptr,
         }
     }
 }
+#endif
 
 inline bool register_instance_impl(void *ptr, instance *self) {
-    get_internals().registered_instances.emplace(ptr, self);
+    with_instance_map(ptr, [&](instance_map &instances) { instances.emplace(ptr, self); });
     return true; // unused, but gives the same signature as the deregister func
 }
 inline bool deregister_instance_impl(void *ptr, instance *self) {
-    auto &registered_instances = get_internals().registered_instances;
-    auto range = registered_instances.equal_range(ptr);
-    for (auto it = range.first; it != range.second; ++it) {
-        if (self == it->second) {
-            registered_instances.erase(it);
-            return true;
-        }
-    }
-    return false;
+    return with_instance_map(ptr,
+                             [&](instance_map &instances) { return instances.erase(ptr, self); });
 }
 
 inline void register_instance(instance *self, void *valptr, const type_info *tinfo) {
+    if (!uses_instance_registry(tinfo)) {
+        return;
+    }
     register_instance_impl(valptr, self);
     if (!tinfo->simple_ancestors) {
         traverse_offset_bases(valptr, tinfo, self, register_instance_impl);
     }
+    PYBIND11_TRACE(instance_registered, tinfo->type->tp_name, valptr);
 }
 
 inline bool deregister_instance(instance *self, void *valptr, const type_info *tinfo) {
+    if (!uses_instance_registry(tinfo)) {
+        return true;
+    }
     bool ret = deregister_instance_impl(valptr, self);
     if (!tinfo->simple_ancestors) {
         traverse_offset_bases(valptr, tinfo, self, deregister_instance_impl);
@@ -343,6 +738,124 @@ inline bool deregister_instance(instance *self, void *valptr, const type_info *t
     return ret;
 }
 
+#if !defined(PYPY_VERSION) && !defined(Py_GIL_DISABLED)                                          \
+    && !defined(PYBIND11_NO_INSTANCE_FREELIST)
+#    define PYBIND11_HAS_INSTANCE_FREELIST
+#endif
+
+#if defined(PYBIND11_HAS_INSTANCE_FREELIST)
+/// Bounded freelists of the memory of destroyed instances, by size, so that instances of types
+/// which are created and destroyed all the time are recycled instead of going back through the
+/// object allocator. Instances tracked by the garbage collector are never pooled. The pooled
+/// blocks belong to the allocator of one interpreter: they are only reused there, and freed
+/// when that interpreter's state dict is cleared during finalization.
+struct instance_freelist {
+    static constexpr size_t max_block_size = 256;
+    static constexpr size_t max_blocks = 32;
+
+    PyInterpreterState *owner = nullptr;
+    std::vector<void *> buckets[max_block_size / sizeof(void *)];
+
+    static instance_freelist &get() {
+        // Leaked on purpose, like the internals
+        static auto *freelist = new instance_freelist();
+        return *freelist;
+    }
+
+    /// Returns the pool for blocks of `size` bytes, or nullptr if they cannot be pooled. Only
+    /// claims the freelist for the current interpreter if `claim` is set.
+    std::vector<void *> *bucket(size_t size, bool claim) {
+        if (size == 0 || size > max_block_size) {
+            return nullptr;
+        }
+        // Subinterpreters with a GIL of their own would race on the buckets
+        if (!in_main_interpreter()) {
+            return nullptr;
+        }
+        auto *interpreter = current_interpreter();
+        if (owner != interpreter) {
+            if (owner != nullptr || !claim || !Py_IsInitialized() || !claim_for(interpreter)) {
+                return nullptr;
+            }
+        }
+        return &buckets[(size - 1) / sizeof(void *)];
+    }
+
+    bool claim_for(PyInterpreterState *interpreter) {
+        // The freelist stays claimed for as long as this capsule lives in the state dict
+        auto *cap = PyCapsule_New(this, nullptr, [](PyObject *) { get().release(); });
+        if (cap == nullptr) {
+            PyErr_Clear();
+            return false;
+        }
+        auto key = "__pybind11_instance_freelist_"
+                   + std::to_string(reinterpret_cast<std::uintptr_t>(this)) + "__";
+        int status = -1;
+        try {
+            status = PyDict_SetItemString(get_python_state_dict().ptr(), key.c_str(), cap);
+        } catch (error_already_set &) {
+        }
+        Py_DECREF(cap);
+        if (status != 0) {
+            PyErr_Clear();
+            return false;
+        }
+        owner = interpreter;
+        return true;
+    }
+
+    void release() {
+        owner = nullptr;
+        for (auto &bucket : buckets) {
+            for (void *block : bucket) {
+                PyObject_Free(block);
+            }
+            bucket.clear();
+        }
+    }
+};
+
+/// `tp_alloc` of pybind11 types: reuses a pooled block for instances that are not tracked by
+/// the garbage collector, which is equivalent to `PyType_GenericAlloc` for them.
+extern "C" inline PyObject *pybind11_object_alloc(PyTypeObject *type, Py_ssize_t nitems) {
+    if (nitems == 0 && type->tp_itemsize == 0 && !PyType_IS_GC(type)) {
+        const auto size = static_cast<size_t>(type->tp_basicsize);
+        auto *bucket = instance_freelist::get().bucket(size, /*claim=*/true);
+        if (bucket != nullptr && !bucket->empty()) {
+            void *block = bucket->back();
+            bucket->pop_back();
+            std::memset(block, 0, size);
+            auto *self = static_cast<PyObject *>(block);
+#    if PY_VERSION_HEX < 0x03080000
+            // `PyObject_Init` only takes the reference to heap types from Python 3.8 on
+            Py_INCREF(type);
+#    endif
+            return PyObject_Init(self, type);
+        }
+    }
+    return PyType_GenericAlloc(type, nitems);
+}
+
+/// `tp_free` of pybind11 types, the counterpart of `pybind11_object_alloc`
+extern "C" inline void pybind11_object_free(void *ptr) {
+    auto *self = static_cast<PyObject *>(ptr);
+    auto *type = Py_TYPE(self);
+    if (PyType_IS_GC(type)) {
+        PyObject_GC_Del(ptr);
+        return;
+    }
+    if (type->tp_itemsize == 0) {
+        auto *bucket = instance_freelist::get().bucket(static_cast<size_t>(type->tp_basicsize),
+                                                       /*claim=*/false);
+        if (bucket != nullptr && bucket->size() < instance_freelist::max_blocks) {
+            bucket->push_back(ptr);
+            return;
+        }
+    }
+    PyObject_Free(ptr);
+}
+#endif
+
 /// Instance creation function for all pybind11 types. It allocates the internal instance layout
 /// for holding C++ objects and holders.  Allocation is done lazily (the first time the instance is
 /// cast to a reference or pointer), and initialization is done by an `__init__` function.
@@ -380,27 +893,101 @@ extern "C" inline int pybind11_object_init(PyObject *self, PyObject *, PyObject
 }
 
 inline void add_patient(PyObject *nurse, PyObject *patient) {
-    auto &internals = get_internals();
     auto *instance = reinterpret_cast<detail::instance *>(nurse);
+#if PYBIND11_INTERNALS_VERSION > 5
+    // The first patient is stored in the instance itself; only a second one needs a list
+    with_internals([&](internals &) {
+        if (!instance->has_patients) {
+            instance->patients = handle(patient).inc_ref().ptr();
+            instance->has_patients = true;
+            return;
+        }
+        if (!instance->patients_in_list) {
+            PyObject *list = PyList_New(1);
+            if (!list) {
+                throw error_already_set();
+            }
+            PyList_SET_ITEM(list, 0, instance->patients);
+            instance->patients = list;
+            instance->patients_in_list = true;
+        }
+        if (PyList_Append(instance->patients, patient) != 0) {
+            throw error_already_set();
+        }
+    });
+#else
     instance->has_patients = true;
     Py_INCREF(patient);
-    internals.patients[nurse].push_back(patient);
+    with_internals([&](internals &internals) { internals.patients[nurse].push_back(patient); });
+#endif
 }
 
 inline void clear_patients(PyObject *self) {
     auto *instance = reinterpret_cast<detail::instance *>(self);
-    auto &internals = get_internals();
-    auto pos = internals.patients.find(self);
-    assert(pos != internals.patients.end());
+#if PYBIND11_INTERNALS_VERSION > 5
+    // Releasing the patients can run more Python code, so detach them from the instance first
+    PyObject *patients = with_internals([instance](internals &) {
+        PyObject *result = instance->patients;
+        instance->patients = nullptr;
+        instance->has_patients = false;
+        instance->patients_in_list = false;
+        return result;
+    });
+    Py_DECREF(patients);
+#else
     // Clearing the patients can cause more Python code to run, which
     // can invalidate the iterator. Extract the vector of patients
     // from the unordered_map first.
-    auto patients = std::move(pos->second);
-    internals.patients.erase(pos);
+    auto patients = with_internals([self](internals &internals) {
+        auto pos = internals.patients.find(self);
+        assert(pos != internals.patients.end());
+        auto result = std::move(pos->second);
+        internals.patients.erase(pos);
+        return result;
+    });
     instance->has_patients = false;
     for (PyObject *&patient : patients) {
         Py_CLEAR(patient);
     }
+#endif
+}
+
+/// py::slots: the value of the attribute slot at `offset` of an instance
+inline PyObject *&instance_slot(PyObject *self, ssize_t offset) {
+    return *reinterpret_cast<PyObject **>(reinterpret_cast<char *>(self) + offset);
+}
+
+/// py::slots: calls `f` with the offset of each attribute slot in the instances of a registered
+/// type, including those of its bases. The offsets are read from the members of the types rather
+/// than kept in their `type_info`: only `enable_slots()` gives pybind11 types members, and the
+/// bases of a registered type are all registered types (or `object`).
+template <typename F>
+void for_each_slot_offset(PyTypeObject *type, F &&f) {
+    PyObject *mro = type->tp_mro;
+    for (ssize_t i = 0; mro != nullptr && i < PyTuple_GET_SIZE(mro); ++i) {
+        const auto *base = reinterpret_cast<PyTypeObject *>(PyTuple_GET_ITEM(mro, i));
+        for (auto *member = base->tp_members; member != nullptr && member->name != nullptr;
+             ++member) {
+            if (member->type == PYBIND11_T_OBJECT_EX) {
+                f(member->offset);
+            }
+        }
+    }
+}
+
+/// py::slots: whether the instances of a registered type have attribute slots
+inline bool has_instance_slots(PyTypeObject *type) {
+    bool found = false;
+    for_each_slot_offset(type, [&](ssize_t) { found = true; });
+    return found;
+}
+
+/// py::slots: release the values of all attribute slots of an instance
+inline void clear_instance_slots(PyObject *self) {
+    for (auto *tinfo : all_type_info(Py_TYPE(self))) {
+        for_each_slot_offset(tinfo->type,
+                             [self](ssize_t offset) { Py_CLEAR(instance_slot(self, offset)); });
+    }
 }
 
 /// Clears all internal data from the instance and removes it from registered instances in
@@ -437,6 +1024,11 @@ inline void clear_instance(PyObject *self) {
         Py_CLEAR(*dict_ptr);
     }
 
+    // Only types with attribute slots or a __dict__ support garbage collection
+    if (PyType_IS_GC(Py_TYPE(self))) {
+        clear_instance_slots(self);
+    }
+
     if (instance->has_patients) {
         clear_patients(self);
     }
@@ -449,7 +1041,7 @@ extern "C" inline void pybind11_object_dealloc(PyObject *self) {
 
     // If this is a GC tracked object, untrack it first
     // Note that the track call is implicitly done by the
-    // default tp_alloc, which we never override.
+    // default tp_alloc, which is always used for these.
     if (PyType_HasFeature(type, Py_TPFLAGS_HAVE_GC) != 0) {
         PyObject_GC_UnTrack(self);
     }
@@ -520,10 +1112,25 @@ inline PyObject *make_object_base_type(PyTypeObject *metaclass) {
     return (PyObject *) heap_type;
 }
 
-/// dynamic_attr: Allow the garbage collector to traverse the internal instance `__dict__`.
+/// dynamic_attr, slots: Allow the garbage collector to traverse the internal instance `__dict__`
+/// and attribute slots.
 extern "C" inline int pybind11_traverse(PyObject *self, visitproc visit, void *arg) {
-    PyObject *&dict = *_PyObject_GetDictPtr(self);
-    Py_VISIT(dict);
+    PyObject **dict_ptr = _PyObject_GetDictPtr(self);
+    if (dict_ptr) {
+        Py_VISIT(*dict_ptr);
+    }
+    for (auto *tinfo : all_type_info(Py_TYPE(self))) {
+        int result = 0;
+        for_each_slot_offset(tinfo->type, [&](ssize_t offset) {
+            if (result == 0) {
+                PyObject *value = instance_slot(self, offset);
+                result = value != nullptr ? visit(value, arg) : 0;
+            }
+        });
+        if (result != 0) {
+            return result;
+        }
+    }
 // https://docs.python.org/3/c-api/typeobj.html#c.PyTypeObject.tp_traverse
 #if PY_VERSION_HEX >= 0x03090000
     Py_VISIT(Py_TYPE(self));
@@ -531,10 +1138,13 @@ extern "C" inline int pybind11_traverse(PyObject *self, visitproc visit, void *a
     return 0;
 }
 
-/// dynamic_attr: Allow the GC to clear the dictionary.
+/// dynamic_attr, slots: Allow the GC to clear the dictionary and attribute slots.
 extern "C" inline int pybind11_clear(PyObject *self) {
-    PyObject *&dict = *_PyObject_GetDictPtr(self);
-    Py_CLEAR(dict);
+    PyObject **dict_ptr = _PyObject_GetDictPtr(self);
+    if (dict_ptr) {
+        Py_CLEAR(*dict_ptr);
+    }
+    clear_instance_slots(self);
     return 0;
 }
 
@@ -565,17 +1175,167 @@ inline void enable_dynamic_attributes(PyHeapTypeObject *heap_type) {
     type->tp_getset = getset;
 }
 
-/// buffer_protocol: Fill in the view as specified by flags.
-extern "C" inline int pybind11_getbuffer(PyObject *obj, Py_buffer *view, int flags) {
-    // Look for a `get_buffer` implementation in this type's info or any bases (following MRO).
-    type_info *tinfo = nullptr;
-    for (auto type : reinterpret_borrow<tuple>(Py_TYPE(obj)->tp_mro)) {
-        tinfo = get_type_info((PyTypeObject *) type.ptr());
+/// Reserve an attribute slot for each of `names` at the end of the instances, accessed through
+/// member descriptors, and opt into garbage collection (which is also needed for the slots
+/// inherited from a base class when `names` is empty).
+inline void enable_slots(PyHeapTypeObject *heap_type, const std::vector<const char *> &names) {
+    auto *type = &heap_type->ht_type;
+    type->tp_flags |= Py_TPFLAGS_HAVE_GC;
+    type->tp_traverse = pybind11_traverse;
+    type->tp_clear = pybind11_clear;
+    if (names.empty()) {
+        return;
+    }
+
+    // A value stored inside the instances (py::inline_storage) may end unaligned
+    const auto slot_size = static_cast<ssize_t>(sizeof(PyObject *));
+    type->tp_basicsize = (type->tp_basicsize + slot_size - 1) / slot_size * slot_size;
+
+    // Like the name of the type, the members are never freed
+    auto *members = new PyMemberDef[names.size() + 1]();
+    for (size_t i = 0; i < names.size(); ++i) {
+#if PY_VERSION_HEX < 0x03070000
+        members[i].name = const_cast<char *>(c_str(names[i]));
+#else
+        members[i].name = c_str(names[i]);
+#endif
+        members[i].type = PYBIND11_T_OBJECT_EX;
+        members[i].offset = type->tp_basicsize;
+        type->tp_basicsize += slot_size;
+    }
+    type->tp_members = members;
+}
+
+/// The callbacks of a `def_buffer` that fills `Py_buffer` directly. `fill` sets `buf`,
+/// `itemsize`, `format`, `ndim`, `shape`, `strides` and `readonly` of `view` for the object
+/// `obj`, and returns false if `obj` cannot be cast to the bound type; errors are thrown.
+/// `release`, if any, is called once the consumer releases the view.
+struct buffer_filler {
+    bool (*fill)(PyObject *obj, Py_buffer *view, int flags, void *data);
+    void (*release)(PyObject *obj, Py_buffer *view, void *data);
+    void *data;
+};
+
+/// `type_info::get_buffer` for types with a `buffer_filler`, which `pybind11_getbuffer` uses
+/// directly. This conversion into a `buffer_info` is only used by other extension modules,
+/// e.g. for derived classes that do not share the same `pybind11_getbuffer`. Their
+/// `pybind11_releasebuffer` does not know about the release callback, which is therefore called
+/// as soon as the view has been copied.
+inline buffer_info *filled_buffer_info(PyObject *obj, void *data) {
+    const auto *filler = static_cast<const buffer_filler *>(data);
+    Py_buffer view{};
+    if (!filler->fill(obj, &view, PyBUF_STRIDES | PyBUF_FORMAT, filler->data)) {
+        return nullptr;
+    }
+    std::vector<ssize_t> shape(view.shape, view.shape + view.ndim);
+    std::vector<ssize_t> strides
+        = view.strides != nullptr ? std::vector<ssize_t>(view.strides, view.strides + view.ndim)
+                                  : c_strides(shape, view.itemsize);
+    auto *info = new buffer_info(view.buf,
+                                 view.itemsize,
+                                 view.format != nullptr ? view.format : "B",
+                                 view.ndim,
+                                 std::move(shape),
+                                 std::move(strides),
+                                 view.readonly != 0);
+    if (filler->release != nullptr) {
+        filler->release(obj, &view, filler->data);
+    }
+    return info;
+}
+
+/// buffer_protocol: Check a view whose fields are all set against the request of the consumer,
+/// and complete it: drop what was not requested, and reference the exporting object.
+inline int finish_buffer(PyObject *obj, Py_buffer *view, int flags) {
+    if ((flags & PyBUF_WRITABLE) == PyBUF_WRITABLE && view->readonly != 0) {
+        PyErr_SetString(PyExc_BufferError, "Writable buffer requested for readonly storage");
+        return -1;
+    }
+    view->len = view->itemsize;
+    for (int i = 0; i < view->ndim; ++i) {
+        view->len *= view->shape[i];
+    }
+    // Consumers that do not ask for strides assume C-contiguous data
+    const bool strides = (flags & PyBUF_STRIDES) == PyBUF_STRIDES;
+    if ((!strides || (flags & PyBUF_C_CONTIGUOUS) == PyBUF_C_CONTIGUOUS)
+        && PyBuffer_IsContiguous(view, 'C') == 0) {
+        PyErr_SetString(PyExc_BufferError,
+                        "C-contiguous buffer requested for non-contiguous storage");
+        return -1;
+    }
+    if ((flags & PyBUF_F_CONTIGUOUS) == PyBUF_F_CONTIGUOUS
+        && PyBuffer_IsContiguous(view, 'F') == 0) {
+        PyErr_SetString(PyExc_BufferError,
+                        "Fortran-contiguous buffer requested for non-contiguous storage");
+        return -1;
+    }
+    if ((flags & PyBUF_ANY_CONTIGUOUS) == PyBUF_ANY_CONTIGUOUS
+        && PyBuffer_IsContiguous(view, 'A') == 0) {
+        PyErr_SetString(PyExc_BufferError,
+                        "Contiguous buffer requested for non-contiguous storage");
+        return -1;
+    }
+    if ((flags & PyBUF_FORMAT) != PyBUF_FORMAT) {
+        view->format = nullptr;
+    }
+    if (!strides) {
+        view->strides = nullptr;
+        if ((flags & PyBUF_ND) != PyBUF_ND) {
+            view->ndim = 1;
+            view->shape = nullptr;
+        }
+    }
+    view->obj = obj;
+    Py_INCREF(view->obj);
+    return 0;
+}
+
+/// buffer_protocol: Fill in the view from a `buffer_filler`, without creating a `buffer_info`
+inline int fill_buffer(PyObject *obj, Py_buffer *view, int flags, const buffer_filler &filler) {
+    bool filled = false;
+    // Exceptions must not propagate into the interpreter; pybind11's own ones can be translated
+    try {
+        filled = filler.fill(obj, view, flags, filler.data);
+    } catch (error_already_set &e) {
+        e.restore();
+        return -1;
+    } catch (const builtin_exception &e) {
+        e.set_error();
+        return -1;
+    }
+    if (!filled) {
+        PyErr_SetString(PyExc_BufferError, "pybind11_getbuffer(): Internal error");
+        return -1;
+    }
+    // Marks views to be passed to the release callback
+    view->internal = filler.release != nullptr ? const_cast<buffer_filler *>(&filler) : nullptr;
+    if (finish_buffer(obj, view, flags) != 0) {
+        if (filler.release != nullptr) {
+            error_scope scope; // Preserve the BufferError
+            filler.release(obj, view, filler.data);
+        }
+        std::memset(view, 0, sizeof(Py_buffer));
+        return -1;
+    }
+    return 0;
+}
+
+// The type info with the `get_buffer` implementation for a type or any of its bases
+inline type_info *get_buffer_type_info(PyTypeObject *type) {
+    for (auto base : reinterpret_borrow<tuple>(type->tp_mro)) {
+        type_info *tinfo = get_type_info((PyTypeObject *) base.ptr());
         if (tinfo && tinfo->get_buffer) {
-            break;
+            return tinfo;
         }
     }
-    if (view == nullptr || !tinfo || !tinfo->get_buffer) {
+    return nullptr;
+}
+
+/// buffer_protocol: Fill in the view as specified by flags.
+extern "C" inline int pybind11_getbuffer(PyObject *obj, Py_buffer *view, int flags) {
+    // Look for a `get_buffer` implementation in this type's info or any bases (following MRO).
+    type_info *tinfo = get_buffer_type_info(Py_TYPE(obj));
+    if (view == nullptr || !tinfo) {
         if (view) {
             view->obj = nullptr;
         }
@@ -583,37 +1343,60 @@ extern "C" inline int pybind11_getbuffer(PyObject *obj, Py_buffer *view, int fla
         return -1;
     }
     std::memset(view, 0, sizeof(Py_buffer));
-    buffer_info *info = tinfo->get_buffer(obj, tinfo->get_buffer_data);
-    if ((flags & PyBUF_WRITABLE) == PyBUF_WRITABLE && info->readonly) {
-        delete info;
-        // view->obj = nullptr;  // Was just memset to 0, so not necessary
-        PyErr_SetString(PyExc_BufferError, "Writable buffer requested for readonly storage");
+    if (tinfo->get_buffer == &filled_buffer_info) {
+        return fill_buffer(
+            obj, view, flags, *static_cast<const buffer_filler *>(tinfo->get_buffer_data));
+    }
+    buffer_info *info = nullptr;
+    // Exceptions must not propagate into the interpreter; pybind11's own ones can be translated
+    try {
+        info = tinfo->get_buffer(obj, tinfo->get_buffer_data);
+    } catch (error_already_set &e) {
+        e.restore();
+        return -1;
+    } catch (const builtin_exception &e) {
+        e.set_error();
+        return -1;
+    }
+    if (info == nullptr) {
+        PyErr_SetString(PyExc_BufferError, "pybind11_getbuffer(): Internal error");
         return -1;
     }
-    view->obj = obj;
-    view->ndim = 1;
     view->internal = info;
     view->buf = info->ptr;
     view->itemsize = info->itemsize;
-    view->len = view->itemsize;
-    for (auto s : info->shape) {
-        view->len *= s;
-    }
     view->readonly = static_cast<int>(info->readonly);
-    if ((flags & PyBUF_FORMAT) == PyBUF_FORMAT) {
-        view->format = const_cast<char *>(info->format.c_str());
-    }
-    if ((flags & PyBUF_STRIDES) == PyBUF_STRIDES) {
-        view->ndim = (int) info->ndim;
-        view->strides = info->strides.data();
-        view->shape = info->shape.data();
+    view->format = const_cast<char *>(info->format.c_str());
+    view->ndim = (int) info->ndim;
+    view->strides = info->strides.data();
+    view->shape = info->shape.data();
+    if (finish_buffer(obj, view, flags) != 0) {
+        delete info;
+        std::memset(view, 0, sizeof(Py_buffer));
+        return -1;
     }
-    Py_INCREF(view->obj);
     return 0;
 }
 
 /// buffer_protocol: Release the resources of the buffer.
-extern "C" inline void pybind11_releasebuffer(PyObject *, Py_buffer *view) {
+extern "C" inline void pybind11_releasebuffer(PyObject *obj, Py_buffer *view) {
+    if (view->internal == nullptr) {
+        return;
+    }
+    type_info *tinfo = get_buffer_type_info(Py_TYPE(obj));
+    if (tinfo && tinfo->get_buffer == &filled_buffer_info) {
+        const auto *filler = static_cast<const buffer_filler *>(view->internal);
+        // Exceptions must not propagate into the interpreter
+        try {
+            filler->release(obj, view, filler->data);
+        } catch (error_already_set &e) {
+            e.discard_as_unraisable(reinterpret_borrow<object>(obj));
+        } catch (const builtin_exception &e) {
+            e.set_error();
+            PyErr_WriteUnraisable(obj);
+        }
+        return;
+    }
     delete (buffer_info *) view->internal;
 }
 
@@ -625,6 +1408,211 @@ inline void enable_buffer_protocol(PyHeapTypeObject *heap_type) {
     heap_type->as_buffer.bf_releasebuffer = pybind11_releasebuffer;
 }
 
+#if defined(PYBIND11_HAS_VECTORCALL)
+/// The slots of `__len__`, `__getitem__`, `__setitem__`/`__delitem__`, `__contains__` and
+/// `__hash__` defined with `class_::def`. CPython's generic slots look the method up, bind it to
+/// the instance in a new method object and call that, and then convert the result; these call the
+/// pybind11 function directly with the instance as first argument, and read `__len__`,
+/// `__contains__` and `__hash__` results without going through the number protocol where they are
+/// of the expected type. If the method is not a pybind11 function (e.g. after it was replaced, in
+/// which case CPython usually resets the slot anyway), the generic slot that was replaced is used.
+struct special_method_slots {
+    lenfunc sq_length = nullptr;
+    lenfunc mp_length = nullptr;
+    binaryfunc mp_subscript = nullptr;
+    objobjargproc mp_ass_subscript = nullptr;
+    objobjproc sq_contains = nullptr;
+    hashfunc tp_hash = nullptr;
+};
+
+// Defined in pybind11.h: translates the exception being handled with the registered translators
+inline PyObject *handle_active_exception();
+
+inline special_method_slots &generic_special_method_slots() {
+    static special_method_slots slots;
+    return slots;
+}
+
+/// Returns the pybind11 function (a borrowed reference) of a special method of `self`'s type, or
+/// nullptr if the method is something else
+inline PyObject *special_method_function(PyObject *self, const interned_str &name) {
+    PyObject *descr = _PyType_Lookup(Py_TYPE(self), name.get().ptr());
+    if (descr == nullptr || !PyInstanceMethod_Check(descr)) {
+        return nullptr;
+    }
+    PyObject *func = PyInstanceMethod_GET_FUNCTION(descr);
+    return PyCFunction_Check(func) ? func : nullptr;
+}
+
+inline PyObject *
+call_special_method_function(PyObject *func, PyObject *const *args, size_t nargs) {
+    // The method may be replaced while it runs
+    Py_INCREF(func);
+    PyObject *result = PyObject_Vectorcall(func, args, nargs, nullptr);
+    Py_DECREF(func);
+    return result;
+}
+
+inline Py_ssize_t special_method_length(PyObject *self, lenfunc generic) {
+    static interned_str name("__len__");
+    PyObject *func = special_method_function(self, name);
+    if (func == nullptr) {
+        return generic(self);
+    }
+    auto result = reinterpret_steal<object>(call_special_method_function(func, &self, 1));
+    if (result && !PyLong_CheckExact(result.ptr())) {
+        result = reinterpret_steal<object>(PyNumber_Index(result.ptr()));
+    }
+    if (!result) {
+        return -1;
+    }
+    Py_ssize_t length = PyLong_AsSsize_t(result.ptr());
+    if (length < 0) {
+        if (!PyErr_Occurred()) {
+            PyErr_SetString(PyExc_ValueError, "__len__() should return >= 0");
+        }
+        return -1;
+    }
+    return length;
+}
+
+extern "C" inline Py_ssize_t pybind11_sq_length(PyObject *self) {
+    try {
+        return special_method_length(self, generic_special_method_slots().sq_length);
+    } catch (...) {
+        handle_active_exception();
+        return -1;
+    }
+}
+
+extern "C" inline Py_ssize_t pybind11_mp_length(PyObject *self) {
+    try {
+        return special_method_length(self, generic_special_method_slots().mp_length);
+    } catch (...) {
+        handle_active_exception();
+        return -1;
+    }
+}
+
+extern "C" inline PyObject *pybind11_mp_subscript(PyObject *self, PyObject *key) {
+    try {
+        static interned_str name("__getitem__");
+        PyObject *func = special_method_function(self, name);
+        if (func == nullptr) {
+            return generic_special_method_slots().mp_subscript(self, key);
+        }
+        PyObject *args[] = {self, key};
+        return call_special_method_function(func, args, 2);
+    } catch (...) {
+        return handle_active_exception();
+    }
+}
+
+extern "C" inline int pybind11_mp_ass_subscript(PyObject *self, PyObject *key, PyObject *value) {
+    try {
+        static interned_str set_name("__setitem__");
+        static interned_str del_name("__delitem__");
+        PyObject *func = special_method_function(self, value != nullptr ? set_name : del_name);
+        if (func == nullptr) {
+            return generic_special_method_slots().mp_ass_subscript(self, key, value);
+        }
+        PyObject *args[] = {self, key, value};
+        PyObject *result = call_special_method_function(func, args, value != nullptr ? 3 : 2);
+        if (result == nullptr) {
+            return -1;
+        }
+        Py_DECREF(result);
+        return 0;
+    } catch (...) {
+        handle_active_exception();
+        return -1;
+    }
+}
+
+extern "C" inline int pybind11_sq_contains(PyObject *self, PyObject *value) {
+    try {
+        static interned_str name("__contains__");
+        PyObject *func = special_method_function(self, name);
+        if (func == nullptr) {
+            return generic_special_method_slots().sq_contains(self, value);
+        }
+        PyObject *args[] = {self, value};
+        PyObject *result = call_special_method_function(func, args, 2);
+        if (result == nullptr) {
+            return -1;
+        }
+        const int contains = result == Py_True    ? 1
+                             : result == Py_False ? 0
+                                                  : PyObject_IsTrue(result);
+        Py_DECREF(result);
+        return contains;
+    } catch (...) {
+        handle_active_exception();
+        return -1;
+    }
+}
+
+extern "C" inline Py_hash_t pybind11_tp_hash(PyObject *self) {
+    try {
+        static interned_str name("__hash__");
+        PyObject *func = special_method_function(self, name);
+        if (func == nullptr) {
+            return generic_special_method_slots().tp_hash(self);
+        }
+        auto result = reinterpret_steal<object>(call_special_method_function(func, &self, 1));
+        if (!result) {
+            return -1;
+        }
+        if (!PyLong_Check(result.ptr())) {
+            PyErr_SetString(PyExc_TypeError, "__hash__ method should return an integer");
+            return -1;
+        }
+        // Like CPython: the hash of the integer if it does not fit, and never -1
+        Py_hash_t hash = PyLong_AsSsize_t(result.ptr());
+        if (hash == -1 && PyErr_Occurred()) {
+            PyErr_Clear();
+            hash = PyLong_Type.tp_hash(result.ptr());
+        }
+        return hash == -1 ? -2 : hash;
+    } catch (...) {
+        handle_active_exception();
+        return -1;
+    }
+}
+
+template <typename Slot>
+void install_special_method_slot(Slot &slot, Slot fast, Slot &generic) {
+    if (slot != nullptr && slot != fast) {
+        generic = slot;
+        slot = fast;
+    }
+}
+
+/// Installs the slots of a special method just defined with `class_::def`, which has reset them
+/// to CPython's generic slots
+inline void install_special_method_slots(PyTypeObject *type, const char *name) {
+    auto &generic = generic_special_method_slots();
+    if (std::strcmp(name, "__len__") == 0) {
+        install_special_method_slot(
+            type->tp_as_sequence->sq_length, &pybind11_sq_length, generic.sq_length);
+        install_special_method_slot(
+            type->tp_as_mapping->mp_length, &pybind11_mp_length, generic.mp_length);
+    } else if (std::strcmp(name, "__getitem__") == 0) {
+        install_special_method_slot(
+            type->tp_as_mapping->mp_subscript, &pybind11_mp_subscript, generic.mp_subscript);
+    } else if (std::strcmp(name, "__setitem__") == 0 || std::strcmp(name, "__delitem__") == 0) {
+        install_special_method_slot(type->tp_as_mapping->mp_ass_subscript,
+                                    &pybind11_mp_ass_subscript,
+                                    generic.mp_ass_subscript);
+    } else if (std::strcmp(name, "__contains__") == 0) {
+        install_special_method_slot(
+            type->tp_as_sequence->sq_contains, &pybind11_sq_contains, generic.sq_contains);
+    } else if (std::strcmp(name, "__hash__") == 0) {
+        install_special_method_slot(type->tp_hash, &pybind11_tp_hash, generic.tp_hash);
+    }
+}
+#endif
+
 /** Create a brand new Python type according to the `type_record` specification.
     Return value: New reference. */
 inline PyObject *make_new_python_type(const type_record &rec) {
@@ -685,7 +1673,21 @@ inline PyObject *make_new_python_type(const type_record &rec) {
     type->tp_name = full_name;
     type->tp_doc = tp_doc;
     type->tp_base = type_incref((PyTypeObject *) base);
-    type->tp_basicsize = static_cast<ssize_t>(sizeof(instance));
+    type->tp_basicsize = static_cast<ssize_t>(
+        rec.inline_storage ? inline_value_offset(rec.type_align) + rec.type_size
+                           : sizeof(instance));
+    // Make room for the value and the attribute slots stored inside instances of a base class
+    bool inherits_slots = false;
+    for (auto b : rec.bases) {
+        auto *base_type = (PyTypeObject *) b.ptr();
+        auto *base_info = get_type_info(base_type);
+        const bool base_has_slots = base_info != nullptr && has_instance_slots(base_type);
+        if (base_info && (has_inline_storage(base_info) || base_has_slots)
+            && base_type->tp_basicsize > type->tp_basicsize) {
+            type->tp_basicsize = base_type->tp_basicsize;
+        }
+        inherits_slots |= base_has_slots;
+    }
     if (!bases.empty()) {
         type->tp_bases = bases.release().ptr();
     }
@@ -705,6 +1707,10 @@ inline PyObject *make_new_python_type(const type_record &rec) {
         type->tp_flags |= Py_TPFLAGS_BASETYPE;
     }
 
+    if (!rec.slot_names.empty() || inherits_slots) {
+        enable_slots(heap_type, rec.slot_names);
+    }
+
     if (rec.dynamic_attr) {
         enable_dynamic_attributes(heap_type);
     }
@@ -717,12 +1723,26 @@ inline PyObject *make_new_python_type(const type_record &rec) {
         rec.custom_type_setup_callback(heap_type);
     }
 
+#if defined(PYBIND11_HAS_INSTANCE_FREELIST)
+    // Unless the custom type setup took over the allocation of instances
+    if (type->tp_alloc == nullptr && type->tp_free == nullptr) {
+        type->tp_alloc = pybind11_object_alloc;
+        type->tp_free = pybind11_object_free;
+    }
+#endif
+
     if (PyType_Ready(type) < 0) {
         pybind11_fail(std::string(rec.name) + ": PyType_Ready failed: " + error_string());
     }
 
     assert(!rec.dynamic_attr || PyType_HasFeature(type, Py_TPFLAGS_HAVE_GC));
 
+    // E.g. a custom type setup or a base type given as a Python object may have enabled the GC
+    if (rec.no_gc && PyType_HasFeature(type, Py_TPFLAGS_HAVE_GC)) {
+        pybind11_fail(std::string(rec.name)
+                      + ": py::no_gc() requested, but the type supports garbage collection");
+    }
+
     /* Register type with the parent scope */
     if (rec.scope) {
         setattr(rec.scope, rec.name, (PyObject *) type);
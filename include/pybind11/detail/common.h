@@ -186,6 +186,14 @@
 #    define PYBIND11_NOINLINE __attribute__((noinline)) inline
 #endif
 
+// The PYBIND11_ALWAYS_INLINE macro is for small function DEFINITIONS that are instantiated for
+// many template arguments, and should be merged into their callers rather than emitted for each.
+#if defined(_MSC_VER)
+#    define PYBIND11_ALWAYS_INLINE __forceinline
+#else
+#    define PYBIND11_ALWAYS_INLINE __attribute__((always_inline)) inline
+#endif
+
 #if defined(__MINGW32__)
 // For unknown reasons all PYBIND11_DEPRECATED member trigger a warning when declared
 // whether it is used or not
@@ -248,9 +256,16 @@ PYBIND11_WARNING_DISABLE_MSVC(4505)
 #    if defined(PYBIND11_CPP17) && __has_include(<variant>)
 #        define PYBIND11_HAS_VARIANT 1
 #    endif
+// std::span
+#    if defined(PYBIND11_CPP20) && __has_include(<span>)
+#        define PYBIND11_HAS_SPAN 1
+#    endif
 #elif defined(_MSC_VER) && defined(PYBIND11_CPP17)
 #    define PYBIND11_HAS_OPTIONAL 1
 #    define PYBIND11_HAS_VARIANT 1
+#    if defined(PYBIND11_CPP20)
+#        define PYBIND11_HAS_SPAN 1
+#    endif
 #endif
 
 #if defined(PYBIND11_CPP17)
@@ -292,6 +307,51 @@ PYBIND11_WARNING_DISABLE_MSVC(4505)
 #    define PYBIND11_SIMPLE_GIL_MANAGEMENT
 #endif
 
+// `METH_FASTCALL | METH_KEYWORDS` is public API (and backs vectorcall) since Python 3.7.
+// Older interpreters and PyPy fall back to `METH_VARARGS | METH_KEYWORDS`.
+#if PY_VERSION_HEX >= 0x03070000 && !defined(PYPY_VERSION) && !defined(PYBIND11_NO_METH_FASTCALL)
+#    define PYBIND11_HAS_METH_FASTCALL
+#endif
+
+// `PyObject_Vectorcall` is public API since Python 3.9.
+#if PY_VERSION_HEX >= 0x03090000 && !defined(PYPY_VERSION)
+#    define PYBIND11_HAS_VECTORCALL
+#endif
+
+// Subinterpreters can have a GIL of their own since Python 3.12 (PEP 684). From then on, they can
+// get internals of their own, and modules can use multi-phase initialization (PEP 489) to be
+// imported into each of them.
+#if PY_VERSION_HEX >= 0x030C0000 && !defined(PYPY_VERSION)
+#    define PYBIND11_HAS_SUBINTERPRETER_SUPPORT
+#endif
+
+/// Tracks the `internals` and `type_info` ABI version independent of the main library version.
+///
+/// Some portions of the code use an ABI that is conditional depending on this
+/// version number.  That allows ABI-breaking changes to be "pre-implemented".
+/// Once the default version number is incremented, the conditional logic that
+/// no longer applies can be removed.  Additionally, users that need not
+/// maintain ABI compatibility can increase the version number in order to take
+/// advantage of any functionality/efficiency improvements that depend on the
+/// newer ABI.
+///
+/// WARNING: If you choose to manually increase the ABI version, note that
+/// pybind11 may not be tested as thoroughly with a non-default ABI version, and
+/// further ABI-incompatible changes may be made before the ABI is officially
+/// changed to the new version.
+#ifndef PYBIND11_INTERNALS_VERSION
+#    if PY_VERSION_HEX >= 0x030C0000
+// Version bump for Python 3.12+, before first 3.12 beta release.
+#        define PYBIND11_INTERNALS_VERSION 5
+#    else
+#        define PYBIND11_INTERNALS_VERSION 4
+#    endif
+#endif
+
+// This requirement is mainly to reduce the support burden (see PR #4570).
+static_assert(PY_VERSION_HEX < 0x030C0000 || PYBIND11_INTERNALS_VERSION >= 5,
+              "pybind11 ABI version 5 is the minimum for Python 3.12+");
+
 #if defined(_MSC_VER)
 #    if defined(PYBIND11_DEBUG_MARKER)
 #        define _DEBUG
@@ -322,6 +382,9 @@ PYBIND11_WARNING_POP
 #if defined(__cpp_lib_char8_t) && __cpp_lib_char8_t >= 201811L
 #    define PYBIND11_HAS_U8STRING
 #endif
+#if defined(__cpp_lib_expected) && __cpp_lib_expected >= 202202L
+#    define PYBIND11_HAS_EXPECTED 1
+#endif
 
 // See description of PR #4246:
 #if !defined(NDEBUG) && !defined(PY_ASSERT_GIL_HELD_INCREF_DECREF) && !defined(PYPY_VERSION)      \
@@ -374,7 +437,9 @@ PYBIND11_WARNING_POP
 #define PYBIND11_STRINGIFY(x) #x
 #define PYBIND11_TOSTRING(x) PYBIND11_STRINGIFY(x)
 #define PYBIND11_CONCAT(first, second) first##second
-#define PYBIND11_ENSURE_INTERNALS_READY pybind11::detail::get_internals();
+#define PYBIND11_ENSURE_INTERNALS_READY                                                           \
+    pybind11::detail::note_current_interpreter();                                                 \
+    pybind11::detail::get_internals();
 
 #define PYBIND11_CHECK_PYTHON_VERSION                                                             \
     {                                                                                             \
@@ -435,7 +500,14 @@ PYBIND11_WARNING_POP
     This macro creates the entry point that will be invoked when the Python interpreter
     imports an extension module. The module name is given as the first argument and it
     should not be in quotes. The second macro argument defines a variable of type
-    `py::module_` which can be used to initialize the module.
+    `py::module_` which can be used to initialize the module. Further arguments are
+    module options: `py::mod_gil_not_used()` declares that the module can run without the
+    GIL in free-threaded builds of Python, and `py::multiple_interpreters` which
+    subinterpreters can import it.
+
+    From Python 3.12 on, a module given `py::multiple_interpreters` uses multi-phase
+    initialization, so that every interpreter importing it runs the function body for a
+    module object of its own.
 
     The entry point is marked as "maybe unused" to aid dead-code detection analysis:
     since the entry point is typically only looked up at runtime and not referenced
@@ -452,21 +524,26 @@ PYBIND11_WARNING_POP
             });
         }
 \endrst */
-#define PYBIND11_MODULE(name, variable)                                                           \
+#define PYBIND11_MODULE(name, variable, ...)                                                      \
     static ::pybind11::module_::module_def PYBIND11_CONCAT(pybind11_module_def_, name)            \
         PYBIND11_MAYBE_UNUSED;                                                                    \
+    static ::pybind11::module_::module_slots PYBIND11_CONCAT(pybind11_module_slots_, name)        \
+        PYBIND11_MAYBE_UNUSED;                                                                    \
     PYBIND11_MAYBE_UNUSED                                                                         \
     static void PYBIND11_CONCAT(pybind11_init_, name)(::pybind11::module_ &);                     \
+    static int PYBIND11_CONCAT(pybind11_exec_, name)(PyObject * pm) {                             \
+        return ::pybind11::detail::exec_module(pm, &PYBIND11_CONCAT(pybind11_init_, name));       \
+    }                                                                                             \
     PYBIND11_PLUGIN_IMPL(name) {                                                                  \
         PYBIND11_CHECK_PYTHON_VERSION                                                             \
         PYBIND11_ENSURE_INTERNALS_READY                                                           \
-        auto m = ::pybind11::module_::create_extension_module(                                    \
-            PYBIND11_TOSTRING(name), nullptr, &PYBIND11_CONCAT(pybind11_module_def_, name));      \
-        try {                                                                                     \
-            PYBIND11_CONCAT(pybind11_init_, name)(m);                                             \
-            return m.ptr();                                                                       \
-        }                                                                                         \
-        PYBIND11_CATCH_INIT_EXCEPTIONS                                                            \
+        return ::pybind11::detail::initialize_module_def(                                         \
+            PYBIND11_TOSTRING(name),                                                              \
+            &PYBIND11_CONCAT(pybind11_module_def_, name),                                         \
+            PYBIND11_CONCAT(pybind11_module_slots_, name),                                        \
+            &PYBIND11_CONCAT(pybind11_init_, name),                                               \
+            &PYBIND11_CONCAT(pybind11_exec_, name),                                               \
+            ##__VA_ARGS__);                                                                       \
     }                                                                                             \
     void PYBIND11_CONCAT(pybind11_init_, name)(::pybind11::module_ & (variable))
 
@@ -605,8 +682,17 @@ struct instance {
     bool simple_holder_constructed : 1;
     /// For simple layout, tracks whether the instance is registered in `registered_instances`
     bool simple_instance_registered : 1;
+#if PYBIND11_INTERNALS_VERSION > 5
+    /// If true, `patients` holds the objects kept alive by this one (see `keep_alive`)
+    bool has_patients : 1;
+    /// If true, `patients` is a list of them rather than the only one
+    bool patients_in_list : 1;
+    /// The object that is kept alive by this one, or a list of them
+    PyObject *patients;
+#else
     /// If true, get_internals().patients has an entry for this object
     bool has_patients : 1;
+#endif
 
     /// Initializes all of the above type/values/holders data (but not the instance values
     /// themselves)
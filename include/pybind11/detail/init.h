@@ -34,6 +34,9 @@ private:
     value_and_holder *value = nullptr;
 };
 
+template <>
+struct loads_by_type<type_caster<value_and_holder>> : std::true_type {};
+
 PYBIND11_NAMESPACE_BEGIN(initimpl)
 
 inline void no_nullptr(void *ptr) {
@@ -82,6 +85,20 @@ inline Class *construct_or_initialize(Args &&...args) {
     return new Class{std::forward<Args>(args)...};
 }
 
+// Same as the above, but constructs the object at the given address
+template <typename Class,
+          typename... Args,
+          detail::enable_if_t<std::is_constructible<Class, Args...>::value, int> = 0>
+inline Class *construct_or_initialize_at(void *storage, Args &&...args) {
+    return ::new (storage) Class(std::forward<Args>(args)...);
+}
+template <typename Class,
+          typename... Args,
+          detail::enable_if_t<!std::is_constructible<Class, Args...>::value, int> = 0>
+inline Class *construct_or_initialize_at(void *storage, Args &&...args) {
+    return ::new (storage) Class{std::forward<Args>(args)...};
+}
+
 // Attempts to constructs an alias using a `Alias(Cpp &&)` constructor.  This allows types with
 // an alias to provide only a single Cpp factory function as long as the Alias can be
 // constructed from an rvalue reference of the base Cpp type.  This means that Alias classes
@@ -179,6 +196,8 @@ void construct(value_and_holder &v_h, Cpp<Class> &&result, bool need_alias) {
                   "pybind11::init() return-by-value factory function requires a movable class");
     if (Class::has_alias && need_alias) {
         construct_alias_from_cpp<Class>(is_alias_constructible<Class>{}, v_h, std::move(result));
+    } else if (void *storage = inline_value_ptr(v_h.inst, v_h.type)) {
+        v_h.value_ptr() = ::new (storage) Cpp<Class>(std::move(result));
     } else {
         v_h.value_ptr() = new Cpp<Class>(std::move(result));
     }
@@ -195,18 +214,45 @@ void construct(value_and_holder &v_h, Alias<Class> &&result, bool) {
     v_h.value_ptr() = new Alias<Class>(std::move(result));
 }
 
+// Implements `py::fast_init()` for `py::init<Args...>()`; defined in pybind11.h, after
+// `cpp_function`
+template <typename Class, typename... Args>
+struct fast_constructor;
+
+template <typename Class, typename... Args>
+void install_fast_constructor(Class &, std::false_type) {}
+template <typename Class, typename... Args>
+void install_fast_constructor(Class &cl, std::true_type) {
+    fast_constructor<Class, Args...>::install(cl);
+}
+
+template <typename T>
+struct is_keep_alive : std::false_type {};
+template <size_t Nurse, size_t Patient>
+struct is_keep_alive<keep_alive<Nurse, Patient>> : std::true_type {};
+
 // Implementing class for py::init<...>()
 template <typename... Args>
 struct constructor {
     template <typename Class, typename... Extra, enable_if_t<!Class::has_alias, int> = 0>
     static void execute(Class &cl, const Extra &...extra) {
+        static_assert(!any_of<std::is_same<fast_init, Extra>...>::value
+                          || !any_of<is_keep_alive<Extra>..., is_call_guard<Extra>...>::value,
+                      "py::fast_init() cannot be combined with py::keep_alive or py::call_guard");
         cl.def(
             "__init__",
             [](value_and_holder &v_h, Args... args) {
-                v_h.value_ptr() = construct_or_initialize<Cpp<Class>>(std::forward<Args>(args)...);
+                if (void *storage = inline_value_ptr(v_h.inst, v_h.type)) {
+                    v_h.value_ptr() = construct_or_initialize_at<Cpp<Class>>(
+                        storage, std::forward<Args>(args)...);
+                } else {
+                    v_h.value_ptr()
+                        = construct_or_initialize<Cpp<Class>>(std::forward<Args>(args)...);
+                }
             },
             is_new_style_constructor(),
             extra...);
+        install_fast_constructor<Class, Args...>(cl, any_of<std::is_same<fast_init, Extra>...>{});
     }
 
     template <
@@ -215,6 +261,8 @@ struct constructor {
         enable_if_t<Class::has_alias && std::is_constructible<Cpp<Class>, Args...>::value, int>
         = 0>
     static void execute(Class &cl, const Extra &...extra) {
+        static_assert(!any_of<std::is_same<fast_init, Extra>...>::value,
+                      "py::fast_init() cannot be used with a trampoline (alias) class");
         cl.def(
             "__init__",
             [](value_and_holder &v_h, Args... args) {
@@ -236,6 +284,8 @@ struct constructor {
         enable_if_t<Class::has_alias && !std::is_constructible<Cpp<Class>, Args...>::value, int>
         = 0>
     static void execute(Class &cl, const Extra &...extra) {
+        static_assert(!any_of<std::is_same<fast_init, Extra>...>::value,
+                      "py::fast_init() cannot be used with a trampoline (alias) class");
         cl.def(
             "__init__",
             [](value_and_holder &v_h, Args... args) {
@@ -361,6 +411,54 @@ struct factory<CFunc, AFunc, CReturn(CArgs...), AReturn(AArgs...)> {
     }
 };
 
+// Implementation class for py::init_inplace(Func)
+template <typename Func, typename = function_signature_t<Func>>
+struct inplace_factory;
+
+template <typename Func, typename Return, typename... Args>
+struct inplace_factory<Func, Return(void *, Args...)> {
+    remove_reference_t<Func> class_factory;
+
+    // NOLINTNEXTLINE(google-explicit-constructor)
+    inplace_factory(Func &&f) : class_factory(std::forward<Func>(f)) {}
+
+    // The factory constructs the instance in the storage inside the Python object if the class
+    // uses `py::inline_storage`, or else in memory allocated like `new Cpp` would, which the
+    // holder frees.
+    template <typename Class, typename... Extra>
+    void execute(Class &cl, const Extra &...extra) && {
+        static_assert(!Class::has_alias,
+                      "py::init_inplace() cannot be used with a trampoline (alias) class");
+#if defined(PYBIND11_CPP14)
+        cl.def(
+            "__init__",
+            [func = std::move(class_factory)]
+#else
+        auto &func = class_factory;
+        cl.def(
+            "__init__",
+            [func]
+#endif
+            (value_and_holder &v_h, Args... args) {
+                void *storage = inline_value_ptr(v_h.inst, v_h.type);
+                if (storage != nullptr) {
+                    func(storage, std::forward<Args>(args)...);
+                } else {
+                    storage = ::operator new(sizeof(Cpp<Class>));
+                    try {
+                        func(storage, std::forward<Args>(args)...);
+                    } catch (...) {
+                        ::operator delete(storage);
+                        throw;
+                    }
+                }
+                v_h.value_ptr() = static_cast<Cpp<Class> *>(storage);
+            },
+            is_new_style_constructor(),
+            extra...);
+    }
+};
+
 /// Set just the C++ state. Same as `__init__`.
 template <typename Class, typename T>
 void setstate(value_and_holder &v_h, T &&result, bool need_alias) {
@@ -383,6 +481,84 @@ void setstate(value_and_holder &v_h, std::pair<T, O> &&result, bool need_alias)
     setattr((PyObject *) v_h.inst, "__dict__", d);
 }
 
+/// Whether the Python state of a `__getstate__` returning a `T` can contain memoryviews
+template <typename T>
+struct may_hold_memoryview : any_of<std::is_same<T, object>,
+                                    std::is_same<T, tuple>,
+                                    std::is_same<T, memoryview>,
+                                    std::is_same<T, buffer>> {};
+template <typename... Ts>
+struct may_hold_memoryview<std::tuple<Ts...>> : any_of<may_hold_memoryview<intrinsic_t<Ts>>...> {
+};
+template <typename T1, typename T2>
+struct may_hold_memoryview<std::pair<T1, T2>>
+    : any_of<may_hold_memoryview<intrinsic_t<T1>>, may_hold_memoryview<intrinsic_t<T2>>> {};
+
+/// Memoryviews cannot be pickled. For protocol 5, they are wrapped in a `pickle.PickleBuffer`,
+/// which the pickler can pass out-of-band without copying the data; for older protocols, their
+/// data is copied into a `bytes` object.
+inline object picklable_buffer(handle item, int protocol) {
+    if (protocol >= 5) {
+        auto pickle = reinterpret_steal<object>(PyImport_ImportModule("pickle"));
+        if (!pickle) {
+            throw error_already_set();
+        }
+        return pickle.attr("PickleBuffer")(item);
+    }
+    auto copy = reinterpret_steal<object>(PyBytes_FromObject(item.ptr()));
+    if (!copy) {
+        throw error_already_set();
+    }
+    return copy;
+}
+
+/// Returns a copy of the tuple `tup` with the item at `index` replaced by `item`
+inline tuple tuple_with_item(handle tup, ssize_t index, const object &item) {
+    ssize_t size = PyTuple_GET_SIZE(tup.ptr());
+    tuple result(size);
+    for (ssize_t i = 0; i < size; ++i) {
+        handle element = i == index ? handle(item) : handle(PyTuple_GET_ITEM(tup.ptr(), i));
+        PyTuple_SET_ITEM(result.ptr(), i, element.inc_ref().ptr());
+    }
+    return result;
+}
+
+/// Implements `__reduce_ex__` for classes with `py::pickle`: like `object.__reduce_ex__`, which
+/// calls `__getstate__`, but makes memoryviews in the state (or among the elements of a tuple
+/// state) picklable.
+inline object reduce_ex_with_buffers(handle self, int protocol) {
+    auto reduce_ex = reinterpret_borrow<object>(reinterpret_cast<PyObject *>(&PyBaseObject_Type))
+                         .attr("__reduce_ex__");
+    object reduced = reduce_ex(self, protocol);
+    if (!PyTuple_Check(reduced.ptr()) || PyTuple_GET_SIZE(reduced.ptr()) < 3) {
+        return reduced;
+    }
+    handle state = PyTuple_GET_ITEM(reduced.ptr(), 2);
+    if (PyMemoryView_Check(state.ptr())) {
+        return tuple_with_item(reduced, 2, picklable_buffer(state, protocol));
+    }
+    if (!PyTuple_Check(state.ptr())) {
+        return reduced;
+    }
+    auto new_state = reinterpret_borrow<object>(state);
+    for (ssize_t i = 0; i < PyTuple_GET_SIZE(state.ptr()); ++i) {
+        handle item = PyTuple_GET_ITEM(state.ptr(), i);
+        if (PyMemoryView_Check(item.ptr())) {
+            new_state = tuple_with_item(new_state, i, picklable_buffer(item, protocol));
+        }
+    }
+    return new_state.is(state) ? reduced : tuple_with_item(reduced, 2, new_state);
+}
+
+template <typename Class>
+void install_reduce_ex(Class &, std::false_type) {}
+template <typename Class>
+void install_reduce_ex(Class &cl, std::true_type) {
+    cl.def("__reduce_ex__", [](handle self, int protocol) {
+        return reduce_ex_with_buffers(self, protocol);
+    });
+}
+
 /// Implementation for py::pickle(GetState, SetState)
 template <typename Get,
           typename Set,
@@ -426,6 +602,7 @@ struct pickle_factory<Get, Set, RetState(Self), NewInstance(ArgState)> {
             },
             is_new_style_constructor(),
             extra...);
+        install_reduce_ex(cl, may_hold_memoryview<intrinsic_t<RetState>>{});
     }
 };
 
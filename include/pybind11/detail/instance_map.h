@@ -0,0 +1,176 @@
+// Copyright (c) 2023 The pybind Community.
+
+#pragma once
+
+// Included by internals.h, which chooses the PYBIND11_INTERNALS_VERSION
+#include "common.h"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+PYBIND11_NAMESPACE_BEGIN(PYBIND11_NAMESPACE)
+PYBIND11_NAMESPACE_BEGIN(detail)
+
+#if PYBIND11_INTERNALS_VERSION > 5
+
+/// Multimap from C++ value pointers to the Python instances wrapping them (there can be several,
+/// e.g. for a base class subobject at the same address, or for instances sharing a pointer with
+/// `return_value_policy::reference`). Instances are created and destroyed all the time, so
+/// this uses open addressing with linear probing over a flat array, rather than allocating a
+/// node per entry like `std::unordered_multimap`. Entries are removed by shifting the following
+/// entries back, so that no tombstones accumulate.
+class instance_map {
+public:
+    void emplace(const void *key, instance *value) {
+        assert(key != nullptr);
+        if ((m_size + 1) * 2 > m_slots.size()) {
+            rehash(m_slots.empty() ? min_capacity : m_slots.size() * 2);
+        }
+        insert_slot(key, value);
+        ++m_size;
+    }
+
+    /// Removes the entry for exactly this key and value, if any
+    bool erase(const void *key, const instance *value) {
+        if (m_size == 0) {
+            return false;
+        }
+        const size_t mask = m_slots.size() - 1;
+        for (size_t i = home(key);; i = (i + 1) & mask) {
+            if (m_slots[i].key == nullptr) {
+                return false;
+            }
+            if (m_slots[i].key == key && m_slots[i].value == value) {
+                erase_slot(i);
+                --m_size;
+                return true;
+            }
+        }
+    }
+
+    /// Returns the first instance registered for `key` for which `pred` returns true. `pred`
+    /// may cause other entries to be erased (e.g. by triggering garbage collection), but must
+    /// not add any.
+    template <typename Pred>
+    instance *find_if(const void *key, Pred &&pred) const {
+        if (m_size == 0) {
+            return nullptr;
+        }
+        const size_t mask = m_slots.size() - 1;
+        for (size_t i = home(key); m_slots[i].key != nullptr; i = (i + 1) & mask) {
+            if (m_slots[i].key == key) {
+                instance *value = m_slots[i].value;
+                if (pred(value)) {
+                    return value;
+                }
+            }
+        }
+        return nullptr;
+    }
+
+    size_t size() const { return m_size; }
+    size_t bucket_count() const { return m_slots.size(); }
+
+private:
+    struct slot {
+        const void *key = nullptr;
+        instance *value = nullptr;
+    };
+
+    static constexpr size_t min_capacity = 64;
+
+    size_t home(const void *key) const {
+        // Fibonacci hashing: the low bits of pointers are mostly zero due to alignment, so take
+        // the high bits of the product instead
+        const auto h = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(key))
+                       * UINT64_C(0x9E3779B97F4A7C15);
+        return static_cast<size_t>(h >> m_shift);
+    }
+
+    void insert_slot(const void *key, instance *value) {
+        const size_t mask = m_slots.size() - 1;
+        size_t i = home(key);
+        while (m_slots[i].key != nullptr) {
+            i = (i + 1) & mask;
+        }
+        m_slots[i].key = key;
+        m_slots[i].value = value;
+    }
+
+    void erase_slot(size_t i) {
+        const size_t mask = m_slots.size() - 1;
+        for (size_t j = (i + 1) & mask; m_slots[j].key != nullptr; j = (j + 1) & mask) {
+            // Entries whose home lies cyclically in (i, j] are still reachable; any other entry
+            // can fill the gap at i
+            const size_t k = home(m_slots[j].key);
+            const bool reachable = i <= j ? (i < k && k <= j) : (i < k || k <= j);
+            if (!reachable) {
+                m_slots[i] = m_slots[j];
+                i = j;
+            }
+        }
+        m_slots[i] = slot();
+    }
+
+    void rehash(size_t capacity) {
+        std::vector<slot> old(capacity);
+        old.swap(m_slots);
+        m_shift = 64;
+        for (size_t c = capacity; c > 1; c >>= 1) {
+            --m_shift;
+        }
+        for (const auto &s : old) {
+            if (s.key != nullptr) {
+                insert_slot(s.key, s.value);
+            }
+        }
+    }
+
+    std::vector<slot> m_slots;
+    size_t m_size = 0;
+    unsigned m_shift = 64;
+};
+
+#else
+
+/// Multimap from C++ value pointers to the Python instances wrapping them. With this ABI
+/// version it has to keep the layout of the `std::unordered_multimap` it wraps; the open
+/// addressing variant above is used from `PYBIND11_INTERNALS_VERSION` 6 on.
+class instance_map {
+public:
+    void emplace(const void *key, instance *value) { m_map.emplace(key, value); }
+
+    bool erase(const void *key, const instance *value) {
+        auto range = m_map.equal_range(key);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second == value) {
+                m_map.erase(it);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    template <typename Pred>
+    instance *find_if(const void *key, Pred &&pred) const {
+        auto range = m_map.equal_range(key);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (pred(it->second)) {
+                return it->second;
+            }
+        }
+        return nullptr;
+    }
+
+    size_t size() const { return m_map.size(); }
+    size_t bucket_count() const { return m_map.bucket_count(); }
+
+private:
+    std::unordered_multimap<const void *, instance *> m_map;
+};
+
+#endif
+
+PYBIND11_NAMESPACE_END(detail)
+PYBIND11_NAMESPACE_END(PYBIND11_NAMESPACE)
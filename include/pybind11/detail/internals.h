@@ -17,34 +17,22 @@
 
 #include "../pytypes.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <exception>
+#include <memory>
+#include <utility>
 
-/// Tracks the `internals` and `type_info` ABI version independent of the main library version.
-///
-/// Some portions of the code use an ABI that is conditional depending on this
-/// version number.  That allows ABI-breaking changes to be "pre-implemented".
-/// Once the default version number is incremented, the conditional logic that
-/// no longer applies can be removed.  Additionally, users that need not
-/// maintain ABI compatibility can increase the version number in order to take
-/// advantage of any functionality/efficiency improvements that depend on the
-/// newer ABI.
-///
-/// WARNING: If you choose to manually increase the ABI version, note that
-/// pybind11 may not be tested as thoroughly with a non-default ABI version, and
-/// further ABI-incompatible changes may be made before the ABI is officially
-/// changed to the new version.
-#ifndef PYBIND11_INTERNALS_VERSION
-#    if PY_VERSION_HEX >= 0x030C0000
-// Version bump for Python 3.12+, before first 3.12 beta release.
-#        define PYBIND11_INTERNALS_VERSION 5
-#    else
-#        define PYBIND11_INTERNALS_VERSION 4
-#    endif
+#if defined(Py_GIL_DISABLED)
+#    include <mutex>
+#    include <thread>
 #endif
 
-// This requirement is mainly to reduce the support burden (see PR #4570).
-static_assert(PY_VERSION_HEX < 0x030C0000 || PYBIND11_INTERNALS_VERSION >= 5,
-              "pybind11 ABI version 5 is the minimum for Python 3.12+");
+// `PYBIND11_INTERNALS_VERSION` is defined in common.h, since the layout of `instance` depends on
+// it as well.
+
+#include "instance_map.h"
 
 PYBIND11_NAMESPACE_BEGIN(PYBIND11_NAMESPACE)
 
@@ -162,19 +150,88 @@ struct override_hash {
     }
 };
 
+#if PYBIND11_INTERNALS_VERSION > 5
+/// What `get_override()` found for a method name on a Python type. It stays valid for as long as
+/// the type keeps this `tp_version_tag`, which CPython changes whenever the type or one of its
+/// bases is modified. It has no member initializers, so that it is an aggregate in C++11 too;
+/// `override_cache_entry{}` is the entry for a method that is not overridden.
+struct override_cache_entry {
+    unsigned int version_tag;
+    // The Python function overriding the method, borrowed from the dict of the type or one of
+    // its bases, or nullptr if the method is not overridden
+    PyObject *function;
+};
+#endif
+
+#if defined(Py_GIL_DISABLED)
+/// A `PyMutex` that can be used with `std::unique_lock`. It is used rather than `std::mutex`
+/// because a thread waiting for it detaches from the interpreter, so that it cannot deadlock with
+/// a thread that needs all others to stop (e.g. for garbage collection).
+class pymutex {
+public:
+    pymutex() = default;
+    pymutex(const pymutex &) = delete;
+    pymutex &operator=(const pymutex &) = delete;
+
+    void lock() { PyMutex_Lock(&m_mutex); }
+    void unlock() { PyMutex_Unlock(&m_mutex); }
+
+private:
+    PyMutex m_mutex{};
+};
+
+/// A part of the registered instances with its own mutex. Instances are created and destroyed
+/// all the time on every thread, so free-threaded builds spread them over several of these
+/// rather than locking all of the internals. Padded to a multiple of the cache line size, so
+/// that threads using neighbouring shards do not contend for the same line.
+struct instance_map_shard {
+    instance_map registered_instances;
+    pymutex mutex;
+    char padding[64 - (sizeof(instance_map) + sizeof(pymutex)) % 64];
+};
+#endif
+
 /// Internal data structure used to track registered instances and types.
 /// Whenever binary incompatible changes are made to this structure,
 /// `PYBIND11_INTERNALS_VERSION` must be incremented.
 struct internals {
+#if defined(Py_GIL_DISABLED)
+    // Without the GIL, this protects all other members except the instance shards, and the local
+    // internals of every extension module. It must not be held while calling back into Python
+    // code, which could need it again.
+    pymutex mutex;
+    // Changed whenever a type is registered or destroyed, see `type_info_cache`
+    std::atomic<size_t> registered_types_epoch{1};
+#endif
     // std::type_index -> pybind11's type information
     type_map<type_info *> registered_types_cpp;
+#if PYBIND11_INTERNALS_VERSION > 5
+    // Replaced whenever a type is registered or destroyed: cached results of C++ type lookups
+    // hold a weak reference to it, see `type_info_cache`
+    std::shared_ptr<void> registered_types_token = std::make_shared<char>();
+#endif
     // PyTypeObject* -> base type_info(s)
     std::unordered_map<PyTypeObject *, std::vector<type_info *>> registered_types_py;
-    std::unordered_multimap<const void *, instance *> registered_instances; // void * -> instance*
+#if defined(Py_GIL_DISABLED)
+    // void * -> instance*, spread over the shards by the hash of the pointer
+    std::unique_ptr<instance_map_shard[]> instance_shards;
+    size_t instance_shards_mask = 0;
+#else
+    instance_map registered_instances; // void * -> instance*
+#endif
+#if PYBIND11_INTERNALS_VERSION > 5
+    std::unordered_map<std::pair<const PyObject *, const char *>,
+                       override_cache_entry,
+                       override_hash>
+        override_cache;
+#else
     std::unordered_set<std::pair<const PyObject *, const char *>, override_hash>
         inactive_override_cache;
+#endif
     type_map<std::vector<bool (*)(PyObject *, void *&)>> direct_conversions;
+#if PYBIND11_INTERNALS_VERSION <= 5
     std::unordered_map<const PyObject *, std::vector<PyObject *>> patients;
+#endif
     std::forward_list<ExceptionTranslator> registered_exception_translators;
     std::unordered_map<std::string, void *> shared_data; // Custom data to be shared across
                                                          // extensions
@@ -201,7 +258,19 @@ struct internals {
     std::string function_record_capsule_name = internals_function_record_capsule_name;
 #    endif
 
+#    if defined(Py_GIL_DISABLED)
+    internals() {
+        // A power of two, so that the shard index can be masked out of the hash
+        size_t num_shards = 1;
+        while (num_shards < 2 * static_cast<size_t>(std::thread::hardware_concurrency())) {
+            num_shards *= 2;
+        }
+        instance_shards.reset(new instance_map_shard[num_shards]);
+        instance_shards_mask = num_shards - 1;
+    }
+#    else
     internals() = default;
+#    endif
     internals(const internals &other) = delete;
     internals &operator=(const internals &other) = delete;
     ~internals() {
@@ -221,6 +290,70 @@ struct internals {
 #endif
 };
 
+/// The Python objects of the values of a `py::enum_` bound with `py::fast_enum()`, by their
+/// value converted to `std::uint64_t`. If the values span a small range they are looked up in an
+/// array, otherwise in a hash table. The references are borrowed from the `__entries` of the type.
+struct enum_value_table {
+    std::vector<std::pair<std::uint64_t, PyObject *>> values;
+    std::uint64_t first = 0;
+    std::vector<PyObject *> dense;
+    std::unordered_map<std::uint64_t, PyObject *> sparse;
+
+    PyObject *find(std::uint64_t value) const {
+        const std::uint64_t index = value - first;
+        if (index < dense.size()) {
+            return dense[static_cast<size_t>(index)];
+        }
+        if (sparse.empty()) {
+            return nullptr;
+        }
+        auto it = sparse.find(value);
+        return it != sparse.end() ? it->second : nullptr;
+    }
+
+    /// Adds a value; the first object added for a value is kept
+    void insert(std::uint64_t value, PyObject *obj) {
+        for (const auto &v : values) {
+            if (v.first == value) {
+                return;
+            }
+        }
+        values.emplace_back(value, obj);
+        // Signed order, so that small negative values are close to the others
+        auto lowest = static_cast<std::int64_t>(value);
+        auto highest = lowest;
+        for (const auto &v : values) {
+            lowest = (std::min)(lowest, static_cast<std::int64_t>(v.first));
+            highest = (std::max)(highest, static_cast<std::int64_t>(v.first));
+        }
+        const std::uint64_t span
+            = static_cast<std::uint64_t>(highest) - static_cast<std::uint64_t>(lowest);
+        dense.clear();
+        sparse.clear();
+        if (span < 4 * values.size() + 64) {
+            first = static_cast<std::uint64_t>(lowest);
+            dense.resize(static_cast<size_t>(span) + 1);
+            for (const auto &v : values) {
+                dense[static_cast<size_t>(v.first - first)] = v.second;
+            }
+        } else {
+            sparse.insert(values.begin(), values.end());
+        }
+    }
+};
+
+#if PYBIND11_INTERNALS_VERSION > 5
+/// A registered C++ base of a type with multiple inheritance among its ancestors, see
+/// `type_info::base_casts`
+struct base_cast {
+    const type_info *base;
+    /* 0 if `cast` applies to the value pointer itself, otherwise 1 + the index of the base whose
+       pointer it applies to */
+    size_t from;
+    void *(*cast)(void *);
+};
+#endif
+
 /// Additional type information which does not fit into the PyTypeObject.
 /// Changes to this struct also require bumping `PYBIND11_INTERNALS_VERSION`.
 struct type_info {
@@ -236,6 +369,13 @@ struct type_info {
     buffer_info *(*get_buffer)(PyObject *, void *) = nullptr;
     void *get_buffer_data = nullptr;
     void *(*module_local_load)(PyObject *, const type_info *) = nullptr;
+#if PYBIND11_INTERNALS_VERSION > 5
+    /* the values of a `py::enum_` with `py::fast_enum()`, owned by the type_info */
+    enum_value_table *enum_values = nullptr;
+    /* all registered C++ bases, depth-first, if the type does not have simple ancestors: the
+       pointers to them are computed without looking up the Python bases and their type_info */
+    std::vector<base_cast> base_casts;
+#endif
     /* A simple type never occurs as a (direct or indirect) parent
      * of a class that makes use of multiple inheritance.
      * A type can be simple even if it has non-simple ancestors as long as it has no descendants.
@@ -247,6 +387,12 @@ struct type_info {
     bool default_holder : 1;
     /* true if this is a type registered with py::module_local */
     bool module_local : 1;
+#if PYBIND11_INTERNALS_VERSION > 5
+    /* true if instances are not tracked in `registered_instances` (py::no_instance_registry) */
+    bool no_instance_registry : 1;
+    /* true if values can be stored inside the instances (py::inline_storage) */
+    bool inline_storage : 1;
+#endif
 };
 
 /// On MSVC, debug and release builds are not ABI-compatible!
@@ -317,13 +463,102 @@ struct type_info {
         PYBIND11_INTERNALS_KIND PYBIND11_COMPILER_TYPE PYBIND11_STDLIB PYBIND11_BUILD_ABI         \
             PYBIND11_BUILD_TYPE "__"
 
-/// Each module locally stores a pointer to the `internals` data. The data
-/// itself is shared among modules with the same `PYBIND11_INTERNALS_ID`.
-inline internals **&get_internals_pp() {
+inline internals **get_internals_pp_from_capsule(handle obj);
+
+#if defined(PYBIND11_HAS_SUBINTERPRETER_SUPPORT)
+/// Set once pybind11 code of this module is about to run in an interpreter other than the main
+/// one. Until then, nothing checks which interpreter is current.
+inline std::atomic<bool> &subinterpreters_seen() {
+    static std::atomic<bool> seen{false};
+    return seen;
+}
+
+/// Returns the interpreter of the calling thread if that is a subinterpreter, or nullptr in the
+/// main interpreter and in threads without a thread state. Threads only get a subinterpreter
+/// while they hold its GIL.
+inline PyInterpreterState *current_subinterpreter() {
+    if (!subinterpreters_seen().load(std::memory_order_relaxed)) {
+        return nullptr;
+    }
+    PyThreadState *tstate = _PyThreadState_UncheckedGet();
+    if (tstate == nullptr) {
+        return nullptr;
+    }
+    PyInterpreterState *interp = PyThreadState_GetInterpreter(tstate);
+    return interp != PyInterpreterState_Main() ? interp : nullptr;
+}
+
+/// Data of one subinterpreter, as last looked up by the calling thread. The ID tells apart
+/// interpreters that happen to be allocated at the same address, since IDs are not reused for
+/// as long as the main interpreter lives.
+template <typename T>
+struct subinterpreter_entry {
+    PyInterpreterState *interp;
+    int64_t id;
+    T value;
+
+    bool matches(PyInterpreterState *current) const {
+        return interp == current && id == PyInterpreterState_GetID(current);
+    }
+};
+#endif
+
+/// Called before pybind11 code first runs in an interpreter, i.e. when a module is imported or a
+/// subinterpreter is created, so that the interpreter gets internals of its own if necessary.
+inline void note_current_interpreter() {
+#if defined(PYBIND11_HAS_SUBINTERPRETER_SUPPORT)
+    PyThreadState *tstate = _PyThreadState_UncheckedGet();
+    if (tstate != nullptr && PyThreadState_GetInterpreter(tstate) != PyInterpreterState_Main()) {
+        subinterpreters_seen().store(true);
+    }
+#endif
+}
+
+/// Whether the calling thread runs in the main interpreter. Caches that live in static storage
+/// are only used there: subinterpreters with a GIL of their own would race on them.
+inline bool in_main_interpreter() {
+#if defined(PYBIND11_HAS_SUBINTERPRETER_SUPPORT)
+    return current_subinterpreter() == nullptr;
+#else
+    return true;
+#endif
+}
+
+/// The pointer to the `internals` data of the main interpreter
+inline internals **&get_main_internals_pp() {
     static internals **internals_pp = nullptr;
     return internals_pp;
 }
 
+/// Each module locally stores a pointer to the `internals` data. The data
+/// itself is shared among modules with the same `PYBIND11_INTERNALS_ID`. A
+/// subinterpreter shares the internals of the main interpreter, like the modules with
+/// single-phase initialization that it copies from there, unless it has internals of its own
+/// (see `initialize_subinterpreter_internals()`), which are found through its state dict.
+inline internals **&get_internals_pp() {
+    auto **&main_internals_pp = get_main_internals_pp();
+#if defined(PYBIND11_HAS_SUBINTERPRETER_SUPPORT)
+    if (auto *interp = current_subinterpreter()) {
+        static thread_local subinterpreter_entry<internals **> last{nullptr, -1, nullptr};
+        // Only found internals are remembered: the subinterpreter can get its own later
+        if (!last.matches(interp) || last.value == nullptr) {
+            last = {interp, PyInterpreterState_GetID(interp), nullptr};
+            if (PyObject *state_dict = PyInterpreterState_GetDict(interp)) {
+                if (PyObject *obj = dict_getitemstring(state_dict, PYBIND11_INTERNALS_ID)) {
+                    last.value = get_internals_pp_from_capsule(obj);
+                }
+            }
+        }
+        // Before there are any internals at all, the subinterpreter creates its own
+        if (last.value == nullptr && main_internals_pp != nullptr) {
+            return main_internals_pp;
+        }
+        return last.value;
+    }
+#endif
+    return main_internals_pp;
+}
+
 // forward decl
 inline void translate_exception(std::exception_ptr);
 
@@ -463,27 +698,17 @@ inline internals **get_internals_pp_from_capsule(handle obj) {
     return static_cast<internals **>(raw_ptr);
 }
 
-/// Return a reference to the current `internals` data
-PYBIND11_NOINLINE internals &get_internals() {
-    auto **&internals_pp = get_internals_pp();
+/// Loads the internals of the current interpreter from its state dict, or creates them. Called
+/// with the GIL held.
+PYBIND11_NOINLINE internals &initialize_internals(internals **&internals_pp) {
+#if defined(Py_GIL_DISABLED)
+    // Without the GIL, several threads may get here at once; only one of them creates the
+    // internals
+    static pymutex init_mutex;
+    std::lock_guard<pymutex> init_lock(init_mutex);
     if (internals_pp && *internals_pp) {
         return **internals_pp;
     }
-
-#if defined(WITH_THREAD)
-#    if defined(PYBIND11_SIMPLE_GIL_MANAGEMENT)
-    gil_scoped_acquire gil;
-#    else
-    // Ensure that the GIL is held since we will need to make Python calls.
-    // Cannot use py::gil_scoped_acquire here since that constructor calls get_internals.
-    struct gil_scoped_acquire_local {
-        gil_scoped_acquire_local() : state(PyGILState_Ensure()) {}
-        gil_scoped_acquire_local(const gil_scoped_acquire_local &) = delete;
-        gil_scoped_acquire_local &operator=(const gil_scoped_acquire_local &) = delete;
-        ~gil_scoped_acquire_local() { PyGILState_Release(state); }
-        const PyGILState_STATE state;
-    } gil;
-#    endif
 #endif
     error_scope err_scope;
 
@@ -535,6 +760,107 @@ PYBIND11_NOINLINE internals &get_internals() {
     return **internals_pp;
 }
 
+/// Gives the current subinterpreter internals of its own, unless it has them already. Modules
+/// with multi-phase initialization register their types there, rather than in the internals of
+/// the main interpreter, which its threads may not use if it has a GIL of its own.
+inline void initialize_subinterpreter_internals() {
+#if defined(PYBIND11_HAS_SUBINTERPRETER_SUPPORT)
+    if (current_subinterpreter() == nullptr) {
+        return;
+    }
+    internals **current = get_internals_pp();
+    if (current == nullptr || current == get_main_internals_pp()) {
+        internals **own = nullptr;
+        initialize_internals(own);
+    }
+#endif
+}
+
+/// Return a reference to the current `internals` data
+PYBIND11_NOINLINE internals &get_internals() {
+    auto **&internals_pp = get_internals_pp();
+    if (internals_pp && *internals_pp) {
+        return **internals_pp;
+    }
+
+#if defined(PYBIND11_HAS_SUBINTERPRETER_SUPPORT)
+    // The thread already holds the GIL of the subinterpreter, and `PyGILState_Ensure()` would
+    // switch it to its thread state of the main interpreter
+    if (current_subinterpreter() != nullptr) {
+        return initialize_internals(internals_pp);
+    }
+#endif
+#if defined(WITH_THREAD)
+#    if defined(PYBIND11_SIMPLE_GIL_MANAGEMENT)
+    gil_scoped_acquire gil;
+#    else
+    // Ensure that the GIL is held since we will need to make Python calls.
+    // Cannot use py::gil_scoped_acquire here since that constructor calls get_internals.
+    struct gil_scoped_acquire_local {
+        gil_scoped_acquire_local() : state(PyGILState_Ensure()) {}
+        gil_scoped_acquire_local(const gil_scoped_acquire_local &) = delete;
+        gil_scoped_acquire_local &operator=(const gil_scoped_acquire_local &) = delete;
+        ~gil_scoped_acquire_local() { PyGILState_Release(state); }
+        const PyGILState_STATE state;
+    } gil;
+#    endif
+#endif
+    return initialize_internals(internals_pp);
+}
+
+#if defined(Py_GIL_DISABLED)
+#    define PYBIND11_LOCK_INTERNALS(internals)                                                    \
+        std::unique_lock<::pybind11::detail::pymutex> lock((internals).mutex)
+#else
+#    define PYBIND11_LOCK_INTERNALS(internals)
+#endif
+
+/// Calls `cb` with the internals, which stay locked during the call in free-threaded builds.
+/// `cb` must not call back into Python code.
+template <typename F>
+inline auto with_internals(const F &cb) -> decltype(cb(get_internals())) {
+    auto &internals = get_internals();
+    PYBIND11_LOCK_INTERNALS(internals);
+    return cb(internals);
+}
+
+/// Calls `cb` with the map of registered instances that `ptr` belongs to, which stays locked
+/// during the call in free-threaded builds
+template <typename F>
+inline auto with_instance_map(const void *ptr, const F &cb)
+    -> decltype(cb(std::declval<instance_map &>())) {
+    auto &internals = get_internals();
+#if defined(Py_GIL_DISABLED)
+    // Fibonacci hashing, as in `instance_map`; the top bits go to the shard index, so that the
+    // shards do not only see pointers that also end up close together in their own table
+    const auto hash = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(ptr))
+                      * UINT64_C(0x9E3779B97F4A7C15);
+    auto &shard = internals.instance_shards[static_cast<size_t>(hash >> 32)
+                                            & internals.instance_shards_mask];
+    std::unique_lock<pymutex> lock(shard.mutex);
+    return cb(shard.registered_instances);
+#else
+    (void) ptr;
+    return cb(internals.registered_instances);
+#endif
+}
+
+/// The number of instances in the registered instances
+inline size_t num_registered_instances() {
+    auto &internals = get_internals();
+#if defined(Py_GIL_DISABLED)
+    size_t count = 0;
+    for (size_t i = 0; i <= internals.instance_shards_mask; ++i) {
+        auto &shard = internals.instance_shards[i];
+        std::unique_lock<pymutex> lock(shard.mutex);
+        count += shard.registered_instances.size();
+    }
+    return count;
+#else
+    return internals.registered_instances.size();
+#endif
+}
+
 // the internals struct (above) is shared between all the modules. local_internals are only
 // for a single module. Any changes made to internals may require an update to
 // PYBIND11_INTERNALS_VERSION, breaking backwards compatibility. local_internals is, by design,
@@ -544,6 +870,17 @@ PYBIND11_NOINLINE internals &get_internals() {
 struct local_internals {
     type_map<type_info *> registered_types_cpp;
     std::forward_list<ExceptionTranslator> registered_exception_translators;
+    /// The types of `py::native_member()` descriptors, of instance and static members, created
+    /// when the first descriptor of each kind is made. `finalize_interpreter()` resets them.
+    PyTypeObject *native_member_type = nullptr;
+    PyTypeObject *native_static_member_type = nullptr;
+    /// The `str` objects returned for `py::interned<T>`, by content and by address (see
+    /// `interned_str_cache`)
+    std::unordered_map<std::string, PyObject *> interned_strings;
+    std::unordered_map<const void *, PyObject *> interned_pointers;
+#if defined(Py_GIL_DISABLED)
+    pymutex interned_mutex;
+#endif
 #if defined(WITH_THREAD) && PYBIND11_INTERNALS_VERSION == 4
 
     // For ABI compatibility, we can't store the loader_life_support TLS key in
@@ -580,8 +917,41 @@ struct local_internals {
 #endif //  defined(WITH_THREAD) && PYBIND11_INTERNALS_VERSION == 4
 };
 
+#if defined(PYBIND11_HAS_SUBINTERPRETER_SUPPORT)
+/// Loads the `local_internals` of this module in the current subinterpreter from its state dict,
+/// or creates them. Like those of the main interpreter, they are never destroyed.
+PYBIND11_NOINLINE local_internals *load_subinterpreter_local_internals() {
+    // Tells the modules apart in the state dict
+    static const char module_tag = 0;
+    auto key = std::string(PYBIND11_MODULE_LOCAL_ID)
+               + std::to_string(reinterpret_cast<std::uintptr_t>(&module_tag));
+    dict state_dict = get_python_state_dict();
+    if (PyObject *obj = dict_getitemstring(state_dict.ptr(), key.c_str())) {
+        void *raw_ptr = PyCapsule_GetPointer(obj, /*name=*/nullptr);
+        if (raw_ptr == nullptr) {
+            throw error_already_set();
+        }
+        return static_cast<local_internals *>(raw_ptr);
+    }
+    auto *locals = new local_internals();
+    state_dict[key.c_str()] = capsule(locals);
+    return locals;
+}
+#endif
+
 /// Works like `get_internals`, but for things which are locally registered.
 inline local_internals &get_local_internals() {
+#if defined(PYBIND11_HAS_SUBINTERPRETER_SUPPORT)
+    auto *interp = current_subinterpreter();
+    if (interp != nullptr && get_internals_pp() != get_main_internals_pp()) {
+        static thread_local subinterpreter_entry<local_internals *> last{nullptr, -1, nullptr};
+        if (!last.matches(interp)) {
+            auto *locals = load_subinterpreter_local_internals();
+            last = {interp, PyInterpreterState_GetID(interp), locals};
+        }
+        return *last.value;
+    }
+#endif
     // Current static can be created in the interpreter finalization routine. If the later will be
     // destroyed in another static variable destructor, creation of this static there will cause
     // static deinitialization fiasco. In order to avoid it we avoid destruction of the
@@ -597,9 +967,12 @@ inline local_internals &get_local_internals() {
 /// suitable for c-style strings needed by Python internals (such as PyTypeObject's tp_name).
 template <typename... Args>
 const char *c_str(Args &&...args) {
-    auto &strings = get_internals().static_strings;
-    strings.emplace_front(std::forward<Args>(args)...);
-    return strings.front().c_str();
+    // Strings only ever get added, so the one returned stays valid after unlocking
+    return with_internals([&](internals &internals) {
+        auto &strings = internals.static_strings;
+        strings.emplace_front(std::forward<Args>(args)...);
+        return strings.front().c_str();
+    });
 }
 
 inline const char *get_function_record_capsule_name() {
@@ -621,20 +994,108 @@ inline bool is_function_record_capsule(const capsule &cap) {
     return cap.name() == get_function_record_capsule_name();
 }
 
+inline PyInterpreterState *current_interpreter() {
+#if PY_VERSION_HEX >= 0x03090000
+    return PyInterpreterState_Get();
+#else
+    return PyThreadState_Get()->interp;
+#endif
+}
+
+/// Tells module-level caches of Python objects whether those objects are still alive: the
+/// generation changes whenever the interpreter they were made in is finalized. Like the
+/// instance freelist, it is tied to one interpreter at a time through a capsule in its state
+/// dict.
+struct interpreter_lifetime {
+    PyInterpreterState *owner = nullptr;
+    size_t generation = 0;
+
+    static interpreter_lifetime &get() {
+        static interpreter_lifetime lifetime;
+        return lifetime;
+    }
+
+    /// Returns the generation of the current interpreter, or 0 if it is not the one tracked.
+    /// Always 0 in free-threaded builds, where nothing would keep threads from racing on the
+    /// caches, and in subinterpreters, which may have a GIL of their own.
+    size_t current() {
+#if defined(Py_GIL_DISABLED)
+        return 0;
+#else
+        if (!in_main_interpreter()) {
+            return 0;
+        }
+        auto *interpreter = current_interpreter();
+        if (owner == interpreter) {
+            return generation;
+        }
+        if (owner != nullptr || !Py_IsInitialized() || !claim_for(interpreter)) {
+            return 0;
+        }
+        return generation;
+#endif
+    }
+
+private:
+    bool claim_for(PyInterpreterState *interpreter) {
+        auto *cap = PyCapsule_New(this, nullptr, [](PyObject *) { get().owner = nullptr; });
+        if (cap == nullptr) {
+            PyErr_Clear();
+            return false;
+        }
+        auto key = "__pybind11_interpreter_lifetime_"
+                   + std::to_string(reinterpret_cast<std::uintptr_t>(this)) + "__";
+        int status = -1;
+        try {
+            status = PyDict_SetItemString(get_python_state_dict().ptr(), key.c_str(), cap);
+        } catch (error_already_set &) {
+        }
+        Py_DECREF(cap);
+        if (status != 0) {
+            PyErr_Clear();
+            return false;
+        }
+        owner = interpreter;
+        ++generation;
+        return true;
+    }
+};
+
 PYBIND11_NAMESPACE_END(detail)
 
+inline object interned_str::get() const {
+    const size_t generation = detail::interpreter_lifetime::get().current();
+    if (generation != 0 && generation == m_generation) {
+        return reinterpret_borrow<object>(m_str);
+    }
+    PyObject *result = PyUnicode_InternFromString(m_value);
+    if (result == nullptr) {
+        throw error_already_set();
+    }
+    if (generation == 0) {
+        return reinterpret_steal<object>(result);
+    }
+    // Not released: the string of an earlier generation may have been freed with its interpreter
+    m_str = result;
+    m_generation = generation;
+    return reinterpret_borrow<object>(m_str);
+}
+
 /// Returns a named pointer that is shared among all extension modules (using the same
 /// pybind11 version) running in the current interpreter. Names starting with underscores
 /// are reserved for internal usage. Returns `nullptr` if no matching entry was found.
 PYBIND11_NOINLINE void *get_shared_data(const std::string &name) {
-    auto &internals = detail::get_internals();
-    auto it = internals.shared_data.find(name);
-    return it != internals.shared_data.end() ? it->second : nullptr;
+    return detail::with_internals([&](detail::internals &internals) {
+        auto it = internals.shared_data.find(name);
+        return it != internals.shared_data.end() ? it->second : nullptr;
+    });
 }
 
 /// Set the shared data that can be later recovered by `get_shared_data()`.
 PYBIND11_NOINLINE void *set_shared_data(const std::string &name, void *data) {
-    detail::get_internals().shared_data[name] = data;
+    detail::with_internals([&](detail::internals &internals) {
+        internals.shared_data[name] = data;
+    });
     return data;
 }
 
@@ -643,14 +1104,15 @@ PYBIND11_NOINLINE void *set_shared_data(const std::string &name, void *data) {
 /// added to the shared data under the given name and a reference to it is returned.
 template <typename T>
 T &get_or_create_shared_data(const std::string &name) {
-    auto &internals = detail::get_internals();
-    auto it = internals.shared_data.find(name);
-    T *ptr = (T *) (it != internals.shared_data.end() ? it->second : nullptr);
-    if (!ptr) {
-        ptr = new T();
-        internals.shared_data[name] = ptr;
-    }
-    return *ptr;
+    return *detail::with_internals([&](detail::internals &internals) {
+        auto it = internals.shared_data.find(name);
+        T *ptr = (T *) (it != internals.shared_data.end() ? it->second : nullptr);
+        if (!ptr) {
+            ptr = new T();
+            internals.shared_data[name] = ptr;
+        }
+        return ptr;
+    });
 }
 
 PYBIND11_NAMESPACE_END(PYBIND11_NAMESPACE)
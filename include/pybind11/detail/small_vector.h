@@ -0,0 +1,99 @@
+// Copyright (c) 2023 The pybind Community.
+
+#pragma once
+
+#include "common.h"
+
+#include <array>
+#include <memory>
+
+PYBIND11_NAMESPACE_BEGIN(PYBIND11_NAMESPACE)
+PYBIND11_NAMESPACE_BEGIN(detail)
+
+/// A minimal vector of default-constructible elements that keeps up to `InlineSize` of them
+/// inside the object itself, and only moves them to the heap when it grows beyond that. Used for
+/// the per-call argument lists in `function_call`, so that ordinary calls do not allocate.
+template <typename T, size_t InlineSize>
+class small_vector {
+public:
+    using value_type = T;
+    using size_type = size_t;
+    using iterator = T *;
+    using const_iterator = const T *;
+
+    small_vector() = default;
+    small_vector(small_vector &&other) noexcept { swap(other); }
+    small_vector &operator=(small_vector &&other) noexcept {
+        small_vector(std::move(other)).swap(*this);
+        return *this;
+    }
+
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    size_t capacity() const { return m_heap ? m_capacity : InlineSize; }
+
+    T *data() { return m_heap ? m_heap.get() : m_inline.data(); }
+    const T *data() const { return m_heap ? m_heap.get() : m_inline.data(); }
+
+    T &operator[](size_t i) { return data()[i]; }
+    const T &operator[](size_t i) const { return data()[i]; }
+    T &back() { return data()[m_size - 1]; }
+    const T &back() const { return data()[m_size - 1]; }
+
+    iterator begin() { return data(); }
+    iterator end() { return data() + m_size; }
+    const_iterator begin() const { return data(); }
+    const_iterator end() const { return data() + m_size; }
+
+    void reserve(size_t n) {
+        if (n <= capacity()) {
+            return;
+        }
+        std::unique_ptr<T[]> heap(new T[n]());
+        T *old = data();
+        for (size_t i = 0; i < m_size; ++i) {
+            heap[i] = std::move(old[i]);
+        }
+        m_heap = std::move(heap);
+        m_capacity = n;
+    }
+
+    void push_back(const T &value) {
+        if (m_size == capacity()) {
+            reserve(m_size * 2);
+        }
+        data()[m_size++] = value;
+    }
+
+    template <typename... Args>
+    void emplace_back(Args &&...args) {
+        push_back(T(std::forward<Args>(args)...));
+    }
+
+    void resize(size_t n, const T &value = T()) {
+        reserve(n);
+        for (size_t i = m_size; i < n; ++i) {
+            data()[i] = value;
+        }
+        m_size = n;
+    }
+
+    void clear() { m_size = 0; }
+
+    void swap(small_vector &other) noexcept {
+        std::swap(m_inline, other.m_inline);
+        m_heap.swap(other.m_heap);
+        std::swap(m_size, other.m_size);
+        std::swap(m_capacity, other.m_capacity);
+    }
+
+private:
+    std::array<T, InlineSize> m_inline{};
+    // When the elements no longer fit inline, all of them live here instead.
+    std::unique_ptr<T[]> m_heap;
+    size_t m_capacity = 0;
+    size_t m_size = 0;
+};
+
+PYBIND11_NAMESPACE_END(detail)
+PYBIND11_NAMESPACE_END(PYBIND11_NAMESPACE)
@@ -0,0 +1,105 @@
+// Copyright (c) 2023 The pybind Community.
+
+#pragma once
+
+#include "common.h"
+
+#if defined(PYBIND11_TRACING)
+#    include <atomic>
+#    if defined(__linux__) && defined(__has_include)
+#        if __has_include(<sys/sdt.h>)
+#            include <sys/sdt.h>
+#            define PYBIND11_HAS_USDT
+#        endif
+#    endif
+#endif
+
+PYBIND11_NAMESPACE_BEGIN(PYBIND11_NAMESPACE)
+
+#if defined(PYBIND11_TRACING)
+/// The events reported to the trace hook (see `set_trace_hook()`). The meaning of the `name` and
+/// `data` arguments of the hook is given for each event.
+enum class trace_event {
+    /// A bound function was called and its arguments are loaded: the name of the function and
+    /// its `detail::function_record`
+    function_entry,
+    /// The function returned (or threw), and its return value was converted: as above
+    function_exit,
+    /// An overload was tried, but could not load the arguments: as above
+    overload_failed,
+    /// An argument was converted implicitly: the name of the target type and the source object
+    implicit_conversion,
+    /// An instance was registered: the name of its type and the pointer to the C++ value
+    instance_registered,
+    /// A `keep_alive` relation was established: the type name of the nurse and the patient
+    keep_alive,
+    /// The current thread acquired the GIL in `gil_scoped_acquire` or `gil_scoped_release`:
+    /// no name, and the thread state
+    gil_acquire,
+    /// ... and released it again: as above
+    gil_release,
+};
+
+/// A function that is called for every trace event. It must not call into Python, and it can be
+/// called without holding the GIL.
+using trace_hook = void (*)(trace_event event, const char *name, const void *data);
+
+PYBIND11_NAMESPACE_BEGIN(detail)
+
+/// The trace hook is set per extension module, like the dispatch statistics
+inline std::atomic<trace_hook> &trace_hook_slot() {
+    static std::atomic<trace_hook> hook{nullptr};
+    return hook;
+}
+
+inline void trace(trace_event event, const char *name, const void *data) {
+#    if defined(PYBIND11_HAS_USDT)
+    // The probes are `pybind11:<event>`, with the same arguments as the hook
+    switch (event) {
+        case trace_event::function_entry:
+            DTRACE_PROBE2(pybind11, function_entry, name, data);
+            break;
+        case trace_event::function_exit:
+            DTRACE_PROBE2(pybind11, function_exit, name, data);
+            break;
+        case trace_event::overload_failed:
+            DTRACE_PROBE2(pybind11, overload_failed, name, data);
+            break;
+        case trace_event::implicit_conversion:
+            DTRACE_PROBE2(pybind11, implicit_conversion, name, data);
+            break;
+        case trace_event::instance_registered:
+            DTRACE_PROBE2(pybind11, instance_registered, name, data);
+            break;
+        case trace_event::keep_alive:
+            DTRACE_PROBE2(pybind11, keep_alive, name, data);
+            break;
+        case trace_event::gil_acquire:
+            DTRACE_PROBE2(pybind11, gil_acquire, name, data);
+            break;
+        case trace_event::gil_release:
+            DTRACE_PROBE2(pybind11, gil_release, name, data);
+            break;
+    }
+#    endif
+    if (trace_hook hook = trace_hook_slot().load(std::memory_order_acquire)) {
+        hook(event, name, data);
+    }
+}
+
+PYBIND11_NAMESPACE_END(detail)
+
+/// Sets the function that is called for the trace events of this extension module (or none, if
+/// `hook` is nullptr), and returns the previous one. Requires compiling with ``PYBIND11_TRACING``
+/// defined.
+inline trace_hook set_trace_hook(trace_hook hook) {
+    return detail::trace_hook_slot().exchange(hook, std::memory_order_acq_rel);
+}
+
+#    define PYBIND11_TRACE(event, name, data)                                                     \
+        ::pybind11::detail::trace(::pybind11::trace_event::event, name, data)
+#else
+#    define PYBIND11_TRACE(event, name, data) ((void) 0)
+#endif
+
+PYBIND11_NAMESPACE_END(PYBIND11_NAMESPACE)
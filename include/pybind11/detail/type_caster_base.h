@@ -13,10 +13,15 @@
 #include "common.h"
 #include "descr.h"
 #include "internals.h"
+#include "small_vector.h"
+#include "tracing.h"
 #include "typeid.h"
 
+#include <array>
 #include <cstdint>
+#include <functional>
 #include <iterator>
+#include <memory>
 #include <new>
 #include <string>
 #include <type_traits>
@@ -34,7 +39,9 @@ PYBIND11_NAMESPACE_BEGIN(detail)
 class loader_life_support {
 private:
     loader_life_support *parent = nullptr;
-    std::unordered_set<PyObject *> keep_alive;
+    // The patients of this frame, with one reference each. Most calls have none or only a few, so
+    // these are kept inline in the frame (which lives on the stack) rather than in a hash set.
+    small_vector<PyObject *, 4> keep_alive;
 
 #if defined(WITH_THREAD)
     // Store stack pointer in thread-local storage.
@@ -90,12 +97,35 @@ public:
                              "of temporary values");
         }
 
-        if (frame->keep_alive.insert(h.ptr()).second) {
-            Py_INCREF(h.ptr());
+        // Each entry holds its own reference, so duplicates are harmless; only skip the common
+        // case of the same temporary being added again right away.
+        if (frame->keep_alive.empty() || frame->keep_alive.back() != h.ptr()) {
+            frame->keep_alive.push_back(h.inc_ref().ptr());
         }
     }
 };
 
+#if PYBIND11_INTERNALS_VERSION > 5 && !defined(PYPY_VERSION) && !defined(Py_GIL_DISABLED)
+#    define PYBIND11_HAS_TYPE_INFO_SLOT
+
+/// The type objects created by pybind11's default metaclass, and by Python subclasses of it: the
+/// heap type is followed by a pointer to the `all_type_info()` cache entry of the type, so that
+/// the common case of that lookup does not go through `registered_types_py`.
+struct pybind11_heap_type {
+    PyHeapTypeObject heap_type;
+    const std::vector<type_info *> *all_type_info;
+};
+
+/// Returns the cache slot of `type`, or nullptr if it was not created by a pybind11 metaclass
+inline const std::vector<type_info *> **all_type_info_slot(PyTypeObject *type) {
+    auto *metaclass = get_internals().default_metaclass;
+    if (Py_TYPE(type) != metaclass && PyType_IsSubtype(Py_TYPE(type), metaclass) == 0) {
+        return nullptr;
+    }
+    return &reinterpret_cast<pybind11_heap_type *>(type)->all_type_info;
+}
+#endif
+
 // Gets the cache entry for the given type, creating it if necessary.  The return value is the pair
 // returned by emplace, i.e. an iterator for the entry and a bool set to `true` if the entry was
 // just created.
@@ -167,15 +197,38 @@ PYBIND11_NOINLINE void all_type_info_populate(PyTypeObject *t, std::vector<type_
  * The value is cached for the lifetime of the Python type.
  */
 inline const std::vector<detail::type_info *> &all_type_info(PyTypeObject *type) {
+#if defined(PYBIND11_HAS_TYPE_INFO_SLOT)
+    auto *slot = all_type_info_slot(type);
+    if (slot != nullptr && *slot != nullptr) {
+        return **slot;
+    }
+#endif
     auto ins = all_type_info_get_cache(type);
+#if !defined(Py_GIL_DISABLED)
     if (ins.second) {
         // New cache entry: populate it
         all_type_info_populate(type, ins.first->second);
     }
+#endif
+#if defined(PYBIND11_HAS_TYPE_INFO_SLOT)
+    if (slot != nullptr) {
+        // The entry is erased only when the type itself is destroyed
+        *slot = &ins.first->second;
+    }
+#endif
 
     return ins.first->second;
 }
 
+#if PYBIND11_INTERNALS_VERSION > 5
+/// Casts the value pointer of a type to the pointer to its base `bases[i]`, for the
+/// `type_info::base_casts` of the type
+inline void *cast_to_base(const std::vector<base_cast> &bases, size_t i, void *valueptr) {
+    const auto &base = bases[i];
+    return base.cast(base.from == 0 ? valueptr : cast_to_base(bases, base.from - 1, valueptr));
+}
+#endif
+
 /**
  * Gets a single pybind11 type info for a python type.  Returns nullptr if neither the type nor any
  * ancestors are pybind11-registered.  Throws an exception if there are multiple bases--use
@@ -194,21 +247,146 @@ PYBIND11_NOINLINE detail::type_info *get_type_info(PyTypeObject *type) {
 }
 
 inline detail::type_info *get_local_type_info(const std::type_index &tp) {
-    auto &locals = get_local_internals().registered_types_cpp;
-    auto it = locals.find(tp);
-    if (it != locals.end()) {
-        return it->second;
-    }
-    return nullptr;
+    // The local internals are protected by the mutex of the (global) internals as well
+    return with_internals([&](internals &) -> type_info * {
+        auto &locals = get_local_internals().registered_types_cpp;
+        auto it = locals.find(tp);
+        if (it != locals.end()) {
+            return it->second;
+        }
+        return nullptr;
+    });
 }
 
 inline detail::type_info *get_global_type_info(const std::type_index &tp) {
-    auto &types = get_internals().registered_types_cpp;
-    auto it = types.find(tp);
-    if (it != types.end()) {
-        return it->second;
+    return with_internals([&](internals &internals) -> type_info * {
+        auto &types = internals.registered_types_cpp;
+        auto it = types.find(tp);
+        if (it != types.end()) {
+            return it->second;
+        }
+        return nullptr;
+    });
+}
+
+/// Bindings added with `module_::def_lazy()`, which are created when they are first needed
+struct lazy_binding {
+    /// A weak reference to the module, which the pending binding does not keep alive
+    weakref scope;
+    std::string name;
+    std::vector<std::type_index> types;
+    std::function<void(handle)> init;
+
+    /// Calls `init` unless it already ran or the module is gone. It is kept if it throws, so that
+    /// it runs again next time.
+    void materialize() {
+        object module = scope();
+        if (!init || module.is_none()) {
+            return;
+        }
+        auto f = std::move(init);
+        init = nullptr;
+        try {
+            f(module);
+        } catch (...) {
+            init = std::move(f);
+            throw;
+        }
     }
-    return nullptr;
+};
+
+/// The pending lazy bindings of all modules, by module and attribute name, and by the C++ types
+/// they register. Shared by all extension modules through `internals.shared_data`, and only used
+/// with the internals locked.
+struct lazy_bindings {
+    std::unordered_map<PyObject *, std::unordered_map<std::string, std::shared_ptr<lazy_binding>>>
+        by_name;
+    type_map<std::shared_ptr<lazy_binding>> by_type;
+    /// Weak references to the modules in `by_name`, whose callbacks drop their bindings
+    std::unordered_map<PyObject *, object> module_refs;
+
+    /// Drops a binding once it ran
+    void erase(const lazy_binding &binding, PyObject *module) {
+        auto it = by_name.find(module);
+        if (it != by_name.end()) {
+            auto named = it->second.find(binding.name);
+            if (named != it->second.end() && named->second.get() == &binding) {
+                it->second.erase(named);
+            }
+        }
+        for (const auto &tp : binding.types) {
+            auto typed = by_type.find(tp);
+            if (typed != by_type.end() && typed->second.get() == &binding) {
+                by_type.erase(typed);
+            }
+        }
+    }
+
+    /// Drops the bindings of a module that is gone. Returns its weak reference, which the caller
+    /// releases after unlocking.
+    object erase_module(PyObject *module) {
+        auto it = by_name.find(module);
+        if (it != by_name.end()) {
+            for (const auto &entry : it->second) {
+                erase(*entry.second, nullptr);
+            }
+            by_name.erase(it);
+        }
+        object ref;
+        auto ref_it = module_refs.find(module);
+        if (ref_it != module_refs.end()) {
+            ref = std::move(ref_it->second);
+            module_refs.erase(ref_it);
+        }
+        return ref;
+    }
+};
+
+/// The key of `lazy_bindings` in `internals.shared_data`, to be changed along with its layout
+#define PYBIND11_LAZY_BINDINGS_ID "_lazy_bindings_v1"
+
+inline lazy_bindings *find_lazy_bindings(internals &internals) {
+    auto it = internals.shared_data.find(PYBIND11_LAZY_BINDINGS_ID);
+    return it != internals.shared_data.end() ? static_cast<lazy_bindings *>(it->second)
+                                             : nullptr;
+}
+
+inline lazy_bindings &get_lazy_bindings(internals &internals) {
+    auto &ptr = internals.shared_data[PYBIND11_LAZY_BINDINGS_ID];
+    if (!ptr) {
+        ptr = new lazy_bindings();
+    }
+    return *static_cast<lazy_bindings *>(ptr);
+}
+
+/// Runs a pending lazy binding, and drops it if it succeeds
+inline void materialize_lazy_binding(const std::shared_ptr<lazy_binding> &binding,
+                                     PyObject *module) {
+    binding->materialize();
+    with_internals([&](internals &internals) {
+        if (auto *bindings = find_lazy_bindings(internals)) {
+            bindings->erase(*binding, module);
+        }
+    });
+}
+
+/// Creates the lazy binding registering the C++ type `tp`, if there is one. Returns whether it
+/// ran.
+PYBIND11_NOINLINE bool materialize_lazy_type(const std::type_index &tp) {
+    auto binding = with_internals([&](internals &internals) -> std::shared_ptr<lazy_binding> {
+        auto *bindings = find_lazy_bindings(internals);
+        if (bindings == nullptr) {
+            return nullptr;
+        }
+        auto it = bindings->by_type.find(tp);
+        return it != bindings->by_type.end() ? it->second : nullptr;
+    });
+    if (!binding || !binding->init) {
+        return false;
+    }
+    object module = binding->scope();
+    materialize_lazy_binding(binding, module.ptr());
+    return true;
 }
 
 /// Return the type info for a given C++ type; on lookup failure can either throw or return
@@ -221,6 +399,9 @@ PYBIND11_NOINLINE detail::type_info *get_type_info(const std::type_index &tp,
     if (auto *gtype = get_global_type_info(tp)) {
         return gtype;
     }
+    if (materialize_lazy_type(tp)) {
+        return get_type_info(tp, throw_if_missing);
+    }
 
     if (throw_if_missing) {
         std::string tname = tp.name();
@@ -231,25 +412,301 @@ PYBIND11_NOINLINE detail::type_info *get_type_info(const std::type_index &tp,
     return nullptr;
 }
 
+#if defined(Py_GIL_DISABLED)
+#    define PYBIND11_HAS_TYPE_INFO_CACHE
+
+/// The result of `get_type_info()` for one C++ type, which stays valid for as long as the
+/// internals keep their `registered_types_epoch`. Reading it takes no lock: as in a seqlock,
+/// `m_sequence` is odd while a thread updates the entry, and changes if one did during the read.
+class type_info_cache {
+public:
+    type_info *get(const std::type_info &tp) {
+        auto &internals = get_internals();
+        const size_t epoch = internals.registered_types_epoch.load(std::memory_order_acquire);
+        const size_t sequence = m_sequence.load(std::memory_order_acquire);
+        if ((sequence & 1) == 0) {
+            const auto *owner = m_owner.load(std::memory_order_relaxed);
+            const size_t cached_epoch = m_epoch.load(std::memory_order_relaxed);
+            type_info *cached = m_tinfo.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (m_sequence.load(std::memory_order_relaxed) == sequence && owner == &internals
+                && cached_epoch == epoch) {
+                return cached;
+            }
+        }
+        auto *tinfo = get_type_info(std::type_index(tp));
+        // If another thread is updating the entry, it is left to that one
+        size_t expected = m_sequence.load(std::memory_order_relaxed);
+        if ((expected & 1) == 0
+            && m_sequence.compare_exchange_strong(
+                expected, expected + 1, std::memory_order_relaxed)) {
+            std::atomic_thread_fence(std::memory_order_release);
+            // Was loaded before the lookup, so the entry can only be older than it looks
+            m_epoch.store(epoch, std::memory_order_relaxed);
+            m_owner.store(&internals, std::memory_order_relaxed);
+            m_tinfo.store(tinfo, std::memory_order_relaxed);
+            m_sequence.store(expected + 2, std::memory_order_release);
+        }
+        return tinfo;
+    }
+
+private:
+    std::atomic<size_t> m_sequence{0};
+    std::atomic<const internals *> m_owner{nullptr};
+    std::atomic<size_t> m_epoch{0};
+    std::atomic<type_info *> m_tinfo{nullptr};
+};
+
+/// Expires all `type_info_cache` entries. Called with the internals locked.
+inline void invalidate_type_info_caches(internals &internals) {
+    internals.registered_types_epoch.fetch_add(1, std::memory_order_release);
+}
+#elif PYBIND11_INTERNALS_VERSION > 5
+#    define PYBIND11_HAS_TYPE_INFO_CACHE
+#    define PYBIND11_HAS_POLYMORPHIC_TYPE_INFO_CACHE
+
+/// The result of `get_type_info()` for one C++ type, which stays valid until any type is
+/// registered or destroyed, or the internals are replaced when the interpreter is finalized.
+/// Subinterpreters always do the lookup.
+struct type_info_cache {
+    const internals *owner = nullptr;
+    std::weak_ptr<void> token;
+    type_info *tinfo = nullptr;
+
+    type_info *get(const std::type_info &tp) {
+        if (!in_main_interpreter()) {
+            return get_type_info(std::type_index(tp));
+        }
+        auto &internals = get_internals();
+        if (owner != &internals || token.expired()) {
+            tinfo = get_type_info(std::type_index(tp));
+            owner = tinfo != nullptr ? &internals : nullptr;
+            token = internals.registered_types_token;
+        }
+        return tinfo;
+    }
+};
+
+/// The results of `get_type_info()` for the most-derived types seen behind pointers to one
+/// polymorphic type, with the same lifetime as `type_info_cache`. Types that are not registered
+/// are remembered as well, since unbound derived classes are just as common there.
+struct polymorphic_type_info_cache {
+    static constexpr size_t capacity = 8;
+
+    // An aggregate, so that C++11 can brace-initialize it; `entries{}` zeroes them all.
+    struct entry {
+        const std::type_info *type;
+        type_info *tinfo;
+    };
+
+    const internals *owner = nullptr;
+    std::weak_ptr<void> token;
+    std::array<entry, capacity> entries{};
+    size_t next = 0;
+
+    type_info *get(const std::type_info &tp) {
+        if (!in_main_interpreter()) {
+            return get_type_info(std::type_index(tp));
+        }
+        auto &internals = get_internals();
+        if (owner != &internals || token.expired()) {
+            entries = {};
+            next = 0;
+            owner = &internals;
+            token = internals.registered_types_token;
+        }
+        for (const auto &e : entries) {
+            if (e.type == &tp) {
+                return e.tinfo;
+            }
+        }
+        auto *tinfo = get_type_info(std::type_index(tp));
+        entries[next] = {&tp, tinfo};
+        next = (next + 1) % capacity;
+        return tinfo;
+    }
+};
+
+/// Expires all `type_info_cache` and `polymorphic_type_info_cache` entries
+inline void invalidate_type_info_caches(internals &internals) {
+    internals.registered_types_token = std::make_shared<char>();
+}
+#endif
+
+/// Same as `get_type_info(typeid(T))`, but only does the lookup once per type if possible
+template <typename T>
+type_info *get_type_info_cached() {
+#if defined(PYBIND11_HAS_TYPE_INFO_CACHE)
+    static type_info_cache cache;
+    return cache.get(typeid(T));
+#else
+    return get_type_info(typeid(T));
+#endif
+}
+
+/// Same as `get_type_info(tp)` for a type `tp` derived from `T`
+template <typename T>
+type_info *get_derived_type_info_cached(const std::type_info &tp) {
+#if defined(PYBIND11_HAS_POLYMORPHIC_TYPE_INFO_CACHE)
+    static polymorphic_type_info_cache cache;
+    return cache.get(tp);
+#else
+    return get_type_info(tp);
+#endif
+}
+
+/// Returns the version tag of `type`, or 0 if it currently has no valid one. CPython assigns a
+/// new tag whenever the type or one of its bases is modified, and never reuses them.
+inline unsigned int valid_version_tag(PyTypeObject *type) {
+#if defined(PYPY_VERSION)
+    (void) type;
+    return 0;
+#else
+    return PyType_HasFeature(type, Py_TPFLAGS_VALID_VERSION_TAG) ? type->tp_version_tag : 0;
+#endif
+}
+
+/// Remembers the Python types from which `try_load_foreign_module_local()` cannot load a given
+/// C++ type. That only depends on the attributes of the type, so a miss stays valid for as long
+/// as the type keeps its version tag.
+class foreign_module_local_misses {
+public:
+    static foreign_module_local_misses &get() {
+        // Leaked on purpose, like the local internals
+        static auto *misses = new foreign_module_local_misses();
+        return *misses;
+    }
+
+    bool contains(PyTypeObject *type, const std::type_info *cpptype) const {
+        // Subinterpreters with a GIL of their own would race on the map
+        if (!in_main_interpreter()) {
+            return false;
+        }
+        const auto tag = valid_version_tag(type);
+        if (tag == 0) {
+            return false;
+        }
+        PYBIND11_LOCK_INTERNALS(get_internals());
+        auto it = m_misses.find(std::make_pair(type, cpptype));
+        return it != m_misses.end() && it->second == tag;
+    }
+
+    void insert(PyTypeObject *type, const std::type_info *cpptype) {
+        if (!in_main_interpreter()) {
+            return;
+        }
+        if (const auto tag = valid_version_tag(type)) {
+            // Entries of destroyed types are never looked up again, so just start over when
+            // there are too many
+            PYBIND11_LOCK_INTERNALS(get_internals());
+            if (m_misses.size() >= max_size) {
+                m_misses.clear();
+            }
+            m_misses[std::make_pair(type, cpptype)] = tag;
+        }
+    }
+
+private:
+    using key_type = std::pair<const PyTypeObject *, const std::type_info *>;
+
+    struct key_hash {
+        size_t operator()(const key_type &v) const {
+            size_t value = std::hash<const void *>()(v.first);
+            value
+                ^= std::hash<const void *>()(v.second) + 0x9e3779b9 + (value << 6) + (value >> 2);
+            return value;
+        }
+    };
+
+    static constexpr size_t max_size = 4096;
+    std::unordered_map<key_type, unsigned int, key_hash> m_misses;
+};
+
 PYBIND11_NOINLINE handle get_type_handle(const std::type_info &tp, bool throw_if_missing) {
     detail::type_info *type_info = get_type_info(tp, throw_if_missing);
     return handle(type_info ? ((PyObject *) type_info->type) : nullptr);
 }
 
+/// Whether the instances of a type are tracked in `registered_instances`. The
+/// `py::no_instance_registry` annotation needs `PYBIND11_INTERNALS_VERSION` 6 or higher and is
+/// ignored otherwise.
+inline bool uses_instance_registry(const type_info *tinfo) {
+#if PYBIND11_INTERNALS_VERSION > 5
+    return !tinfo->no_instance_registry;
+#else
+    (void) tinfo;
+    return true;
+#endif
+}
+
+/// The values of a `py::enum_` with `py::fast_enum()`, or nullptr. They need
+/// `PYBIND11_INTERNALS_VERSION` 6 or higher; conversions create new objects otherwise.
+inline enum_value_table *get_enum_values(const type_info *tinfo) {
+#if PYBIND11_INTERNALS_VERSION > 5
+    return tinfo->enum_values;
+#else
+    (void) tinfo;
+    return nullptr;
+#endif
+}
+
+/// Returns new references to the instances registered for `ptr`. They are taken with the
+/// instances locked, before another thread can destroy them, but can only be inspected after
+/// unlocking: looking up their types may run Python code (e.g. the garbage collector), which
+/// can deregister other instances.
+inline small_vector<object, 4> registered_instances_of(const void *ptr) {
+    small_vector<object, 4> result;
+    with_instance_map(ptr, [&](instance_map &instances) {
+        instances.find_if(ptr, [&](instance *candidate) {
+            result.push_back(reinterpret_borrow<object>((PyObject *) candidate));
+            return false;
+        });
+    });
+    return result;
+}
+
 // Searches the inheritance graph for a registered Python instance, using all_type_info().
 PYBIND11_NOINLINE handle find_registered_python_instance(void *src,
                                                          const detail::type_info *tinfo) {
-    auto it_instances = get_internals().registered_instances.equal_range(src);
-    for (auto it_i = it_instances.first; it_i != it_instances.second; ++it_i) {
-        for (auto *instance_type : detail::all_type_info(Py_TYPE(it_i->second))) {
+    for (auto &candidate : registered_instances_of(src)) {
+        for (auto *instance_type : detail::all_type_info(Py_TYPE(candidate.ptr()))) {
             if (instance_type && same_type(*instance_type->cpptype, *tinfo->cpptype)) {
-                return handle((PyObject *) it_i->second).inc_ref();
+                return candidate.release();
             }
         }
     }
     return handle();
 }
 
+/// Values larger than this alignment are never stored inside instances (Python object memory is
+/// only guaranteed to be aligned to 8 bytes)
+constexpr size_t inline_storage_max_align = 8;
+
+/// Offset of the value stored inside instances of types bound with `py::inline_storage`
+inline size_t inline_value_offset(size_t align) {
+    return (sizeof(instance) + align - 1) / align * align;
+}
+
+/// Whether values of type `tinfo` can be stored inside its instances. The `py::inline_storage`
+/// annotation needs `PYBIND11_INTERNALS_VERSION` 6 or higher and is ignored otherwise.
+inline bool has_inline_storage(const type_info *tinfo) {
+#if PYBIND11_INTERNALS_VERSION > 5
+    return tinfo->inline_storage;
+#else
+    (void) tinfo;
+    return false;
+#endif
+}
+
+/// Returns where the value of type `tinfo` is stored inside `inst` if that type uses
+/// `py::inline_storage`, or nullptr otherwise.
+inline void *inline_value_ptr(instance *inst, const type_info *tinfo) {
+    if (!has_inline_storage(tinfo) || !inst->simple_layout) {
+        return nullptr;
+    }
+    return reinterpret_cast<char *>(inst) + inline_value_offset(tinfo->type_align);
+}
+
 struct value_and_holder {
     instance *inst = nullptr;
     size_t index = 0u;
@@ -471,12 +928,10 @@ PYBIND11_NOINLINE bool isinstance_generic(handle obj, const std::type_info &tp)
 }
 
 PYBIND11_NOINLINE handle get_object_handle(const void *ptr, const detail::type_info *type) {
-    auto &instances = get_internals().registered_instances;
-    auto range = instances.equal_range(ptr);
-    for (auto it = range.first; it != range.second; ++it) {
-        for (const auto &vh : values_and_holders(it->second)) {
+    for (auto &candidate : registered_instances_of(ptr)) {
+        for (const auto &vh : values_and_holders(reinterpret_cast<instance *>(candidate.ptr()))) {
             if (vh.type == type) {
-                return handle((PyObject *) it->second);
+                return candidate;
             }
         }
     }
@@ -503,6 +958,9 @@ public:
     explicit type_caster_generic(const type_info *typeinfo)
         : typeinfo(typeinfo), cpptype(typeinfo ? typeinfo->cpptype : nullptr) {}
 
+    type_caster_generic(const std::type_info &type_info, const detail::type_info *typeinfo)
+        : typeinfo(typeinfo), cpptype(&type_info) {}
+
     bool load(handle src, bool convert) { return load_impl<type_caster_generic>(src, convert); }
 
     PYBIND11_NOINLINE static handle cast(const void *_src,
@@ -511,7 +969,10 @@ public:
                                          const detail::type_info *tinfo,
                                          void *(*copy_constructor)(const void *),
                                          void *(*move_constructor)(const void *),
-                                         const void *existing_holder = nullptr) {
+                                         const void *existing_holder = nullptr,
+                                         void (*copy_construct_at)(void *, const void *) = nullptr,
+                                         void (*move_construct_at)(void *, const void *)
+                                         = nullptr) {
         if (!tinfo) { // no type info: error will be set already
             return handle();
         }
@@ -521,14 +982,18 @@ public:
             return none().release();
         }
 
-        if (handle registered_inst = find_registered_python_instance(src, tinfo)) {
-            return registered_inst;
+        if (uses_instance_registry(tinfo)) {
+            if (handle registered_inst = find_registered_python_instance(src, tinfo)) {
+                return registered_inst;
+            }
         }
 
         auto inst = reinterpret_steal<object>(make_new_instance(tinfo->type));
         auto *wrapper = reinterpret_cast<instance *>(inst.ptr());
         wrapper->owned = false;
         void *&valueptr = values_and_holders(wrapper).begin()->value_ptr();
+        // Copies and moves can go straight into the instance (see `py::inline_storage`)
+        void *storage = inline_value_ptr(wrapper, tinfo);
 
         switch (policy) {
             case return_value_policy::automatic:
@@ -544,7 +1009,10 @@ public:
                 break;
 
             case return_value_policy::copy:
-                if (copy_constructor) {
+                if (copy_construct_at && storage) {
+                    copy_construct_at(storage, src);
+                    valueptr = storage;
+                } else if (copy_constructor) {
                     valueptr = copy_constructor(src);
                 } else {
 #if defined(PYBIND11_DETAILED_ERROR_MESSAGES)
@@ -562,7 +1030,13 @@ public:
                 break;
 
             case return_value_policy::move:
-                if (move_constructor) {
+                if (move_construct_at && storage) {
+                    move_construct_at(storage, src);
+                    valueptr = storage;
+                } else if (copy_construct_at && storage) {
+                    copy_construct_at(storage, src);
+                    valueptr = storage;
+                } else if (move_constructor) {
                     valueptr = move_constructor(src);
                 } else if (copy_constructor) {
                     valueptr = copy_constructor(src);
@@ -620,6 +1094,23 @@ public:
         value = vptr;
     }
     bool try_implicit_casts(handle src, bool convert) {
+#if PYBIND11_INTERNALS_VERSION > 5
+        // Look for the target among the registered bases of the source type first, which casts
+        // the pointer directly instead of loading each derived type in turn
+        const auto &src_bases = all_type_info(Py_TYPE(src.ptr()));
+        if (src_bases.size() == 1) {
+            const auto &casts = src_bases.front()->base_casts;
+            for (size_t i = 0; i < casts.size(); ++i) {
+                if (casts[i].base == typeinfo) {
+                    type_caster_generic sub_caster(src_bases.front());
+                    sub_caster.load_value(
+                        reinterpret_cast<instance *>(src.ptr())->get_value_and_holder());
+                    value = cast_to_base(casts, i, sub_caster.value);
+                    return true;
+                }
+            }
+        }
+#endif
         for (const auto &cast : typeinfo->implicit_casts) {
             type_caster_generic sub_caster(*cast.first);
             if (sub_caster.load(src, convert)) {
@@ -650,17 +1141,25 @@ public:
     /// Try to load with foreign typeinfo, if available. Used when there is no
     /// native typeinfo, or when the native one wasn't able to produce a value.
     PYBIND11_NOINLINE bool try_load_foreign_module_local(handle src) {
-        constexpr auto *local_key = PYBIND11_MODULE_LOCAL_ID;
+        static interned_str local_key(PYBIND11_MODULE_LOCAL_ID);
         const auto pytype = type::handle_of(src);
-        if (!hasattr(pytype, local_key)) {
+        auto *srctype = (PyTypeObject *) pytype.ptr();
+        auto &misses = foreign_module_local_misses::get();
+        if (misses.contains(srctype, cpptype)) {
+            return false;
+        }
+        object local_capsule = getattr(pytype, local_key.get(), nullptr);
+        if (!local_capsule) {
+            misses.insert(srctype, cpptype);
             return false;
         }
 
-        type_info *foreign_typeinfo = reinterpret_borrow<capsule>(getattr(pytype, local_key));
+        type_info *foreign_typeinfo = reinterpret_borrow<capsule>(local_capsule);
         // Only consider this foreign loader if actually foreign and is a loader of the correct cpp
         // type
         if (foreign_typeinfo->module_local_load == &local_load
             || (cpptype && !same_type(*cpptype, *foreign_typeinfo->cpptype))) {
+            misses.insert(srctype, cpptype);
             return false;
         }
 
@@ -736,6 +1235,7 @@ public:
             for (const auto &converter : typeinfo->implicit_conversions) {
                 auto temp = reinterpret_steal<object>(converter(src.ptr(), typeinfo->type));
                 if (load_impl<ThisT>(temp, false)) {
+                    PYBIND11_TRACE(implicit_conversion, typeinfo->type->tp_name, src.ptr());
                     loader_life_support::add_patient(temp);
                     return true;
                 }
@@ -1066,7 +1566,7 @@ class type_caster_base : public type_caster_generic {
 public:
     static constexpr auto name = const_name<type>();
 
-    type_caster_base() : type_caster_base(typeid(type)) {}
+    type_caster_base() : type_caster_generic(typeid(type), get_type_info_cached<type>()) {}
     explicit type_caster_base(const std::type_info &info) : type_caster_generic(info) {}
 
     static handle cast(const itype &src, return_value_policy policy, handle parent) {
@@ -1074,13 +1574,35 @@ public:
             || policy == return_value_policy::automatic_reference) {
             policy = return_value_policy::copy;
         }
+        if (policy == return_value_policy::copy || policy == return_value_policy::move) {
+            if (handle value = cast_enum_value(src, std::is_enum<itype>())) {
+                return value;
+            }
+        }
         return cast(&src, policy, parent);
     }
 
     static handle cast(itype &&src, return_value_policy, handle parent) {
+        if (handle value = cast_enum_value(src, std::is_enum<itype>())) {
+            return value;
+        }
         return cast(&src, return_value_policy::move, parent);
     }
 
+    /// Returns a new reference to the object of a value of a `py::enum_` with `py::fast_enum()`,
+    /// or a null handle
+    static handle cast_enum_value(const itype &src, std::true_type) {
+        const auto *tinfo = get_type_info_cached<itype>();
+        auto *values = tinfo != nullptr ? get_enum_values(tinfo) : nullptr;
+        if (values == nullptr) {
+            return handle();
+        }
+        using underlying = typename std::underlying_type<itype>::type;
+        return handle(values->find(static_cast<std::uint64_t>(static_cast<underlying>(src))))
+            .inc_ref();
+    }
+    static handle cast_enum_value(const itype &, std::false_type) { return handle(); }
+
     // Returns a (pointer, type_info) pair taking care of necessary type lookup for a
     // polymorphic type (using RTTI by default, but can be overridden by specializing
     // polymorphic_type_hook). If the instance isn't derived, returns the base version.
@@ -1097,23 +1619,32 @@ public:
             // except via a user-provided specialization of polymorphic_type_hook,
             // and the user has promised that no this-pointer adjustment is
             // required in that case, so it's OK to use static_cast.
-            if (const auto *tpi = get_type_info(*instance_type)) {
+            if (const auto *tpi = get_derived_type_info_cached<itype>(*instance_type)) {
                 return {vsrc, tpi};
             }
         }
         // Otherwise we have either a nullptr, an `itype` pointer, or an unknown derived pointer,
         // so don't do a cast
+        if (const auto *tpi = get_type_info_cached<itype>()) {
+            return {src, tpi};
+        }
         return type_caster_generic::src_and_type(src, cast_type, instance_type);
     }
 
     static handle cast(const itype *src, return_value_policy policy, handle parent) {
         auto st = src_and_type(src);
+        // Values can only be constructed inside the instance if it is of this exact type
+        const bool exact_type
+            = st.second != nullptr && same_type(*st.second->cpptype, typeid(type));
         return type_caster_generic::cast(st.first,
                                          policy,
                                          parent,
                                          st.second,
                                          make_copy_constructor(src),
-                                         make_move_constructor(src));
+                                         make_move_constructor(src),
+                                         nullptr,
+                                         exact_type ? make_copy_constructor_at(src) : nullptr,
+                                         exact_type ? make_move_constructor_at(src) : nullptr);
     }
 
     static handle cast_holder(const itype *src, const void *holder) {
@@ -1162,6 +1693,28 @@ protected:
 
     static Constructor make_copy_constructor(...) { return nullptr; }
     static Constructor make_move_constructor(...) { return nullptr; }
+
+    using InplaceConstructor = void (*)(void *, const void *);
+
+    /* Variants of the above that construct the value at a given address. */
+    template <typename T, typename = enable_if_t<is_copy_constructible<T>::value>>
+    static auto make_copy_constructor_at(const T *)
+        -> decltype(new T(std::declval<const T>()), InplaceConstructor{}) {
+        return [](void *dst, const void *arg) {
+            ::new (dst) T(*reinterpret_cast<const T *>(arg));
+        };
+    }
+
+    template <typename T, typename = enable_if_t<is_move_constructible<T>::value>>
+    static auto make_move_constructor_at(const T *)
+        -> decltype(new T(std::declval<T &&>()), InplaceConstructor{}) {
+        return [](void *dst, const void *arg) {
+            ::new (dst) T(std::move(*const_cast<T *>(reinterpret_cast<const T *>(arg))));
+        };
+    }
+
+    static InplaceConstructor make_copy_constructor_at(...) { return nullptr; }
+    static InplaceConstructor make_move_constructor_at(...) { return nullptr; }
 };
 
 PYBIND11_NOINLINE std::string type_info_description(const std::type_info &ti) {
@@ -317,6 +317,9 @@ struct type_caster<Type, enable_if_t<is_eigen_dense_plain<Type>::value>> {
 
         // Allocate the new type, then build a numpy reference into it
         value = Type(fits.rows, fits.cols);
+        if (copy_without_gil(buf, fits)) {
+            return true;
+        }
         auto ref = reinterpret_steal<array>(eigen_ref_array<props>(value));
         if (dims == 1) {
             ref = ref.squeeze();
@@ -335,6 +338,26 @@ struct type_caster<Type, enable_if_t<is_eigen_dense_plain<Type>::value>> {
     }
 
 private:
+    // Copies a large array that already has the right dtype straight into `value`, with the GIL
+    // released; `buf` keeps the source data alive meanwhile.  Returns false if it cannot.
+    bool copy_without_gil(const array &buf, const EigenConformable<props::row_major> &fits) {
+        if (buf.nbytes() < PYBIND11_NUMPY_COPY_WITHOUT_GIL_THRESHOLD || fits.negativestrides
+            || !isinstance<array_t<Scalar>>(buf)
+            || !detail::check_flags(buf.ptr(), npy_api::NPY_ARRAY_ALIGNED_)) {
+            return false;
+        }
+        for (ssize_t i = 0; i < buf.ndim(); ++i) {
+            if (buf.strides(i) % static_cast<ssize_t>(sizeof(Scalar)) != 0) {
+                return false;
+            }
+        }
+        EigenDMap<const Type> src(
+            static_cast<const Scalar *>(buf.data()), fits.rows, fits.cols, fits.stride);
+        gil_scoped_release release;
+        value = src;
+        return true;
+    }
+
     // Cast implementation
     template <typename CType>
     static handle cast_impl(CType *src, return_value_policy policy, handle parent) {
@@ -640,8 +663,41 @@ public:
     using cast_op_type = Type;
 };
 
+// The SciPy class for sparse matrices stored like `Type`
 template <typename Type>
-struct type_caster<Type, enable_if_t<is_eigen_sparse<Type>::value>> {
+object scipy_sparse_matrix_type() {
+    return module_::import("scipy.sparse").attr(Type::IsRowMajor ? "csr_matrix" : "csc_matrix");
+}
+
+// Returns a SciPy matrix that views the compressed storage of `src` (which must be compressed)
+// with `base` as the base of its arrays, as `eigen_array_cast` does for dense types. SciPy keeps
+// arrays of the index types it supports as they are, so nothing is copied.
+template <typename Type>
+handle eigen_sparse_ref(const Type &src, handle base, bool writeable = true) {
+    array data(src.nonZeros(), src.valuePtr(), base);
+    if (!writeable) {
+        array_proxy(data.ptr())->flags &= ~detail::npy_api::NPY_ARRAY_WRITEABLE_;
+    }
+    array outerIndices(
+        (Type::IsRowMajor ? src.rows() : src.cols()) + 1, src.outerIndexPtr(), base);
+    array innerIndices(src.nonZeros(), src.innerIndexPtr(), base);
+    return scipy_sparse_matrix_type<Type>()(
+               pybind11::make_tuple(
+                   std::move(data), std::move(innerIndices), std::move(outerIndices)),
+               pybind11::make_tuple(src.rows(), src.cols()))
+        .release();
+}
+
+template <typename T>
+struct is_eigen_sparse_map : std::false_type {};
+template <typename MatrixType, int Options, typename StrideType>
+struct is_eigen_sparse_map<Eigen::Map<MatrixType, Options, StrideType>>
+    : is_eigen_sparse<MatrixType> {};
+
+template <typename Type>
+struct type_caster<
+    Type,
+    enable_if_t<is_eigen_sparse<Type>::value && !is_eigen_sparse_map<Type>::value>> {
     using Scalar = typename Type::Scalar;
     static_assert(!std::is_pointer<Scalar>::value,
                   PYBIND11_EIGEN_MESSAGE_POINTER_TYPES_ARE_NOT_SUPPORTED);
@@ -655,8 +711,7 @@ struct type_caster<Type, enable_if_t<is_eigen_sparse<Type>::value>> {
         }
 
         auto obj = reinterpret_borrow<object>(src);
-        object sparse_module = module_::import("scipy.sparse");
-        object matrix_type = sparse_module.attr(rowMajor ? "csr_matrix" : "csc_matrix");
+        object matrix_type = scipy_sparse_matrix_type<Type>();
 
         if (!type::handle_of(obj).is(matrix_type)) {
             try {
@@ -688,20 +743,57 @@ struct type_caster<Type, enable_if_t<is_eigen_sparse<Type>::value>> {
         return true;
     }
 
-    static handle cast(const Type &src, return_value_policy /* policy */, handle /* parent */) {
-        const_cast<Type &>(src).makeCompressed();
-
-        object matrix_type
-            = module_::import("scipy.sparse").attr(rowMajor ? "csr_matrix" : "csc_matrix");
-
-        array data(src.nonZeros(), src.valuePtr());
-        array outerIndices((rowMajor ? src.rows() : src.cols()) + 1, src.outerIndexPtr());
-        array innerIndices(src.nonZeros(), src.innerIndexPtr());
+private:
+    // As for dense types, values that are moved or owned by the caller are taken over and
+    // references are viewed; only copies (including the default for lvalues) copy the data
+    template <typename CType>
+    static handle cast_impl(CType *src, return_value_policy policy, handle parent) {
+        switch (policy) {
+            case return_value_policy::take_ownership:
+            case return_value_policy::automatic:
+            case return_value_policy::move: {
+                std::unique_ptr<Type> owned(new Type(std::move(*src)));
+                owned->makeCompressed();
+                const Type &ref = *owned;
+                return eigen_sparse_ref(ref, owning_capsule(std::move(owned)));
+            }
+            case return_value_policy::copy: {
+                const_cast<Type &>(*src).makeCompressed();
+                // Arrays without a base copy the data
+                return eigen_sparse_ref(*src, handle());
+            }
+            case return_value_policy::reference:
+            case return_value_policy::automatic_reference:
+                const_cast<Type &>(*src).makeCompressed();
+                return eigen_sparse_ref(*src, none(), !std::is_const<CType>::value);
+            case return_value_policy::reference_internal:
+                const_cast<Type &>(*src).makeCompressed();
+                return eigen_sparse_ref(*src, parent, !std::is_const<CType>::value);
+            default:
+                throw cast_error("unhandled return_value_policy: should not happen!");
+        }
+    }
 
-        return matrix_type(pybind11::make_tuple(
-                               std::move(data), std::move(innerIndices), std::move(outerIndices)),
-                           pybind11::make_tuple(src.rows(), src.cols()))
-            .release();
+public:
+    // Returned values are moved into the SciPy matrix
+    static handle cast(Type &&src, return_value_policy /* policy */, handle parent) {
+        return cast_impl(&src, return_value_policy::move, parent);
+    }
+    // lvalue reference return; default (automatic) becomes copy
+    static handle cast(Type &src, return_value_policy policy, handle parent) {
+        if (policy == return_value_policy::automatic
+            || policy == return_value_policy::automatic_reference) {
+            policy = return_value_policy::copy;
+        }
+        return cast_impl(&src, policy, parent);
+    }
+    // const lvalue reference return; views are not writeable
+    static handle cast(const Type &src, return_value_policy policy, handle parent) {
+        if (policy == return_value_policy::automatic
+            || policy == return_value_policy::automatic_reference) {
+            policy = return_value_policy::copy;
+        }
+        return cast_impl(&src, policy, parent);
     }
 
     PYBIND11_TYPE_CASTER(Type,
@@ -710,5 +802,102 @@ struct type_caster<Type, enable_if_t<is_eigen_sparse<Type>::value>> {
                              + npy_format_descriptor<Scalar>::name + const_name("]"));
 };
 
+// Type caster for `Eigen::Map` of sparse matrices: a view of the arrays of a SciPy matrix with the
+// same storage order. Maps of non-const matrices only accept arrays with the exact scalar and
+// index types, as writes must reach them; maps of const matrices convert when allowed to.
+template <typename Type>
+struct type_caster<Type, enable_if_t<is_eigen_sparse_map<Type>::value>> {
+    using Scalar = typename Type::Scalar;
+    static_assert(!std::is_pointer<Scalar>::value,
+                  PYBIND11_EIGEN_MESSAGE_POINTER_TYPES_ARE_NOT_SUPPORTED);
+    using StorageIndex = typename Type::StorageIndex;
+    using Index = typename Type::Index;
+    static constexpr bool rowMajor = Type::IsRowMajor;
+    static constexpr bool writeable
+        = !std::is_const<remove_reference_t<decltype(*std::declval<Type>().valuePtr())>>::value;
+
+    bool load(handle src, bool convert) {
+        if (!src) {
+            return false;
+        }
+        auto obj = reinterpret_borrow<object>(src);
+        object matrix_type = scipy_sparse_matrix_type<Type>();
+        if (!type::handle_of(obj).is(matrix_type)) {
+            if (!convert || writeable) {
+                return false;
+            }
+            try {
+                obj = matrix_type(obj);
+            } catch (const error_already_set &) {
+                return false;
+            }
+        }
+
+        object values = obj.attr("data");
+        object innerIndices = obj.attr("indices");
+        object outerIndices = obj.attr("indptr");
+        if (!convert || writeable) {
+            if (!array_t<Scalar, array::c_style>::check_(values)
+                || !array_t<StorageIndex, array::c_style>::check_(innerIndices)
+                || !array_t<StorageIndex, array::c_style>::check_(outerIndices)) {
+                return false;
+            }
+            if (writeable && !reinterpret_borrow<array>(values).writeable()) {
+                return false;
+            }
+        }
+        m_values = array_t<Scalar, array::forcecast | array::c_style>::ensure(values);
+        m_inner = array_t<StorageIndex, array::forcecast | array::c_style>::ensure(innerIndices);
+        m_outer = array_t<StorageIndex, array::forcecast | array::c_style>::ensure(outerIndices);
+        if (!m_values || !m_inner || !m_outer) {
+            return false;
+        }
+        auto shape = pybind11::tuple((pybind11::object) obj.attr("shape"));
+        m_map.reset(new Type(shape[0].cast<Index>(),
+                             shape[1].cast<Index>(),
+                             obj.attr("nnz").cast<Index>(),
+                             m_outer.mutable_data(),
+                             m_inner.mutable_data(),
+                             m_values.mutable_data()));
+        return true;
+    }
+
+    // As for dense maps, the SciPy matrix views the data that the map points to (which must stay
+    // around, e.g. with an appropriate keep_alive), unless a copy is asked for
+    static handle cast(const Type &src, return_value_policy policy, handle parent) {
+        switch (policy) {
+            case return_value_policy::copy:
+                return eigen_sparse_ref(src, handle());
+            case return_value_policy::reference_internal:
+                return eigen_sparse_ref(src, parent, writeable);
+            case return_value_policy::reference:
+            case return_value_policy::automatic:
+            case return_value_policy::automatic_reference:
+                return eigen_sparse_ref(src, none(), writeable);
+            default:
+                // move, take_ownership don't make any sense for a map:
+                pybind11_fail("Invalid return_value_policy for Eigen Map of a sparse matrix");
+        }
+    }
+
+    static constexpr auto name
+        = const_name<(Type::IsRowMajor) != 0>("scipy.sparse.csr_matrix[",
+                                               "scipy.sparse.csc_matrix[")
+          + npy_format_descriptor<Scalar>::name + const_name("]");
+
+    // NOLINTNEXTLINE(google-explicit-constructor)
+    operator Type *() { return m_map.get(); }
+    // NOLINTNEXTLINE(google-explicit-constructor)
+    operator Type &() { return *m_map; }
+    template <typename T_>
+    using cast_op_type = pybind11::detail::cast_op_type<T_>;
+
+private:
+    array_t<Scalar, array::forcecast | array::c_style> m_values;
+    array_t<StorageIndex, array::forcecast | array::c_style> m_inner;
+    array_t<StorageIndex, array::forcecast | array::c_style> m_outer;
+    std::unique_ptr<Type> m_map;
+};
+
 PYBIND11_NAMESPACE_END(detail)
 PYBIND11_NAMESPACE_END(PYBIND11_NAMESPACE)
@@ -227,7 +227,9 @@ struct type_caster<Type, typename eigen_tensor_helper<Type>::ValidType> {
             || policy == return_value_policy::reference_internal) {
             pybind11_fail("Cannot use a reference return value policy for an rvalue");
         }
-        return cast_impl(&src, return_value_policy::move, parent);
+        // A const rvalue cannot be moved from: copy it once onto the heap and hand that copy
+        // to the capsule, rather than copying it again into a freshly allocated array.
+        return cast_impl(Helper::alloc(src), return_value_policy::take_ownership, parent);
     }
 
     static handle cast(Type &src, return_value_policy policy, handle parent) {
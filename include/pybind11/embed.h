@@ -12,7 +12,11 @@
 #include "pybind11.h"
 #include "eval.h"
 
+#include <chrono>
+#include <cstring>
 #include <memory>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 #if defined(PYPY_VERSION)
@@ -28,6 +32,7 @@
     defined in global scope. The first macro parameter is the name of the
     module (without quotes). The second parameter is the variable which will
     be used as the interface to add functions and classes to the module.
+    Further arguments are module options, as for `PYBIND11_MODULE`.
 
     .. code-block:: cpp
 
@@ -38,23 +43,46 @@
             });
         }
  \endrst */
-#define PYBIND11_EMBEDDED_MODULE(name, variable)                                                  \
+#define PYBIND11_EMBEDDED_MODULE(name, variable, ...)                                             \
     static ::pybind11::module_::module_def PYBIND11_CONCAT(pybind11_module_def_, name);           \
+    static ::pybind11::module_::module_slots PYBIND11_CONCAT(pybind11_module_slots_, name);       \
     static void PYBIND11_CONCAT(pybind11_init_, name)(::pybind11::module_ &);                     \
+    static int PYBIND11_CONCAT(pybind11_exec_, name)(PyObject * pm) {                             \
+        return ::pybind11::detail::exec_module(pm, &PYBIND11_CONCAT(pybind11_init_, name));       \
+    }                                                                                             \
     static PyObject PYBIND11_CONCAT(*pybind11_init_wrapper_, name)() {                            \
-        auto m = ::pybind11::module_::create_extension_module(                                    \
-            PYBIND11_TOSTRING(name), nullptr, &PYBIND11_CONCAT(pybind11_module_def_, name));      \
-        try {                                                                                     \
-            PYBIND11_CONCAT(pybind11_init_, name)(m);                                             \
-            return m.ptr();                                                                       \
-        }                                                                                         \
-        PYBIND11_CATCH_INIT_EXCEPTIONS                                                            \
+        ::pybind11::detail::note_current_interpreter();                                           \
+        return ::pybind11::detail::initialize_module_def(                                         \
+            PYBIND11_TOSTRING(name),                                                              \
+            &PYBIND11_CONCAT(pybind11_module_def_, name),                                         \
+            PYBIND11_CONCAT(pybind11_module_slots_, name),                                        \
+            &PYBIND11_CONCAT(pybind11_init_, name),                                               \
+            &PYBIND11_CONCAT(pybind11_exec_, name),                                               \
+            ##__VA_ARGS__);                                                                       \
     }                                                                                             \
     PYBIND11_EMBEDDED_MODULE_IMPL(name)                                                           \
     ::pybind11::detail::embedded_module PYBIND11_CONCAT(pybind11_module_, name)(                  \
         PYBIND11_TOSTRING(name), PYBIND11_CONCAT(pybind11_init_impl_, name));                     \
-    void PYBIND11_CONCAT(pybind11_init_, name)(::pybind11::module_                                \
-                                               & variable) // NOLINT(bugprone-macro-parentheses)
+    void PYBIND11_CONCAT(pybind11_init_, name)(                                                   \
+        ::pybind11::module_ & variable) // NOLINT(bugprone-macro-parentheses)
+
+/** \rst
+    Add a pure Python module, whose source code is compiled into the program, to the modules that
+    the interpreter can import. Must be defined in global scope, before the interpreter is
+    initialized. The first macro parameter is the name of the module (without quotes), the second
+    one its source code. Packages, and modules with dotted names, are added with
+    `add_embedded_python_module`.
+
+    .. code-block:: cpp
+
+        PYBIND11_EMBEDDED_PYTHON_MODULE(helpers, R"(
+        def greet(name):
+            return "Hello, " + name
+        )");
+ \endrst */
+#define PYBIND11_EMBEDDED_PYTHON_MODULE(name, source)                                             \
+    static ::pybind11::detail::embedded_python_module PYBIND11_CONCAT(                            \
+        pybind11_python_module_, name)(PYBIND11_TOSTRING(name), source)
 
 PYBIND11_NAMESPACE_BEGIN(PYBIND11_NAMESPACE)
 PYBIND11_NAMESPACE_BEGIN(detail)
@@ -74,6 +102,73 @@ struct embedded_module {
     }
 };
 
+struct embedded_python_source {
+    std::string source;
+    bool is_package;
+};
+
+/// The pure Python modules added with `PYBIND11_EMBEDDED_PYTHON_MODULE`, by module name
+inline std::unordered_map<std::string, embedded_python_source> &embedded_python_sources() {
+    static std::unordered_map<std::string, embedded_python_source> sources;
+    return sources;
+}
+
+inline void add_embedded_python_source(const char *name, const char *source, bool is_package) {
+    if (Py_IsInitialized() != 0) {
+        pybind11_fail("Can't add new modules after the interpreter has been initialized");
+    }
+    embedded_python_sources()[name] = embedded_python_source{source, is_package};
+}
+
+struct embedded_python_module {
+    embedded_python_module(const char *name, const char *source) {
+        add_embedded_python_source(name, source, false);
+    }
+};
+
+/// Puts an importer of the embedded pure Python modules at the front of `sys.meta_path`. Like the
+/// importers of builtin and frozen modules, it is a class which is both finder and loader. It is
+/// written in Python, so that the startup does not need the pybind11 internals, and nothing is
+/// done if there are no such modules.
+inline void install_embedded_python_importer() {
+    const auto &sources = embedded_python_sources();
+    if (sources.empty()) {
+        return;
+    }
+    dict scope;
+    dict python_sources;
+    for (const auto &entry : sources) {
+        python_sources[pybind11::str(entry.first)]
+            = pybind11::make_tuple(entry.second.source, entry.second.is_package);
+    }
+    scope["__builtins__"] = PyEval_GetBuiltins();
+    scope["sources"] = python_sources;
+    exec(R"(
+        import sys
+        from importlib.machinery import ModuleSpec
+
+        class pybind11_embedded_importer:
+            @classmethod
+            def find_spec(cls, fullname, path=None, target=None):
+                if fullname not in sources:
+                    return None
+                return ModuleSpec(fullname, cls, origin="<embedded " + fullname + ">",
+                                  is_package=sources[fullname][1])
+
+            @staticmethod
+            def create_module(spec):
+                return None
+
+            @staticmethod
+            def exec_module(module):
+                spec = module.__spec__
+                exec(compile(sources[spec.name][0], spec.origin, "exec"), module.__dict__)
+
+        sys.meta_path.insert(0, pybind11_embedded_importer)
+        )",
+         scope);
+}
+
 struct wide_char_arg_deleter {
     void operator()(wchar_t *ptr) const {
         // API docs: https://docs.python.org/3/c-api/sys.html#c.Py_DecodeLocale
@@ -138,13 +233,49 @@ inline void initialize_interpreter_pre_pyconfig(bool init_signal_handlers,
 }
 #endif
 
+#if PY_VERSION_HEX >= PYBIND11_PYCONFIG_SUPPORT_PY_VERSION_HEX
 PYBIND11_NAMESPACE_END(detail)
 
-#if PY_VERSION_HEX >= PYBIND11_PYCONFIG_SUPPORT_PY_VERSION_HEX
-inline void initialize_interpreter(PyConfig *config,
-                                   int argc = 0,
-                                   const char *const *argv = nullptr,
-                                   bool add_program_dir_to_path = true) {
+/// The time spent in each phase of `initialize_interpreter`
+struct startup_timings {
+    /// Filling in the `PyConfig`, including ``sys.argv``
+    std::chrono::nanoseconds configuration{0};
+    /// `Py_InitializeFromConfig`, which imports ``site`` unless it is skipped
+    std::chrono::nanoseconds interpreter{0};
+    /// Adding the program directory to ``sys.path``, and the embedded Python modules
+    std::chrono::nanoseconds path{0};
+    /// Importing `interpreter_options::preload_modules`
+    std::chrono::nanoseconds preload{0};
+
+    std::chrono::nanoseconds total() const { return configuration + interpreter + path + preload; }
+};
+
+PYBIND11_NAMESPACE_BEGIN(detail)
+
+class startup_phase_timer {
+public:
+    explicit startup_phase_timer(startup_timings *target) : timings(target) {}
+
+    /// Sets `phase` to the time since the previous call (or the construction)
+    void end(std::chrono::nanoseconds startup_timings::*phase) {
+        auto now = std::chrono::steady_clock::now();
+        if (timings != nullptr) {
+            timings->*phase
+                = std::chrono::duration_cast<std::chrono::nanoseconds>(now - phase_start);
+        }
+        phase_start = now;
+    }
+
+private:
+    startup_timings *timings;
+    std::chrono::steady_clock::time_point phase_start = std::chrono::steady_clock::now();
+};
+
+inline void initialize_interpreter_from_config(PyConfig *config,
+                                               int argc,
+                                               const char *const *argv,
+                                               bool add_program_dir_to_path,
+                                               startup_phase_timer &timer) {
     detail::precheck_interpreter();
     PyStatus status = PyConfig_SetBytesArgv(config, argc, const_cast<char *const *>(argv));
     if (PyStatus_Exception(status) != 0) {
@@ -154,12 +285,14 @@ inline void initialize_interpreter(PyConfig *config,
         throw std::runtime_error(PyStatus_IsError(status) != 0 ? status.err_msg
                                                                : "Failed to prepare CPython");
     }
+    timer.end(&startup_timings::configuration);
     status = Py_InitializeFromConfig(config);
     if (PyStatus_Exception(status) != 0) {
         PyConfig_Clear(config);
         throw std::runtime_error(PyStatus_IsError(status) != 0 ? status.err_msg
                                                                : "Failed to init CPython");
     }
+    timer.end(&startup_timings::interpreter);
     if (add_program_dir_to_path) {
         PyRun_SimpleString("import sys, os.path; "
                            "sys.path.insert(0, "
@@ -167,6 +300,84 @@ inline void initialize_interpreter(PyConfig *config,
                            "if sys.argv and os.path.exists(sys.argv[0]) else '')");
     }
     PyConfig_Clear(config);
+    install_embedded_python_importer();
+    timer.end(&startup_timings::path);
+}
+#endif
+
+PYBIND11_NAMESPACE_END(detail)
+
+/** \rst
+    Add a pure Python module, whose source code is compiled into the program, to the modules that
+    the interpreter can import. This must be done before the interpreter is initialized. A package
+    (``is_package``) can have embedded submodules, whose names start with its name and a dot.
+    The source code is compiled on the first import, with ``<embedded name>`` as its file name.
+ \endrst */
+inline void
+add_embedded_python_module(const char *name, const char *source, bool is_package = false) {
+    detail::add_embedded_python_source(name, source, is_package);
+}
+
+#if PY_VERSION_HEX >= PYBIND11_PYCONFIG_SUPPORT_PY_VERSION_HEX
+inline void initialize_interpreter(PyConfig *config,
+                                   int argc = 0,
+                                   const char *const *argv = nullptr,
+                                   bool add_program_dir_to_path = true) {
+    detail::startup_phase_timer timer(nullptr);
+    detail::initialize_interpreter_from_config(
+        config, argc, argv, add_program_dir_to_path, timer);
+}
+
+/// Options of `initialize_interpreter` for programs which need a fast startup
+struct interpreter_options {
+    /// Start from `PyConfig_InitIsolatedConfig`, which ignores the environment variables, the
+    /// user site directory and the current directory, instead of `PyConfig_InitPythonConfig`
+    bool isolated = false;
+    /// Import ``site`` during startup, which adds the site-packages directories to ``sys.path``
+    /// and processes their ``.pth`` files. This is often the largest part of the startup time.
+    bool import_site = true;
+    bool init_signal_handlers = true;
+    int argc = 0;
+    const char *const *argv = nullptr;
+    bool add_program_dir_to_path = true;
+    /// Modules imported right after the startup, e.g. `PYBIND11_EMBEDDED_MODULE` modules which
+    /// the program uses anyway
+    std::vector<std::string> preload_modules;
+    /// If not null, receives the time spent in each phase of the startup
+    startup_timings *timings = nullptr;
+};
+
+/** \rst
+    Initialize the Python interpreter with `interpreter_options`:
+
+    .. code-block:: cpp
+
+        py::startup_timings timings;
+        py::interpreter_options options;
+        options.isolated = true;
+        options.import_site = false;
+        options.preload_modules = {"fast_calc"};
+        options.timings = &timings;
+        py::initialize_interpreter(options);
+ \endrst */
+inline void initialize_interpreter(const interpreter_options &options) {
+    detail::startup_phase_timer timer(options.timings);
+    PyConfig config;
+    if (options.isolated) {
+        PyConfig_InitIsolatedConfig(&config);
+    } else {
+        PyConfig_InitPythonConfig(&config);
+        // See PR #4473 for background
+        config.parse_argv = 0;
+    }
+    config.site_import = options.import_site ? 1 : 0;
+    config.install_signal_handlers = options.init_signal_handlers ? 1 : 0;
+    detail::initialize_interpreter_from_config(
+        &config, options.argc, options.argv, options.add_program_dir_to_path, timer);
+    for (const auto &name : options.preload_modules) {
+        module_::import(name.c_str());
+    }
+    timer.end(&startup_timings::preload);
 }
 #endif
 
@@ -196,6 +407,7 @@ inline void initialize_interpreter(bool init_signal_handlers = true,
 #if PY_VERSION_HEX < PYBIND11_PYCONFIG_SUPPORT_PY_VERSION_HEX
     detail::initialize_interpreter_pre_pyconfig(
         init_signal_handlers, argc, argv, add_program_dir_to_path);
+    detail::install_embedded_python_importer();
 #else
     PyConfig config;
     PyConfig_InitPythonConfig(&config);
@@ -254,8 +466,11 @@ inline void finalize_interpreter() {
     }
     // Local internals contains data managed by the current interpreter, so we must clear them to
     // avoid undefined behaviors when initializing another interpreter
+    detail::interned_str_cache::clear();
     detail::get_local_internals().registered_types_cpp.clear();
     detail::get_local_internals().registered_exception_translators.clear();
+    detail::get_local_internals().native_member_type = nullptr;
+    detail::get_local_internals().native_static_member_type = nullptr;
 
     Py_Finalize();
 
@@ -296,6 +511,10 @@ public:
                                 bool add_program_dir_to_path = true) {
         initialize_interpreter(config, argc, argv, add_program_dir_to_path);
     }
+
+    explicit scoped_interpreter(const interpreter_options &options) {
+        initialize_interpreter(options);
+    }
 #endif
 
     scoped_interpreter(const scoped_interpreter &) = delete;
@@ -313,4 +532,145 @@ private:
     bool is_valid = true;
 };
 
+#if defined(PYBIND11_HAS_SUBINTERPRETER_SUPPORT)
+/** \rst
+    A subinterpreter, which is ended when this is destroyed. By default it has a GIL of its
+    own (PEP 684), so that threads running in it do not wait for those of other interpreters:
+    several subinterpreters can run Python code on several cores at once. Each of them gets
+    internals of its own, and imports modules anew; only modules declared with
+    `py::multiple_interpreters::per_interpreter_gil()` can be imported there.
+
+    Threads run code in the subinterpreter within a `subinterpreter_scoped_activate`:
+
+    .. code-block:: cpp
+
+        py::scoped_interpreter guard{};
+        auto sub = py::subinterpreter::create();
+        std::thread worker([&sub] {
+            py::subinterpreter_scoped_activate activate(sub);
+            py::exec("import example; example.run()");
+        });
+        {
+            py::gil_scoped_release release;
+            worker.join();
+        }
+ \endrst */
+class subinterpreter {
+public:
+    /// Creates a subinterpreter with a GIL of its own, and isolated from the main interpreter as
+    /// much as `PyInterpreterConfig` allows. The calling thread must hold the GIL of another
+    /// interpreter, which it still holds afterwards.
+    static subinterpreter create() {
+        PyInterpreterConfig config;
+        std::memset(&config, 0, sizeof(config));
+        config.use_main_obmalloc = 0;
+        config.allow_fork = 0;
+        config.allow_exec = 0;
+        config.allow_threads = 1;
+        config.allow_daemon_threads = 0;
+        config.check_multi_interp_extensions = 1;
+        config.gil = PyInterpreterConfig_OWN_GIL;
+        return create(config);
+    }
+
+    /// Creates a subinterpreter with the given configuration
+    static subinterpreter create(const PyInterpreterConfig &config) {
+        PyThreadState *previous = PyThreadState_Get();
+        PyThreadState *tstate = nullptr;
+        PyStatus status = Py_NewInterpreterFromConfig(&tstate, &config);
+        if (PyStatus_Exception(status) != 0 || tstate == nullptr) {
+            // The previous thread state is current again
+            pybind11_fail(std::string("subinterpreter::create(): ")
+                          + (status.err_msg != nullptr ? status.err_msg : "failed"));
+        }
+        detail::note_current_interpreter();
+        detail::initialize_subinterpreter_internals();
+        // Threads get thread states of their own when they activate the subinterpreter. This one
+        // is only deleted with the interpreter: Python 3.12 cannot reuse its memory for another.
+        PyEval_SaveThread();
+        PyEval_RestoreThread(previous);
+        return subinterpreter(tstate);
+    }
+
+    subinterpreter(const subinterpreter &) = delete;
+    subinterpreter(subinterpreter &&other) noexcept
+        : interp(other.interp), creation_tstate(other.creation_tstate) {
+        other.interp = nullptr;
+        other.creation_tstate = nullptr;
+    }
+    subinterpreter &operator=(const subinterpreter &) = delete;
+    subinterpreter &operator=(subinterpreter &&) = delete;
+
+    /// Ends the subinterpreter, which no thread may have activated anymore. The calling thread
+    /// may hold the GIL of another interpreter.
+    ~subinterpreter() {
+        if (interp == nullptr) {
+            return;
+        }
+        PyThreadState *previous = detail::get_thread_state_unchecked();
+        if (previous != nullptr) {
+            PyEval_SaveThread();
+        }
+        PyThreadState *tstate = PyThreadState_New(interp);
+        PyEval_RestoreThread(tstate);
+        PyThreadState_Clear(creation_tstate);
+        PyThreadState_Delete(creation_tstate);
+        // As in `finalize_interpreter()`, the internals are destroyed after the interpreter
+        detail::internals **internals_pp = detail::get_internals_pp();
+        Py_EndInterpreter(tstate);
+        if (internals_pp != nullptr && internals_pp != detail::get_main_internals_pp()) {
+            delete *internals_pp;
+            *internals_pp = nullptr;
+        }
+        if (previous != nullptr) {
+            PyEval_RestoreThread(previous);
+        }
+    }
+
+    PyInterpreterState *interpreter_state() const { return interp; }
+
+    /// The ID of the subinterpreter, as in Python's `interpreters` module
+    int64_t id() const { return PyInterpreterState_GetID(interp); }
+
+private:
+    explicit subinterpreter(PyThreadState *tstate)
+        : interp(PyThreadState_GetInterpreter(tstate)), creation_tstate(tstate) {}
+
+    PyInterpreterState *interp;
+    PyThreadState *creation_tstate;
+};
+
+/** \rst
+    Makes a `subinterpreter` the current interpreter of the calling thread, which holds its GIL
+    until the end of the scope. Then the previous thread state of the thread, and its GIL, are
+    restored.
+ \endrst */
+class subinterpreter_scoped_activate {
+public:
+    explicit subinterpreter_scoped_activate(const subinterpreter &sub)
+        : previous(detail::get_thread_state_unchecked()) {
+        if (previous != nullptr) {
+            PyEval_SaveThread();
+        }
+        tstate = PyThreadState_New(sub.interpreter_state());
+        PyEval_RestoreThread(tstate);
+    }
+
+    subinterpreter_scoped_activate(const subinterpreter_scoped_activate &) = delete;
+    subinterpreter_scoped_activate &operator=(const subinterpreter_scoped_activate &) = delete;
+
+    ~subinterpreter_scoped_activate() {
+        PyThreadState_Clear(tstate);
+        PyThreadState_DeleteCurrent();
+        if (previous != nullptr) {
+            PyEval_RestoreThread(previous);
+        }
+    }
+
+private:
+    PyThreadState *previous;
+    PyThreadState *tstate;
+};
+#endif
+
 PYBIND11_NAMESPACE_END(PYBIND11_NAMESPACE)
@@ -13,22 +13,20 @@
 
 #include "pybind11.h"
 
+#include <string>
+#include <type_traits>
 #include <utility>
 
 PYBIND11_NAMESPACE_BEGIN(PYBIND11_NAMESPACE)
 PYBIND11_NAMESPACE_BEGIN(detail)
 
 inline void ensure_builtins_in_globals(object &global) {
-#if defined(PYPY_VERSION) || PY_VERSION_HEX < 0x03080000
     // Running exec and eval adds `builtins` module under `__builtins__` key to
     // globals if not yet present.  Python 3.8 made PyRun_String behave
-    // similarly. Let's also do that for older versions, for consistency. This
-    // was missing from PyPy3.8 7.3.7.
-    if (!global.contains("__builtins__"))
+    // similarly, but PyEval_EvalCode (which runs the compiled code) does not.
+    if (!global.contains("__builtins__")) {
         global["__builtins__"] = module_::import(PYBIND11_BUILTINS_MODULE);
-#else
-    (void) global;
-#endif
+    }
 }
 
 PYBIND11_NAMESPACE_END(detail)
@@ -44,45 +42,126 @@ enum eval_mode {
     eval_statements
 };
 
-template <eval_mode mode = eval_expr>
-object eval(const str &expr, object global = globals(), object local = object()) {
-    if (!local) {
-        local = global;
-    }
-
-    detail::ensure_builtins_in_globals(global);
+/// Python code compiled by `compile()`, which `eval()` runs without parsing the source again
+class compiled_code : public object {
+public:
+    PYBIND11_OBJECT_DEFAULT(compiled_code, object, PyCode_Check)
+};
 
-    /* PyRun_String does not accept a PyObject / encoding specifier,
-       this seems to be the only alternative */
-    std::string buffer = "# -*- coding: utf-8 -*-\n" + (std::string) expr;
+PYBIND11_NAMESPACE_BEGIN(detail)
 
-    int start = 0;
+inline int eval_start_token(eval_mode mode) {
     switch (mode) {
         case eval_expr:
-            start = Py_eval_input;
-            break;
+            return Py_eval_input;
         case eval_single_statement:
-            start = Py_single_input;
-            break;
+            return Py_single_input;
         case eval_statements:
-            start = Py_file_input;
-            break;
+            return Py_file_input;
         default:
             pybind11_fail("invalid evaluation mode");
     }
+}
+
+inline compiled_code compile_source(const str &source, int start, const char *filename) {
+    /* Py_CompileString does not accept a PyObject / encoding specifier,
+       this seems to be the only alternative */
+    std::string buffer = "# -*- coding: utf-8 -*-\n" + (std::string) source;
+    PyObject *code = Py_CompileString(buffer.c_str(), filename, start);
+    if (!code) {
+        throw error_already_set();
+    }
+    return reinterpret_steal<compiled_code>(code);
+}
+
+/// The code objects that `eval()` and `exec()` compiled, by source and mode: the same strings
+/// are often evaluated many times. Kept in the state dict of the interpreter, since code
+/// objects belong to it, and cleared when it holds `max_size` entries.
+struct eval_cache {
+    static constexpr size_t max_size = 1024;
+
+    static dict get(const char *name) {
+        dict state_dict = get_python_state_dict();
+        if (!state_dict.contains(name)) {
+            state_dict[name] = dict();
+        }
+        return state_dict[name];
+    }
+
+    static void add(dict &cache, const object &key, const object &value) {
+        if (cache.size() >= max_size) {
+            cache.clear();
+        }
+        cache[key] = value;
+    }
+};
+
+/// Compiles `source` as `<string>`, removing its common leading whitespace first if `dedent`,
+/// or returns the code compiled from it before
+inline compiled_code compile_cached(const str &source, eval_mode mode, bool dedent) {
+    dict cache = eval_cache::get("__pybind11_eval_cache__");
+    auto key = make_tuple(source, static_cast<int>(mode), dedent);
+    PyObject *code = dict_getitem(cache.ptr(), key.ptr());
+    if (code != nullptr) {
+        return reinterpret_borrow<compiled_code>(code);
+    }
+    auto result = compile_source(
+        dedent ? str(module_::import("textwrap").attr("dedent")(source)) : source,
+        eval_start_token(mode),
+        "<string>");
+    eval_cache::add(cache, key, result);
+    return result;
+}
+
+PYBIND11_NAMESPACE_END(detail)
+
+/** \rst
+    Compiles a string of Python code, to run it with ``eval()`` as many times as needed. The
+    ``mode`` applies to every evaluation of the code; ``filename`` appears in tracebacks.
+\endrst */
+template <eval_mode mode = eval_expr>
+compiled_code compile(const str &source, const char *filename = "<string>") {
+    return detail::compile_source(source, detail::eval_start_token(mode), filename);
+}
+
+template <eval_mode mode = eval_expr, size_t N>
+compiled_code compile(const char (&s)[N], const char *filename = "<string>") {
+    /* Support raw string literals by removing common leading whitespace */
+    auto source = (s[0] == '\n') ? str(module_::import("textwrap").attr("dedent")(s)) : str(s);
+    return compile<mode>(source, filename);
+}
+
+/// Runs code from `compile()`. Its mode is the one it was compiled with.
+template <eval_mode mode = eval_expr,
+          typename Code,
+          detail::enable_if_t<std::is_same<Code, compiled_code>::value, int> = 0>
+object eval(const Code &code, object global = globals(), object local = object()) {
+    if (!local) {
+        local = global;
+    }
 
-    PyObject *result = PyRun_String(buffer.c_str(), start, global.ptr(), local.ptr());
+    detail::ensure_builtins_in_globals(global);
+
+    PyObject *result = PyEval_EvalCode(code.ptr(), global.ptr(), local.ptr());
     if (!result) {
         throw error_already_set();
     }
     return reinterpret_steal<object>(result);
 }
 
+/// Evaluates a string. The code compiled from it is cached, so that evaluating the same string
+/// again does not parse it again.
+template <eval_mode mode = eval_expr>
+object eval(const str &expr, object global = globals(), object local = object()) {
+    return eval(detail::compile_cached(expr, mode, false), std::move(global), std::move(local));
+}
+
 template <eval_mode mode = eval_expr, size_t N>
 object eval(const char (&s)[N], object global = globals(), object local = object()) {
     /* Support raw string literals by removing common leading whitespace */
-    auto expr = (s[0] == '\n') ? str(module_::import("textwrap").attr("dedent")(s)) : str(s);
-    return eval<mode>(expr, std::move(global), std::move(local));
+    return eval(detail::compile_cached(str(s), mode, s[0] == '\n'),
+                std::move(global),
+                std::move(local));
 }
 
 inline void exec(const str &expr, object global = globals(), object local = object()) {
@@ -108,48 +187,61 @@ object eval_file(str) {
     pybind11_fail("eval_file not supported in PyPy3. Use eval");
 }
 #else
-template <eval_mode mode = eval_statements>
-object eval_file(str fname, object global = globals(), object local = object()) {
-    if (!local) {
-        local = global;
-    }
-
-    detail::ensure_builtins_in_globals(global);
-
-    int start = 0;
-    switch (mode) {
-        case eval_expr:
-            start = Py_eval_input;
-            break;
-        case eval_single_statement:
-            start = Py_single_input;
-            break;
-        case eval_statements:
-            start = Py_file_input;
-            break;
-        default:
-            pybind11_fail("invalid evaluation mode");
-    }
+PYBIND11_NAMESPACE_BEGIN(detail)
 
-    int closeFile = 1;
+/// Compiles the file `fname`, or returns the code compiled from it before if the file still has
+/// the same modification time and size
+inline compiled_code compile_file_cached(const str &fname, eval_mode mode) {
     std::string fname_str = (std::string) fname;
-    FILE *f = _Py_fopen_obj(fname.ptr(), "r");
-    if (!f) {
-        PyErr_Clear();
+    object stat;
+    try {
+        stat = module_::import("os").attr("stat")(fname);
+    } catch (error_already_set &) {
         pybind11_fail("File \"" + fname_str + "\" could not be opened!");
     }
+    auto version = make_tuple(stat.attr("st_mtime_ns"), stat.attr("st_size"));
+
+    dict cache = eval_cache::get("__pybind11_eval_file_cache__");
+    auto key = make_tuple(fname, static_cast<int>(mode));
+    PyObject *entry = dict_getitem(cache.ptr(), key.ptr());
+    if (entry != nullptr) {
+        auto cached = reinterpret_borrow<tuple>(entry);
+        if (object(cached[0]).equal(version)) {
+            return cached[1].cast<compiled_code>();
+        }
+    }
 
-    if (!global.contains("__file__")) {
-        global["__file__"] = std::move(fname);
+    static const char *const builtin_modes[] = {"eval", "single", "exec"};
+    object file = module_::import("io").attr("open")(fname, "rb");
+    object source;
+    try {
+        source = file.attr("read")();
+    } catch (error_already_set &) {
+        file.attr("close")();
+        throw;
     }
+    file.attr("close")();
+    // The builtin `compile` reads the encoding of the source from its bytes, like `PyRun_File`
+    auto result = module_::import(PYBIND11_BUILTINS_MODULE)
+                      .attr("compile")(source, fname, builtin_modes[mode], 0, true)
+                      .cast<compiled_code>();
+    eval_cache::add(cache, key, make_tuple(version, result));
+    return result;
+}
 
-    PyObject *result
-        = PyRun_FileEx(f, fname_str.c_str(), start, global.ptr(), local.ptr(), closeFile);
+PYBIND11_NAMESPACE_END(detail)
 
-    if (!result) {
-        throw error_already_set();
+/// Evaluates a file. The code compiled from it is cached, and compiled again when the
+/// modification time or size of the file changes.
+template <eval_mode mode = eval_statements>
+object eval_file(str fname, object global = globals(), object local = object()) {
+    auto code = detail::compile_file_cached(fname, mode);
+
+    if (!global.contains("__file__")) {
+        global["__file__"] = std::move(fname);
     }
-    return reinterpret_steal<object>(result);
+
+    return eval(code, std::move(global), std::move(local));
 }
 #endif
 
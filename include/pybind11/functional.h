@@ -11,7 +11,9 @@
 
 #include "pybind11.h"
 
+#include <array>
 #include <functional>
+#include <string>
 
 PYBIND11_NAMESPACE_BEGIN(PYBIND11_NAMESPACE)
 PYBIND11_NAMESPACE_BEGIN(detail)
@@ -38,6 +40,11 @@ public:
 
         auto func = reinterpret_borrow<function>(src);
 
+        // A pybind11 function (or the function of a bound method), which calls try to invoke
+        // directly (see `call_function_record`) before calling `func` through Python
+        const function_record *direct_rec = nullptr;
+        handle direct_self;
+
         /*
            When passing a C++ function as an argument to another C++
            function via Python, every function call would normally involve
@@ -57,6 +64,10 @@ public:
                 // Check that we can safely reinterpret the capsule into a function_record
                 if (detail::is_function_record_capsule(c)) {
                     rec = c.get_pointer<function_record>();
+                    direct_rec = rec;
+                    if (PyMethod_Check(src.ptr())) {
+                        direct_self = PyMethod_GET_SELF(src.ptr());
+                    }
                 }
 
                 while (rec != nullptr) {
@@ -102,15 +113,73 @@ public:
         // to emulate 'move initialization capture' in C++11
         struct func_wrapper {
             func_handle hfunc;
-            explicit func_wrapper(func_handle &&hf) noexcept : hfunc(std::move(hf)) {}
+            const function_record *rec;
+            handle self; // `self` of a bound method, kept alive by `hfunc`
+            func_wrapper(func_handle &&hf, const function_record *rec_, handle self_) noexcept
+                : hfunc(std::move(hf)), rec(rec_), self(self_) {}
             Return operator()(Args... args) const {
+                // Inside a `gil_scoped_callback_batch`, this thread holds the GIL already
+                if (callback_batch_depth() > 0) {
+                    return call(std::forward<Args>(args)...).template cast<Return>();
+                }
                 gil_scoped_acquire acq;
                 // casts the returned object as a rvalue to the return type
-                return hfunc.f(std::forward<Args>(args)...).template cast<Return>();
+                return call(std::forward<Args>(args)...).template cast<Return>();
+            }
+
+        private:
+            object call(Args &&...args) const {
+                constexpr size_t nargs = sizeof...(Args);
+                // The arguments follow an empty slot, which lets `self` be put in front of
+                // them for a direct call, and vectorcall do the same without copying them
+                std::array<object, nargs + 1> argv{
+                    {object(),
+                     reinterpret_steal<object>(
+                         make_caster<Args>::cast(std::forward<Args>(args),
+                                                 return_value_policy::automatic_reference,
+                                                 nullptr))...}};
+                std::array<PyObject *, nargs + 1> ptrs{};
+                for (size_t i = 1; i <= nargs; ++i) {
+                    if (!argv[i]) {
+#if !defined(PYBIND11_DETAILED_ERROR_MESSAGES)
+                        throw cast_error_unable_to_convert_call_arg(std::to_string(i - 1));
+#else
+                        std::array<std::string, nargs + 1> argtypes{{"", type_id<Args>()...}};
+                        throw cast_error_unable_to_convert_call_arg(std::to_string(i - 1),
+                                                                    argtypes[i]);
+#endif
+                    }
+                    ptrs[i] = argv[i].ptr();
+                }
+
+                if (rec != nullptr) {
+                    ptrs[0] = self.ptr();
+                    const size_t first = self ? 0 : 1;
+                    auto result = call_function_record(*rec, &ptrs[first], nargs + 1 - first);
+                    if (result) {
+                        return result;
+                    }
+                    // Not invoked: the call through Python reports why
+                }
+
+#if defined(PYBIND11_HAS_VECTORCALL)
+                PyObject *result = PyObject_Vectorcall(
+                    hfunc.f.ptr(), &ptrs[1], nargs | PY_VECTORCALL_ARGUMENTS_OFFSET, nullptr);
+#else
+                tuple call_args(nargs);
+                for (size_t i = 1; i <= nargs; ++i) {
+                    PyTuple_SET_ITEM(call_args.ptr(), (ssize_t) i - 1, argv[i].release().ptr());
+                }
+                PyObject *result = PyObject_Call(hfunc.f.ptr(), call_args.ptr(), nullptr);
+#endif
+                if (!result) {
+                    throw error_already_set();
+                }
+                return reinterpret_steal<object>(result);
             }
         };
 
-        value = func_wrapper(func_handle(std::move(func)));
+        value = func_wrapper(func_handle(std::move(func)), direct_rec, direct_self);
         return true;
     }
 
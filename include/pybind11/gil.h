@@ -10,6 +10,7 @@
 #pragma once
 
 #include "detail/common.h"
+#include "detail/tracing.h"
 
 #if defined(WITH_THREAD) && !defined(PYBIND11_SIMPLE_GIL_MANAGEMENT)
 #    include "detail/internals.h"
@@ -22,6 +23,19 @@ PYBIND11_NAMESPACE_BEGIN(detail)
 // forward declarations
 PyThreadState *get_thread_state_unchecked();
 
+/// The number of `gil_scoped_callback_batch` scopes that the current thread is in, not counting
+/// those it has left temporarily by releasing the GIL
+inline int &callback_batch_depth() {
+    static thread_local int depth = 0;
+    return depth;
+}
+
+/// The thread state kept by the innermost `gil_scoped_thread_state` of the current thread
+inline PyThreadState *&kept_thread_state() {
+    static thread_local PyThreadState *tstate = nullptr;
+    return tstate;
+}
+
 PYBIND11_NAMESPACE_END(detail)
 
 #if defined(WITH_THREAD)
@@ -53,6 +67,24 @@ PYBIND11_NAMESPACE_END(detail)
 class gil_scoped_acquire {
 public:
     PYBIND11_NOINLINE gil_scoped_acquire() {
+        // Fast path: this thread holds the GIL already, so there is nothing to look up
+        tstate = detail::get_thread_state_unchecked();
+        if (holds_gil(tstate)) {
+            release = false;
+            inc_ref();
+            return;
+        }
+
+        // A thread state kept by `gil_scoped_thread_state` belongs to this thread, so it can be
+        // used without looking it up
+        tstate = detail::kept_thread_state();
+        if (tstate != nullptr) {
+            PyEval_AcquireThread(tstate);
+            PYBIND11_TRACE(gil_acquire, nullptr, tstate);
+            inc_ref();
+            return;
+        }
+
         auto &internals = detail::get_internals();
         tstate = (PyThreadState *) PYBIND11_TLS_GET_VALUE(internals.tstate);
 
@@ -80,6 +112,7 @@ public:
 
         if (release) {
             PyEval_AcquireThread(tstate);
+            PYBIND11_TRACE(gil_acquire, nullptr, tstate);
         }
 
         inc_ref();
@@ -123,6 +156,9 @@ public:
     PYBIND11_NOINLINE void disarm() { active = false; }
 
     PYBIND11_NOINLINE ~gil_scoped_acquire() {
+        if (release) {
+            PYBIND11_TRACE(gil_release, nullptr, tstate);
+        }
         dec_ref();
         if (release) {
             PyEval_SaveThread();
@@ -130,6 +166,16 @@ public:
     }
 
 private:
+    // Whether `tstate`, the current thread state, belongs to the calling thread
+    static bool holds_gil(PyThreadState *tstate) {
+#        if PY_VERSION_HEX >= 0x030C0000
+        // The current thread state is thread-local
+        return tstate != nullptr;
+#        else
+        return tstate != nullptr && tstate->thread_id == PyThread_get_thread_ident();
+#        endif
+    }
+
     PyThreadState *tstate = nullptr;
     bool release = true;
     bool active = true;
@@ -137,18 +183,24 @@ private:
 
 class gil_scoped_release {
 public:
-    explicit gil_scoped_release(bool disassoc = false) : disassoc(disassoc) {
+    explicit gil_scoped_release(bool disassoc = false)
+        : disassoc(disassoc), batch_depth(detail::callback_batch_depth()) {
+        detail::callback_batch_depth() = 0;
         // `get_internals()` must be called here unconditionally in order to initialize
         // `internals.tstate` for subsequent `gil_scoped_acquire` calls. Otherwise, an
         // initialization race could occur as multiple threads try `gil_scoped_acquire`.
         auto &internals = detail::get_internals();
         // NOLINTNEXTLINE(cppcoreguidelines-prefer-member-initializer)
         tstate = PyEval_SaveThread();
+        PYBIND11_TRACE(gil_release, nullptr, tstate);
         if (disassoc) {
             // Python >= 3.7 can remove this, it's an int before 3.7
             // NOLINTNEXTLINE(readability-qualified-auto)
             auto key = internals.tstate;
             PYBIND11_TLS_DELETE_VALUE(key);
+            // The thread state may be moved to another thread
+            kept = detail::kept_thread_state();
+            detail::kept_thread_state() = nullptr;
         }
     }
 
@@ -163,51 +215,124 @@ public:
     PYBIND11_NOINLINE void disarm() { active = false; }
 
     ~gil_scoped_release() {
+        detail::callback_batch_depth() = batch_depth;
         if (!tstate) {
             return;
         }
         // `PyEval_RestoreThread()` should not be called if runtime is finalizing
         if (active) {
             PyEval_RestoreThread(tstate);
+            PYBIND11_TRACE(gil_acquire, nullptr, tstate);
         }
         if (disassoc) {
             // Python >= 3.7 can remove this, it's an int before 3.7
             // NOLINTNEXTLINE(readability-qualified-auto)
             auto key = detail::get_internals().tstate;
             PYBIND11_TLS_REPLACE_VALUE(key, tstate);
+            detail::kept_thread_state() = kept;
         }
     }
 
 private:
     PyThreadState *tstate;
+    PyThreadState *kept = nullptr;
     bool disassoc;
+    int batch_depth;
     bool active = true;
 };
 
+/// Keeps the thread state of the calling thread for the whole scope, without holding the GIL.
+/// Every `gil_scoped_acquire` in the scope reuses it instead of looking it up, and on a thread
+/// that was not created by Python, instead of making a new thread state and deleting it again
+/// each time.
+class gil_scoped_thread_state {
+public:
+    gil_scoped_thread_state() : previous(detail::kept_thread_state()) {
+        gil_scoped_acquire acquire;
+        // Held until the destructor, which keeps `dec_ref()` from deleting the thread state
+        acquire.inc_ref();
+        detail::kept_thread_state() = detail::get_thread_state_unchecked();
+    }
+
+    gil_scoped_thread_state(const gil_scoped_thread_state &) = delete;
+    gil_scoped_thread_state &operator=(const gil_scoped_thread_state &) = delete;
+
+    ~gil_scoped_thread_state() {
+        {
+            gil_scoped_acquire acquire;
+            acquire.dec_ref();
+        }
+        detail::kept_thread_state() = previous;
+    }
+
+private:
+    PyThreadState *previous;
+};
+
 #    else // PYBIND11_SIMPLE_GIL_MANAGEMENT
 
 class gil_scoped_acquire {
     PyGILState_STATE state;
 
 public:
-    gil_scoped_acquire() : state{PyGILState_Ensure()} {}
+    gil_scoped_acquire() : state{PyGILState_Ensure()} {
+        if (state == PyGILState_UNLOCKED) {
+            PYBIND11_TRACE(gil_acquire, nullptr, PyThreadState_Get());
+        }
+    }
     gil_scoped_acquire(const gil_scoped_acquire &) = delete;
     gil_scoped_acquire &operator=(const gil_scoped_acquire &) = delete;
-    ~gil_scoped_acquire() { PyGILState_Release(state); }
+    ~gil_scoped_acquire() {
+        if (state == PyGILState_UNLOCKED) {
+            PYBIND11_TRACE(gil_release, nullptr, PyThreadState_Get());
+        }
+        PyGILState_Release(state);
+    }
     void disarm() {}
 };
 
 class gil_scoped_release {
+    int batch_depth;
     PyThreadState *state;
 
 public:
-    gil_scoped_release() : state{PyEval_SaveThread()} {}
+    gil_scoped_release() : batch_depth{detail::callback_batch_depth()} {
+        detail::callback_batch_depth() = 0;
+        state = PyEval_SaveThread();
+        PYBIND11_TRACE(gil_release, nullptr, state);
+    }
     gil_scoped_release(const gil_scoped_release &) = delete;
     gil_scoped_release &operator=(const gil_scoped_release &) = delete;
-    ~gil_scoped_release() { PyEval_RestoreThread(state); }
+    ~gil_scoped_release() {
+        PyEval_RestoreThread(state);
+        PYBIND11_TRACE(gil_acquire, nullptr, state);
+        detail::callback_batch_depth() = batch_depth;
+    }
     void disarm() {}
 };
 
+class gil_scoped_thread_state {
+    PyGILState_STATE state;
+    PyThreadState *saved = nullptr;
+
+public:
+    gil_scoped_thread_state() : state{PyGILState_Ensure()} {
+        // The thread state stays until `PyGILState_Release()`, but the GIL is released now if
+        // it was not held before
+        if (state == PyGILState_UNLOCKED) {
+            saved = PyEval_SaveThread();
+        }
+    }
+    gil_scoped_thread_state(const gil_scoped_thread_state &) = delete;
+    gil_scoped_thread_state &operator=(const gil_scoped_thread_state &) = delete;
+    ~gil_scoped_thread_state() {
+        if (saved != nullptr) {
+            PyEval_RestoreThread(saved);
+        }
+        PyGILState_Release(state);
+    }
+};
+
 #    endif // PYBIND11_SIMPLE_GIL_MANAGEMENT
 
 #else // WITH_THREAD
@@ -234,6 +359,30 @@ public:
     void disarm() {}
 };
 
+class gil_scoped_thread_state {
+public:
+    gil_scoped_thread_state() {
+        // Trick to suppress `unused variable` error messages (at call sites).
+        (void) (this != (this + 1));
+    }
+    gil_scoped_thread_state(const gil_scoped_thread_state &) = delete;
+    gil_scoped_thread_state &operator=(const gil_scoped_thread_state &) = delete;
+};
+
 #endif // WITH_THREAD
 
+/// Holds the GIL for a batch of calls from C++ to Python callbacks passed as `std::function`.
+/// Within the scope, these calls skip acquiring the GIL themselves. Releasing the GIL with
+/// `gil_scoped_release` inside the scope suspends the batch until the GIL is reacquired.
+class gil_scoped_callback_batch {
+public:
+    gil_scoped_callback_batch() { ++detail::callback_batch_depth(); }
+    gil_scoped_callback_batch(const gil_scoped_callback_batch &) = delete;
+    gil_scoped_callback_batch &operator=(const gil_scoped_callback_batch &) = delete;
+    ~gil_scoped_callback_batch() { --detail::callback_batch_depth(); }
+
+private:
+    gil_scoped_acquire acquire;
+};
+
 PYBIND11_NAMESPACE_END(PYBIND11_NAMESPACE)
@@ -15,6 +15,7 @@
     For more background see the discussions under
     https://github.com/pybind/pybind11/pull/2982 and
     https://github.com/pybind/pybind11/pull/2995.
+    The buffered redirects (`scoped_buffered_ostream_redirect`) are thread safe.
 */
 
 #pragma once
@@ -22,18 +23,60 @@
 #include "pybind11.h"
 
 #include <algorithm>
+#include <chrono>
+#include <condition_variable>
 #include <cstring>
 #include <iostream>
 #include <iterator>
 #include <memory>
+#include <mutex>
 #include <ostream>
 #include <streambuf>
 #include <string>
+#include <thread>
 #include <utility>
 
 PYBIND11_NAMESPACE_BEGIN(PYBIND11_NAMESPACE)
 PYBIND11_NAMESPACE_BEGIN(detail)
 
+// Computes how many bytes at the end of [begin, end) are part of an
+// incomplete sequence of UTF-8 bytes.
+// Precondition: begin < end
+inline size_t utf8_remainder(const char *begin, const char *end) {
+    const auto rbase = std::reverse_iterator<const char *>(begin);
+    const auto rpptr = std::reverse_iterator<const char *>(end);
+    auto is_ascii = [](char c) { return (static_cast<unsigned char>(c) & 0x80) == 0x00; };
+    auto is_leading = [](char c) { return (static_cast<unsigned char>(c) & 0xC0) == 0xC0; };
+    auto is_leading_2b = [](char c) { return static_cast<unsigned char>(c) <= 0xDF; };
+    auto is_leading_3b = [](char c) { return static_cast<unsigned char>(c) <= 0xEF; };
+    // If the last character is ASCII, there are no incomplete code points
+    if (is_ascii(*rpptr)) {
+        return 0;
+    }
+    // Otherwise, work back from the end of the buffer and find the first
+    // UTF-8 leading byte
+    const auto rpend = rbase - rpptr >= 3 ? rpptr + 3 : rbase;
+    const auto leading = std::find_if(rpptr, rpend, is_leading);
+    if (leading == rbase) {
+        return 0;
+    }
+    const auto dist = static_cast<size_t>(leading - rpptr);
+    size_t remainder = 0;
+
+    if (dist == 0) {
+        remainder = 1; // 1-byte code point is impossible
+    } else if (dist == 1) {
+        remainder = is_leading_2b(*leading) ? 0 : dist + 1;
+    } else if (dist == 2) {
+        remainder = is_leading_3b(*leading) ? 0 : dist + 1;
+    }
+    // else if (dist >= 3), at least 4 bytes before encountering an UTF-8
+    // leading byte, either no remainder or invalid UTF-8.
+    // Invalid UTF-8 will cause an exception later when converting
+    // to a Python string, so that's not handled here.
+    return remainder;
+}
+
 // Buffer that writes to Python instead of C++
 class pythonbuf : public std::streambuf {
 private:
@@ -52,51 +95,13 @@ private:
         return sync() == 0 ? traits_type::not_eof(c) : traits_type::eof();
     }
 
-    // Computes how many bytes at the end of the buffer are part of an
-    // incomplete sequence of UTF-8 bytes.
-    // Precondition: pbase() < pptr()
-    size_t utf8_remainder() const {
-        const auto rbase = std::reverse_iterator<char *>(pbase());
-        const auto rpptr = std::reverse_iterator<char *>(pptr());
-        auto is_ascii = [](char c) { return (static_cast<unsigned char>(c) & 0x80) == 0x00; };
-        auto is_leading = [](char c) { return (static_cast<unsigned char>(c) & 0xC0) == 0xC0; };
-        auto is_leading_2b = [](char c) { return static_cast<unsigned char>(c) <= 0xDF; };
-        auto is_leading_3b = [](char c) { return static_cast<unsigned char>(c) <= 0xEF; };
-        // If the last character is ASCII, there are no incomplete code points
-        if (is_ascii(*rpptr)) {
-            return 0;
-        }
-        // Otherwise, work back from the end of the buffer and find the first
-        // UTF-8 leading byte
-        const auto rpend = rbase - rpptr >= 3 ? rpptr + 3 : rbase;
-        const auto leading = std::find_if(rpptr, rpend, is_leading);
-        if (leading == rbase) {
-            return 0;
-        }
-        const auto dist = static_cast<size_t>(leading - rpptr);
-        size_t remainder = 0;
-
-        if (dist == 0) {
-            remainder = 1; // 1-byte code point is impossible
-        } else if (dist == 1) {
-            remainder = is_leading_2b(*leading) ? 0 : dist + 1;
-        } else if (dist == 2) {
-            remainder = is_leading_3b(*leading) ? 0 : dist + 1;
-        }
-        // else if (dist >= 3), at least 4 bytes before encountering an UTF-8
-        // leading byte, either no remainder or invalid UTF-8.
-        // Invalid UTF-8 will cause an exception later when converting
-        // to a Python string, so that's not handled here.
-        return remainder;
-    }
-
     // This function must be non-virtual to be called in a destructor.
     int _sync() {
         if (pbase() != pptr()) { // If buffer is not empty
             gil_scoped_acquire tmp;
             // This subtraction cannot be negative, so dropping the sign.
             auto size = static_cast<size_t>(pptr() - pbase());
-            size_t remainder = utf8_remainder();
+            size_t remainder = utf8_remainder(pbase(), pptr());
 
             if (size > remainder) {
                 str line(pbase(), size - remainder);
@@ -129,6 +134,129 @@ public:
     ~pythonbuf() override { _sync(); }
 };
 
+/// Buffer that collects the output of any number of threads without the GIL, and writes it to
+/// Python in large blocks: from a background thread once `flush_threshold` bytes are waiting or
+/// every `flush_interval`, and when the buffer is destroyed. Flushes of the C++ stream (e.g.
+/// `std::endl`) do not write anything. A threshold and interval of zero disable the background
+/// thread.
+class buffered_pythonbuf : public std::streambuf {
+public:
+    buffered_pythonbuf(const object &pyostream,
+                       size_t flush_threshold,
+                       std::chrono::milliseconds flush_interval)
+        : pywrite(pyostream.attr("write")), pyflush(pyostream.attr("flush")),
+          threshold(flush_threshold), interval(flush_interval) {
+        // Without a put area, every write goes through `xsputn()` or `overflow()`
+        setp(nullptr, nullptr);
+        if (threshold != 0 || interval.count() != 0) {
+            flusher = std::thread([this]() { flush_in_background(); });
+        }
+    }
+
+    buffered_pythonbuf(const buffered_pythonbuf &) = delete;
+    buffered_pythonbuf &operator=(const buffered_pythonbuf &) = delete;
+
+    /// Writes what is left. Must be called with the GIL held, which is released while waiting
+    /// for the background thread.
+    ~buffered_pythonbuf() override {
+        if (flusher.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            wake.notify_one();
+            gil_scoped_release release;
+            flusher.join();
+        }
+        try {
+            write(data);
+        } catch (error_already_set &e) {
+            e.discard_as_unraisable("pybind11::detail::buffered_pythonbuf::~buffered_pythonbuf");
+        }
+    }
+
+protected:
+    std::streamsize xsputn(const char *s, std::streamsize n) override {
+        append(s, static_cast<size_t>(n));
+        return n;
+    }
+
+    int overflow(int c) override {
+        if (!traits_type::eq_int_type(c, traits_type::eof())) {
+            const char ch = traits_type::to_char_type(c);
+            append(&ch, 1);
+        }
+        return traits_type::not_eof(c);
+    }
+
+private:
+    void append(const char *s, size_t n) {
+        bool reached_threshold = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            const size_t before = data.size();
+            data.append(s, n);
+            reached_threshold = threshold != 0 && before < threshold && data.size() >= threshold;
+        }
+        if (reached_threshold) {
+            wake.notify_one();
+        }
+    }
+
+    bool should_flush() const { return stopping || (threshold != 0 && data.size() >= threshold); }
+
+    void flush_in_background() {
+        // Only ever waits for the GIL without holding the mutex, which writers holding the GIL
+        // may be waiting for
+        gil_scoped_thread_state thread_state;
+        std::unique_lock<std::mutex> lock(mutex);
+        std::string block;
+        while (!stopping) {
+            if (interval.count() != 0) {
+                wake.wait_for(lock, interval, [this]() { return should_flush(); });
+            } else {
+                wake.wait(lock, [this]() { return should_flush(); });
+            }
+            if (stopping || data.empty()) {
+                continue;
+            }
+            // An incomplete UTF-8 sequence at the end stays for the next block
+            const size_t remainder = utf8_remainder(data.data(), data.data() + data.size());
+            block.assign(data, 0, data.size() - remainder);
+            data.erase(0, data.size() - remainder);
+            lock.unlock();
+            {
+                gil_scoped_acquire gil;
+                try {
+                    write(block);
+                } catch (error_already_set &e) {
+                    e.discard_as_unraisable(
+                        "pybind11::detail::buffered_pythonbuf::flush_in_background");
+                }
+            }
+            lock.lock();
+        }
+    }
+
+    // Called with the GIL held
+    void write(const std::string &block) {
+        if (!block.empty()) {
+            pywrite(str(block.data(), block.size()));
+            pyflush();
+        }
+    }
+
+    object pywrite;
+    object pyflush;
+    const size_t threshold;
+    const std::chrono::milliseconds interval;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::string data;
+    bool stopping = false;
+    std::thread flusher;
+};
+
 PYBIND11_NAMESPACE_END(detail)
 
 /** \rst
@@ -197,6 +325,63 @@ public:
         : scoped_ostream_redirect(costream, pyostream) {}
 };
 
+/// How `scoped_buffered_ostream_redirect` writes to Python
+struct buffered_redirect_options {
+    /// The number of bytes waiting after which they are written, or 0
+    size_t flush_threshold = 64 * 1024;
+    /// The interval at which waiting output is written, or 0
+    std::chrono::milliseconds flush_interval{100};
+};
+
+/** \rst
+    Like `scoped_ostream_redirect`, but any number of threads may write to the stream at once,
+    without the GIL. The output is collected in a buffer and written to Python in large blocks,
+    by a background thread and at the end of the scope; flushes of the C++ stream (e.g.
+    ``std::endl``) do not write anything by themselves.
+
+    .. code-block:: cpp
+
+        {
+            py::scoped_buffered_ostream_redirect output;
+            py::gil_scoped_release release;
+            run_workers(); // log to std::cout from several threads
+        } // <-- the rest of the output is written to sys.stdout
+
+    The guard must be destroyed with the GIL held, like it is constructed.
+ \endrst */
+class scoped_buffered_ostream_redirect {
+protected:
+    std::streambuf *old;
+    std::ostream &costream;
+    detail::buffered_pythonbuf buffer;
+
+public:
+    explicit scoped_buffered_ostream_redirect(std::ostream &costream = std::cout,
+                                              const object &pyostream
+                                              = module_::import("sys").attr("stdout"),
+                                              const buffered_redirect_options &options = {})
+        : costream(costream),
+          buffer(pyostream, options.flush_threshold, options.flush_interval) {
+        old = costream.rdbuf(&buffer);
+    }
+
+    ~scoped_buffered_ostream_redirect() { costream.rdbuf(old); }
+
+    scoped_buffered_ostream_redirect(const scoped_buffered_ostream_redirect &) = delete;
+    scoped_buffered_ostream_redirect &operator=(const scoped_buffered_ostream_redirect &)
+        = delete;
+};
+
+/// Like `scoped_buffered_ostream_redirect`, but redirects cerr by default
+class scoped_buffered_estream_redirect : public scoped_buffered_ostream_redirect {
+public:
+    explicit scoped_buffered_estream_redirect(std::ostream &costream = std::cerr,
+                                              const object &pyostream
+                                              = module_::import("sys").attr("stderr"),
+                                              const buffered_redirect_options &options = {})
+        : scoped_buffered_ostream_redirect(costream, pyostream, options) {}
+};
+
 PYBIND11_NAMESPACE_BEGIN(detail)
 
 // Class to redirect output as a context manager. C++ backend.
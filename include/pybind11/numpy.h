@@ -14,18 +14,37 @@
 
 #include <algorithm>
 #include <array>
+#include <cerrno>
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
+#include <exception>
 #include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
 #include <numeric>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <type_traits>
 #include <typeindex>
 #include <utility>
 #include <vector>
 
+#if defined(__unix__) || defined(__APPLE__)
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#    define PYBIND11_NUMPY_HAS_MMAP 1
+#endif
+
+// Copies of array data of at least this many bytes release the GIL while they run
+#ifndef PYBIND11_NUMPY_COPY_WITHOUT_GIL_THRESHOLD
+#    define PYBIND11_NUMPY_COPY_WITHOUT_GIL_THRESHOLD (1 << 20)
+#endif
+
 /* This will be true on all flat address space platforms and allows us to reduce the
    whole npy_intp / ssize_t / Py_intptr_t business down to just ssize_t for all size
    and dimension types (e.g. shape, strides, indexing), instead of inflicting this
@@ -314,6 +333,33 @@ inline bool check_flags(const void *ptr, int flag) {
     return (flag == (array_proxy(ptr)->flags & flag));
 }
 
+/// Whether `src` is a NumPy array, without importing NumPy if it is not loaded yet (in which case
+/// no object can be an array), for casters that only take arrays as a fast path
+inline bool is_loaded_numpy_array(handle src) {
+    return PyDict_GetItemString(PyImport_GetModuleDict(), "numpy") != nullptr
+           && npy_api::get().PyArray_Check_(src.ptr());
+}
+
+// Arrays usually share the descriptor of their dtype (builtin descriptors are singletons, and
+// registered structured dtypes are cached), so comparing the pointers first avoids most calls
+// into NumPy.
+inline bool equivalent_dtypes(PyObject *a, PyObject *b) {
+    return a == b || npy_api::get().PyArray_EquivTypes_(a, b);
+}
+
+// The type number of the builtin NumPy dtype of `T`, or -1 if `T` does not map to one
+template <typename T, typename = void>
+struct npy_builtin_type_num : std::integral_constant<int, -1> {};
+template <typename T>
+struct npy_builtin_type_num<T, void_t<decltype(npy_format_descriptor<T>::value)>>
+    : std::integral_constant<int, npy_format_descriptor<T>::value> {};
+
+// Whether a descriptor is the builtin one with the given type number, in native byte order
+inline bool is_native_builtin_descr(PyObject *descr, int type_num) {
+    const auto *proxy = array_descriptor_proxy(descr);
+    return proxy->type_num == type_num && (proxy->byteorder == '=' || proxy->byteorder == '|');
+}
+
 template <typename T>
 struct is_std_array : std::false_type {};
 template <typename T, size_t N>
@@ -526,6 +572,158 @@ public:
     }
 };
 
+/**
+ * Like `unchecked_reference`, for an array with a compile-time number of dimensions that is known
+ * to be C-contiguous (row-major), or Fortran-contiguous if `FStyle`. Element offsets follow from
+ * the shape alone, which lets the compiler optimize (and vectorize) loops much like for a
+ * built-in multidimensional array. The elements can also be traversed as a plain pointer range
+ * with `begin()` and `end()`. This is constructed through `unchecked<T, N, Layout>()` or
+ * `unchecked<N, Layout>()`, with `array::c_style` or `array::f_style` as the `Layout`.
+ */
+template <typename T, ssize_t Dims, bool FStyle>
+class unchecked_contiguous_reference {
+    static_assert(Dims >= 0,
+                  "Contiguous unchecked access requires a compile-time number of dimensions");
+
+protected:
+    const T *data_;
+    std::array<ssize_t, (size_t) Dims> shape_;
+
+    friend class pybind11::array;
+    // The strides are implied by the layout, so only the shape is stored
+    unchecked_contiguous_reference(const void *data,
+                                   const ssize_t *shape,
+                                   const ssize_t * /*strides*/,
+                                   ssize_t /*dims*/)
+        : data_{static_cast<const T *>(data)} {
+        for (size_t i = 0; i < (size_t) Dims; i++) {
+            shape_[i] = shape[i];
+        }
+    }
+
+    // Row-major: ((i0 * n1 + i1) * n2 + i2) ...
+    template <size_t Dim>
+    ssize_t c_offset(ssize_t acc) const {
+        return acc;
+    }
+    template <size_t Dim, typename... Ix>
+    ssize_t c_offset(ssize_t acc, ssize_t i, Ix... index) const {
+        return c_offset<Dim + 1>(acc * shape_[Dim] + i, index...);
+    }
+
+    // Column-major: i0 + n0 * (i1 + n1 * (i2 ...))
+    template <size_t Dim>
+    ssize_t f_offset(ssize_t i) const {
+        return i;
+    }
+    template <size_t Dim, typename... Ix>
+    ssize_t f_offset(ssize_t i, ssize_t j, Ix... index) const {
+        return i + shape_[Dim] * f_offset<Dim + 1>(j, index...);
+    }
+
+    ssize_t offset() const { return 0; }
+    template <typename... Ix>
+    ssize_t offset(ssize_t i, Ix... index) const {
+        return FStyle ? f_offset<0>(i, index...) : c_offset<1>(i, index...);
+    }
+
+public:
+    /// Unchecked const reference access to data at the given indices
+    template <typename... Ix>
+    const T &operator()(Ix... index) const {
+        static_assert(ssize_t{sizeof...(Ix)} == Dims,
+                      "Invalid number of indices for unchecked array reference");
+        return data_[offset(ssize_t(index)...)];
+    }
+    /// Unchecked const reference access to data of a 1-dimensional array
+    template <ssize_t D = Dims, typename = enable_if_t<D == 1>>
+    const T &operator[](ssize_t index) const {
+        return data_[index];
+    }
+
+    /// Pointer to the first element
+    const T *data() const { return data_; }
+    /// Pointer access to the data at the given indices
+    template <typename... Ix>
+    const T *data(Ix... ix) const {
+        return &operator()(ssize_t(ix)...);
+    }
+
+    /// The elements, in memory order
+    const T *begin() const { return data_; }
+    const T *end() const { return data_ + size(); }
+
+    /// Returns the item size, i.e. sizeof(T)
+    constexpr static ssize_t itemsize() { return sizeof(T); }
+
+    /// Returns the shape (i.e. size) of dimension `dim`
+    ssize_t shape(ssize_t dim) const { return shape_[(size_t) dim]; }
+
+    /// Returns the number of dimensions of the array
+    constexpr static ssize_t ndim() { return Dims; }
+
+    /// Returns the total number of elements in the referenced array
+    ssize_t size() const {
+        return std::accumulate(
+            shape_.begin(), shape_.end(), (ssize_t) 1, std::multiplies<ssize_t>());
+    }
+
+    /// Returns the total number of bytes used by the referenced data
+    ssize_t nbytes() const { return size() * itemsize(); }
+};
+
+template <typename T, ssize_t Dims, bool FStyle>
+class unchecked_contiguous_mutable_reference
+    : public unchecked_contiguous_reference<T, Dims, FStyle> {
+    friend class pybind11::array;
+    using ConstBase = unchecked_contiguous_reference<T, Dims, FStyle>;
+    using ConstBase::ConstBase;
+
+public:
+    // Bring in const-qualified versions from base class
+    using ConstBase::operator();
+    using ConstBase::operator[];
+    using ConstBase::begin;
+    using ConstBase::end;
+
+    /// Mutable, unchecked access to data at the given indices
+    template <typename... Ix>
+    T &operator()(Ix... index) {
+        return const_cast<T &>(ConstBase::operator()(index...));
+    }
+    /// Mutable, unchecked access to data of a 1-dimensional array
+    template <ssize_t D = Dims, typename = enable_if_t<D == 1>>
+    T &operator[](ssize_t index) {
+        return operator()(index);
+    }
+
+    /// Mutable pointer to the first element
+    T *mutable_data() { return const_cast<T *>(this->data_); }
+    /// Mutable pointer access to the data at the given indices
+    template <typename... Ix>
+    T *mutable_data(Ix... ix) {
+        return &operator()(ssize_t(ix)...);
+    }
+
+    /// The elements, in memory order
+    T *begin() { return mutable_data(); }
+    T *end() { return mutable_data() + this->size(); }
+};
+
+// The proxy returned by `unchecked<T, Dims, Layout>()`; `Layout` is 0 for arbitrary strides
+template <typename T, ssize_t Dims, int Layout>
+using unchecked_reference_t
+    = conditional_t<Layout == 0,
+                    unchecked_reference<T, Dims>,
+                    unchecked_contiguous_reference<T,
+                                                   Dims,
+                                                   Layout == npy_api::NPY_ARRAY_F_CONTIGUOUS_>>;
+template <typename T, ssize_t Dims, int Layout>
+using unchecked_mutable_reference_t = conditional_t<
+    Layout == 0,
+    unchecked_mutable_reference<T, Dims>,
+    unchecked_contiguous_mutable_reference<T, Dims, Layout == npy_api::NPY_ARRAY_F_CONTIGUOUS_>>;
+
 template <typename T, ssize_t Dim>
 struct type_caster<unchecked_reference<T, Dim>> {
     static_assert(Dim == 0 && Dim > 0 /* always fail */,
@@ -743,8 +941,7 @@ public:
             if (base) {
                 api.PyArray_SetBaseObject_(tmp.ptr(), base.inc_ref().ptr());
             } else {
-                tmp = reinterpret_steal<object>(
-                    api.PyArray_NewCopy_(tmp.ptr(), -1 /* any order */));
+                tmp = copy_of(reinterpret_borrow<array>(tmp));
             }
         }
         m_ptr = tmp.release().ptr();
@@ -876,15 +1073,13 @@ public:
      * dimensionality checking.  Will throw if the array is missing the `writeable` flag.  Use with
      * care: the array must not be destroyed or reshaped for the duration of the returned object,
      * and the caller must take care not to access invalid dimensions or dimension indices.
+     * With a `Layout` of `c_style` or `f_style`, the array must also be contiguous in that order,
+     * and the proxy computes the offsets of elements from the shape alone.
      */
-    template <typename T, ssize_t Dims = -1>
-    detail::unchecked_mutable_reference<T, Dims> mutable_unchecked() & {
-        if (Dims >= 0 && ndim() != Dims) {
-            throw std::domain_error("array has incorrect number of dimensions: "
-                                    + std::to_string(ndim()) + "; expected "
-                                    + std::to_string(Dims));
-        }
-        return detail::unchecked_mutable_reference<T, Dims>(
+    template <typename T, ssize_t Dims = -1, int Layout = 0>
+    detail::unchecked_mutable_reference_t<T, Dims, Layout> mutable_unchecked() & {
+        check_unchecked_layout<Dims, Layout>();
+        return detail::unchecked_mutable_reference_t<T, Dims, Layout>(
             mutable_data(), shape(), strides(), ndim());
     }
 
@@ -893,16 +1088,38 @@ public:
      * dimensionality checking.  Unlike `mutable_unchecked()`, this does not require that the
      * underlying array have the `writable` flag.  Use with care: the array must not be destroyed
      * or reshaped for the duration of the returned object, and the caller must take care not to
-     * access invalid dimensions or dimension indices.
+     * access invalid dimensions or dimension indices. `Layout` is as for `mutable_unchecked()`.
+     */
+    template <typename T, ssize_t Dims = -1, int Layout = 0>
+    detail::unchecked_reference_t<T, Dims, Layout> unchecked() const & {
+        check_unchecked_layout<Dims, Layout>();
+        return detail::unchecked_reference_t<T, Dims, Layout>(data(), shape(), strides(), ndim());
+    }
+
+    /**
+     * Like `mutable_unchecked()`, for the field of type `T` at `offset` bytes into each element
+     * of a structured array: the proxy accesses the field in place, with the strides of the
+     * array. Throws if the field does not fit inside the elements.
      */
     template <typename T, ssize_t Dims = -1>
-    detail::unchecked_reference<T, Dims> unchecked() const & {
-        if (Dims >= 0 && ndim() != Dims) {
-            throw std::domain_error("array has incorrect number of dimensions: "
-                                    + std::to_string(ndim()) + "; expected "
-                                    + std::to_string(Dims));
-        }
-        return detail::unchecked_reference<T, Dims>(data(), shape(), strides(), ndim());
+    detail::unchecked_mutable_reference<T, Dims> mutable_unchecked_field(ssize_t offset) & {
+        check_unchecked_layout<Dims, 0>();
+        check_field_offset(offset, sizeof(T));
+        return detail::unchecked_mutable_reference<T, Dims>(
+            static_cast<char *>(mutable_data()) + offset, shape(), strides(), ndim());
+    }
+
+    /**
+     * Like `unchecked()`, for the field of type `T` at `offset` bytes into each element of a
+     * structured array: the proxy accesses the field in place, with the strides of the array.
+     * Throws if the field does not fit inside the elements.
+     */
+    template <typename T, ssize_t Dims = -1>
+    detail::unchecked_reference<T, Dims> unchecked_field(ssize_t offset) const & {
+        check_unchecked_layout<Dims, 0>();
+        check_field_offset(offset, sizeof(T));
+        return detail::unchecked_reference<T, Dims>(
+            static_cast<const char *>(data()) + offset, shape(), strides(), ndim());
     }
 
     /// Return a new view with all of the dimensions of length 1 removed
@@ -988,6 +1205,30 @@ protected:
         }
     }
 
+    // The requirements of `unchecked<T, Dims, Layout>()` that the proxy cannot check itself
+    template <ssize_t Dims, int Layout>
+    void check_unchecked_layout() const {
+        static_assert(Layout == 0 || Layout == c_style || Layout == f_style,
+                      "The layout of an unchecked reference must be c_style or f_style");
+        if (Dims >= 0 && ndim() != Dims) {
+            throw std::domain_error("array has incorrect number of dimensions: "
+                                    + std::to_string(ndim()) + "; expected "
+                                    + std::to_string(Dims));
+        }
+        if (Layout != 0 && !detail::check_flags(m_ptr, Layout)) {
+            throw std::domain_error(Layout == c_style ? "array is not C-contiguous"
+                                                      : "array is not Fortran-contiguous");
+        }
+    }
+
+    void check_field_offset(ssize_t offset, size_t size) const {
+        if (offset < 0 || offset + static_cast<ssize_t>(size) > itemsize()) {
+            throw std::domain_error("field at offset " + std::to_string(offset)
+                                    + " does not fit in items of size "
+                                    + std::to_string(itemsize()));
+        }
+    }
+
     template <typename... Ix>
     void check_dimensions(Ix... index) const {
         check_dimensions_impl(ssize_t(0), shape(), ssize_t(index)...);
@@ -1005,6 +1246,35 @@ protected:
         check_dimensions_impl(axis + 1, shape + 1, index...);
     }
 
+    // Copies `src` into a new array in the same order.  Large contiguous copies of plain data are
+    // done with the GIL released: `src` and the new array keep both buffers alive meanwhile.
+    static array copy_of(const array &src) {
+        auto dt = src.dtype();
+        bool c_contiguous = detail::check_flags(src.ptr(), c_style);
+        if (!(c_contiguous || detail::check_flags(src.ptr(), f_style))
+            || src.nbytes() < PYBIND11_NUMPY_COPY_WITHOUT_GIL_THRESHOLD
+            || dt.kind() == 'O' || dt.has_fields()) {
+            auto result = reinterpret_steal<array>(
+                detail::npy_api::get().PyArray_NewCopy_(src.ptr(), -1 /* any order */));
+            if (!result) {
+                throw error_already_set();
+            }
+            return result;
+        }
+        std::vector<ssize_t> shape(src.shape(), src.shape() + src.ndim());
+        auto strides = c_contiguous ? detail::c_strides(shape, dt.itemsize())
+                                    : detail::f_strides(shape, dt.itemsize());
+        array result(dt, std::move(shape), std::move(strides));
+        void *dst = result.mutable_data();
+        const void *data = src.data();
+        auto nbytes = static_cast<size_t>(src.nbytes());
+        {
+            gil_scoped_release release;
+            std::memcpy(dst, data, nbytes);
+        }
+        return result;
+    }
+
     /// Create array from any object -- always returns a new reference
     static PyObject *raw_array(PyObject *ptr, int ExtraFlags = 0) {
         if (ptr == nullptr) {
@@ -1016,6 +1286,130 @@ protected:
     }
 };
 
+PYBIND11_NAMESPACE_BEGIN(detail)
+
+/// Memory obtained from an allocator, owned by a capsule that is the base object of the arrays
+/// using it
+template <typename Allocator>
+struct allocator_owned_data {
+    using traits = std::allocator_traits<Allocator>;
+
+    allocator_owned_data(const Allocator &alloc, size_t count)
+        : alloc(alloc), data(traits::allocate(this->alloc, count)), count(count) {}
+    ~allocator_owned_data() { traits::deallocate(alloc, data, count); }
+    allocator_owned_data(const allocator_owned_data &) = delete;
+    allocator_owned_data &operator=(const allocator_owned_data &) = delete;
+
+    Allocator alloc;
+    typename traits::pointer data;
+    size_t count;
+};
+
+/// Returns a capsule that deletes `owner` once it is gone, to be the base object of arrays that
+/// view memory held by `owner`
+template <typename Owner>
+capsule owning_capsule(std::unique_ptr<Owner> owner) {
+    capsule result(owner.get(), [](void *p) { delete static_cast<Owner *>(p); });
+    owner.release();
+    return result;
+}
+
+/// The allocator behind `py::aligned`. It over-allocates with `std::malloc`, and keeps the pointer
+/// to free just before the aligned block.
+template <typename T, size_t Alignment>
+struct aligned_allocator {
+    using value_type = T;
+    template <typename U>
+    struct rebind {
+        using other = aligned_allocator<U, Alignment>;
+    };
+
+    explicit aligned_allocator(bool huge_pages = false) : huge_pages(huge_pages) {}
+    template <typename U>
+    explicit aligned_allocator(const aligned_allocator<U, Alignment> &other)
+        : huge_pages(other.huge_pages) {}
+
+    T *allocate(size_t n) {
+        const size_t huge_page_size = size_t(1) << 21;
+        size_t alignment = std::max({Alignment, alignof(T), alignof(void *)});
+        if (huge_pages) {
+            alignment = std::max(alignment, huge_page_size);
+        }
+        const size_t overhead = 2 * alignment + sizeof(void *);
+        if (n > (static_cast<size_t>(-1) - overhead) / sizeof(T)) {
+            throw std::bad_alloc();
+        }
+        size_t bytes = n * sizeof(T);
+        if (huge_pages) {
+            bytes = (bytes + huge_page_size - 1) & ~(huge_page_size - 1);
+        }
+        void *raw = std::malloc(bytes + alignment - 1 + sizeof(void *));
+        if (raw == nullptr) {
+            throw std::bad_alloc();
+        }
+        const auto first = reinterpret_cast<std::uintptr_t>(raw) + sizeof(void *);
+        const auto address = (first + alignment - 1) & ~static_cast<std::uintptr_t>(alignment - 1);
+        void *result = reinterpret_cast<void *>(address);
+        static_cast<void **>(result)[-1] = raw;
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+        if (huge_pages) {
+            // Only a hint; the memory is usable either way
+            (void) madvise(result, bytes, MADV_HUGEPAGE);
+        }
+#endif
+        return static_cast<T *>(result);
+    }
+
+    void deallocate(T *p, size_t) { std::free(reinterpret_cast<void **>(p)[-1]); }
+
+    bool huge_pages;
+};
+
+#if defined(PYBIND11_NUMPY_HAS_MMAP)
+/// A mapping of (part of) a file into memory, unmapped on destruction
+struct mapped_file {
+    mapped_file(void *address, size_t length) : address(address), length(length) {}
+    ~mapped_file() { (void) munmap(address, length); }
+    mapped_file(const mapped_file &) = delete;
+    mapped_file &operator=(const mapped_file &) = delete;
+
+    void *address;
+    size_t length;
+};
+
+// Sets the Python error from `errno` for an operation on `path` and throws it
+[[noreturn]] inline void throw_errno(const std::string &path) {
+    PyErr_SetFromErrnoWithFilename(PyExc_OSError, path.c_str());
+    throw error_already_set();
+}
+#endif
+
+PYBIND11_NAMESPACE_END(detail)
+
+/// How `array_t::mmap()` maps the file, as the modes of `numpy.memmap`
+enum class mmap_mode {
+    /// Read-only ("r"): the array is not writeable
+    read_only,
+    /// Read-write ("r+"): writes to the array go to the file
+    read_write,
+    /// Copy-on-write ("c"): the array is writeable, but writes never reach the file
+    copy_on_write
+};
+
+/// Access pattern hints for `array_t::mmap()`, passed to `posix_madvise`
+enum class mmap_advice { normal, sequential, random, will_need };
+
+/// Allocation option for `array_t` constructors: aligns the data to `Alignment` bytes (a power of
+/// two), e.g. for aligned SIMD loads. With `huge_pages`, the data is placed in whole 2 MiB pages,
+/// which on Linux are also marked for transparent huge pages.
+template <size_t Alignment>
+struct aligned {
+    static_assert(Alignment != 0 && (Alignment & (Alignment - 1)) == 0,
+                  "The alignment must be a power of two");
+    bool huge_pages;
+    explicit aligned(bool huge_pages = false) : huge_pages(huge_pages) {}
+};
+
 template <typename T, int ExtraFlags = array::forcecast>
 class array_t : public array {
 private:
@@ -1073,6 +1467,168 @@ public:
     explicit array_t(ssize_t count, const T *ptr = nullptr, handle base = handle())
         : array({count}, {}, ptr, base) {}
 
+    /// Creates an array with uninitialized, aligned data; see `py::aligned` and `allocate()`
+    template <size_t Alignment>
+    array_t(ShapeContainer shape, aligned<Alignment> option)
+        : array_t(allocate(std::move(shape),
+                           detail::aligned_allocator<T, Alignment>(option.huge_pages))) {}
+
+    /**
+     * Creates an array of the given shape (in Fortran order if `ExtraFlags` includes `f_style`)
+     * whose data is allocated by `alloc`, e.g. an arena, a hugepage allocator or a pinned-memory
+     * pool; it may be an allocator of any type, it is rebound to `T`. As with `numpy.empty`, the
+     * elements are left uninitialized. NumPy uses the memory in place, and it is released through
+     * the allocator once the array and all views of it are gone.
+     */
+    template <typename Allocator>
+    static array_t allocate(ShapeContainer shape, const Allocator &alloc = Allocator()) {
+        using rebound = typename std::allocator_traits<Allocator>::template rebind_alloc<T>;
+        using owned_data = detail::allocator_owned_data<rebound>;
+        ssize_t count = 1;
+        for (auto extent : *shape) {
+            count = count < 0 || extent < 0 ? -1 : count * extent;
+        }
+        if (count <= 0) {
+            // Nothing to allocate, or an invalid shape that NumPy reports as usual
+            return array_t(std::move(shape));
+        }
+        std::unique_ptr<owned_data> owned(
+            new owned_data(rebound(alloc), static_cast<size_t>(count)));
+        const T *ptr = std::addressof(*owned->data);
+        return array_t(std::move(shape), ptr, detail::owning_capsule(std::move(owned)));
+    }
+
+    /**
+     * Creates an array that takes over the elements of `data` instead of copying them: the
+     * vector is moved into the base object of the array, and destroyed once the array and all
+     * views of it are gone. `shape` defaults to `{data.size()}`, and must describe exactly
+     * `data.size()` elements, which are laid out as selected by `ExtraFlags`.
+     */
+    template <typename Alloc>
+    static array_t from_vector(std::vector<T, Alloc> &&data) {
+        const auto size = static_cast<ssize_t>(data.size());
+        return from_vector(std::move(data), {size});
+    }
+
+    template <typename Alloc>
+    static array_t from_vector(std::vector<T, Alloc> &&data, ShapeContainer shape) {
+        static_assert(!std::is_same<T, bool>::value,
+                      "std::vector<bool> does not store its elements as bool");
+        ssize_t count = 1;
+        for (auto extent : *shape) {
+            count = count < 0 || extent < 0 ? -1 : count * extent;
+        }
+        if (count != static_cast<ssize_t>(data.size())) {
+            throw value_error("array_t::from_vector(): the shape does not match the size of "
+                              "the vector");
+        }
+        std::unique_ptr<std::vector<T, Alloc>> owned(new std::vector<T, Alloc>(std::move(data)));
+        const T *ptr = owned->data();
+        return array_t(std::move(shape), ptr, detail::owning_capsule(std::move(owned)));
+    }
+
+    /**
+     * Creates an array that takes ownership of the elements at `data`, which must hold all the
+     * elements given by `shape` and `strides` (by default, laid out as selected by `ExtraFlags`).
+     * They are released with the deleter of `data` once the array and all views of it are gone.
+     */
+    template <typename Deleter>
+    static array_t from_unique_ptr(std::unique_ptr<T[], Deleter> data,
+                                   ShapeContainer shape,
+                                   StridesContainer strides = {}) {
+        if (strides->empty()) {
+            *strides = (ExtraFlags & f_style) != 0 ? detail::f_strides(*shape, sizeof(T))
+                                                   : detail::c_strides(*shape, sizeof(T));
+        }
+        const T *ptr = data.get();
+        std::unique_ptr<std::unique_ptr<T[], Deleter>> owned(
+            new std::unique_ptr<T[], Deleter>(std::move(data)));
+        return array_t(std::move(shape),
+                       std::move(strides),
+                       ptr,
+                       detail::owning_capsule(std::move(owned)));
+    }
+
+#if defined(PYBIND11_NUMPY_HAS_MMAP)
+    /**
+     * Creates an array of the given shape (in Fortran order if `ExtraFlags` includes `f_style`)
+     * whose data is the file at `path`, starting `offset` bytes in, mapped into memory like with
+     * `numpy.memmap`. The file is unmapped once the array and all views of it are gone. Throws
+     * `OSError` if the file cannot be opened or mapped, and `value_error` if it is too small.
+     * Only available on POSIX systems (where `PYBIND11_NUMPY_HAS_MMAP` is defined).
+     */
+    static array_t mmap(const std::string &path,
+                        ShapeContainer shape,
+                        mmap_mode mode = mmap_mode::read_only,
+                        ssize_t offset = 0,
+                        mmap_advice advice = mmap_advice::normal) {
+        ssize_t count = 1;
+        for (auto extent : *shape) {
+            count = count < 0 || extent < 0 ? -1 : count * extent;
+        }
+        if (offset < 0) {
+            throw value_error("array_t::mmap(): the offset must not be negative");
+        }
+        array_t result;
+        if (count <= 0) {
+            // Nothing to map (empty files cannot be mapped), or an invalid shape that NumPy
+            // reports as usual
+            result = array_t(std::move(shape));
+        } else {
+            const int fd = ::open(path.c_str(), mode == mmap_mode::read_write ? O_RDWR : O_RDONLY);
+            if (fd < 0) {
+                detail::throw_errno(path);
+            }
+            struct stat info {};
+            if (fstat(fd, &info) != 0) {
+                const int error = errno;
+                (void) ::close(fd);
+                errno = error;
+                detail::throw_errno(path);
+            }
+            const auto bytes = static_cast<size_t>(count) * sizeof(T);
+            if (static_cast<size_t>(info.st_size) < static_cast<size_t>(offset)
+                || static_cast<size_t>(info.st_size) - static_cast<size_t>(offset) < bytes) {
+                (void) ::close(fd);
+                throw value_error("array_t::mmap(): the file is too small for the shape");
+            }
+            // The mapping itself has to start at a multiple of the page size
+            const auto page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+            const size_t start = static_cast<size_t>(offset) / page * page;
+            const size_t length = static_cast<size_t>(offset) - start + bytes;
+            void *address = ::mmap(nullptr,
+                                   length,
+                                   mode == mmap_mode::read_only ? PROT_READ
+                                                                : PROT_READ | PROT_WRITE,
+                                   mode == mmap_mode::copy_on_write ? MAP_PRIVATE : MAP_SHARED,
+                                   fd,
+                                   static_cast<off_t>(start));
+            const int error = errno;
+            (void) ::close(fd);
+            if (address == MAP_FAILED) {
+                errno = error;
+                detail::throw_errno(path);
+            }
+            std::unique_ptr<detail::mapped_file> owned(new detail::mapped_file(address, length));
+            if (advice != mmap_advice::normal) {
+                // Only a hint; the mapping is usable either way
+                (void) posix_madvise(address,
+                                     length,
+                                     advice == mmap_advice::sequential ? POSIX_MADV_SEQUENTIAL
+                                     : advice == mmap_advice::random   ? POSIX_MADV_RANDOM
+                                                                       : POSIX_MADV_WILLNEED);
+            }
+            const T *ptr = reinterpret_cast<const T *>(static_cast<const char *>(address)
+                                                       + (static_cast<size_t>(offset) - start));
+            result = array_t(std::move(shape), ptr, detail::owning_capsule(std::move(owned)));
+        }
+        if (mode == mmap_mode::read_only) {
+            detail::array_proxy(result.ptr())->flags &= ~detail::npy_api::NPY_ARRAY_WRITEABLE_;
+        }
+        return result;
+    }
+#endif
+
     constexpr ssize_t itemsize() const { return sizeof(T); }
 
     template <typename... Ix>
@@ -1116,9 +1672,9 @@ public:
      * care: the array must not be destroyed or reshaped for the duration of the returned object,
      * and the caller must take care not to access invalid dimensions or dimension indices.
      */
-    template <ssize_t Dims = -1>
-    detail::unchecked_mutable_reference<T, Dims> mutable_unchecked() & {
-        return array::mutable_unchecked<T, Dims>();
+    template <ssize_t Dims = -1, int Layout = 0>
+    detail::unchecked_mutable_reference_t<T, Dims, Layout> mutable_unchecked() & {
+        return array::mutable_unchecked<T, Dims, Layout>();
     }
 
     /**
@@ -1128,14 +1684,35 @@ public:
      * or reshaped for the duration of the returned object, and the caller must take care not to
      * access invalid dimensions or dimension indices.
      */
-    template <ssize_t Dims = -1>
-    detail::unchecked_reference<T, Dims> unchecked() const & {
-        return array::unchecked<T, Dims>();
+    template <ssize_t Dims = -1, int Layout = 0>
+    detail::unchecked_reference_t<T, Dims, Layout> unchecked() const & {
+        return array::unchecked<T, Dims, Layout>();
+    }
+
+    /**
+     * Returns a proxy object like `mutable_unchecked()` for the member `member` of the elements,
+     * e.g. `a.mutable_unchecked_field<1>(&Point::x)`, so that a loop over a single member of a
+     * structured array does not have to go through the whole elements.
+     */
+    template <ssize_t Dims = -1, typename F, typename C>
+    detail::unchecked_mutable_reference<F, Dims> mutable_unchecked_field(F C::*member) & {
+        static_assert(std::is_same<C, T>::value, "member must belong to the element type");
+        return array::mutable_unchecked_field<F, Dims>(detail::member_offset<T>(member));
+    }
+
+    /// Returns a proxy object like `unchecked()` for the member `member` of the elements
+    template <ssize_t Dims = -1, typename F, typename C>
+    detail::unchecked_reference<F, Dims> unchecked_field(F C::*member) const & {
+        static_assert(std::is_same<C, T>::value, "member must belong to the element type");
+        return array::unchecked_field<F, Dims>(detail::member_offset<T>(member));
     }
 
     /// Ensure that the argument is a NumPy array of the correct dtype (and if not, try to convert
     /// it).  In case of an error, nullptr is returned and the Python error is cleared.
     static array_t ensure(handle h) {
+        if (check_exact_(h)) {
+            return reinterpret_borrow<array_t>(h);
+        }
         auto result = reinterpret_steal<array_t>(raw_array_t(h.ptr()));
         if (!result) {
             PyErr_Clear();
@@ -1144,14 +1721,27 @@ public:
     }
 
     static bool check_(handle h) {
+        if (check_exact_(h)) {
+            return true;
+        }
         const auto &api = detail::npy_api::get();
         return api.PyArray_Check_(h.ptr())
-               && api.PyArray_EquivTypes_(detail::array_proxy(h.ptr())->descr,
-                                          dtype::of<T>().ptr())
+               && detail::equivalent_dtypes(detail::array_proxy(h.ptr())->descr,
+                                            dtype::of<T>().ptr())
                && detail::check_flags(h.ptr(), ExtraFlags & (array::c_style | array::f_style));
     }
 
 protected:
+    // Fast path of `check_()` for an exact `numpy.ndarray` of the builtin dtype of `T`: only
+    // compares integers, without creating references or calling into NumPy. A `false` result
+    // does not mean that the array does not match.
+    static bool check_exact_(handle h) {
+        constexpr int type_num = detail::npy_builtin_type_num<T>::value;
+        return type_num >= 0 && h && Py_TYPE(h.ptr()) == detail::npy_api::get().PyArray_Type_
+               && detail::is_native_builtin_descr(detail::array_proxy(h.ptr())->descr, type_num)
+               && detail::check_flags(h.ptr(), ExtraFlags & (array::c_style | array::f_style));
+    }
+
     /// Create array from any object -- always returns a new reference
     static PyObject *raw_array_t(PyObject *ptr) {
         if (ptr == nullptr) {
@@ -1168,6 +1758,65 @@ protected:
     }
 };
 
+/// Copies each field of the structured array `a` into a C-contiguous array of the same shape,
+/// so that the values of a field are next to each other in memory. Returns a dict from the
+/// field names to these arrays, in the order of the fields of the dtype.
+inline dict to_columns(const array &a) {
+    if (!a.dtype().has_fields()) {
+        throw std::domain_error("to_columns(): array does not have a structured dtype");
+    }
+    auto &api = detail::npy_api::get();
+    dict columns;
+    for (handle name : a.dtype().attr("names")) {
+        object field = a[name];
+        auto column = reinterpret_steal<array>(api.PyArray_NewCopy_(field.ptr(), 0 /* C order */));
+        if (!column) {
+            throw error_already_set();
+        }
+        columns[name] = std::move(column);
+    }
+    return columns;
+}
+
+/// The inverse of `to_columns()`: creates a C-contiguous structured array of the dtype `dt`, with
+/// the shape of the columns, and copies each column into its field. `columns` maps the names of
+/// all fields of `dt` to arrays, which are converted to the types of the fields.
+inline array from_columns(const dict &columns, const pybind11::dtype &dt) {
+    if (!dt.has_fields()) {
+        throw std::domain_error("from_columns(): dtype is not structured");
+    }
+    tuple names = dt.attr("names");
+    std::vector<array> fields;
+    for (handle name : names) {
+        auto column = array::ensure(columns[name]);
+        if (!column) {
+            throw value_error("from_columns(): column \"" + str(name).cast<std::string>()
+                              + "\" is not an array");
+        }
+        fields.push_back(std::move(column));
+    }
+    if (fields.empty()) {
+        throw std::domain_error("from_columns(): dtype does not have any fields");
+    }
+
+    const auto &first = fields.front();
+    array result(dt, std::vector<ssize_t>(first.shape(), first.shape() + first.ndim()));
+    auto &api = detail::npy_api::get();
+    for (size_t i = 0; i < fields.size(); ++i) {
+        object field = result[names[i]];
+        if (api.PyArray_CopyInto_(field.ptr(), fields[i].ptr()) < 0) {
+            throw error_already_set();
+        }
+    }
+    return result;
+}
+
+/// `from_columns()` for the dtype of `T`, registered with `PYBIND11_NUMPY_DTYPE`
+template <typename T>
+array_t<T> from_columns(const dict &columns) {
+    return reinterpret_steal<array_t<T>>(from_columns(columns, dtype::of<T>()).release());
+}
+
 template <typename T>
 struct format_descriptor<T, detail::enable_if_t<detail::is_pod_struct<T>::value>> {
     static std::string format() {
@@ -1207,7 +1856,13 @@ struct pyobject_caster<array_t<T, ExtraFlags>> {
     using type = array_t<T, ExtraFlags>;
 
     bool load(handle src, bool convert) {
-        if (!convert && !type::check_(src)) {
+        if (type::check_(src)) {
+            // `ensure()` would return such an array as it is, after checking it all over again
+            if (Py_TYPE(src.ptr()) == npy_api::get().PyArray_Type_) {
+                value = reinterpret_borrow<type>(src);
+                return true;
+            }
+        } else if (!convert) {
             return false;
         }
         value = type::ensure(src);
@@ -1223,7 +1878,7 @@ struct pyobject_caster<array_t<T, ExtraFlags>> {
 template <typename T>
 struct compare_buffer_info<T, detail::enable_if_t<detail::is_pod_struct<T>::value>> {
     static bool compare(const buffer_info &b) {
-        return npy_api::get().PyArray_EquivTypes_(dtype::of<T>().ptr(), dtype(b).ptr());
+        return equivalent_dtypes(dtype::of<T>().ptr(), dtype(b).ptr());
     }
 };
 
@@ -1417,8 +2072,10 @@ PYBIND11_NOINLINE void register_structured_dtype(any_container<field_descriptor>
     }
 
     auto tindex = std::type_index(tinfo);
-    numpy_internals.registered_dtypes[tindex] = {dtype_ptr, std::move(format_str)};
-    get_internals().direct_conversions[tindex].push_back(direct_converter);
+    with_internals([&](internals &internals) {
+        numpy_internals.registered_dtypes[tindex] = {dtype_ptr, std::move(format_str)};
+        internals.direct_conversions[tindex].push_back(direct_converter);
+    });
 }
 
 template <typename T, typename SFINAE>
@@ -1454,7 +2111,7 @@ private:
             return false;
         }
         if (auto descr = reinterpret_steal<object>(api.PyArray_DescrFromScalar_(obj))) {
-            if (api.PyArray_EquivTypes_(dtype_ptr(), descr.ptr())) {
+            if (equivalent_dtypes(dtype_ptr(), descr.ptr())) {
                 value = ((PyVoidScalarObject_Proxy *) obj)->obval;
                 return true;
             }
@@ -1561,6 +2218,12 @@ public:
 
     void increment(size_type dim) { p_ptr += m_strides[dim]; }
 
+    /// Advances by `n` steps along the last dimension
+    void advance_last(value_type n) { p_ptr += n * m_strides.back(); }
+
+    /// The stride along the last dimension (the one that varies fastest)
+    value_type last_stride() const { return m_strides.back(); }
+
     void *data() const { return p_ptr; }
 
 private:
@@ -1573,13 +2236,21 @@ class multi_array_iterator {
 public:
     using container_type = std::vector<ssize_t>;
 
-    multi_array_iterator(const std::array<buffer_info, N> &buffers, const container_type &shape)
+    /// Starts at the element with the given (C order) linear index
+    multi_array_iterator(const std::array<buffer_info, N> &buffers,
+                         const container_type &shape,
+                         size_t start = 0)
         : m_shape(shape.size()), m_index(shape.size(), 0), m_common_iterator() {
 
         // Manual copy to avoid conversion warning if using std::copy
         for (size_t i = 0; i < shape.size(); ++i) {
             m_shape[i] = shape[i];
         }
+        for (size_t j = shape.size(); j != 0 && start != 0; --j) {
+            const auto extent = static_cast<size_t>(shape[j - 1]);
+            m_index[j - 1] = static_cast<ssize_t>(start % extent);
+            start /= extent;
+        }
 
         container_type strides(shape.size());
         for (size_t i = 0; i < N; ++i) {
@@ -1599,11 +2270,28 @@ public:
         return *this;
     }
 
+    /// Moves to the first element of the next row, i.e. the next value of all indices but the
+    /// last one
+    multi_array_iterator &next_row() {
+        const size_t last = m_index.size() - 1;
+        for (auto &iter : m_common_iterator) {
+            iter.advance_last(m_shape[last] - 1 - m_index[last]);
+        }
+        m_index[last] = m_shape[last] - 1;
+        return ++*this;
+    }
+
     template <size_t K, class T = void>
     T *data() const {
         return reinterpret_cast<T *>(m_common_iterator[K].data());
     }
 
+    /// The stride of buffer `K` along the last dimension; 0 if it is broadcast along it
+    template <size_t K>
+    ssize_t last_stride() const {
+        return m_common_iterator[K].last_stride();
+    }
+
 private:
     using common_iter = common_iterator;
 
@@ -1630,7 +2318,11 @@ private:
         }
 
         std::fill(strides_iter, strides.rend(), 0);
-        iterator = common_iter(buffer.ptr, strides, shape);
+        auto *ptr = static_cast<char *>(buffer.ptr);
+        for (size_t i = 0; i < m_index.size(); ++i) {
+            ptr += m_index[i] * strides[i];
+        }
+        iterator = common_iter(ptr, strides, shape);
     }
 
     void increment_common_iterator(size_t dim) {
@@ -1736,6 +2428,189 @@ broadcast(const std::array<buffer_info, N> &buffers, ssize_t &ndim, std::vector<
                                  : broadcast_trivial::non_trivial;
 }
 
+PYBIND11_NAMESPACE_END(detail)
+
+/**
+ * Loops over the elements of `N` arrays broadcast against each other, like the inner loops of
+ * NumPy ufuncs. The elements are visited in chunks: runs of elements along which every operand
+ * advances by a fixed byte stride (0 where it is broadcast). Dimensions are reordered to follow
+ * the memory layout and merged where possible, so that e.g. operands that are all C-contiguous
+ * or all Fortran-contiguous are visited in a single chunk. For conversions, pass `array_t`
+ * operands, which cast their input (with `forcecast`) when they are created.
+ *
+ * The loop itself does not involve Python, so it can run without the GIL. The chunks point to
+ * mutable data, but the iterator does not check that operands are writeable.
+ */
+template <size_t N>
+class nditer {
+public:
+    struct chunk {
+        /// The first element of the chunk in each operand
+        std::array<char *, N> data;
+        /// The byte strides of the operands along the chunk
+        std::array<ssize_t, N> strides;
+        /// The number of elements in the chunk
+        ssize_t size;
+
+        /// Element `i` of the chunk in operand `K`
+        template <size_t K, typename T>
+        T &at(ssize_t i) const {
+            return *reinterpret_cast<T *>(std::get<K>(data) + i * std::get<K>(strides));
+        }
+    };
+
+    /// Throws `value_error` if the shapes of the operands cannot be broadcast together
+    explicit nditer(std::array<array, N> operands) : m_operands(std::move(operands)) {
+        ssize_t ndim = 0;
+        for (const auto &op : m_operands) {
+            ndim = std::max(ndim, op.ndim());
+        }
+        m_shape.assign(static_cast<size_t>(ndim), 1);
+        for (const auto &op : m_operands) {
+            for (ssize_t d = 0; d < op.ndim(); ++d) {
+                const ssize_t extent = op.shape(d);
+                auto &out = m_shape[static_cast<size_t>(ndim - op.ndim() + d)];
+                if (out == 1) {
+                    out = extent;
+                } else if (extent != 1 && extent != out) {
+                    throw value_error("operands could not be broadcast together");
+                }
+            }
+        }
+
+        // Byte strides of each operand along every dimension of the broadcast shape
+        std::array<std::vector<ssize_t>, N> strides;
+        for (size_t k = 0; k < N; ++k) {
+            const auto &op = m_operands[k];
+            strides[k].assign(m_shape.size(), 0);
+            for (ssize_t d = 0; d < op.ndim(); ++d) {
+                if (op.shape(d) != 1) {
+                    strides[k][static_cast<size_t>(ndim - op.ndim() + d)] = op.strides(d);
+                }
+            }
+        }
+
+        // Order the dimensions from the largest to the smallest stride, judged by the first
+        // operand that is not broadcast along either of the two dimensions compared
+        std::vector<size_t> order;
+        for (size_t d = 0; d < m_shape.size(); ++d) {
+            if (m_shape[d] == 0) {
+                m_empty = true;
+            }
+            if (m_shape[d] != 1) {
+                order.push_back(d);
+            }
+        }
+        for (size_t i = 1; i < order.size(); ++i) {
+            for (size_t j = i; j > 0 && is_inner(strides, order[j - 1], order[j]); --j) {
+                std::swap(order[j - 1], order[j]);
+            }
+        }
+
+        // Merge each dimension into the next inner one if the strides allow that for every
+        // operand; the loop dimensions are stored from the innermost one outwards
+        for (auto it = order.rbegin(); it != order.rend(); ++it) {
+            const size_t d = *it;
+            bool merge = !m_loop_shape.empty();
+            for (size_t k = 0; k < N && merge; ++k) {
+                merge = strides[k][d] == m_loop_strides[k].back() * m_loop_shape.back();
+            }
+            if (merge) {
+                m_loop_shape.back() *= m_shape[d];
+            } else {
+                m_loop_shape.push_back(m_shape[d]);
+                for (size_t k = 0; k < N; ++k) {
+                    m_loop_strides[k].push_back(strides[k][d]);
+                }
+            }
+        }
+        if (m_loop_shape.empty()) {
+            m_loop_shape.push_back(1);
+            for (auto &s : m_loop_strides) {
+                s.push_back(0);
+            }
+        }
+    }
+
+    /// The broadcast shape of the operands
+    const std::vector<ssize_t> &shape() const { return m_shape; }
+
+    /// The number of elements visited
+    ssize_t size() const {
+        return std::accumulate(
+            m_shape.begin(), m_shape.end(), (ssize_t) 1, std::multiplies<ssize_t>());
+    }
+
+    /// Calls `f(const chunk &)` for every chunk
+    template <typename Func>
+    void for_each(Func &&f) const {
+        if (m_empty) {
+            return;
+        }
+        chunk c;
+        for (size_t k = 0; k < N; ++k) {
+            c.data[k] = static_cast<char *>(const_cast<void *>(m_operands[k].data()));
+            c.strides[k] = m_loop_strides[k][0];
+        }
+        c.size = m_loop_shape[0];
+        const size_t loop_ndim = m_loop_shape.size();
+        std::vector<ssize_t> index(loop_ndim, 0);
+        for (;;) {
+            f(static_cast<const chunk &>(c));
+            size_t d = 1;
+            for (; d < loop_ndim; ++d) {
+                for (size_t k = 0; k < N; ++k) {
+                    c.data[k] += m_loop_strides[k][d];
+                }
+                if (++index[d] != m_loop_shape[d]) {
+                    break;
+                }
+                for (size_t k = 0; k < N; ++k) {
+                    c.data[k] -= m_loop_strides[k][d] * m_loop_shape[d];
+                }
+                index[d] = 0;
+            }
+            if (d == loop_ndim) {
+                return;
+            }
+        }
+    }
+
+    /// Like `for_each()`, with the GIL released; `f` must not use Python
+    template <typename Func>
+    void for_each_without_gil(Func &&f) const {
+        gil_scoped_release release;
+        for_each(std::forward<Func>(f));
+    }
+
+private:
+    // Whether dimension `inner` should be looped over inside dimension `outer`
+    static bool
+    is_inner(const std::array<std::vector<ssize_t>, N> &strides, size_t inner, size_t outer) {
+        for (const auto &s : strides) {
+            if (s[inner] != 0 && s[outer] != 0) {
+                return std::abs(s[inner]) < std::abs(s[outer]);
+            }
+        }
+        return false;
+    }
+
+    std::array<array, N> m_operands;
+    std::vector<ssize_t> m_shape;
+    bool m_empty = false;
+    std::vector<ssize_t> m_loop_shape;
+    std::array<std::vector<ssize_t>, N> m_loop_strides;
+};
+
+/// Option for `py::vectorize`: splits the elements between `threads` threads (by default, one
+/// per hardware thread), which call the function without holding the GIL
+struct parallel {
+    size_t threads;
+    explicit parallel(size_t threads = 0) : threads(threads) {}
+};
+
+PYBIND11_NAMESPACE_BEGIN(detail)
+
 template <typename T>
 struct vectorize_arg {
     static_assert(!std::is_rvalue_reference<T>::value,
@@ -1815,6 +2690,15 @@ public:
                   !std::is_same<vectorize_helper, typename std::decay<T>::type>::value>>
     explicit vectorize_helper(T &&f) : f(std::forward<T>(f)) {}
 
+    template <typename T,
+              typename = detail::enable_if_t<
+                  !std::is_same<vectorize_helper, typename std::decay<T>::type>::value>>
+    vectorize_helper(T &&f, parallel p) : f(std::forward<T>(f)) {
+        static_assert(!any_of<is_pyobject<intrinsic_t<Args>>...>::value,
+                      "py::parallel() requires a function without Python object arguments");
+        m_threads = p.threads != 0 ? p.threads : std::thread::hardware_concurrency();
+    }
+
     object operator()(typename vectorize_arg<Args>::type... args) {
         return run(args...,
                    make_index_sequence<N>(),
@@ -1824,6 +2708,10 @@ public:
 
 private:
     remove_reference_t<Func> f;
+    // The maximum number of threads to use, if parallel() was requested
+    size_t m_threads = 1;
+    // Threads are only started for at least this many elements each
+    static constexpr size_t min_elements_per_thread = 4096;
 
     // Internal compiler error in MSVC 19.16.27025.1 (Visual Studio 2017 15.9.4), when compiling
     // with "/permissive-" flag when arg_call_types is manually inlined.
@@ -1885,25 +2773,134 @@ private:
 
         /* Call the function */
         auto *mutable_data = returned_array::mutable_data(result);
-        if (trivial == broadcast_trivial::non_trivial) {
-            apply_broadcast(buffers, params, mutable_data, size, shape, i_seq, vi_seq, bi_seq);
+        const size_t threads
+            = std::min(m_threads, std::max(size / min_elements_per_thread, size_t(1)));
+        if (threads > 1) {
+            apply_parallel(threads,
+                           trivial,
+                           buffers,
+                           params,
+                           mutable_data,
+                           size,
+                           shape,
+                           i_seq,
+                           vi_seq,
+                           bi_seq);
         } else {
-            apply_trivial(buffers, params, mutable_data, size, i_seq, vi_seq, bi_seq);
+            apply(trivial, buffers, params, mutable_data, 0, size, shape, i_seq, vi_seq, bi_seq);
         }
 
         return result;
         PYBIND11_WARNING_POP
     }
 
+    // Calls the function for the elements [begin, end) of the output
+    template <size_t... Index, size_t... VIndex, size_t... BIndex>
+    void apply(broadcast_trivial trivial,
+               const std::array<buffer_info, NVectorized> &buffers,
+               std::array<void *, N> &params,
+               Return *out,
+               size_t begin,
+               size_t end,
+               const std::vector<ssize_t> &output_shape,
+               index_sequence<Index...> i_seq,
+               index_sequence<VIndex...> vi_seq,
+               index_sequence<BIndex...> bi_seq) {
+        if (trivial == broadcast_trivial::non_trivial) {
+            apply_broadcast(
+                buffers, params, out, begin, end, output_shape, i_seq, vi_seq, bi_seq);
+        } else {
+            apply_trivial(buffers, params, out, begin, end, i_seq, vi_seq, bi_seq);
+        }
+    }
+
+    // Splits the output into one contiguous range per thread. Exceptions are caught in the
+    // threads, and the first one is rethrown once they are all done and the GIL is held again.
+    template <size_t... Index, size_t... VIndex, size_t... BIndex>
+    void apply_parallel(size_t threads,
+                        broadcast_trivial trivial,
+                        const std::array<buffer_info, NVectorized> &buffers,
+                        const std::array<void *, N> &params,
+                        Return *out,
+                        size_t size,
+                        const std::vector<ssize_t> &output_shape,
+                        index_sequence<Index...> i_seq,
+                        index_sequence<VIndex...> vi_seq,
+                        index_sequence<BIndex...> bi_seq) {
+        const size_t chunk = (size + threads - 1) / threads;
+        std::vector<std::exception_ptr> errors(threads);
+        auto work = [&](size_t t) {
+            try {
+                // Each thread advances its own copy of the argument pointers
+                std::array<void *, N> thread_params = params;
+                apply(trivial,
+                      buffers,
+                      thread_params,
+                      out,
+                      t * chunk,
+                      std::min(size, (t + 1) * chunk),
+                      output_shape,
+                      i_seq,
+                      vi_seq,
+                      bi_seq);
+            } catch (...) {
+                errors[t] = std::current_exception();
+            }
+        };
+        {
+            gil_scoped_release release;
+            std::vector<std::thread> workers;
+            workers.reserve(threads - 1);
+            try {
+                for (size_t t = 1; t < threads; ++t) {
+                    workers.emplace_back(work, t);
+                }
+            } catch (...) {
+                for (auto &worker : workers) {
+                    worker.join();
+                }
+                throw;
+            }
+            work(0);
+            for (auto &worker : workers) {
+                worker.join();
+            }
+        }
+        for (const auto &error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+
     template <size_t... Index, size_t... VIndex, size_t... BIndex>
-    void apply_trivial(std::array<buffer_info, NVectorized> &buffers,
+    void apply_trivial(const std::array<buffer_info, NVectorized> &buffers,
                        std::array<void *, N> &params,
                        Return *out,
-                       size_t size,
+                       size_t begin,
+                       size_t end,
                        index_sequence<Index...>,
                        index_sequence<VIndex...>,
                        index_sequence<BIndex...>) {
 
+        // Without singletons, every pointer advances by the size of its element, which is known
+        // at compile time; this gives a loop that the compiler can unroll or vectorize.
+        bool any_singleton = false;
+        for (const auto &buffer : buffers) {
+            any_singleton = any_singleton || buffer.size == 1;
+        }
+        if (!any_singleton) {
+            const std::array<unsigned char *, NVectorized> data{
+                {static_cast<unsigned char *>(buffers[BIndex].ptr)...}};
+            for (size_t i = begin; i < end; ++i) {
+                PYBIND11_EXPAND_SIDE_EFFECTS(
+                    (params[VIndex] = data[BIndex] + i * sizeof(param_n_t<VIndex>)));
+                returned_array::call(
+                    out, i, f, *reinterpret_cast<param_n_t<Index> *>(params[Index])...);
+            }
+            return;
+        }
+
         // Initialize an array of mutable byte references and sizes with references set to the
         // appropriate pointer in `params`; as we iterate, we'll increment each pointer by its size
         // (except for singletons, which get an increment of 0).
@@ -1911,8 +2908,11 @@ private:
             {std::pair<unsigned char *&, const size_t>(
                 reinterpret_cast<unsigned char *&>(params[VIndex] = buffers[BIndex].ptr),
                 buffers[BIndex].size == 1 ? 0 : sizeof(param_n_t<VIndex>))...}};
+        for (auto &x : vecparams) {
+            x.first += begin * x.second;
+        }
 
-        for (size_t i = 0; i < size; ++i) {
+        for (size_t i = begin; i < end; ++i) {
             returned_array::call(
                 out, i, f, *reinterpret_cast<param_n_t<Index> *>(params[Index])...);
             for (auto &x : vecparams) {
@@ -1922,21 +2922,34 @@ private:
     }
 
     template <size_t... Index, size_t... VIndex, size_t... BIndex>
-    void apply_broadcast(std::array<buffer_info, NVectorized> &buffers,
+    void apply_broadcast(const std::array<buffer_info, NVectorized> &buffers,
                          std::array<void *, N> &params,
                          Return *out,
-                         size_t size,
+                         size_t begin,
+                         size_t end,
                          const std::vector<ssize_t> &output_shape,
                          index_sequence<Index...>,
                          index_sequence<VIndex...>,
                          index_sequence<BIndex...>) {
 
-        multi_array_iterator<NVectorized> input_iter(buffers, output_shape);
-
-        for (size_t i = 0; i < size; ++i, ++input_iter) {
-            PYBIND11_EXPAND_SIDE_EFFECTS((params[VIndex] = input_iter.template data<BIndex>()));
-            returned_array::call(
-                out, i, f, *reinterpret_cast<param_n_t<Index> *>(std::get<Index>(params))...);
+        // Along the last dimension, every input advances by a fixed stride (0 if it is broadcast
+        // along it). Only moving on to the next row needs the general iterator, like the inner
+        // loops of NumPy ufuncs.
+        multi_array_iterator<NVectorized> input_iter(buffers, output_shape, begin);
+        const auto row_size = static_cast<size_t>(output_shape.back());
+        const std::array<ssize_t, NVectorized> strides{
+            {input_iter.template last_stride<BIndex>()...}};
+
+        for (size_t i = begin; i < end; input_iter.next_row()) {
+            std::array<unsigned char *, NVectorized> data{
+                {input_iter.template data<BIndex, unsigned char>()...}};
+            const size_t row_end = std::min(end, (i / row_size + 1) * row_size);
+            for (; i < row_end; ++i) {
+                PYBIND11_EXPAND_SIDE_EFFECTS((params[VIndex] = data[BIndex]));
+                returned_array::call(
+                    out, i, f, *reinterpret_cast<param_n_t<Index> *>(std::get<Index>(params))...);
+                PYBIND11_EXPAND_SIDE_EFFECTS((data[BIndex] += strides[BIndex]));
+            }
         }
     }
 };
@@ -1945,6 +2958,11 @@ template <typename Func, typename Return, typename... Args>
 vectorize_helper<Func, Return, Args...> vectorize_extractor(const Func &f, Return (*)(Args...)) {
     return detail::vectorize_helper<Func, Return, Args...>(f);
 }
+template <typename Func, typename Return, typename... Args>
+vectorize_helper<Func, Return, Args...>
+vectorize_extractor(const Func &f, Return (*)(Args...), parallel p) {
+    return detail::vectorize_helper<Func, Return, Args...>(f, p);
+}
 
 template <typename T, int Flags>
 struct handle_type_name<array_t<T, Flags>> {
@@ -1995,4 +3013,191 @@ Helper vectorize(Return (Class::*f)(Args...) const) {
     return Helper(std::mem_fn(f));
 }
 
+// The same with `py::parallel()`:
+template <typename Return, typename... Args>
+detail::vectorize_helper<Return (*)(Args...), Return, Args...> vectorize(Return (*f)(Args...),
+                                                                          parallel p) {
+    return detail::vectorize_helper<Return (*)(Args...), Return, Args...>(f, p);
+}
+
+template <typename Func, detail::enable_if_t<detail::is_lambda<Func>::value, int> = 0>
+auto vectorize(Func &&f, parallel p)
+    -> decltype(detail::vectorize_extractor(
+        std::forward<Func>(f), (detail::function_signature_t<Func> *) nullptr, p)) {
+    return detail::vectorize_extractor(
+        std::forward<Func>(f), (detail::function_signature_t<Func> *) nullptr, p);
+}
+
+template <typename Return,
+          typename Class,
+          typename... Args,
+          typename Helper = detail::vectorize_helper<
+              decltype(std::mem_fn(std::declval<Return (Class::*)(Args...)>())),
+              Return,
+              Class *,
+              Args...>>
+Helper vectorize(Return (Class::*f)(Args...), parallel p) {
+    return Helper(std::mem_fn(f), p);
+}
+
+template <typename Return,
+          typename Class,
+          typename... Args,
+          typename Helper = detail::vectorize_helper<
+              decltype(std::mem_fn(std::declval<Return (Class::*)(Args...) const>())),
+              Return,
+              const Class *,
+              Args...>>
+Helper vectorize(Return (Class::*f)(Args...) const, parallel p) {
+    return Helper(std::mem_fn(f), p);
+}
+
+PYBIND11_NAMESPACE_BEGIN(detail)
+
+/* As with `make_iterator`, each combination of template arguments is registered as a separate
+ * Python type.
+ */
+template <return_value_policy Policy, typename Iterator, typename Sentinel, typename T>
+struct chunked_iterator_state {
+    Iterator it;
+    Sentinel end;
+    ssize_t chunk_size;
+
+    /// Chunks of pointer ranges are views when returned with `reference_internal`
+    using is_view = bool_constant<std::is_pointer<Iterator>::value
+                                  && std::is_same<Iterator, Sentinel>::value
+                                  && Policy == return_value_policy::reference_internal>;
+    using is_random_access = bool_constant<
+        std::is_same<Iterator, Sentinel>::value
+        && std::is_base_of<std::random_access_iterator_tag,
+                           typename std::iterator_traits<Iterator>::iterator_category>::value>;
+
+    /// Returns the next chunk, or a null object if the range is exhausted. `self` is the Python
+    /// iterator, which views keep alive.
+    object next(handle self) {
+        if (it == end) {
+            return object();
+        }
+        return next(self, is_view{}, is_random_access{});
+    }
+
+private:
+    template <typename RandomAccess>
+    array_t<T> next(handle self, std::true_type, RandomAccess) {
+        const auto n = std::min<ssize_t>(chunk_size, end - it);
+        array_t<T> chunk(n, it, self);
+        if (std::is_const<remove_reference_t<decltype(*it)>>::value) {
+            array_proxy(chunk.ptr())->flags &= ~npy_api::NPY_ARRAY_WRITEABLE_;
+        }
+        it += n;
+        return chunk;
+    }
+
+    array_t<T> next(handle, std::false_type, std::true_type) {
+        const auto n = std::min<ssize_t>(chunk_size, static_cast<ssize_t>(end - it));
+        array_t<T> chunk(n);
+        std::copy(it, it + n, chunk.mutable_data());
+        it += n;
+        return chunk;
+    }
+
+    array_t<T> next(handle, std::false_type, std::false_type) {
+        array_t<T> chunk(chunk_size);
+        T *data = chunk.mutable_data();
+        ssize_t n = 0;
+        for (; n < chunk_size && it != end; ++it, ++n) {
+            data[n] = *it;
+        }
+        if (n < chunk_size) {
+            chunk.resize({n}, false);
+        }
+        return chunk;
+    }
+};
+
+#if !defined(PYPY_VERSION)
+/// The `tp_iternext` slot of chunked iterators, like the one of `make_iterator`'s iterators
+template <typename State>
+PyObject *chunked_iterator_next(PyObject *self) {
+    try {
+        auto *state = get_iterator_state<State>(self);
+        if (state == nullptr) {
+            return nullptr;
+        }
+        return state->next(self).release().ptr();
+    } catch (...) {
+        return handle_active_exception();
+    }
+}
+#endif
+
+template <return_value_policy Policy, typename T, typename Iterator, typename Sentinel>
+iterator make_chunked_iterator_impl(Iterator first, Sentinel last, ssize_t chunk_size) {
+    using state = chunked_iterator_state<Policy, Iterator, Sentinel, T>;
+    if (chunk_size <= 0) {
+        throw value_error("make_chunked_iterator(): chunk_size must be positive");
+    }
+
+    if (!get_type_info(typeid(state), false)) {
+        class_<state> cls(
+            handle(), "chunked_iterator", pybind11::module_local(), inline_storage());
+        cls.def("__iter__", [](state &s) -> state & { return s; })
+            .def("__next__", [](const object &self) {
+                auto chunk = self.cast<state &>().next(self);
+                if (!chunk) {
+                    throw stop_iteration();
+                }
+                return chunk;
+            });
+#if !defined(PYPY_VERSION)
+        auto *type = reinterpret_cast<PyTypeObject *>(cls.ptr());
+        type->tp_iter = PyObject_SelfIter;
+        type->tp_iternext = &chunked_iterator_next<state>;
+#endif
+    }
+
+    return cast(state{first, last, chunk_size});
+}
+
+template <typename Container, typename SFINAE = void>
+struct has_contiguous_data : std::false_type {};
+template <typename Container>
+struct has_contiguous_data<
+    Container,
+    enable_if_t<std::is_pointer<decltype(std::declval<Container &>().data())>::value,
+                void_t<decltype(std::declval<Container &>().size())>>> : std::true_type {};
+
+PYBIND11_NAMESPACE_END(detail)
+
+/// Makes a Python iterator over a range of arithmetic or structured (`PYBIND11_NUMPY_DTYPE`)
+/// values which yields one-dimensional arrays of up to `chunk_size` elements each, so that Python
+/// code can process large ranges without an object per element. The elements are copied into
+/// the arrays, except that with `return_value_policy::reference_internal` the arrays for a range
+/// of pointers are views into it, which keep the iterator alive (read-only for `const` elements).
+template <return_value_policy Policy = return_value_policy::copy,
+          typename Iterator,
+          typename Sentinel,
+          typename ValueType = detail::remove_cv_t<
+              detail::remove_reference_t<decltype(*std::declval<Iterator &>())>>>
+iterator make_chunked_iterator(Iterator first, Sentinel last, ssize_t chunk_size) {
+    return detail::make_chunked_iterator_impl<Policy, ValueType>(first, last, chunk_size);
+}
+
+/// Makes a chunked iterator over a container; containers with `data()` and `size()` are treated
+/// as ranges of pointers
+template <return_value_policy Policy = return_value_policy::copy,
+          typename Type,
+          detail::enable_if_t<detail::has_contiguous_data<Type>::value, int> = 0>
+iterator make_chunked_iterator(Type &value, ssize_t chunk_size) {
+    return make_chunked_iterator<Policy>(
+        value.data(), value.data() + value.size(), chunk_size);
+}
+
+template <return_value_policy Policy = return_value_policy::copy,
+          typename Type,
+          detail::enable_if_t<!detail::has_contiguous_data<Type>::value, int> = 0>
+iterator make_chunked_iterator(Type &value, ssize_t chunk_size) {
+    return make_chunked_iterator<Policy>(std::begin(value), std::end(value), chunk_size);
+}
+
 PYBIND11_NAMESPACE_END(PYBIND11_NAMESPACE)
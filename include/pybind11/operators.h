@@ -11,6 +11,9 @@
 
 #include "pybind11.h"
 
+#include <algorithm>
+#include <iterator>
+
 PYBIND11_NAMESPACE_BEGIN(PYBIND11_NAMESPACE)
 PYBIND11_NAMESPACE_BEGIN(detail)
 
@@ -81,6 +84,355 @@ inline self_t __self() { return self; }
 template <op_id, op_type, typename B, typename L, typename R>
 struct op_impl {};
 
+#if !defined(PYPY_VERSION)
+/// Stored in `function_record::data[2]` of the operators on two (or one) instances of the class
+/// itself, which are also installed as type slots (e.g. `nb_add`) while they are the first
+/// overload of their method. Such a slot calls the C++ operator directly when the operands are
+/// exactly of the class, and behaves like CPython's generic slot otherwise.
+struct operator_slot {
+    void (*install)(PyTypeObject *type);
+};
+
+/// The Python type of the class bound to `B`. If `B` is bound more than once (e.g. by
+/// module-local classes of several modules, in several subinterpreters, or again after the
+/// interpreter was restarted), no operand is taken as one any more. The slots then call the
+/// operator methods like CPython's generic slots, whose functions (saved as `generic` below) are
+/// the same in every interpreter.
+template <typename B>
+struct operator_operand {
+    static PyTypeObject *type;
+    static const type_info *tinfo;
+    static bool shared;
+
+    static bool claim(PyTypeObject *t) {
+        if (shared) {
+            return false;
+        }
+        if (type != nullptr && type != t) {
+            shared = true;
+            type = nullptr;
+            return false;
+        }
+        type = t;
+        tinfo = get_type_info(t);
+        return tinfo != nullptr;
+    }
+
+    /// Returns the C++ object of an instance of exactly the class, or nullptr for anything else
+    /// (including subclasses and instances whose `__init__` was not called)
+    static B *get(PyObject *o) {
+        if (Py_TYPE(o) != type) {
+            return nullptr;
+        }
+        return static_cast<B *>(reinterpret_cast<instance *>(o)
+                                    ->get_value_and_holder(tinfo, /*throw_if_missing=*/false)
+                                    .value_ptr());
+    }
+};
+template <typename B>
+PyTypeObject *operator_operand<B>::type = nullptr;
+template <typename B>
+const type_info *operator_operand<B>::tinfo = nullptr;
+template <typename B>
+bool operator_operand<B>::shared = false;
+
+/// Casts the result of an operator like the function dispatcher does
+template <typename Op, typename... Args>
+PyObject *call_operator(PyObject *self, Args &...args) {
+    using Return = decltype(Op::execute(args...));
+    return make_caster<Return>::cast(
+               Op::execute(args...),
+               return_value_policy_override<Return>::policy(return_value_policy::automatic),
+               self)
+        .ptr();
+}
+
+/// Calls a special method the way CPython's slots do: looked up on the type, and
+/// `NotImplemented` if it does not exist
+inline PyObject *call_special_method(PyObject *self, const interned_str &name, PyObject *other) {
+    PyObject *descr = _PyType_Lookup(Py_TYPE(self), name.get().ptr());
+    if (descr == nullptr) {
+        return handle(Py_NotImplemented).inc_ref().ptr();
+    }
+    object func;
+    if (auto get = Py_TYPE(descr)->tp_descr_get) {
+        func = reinterpret_steal<object>(get(descr, self, (PyObject *) Py_TYPE(self)));
+        if (!func) {
+            return nullptr;
+        }
+    } else {
+        func = reinterpret_borrow<object>(descr);
+    }
+    return PyObject_CallFunctionObjArgs(func.ptr(), other, nullptr);
+}
+
+template <op_id id, typename B, binaryfunc PyNumberMethods::*Slot>
+struct binary_operator_slot {
+    using op = op_impl<id, op_l, B, B, B>;
+    using rop = op_impl<id, op_r, B, B, B>;
+
+    static PyObject *call(PyObject *l, PyObject *r) {
+        try {
+            B *lv = operator_operand<B>::get(l);
+            B *rv = lv != nullptr ? operator_operand<B>::get(r) : nullptr;
+            if (rv != nullptr) {
+                return call_operator<op>(l, *lv, *rv);
+            }
+            return call_generic(l, r);
+        } catch (...) {
+            return handle_active_exception();
+        }
+    }
+
+    static void install(PyTypeObject *type) {
+        if (operator_operand<B>::claim(type)) {
+            type->tp_as_number->*Slot = &call;
+        }
+    }
+
+    static const operator_slot *get() {
+        static const operator_slot slot{&install};
+        return &slot;
+    }
+
+private:
+    static bool has_slot(PyTypeObject *type) {
+        return type->tp_as_number != nullptr && type->tp_as_number->*Slot == &call;
+    }
+
+    /// What CPython's `slot_nb_add` (and so on) does, for which this slot stands in: it calls
+    /// `__add__` and `__radd__` only of types which have the same slot.
+    static PyObject *call_generic(PyObject *l, PyObject *r) {
+        static interned_str name(op::name());
+        static interned_str rname(rop::name());
+        PyTypeObject *ltype = Py_TYPE(l), *rtype = Py_TYPE(r);
+        const bool do_other = ltype != rtype && has_slot(rtype);
+        if (has_slot(ltype)) {
+            if (do_other && PyType_IsSubtype(rtype, ltype) != 0
+                && _PyType_Lookup(rtype, rname.get().ptr())
+                       != _PyType_Lookup(ltype, rname.get().ptr())) {
+                // A subclass which overrides the reflected method goes first
+                PyObject *result = call_special_method(r, rname, l);
+                if (result != Py_NotImplemented) {
+                    return result;
+                }
+                Py_DECREF(result);
+                return call_special_method(l, name, r);
+            }
+            PyObject *result = call_special_method(l, name, r);
+            if (result != Py_NotImplemented || ltype == rtype) {
+                return result;
+            }
+            Py_DECREF(result);
+        }
+        if (do_other) {
+            return call_special_method(r, rname, l);
+        }
+        return handle(Py_NotImplemented).inc_ref().ptr();
+    }
+};
+
+template <op_id id, typename B, binaryfunc PyNumberMethods::*Slot>
+struct inplace_operator_slot {
+    using op = op_impl<id, op_l, B, B, B>;
+    static binaryfunc generic;
+
+    static PyObject *call(PyObject *l, PyObject *r) {
+        B *lv = operator_operand<B>::get(l);
+        B *rv = lv != nullptr ? operator_operand<B>::get(r) : nullptr;
+        if (rv == nullptr) {
+            return generic(l, r);
+        }
+        try {
+            return call_operator<op>(l, *lv, *rv);
+        } catch (...) {
+            return handle_active_exception();
+        }
+    }
+
+    static void install(PyTypeObject *type) {
+        binaryfunc &slot = type->tp_as_number->*Slot;
+        if (slot != &call && slot != nullptr && operator_operand<B>::claim(type)) {
+            generic = slot;
+            slot = &call;
+        }
+    }
+
+    static const operator_slot *get() {
+        static const operator_slot slot{&install};
+        return &slot;
+    }
+};
+template <op_id id, typename B, binaryfunc PyNumberMethods::*Slot>
+binaryfunc inplace_operator_slot<id, B, Slot>::generic = nullptr;
+
+template <op_id id, typename B, unaryfunc PyNumberMethods::*Slot>
+struct unary_operator_slot {
+    using op = op_impl<id, op_u, B, B, undefined_t>;
+    static unaryfunc generic;
+
+    static PyObject *call(PyObject *o) {
+        B *v = operator_operand<B>::get(o);
+        if (v == nullptr) {
+            return generic(o);
+        }
+        try {
+            return call_operator<op>(o, *v);
+        } catch (...) {
+            return handle_active_exception();
+        }
+    }
+
+    static void install(PyTypeObject *type) {
+        unaryfunc &slot = type->tp_as_number->*Slot;
+        if (slot != &call && slot != nullptr && operator_operand<B>::claim(type)) {
+            generic = slot;
+            slot = &call;
+        }
+    }
+
+    static const operator_slot *get() {
+        static const operator_slot slot{&install};
+        return &slot;
+    }
+};
+template <op_id id, typename B, unaryfunc PyNumberMethods::*Slot>
+unaryfunc unary_operator_slot<id, B, Slot>::generic = nullptr;
+
+/// `tp_richcompare` is shared by the six comparisons; those which are not installed (or not
+/// defined) go through the generic slot.
+template <typename B>
+struct richcompare_operator_slot {
+    using compare_fn = PyObject *(*) (PyObject *, B &, B &);
+    static richcmpfunc generic;
+    static compare_fn compare[6];
+
+    static PyObject *call(PyObject *l, PyObject *r, int cmp) {
+        compare_fn fn = cmp >= Py_LT && cmp <= Py_GE ? compare[cmp] : nullptr;
+        B *lv = fn != nullptr ? operator_operand<B>::get(l) : nullptr;
+        B *rv = lv != nullptr ? operator_operand<B>::get(r) : nullptr;
+        if (rv == nullptr) {
+            return generic(l, r, cmp);
+        }
+        try {
+            return fn(l, *lv, *rv);
+        } catch (...) {
+            return handle_active_exception();
+        }
+    }
+};
+template <typename B>
+richcmpfunc richcompare_operator_slot<B>::generic = nullptr;
+template <typename B>
+typename richcompare_operator_slot<B>::compare_fn richcompare_operator_slot<B>::compare[6];
+
+template <op_id id, typename B, int Cmp>
+struct compare_operator_slot {
+    using op = op_impl<id, op_l, B, B, B>;
+    using richcompare = richcompare_operator_slot<B>;
+
+    static PyObject *compare(PyObject *self, B &l, B &r) { return call_operator<op>(self, l, r); }
+
+    static void install(PyTypeObject *type) {
+        if (type->tp_richcompare != &richcompare::call) {
+            // Setting any comparison method resets the slot, and then all of them are installed
+            // again
+            if (type->tp_richcompare == nullptr || !operator_operand<B>::claim(type)) {
+                return;
+            }
+            richcompare::generic = type->tp_richcompare;
+            std::fill(std::begin(richcompare::compare), std::end(richcompare::compare), nullptr);
+            type->tp_richcompare = &richcompare::call;
+        }
+        richcompare::compare[Cmp] = &compare;
+    }
+
+    static const operator_slot *get() {
+        static const operator_slot slot{&install};
+        return &slot;
+    }
+};
+
+struct no_operator_slot {
+    static const operator_slot *get() { return nullptr; }
+};
+
+/// The slot of an operator on instances of `B` only; none by default
+template <op_id id, typename B>
+struct operator_slot_for : no_operator_slot {};
+
+#    define PYBIND11_OPERATOR_SLOT(id, kind, slot)                                               \
+        template <typename B>                                                                     \
+        struct operator_slot_for<op_##id, B> : kind##_operator_slot<op_##id, B, slot> {};
+
+PYBIND11_OPERATOR_SLOT(add, binary, &PyNumberMethods::nb_add)
+PYBIND11_OPERATOR_SLOT(sub, binary, &PyNumberMethods::nb_subtract)
+PYBIND11_OPERATOR_SLOT(mul, binary, &PyNumberMethods::nb_multiply)
+PYBIND11_OPERATOR_SLOT(truediv, binary, &PyNumberMethods::nb_true_divide)
+PYBIND11_OPERATOR_SLOT(mod, binary, &PyNumberMethods::nb_remainder)
+PYBIND11_OPERATOR_SLOT(lshift, binary, &PyNumberMethods::nb_lshift)
+PYBIND11_OPERATOR_SLOT(rshift, binary, &PyNumberMethods::nb_rshift)
+PYBIND11_OPERATOR_SLOT(and, binary, &PyNumberMethods::nb_and)
+PYBIND11_OPERATOR_SLOT(xor, binary, &PyNumberMethods::nb_xor)
+PYBIND11_OPERATOR_SLOT(or, binary, &PyNumberMethods::nb_or)
+PYBIND11_OPERATOR_SLOT(iadd, inplace, &PyNumberMethods::nb_inplace_add)
+PYBIND11_OPERATOR_SLOT(isub, inplace, &PyNumberMethods::nb_inplace_subtract)
+PYBIND11_OPERATOR_SLOT(imul, inplace, &PyNumberMethods::nb_inplace_multiply)
+PYBIND11_OPERATOR_SLOT(itruediv, inplace, &PyNumberMethods::nb_inplace_true_divide)
+PYBIND11_OPERATOR_SLOT(imod, inplace, &PyNumberMethods::nb_inplace_remainder)
+PYBIND11_OPERATOR_SLOT(ilshift, inplace, &PyNumberMethods::nb_inplace_lshift)
+PYBIND11_OPERATOR_SLOT(irshift, inplace, &PyNumberMethods::nb_inplace_rshift)
+PYBIND11_OPERATOR_SLOT(iand, inplace, &PyNumberMethods::nb_inplace_and)
+PYBIND11_OPERATOR_SLOT(ixor, inplace, &PyNumberMethods::nb_inplace_xor)
+PYBIND11_OPERATOR_SLOT(ior, inplace, &PyNumberMethods::nb_inplace_or)
+PYBIND11_OPERATOR_SLOT(neg, unary, &PyNumberMethods::nb_negative)
+PYBIND11_OPERATOR_SLOT(pos, unary, &PyNumberMethods::nb_positive)
+PYBIND11_OPERATOR_SLOT(abs, unary, &PyNumberMethods::nb_absolute)
+PYBIND11_OPERATOR_SLOT(invert, unary, &PyNumberMethods::nb_invert)
+PYBIND11_OPERATOR_SLOT(lt, compare, Py_LT)
+PYBIND11_OPERATOR_SLOT(le, compare, Py_LE)
+PYBIND11_OPERATOR_SLOT(eq, compare, Py_EQ)
+PYBIND11_OPERATOR_SLOT(ne, compare, Py_NE)
+PYBIND11_OPERATOR_SLOT(gt, compare, Py_GT)
+PYBIND11_OPERATOR_SLOT(ge, compare, Py_GE)
+#    undef PYBIND11_OPERATOR_SLOT
+
+/// Installs the slots of all operators which are the first overload of their method. Defining a
+/// method resets the slots it is reached through (`__radd__` resets `nb_add`, too), so this runs
+/// after every operator definition.
+inline void update_operator_slots(PyTypeObject *type) {
+    static const char *const names[]
+        = {"__add__",      "__sub__",      "__mul__",       "__truediv__",  "__mod__",
+           "__lshift__",   "__rshift__",   "__and__",       "__xor__",      "__or__",
+           "__iadd__",     "__isub__",     "__imul__",      "__itruediv__", "__imod__",
+           "__ilshift__",  "__irshift__",  "__iand__",      "__ixor__",     "__ior__",
+           "__neg__",      "__pos__",      "__abs__",       "__invert__",   "__lt__",
+           "__le__",       "__eq__",       "__ne__",        "__gt__",       "__ge__"};
+    for (const char *name : names) {
+        function_record *rec = get_function_record(PyDict_GetItemString(type->tp_dict, name));
+        // Other functions may keep their capture in `data[2]`, but they are not stateless
+        if (rec != nullptr && rec->is_operator && rec->is_stateless && rec->data[2] != nullptr) {
+            static_cast<const operator_slot *>(rec->data[2])->install(type);
+        }
+    }
+}
+
+/// Marks the operator just added to a method (its last overload) with its slot
+inline void add_operator_slot(handle cls, const char *name, const operator_slot *slot) {
+    auto *type = reinterpret_cast<PyTypeObject *>(cls.ptr());
+    if (slot != nullptr) {
+        function_record *rec = get_function_record(PyDict_GetItemString(type->tp_dict, name));
+        while (rec != nullptr && rec->next != nullptr) {
+            rec = rec->next;
+        }
+        if (rec != nullptr) {
+            rec->data[2] = const_cast<operator_slot *>(slot);
+        }
+    }
+    update_operator_slots(type);
+}
+#endif
+
 /// Operator implementation generator
 template <op_id id, op_type ot, typename L, typename R>
 struct op_ {
@@ -92,6 +444,16 @@ struct op_ {
         using R_type = conditional_t<std::is_same<R, self_t>::value, Base, R>;
         using op = op_impl<id, ot, Base, L_type, R_type>;
         cl.def(op::name(), &op::execute, is_operator(), extra...);
+#if !defined(PYPY_VERSION)
+        // Only plain operators on the class itself have a slot
+        constexpr bool has_slot
+            = sizeof...(Extra) == 0
+              && (ot == op_u
+                  || (ot == op_l && std::is_same<L_type, Base>::value
+                      && std::is_same<R_type, Base>::value));
+        using slot = conditional_t<has_slot, operator_slot_for<id, Base>, no_operator_slot>;
+        add_operator_slot(cl, op::name(), slot::get());
+#endif
     }
     template <typename Class, typename... Extra>
     void execute_cast(Class &cl, const Extra &...extra) const {
@@ -100,6 +462,9 @@ struct op_ {
         using R_type = conditional_t<std::is_same<R, self_t>::value, Base, R>;
         using op = op_impl<id, ot, Base, L_type, R_type>;
         cl.def(op::name(), &op::execute_cast, is_operator(), extra...);
+#if !defined(PYPY_VERSION)
+        add_operator_slot(cl, op::name(), nullptr);
+#endif
     }
 };
 
@@ -16,14 +16,27 @@
 #include "gil.h"
 #include "options.h"
 
+#include <algorithm>
+#include <array>
 #include <cstdlib>
 #include <cstring>
+#include <functional>
+#include <initializer_list>
 #include <memory>
+#include <mutex>
 #include <new>
 #include <string>
+#include <typeindex>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
+#if defined(PYBIND11_DISPATCH_STATS)
+#    include <chrono>
+#    include <cstdint>
+#endif
+
 #if defined(__cpp_lib_launder) && !(defined(_MSC_VER) && (_MSC_VER < 1914))
 #    define PYBIND11_STD_LAUNDER std::launder
 #    define PYBIND11_HAS_STD_LAUNDER 1
@@ -35,6 +48,15 @@
 #    include <cxxabi.h>
 #endif
 
+// The dynamic type of the exception being handled is only known with the Itanium C++ ABI
+#if (defined(__GLIBCXX__) || defined(_LIBCPP_VERSION)) && !defined(PYPY_VERSION)                  \
+    && !defined(Py_GIL_DISABLED) && !defined(PYBIND11_NO_EXCEPTION_TRANSLATOR_CACHE)
+#    define PYBIND11_HAS_EXCEPTION_TRANSLATOR_CACHE
+#    include <array>
+#    include <cxxabi.h>
+#    include <typeinfo>
+#endif
+
 PYBIND11_NAMESPACE_BEGIN(PYBIND11_NAMESPACE)
 
 /* https://stackoverflow.com/questions/46798456/handling-gccs-noexcept-type-warning
@@ -52,16 +74,19 @@ PYBIND11_WARNING_DISABLE_MSVC(4127)
 
 PYBIND11_NAMESPACE_BEGIN(detail)
 
-// Apply all the extensions translators from a list
+// Apply all the extensions translators from a list, starting with the given exception.
 // Return true if one of the translators completed without raising an exception
 // itself. Return of false indicates that if there are other translators
-// available, they should be tried.
-inline bool apply_exception_translators(std::forward_list<ExceptionTranslator> &translators) {
-    auto last_exception = std::current_exception();
-
+// available, they should be tried. On success, `last_exception` is the exception
+// the translator `handled_by` was given (translators may raise another exception
+// for later translators to handle).
+inline bool apply_exception_translators(std::forward_list<ExceptionTranslator> &translators,
+                                        std::exception_ptr &last_exception,
+                                        ExceptionTranslator &handled_by) {
     for (auto &translator : translators) {
         try {
             translator(last_exception);
+            handled_by = translator;
             return true;
         } catch (...) {
             last_exception = std::current_exception();
@@ -70,12 +95,591 @@ inline bool apply_exception_translators(std::forward_list<ExceptionTranslator> &
     return false;
 }
 
+// Apply all the extensions translators from a list
+// Return true if one of the translators completed without raising an exception
+// itself. Return of false indicates that if there are other translators
+// available, they should be tried.
+inline bool apply_exception_translators(std::forward_list<ExceptionTranslator> &translators) {
+    auto last_exception = std::current_exception();
+    ExceptionTranslator handled_by = nullptr;
+    return apply_exception_translators(translators, last_exception, handled_by);
+}
+
+#if defined(PYBIND11_HAS_EXCEPTION_TRANSLATOR_CACHE)
+/// Remembers which exception translator handled recent exceptions of a given dynamic type, so
+/// that later exceptions of that type can be passed to it directly instead of being rethrown
+/// through every translator registered before it. The cache is reset whenever translators are
+/// registered (noticed through the heads of the translator lists changing). Only translators
+/// that handled the exception they were given, rather than translating it into another one,
+/// are remembered. Should the remembered translator decline an exception, the full chain is
+/// still tried. Only the main interpreter uses the cache.
+struct exception_translator_cache {
+    static constexpr size_t num_entries = 8;
+
+    // An aggregate, so that C++11 can brace-initialize it; `m_entries{}` zeroes them all.
+    struct entry {
+        const std::type_info *type;
+        ExceptionTranslator translator;
+    };
+
+    ExceptionTranslator find(const std::type_info *type,
+                             const std::forward_list<ExceptionTranslator> &local_translators,
+                             const std::forward_list<ExceptionTranslator> &global_translators) {
+        if (!in_main_interpreter()) {
+            return nullptr;
+        }
+        const void *local_head = local_translators.empty() ? nullptr : &local_translators.front();
+        const void *global_head
+            = global_translators.empty() ? nullptr : &global_translators.front();
+        if (local_head != m_local_head || global_head != m_global_head) {
+            m_entries = {};
+            m_local_head = local_head;
+            m_global_head = global_head;
+            return nullptr;
+        }
+        if (type == nullptr) {
+            return nullptr;
+        }
+        for (const auto &e : m_entries) {
+            if (e.type != nullptr && *e.type == *type) {
+                return e.translator;
+            }
+        }
+        return nullptr;
+    }
+
+    void store(const std::type_info *type, ExceptionTranslator translator) {
+        if (type == nullptr || translator == nullptr || !in_main_interpreter()) {
+            return;
+        }
+        m_entries[m_next] = entry{type, translator};
+        m_next = (m_next + 1) % num_entries;
+    }
+
+private:
+    std::array<entry, num_entries> m_entries{};
+    size_t m_next = 0;
+    const void *m_local_head = nullptr;
+    const void *m_global_head = nullptr;
+};
+
+/// The cache is per extension module and protected by the GIL
+inline exception_translator_cache &get_exception_translator_cache() {
+    static exception_translator_cache cache;
+    return cache;
+}
+#endif
+
+/// Checks whether the keyword `key` of a call names the argument `arg`. Keywords are normally
+/// interned by the interpreter, so this is usually a pointer comparison with the interned name
+/// stored in the argument record; only non-interned keywords need their contents compared.
+inline bool keyword_matches(PyObject *key, const argument_record &arg) {
+    if (key == arg.name_obj.ptr()) {
+        return true;
+    }
+#if !defined(PYPY_VERSION)
+    if (PyUnicode_CHECK_INTERNED(key) && arg.name_obj) {
+        return false;
+    }
+#endif
+    const char *key_str = PyUnicode_AsUTF8(key);
+    if (key_str == nullptr) {
+        throw error_already_set();
+    }
+    return std::strcmp(key_str, arg.name) == 0;
+}
+
+/// Looks up a keyword argument of a vectorcall-style call, where the values of the keyword
+/// arguments named in `kwnames` follow the `nargs` positional arguments in `args`. Returns the
+/// index into `kwnames`, or -1 if `arg` was not passed as a keyword.
+inline ssize_t find_keyword_argument(PyObject *kwnames, const argument_record &arg) {
+    if (!kwnames) {
+        return -1;
+    }
+    const auto n_kwargs = PyTuple_GET_SIZE(kwnames);
+    for (ssize_t i = 0; i < n_kwargs; ++i) {
+        if (keyword_matches(PyTuple_GET_ITEM(kwnames, i), arg)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/// Remembers which overload of a function matched recent calls with a given combination of
+/// argument types and keyword names. Since the overloads preceding the matching one failed to load
+/// those argument types, the ones that load their arguments purely by type
+/// (`function_record::loads_by_type`) can be skipped on later calls.
+struct overload_cache {
+    /// Calls with more (positional and keyword) arguments than this are not cached
+    static constexpr size_t max_args = 6;
+    static constexpr size_t num_entries = 4;
+
+    struct entry {
+        /// The overload that matched, or nullptr if the entry is unused
+        const function_record *overload = nullptr;
+        /// The keyword names of the call, if any (strong reference)
+        PyObject *kwnames = nullptr;
+        size_t nargs = 0;
+        /// The argument types are not referenced; the version tags make sure they are still the
+        /// same (and unmodified) type objects
+        PyTypeObject *types[max_args] = {};
+        unsigned int version_tags[max_args] = {};
+    };
+
+    entry entries[num_entries];
+
+    overload_cache() = default;
+    overload_cache(const overload_cache &) = delete;
+    overload_cache &operator=(const overload_cache &) = delete;
+    ~overload_cache() {
+        for (auto &e : entries) {
+            Py_XDECREF(e.kwnames);
+        }
+    }
+
+    /// Returns the entry slot for a call, or -1 if the call cannot be cached
+    static ssize_t slot(PyObject *const *args, size_t nargs, PyObject *kwnames) {
+#if defined(PYPY_VERSION) || defined(Py_GIL_DISABLED)
+        (void) args;
+        (void) nargs;
+        (void) kwnames;
+        return -1;
+#else
+        const size_t n = nargs + (kwnames ? (size_t) PyTuple_GET_SIZE(kwnames) : 0);
+        if (n > max_args) {
+            return -1;
+        }
+        size_t hash = nargs ^ (reinterpret_cast<size_t>(kwnames) >> 4);
+        for (size_t i = 0; i < n; ++i) {
+            auto *type = Py_TYPE(args[i]);
+            if (!PyType_HasFeature(type, Py_TPFLAGS_VALID_VERSION_TAG)) {
+                return -1;
+            }
+            hash = hash * 31 + (reinterpret_cast<size_t>(type) >> 4);
+        }
+        return (ssize_t) ((hash ^ (hash >> 7)) % num_entries);
+#endif
+    }
+
+    const function_record *
+    find(ssize_t slot, PyObject *const *args, size_t nargs, PyObject *kwnames) const {
+        const auto &e = entries[slot];
+        if (e.overload == nullptr || e.nargs != nargs || e.kwnames != kwnames) {
+            return nullptr;
+        }
+        const size_t n = nargs + (kwnames ? (size_t) PyTuple_GET_SIZE(kwnames) : 0);
+        for (size_t i = 0; i < n; ++i) {
+            auto *type = Py_TYPE(args[i]);
+            if (e.types[i] != type || e.version_tags[i] != type->tp_version_tag) {
+                return nullptr;
+            }
+        }
+        return e.overload;
+    }
+
+    void store(ssize_t slot,
+               PyObject *const *args,
+               size_t nargs,
+               PyObject *kwnames,
+               const function_record *overload) {
+        auto &e = entries[slot];
+        Py_XINCREF(kwnames);
+        Py_XDECREF(e.kwnames);
+        e.kwnames = kwnames;
+        e.nargs = nargs;
+        const size_t n = nargs + (kwnames ? (size_t) PyTuple_GET_SIZE(kwnames) : 0);
+        for (size_t i = 0; i < n; ++i) {
+            e.types[i] = Py_TYPE(args[i]);
+            e.version_tags[i] = e.types[i]->tp_version_tag;
+        }
+        e.overload = overload;
+    }
+};
+
+#if defined(PYBIND11_DISPATCH_STATS)
+#    if defined(Py_GIL_DISABLED)
+#        error "PYBIND11_DISPATCH_STATS relies on the GIL and is not free-threading safe"
+#    endif
+/// Counters the dispatcher keeps for each overload while dispatch statistics are enabled (see
+/// `enable_dispatch_stats()`)
+struct function_stats {
+    /// Number of calls that ran this overload
+    std::uint64_t calls = 0;
+    /// Number of times this overload was tried, but could not load the arguments
+    std::uint64_t overload_misses = 0;
+    /// Number of times this overload was tried with implicit conversions allowed
+    std::uint64_t conversion_passes = 0;
+    /// Cumulative time spent loading the arguments (including failed attempts)
+    std::chrono::steady_clock::duration load_time{};
+    /// Cumulative time spent in the C++ function and converting its return value
+    std::chrono::steady_clock::duration call_time{};
+};
+
+struct dispatch_stats_state {
+    bool enabled = false;
+    std::unordered_map<const function_record *, function_stats> functions;
+};
+
+/// Dispatch statistics are collected per extension module and protected by the GIL. This is
+/// intentionally leaked, since function records can be destroyed very late during shutdown.
+inline dispatch_stats_state &get_dispatch_stats_state() {
+    static auto *state = new dispatch_stats_state();
+    return *state;
+}
+
+/// Measures a single attempt to run an overload and adds it to that overload's statistics.
+/// The generated `function_record::impl` marks the point where argument loading finished via
+/// `mark_loaded()`.
+class dispatch_stats_scope {
+    using clock = std::chrono::steady_clock;
+
+public:
+    dispatch_stats_scope(const function_record &func, bool conversion_pass) {
+        auto &state = get_dispatch_stats_state();
+        if (!state.enabled) {
+            return;
+        }
+        m_stats = &state.functions[&func];
+        if (conversion_pass) {
+            ++m_stats->conversion_passes;
+        }
+        m_outer_loaded_at = current_loaded_at();
+        current_loaded_at() = &m_loaded_at;
+        m_start = clock::now();
+    }
+    dispatch_stats_scope(const dispatch_stats_scope &) = delete;
+    dispatch_stats_scope &operator=(const dispatch_stats_scope &) = delete;
+
+    ~dispatch_stats_scope() {
+        if (m_stats == nullptr) {
+            return;
+        }
+        const auto end = clock::now();
+        current_loaded_at() = m_outer_loaded_at;
+        if (m_missed) {
+            ++m_stats->overload_misses;
+            m_stats->load_time += end - m_start;
+            return;
+        }
+        ++m_stats->calls;
+        if (m_loaded_at == clock::time_point{}) {
+            // Not marked, e.g. by an overload added from another extension module
+            m_stats->call_time += end - m_start;
+        } else {
+            m_stats->load_time += m_loaded_at - m_start;
+            m_stats->call_time += end - m_loaded_at;
+        }
+    }
+
+    /// Records the attempt as an overload miss rather than a call
+    void set_missed() { m_missed = true; }
+
+    static void mark_loaded() {
+        if (auto *loaded_at = current_loaded_at()) {
+            *loaded_at = clock::now();
+        }
+    }
+
+private:
+    // Points into the innermost scope active on this thread (calls can be nested)
+    static clock::time_point *&current_loaded_at() {
+        static thread_local clock::time_point *loaded_at = nullptr;
+        return loaded_at;
+    }
+
+    function_stats *m_stats = nullptr;
+    clock::time_point *m_outer_loaded_at = nullptr;
+    clock::time_point m_start;
+    clock::time_point m_loaded_at;
+    bool m_missed = false;
+};
+#endif
+
+#if defined(PYBIND11_TRACING)
+/// Reports the `function_entry` and `function_exit` trace events around the call of a bound
+/// function, once its arguments are loaded
+class trace_function_scope {
+public:
+    explicit trace_function_scope(const function_record &func) : m_func(func) {
+        PYBIND11_TRACE(function_entry, m_func.name, &m_func);
+    }
+    trace_function_scope(const trace_function_scope &) = delete;
+    trace_function_scope &operator=(const trace_function_scope &) = delete;
+    ~trace_function_scope() { PYBIND11_TRACE(function_exit, m_func.name, &m_func); }
+
+private:
+    const function_record &m_func;
+};
+#endif
+
+/// The wall time spent in the registrations of a `PYBIND11_MODULE` body, collected when the
+/// ``PYBIND11_PROFILE_IMPORT`` environment variable is set (see `initialize_module()`)
+struct import_profile {
+    /// In nanoseconds, as returned by `time.perf_counter_ns()`
+    using duration = long long;
+    struct entry {
+        size_t count = 0;
+        /// Excluding the registrations nested in it (e.g. the methods of an enum)
+        duration self = 0;
+        duration total = 0;
+    };
+    std::unordered_map<std::string, entry> entries;
+    class import_profile_scope *innermost = nullptr;
+    /// `time.perf_counter_ns`, set by `initialize_module()`
+    object perf_counter_ns;
+
+    /// Must be called without a Python error set
+    duration now() const {
+        PyObject *result = PyObject_CallObject(perf_counter_ns.ptr(), nullptr);
+        duration ns = result != nullptr ? PyLong_AsLongLong(result) : -1;
+        Py_XDECREF(result);
+        if (ns == -1) {
+            PyErr_Clear();
+            ns = 0;
+        }
+        return ns;
+    }
+};
+
+inline bool import_profiling_enabled() {
+    static const bool enabled = [] {
+        const char *value = std::getenv("PYBIND11_PROFILE_IMPORT");
+        return value != nullptr && value[0] != '\0' && std::strcmp(value, "0") != 0;
+    }();
+    return enabled;
+}
+
+/// The profile of the module that is being initialized on this thread, if any
+inline import_profile *&current_import_profile() {
+    static thread_local import_profile *profile = nullptr;
+    return profile;
+}
+
+/// Adds the time until the end of the scope to the current import profile, if there is one. The
+/// entry is labelled by `kind`, the `__qualname__` (or `__name__`) of `scope` and `name`.
+class import_profile_scope {
+    using duration = import_profile::duration;
+
+public:
+    import_profile_scope(const char *kind, const char *name, handle scope = handle())
+        : m_profile(current_import_profile()) {
+        if (m_profile == nullptr) {
+            return;
+        }
+        m_kind = kind;
+        m_name = name != nullptr && name[0] != '\0' ? name : "(anonymous)";
+        m_scope = scope;
+        m_parent = m_profile->innermost;
+        m_profile->innermost = this;
+        m_start = m_profile->now();
+    }
+    import_profile_scope(const import_profile_scope &) = delete;
+    import_profile_scope &operator=(const import_profile_scope &) = delete;
+
+    ~import_profile_scope() {
+        if (m_profile == nullptr) {
+            return;
+        }
+        // The scope may be left by an exception, with a Python error set
+        error_scope error;
+        const duration total = m_profile->now() - m_start;
+        m_profile->innermost = m_parent;
+        if (m_parent != nullptr) {
+            m_parent->m_children += total;
+        }
+        auto &entry = m_profile->entries[label()];
+        ++entry.count;
+        entry.total += total;
+        entry.self += total - m_children;
+    }
+
+private:
+    std::string label() const {
+        std::string result = m_kind;
+        result += ' ';
+        for (const char *attr : {"__qualname__", "__name__"}) {
+            if (!m_scope) {
+                break;
+            }
+            PyObject *value = PyObject_GetAttrString(m_scope.ptr(), attr);
+            if (value != nullptr && PyUnicode_Check(value)) {
+                const char *str = PyUnicode_AsUTF8(value);
+                if (str != nullptr) {
+                    result += str;
+                    result += '.';
+                    Py_DECREF(value);
+                    break;
+                }
+            }
+            Py_XDECREF(value);
+            PyErr_Clear();
+        }
+        result += m_name;
+        return result;
+    }
+
+    import_profile *m_profile;
+    import_profile_scope *m_parent = nullptr;
+    const char *m_kind = nullptr;
+    std::string m_name;
+    handle m_scope;
+    duration m_start = 0;
+    duration m_children = 0;
+};
+
 #if defined(_MSC_VER)
 #    define PYBIND11_COMPAT_STRDUP _strdup
 #else
 #    define PYBIND11_COMPAT_STRDUP strdup
 #endif
 
+/// Storage for the function records of the extension module. The records are allocated in
+/// blocks, without the overhead of an allocation each, and so that the overloads of a function
+/// (usually defined one after another) are close in memory; freed records are reused. The names
+/// of the functions and their arguments, which repeat a lot, are kept once in a pool of strings.
+/// Like the internals, the storage is never freed.
+class function_record_storage {
+public:
+    static function_record_storage &get() {
+        static auto *storage = new function_record_storage();
+        return *storage;
+    }
+
+    function_record *create() {
+        void *ptr = nullptr;
+        {
+            std::lock_guard<mutex_type> lock(m_mutex);
+            if (m_free != nullptr) {
+                ptr = m_free;
+                m_free = m_free->next;
+            } else {
+                if (m_block == nullptr || m_used == block_size) {
+                    m_block = new slot[block_size];
+                    m_used = 0;
+                    ++m_blocks;
+                }
+                ptr = &m_block[m_used++];
+            }
+            ++m_records;
+        }
+        return new (ptr) function_record();
+    }
+
+    void destroy(function_record *rec) {
+        rec->~function_record();
+        auto *free_slot = reinterpret_cast<slot *>(rec);
+        std::lock_guard<mutex_type> lock(m_mutex);
+        free_slot->next = m_free;
+        m_free = free_slot;
+        --m_records;
+    }
+
+    /// Returns a copy of `str` that lives as long as the storage
+    const char *pooled(const char *str) {
+        std::lock_guard<mutex_type> lock(m_mutex);
+        auto res = m_strings.insert(str);
+        if (res.second) {
+            m_string_bytes += res.first->size() + 1;
+        }
+        return res.first->c_str();
+    }
+
+    /// Replaces the docstring `doc` (allocated by `strdup`, or nullptr) by a copy of `str`, or by
+    /// nullptr if that is empty
+    void set_docstring(const char *&doc, const std::string &str) {
+        const size_t old_size = doc != nullptr ? std::strlen(doc) + 1 : 0;
+        std::free(const_cast<char *>(doc));
+        doc = str.empty() ? nullptr : PYBIND11_COMPAT_STRDUP(str.c_str());
+        std::lock_guard<mutex_type> lock(m_mutex);
+        m_docstring_bytes += (doc != nullptr ? str.size() + 1 : 0);
+        m_docstring_bytes -= old_size;
+    }
+
+    /// Returns the lazily generated part `field` of a record, or nullptr if it is not set yet
+    template <typename Char>
+    Char *get_lazy(Char *const &field) {
+        std::lock_guard<mutex_type> lock(m_mutex);
+        return field;
+    }
+
+    /// Sets `field` to a copy of `str`, unless another thread did so meanwhile, and returns it
+    template <typename Char>
+    Char *set_lazy(Char *&field, const std::string &str) {
+        std::lock_guard<mutex_type> lock(m_mutex);
+        if (field == nullptr) {
+            field = PYBIND11_COMPAT_STRDUP(str.c_str());
+        }
+        return field;
+    }
+
+    /// The memory used by the storage, see `memory_stats()`
+    struct usage {
+        size_t records;
+        size_t record_bytes;
+        size_t strings;
+        size_t string_bytes;
+        size_t docstring_bytes;
+    };
+
+    usage get_usage() {
+        std::lock_guard<mutex_type> lock(m_mutex);
+        return {m_records,
+                m_blocks * block_size * sizeof(slot),
+                m_strings.size(),
+                m_string_bytes,
+                m_docstring_bytes};
+    }
+
+private:
+    union slot {
+        slot *next;
+        alignas(function_record) unsigned char storage[sizeof(function_record)];
+    };
+    static constexpr size_t block_size = 64;
+
+    // Subinterpreters with a GIL of their own use the storage at the same time, too
+#if defined(Py_GIL_DISABLED)
+    using mutex_type = pymutex;
+#else
+    using mutex_type = std::mutex;
+#endif
+    mutex_type m_mutex;
+    slot *m_block = nullptr;
+    size_t m_used = 0;
+    slot *m_free = nullptr;
+    std::unordered_set<std::string> m_strings;
+    size_t m_records = 0;
+    size_t m_blocks = 0;
+    size_t m_string_bytes = 0;
+    size_t m_docstring_bytes = 0;
+};
+
+// Defined after `cpp_function`, whose internals they use
+inline object call_overload(const function_record &rec,
+                            PyObject *const *args,
+                            size_t nargs,
+                            bool convert = true,
+                            const function_record *overloads = nullptr);
+inline object
+call_function_record(const function_record &rec, PyObject *const *args, size_t nargs);
+
+/// The function objects whose docstrings are generated at the end of the outermost
+/// `deferred_docstrings` scope of the calling thread; `nullptr` outside of such a scope
+struct pending_docstrings {
+    std::vector<object> functions;
+    std::unordered_set<PyObject *> seen;
+};
+
+inline pending_docstrings *&current_pending_docstrings() {
+    static thread_local pending_docstrings *pending = nullptr;
+    return pending;
+}
+
+// Defined after `cpp_function`, whose internals they use
+inline const char *get_function_signature(const function_record &rec);
+inline PyObject *handle_active_exception();
+class deferred_docstrings;
+
 PYBIND11_NAMESPACE_END(detail)
 
 /// Wraps an arbitrary C++ function/method/lambda function/.. into a callable Python object
@@ -148,9 +752,23 @@ public:
     }
 
     /// Return the function name
-    object name() const { return attr("__name__"); }
+    object name() const {
+        static interned_str name_attr("__name__");
+        return attr(name_attr);
+    }
 
 protected:
+    friend object detail::call_overload(const detail::function_record &,
+                                        PyObject *const *,
+                                        size_t,
+                                        bool,
+                                        const detail::function_record *);
+    friend const char *detail::get_function_signature(const detail::function_record &);
+    friend PyObject *detail::handle_active_exception();
+    friend class detail::deferred_docstrings;
+    template <typename, typename...>
+    friend struct detail::initimpl::fast_constructor;
+
     struct InitializingFunctionRecordDeleter {
         // `destruct(function_record, false)`: `initialize_generic` copies strings and
         // takes care of cleaning up in case of exceptions. So pass `false` to `free_strings`.
@@ -161,7 +779,7 @@ protected:
 
     /// Space optimization: don't inline this frequently instantiated fragment
     PYBIND11_NOINLINE unique_function_record make_function_record() {
-        return unique_function_record(new detail::function_record());
+        return unique_function_record(detail::function_record_storage::get().create());
     }
 
     /// Special internal constructor for functors, lambda functions, etc.
@@ -226,8 +844,15 @@ protected:
 
             /* Try to cast the function arguments into the C++ domain */
             if (!args_converter.load_args(call)) {
+                call.args_failed = true;
                 return PYBIND11_TRY_NEXT_OVERLOAD;
             }
+#if defined(PYBIND11_DISPATCH_STATS)
+            dispatch_stats_scope::mark_loaded();
+#endif
+#if defined(PYBIND11_TRACING)
+            trace_function_scope trace_scope(call.func);
+#endif
 
             /* Invoke call policy pre-call hook */
             process_attributes<Extra...>::precall(call);
@@ -244,20 +869,23 @@ protected:
             /* Function scope guard -- defaults to the compile-to-nothing `void_type` */
             using Guard = extract_guard_t<Extra...>;
 
-            /* Perform the function call */
+            /* Perform the function call, noting if its arguments fail to be cast */
+            bool *cast_failed = &call.args_failed;
             handle result;
             if (call.func.is_setter) {
-                (void) std::move(args_converter).template call<Return, Guard>(cap->f);
+                (void) std::move(args_converter).template call<Return, Guard>(cap->f, cast_failed);
                 result = none().release();
             } else {
                 result = cast_out::cast(
-                    std::move(args_converter).template call<Return, Guard>(cap->f),
+                    std::move(args_converter).template call<Return, Guard>(cap->f, cast_failed),
                     policy,
                     call.parent);
             }
 
-            /* Invoke call policy post-call hook */
-            process_attributes<Extra...>::postcall(call, result);
+            /* Invoke call policy post-call hook, unless an error is returned to be raised */
+            if (result || !casts_to_error<cast_out>::value) {
+                process_attributes<Extra...>::postcall(call, result);
+            }
 
             return result;
         };
@@ -268,6 +896,8 @@ protected:
                                                                       // we have a kw_only
         rec->has_args = cast_in::args_pos >= 0;
         rec->has_kwargs = cast_in::has_kwargs;
+        rec->loads_by_type = all_of<loads_by_type<make_caster<Args>>...>::value;
+        rec->returns_error = casts_to_error<cast_out>::value;
 
         /* Process any user-provided function attributes */
         process_attributes<Extra...>::init(extra..., rec);
@@ -292,11 +922,11 @@ protected:
                           "py::pos_only must come before py::kw_only");
         }
 
-        /* Generate a readable signature describing the function's arguments and return
-           value types */
+        /* Describe the function's arguments and return value types, from which a readable
+           signature is generated when it is first needed (see `get_signature`) */
         static constexpr auto signature
             = const_name("(") + cast_in::arg_names + const_name(") -> ") + cast_out::name;
-        PYBIND11_DESCR_CONSTEXPR auto types = decltype(signature)::types();
+        static const auto types = decltype(signature)::types();
 
         /* Register the function with Python from generic (non-templated) code */
         // Pass on the ownership over the `unique_rec` to `initialize_generic`. `rec` stays valid.
@@ -348,6 +978,7 @@ protected:
         // the pointee being alive after this call. Only move out if a `capsule` is going to keep
         // it alive.
         auto *rec = unique_rec.get();
+        detail::import_profile_scope profile_scope("def", rec->name, rec->scope);
 
         // Keep track of strdup'ed strings, and clean them up as long as the function's capsule
         // has not taken ownership yet (when `unique_rec.release()` is called).
@@ -357,19 +988,25 @@ protected:
         // copying all strings.
         strdup_guard guarded_strdup;
 
-        /* Create copies of all referenced C-style strings */
-        rec->name = guarded_strdup(rec->name ? rec->name : "");
+        /* Create copies of all referenced C-style strings; names are shared through the pool of
+           the record storage */
+        auto &storage = detail::function_record_storage::get();
+        rec->name = const_cast<char *>(storage.pooled(rec->name ? rec->name : ""));
         if (rec->doc) {
             rec->doc = guarded_strdup(rec->doc);
         }
         for (auto &a : rec->args) {
             if (a.name) {
-                a.name = guarded_strdup(a.name);
+                a.name = storage.pooled(a.name);
+                a.name_obj = PyUnicode_InternFromString(a.name);
+                if (!a.name_obj) {
+                    throw error_already_set();
+                }
             }
+            // Without a description, the default value is described by its `repr` when the
+            // signature is generated
             if (a.descr) {
                 a.descr = guarded_strdup(a.descr);
-            } else if (a.value) {
-                a.descr = guarded_strdup(repr(a.value).cast<std::string>().c_str());
             }
         }
 
@@ -394,75 +1031,8 @@ protected:
         }
 #endif
 
-        /* Generate a proper function signature */
-        std::string signature;
-        size_t type_index = 0, arg_index = 0;
-        bool is_starred = false;
-        for (const auto *pc = text; *pc != '\0'; ++pc) {
-            const auto c = *pc;
-
-            if (c == '{') {
-                // Write arg name for everything except *args and **kwargs.
-                is_starred = *(pc + 1) == '*';
-                if (is_starred) {
-                    continue;
-                }
-                // Separator for keyword-only arguments, placed before the kw
-                // arguments start (unless we are already putting an *args)
-                if (!rec->has_args && arg_index == rec->nargs_pos) {
-                    signature += "*, ";
-                }
-                if (arg_index < rec->args.size() && rec->args[arg_index].name) {
-                    signature += rec->args[arg_index].name;
-                } else if (arg_index == 0 && rec->is_method) {
-                    signature += "self";
-                } else {
-                    signature += "arg" + std::to_string(arg_index - (rec->is_method ? 1 : 0));
-                }
-                signature += ": ";
-            } else if (c == '}') {
-                // Write default value if available.
-                if (!is_starred && arg_index < rec->args.size() && rec->args[arg_index].descr) {
-                    signature += " = ";
-                    signature += rec->args[arg_index].descr;
-                }
-                // Separator for positional-only arguments (placed after the
-                // argument, rather than before like *
-                if (rec->nargs_pos_only > 0 && (arg_index + 1) == rec->nargs_pos_only) {
-                    signature += ", /";
-                }
-                if (!is_starred) {
-                    arg_index++;
-                }
-            } else if (c == '%') {
-                const std::type_info *t = types[type_index++];
-                if (!t) {
-                    pybind11_fail("Internal error while parsing type signature (1)");
-                }
-                if (auto *tinfo = detail::get_type_info(*t)) {
-                    handle th((PyObject *) tinfo->type);
-                    signature += th.attr("__module__").cast<std::string>() + "."
-                                 + th.attr("__qualname__").cast<std::string>();
-                } else if (rec->is_new_style_constructor && arg_index == 0) {
-                    // A new-style `__init__` takes `self` as `value_and_holder`.
-                    // Rewrite it to the proper class type.
-                    signature += rec->scope.attr("__module__").cast<std::string>() + "."
-                                 + rec->scope.attr("__qualname__").cast<std::string>();
-                } else {
-                    std::string tname(t->name());
-                    detail::clean_type_id(tname);
-                    signature += tname;
-                }
-            } else {
-                signature += c;
-            }
-        }
-
-        if (arg_index != args - rec->has_args - rec->has_kwargs || types[type_index] != nullptr) {
-            pybind11_fail("Internal error while parsing type signature (2)");
-        }
-
-        rec->signature = guarded_strdup(signature.c_str());
+        rec->signature_text = text;
+        rec->signature_types = types;
         rec->args.shrink_to_fit();
         rec->nargs = (std::uint16_t) args;
 
@@ -503,9 +1073,19 @@ protected:
             rec->def = new PyMethodDef();
             std::memset(rec->def, 0, sizeof(PyMethodDef));
             rec->def->ml_name = rec->name;
-            rec->def->ml_meth
-                = reinterpret_cast<PyCFunction>(reinterpret_cast<void (*)()>(dispatcher));
+#if defined(PYBIND11_HAS_METH_FASTCALL)
+            // Functions that only take positional arguments get a shortcut for the common case of
+            // being called with exactly those (see `dispatcher_simple`)
+            const bool simple = !rec->is_constructor && !rec->has_args && !rec->has_kwargs
+                                && rec->nargs_pos == rec->nargs;
+            rec->def->ml_meth = reinterpret_cast<PyCFunction>(
+                reinterpret_cast<void (*)()>(simple ? dispatcher_simple : dispatcher));
+            rec->def->ml_flags = METH_FASTCALL | METH_KEYWORDS;
+#else
+            rec->def->ml_meth = reinterpret_cast<PyCFunction>(
+                reinterpret_cast<void (*)()>(dispatcher_varargs));
             rec->def->ml_flags = METH_VARARGS | METH_KEYWORDS;
+#endif
 
             capsule rec_capsule(unique_rec.release(),
                                 detail::get_function_record_capsule_name(),
@@ -539,7 +1119,7 @@ protected:
                     "error while attempting to bind "
                     + std::string(rec->is_method ? "instance" : "static") + " method "
                     + std::string(pybind11::str(rec->scope.attr("__name__"))) + "."
-                    + std::string(rec->name) + signature
+                    + std::string(rec->name) + get_signature(rec)
 #endif
                 );
             }
@@ -550,6 +1130,8 @@ protected:
                 // chain.
                 chain_start = rec;
                 rec->next = chain;
+                delete chain->cache;
+                chain->cache = nullptr;
                 auto rec_capsule
                     = reinterpret_borrow<capsule>(((PyCFunctionObject *) m_ptr)->m_self);
                 rec_capsule.set_pointer(unique_rec.release());
@@ -557,6 +1139,8 @@ protected:
             } else {
                 // Or end of chain (normal behavior)
                 chain_start = chain;
+                delete chain->cache;
+                chain->cache = nullptr;
                 while (chain->next) {
                     chain = chain->next;
                 }
@@ -565,65 +1149,170 @@ protected:
             }
         }
 
+        chain_start->show_signatures = options::show_function_signatures();
+        chain_start->show_user_docstrings = options::show_user_defined_docstrings();
+        auto *pending = detail::current_pending_docstrings();
+        if (pending == nullptr) {
+            install_docstring(m_ptr);
+        } else if (pending->seen.insert(m_ptr).second) {
+            pending->functions.push_back(reinterpret_borrow<object>(m_ptr));
+        }
+        auto *func = (PyCFunctionObject *) m_ptr;
+
+        if (rec->is_method) {
+            m_ptr = PYBIND11_INSTANCE_METHOD_NEW(m_ptr, rec->scope.ptr());
+            if (!m_ptr) {
+                pybind11_fail(
+                    "cpp_function::cpp_function(): Could not allocate instance method object");
+            }
+            Py_DECREF(func);
+        }
+    }
+
+    /// Returns the signature of an overload, generating it from its `descr` text and types if
+    /// needed. The Python names of the types are looked up at this point, so that they can be
+    /// registered after the function is defined.
+    static const char *get_signature(const detail::function_record *crec) {
+        auto *rec = const_cast<detail::function_record *>(crec);
+        auto &storage = detail::function_record_storage::get();
+        if (const char *cached = storage.get_lazy(rec->signature)) {
+            return cached;
+        }
+        const auto *types = rec->signature_types;
+        std::string signature;
+        size_t type_index = 0, arg_index = 0;
+        bool is_starred = false;
+        for (const auto *pc = rec->signature_text; *pc != '\0'; ++pc) {
+            const auto c = *pc;
+
+            if (c == '{') {
+                // Write arg name for everything except *args and **kwargs.
+                is_starred = *(pc + 1) == '*';
+                if (is_starred) {
+                    continue;
+                }
+                // Separator for keyword-only arguments, placed before the kw
+                // arguments start (unless we are already putting an *args)
+                if (!rec->has_args && arg_index == rec->nargs_pos) {
+                    signature += "*, ";
+                }
+                if (arg_index < rec->args.size() && rec->args[arg_index].name) {
+                    signature += rec->args[arg_index].name;
+                } else if (arg_index == 0 && rec->is_method) {
+                    signature += "self";
+                } else {
+                    signature += "arg" + std::to_string(arg_index - (rec->is_method ? 1 : 0));
+                }
+                signature += ": ";
+            } else if (c == '}') {
+                // Write default value if available.
+                if (!is_starred && arg_index < rec->args.size()) {
+                    auto &arg = rec->args[arg_index];
+                    const char *descr = storage.get_lazy(arg.descr);
+                    if (!descr && arg.value) {
+                        descr = storage.set_lazy(arg.descr, repr(arg.value).cast<std::string>());
+                    }
+                    if (descr) {
+                        signature += " = ";
+                        signature += descr;
+                    }
+                }
+                // Separator for positional-only arguments (placed after the
+                // argument, rather than before like *
+                if (rec->nargs_pos_only > 0 && (arg_index + 1) == rec->nargs_pos_only) {
+                    signature += ", /";
+                }
+                if (!is_starred) {
+                    arg_index++;
+                }
+            } else if (c == '%') {
+                const std::type_info *t = types[type_index++];
+                if (!t) {
+                    pybind11_fail("Internal error while parsing type signature (1)");
+                }
+                if (auto *tinfo = detail::get_type_info(*t)) {
+                    handle th((PyObject *) tinfo->type);
+                    signature += th.attr("__module__").cast<std::string>() + "."
+                                 + th.attr("__qualname__").cast<std::string>();
+                } else if (rec->is_new_style_constructor && arg_index == 0) {
+                    // A new-style `__init__` takes `self` as `value_and_holder`.
+                    // Rewrite it to the proper class type.
+                    signature += rec->scope.attr("__module__").cast<std::string>() + "."
+                                 + rec->scope.attr("__qualname__").cast<std::string>();
+                } else {
+                    std::string tname(t->name());
+                    detail::clean_type_id(tname);
+                    signature += tname;
+                }
+            } else {
+                signature += c;
+            }
+        }
+
+        if (arg_index != size_t{rec->nargs} - rec->has_args - rec->has_kwargs
+            || types[type_index] != nullptr) {
+            pybind11_fail("Internal error while parsing type signature (2)");
+        }
+
+        return storage.set_lazy(rec->signature, signature);
+    }
+
+    /// Installs the docstring of a function object, made of the signatures and docstrings of the
+    /// functions in its overload chain
+    static void install_docstring(handle func_obj) {
+        auto *func = (PyCFunctionObject *) func_obj.ptr();
+        const auto *chain_start
+            = reinterpret_borrow<capsule>(func->m_self).get_pointer<detail::function_record>();
+        const bool overloaded = chain_start->next != nullptr;
+        const bool show_signatures = chain_start->show_signatures;
+        const bool show_user_docstrings = chain_start->show_user_docstrings;
+
         std::string signatures;
         int index = 0;
         /* Create a nice pydoc rec including all signatures and
            docstrings of the functions in the overload chain */
-        if (chain && options::show_function_signatures()) {
+        if (overloaded && show_signatures) {
             // First a generic signature
-            signatures += rec->name;
+            signatures += chain_start->name;
             signatures += "(*args, **kwargs)\n";
             signatures += "Overloaded function.\n\n";
         }
         // Then specific overload signatures
         bool first_user_def = true;
-        for (auto *it = chain_start; it != nullptr; it = it->next) {
-            if (options::show_function_signatures()) {
+        for (const auto *it = chain_start; it != nullptr; it = it->next) {
+            if (show_signatures) {
                 if (index > 0) {
                     signatures += '\n';
                 }
-                if (chain) {
+                if (overloaded) {
                     signatures += std::to_string(++index) + ". ";
                 }
-                signatures += rec->name;
-                signatures += it->signature;
+                signatures += chain_start->name;
+                signatures += get_signature(it);
                 signatures += '\n';
             }
-            if (it->doc && it->doc[0] != '\0' && options::show_user_defined_docstrings()) {
+            if (it->doc && it->doc[0] != '\0' && show_user_docstrings) {
                 // If we're appending another docstring, and aren't printing function signatures,
                 // we need to append a newline first:
-                if (!options::show_function_signatures()) {
+                if (!show_signatures) {
                     if (first_user_def) {
                         first_user_def = false;
                     } else {
                         signatures += '\n';
                     }
                 }
-                if (options::show_function_signatures()) {
+                if (show_signatures) {
                     signatures += '\n';
                 }
                 signatures += it->doc;
-                if (options::show_function_signatures()) {
+                if (show_signatures) {
                     signatures += '\n';
                 }
             }
         }
 
-        /* Install docstring */
-        auto *func = (PyCFunctionObject *) m_ptr;
-        std::free(const_cast<char *>(func->m_ml->ml_doc));
-        // Install docstring if it's non-empty (when at least one option is enabled)
-        func->m_ml->ml_doc
-            = signatures.empty() ? nullptr : PYBIND11_COMPAT_STRDUP(signatures.c_str());
-
-        if (rec->is_method) {
-            m_ptr = PYBIND11_INSTANCE_METHOD_NEW(m_ptr, rec->scope.ptr());
-            if (!m_ptr) {
-                pybind11_fail(
-                    "cpp_function::cpp_function(): Could not allocate instance method object");
-            }
-            Py_DECREF(func);
-        }
+        /* Install docstring if it's non-empty (when at least one option is enabled) */
+        detail::function_record_storage::get().set_docstring(func->m_ml->ml_doc, signatures);
     }
 
     /// When a cpp_function is GCed, release any memory allocated by pybind11
@@ -642,20 +1331,25 @@ protected:
             // During initialization, these strings might not have been copied yet,
             // so they cannot be freed. Once the function has been created, they can.
             // Check `make_function_record` for more details.
+            // The names are kept in the pool of the record storage.
             if (free_strings) {
-                std::free((char *) rec->name);
                 std::free((char *) rec->doc);
                 std::free((char *) rec->signature);
                 for (auto &arg : rec->args) {
-                    std::free(const_cast<char *>(arg.name));
                     std::free(const_cast<char *>(arg.descr));
                 }
             }
             for (auto &arg : rec->args) {
                 arg.value.dec_ref();
+                arg.name_obj.dec_ref();
             }
+            delete rec->cache;
+#if defined(PYBIND11_DISPATCH_STATS)
+            detail::get_dispatch_stats_state().functions.erase(rec);
+#endif
             if (rec->def) {
-                std::free(const_cast<char *>(rec->def->ml_doc));
+                detail::function_record_storage::get().set_docstring(rec->def->ml_doc,
+                                                                     std::string());
 // Python 3.9.0 decref's these in the wrong order; rec->def
 // If loaded on 3.9.0, let these leak (use Python 3.9.1 at runtime to fix)
 // See https://github.com/python/cpython/pull/22670
@@ -667,13 +1361,331 @@ protected:
                 delete rec->def;
 #endif
             }
-            delete rec;
+            detail::function_record_storage::get().destroy(rec);
             rec = next;
         }
     }
 
-    /// Main dispatch logic for calls to functions bound using pybind11
-    static PyObject *dispatcher(PyObject *self, PyObject *args_in, PyObject *kwargs_in) {
+#if !defined(PYBIND11_HAS_METH_FASTCALL)
+    /// Adapts the `METH_VARARGS | METH_KEYWORDS` calling convention to `dispatcher`
+    static PyObject *dispatcher_varargs(PyObject *self, PyObject *args_in, PyObject *kwargs_in) {
+        const auto n_args_in = PyTuple_GET_SIZE(args_in);
+        const auto n_kwargs_in = kwargs_in ? PyDict_Size(kwargs_in) : 0;
+        std::vector<PyObject *> args(static_cast<size_t>(n_args_in + n_kwargs_in));
+        for (ssize_t i = 0; i < n_args_in; ++i) {
+            args[static_cast<size_t>(i)] = PyTuple_GET_ITEM(args_in, i);
+        }
+        object kwnames;
+        if (n_kwargs_in > 0) {
+            kwnames = reinterpret_steal<object>(PyTuple_New(n_kwargs_in));
+            if (!kwnames) {
+                return nullptr;
+            }
+            PyObject *key = nullptr, *value = nullptr;
+            ssize_t pos = 0, i = 0;
+            while (PyDict_Next(kwargs_in, &pos, &key, &value)) {
+                Py_INCREF(key);
+                PyTuple_SET_ITEM(kwnames.ptr(), i, key);
+                args[static_cast<size_t>(n_args_in + i)] = value;
+                ++i;
+            }
+        }
+        return dispatcher(self, args.data(), n_args_in, kwnames.ptr());
+    }
+#endif
+
+#if defined(PYBIND11_HAS_METH_FASTCALL)
+    /// Dispatcher for functions without overloads, `py::args`, `py::kwargs` or keyword-only
+    /// arguments, when called with exactly their number of positional arguments: these are
+    /// passed straight to `function_record::impl`. Anything else goes through the general
+    /// `dispatcher`.
+    static PyObject *dispatcher_simple(PyObject *self,
+                                       PyObject *const *args_in,
+                                       ssize_t nargs_in,
+                                       PyObject *kwnames_in) {
+        using namespace detail;
+        assert(isinstance<capsule>(self));
+
+        const function_record *rec = reinterpret_cast<function_record *>(
+            PyCapsule_GetPointer(self, get_function_record_capsule_name()));
+        assert(rec != nullptr);
+
+        // Overloads may have been added after the function object was created
+        const auto n_args_in = (size_t) nargs_in;
+        if (rec->next != nullptr || kwnames_in != nullptr || n_args_in != rec->nargs) {
+            return dispatcher(self, args_in, nargs_in, kwnames_in);
+        }
+
+        function_call call(*rec, n_args_in > 0 ? args_in[0] : nullptr);
+        for (size_t i = 0; i < n_args_in; ++i) {
+            const argument_record *arg_rec = i < rec->args.size() ? &rec->args[i] : nullptr;
+            handle arg(args_in[i]);
+            if (arg_rec && !arg_rec->none && arg.is_none()) {
+                return dispatcher(self, args_in, nargs_in, kwnames_in);
+            }
+            call.args.push_back(arg);
+            call.args_convert.push_back(arg_rec ? arg_rec->convert : true);
+        }
+
+        handle result;
+        try {
+            result = call_impl(call);
+        } catch (...) {
+            return handle_active_exception();
+        }
+
+        if (result.ptr() == PYBIND11_TRY_NEXT_OVERLOAD) {
+            // There is no other overload to try. The function may also have thrown a
+            // `reference_cast_error` itself, and must then not be called a second time.
+            return no_matching_overload(rec, args_in, n_args_in, kwnames_in);
+        }
+        if (!result) {
+            return raise_return_value_error(*rec);
+        }
+        return result.ptr();
+    }
+#endif
+
+    /// Runs a single overload for the given call. Returns `PYBIND11_TRY_NEXT_OVERLOAD` if the
+    /// arguments could not be loaded or cast, or if the function threw a `reference_cast_error`
+    /// (`function_call::args_failed` tells these apart).
+    static handle call_impl(detail::function_call &call, bool conversion_pass = false) {
+#if defined(PYBIND11_DISPATCH_STATS)
+        detail::dispatch_stats_scope stats_scope(call.func, conversion_pass);
+#else
+        (void) conversion_pass;
+#endif
+        handle result;
+        try {
+            detail::loader_life_support guard{};
+            result = call.func.impl(call);
+        } catch (reference_cast_error &) {
+            result = PYBIND11_TRY_NEXT_OVERLOAD;
+        }
+#if defined(PYBIND11_DISPATCH_STATS)
+        if (result.ptr() == PYBIND11_TRY_NEXT_OVERLOAD) {
+            stats_scope.set_missed();
+        }
+#endif
+        if (result.ptr() == PYBIND11_TRY_NEXT_OVERLOAD) {
+            PYBIND11_TRACE(overload_failed, call.func.name, &call.func);
+        }
+        return result;
+    }
+
+    /// Translates the exception currently being handled into a Python error, giving each
+    /// registered exception translator a chance to handle it. Must be called from a `catch`
+    /// block. Always returns `nullptr`.
+    static PyObject *handle_active_exception() {
+        try {
+            throw;
+        } catch (error_already_set &e) {
+            e.restore();
+            return nullptr;
+#ifdef __GLIBCXX__
+        } catch (abi::__forced_unwind &) {
+            throw;
+#endif
+        } catch (...) {
+            /* When an exception is caught, give each registered exception
+               translator a chance to translate it to a Python exception. First
+               all module-local translators will be tried in reverse order of
+               registration. If none of the module-locale translators handle
+               the exception (or there are no module-locale translators) then
+               the global translators will be tried, also in reverse order of
+               registration.
+
+               A translator may choose to do one of the following:
+
+                - catch the exception and call PyErr_SetString or PyErr_SetObject
+                  to set a standard (or custom) Python exception, or
+                - do nothing and let the exception fall through to the next translator, or
+                - delegate translation to the next translator by throwing a new type of exception.
+             */
+
+#if defined(Py_GIL_DISABLED)
+            // Copied, so that the translators run without the lock (and may register others)
+            auto translators = detail::with_internals([](detail::internals &internals) {
+                return std::make_pair(
+                    detail::get_local_internals().registered_exception_translators,
+                    internals.registered_exception_translators);
+            });
+            auto &local_exception_translators = translators.first;
+            auto &exception_translators = translators.second;
+#else
+            auto &local_exception_translators
+                = detail::get_local_internals().registered_exception_translators;
+            auto &exception_translators = detail::get_internals().registered_exception_translators;
+#endif
+            const auto original_exception = std::current_exception();
+            auto exception = original_exception;
+            ExceptionTranslator handled_by = nullptr;
+
+#if defined(PYBIND11_HAS_EXCEPTION_TRANSLATOR_CACHE)
+            auto &cache = detail::get_exception_translator_cache();
+            const std::type_info *type = abi::__cxa_current_exception_type();
+            if (auto translator
+                = cache.find(type, local_exception_translators, exception_translators)) {
+                try {
+                    translator(original_exception);
+                    return nullptr;
+                } catch (...) {
+                    // Declined after all: try the whole chain
+                }
+            }
+#endif
+
+            if (detail::apply_exception_translators(
+                    local_exception_translators, exception, handled_by)
+                || detail::apply_exception_translators(
+                    exception_translators, exception, handled_by)) {
+#if defined(PYBIND11_HAS_EXCEPTION_TRANSLATOR_CACHE)
+                if (exception == original_exception) {
+                    cache.store(type, handled_by);
+                }
+#endif
+                return nullptr;
+            }
+
+            PyErr_SetString(PyExc_SystemError,
+                            "Exception escaped from default exception translator!");
+            return nullptr;
+        }
+    }
+
+    static void append_note_if_missing_header_is_suspected(std::string &msg) {
+        if (msg.find("std::") != std::string::npos) {
+            msg += "\n\n"
+                   "Did you forget to `#include <pybind11/stl.h>`? Or <pybind11/complex.h>,\n"
+                   "<pybind11/functional.h>, <pybind11/chrono.h>, etc. Some automatic\n"
+                   "conversions are optional and require extra headers to be included\n"
+                   "when compiling your pybind11 module.";
+        }
+    }
+
+    /// Raises the error for a function whose return value could not be converted to Python, or
+    /// passes on the error the function returned. Always returns `nullptr`.
+    static PyObject *raise_return_value_error(const detail::function_record &func) {
+        if (func.returns_error && PyErr_Occurred()) {
+            // The function returned an error to raise (e.g. a `py::result<T>`)
+            return nullptr;
+        }
+        std::string msg = "Unable to convert function return value to a "
+                          "Python type! The signature was\n\t";
+        {
+            // Generating the signature runs Python code, which must not see the pending error
+            error_scope scope;
+            msg += get_signature(&func);
+        }
+        append_note_if_missing_header_is_suspected(msg);
+        // Attach additional error info to the exception if supported
+        if (PyErr_Occurred()) {
+            raise_from(PyExc_TypeError, msg.c_str());
+            return nullptr;
+        }
+        PyErr_SetString(PyExc_TypeError, msg.c_str());
+        return nullptr;
+    }
+
+    /// Returns `NotImplemented` for an operator, and otherwise raises the `TypeError` for a call
+    /// that matches none of the `overloads` (the function record and its chain), listing their
+    /// signatures and the arguments given. Returns `nullptr` if the error is raised.
+    static PyObject *no_matching_overload(const detail::function_record *overloads,
+                                          PyObject *const *args_in,
+                                          size_t n_args_in,
+                                          PyObject *kwnames_in) {
+        if (overloads->is_operator) {
+            return handle(Py_NotImplemented).inc_ref().ptr();
+        }
+
+        const auto n_kwargs_in = kwnames_in ? (size_t) PyTuple_GET_SIZE(kwnames_in) : 0;
+        std::string msg = std::string(overloads->name) + "(): incompatible "
+                          + std::string(overloads->is_constructor ? "constructor" : "function")
+                          + " arguments. The following argument types are supported:\n";
+
+        int ctr = 0;
+        for (const auto *it2 = overloads; it2 != nullptr; it2 = it2->next) {
+            msg += "    " + std::to_string(++ctr) + ". ";
+
+            bool wrote_sig = false;
+            if (overloads->is_constructor) {
+                // For a constructor, rewrite `(self: Object, arg0, ...) -> NoneType` as
+                // `Object(arg0, ...)`
+                std::string sig = get_signature(it2);
+                size_t start = sig.find('(') + 7; // skip "(self: "
+                if (start < sig.size()) {
+                    // End at the , for the next argument
+                    size_t end = sig.find(", "), next = end + 2;
+                    size_t ret = sig.rfind(" -> ");
+                    // Or the ), if there is no comma:
+                    if (end >= sig.size()) {
+                        next = end = sig.find(')');
+                    }
+                    if (start < end && next < sig.size()) {
+                        msg.append(sig, start, end - start);
+                        msg += '(';
+                        msg.append(sig, next, ret - next);
+                        wrote_sig = true;
+                    }
+                }
+            }
+            if (!wrote_sig) {
+                msg += get_signature(it2);
+            }
+
+            msg += '\n';
+        }
+        msg += "\nInvoked with: ";
+        bool some_args = false;
+        for (size_t ti = overloads->is_constructor ? 1 : 0; ti < n_args_in; ++ti) {
+            if (!some_args) {
+                some_args = true;
+            } else {
+                msg += ", ";
+            }
+            try {
+                msg += pybind11::repr(args_in[ti]);
+            } catch (const error_already_set &) {
+                msg += "<repr raised Error>";
+            }
+        }
+        if (n_kwargs_in > 0) {
+            if (some_args) {
+                msg += "; ";
+            }
+            msg += "kwargs: ";
+            for (size_t i = 0; i < n_kwargs_in; ++i) {
+                if (i > 0) {
+                    msg += ", ";
+                }
+                msg += pybind11::str("{}=").format(
+                    handle(PyTuple_GET_ITEM(kwnames_in, (ssize_t) i)));
+                try {
+                    msg += pybind11::repr(args_in[n_args_in + i]);
+                } catch (const error_already_set &) {
+                    msg += "<repr raised Error>";
+                }
+            }
+        }
+
+        append_note_if_missing_header_is_suspected(msg);
+        // Attach additional error info to the exception if supported
+        if (PyErr_Occurred()) {
+            // #HelpAppreciated: unit test coverage for this branch.
+            raise_from(PyExc_TypeError, msg.c_str());
+            return nullptr;
+        }
+        PyErr_SetString(PyExc_TypeError, msg.c_str());
+        return nullptr;
+    }
+
+    /// Main dispatch logic for calls to functions bound using pybind11. This uses the
+    /// `METH_FASTCALL | METH_KEYWORDS` calling convention: the positional arguments are followed
+    /// by the values of the keyword arguments named in the `kwnames_in` tuple (if any).
+    static PyObject *dispatcher(PyObject *self,
+                                PyObject *const *args_in,
+                                ssize_t nargs_in,
+                                PyObject *kwnames_in) {
         using namespace detail;
         assert(isinstance<capsule>(self));
 
@@ -685,9 +1697,10 @@ protected:
 
         /* Need to know how many arguments + keyword arguments there are to pick the right
            overload */
-        const auto n_args_in = (size_t) PyTuple_GET_SIZE(args_in);
+        const auto n_args_in = (size_t) nargs_in;
+        const auto n_kwargs_in = kwnames_in ? (size_t) PyTuple_GET_SIZE(kwnames_in) : 0;
 
-        handle parent = n_args_in > 0 ? PyTuple_GET_ITEM(args_in, 0) : nullptr,
+        handle parent = n_args_in > 0 ? args_in[0] : nullptr,
                result = PYBIND11_TRY_NEXT_OVERLOAD;
 
         auto self_value_and_holder = value_and_holder();
@@ -715,34 +1728,52 @@ protected:
             // We do this in two passes: in the first pass, we load arguments with `convert=false`;
             // in the second, we allow conversion (except for arguments with an explicit
             // py::arg().noconvert()).  This lets us prefer calls without conversion, with
-            // conversion as a fallback.
-            std::vector<function_call> second_pass;
+            // conversion as a fallback. Only the overloads are kept for the second pass, whose
+            // calls are collected again: the first pass does not need to keep its calls around.
+            small_vector<const function_record *, 4> second_pass;
 
             // However, if there are no overloads, we can just skip the no-convert pass entirely
             const bool overloaded = it != nullptr && it->next != nullptr;
 
-            for (; it != nullptr; it = it->next) {
-
-                /* For each overload:
-                   1. Copy all positional arguments we were given, also checking to make sure that
-                      named positional arguments weren't *also* specified via kwarg.
-                   2. If we weren't given enough, try to make up the omitted ones by checking
-                      whether they were provided by a kwarg matching the `py::arg("name")` name. If
-                      so, use it (and remove it from kwargs); if not, see if the function binding
-                      provided a default that we can use.
-                   3. Ensure that either all keyword arguments were "consumed", or that the
-                   function takes a kwargs argument to accept unconsumed kwargs.
-                   4. Any positional arguments still left get put into a tuple (for args), and any
-                      leftover kwargs get put into a dict.
-                   5. Pack everything into a vector; if we have py::args or py::kwargs, they are an
-                      extra tuple or dict at the end of the positional arguments.
-                   6. Call the function call dispatcher (function_record::impl)
-
-                   If one of these fail, move on to the next overload and keep trying until we get
-                   a result other than PYBIND11_TRY_NEXT_OVERLOAD.
-                 */
+            // If these argument types matched an overload before, try that one right away (see
+            // `overload_cache`). Should it not match after all, start over without skipping.
+            const ssize_t cache_slot
+                = overloaded ? overload_cache::slot(args_in, n_args_in, kwnames_in) : -1;
+            const function_record *cached_overload
+                = cache_slot >= 0 && overloads->cache != nullptr
+                      ? overloads->cache->find(cache_slot, args_in, n_args_in, kwnames_in)
+                      : nullptr;
+            auto next_overload = [&](const function_record *current) -> const function_record * {
+                if (current == cached_overload) {
+                    cached_overload = nullptr;
+                    second_pass.clear();
+                    return overloads;
+                }
+                return current->next;
+            };
+
+            /* For each overload:
+               1. Copy all positional arguments we were given, also checking to make sure that
+                  named positional arguments weren't *also* specified via kwarg.
+               2. If we weren't given enough, try to make up the omitted ones by checking
+                  whether they were provided by a kwarg matching the `py::arg("name")` name. If
+                  so, use it (and remove it from kwargs); if not, see if the function binding
+                  provided a default that we can use.
+               3. Ensure that either all keyword arguments were "consumed", or that the
+               function takes a kwargs argument to accept unconsumed kwargs.
+               4. Any positional arguments still left get put into a tuple (for args), and any
+                  leftover kwargs get put into a dict.
+               5. Pack everything into a vector; if we have py::args or py::kwargs, they are an
+                  extra tuple or dict at the end of the positional arguments.
+               6. Call the function call dispatcher (function_record::impl)
+
+               If one of these fail, move on to the next overload and keep trying until we get
+               a result other than PYBIND11_TRY_NEXT_OVERLOAD.
+             */
 
-                const function_record &func = *it;
+            // Steps 1 to 4: collects the arguments of `call`, or returns false if they do not fit
+            // the overload
+            auto collect_args = [&](const function_record &func, function_call &call) -> bool {
                 size_t num_args = func.nargs; // Number of positional arguments that we need
                 if (func.has_args) {
                     --num_args; // (but don't count py::args
@@ -753,16 +1784,15 @@ protected:
                 size_t pos_args = func.nargs_pos;
 
                 if (!func.has_args && n_args_in > pos_args) {
-                    continue; // Too many positional arguments for this overload
+                    return false; // Too many positional arguments for this overload
                 }
 
                 if (n_args_in < pos_args && func.args.size() < pos_args) {
-                    continue; // Not enough positional arguments given, and not enough defaults to
-                              // fill in the blanks
+                    // Not enough positional arguments given, and not enough defaults to fill in
+                    // the blanks
+                    return false;
                 }
 
-                function_call call(func, parent);
-
                 // Protect std::min with parentheses
                 size_t args_to_copy = (std::min)(pos_args, n_args_in);
                 size_t args_copied = 0;
@@ -775,7 +1805,7 @@ protected:
                         self_value_and_holder.type->dealloc(self_value_and_holder);
                     }
 
-                    call.init_self = PyTuple_GET_ITEM(args_in, 0);
+                    call.init_self = args_in[0];
                     call.args.emplace_back(reinterpret_cast<PyObject *>(&self_value_and_holder));
                     call.args_convert.push_back(false);
                     ++args_copied;
@@ -786,13 +1816,13 @@ protected:
                 for (; args_copied < args_to_copy; ++args_copied) {
                     const argument_record *arg_rec
                         = args_copied < func.args.size() ? &func.args[args_copied] : nullptr;
-                    if (kwargs_in && arg_rec && arg_rec->name
-                        && dict_getitemstring(kwargs_in, arg_rec->name)) {
+                    if (kwnames_in && arg_rec && arg_rec->name
+                        && find_keyword_argument(kwnames_in, *arg_rec) >= 0) {
                         bad_arg = true;
                         break;
                     }
 
-                    handle arg(PyTuple_GET_ITEM(args_in, args_copied));
+                    handle arg(args_in[args_copied]);
                     if (arg_rec && !arg_rec->none && arg.is_none()) {
                         bad_arg = true;
                         break;
@@ -801,15 +1831,15 @@ protected:
                     call.args_convert.push_back(arg_rec ? arg_rec->convert : true);
                 }
                 if (bad_arg) {
-                    continue; // Maybe it was meant for another overload (issue #688)
+                    return false; // Maybe it was meant for another overload (issue #688)
                 }
 
                 // Keep track of how many position args we copied out in case we need to come back
                 // to copy the rest into a py::args argument.
                 size_t positional_args_copied = args_copied;
 
-                // We'll need to copy this if we steal some kwargs for defaults
-                dict kwargs = reinterpret_borrow<dict>(kwargs_in);
+                // Number of keyword arguments matched to named arguments so far
+                size_t kwargs_consumed = 0;
 
                 // 1.5. Fill in any missing pos_only args from defaults if they exist
                 if (args_copied < func.nargs_pos_only) {
@@ -829,32 +1859,27 @@ protected:
                     }
 
                     if (args_copied < func.nargs_pos_only) {
-                        continue; // Not enough defaults to fill the positional arguments
+                        return false; // Not enough defaults to fill the positional arguments
                     }
                 }
 
                 // 2. Check kwargs and, failing that, defaults that may help complete the list
+                const size_t kwargs_args_start = args_copied;
                 if (args_copied < num_args) {
-                    bool copied_kwargs = false;
-
                     for (; args_copied < num_args; ++args_copied) {
                         const auto &arg_rec = func.args[args_copied];
 
                         handle value;
-                        if (kwargs_in && arg_rec.name) {
-                            value = dict_getitemstring(kwargs.ptr(), arg_rec.name);
+                        if (kwnames_in && arg_rec.name) {
+                            const auto kw_index = find_keyword_argument(kwnames_in, arg_rec);
+                            if (kw_index >= 0) {
+                                // Consume a kwargs value
+                                value = args_in[n_args_in + (size_t) kw_index];
+                                ++kwargs_consumed;
+                            }
                         }
 
-                        if (value) {
-                            // Consume a kwargs value
-                            if (!copied_kwargs) {
-                                kwargs = reinterpret_steal<dict>(PyDict_Copy(kwargs.ptr()));
-                                copied_kwargs = true;
-                            }
-                            if (PyDict_DelItemString(kwargs.ptr(), arg_rec.name) == -1) {
-                                throw error_already_set();
-                            }
-                        } else if (arg_rec.value) {
+                        if (!value && arg_rec.value) {
                             value = arg_rec.value;
                         }
 
@@ -877,30 +1902,28 @@ protected:
                     }
 
                     if (args_copied < num_args) {
-                        continue; // Not enough arguments, defaults, or kwargs to fill the
-                                  // positional arguments
+                        return false; // Not enough arguments, defaults, or kwargs to fill the
+                                       // positional arguments
                     }
                 }
 
                 // 3. Check everything was consumed (unless we have a kwargs arg)
-                if (kwargs && !kwargs.empty() && !func.has_kwargs) {
-                    continue; // Unconsumed kwargs, but no py::kwargs argument to accept them
+                if (kwargs_consumed < n_kwargs_in && !func.has_kwargs) {
+                    return false; // Unconsumed kwargs, but no py::kwargs argument to accept them
                 }
 
                 // 4a. If we have a py::args argument, create a new tuple with leftovers
                 if (func.has_args) {
                     tuple extra_args;
-                    if (args_to_copy == 0) {
-                        // We didn't copy out any position arguments from the args_in tuple, so we
-                        // can reuse it directly without copying:
-                        extra_args = reinterpret_borrow<tuple>(args_in);
-                    } else if (positional_args_copied >= n_args_in) {
+                    if (positional_args_copied >= n_args_in) {
                         extra_args = tuple(0);
                     } else {
                         size_t args_size = n_args_in - positional_args_copied;
                         extra_args = tuple(args_size);
                         for (size_t i = 0; i < args_size; ++i) {
-                            extra_args[i] = PyTuple_GET_ITEM(args_in, positional_args_copied + i);
+                            PyObject *arg = args_in[positional_args_copied + i];
+                            Py_INCREF(arg);
+                            PyTuple_SET_ITEM(extra_args.ptr(), (ssize_t) i, arg);
                         }
                     }
                     if (call.args.size() <= func.nargs_pos) {
@@ -914,13 +1937,45 @@ protected:
 
                 // 4b. If we have a py::kwargs, pass on any remaining kwargs
                 if (func.has_kwargs) {
-                    if (!kwargs.ptr()) {
-                        kwargs = dict(); // If we didn't get one, send an empty one
+                    dict kwargs;
+                    for (size_t i = 0; i < n_kwargs_in; ++i) {
+                        handle key = PyTuple_GET_ITEM(kwnames_in, (ssize_t) i);
+                        if (kwargs_consumed > 0) {
+                            // Skip the keyword arguments that were matched to named arguments
+                            bool consumed = false;
+                            for (size_t a = kwargs_args_start; a < num_args; ++a) {
+                                const argument_record &arg_rec = func.args[a];
+                                if (arg_rec.name && keyword_matches(key.ptr(), arg_rec)) {
+                                    consumed = true;
+                                    break;
+                                }
+                            }
+                            if (consumed) {
+                                continue;
+                            }
+                        }
+                        if (PyDict_SetItem(kwargs.ptr(), key.ptr(), args_in[n_args_in + i])
+                            != 0) {
+                            throw error_already_set();
+                        }
                     }
                     call.args.push_back(kwargs);
                     call.args_convert.push_back(false);
                     call.kwargs_ref = std::move(kwargs);
                 }
+                return true;
+            };
+
+            for (; it != nullptr; it = next_overload(it)) {
+                if (cached_overload != nullptr && it != cached_overload && it->loads_by_type) {
+                    continue; // Known not to match these argument types
+                }
+
+                const function_record &func = *it;
+                function_call call(func, parent);
+                if (!collect_args(func, call)) {
+                    continue;
+                }
 
 // 5. Put everything in a vector.  Not technically step 5, we've been building it
 // in `call.args` all along.
@@ -931,7 +1986,7 @@ protected:
                 }
 #endif
 
-                std::vector<bool> second_pass_convert;
+                decltype(call.args_convert) second_pass_convert;
                 if (overloaded) {
                     // We're in the first no-convert pass, so swap out the conversion flags for a
                     // set of all-false flags.  If the call fails, we'll swap the flags back in for
@@ -941,12 +1996,7 @@ protected:
                 }
 
                 // 6. Call the function.
-                try {
-                    loader_life_support guard{};
-                    result = func.impl(call);
-                } catch (reference_cast_error &) {
-                    result = PYBIND11_TRY_NEXT_OVERLOAD;
-                }
+                result = call_impl(call);
 
                 if (result.ptr() != PYBIND11_TRY_NEXT_OVERLOAD) {
                     break;
@@ -956,199 +2006,408 @@ protected:
                     // The (overloaded) call failed; if the call has at least one argument that
                     // permits conversion (i.e. it hasn't been explicitly specified `.noconvert()`)
                     // then add this call to the list of second pass overloads to try.
-                    for (size_t i = func.is_method ? 1 : 0; i < pos_args; i++) {
+                    for (size_t i = func.is_method ? 1 : 0; i < func.nargs_pos; i++) {
                         if (second_pass_convert[i]) {
-                            // Found one: swap the converting flags back in and store the call for
-                            // the second pass.
-                            call.args_convert.swap(second_pass_convert);
-                            second_pass.push_back(std::move(call));
+                            second_pass.push_back(&func);
                             break;
                         }
                     }
                 }
             }
 
+            if (cache_slot >= 0 && result.ptr() != PYBIND11_TRY_NEXT_OVERLOAD
+                && it != cached_overload) {
+                // The cache lives in the first record of the chain, which is otherwise immutable
+                auto *chain_head = const_cast<function_record *>(overloads);
+                if (chain_head->cache == nullptr) {
+                    chain_head->cache = new overload_cache();
+                }
+                chain_head->cache->store(cache_slot, args_in, n_args_in, kwnames_in, it);
+            }
+
             if (overloaded && !second_pass.empty() && result.ptr() == PYBIND11_TRY_NEXT_OVERLOAD) {
                 // The no-conversion pass finished without success, try again with conversion
                 // allowed
-                for (auto &call : second_pass) {
-                    try {
-                        loader_life_support guard{};
-                        result = call.func.impl(call);
-                    } catch (reference_cast_error &) {
-                        result = PYBIND11_TRY_NEXT_OVERLOAD;
-                    }
+                for (const function_record *func : second_pass) {
+                    // The arguments fitted this overload in the first pass already
+                    function_call call(*func, parent);
+                    collect_args(*func, call);
+                    result = call_impl(call, /*conversion_pass=*/true);
 
                     if (result.ptr() != PYBIND11_TRY_NEXT_OVERLOAD) {
                         // The error reporting logic below expects 'it' to be valid, as it would be
                         // if we'd encountered this failure in the first-pass loop.
                         if (!result) {
-                            it = &call.func;
+                            it = func;
                         }
                         break;
                     }
                 }
             }
-        } catch (error_already_set &e) {
-            e.restore();
-            return nullptr;
-#ifdef __GLIBCXX__
-        } catch (abi::__forced_unwind &) {
-            throw;
-#endif
         } catch (...) {
-            /* When an exception is caught, give each registered exception
-               translator a chance to translate it to a Python exception. First
-               all module-local translators will be tried in reverse order of
-               registration. If none of the module-locale translators handle
-               the exception (or there are no module-locale translators) then
-               the global translators will be tried, also in reverse order of
-               registration.
+            return handle_active_exception();
+        }
 
-               A translator may choose to do one of the following:
+        if (result.ptr() == PYBIND11_TRY_NEXT_OVERLOAD) {
+            return no_matching_overload(overloads, args_in, n_args_in, kwnames_in);
+        }
+        if (!result) {
+            return raise_return_value_error(*it);
+        }
+        if (overloads->is_constructor && !self_value_and_holder.holder_constructed()) {
+            auto *pi = reinterpret_cast<instance *>(parent.ptr());
+            self_value_and_holder.type->init_instance(pi, nullptr);
+        }
+        return result.ptr();
+    }
+};
 
-                - catch the exception and call PyErr_SetString or PyErr_SetObject
-                  to set a standard (or custom) Python exception, or
-                - do nothing and let the exception fall through to the next translator, or
-                - delegate translation to the next translator by throwing a new type of exception.
-             */
+PYBIND11_NAMESPACE_BEGIN(detail)
 
-            auto &local_exception_translators
-                = get_local_internals().registered_exception_translators;
-            if (detail::apply_exception_translators(local_exception_translators)) {
-                return nullptr;
-            }
-            auto &exception_translators = get_internals().registered_exception_translators;
-            if (detail::apply_exception_translators(exception_translators)) {
-                return nullptr;
-            }
+/// Returns the signature of the overload `rec`, which is generated when it is first needed
+inline const char *get_function_signature(const function_record &rec) {
+    return cpp_function::get_signature(&rec);
+}
 
-            PyErr_SetString(PyExc_SystemError,
-                            "Exception escaped from default exception translator!");
-            return nullptr;
+/// Translates the exception currently being handled into a Python error, like the function
+/// dispatcher does. Must be called from a `catch` block. Always returns `nullptr`.
+inline PyObject *handle_active_exception() { return cpp_function::handle_active_exception(); }
+
+/// Defers the docstrings of the functions defined in its scope, on the same thread, until
+/// `finish()`: they are generated once for each function, rather than once per overload, and
+/// name the Python types registered after the function. Nested scopes leave the functions to the
+/// outermost one.
+class deferred_docstrings {
+public:
+    deferred_docstrings() {
+        if (current_pending_docstrings() == nullptr) {
+            current_pending_docstrings() = &m_pending;
+            m_active = true;
+        }
+    }
+    deferred_docstrings(const deferred_docstrings &) = delete;
+    deferred_docstrings &operator=(const deferred_docstrings &) = delete;
+
+    /// If `finish()` was not called (an exception is propagating), the pending functions keep
+    /// their previous docstrings
+    ~deferred_docstrings() {
+        if (m_active) {
+            current_pending_docstrings() = nullptr;
         }
+    }
 
-        auto append_note_if_missing_header_is_suspected = [](std::string &msg) {
-            if (msg.find("std::") != std::string::npos) {
-                msg += "\n\n"
-                       "Did you forget to `#include <pybind11/stl.h>`? Or <pybind11/complex.h>,\n"
-                       "<pybind11/functional.h>, <pybind11/chrono.h>, etc. Some automatic\n"
-                       "conversions are optional and require extra headers to be included\n"
-                       "when compiling your pybind11 module.";
-            }
-        };
+    /// Generates the pending docstrings, and ends the scope
+    void finish() {
+        if (!m_active) {
+            return;
+        }
+        current_pending_docstrings() = nullptr;
+        m_active = false;
+        for (const auto &func : m_pending.functions) {
+            cpp_function::install_docstring(func);
+        }
+        m_pending.functions.clear();
+    }
 
-        if (result.ptr() == PYBIND11_TRY_NEXT_OVERLOAD) {
-            if (overloads->is_operator) {
-                return handle(Py_NotImplemented).inc_ref().ptr();
-            }
-
-            std::string msg = std::string(overloads->name) + "(): incompatible "
-                              + std::string(overloads->is_constructor ? "constructor" : "function")
-                              + " arguments. The following argument types are supported:\n";
-
-            int ctr = 0;
-            for (const function_record *it2 = overloads; it2 != nullptr; it2 = it2->next) {
-                msg += "    " + std::to_string(++ctr) + ". ";
-
-                bool wrote_sig = false;
-                if (overloads->is_constructor) {
-                    // For a constructor, rewrite `(self: Object, arg0, ...) -> NoneType` as
-                    // `Object(arg0, ...)`
-                    std::string sig = it2->signature;
-                    size_t start = sig.find('(') + 7; // skip "(self: "
-                    if (start < sig.size()) {
-                        // End at the , for the next argument
-                        size_t end = sig.find(", "), next = end + 2;
-                        size_t ret = sig.rfind(" -> ");
-                        // Or the ), if there is no comma:
-                        if (end >= sig.size()) {
-                            next = end = sig.find(')');
-                        }
-                        if (start < end && next < sig.size()) {
-                            msg.append(sig, start, end - start);
-                            msg += '(';
-                            msg.append(sig, next, ret - next);
-                            wrote_sig = true;
-                        }
-                    }
-                }
-                if (!wrote_sig) {
-                    msg += it2->signature;
-                }
+private:
+    pending_docstrings m_pending;
+    bool m_active = false;
+};
 
-                msg += '\n';
-            }
-            msg += "\nInvoked with: ";
-            auto args_ = reinterpret_borrow<tuple>(args_in);
-            bool some_args = false;
-            for (size_t ti = overloads->is_constructor ? 1 : 0; ti < args_.size(); ++ti) {
-                if (!some_args) {
-                    some_args = true;
-                } else {
-                    msg += ", ";
-                }
-                try {
-                    msg += pybind11::repr(args_[ti]);
-                } catch (const error_already_set &) {
-                    msg += "<repr raised Error>";
-                }
-            }
-            if (kwargs_in) {
-                auto kwargs = reinterpret_borrow<dict>(kwargs_in);
-                if (!kwargs.empty()) {
-                    if (some_args) {
-                        msg += "; ";
-                    }
-                    msg += "kwargs: ";
-                    bool first = true;
-                    for (auto kwarg : kwargs) {
-                        if (first) {
-                            first = false;
-                        } else {
-                            msg += ", ";
-                        }
-                        msg += pybind11::str("{}=").format(kwarg.first);
-                        try {
-                            msg += pybind11::repr(kwarg.second);
-                        } catch (const error_already_set &) {
-                            msg += "<repr raised Error>";
-                        }
+/// Returns the record of the first overload of a function (or method) created by pybind11, or
+/// nullptr for other objects
+inline function_record *get_function_record(handle h) {
+    h = get_function(h);
+    if (!h || !PyCFunction_Check(h.ptr())) {
+        return nullptr;
+    }
+
+    handle func_self = PyCFunction_GET_SELF(h.ptr());
+    if (!func_self) {
+        throw error_already_set();
+    }
+    if (!isinstance<capsule>(func_self)) {
+        return nullptr;
+    }
+    auto cap = reinterpret_borrow<capsule>(func_self);
+    if (!is_function_record_capsule(cap)) {
+        return nullptr;
+    }
+    return cap.get_pointer<function_record>();
+}
+
+/// Calls the overload `rec` from C++, straight through its `impl` and without building a Python
+/// call, if it takes exactly the `nargs` positional arguments in `args` (for a method, the first
+/// one is `self`); other overloads in its chain are ignored. Without `convert`, the arguments
+/// are loaded without implicit conversions, as in the first pass of the dispatcher over the
+/// overloads. Returns a null object (and the function is not invoked) if the call cannot be made
+/// this way, including if the arguments fail to load or cast. Exceptions thrown by the function
+/// are not translated but propagate to the caller. A `reference_cast_error` thrown by the
+/// function is reported like the dispatcher does when no overload matches, listing `overloads`
+/// (by default `rec` and the rest of its chain), and the function is not called again.
+inline object call_overload(const function_record &rec,
+                            PyObject *const *args,
+                            size_t nargs,
+                            bool convert,
+                            const function_record *overloads) {
+    if (rec.is_constructor || rec.has_args || rec.has_kwargs || rec.nargs_pos != rec.nargs
+        || rec.nargs != nargs) {
+        return object();
+    }
+
+    function_call call(rec, nargs > 0 ? args[0] : nullptr);
+    for (size_t i = 0; i < nargs; ++i) {
+        const argument_record *arg_rec = i < rec.args.size() ? &rec.args[i] : nullptr;
+        handle arg(args[i]);
+        if (arg_rec && !arg_rec->none && arg.is_none()) {
+            return object();
+        }
+        call.args.push_back(arg);
+        call.args_convert.push_back(convert && (arg_rec ? arg_rec->convert : true));
+    }
+
+    handle result = cpp_function::call_impl(call);
+    if (result.ptr() == PYBIND11_TRY_NEXT_OVERLOAD) {
+        if (call.args_failed) {
+            return object();
+        }
+        result = cpp_function::no_matching_overload(
+            overloads != nullptr ? overloads : &rec, args, nargs, nullptr);
+        if (!result) {
+            throw error_already_set();
+        }
+        return reinterpret_steal<object>(result);
+    }
+    if (!result) {
+        cpp_function::raise_return_value_error(rec);
+        throw error_already_set();
+    }
+    return reinterpret_steal<object>(result);
+}
+
+/// Calls the pybind11 function `rec` from C++ like `call_overload`, if it has a single overload.
+/// Returns a null object if the call cannot be made this way, including if the arguments fail to
+/// load or cast: the function was then not invoked, and the caller should call the function
+/// object. Once the function was invoked, its errors propagate instead (see `call_overload`).
+inline object
+call_function_record(const function_record &rec, PyObject *const *args, size_t nargs) {
+    if (rec.next != nullptr) {
+        return object();
+    }
+    return call_overload(rec, args, nargs);
+}
+
+/// Calls the function `func` for each item of `items` and returns the list of the results. Each
+/// item is a tuple of the positional arguments, or else the single argument. For a pybind11
+/// function, the overload is resolved for the first item, like the dispatcher does for positional
+/// arguments, and then called directly for the following items for as long as their arguments
+/// load. Any other call goes through the function object. Each call is made at most once: an
+/// error raised by the function is passed on, rather than trying another overload.
+inline list call_batched(handle func, const iterable &items) {
+    const function_record *overloads = get_function_record(func);
+    const function_record *chosen = nullptr;
+    std::vector<PyObject *> args;
+    list results;
+    for (handle item : items) {
+        tuple item_args = isinstance<tuple>(item) ? reinterpret_borrow<tuple>(item)
+                                                  : make_tuple(item);
+        args.clear();
+        for (handle arg : item_args) {
+            args.push_back(arg.ptr());
+        }
+
+        object result;
+        if (chosen != nullptr) {
+            result = call_overload(*chosen, args.data(), args.size(), true, overloads);
+        }
+        if (!result && overloads != nullptr) {
+            // Like the dispatcher, try all overloads without implicit conversions first
+            for (int pass = overloads->next != nullptr ? 0 : 1; pass < 2 && !result; ++pass) {
+                for (chosen = overloads; chosen != nullptr; chosen = chosen->next) {
+                    result = call_overload(
+                        *chosen, args.data(), args.size(), pass == 1, overloads);
+                    if (result) {
+                        break;
                     }
                 }
             }
-
-            append_note_if_missing_header_is_suspected(msg);
-            // Attach additional error info to the exception if supported
-            if (PyErr_Occurred()) {
-                // #HelpAppreciated: unit test coverage for this branch.
-                raise_from(PyExc_TypeError, msg.c_str());
-                return nullptr;
-            }
-            PyErr_SetString(PyExc_TypeError, msg.c_str());
-            return nullptr;
         }
         if (!result) {
-            std::string msg = "Unable to convert function return value to a "
-                              "Python type! The signature was\n\t";
-            msg += it->signature;
-            append_note_if_missing_header_is_suspected(msg);
-            // Attach additional error info to the exception if supported
-            if (PyErr_Occurred()) {
-                raise_from(PyExc_TypeError, msg.c_str());
-                return nullptr;
-            }
-            PyErr_SetString(PyExc_TypeError, msg.c_str());
-            return nullptr;
+            result = func(*item_args);
         }
-        if (overloads->is_constructor && !self_value_and_holder.holder_constructed()) {
-            auto *pi = reinterpret_cast<instance *>(parent.ptr());
-            self_value_and_holder.type->init_instance(pi, nullptr);
+        results.append(std::move(result));
+    }
+    return results;
+}
+
+PYBIND11_NAMESPACE_END(detail)
+
+#if defined(PYBIND11_DISPATCH_STATS)
+/// Switches the collection of dispatch statistics for the functions bound by this extension
+/// module on or off. Requires compiling with ``PYBIND11_DISPATCH_STATS`` defined.
+inline void enable_dispatch_stats(bool enable = true) {
+    detail::get_dispatch_stats_state().enabled = enable;
+}
+
+/// Discards the dispatch statistics collected so far.
+inline void reset_dispatch_stats() { detail::get_dispatch_stats_state().functions.clear(); }
+
+/// Returns the dispatch statistics collected for the functions bound by this extension module,
+/// as a dict mapping the qualified signature of each overload to a dict with its ``calls``,
+/// ``overload_misses`` and ``conversion_passes`` counts and its cumulative ``load_time`` and
+/// ``call_time`` in seconds.
+inline dict dispatch_stats() {
+    using seconds = std::chrono::duration<double>;
+    dict result;
+    for (const auto &entry : detail::get_dispatch_stats_state().functions) {
+        const detail::function_record &func = *entry.first;
+        const detail::function_stats &stats = entry.second;
+        std::string key;
+        if (func.scope && hasattr(func.scope, "__name__")) {
+            key = func.scope.attr("__name__").cast<std::string>() + ".";
         }
-        return result.ptr();
+        key += func.name;
+        key += detail::get_function_signature(func);
+        dict value;
+        value["calls"] = stats.calls;
+        value["overload_misses"] = stats.overload_misses;
+        value["conversion_passes"] = stats.conversion_passes;
+        value["load_time"] = std::chrono::duration_cast<seconds>(stats.load_time).count();
+        value["call_time"] = std::chrono::duration_cast<seconds>(stats.call_time).count();
+        result[str(key)] = std::move(value);
+    }
+    return result;
+}
+#endif
+
+/// Returns the memory used by pybind11 for its bookkeeping, as a dict that maps each data
+/// structure to a dict with its number of entries (``size``), and the number of ``buckets`` of
+/// a hash table or the ``bytes`` taken by the contents. The function records, the strings pooled
+/// for them and the docstrings are those of the calling extension module; everything else is
+/// shared by the extension modules that use the same internals.
+inline dict memory_stats() {
+    struct table_usage {
+        size_t size;
+        size_t buckets;
+    };
+    table_usage instances{0, 0};
+    table_usage types_py{0, 0};
+    table_usage types_cpp{0, 0};
+    table_usage override_cache{0, 0};
+#if PYBIND11_INTERNALS_VERSION <= 5
+    table_usage patients{0, 0};
+#endif
+    size_t static_strings = 0;
+    size_t static_string_bytes = 0;
+    // Collected first, since the internals must not be locked while creating Python objects
+    detail::with_internals([&](detail::internals &internals) {
+        types_py = {internals.registered_types_py.size(),
+                    internals.registered_types_py.bucket_count()};
+        types_cpp = {internals.registered_types_cpp.size(),
+                     internals.registered_types_cpp.bucket_count()};
+#if PYBIND11_INTERNALS_VERSION > 5
+        const auto &cache = internals.override_cache;
+#else
+        const auto &cache = internals.inactive_override_cache;
+        patients = {internals.patients.size(), internals.patients.bucket_count()};
+#endif
+        override_cache = {cache.size(), cache.bucket_count()};
+        for (const auto &str : internals.static_strings) {
+            ++static_strings;
+            static_string_bytes += str.size() + 1;
+        }
+#if !defined(Py_GIL_DISABLED)
+        instances = {internals.registered_instances.size(),
+                     internals.registered_instances.bucket_count()};
+#endif
+    });
+#if defined(Py_GIL_DISABLED)
+    auto &internals = detail::get_internals();
+    for (size_t i = 0; i <= internals.instance_shards_mask; ++i) {
+        auto &shard = internals.instance_shards[i];
+        std::unique_lock<detail::pymutex> lock(shard.mutex);
+        instances.size += shard.registered_instances.size();
+        instances.buckets += shard.registered_instances.bucket_count();
+    }
+#endif
+    const auto functions = detail::function_record_storage::get().get_usage();
+
+    auto entry = [](size_t size, const char *key, size_t value) {
+        dict d;
+        d["size"] = size;
+        d[key] = value;
+        return d;
+    };
+    dict result;
+    result["registered_instances"] = entry(instances.size, "buckets", instances.buckets);
+    result["registered_types_py"] = entry(types_py.size, "buckets", types_py.buckets);
+    result["registered_types_cpp"] = entry(types_cpp.size, "buckets", types_cpp.buckets);
+#if PYBIND11_INTERNALS_VERSION <= 5
+    // From internals version 6 on, the patients are stored in the instances themselves
+    result["patients"] = entry(patients.size, "buckets", patients.buckets);
+#endif
+    result["override_cache"] = entry(override_cache.size, "buckets", override_cache.buckets);
+    result["static_strings"] = entry(static_strings, "bytes", static_string_bytes);
+    result["function_records"] = entry(functions.records, "bytes", functions.record_bytes);
+    result["function_strings"] = entry(functions.strings, "bytes", functions.string_bytes);
+    dict docstrings;
+    docstrings["bytes"] = functions.docstring_bytes;
+    result["docstrings"] = std::move(docstrings);
+    return result;
+}
+
+/// Passed to `PYBIND11_MODULE` (or `module_::create_extension_module()`) to declare that the
+/// module can run without the GIL in free-threaded builds of Python. Without it, importing the
+/// module enables the GIL again there.
+class mod_gil_not_used {
+public:
+    explicit mod_gil_not_used(bool flag = true) : flag_(flag) {}
+    bool flag() const { return flag_; }
+
+private:
+    bool flag_;
+};
+
+/// Passed to `PYBIND11_MODULE` to declare which subinterpreters can import the module, from
+/// Python 3.12 on (see `Py_mod_multiple_interpreters`). Without it, the module can be imported
+/// into all of those sharing the GIL of the main interpreter. Subinterpreters with a GIL of their
+/// own run in parallel with other interpreters, so `per_interpreter_gil()` requires the module to
+/// keep no Python objects in static storage, and to guard any other global state.
+class multiple_interpreters {
+public:
+    enum class level { not_supported, shared_gil, per_interpreter_gil };
+
+    static multiple_interpreters not_supported() {
+        return multiple_interpreters(level::not_supported);
     }
+    static multiple_interpreters shared_gil() { return multiple_interpreters(level::shared_gil); }
+    static multiple_interpreters per_interpreter_gil() {
+        return multiple_interpreters(level::per_interpreter_gil);
+    }
+
+    level value() const { return level_; }
+
+private:
+    explicit multiple_interpreters(level value) : level_(value) {}
+
+    level level_;
+};
+
+PYBIND11_NAMESPACE_BEGIN(detail)
+/// The options given to `PYBIND11_MODULE`
+struct module_options {
+    mod_gil_not_used gil_not_used{false};
+    multiple_interpreters interpreters = multiple_interpreters::shared_gil();
+
+    void apply(const mod_gil_not_used &option) { gil_not_used = option; }
+    void apply(const multiple_interpreters &option) { interpreters = option; }
 };
 
+/// The function bound by `module_::def_async()`, defined in pybind11/async.h
+template <typename Func, typename Signature = function_signature_t<Func>>
+class async_function;
+PYBIND11_NAMESPACE_END(detail)
+
 /// Wrapper for Python extension modules
 class module_ : public object {
 public:
@@ -1179,6 +2438,40 @@ public:
         return *this;
     }
 
+    /** \rst
+        Like ``def()``, but calling the function returns an ``asyncio.Future`` of the event loop
+        running in the calling thread. The C++ function runs on a thread pool with the GIL
+        released (or on the executor given with ``py::async_executor``), with copies of its
+        arguments, and the future gets its result or exception when it returns. Requires
+        ``#include <pybind11/async.h>``.
+    \endrst */
+    template <typename Func, typename... Extra>
+    module_ &def_async(const char *name_, Func &&f, const Extra &...extra) {
+        return def(name_,
+                   detail::async_function<typename std::decay<Func>::type>(std::forward<Func>(f),
+                                                                            extra...),
+                   extra...);
+    }
+
+    /** \rst
+        Defines a function that calls ``f`` for each item of an iterable, and returns the list of
+        the results. Each item is a tuple of the positional arguments of ``f``, or else its single
+        argument. The arguments of each call are loaded directly, without going through the
+        dispatcher of a Python call. ``extra`` applies to ``f``: for example, with
+        ``py::call_guard<py::gil_scoped_release>()``, the GIL is released around each call.
+    \endrst */
+    template <typename Func, typename... Extra>
+    module_ &def_batched(const char *name_, Func &&f, const Extra &...extra) {
+        object func = cpp_function(std::forward<Func>(f), name(name_), scope(*this), extra...);
+        cpp_function batched(
+            [func](const iterable &items) { return detail::call_batched(func, items); },
+            name(name_),
+            scope(*this),
+            arg("items"));
+        add_object(name_, batched, true /* overwrite */);
+        return *this;
+    }
+
     /** \rst
         Create and return a new Python submodule with the given name and docstring.
         This also works recursively, i.e.
@@ -1207,6 +2500,43 @@ public:
         return result;
     }
 
+    /** \rst
+        Defines the attribute ``name`` when it is first looked up, rather than now, by calling
+        ``init`` with this module. ``init`` should define ``name``, and may define other bindings
+        as well. The C++ types given as template arguments are the classes that ``init`` binds:
+        casting one of them to or from Python also calls ``init``, if it did not run yet. Before
+        Python 3.7, where modules have no ``__getattr__``, ``init`` is called right away.
+
+        .. code-block:: cpp
+
+            m.def_lazy<Pet>("Pet", [](py::module_ &m) {
+                py::class_<Pet>(m, "Pet").def(py::init<const std::string &>());
+            });
+    \endrst */
+    template <typename... Types, typename Func>
+    module_ &def_lazy(const char *name_, Func &&init) {
+        add_lazy_binding(name_,
+                         std::function<void(module_ &)>(std::forward<Func>(init)),
+                         {std::type_index(typeid(Types))...});
+        return *this;
+    }
+
+    /** \rst
+        Like ``def_lazy()``, for a submodule: it is created with ``def_submodule()`` when it is
+        first looked up, and ``init`` is called with the submodule.
+    \endrst */
+    template <typename... Types, typename Func>
+    module_ &def_lazy_submodule(const char *name_, Func &&init, const char *doc = nullptr) {
+        std::string sub_name = name_;
+        std::string sub_doc = doc != nullptr ? doc : "";
+        bool has_doc = doc != nullptr;
+        std::function<void(module_ &)> sub_init(std::forward<Func>(init));
+        return def_lazy<Types...>(name_, [sub_name, sub_doc, has_doc, sub_init](module_ &m) {
+            auto sub = m.def_submodule(sub_name.c_str(), has_doc ? sub_doc.c_str() : nullptr);
+            sub_init(sub);
+        });
+    }
+
     /// Import and return a module or throws `error_already_set`.
     static module_ import(const char *name) {
         PyObject *obj = PyImport_ImportModule(name);
@@ -1244,12 +2574,19 @@ public:
 
     using module_def = PyModuleDef; // TODO: Can this be removed (it was needed only for Python 2)?
 
+    /// The slots of a `PYBIND11_MODULE` with multi-phase initialization, ending with a zero slot
+    using module_slots = std::array<PyModuleDef_Slot, 4>;
+
     /** \rst
         Create a new top-level module that can be used as the main module of a C extension.
 
         ``def`` should point to a statically allocated module_def.
     \endrst */
-    static module_ create_extension_module(const char *name, const char *doc, module_def *def) {
+    static module_ create_extension_module(const char *name,
+                                           const char *doc,
+                                           module_def *def,
+                                           mod_gil_not_used gil_not_used
+                                           = mod_gil_not_used(false)) {
         // module_def is PyModuleDef
         // Placement new (not an allocation).
         def = new (def)
@@ -1269,13 +2606,321 @@ public:
             }
             pybind11_fail("Internal error in module_::create_extension_module()");
         }
+#if defined(Py_GIL_DISABLED)
+        if (gil_not_used.flag()) {
+            PyUnstable_Module_SetGIL(m, Py_MOD_GIL_NOT_USED);
+        }
+#else
+        (void) gil_not_used;
+#endif
         // TODO: Should be reinterpret_steal for Python 3, but Python also steals it again when
         //       returned from PyInit_...
         //       For Python 2, reinterpret_borrow was correct.
         return reinterpret_borrow<module_>(m);
     }
+
+private:
+    PYBIND11_NOINLINE void add_lazy_binding(const char *name_,
+                                            std::function<void(module_ &)> init,
+                                            std::initializer_list<std::type_index> types) {
+#if PY_VERSION_HEX < 0x03070000
+        (void) name_;
+        (void) types;
+        init(*this);
+#else
+        auto binding = std::make_shared<detail::lazy_binding>();
+        binding->scope = weakref(*this);
+        binding->name = name_;
+        binding->types = types;
+        binding->init = [init](handle scope) {
+            auto m = reinterpret_borrow<module_>(scope);
+            detail::deferred_docstrings docstrings;
+            init(m);
+            docstrings.finish();
+        };
+        bool first = detail::with_internals([&](detail::internals &internals) {
+            auto &bindings = detail::get_lazy_bindings(internals);
+            bool is_new = bindings.by_name.find(m_ptr) == bindings.by_name.end();
+            bindings.by_name[m_ptr][name_] = binding;
+            for (const auto &tp : types) {
+                bindings.by_type[tp] = binding;
+            }
+            return is_new;
+        });
+        if (first) {
+            add_lazy_hooks();
+        }
+#endif
+    }
+
+    /// Adds the module `__getattr__` and `__dir__` (PEP 562) creating and listing the lazy
+    /// bindings, and a weak reference dropping them with the module. A `__getattr__` that the
+    /// module already has is called for other names.
+    void add_lazy_hooks() {
+        PyObject *module_ptr = m_ptr;
+        auto on_release = [module_ptr](handle) {
+            object ref = detail::with_internals([&](detail::internals &internals) {
+                return detail::get_lazy_bindings(internals).erase_module(module_ptr);
+            });
+        };
+        weakref ref(*this, cpp_function(on_release));
+        detail::with_internals([&](detail::internals &internals) {
+            detail::get_lazy_bindings(internals).module_refs[module_ptr] = std::move(ref);
+        });
+        object previous = getattr(*this, "__getattr__", none());
+        auto getattr_hook = [module_ptr, previous](const pybind11::str &attr_name) -> object {
+            auto key = attr_name.cast<std::string>();
+            auto binding = detail::with_internals(
+                [&](detail::internals &internals) -> std::shared_ptr<detail::lazy_binding> {
+                    auto &names = detail::get_lazy_bindings(internals).by_name[module_ptr];
+                    auto it = names.find(key);
+                    return it != names.end() ? it->second : nullptr;
+                });
+            if (!binding) {
+                if (!previous.is_none()) {
+                    return previous(attr_name);
+                }
+                throw attribute_error("module '" + std::string(PyModule_GetName(module_ptr))
+                                      + "' has no attribute '" + key + "'");
+            }
+            detail::materialize_lazy_binding(binding, module_ptr);
+            return getattr(handle(module_ptr), attr_name);
+        };
+        auto dir_hook = [module_ptr]() {
+            list result(reinterpret_borrow<dict>(PyModule_GetDict(module_ptr)).attr("keys")());
+            auto pending = detail::with_internals([&](detail::internals &internals) {
+                std::vector<std::string> names;
+                auto &bindings = detail::get_lazy_bindings(internals);
+                for (const auto &entry : bindings.by_name[module_ptr]) {
+                    names.push_back(entry.first);
+                }
+                return names;
+            });
+            for (const auto &pending_name : pending) {
+                result.append(pybind11::str(pending_name));
+            }
+            return result;
+        };
+        attr("__getattr__") = cpp_function(std::move(getattr_hook), name("__getattr__"));
+        attr("__dir__") = cpp_function(std::move(dir_hook), name("__dir__"));
+    }
 };
 
+PYBIND11_NAMESPACE_BEGIN(detail)
+
+/// Creates the module of a `PYBIND11_MODULE` with single-phase initialization, which is imported
+/// into subinterpreters by copying its contents
+template <typename... Options>
+module_ create_single_phase_module(const char *name,
+                                   module_::module_def *def,
+                                   const Options &...options) {
+    module_options opts;
+    PYBIND11_EXPAND_SIDE_EFFECTS(opts.apply(options));
+    return module_::create_extension_module(name, nullptr, def, opts.gil_not_used);
+}
+
+/// Prints the entries of `profile` with the most self time to stderr
+inline void report_import_profile(const module_ &m,
+                                  const import_profile &profile,
+                                  import_profile::duration total) {
+    using entry = std::pair<const std::string, import_profile::entry>;
+    const auto ms = [](import_profile::duration ns) { return static_cast<double>(ns) / 1e6; };
+    std::vector<const entry *> sorted;
+    sorted.reserve(profile.entries.size());
+    size_t count = 0;
+    for (const auto &e : profile.entries) {
+        sorted.push_back(&e);
+        count += e.second.count;
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const entry *a, const entry *b) {
+        return a->second.self != b->second.self ? a->second.self > b->second.self
+                                                : a->first < b->first;
+    });
+
+    const size_t shown = (std::min)(sorted.size(), size_t{25});
+    auto name = m.attr("__name__").cast<std::string>();
+    PySys_WriteStderr("pybind11: import profile of %.200s (%.3f ms, %lu registrations)\n",
+                      name.c_str(),
+                      ms(total),
+                      static_cast<unsigned long>(count));
+    PySys_WriteStderr("%10s %10s %7s  %s\n", "self [ms]", "total [ms]", "count", "registration");
+    for (size_t i = 0; i < shown; ++i) {
+        const auto &e = sorted[i]->second;
+        PySys_WriteStderr("%10.3f %10.3f %7lu  %.800s\n",
+                          ms(e.self),
+                          ms(e.total),
+                          static_cast<unsigned long>(e.count),
+                          sorted[i]->first.c_str());
+    }
+    if (shown < sorted.size()) {
+        import_profile::duration rest = 0;
+        size_t rest_count = 0;
+        for (size_t i = shown; i < sorted.size(); ++i) {
+            rest += sorted[i]->second.self;
+            rest_count += sorted[i]->second.count;
+        }
+        PySys_WriteStderr("%10.3f %10s %7lu  (the remaining registrations)\n",
+                          ms(rest),
+                          "",
+                          static_cast<unsigned long>(rest_count));
+    }
+}
+
+/// Runs the body of a `PYBIND11_MODULE`, and then generates the docstrings of its functions.
+/// If the ``PYBIND11_PROFILE_IMPORT`` environment variable is set, the time of each registration
+/// is measured and reported at the end.
+inline void initialize_module(module_ &m, void (*init)(module_ &)) {
+#if defined(PYBIND11_DISPATCH_STATS)
+    // Lets `pybind11.detail.dispatch_stats()` and friends find the statistics of this module
+    m.def(
+        "__pybind11_dispatch_stats__",
+        [](const object &enable, bool reset) {
+            if (!enable.is_none()) {
+                enable_dispatch_stats(enable.cast<bool>());
+            }
+            if (reset) {
+                reset_dispatch_stats();
+            }
+            return dispatch_stats();
+        },
+        arg("enable") = none(),
+        arg("reset") = false);
+#endif
+    if (!import_profiling_enabled()) {
+        deferred_docstrings docstrings;
+        init(m);
+        docstrings.finish();
+        return;
+    }
+
+    // Restores the profile of an enclosing module initialization (on import from its body)
+    struct profile_guard {
+        import_profile *outer = current_import_profile();
+        ~profile_guard() { current_import_profile() = outer; }
+    };
+    import_profile profile;
+    profile.perf_counter_ns = module_::import("time").attr("perf_counter_ns");
+    {
+        profile_guard guard;
+        current_import_profile() = &profile;
+        const auto start = profile.now();
+        {
+            deferred_docstrings docstrings;
+            init(m);
+            import_profile_scope profile_scope("docstrings", "(all)");
+            docstrings.finish();
+        }
+        report_import_profile(m, profile, profile.now() - start);
+    }
+}
+
+#if defined(PYBIND11_HAS_SUBINTERPRETER_SUPPORT)
+/// Sets up `def` and `slots` for multi-phase initialization of a `PYBIND11_MODULE`, which calls
+/// `exec` on a new module object in every interpreter importing it, and returns the result of
+/// its `PyInit_<name>()` function
+template <typename... Options>
+PyObject *initialize_multiphase_module_def(const char *name,
+                                           module_::module_def *def,
+                                           module_::module_slots &slots,
+                                           int (*exec)(PyObject *),
+                                           const Options &...options) {
+    module_options opts;
+    PYBIND11_EXPAND_SIDE_EFFECTS(opts.apply(options));
+    void *interpreters = Py_MOD_MULTIPLE_INTERPRETERS_SUPPORTED;
+    switch (opts.interpreters.value()) {
+        case multiple_interpreters::level::not_supported:
+            interpreters = Py_MOD_MULTIPLE_INTERPRETERS_NOT_SUPPORTED;
+            break;
+        case multiple_interpreters::level::shared_gil:
+            break;
+        case multiple_interpreters::level::per_interpreter_gil:
+            interpreters = Py_MOD_PER_INTERPRETER_GIL_SUPPORTED;
+            break;
+    }
+    size_t i = 0;
+    slots[i++] = {Py_mod_exec, reinterpret_cast<void *>(exec)};
+    slots[i++] = {Py_mod_multiple_interpreters, interpreters};
+#    if PY_VERSION_HEX >= 0x030D0000
+    slots[i++] = {Py_mod_gil, opts.gil_not_used.flag() ? Py_MOD_GIL_NOT_USED : Py_MOD_GIL_USED};
+#    endif
+    slots[i] = {0, nullptr};
+    // Placement new (not an allocation).
+    def = new (def) PyModuleDef{/* m_base */ PyModuleDef_HEAD_INIT,
+                                /* m_name */ name,
+                                /* m_doc */ nullptr,
+                                /* m_size */ 0,
+                                /* m_methods */ nullptr,
+                                /* m_slots */ slots.data(),
+                                /* m_traverse */ nullptr,
+                                /* m_clear */ nullptr,
+                                /* m_free */ nullptr};
+    return PyModuleDef_Init(def);
+}
+#endif
+
+/// The `Py_mod_exec` function of a `PYBIND11_MODULE` with multi-phase initialization: calls
+/// `init` on the module object unless a module of the same name was initialized in the
+/// interpreter before (e.g. if it was removed from `sys.modules`), in which case its contents are
+/// copied instead, as with single-phase initialization. Types cannot be registered twice in one
+/// interpreter.
+inline int exec_module(PyObject *pm, void (*init)(module_ &)) {
+    try {
+        initialize_subinterpreter_internals();
+        auto m = reinterpret_borrow<module_>(pm);
+        dict state_dict = get_python_state_dict();
+        const char *key = "__pybind11_initialized_modules__";
+        if (!state_dict.contains(key)) {
+            state_dict[key] = dict();
+            // The modules are released when the interpreter is finalized, before its other
+            // modules are cleared
+            module_::import("atexit").attr("register")(state_dict.attr("pop"), key, none());
+        }
+        dict initialized = state_dict[key];
+        object name = m.attr("__name__");
+        if (initialized.contains(name)) {
+            m.attr("__dict__").attr("update")(initialized[name].attr("__dict__"));
+            return 0;
+        }
+        initialize_module(m, init);
+        initialized[name] = m;
+        return 0;
+    } catch (error_already_set &e) {
+        raise_from(e, PyExc_ImportError, "initialization failed");
+    } catch (const std::exception &e) {
+        PyErr_SetString(PyExc_ImportError, e.what());
+    }
+    return -1;
+}
+
+/// Implements the `PyInit_<name>()` function of a `PYBIND11_MODULE`. Modules declaring which
+/// subinterpreters can import them (`py::multiple_interpreters`) use multi-phase initialization
+/// from Python 3.12 on, so that each of those interpreters calls `exec` on a module object of its
+/// own. Other modules are created and initialized with `init` right away.
+template <typename... Options>
+PyObject *initialize_module_def(const char *name,
+                                module_::module_def *def,
+                                module_::module_slots &slots,
+                                void (*init)(module_ &),
+                                int (*exec)(PyObject *),
+                                const Options &...options) {
+#if defined(PYBIND11_HAS_SUBINTERPRETER_SUPPORT)
+    if (any_of<std::is_same<Options, multiple_interpreters>...>::value) {
+        return initialize_multiphase_module_def(name, def, slots, exec, options...);
+    }
+#else
+    (void) slots;
+    (void) exec;
+#endif
+    try {
+        auto m = create_single_phase_module(name, def, options...);
+        initialize_module(m, init);
+        return m.ptr();
+    }
+    PYBIND11_CATCH_INIT_EXCEPTIONS
+}
+
+PYBIND11_NAMESPACE_END(detail)
+
 // When inside a namespace (or anywhere as long as it's not the first item on a line),
 // C++20 allows "module" to be used. This is provided for backward compatibility, and for
 // simplicity, if someone wants to use py::module for example, that is perfectly safe.
@@ -1303,6 +2948,7 @@ public:
     PYBIND11_OBJECT_DEFAULT(generic_type, object, PyType_Check)
 protected:
     void initialize(const type_record &rec) {
+        import_profile_scope profile_scope("class_", rec.name, rec.scope);
         if (rec.scope && hasattr(rec.scope, "__dict__")
             && rec.scope.attr("__dict__").contains(rec.name)) {
             pybind11_fail("generic_type: cannot initialize type \"" + std::string(rec.name)
@@ -1315,6 +2961,15 @@ protected:
                           + "\" is already registered!");
         }
 
+        if (rec.no_gc && rec.dynamic_attr) {
+            pybind11_fail("generic_type: type \"" + std::string(rec.name)
+                          + "\" has a __dict__ (py::dynamic_attr()) and can not use py::no_gc()");
+        }
+        if (rec.no_gc && !rec.slot_names.empty()) {
+            pybind11_fail("generic_type: type \"" + std::string(rec.name)
+                          + "\" has attribute slots (py::slots()) and can not use py::no_gc()");
+        }
+
         m_ptr = make_new_python_type(rec);
 
         /* Register supplemental type information in C++ dict */
@@ -1331,16 +2986,23 @@ protected:
         tinfo->simple_ancestors = true;
         tinfo->default_holder = rec.default_holder;
         tinfo->module_local = rec.module_local;
-
-        auto &internals = get_internals();
-        auto tindex = std::type_index(*rec.type);
-        tinfo->direct_conversions = &internals.direct_conversions[tindex];
-        if (rec.module_local) {
-            get_local_internals().registered_types_cpp[tindex] = tinfo;
-        } else {
-            internals.registered_types_cpp[tindex] = tinfo;
-        }
-        internals.registered_types_py[(PyTypeObject *) m_ptr] = {tinfo};
+#if PYBIND11_INTERNALS_VERSION > 5
+        tinfo->no_instance_registry = rec.no_instance_registry;
+        tinfo->inline_storage = rec.inline_storage;
+#endif
+        with_internals([&](internals &internals) {
+            auto tindex = std::type_index(*rec.type);
+            tinfo->direct_conversions = &internals.direct_conversions[tindex];
+            if (rec.module_local) {
+                get_local_internals().registered_types_cpp[tindex] = tinfo;
+            } else {
+                internals.registered_types_cpp[tindex] = tinfo;
+            }
+            internals.registered_types_py[(PyTypeObject *) m_ptr] = {tinfo};
+#if defined(PYBIND11_HAS_TYPE_INFO_CACHE)
+            invalidate_type_info_caches(internals);
+#endif
+        });
 
         if (rec.bases.size() > 1 || rec.multiple_inheritance) {
             mark_parents_nonsimple(tinfo->type);
@@ -1353,6 +3015,11 @@ protected:
             // The parent can no longer be a simple type if it has MI and has a child
             parent_tinfo->simple_type = parent_tinfo->simple_type && parent_simple_ancestors;
         }
+#if PYBIND11_INTERNALS_VERSION > 5
+        if (!tinfo->simple_ancestors) {
+            collect_base_casts(tinfo, 0, tinfo->base_casts);
+        }
+#endif
 
         if (rec.module_local) {
             // Stash the local typeinfo and loader so that external modules can access it.
@@ -1428,6 +3095,30 @@ struct has_operator_delete_size<
     T,
     void_t<decltype(static_cast<void (*)(void *, size_t)>(T::operator delete))>> : std::true_type {
 };
+// Whether a `def_buffer` callback fills the `Py_buffer` itself, as `func(self, view, flags)`
+template <typename Func, typename T, typename SFINAE = void>
+struct is_buffer_filler : std::false_type {};
+template <typename Func, typename T>
+struct is_buffer_filler<Func,
+                        T,
+                        void_t<decltype(std::declval<Func &>()(
+                            std::declval<T &>(), std::declval<Py_buffer *>(), 0))>>
+    : std::true_type {};
+
+// Calls the release callback of a `def_buffer`, if there is one
+template <typename Release>
+struct buffer_release_caller {
+    template <typename T>
+    static void call(Release &release, T &self, Py_buffer *view) {
+        release(self, view);
+    }
+};
+template <>
+struct buffer_release_caller<std::nullptr_t> {
+    template <typename T>
+    static void call(std::nullptr_t, T &, Py_buffer *) {}
+};
+
 /// Call class-specific delete if it exists or global otherwise. Can also be an overload set.
 template <typename T, enable_if_t<has_operator_delete<T>::value, int> = 0>
 void call_operator_delete(T *p, size_t, size_t) {
@@ -1460,13 +3151,153 @@ inline void call_operator_delete(void *p, size_t s, size_t a) {
 #endif
 }
 
+template <typename Base, typename Derived, typename SFINAE = void>
+struct is_non_virtual_base_of : std::false_type {};
+template <typename Base, typename Derived>
+struct is_non_virtual_base_of<Base,
+                              Derived,
+                              void_t<decltype(static_cast<Derived *>(std::declval<Base *>()))>>
+    : std::true_type {};
+
+/// Returns the offset of the member `pm` in values of `T`, which derives from `C` (not virtually)
+template <typename T, typename C, typename D>
+ssize_t member_offset(D C::*pm) {
+    alignas(T) unsigned char storage[sizeof(T)];
+    auto *value = reinterpret_cast<T *>(storage);
+    return reinterpret_cast<const unsigned char *>(&(static_cast<C *>(value)->*pm)) - storage;
+}
+
 inline void add_class_method(object &cls, const char *name_, const cpp_function &cf) {
     cls.attr(cf.name()) = cf;
     if (std::strcmp(name_, "__eq__") == 0 && !cls.attr("__dict__").contains("__hash__")) {
         cls.attr("__hash__") = none();
     }
+#if defined(PYBIND11_HAS_VECTORCALL)
+    if (name_[0] == '_' && name_[1] == '_') {
+        install_special_method_slots((PyTypeObject *) cls.ptr(), name_);
+    }
+#endif
 }
 
+PYBIND11_NAMESPACE_BEGIN(initimpl)
+
+template <typename Class, typename... Args>
+struct fast_constructor {
+    /// Makes calls of the class with exactly `sizeof...(Args)` positional arguments construct
+    /// instances directly, if `py::init<Args...>()` is the only `__init__` of the class (which
+    /// must be final, so that the call never creates an instance of a Python subclass)
+    static void install(Class &cl) {
+#if defined(PYBIND11_HAS_VECTORCALL)
+        auto *type = (PyTypeObject *) cl.ptr();
+        if ((type->tp_flags & Py_TPFLAGS_BASETYPE) != 0) {
+            pybind11_fail("py::fast_init() requires a final class (py::is_final())");
+        }
+        auto *rec = Class::get_function_record(getattr(cl, "__init__"));
+        if (rec == nullptr || rec->next != nullptr) {
+            return;
+        }
+        // Arguments marked with `.noconvert()` or `.none(false)` need the dispatcher
+        for (size_t i = 1; i < rec->args.size(); ++i) {
+            if (!rec->args[i].convert || !rec->args[i].none) {
+                return;
+            }
+        }
+        type->tp_vectorcall = &vectorcall;
+#else
+        (void) cl;
+#endif
+    }
+
+#if defined(PYBIND11_HAS_VECTORCALL)
+private:
+    static PyObject *
+    vectorcall(PyObject *type, PyObject *const *args, size_t nargsf, PyObject *kwnames) {
+        const auto nargs = static_cast<size_t>(PyVectorcall_NARGS(nargsf));
+        if (nargs != sizeof...(Args) || (kwnames != nullptr && PyTuple_GET_SIZE(kwnames) != 0)) {
+            return call_metaclass(type, args, nargs, kwnames);
+        }
+        PyObject *self = nullptr;
+        try {
+            loader_life_support life_support;
+            std::tuple<make_caster<Args>...> casters;
+            if (!load(casters, args, make_index_sequence<sizeof...(Args)>{})) {
+                // Let the dispatcher report the error (or find an implicit conversion)
+                return call_metaclass(type, args, nargs, kwnames);
+            }
+            self = make_new_instance((PyTypeObject *) type);
+            auto *inst = reinterpret_cast<instance *>(self);
+            // The class is final, so its own type is the only one in the instance
+            auto v_h = *values_and_holders(inst).begin();
+            construct(v_h, casters, make_index_sequence<sizeof...(Args)>{});
+            v_h.type->init_instance(inst, nullptr);
+            return self;
+        } catch (...) {
+            Py_XDECREF(self);
+            return cpp_function::handle_active_exception();
+        }
+    }
+
+    template <size_t... Is>
+    static bool
+    load(std::tuple<make_caster<Args>...> &casters, PyObject *const *args, index_sequence<Is...>) {
+        for (bool r : {true, std::get<Is>(casters).load(args[Is], true)...}) {
+            if (!r) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <size_t... Is>
+    static void construct(value_and_holder &v_h,
+                          std::tuple<make_caster<Args>...> &casters,
+                          index_sequence<Is...>) {
+        (void) casters;
+        if (void *storage = inline_value_ptr(v_h.inst, v_h.type)) {
+            v_h.value_ptr() = construct_or_initialize_at<Cpp<Class>>(
+                storage, cast_op<Args>(std::move(std::get<Is>(casters)))...);
+        } else {
+            v_h.value_ptr() = construct_or_initialize<Cpp<Class>>(
+                cast_op<Args>(std::move(std::get<Is>(casters)))...);
+        }
+    }
+
+    /// The usual call of the class, through the metaclass, `__new__` and the `__init__` dispatcher
+    static PyObject *
+    call_metaclass(PyObject *type, PyObject *const *args, size_t nargs, PyObject *kwnames) {
+        const auto nkwargs
+            = kwnames == nullptr ? 0 : static_cast<size_t>(PyTuple_GET_SIZE(kwnames));
+        auto args_tuple = reinterpret_steal<object>(PyTuple_New(static_cast<ssize_t>(nargs)));
+        if (!args_tuple) {
+            return nullptr;
+        }
+        for (size_t i = 0; i < nargs; ++i) {
+            PyTuple_SET_ITEM(
+                args_tuple.ptr(), static_cast<ssize_t>(i), handle(args[i]).inc_ref().ptr());
+        }
+        object kwargs;
+        if (nkwargs != 0) {
+            kwargs = reinterpret_steal<object>(PyDict_New());
+            if (!kwargs) {
+                return nullptr;
+            }
+            for (size_t i = 0; i < nkwargs; ++i) {
+                if (PyDict_SetItem(kwargs.ptr(),
+                                   PyTuple_GET_ITEM(kwnames, static_cast<ssize_t>(i)),
+                                   args[nargs + i])
+                    != 0) {
+                    return nullptr;
+                }
+            }
+        }
+        // Not `PyObject_Call()`, which would come back here
+        return Py_TYPE(type)->tp_call(type, args_tuple.ptr(), kwargs.ptr());
+    }
+#endif
+};
+
+PYBIND11_NAMESPACE_END(initimpl)
+
 PYBIND11_NAMESPACE_END(detail)
 
 /// Given a pointer to a member function, cast it to its `Derived` version.
@@ -1550,13 +3381,26 @@ public:
         /* Process optional arguments, if any */
         process_attributes<Extra...>::init(extra..., &record);
 
+#if PYBIND11_INTERNALS_VERSION > 5
+        // Values stored inside the instance must not be deleted by the holder (see `dealloc`)
+        record.inline_storage = record.inline_storage && !has_alias
+                                && std::is_same<holder_type, std::unique_ptr<type>>::value
+                                && alignof(type) <= inline_storage_max_align
+                                && record.bases.size() <= 1;
+#else
+        // Needs `type_info::inline_storage`
+        record.inline_storage = false;
+#endif
+
         generic_type::initialize(record);
 
         if (has_alias) {
-            auto &instances = record.module_local ? get_local_internals().registered_types_cpp
-                                                  : get_internals().registered_types_cpp;
-            instances[std::type_index(typeid(type_alias))]
-                = instances[std::type_index(typeid(type))];
+            with_internals([&](internals &internals) {
+                auto &instances = record.module_local ? get_local_internals().registered_types_cpp
+                                                      : internals.registered_types_cpp;
+                instances[std::type_index(typeid(type_alias))]
+                    = instances[std::type_index(typeid(type))];
+            });
         }
     }
 
@@ -1627,13 +3471,20 @@ public:
         return *this;
     }
 
+    template <typename... Args, typename... Extra>
+    class_ &def(detail::initimpl::inplace_factory<Args...> &&init, const Extra &...extra) {
+        std::move(init).execute(*this, extra...);
+        return *this;
+    }
+
     template <typename... Args, typename... Extra>
     class_ &def(detail::initimpl::pickle_factory<Args...> &&pf, const Extra &...extra) {
         std::move(pf).execute(*this, extra...);
         return *this;
     }
 
-    template <typename Func>
+    template <typename Func,
+              detail::enable_if_t<!detail::is_buffer_filler<Func, type>::value, int> = 0>
     class_ &def_buffer(Func &&func) {
         struct capture {
             Func func;
@@ -1656,6 +3507,32 @@ public:
         return *this;
     }
 
+    /**
+     * Exports buffers without creating a `buffer_info`: `func(type &self, Py_buffer *view, int
+     * flags)` sets `buf`, `itemsize`, `format`, `ndim`, `shape`, `strides` and `readonly` of
+     * `view`; it may leave out what `flags` does not request. The format, shape and strides
+     * must stay valid while `self` is alive, e.g. by pointing to static data (such as
+     * `buffer_format<T>()`) or to members of `self`.
+     */
+    template <typename Func,
+              detail::enable_if_t<detail::is_buffer_filler<Func, type>::value, int> = 0>
+    class_ &def_buffer(Func &&func) {
+        return def_buffer_filler(std::forward<Func>(func), nullptr);
+    }
+
+    /**
+     * Like `def_buffer(func)`, and calls `release(type &self, Py_buffer *view)` when a consumer
+     * releases the view, e.g. to unpin memory that `func` pinned. Also called (with the Python
+     * error preserved) if the view that `func` filled does not match what the consumer asked
+     * for.
+     */
+    template <typename Func,
+              typename Release,
+              detail::enable_if_t<detail::is_buffer_filler<Func, type>::value, int> = 0>
+    class_ &def_buffer(Func &&func, Release &&release) {
+        return def_buffer_filler(std::forward<Func>(func), std::forward<Release>(release));
+    }
+
     template <typename Return, typename Class, typename... Args>
     class_ &def_buffer(Return (Class::*func)(Args...)) {
         return def_buffer([func](type &obj) { return (obj.*func)(); });
@@ -1670,6 +3547,13 @@ public:
     class_ &def_readwrite(const char *name, D C::*pm, const Extra &...extra) {
         static_assert(std::is_same<C, type>::value || std::is_base_of<C, type>::value,
                       "def_readwrite() requires a class member (or base class member)");
+        if (def_native_member(name,
+                              pm,
+                              /*readonly=*/false,
+                              detail::any_of<std::is_same<native_member, Extra>...>{},
+                              extra...)) {
+            return *this;
+        }
         cpp_function fget([pm](const type &c) -> const D & { return c.*pm; }, is_method(*this)),
             fset([pm](type &c, const D &value) { c.*pm = value; }, is_method(*this));
         def_property(name, fget, fset, return_value_policy::reference_internal, extra...);
@@ -1680,6 +3564,13 @@ public:
     class_ &def_readonly(const char *name, const D C::*pm, const Extra &...extra) {
         static_assert(std::is_same<C, type>::value || std::is_base_of<C, type>::value,
                       "def_readonly() requires a class member (or base class member)");
+        if (def_native_member(name,
+                              pm,
+                              /*readonly=*/true,
+                              detail::any_of<std::is_same<native_member, Extra>...>{},
+                              extra...)) {
+            return *this;
+        }
         cpp_function fget([pm](const type &c) -> const D & { return c.*pm; }, is_method(*this));
         def_property_readonly(name, fget, return_value_policy::reference_internal, extra...);
         return *this;
@@ -1687,6 +3578,13 @@ public:
 
     template <typename D, typename... Extra>
     class_ &def_readwrite_static(const char *name, D *pm, const Extra &...extra) {
+        if (def_native_static(name,
+                              pm,
+                              /*readonly=*/false,
+                              detail::any_of<std::is_same<native_member, Extra>...>{},
+                              extra...)) {
+            return *this;
+        }
         cpp_function fget([pm](const object &) -> const D & { return *pm; }, scope(*this)),
             fset([pm](const object &, const D &value) { *pm = value; }, scope(*this));
         def_property_static(name, fget, fset, return_value_policy::reference, extra...);
@@ -1695,6 +3593,17 @@ public:
 
     template <typename D, typename... Extra>
     class_ &def_readonly_static(const char *name, const D *pm, const Extra &...extra) {
+        if (detail::any_of<std::is_same<static_constant, Extra>...>::value) {
+            attr(name) = pybind11::cast(*pm, return_value_policy::copy);
+            return *this;
+        }
+        if (def_native_static(name,
+                              pm,
+                              /*readonly=*/true,
+                              detail::any_of<std::is_same<native_member, Extra>...>{},
+                              extra...)) {
+            return *this;
+        }
         cpp_function fget([pm](const object &) -> const D & { return *pm; }, scope(*this));
         def_property_readonly_static(name, fget, return_value_policy::reference, extra...);
         return *this;
@@ -1805,6 +3714,44 @@ public:
     }
 
 private:
+    template <typename Func, typename Release>
+    class_ &def_buffer_filler(Func &&func, Release &&release) {
+        using release_type = detail::remove_cvref_t<Release>;
+        struct capture {
+            detail::remove_cvref_t<Func> func;
+            release_type release;
+        };
+        auto *ptr = new capture{std::forward<Func>(func), std::forward<Release>(release)};
+        auto *filler = new detail::buffer_filler{
+            [](PyObject *obj, Py_buffer *view, int flags, void *ptr) {
+                detail::make_caster<type> caster;
+                if (!caster.load(obj, false)) {
+                    return false;
+                }
+                ((capture *) ptr)->func(detail::cast_op<type &>(caster), view, flags);
+                return true;
+            },
+            nullptr,
+            ptr};
+        if (!std::is_same<release_type, std::nullptr_t>::value) {
+            filler->release = [](PyObject *obj, Py_buffer *view, void *ptr) {
+                detail::make_caster<type> caster;
+                if (caster.load(obj, false)) {
+                    detail::buffer_release_caller<release_type>::call(
+                        ((capture *) ptr)->release, detail::cast_op<type &>(caster), view);
+                }
+            };
+        }
+        install_buffer_funcs(&detail::filled_buffer_info, filler);
+        weakref(m_ptr, cpp_function([ptr, filler](handle wr) {
+                    delete filler;
+                    delete ptr;
+                    wr.dec_ref();
+                }))
+            .release();
+        return *this;
+    }
+
     /// Initialize holder object, variant 1: object derives from enable_shared_from_this
     template <typename T>
     static void init_holder(detail::instance *inst,
@@ -1828,8 +3775,14 @@ private:
     static void init_holder_from_existing(const detail::value_and_holder &v_h,
                                           const holder_type *holder_ptr,
                                           std::true_type /*is_copy_constructible*/) {
-        new (std::addressof(v_h.holder<holder_type>()))
-            holder_type(*reinterpret_cast<const holder_type *>(holder_ptr));
+        if (holder_ptr == detail::movable_holder()) {
+            // A holder returned by value (see `copyable_holder_caster::cast`)
+            new (std::addressof(v_h.holder<holder_type>()))
+                holder_type(std::move(*const_cast<holder_type *>(holder_ptr)));
+        } else {
+            new (std::addressof(v_h.holder<holder_type>()))
+                holder_type(*reinterpret_cast<const holder_type *>(holder_ptr));
+        }
     }
 
     static void init_holder_from_existing(const detail::value_and_holder &v_h,
@@ -1867,6 +3820,18 @@ private:
         init_holder(inst, v_h, (const holder_type *) holder_ptr, v_h.value_ptr<type>());
     }
 
+    /// A value stored inside the instance is only destroyed, after taking it out of the holder
+    static void destroy_inline_value(detail::value_and_holder &v_h, std::true_type) {
+        if (v_h.value_ptr() == detail::inline_value_ptr(v_h.inst, v_h.type)) {
+            if (v_h.holder_constructed()) {
+                (void) v_h.holder<holder_type>().release();
+            }
+            v_h.value_ptr<type>()->~type();
+            v_h.value_ptr() = nullptr;
+        }
+    }
+    static void destroy_inline_value(detail::value_and_holder &, std::false_type) {}
+
     /// Deallocates an instance; via holder, if constructed; otherwise via operator delete.
     static void dealloc(detail::value_and_holder &v_h) {
         // We could be deallocating because we are cleaning up after a Python exception.
@@ -1876,37 +3841,152 @@ private:
         // throw error_already_set from the C++ destructor which is forbidden and triggers
         // std::terminate().
         error_scope scope;
+        destroy_inline_value(v_h, std::is_same<holder_type, std::unique_ptr<type>>());
         if (v_h.holder_constructed()) {
             v_h.holder<holder_type>().~holder_type();
             v_h.set_holder_constructed(false);
-        } else {
+        } else if (v_h.value_ptr() != nullptr) {
             detail::call_operator_delete(
                 v_h.value_ptr<type>(), v_h.type->type_size, v_h.type->type_align);
         }
         v_h.value_ptr() = nullptr;
     }
 
-    static detail::function_record *get_function_record(handle h) {
-        h = detail::get_function(h);
-        if (!h) {
-            return nullptr;
-        }
+    template <typename, typename...>
+    friend struct detail::initimpl::fast_constructor;
 
-        handle func_self = PyCFunction_GET_SELF(h.ptr());
-        if (!func_self) {
-            throw error_already_set();
-        }
-        if (!isinstance<capsule>(func_self)) {
-            return nullptr;
-        }
-        auto cap = reinterpret_borrow<capsule>(func_self);
-        if (!detail::is_function_record_capsule(cap)) {
-            return nullptr;
-        }
-        return cap.get_pointer<detail::function_record>();
+    template <typename C, typename D, typename... Extra>
+    bool def_native_member(const char *, D C::*, bool, std::false_type, const Extra &...) {
+        return false;
+    }
+
+    template <typename C, typename D, typename... Extra>
+    bool def_native_member(
+        const char *name, D C::*pm, bool readonly, std::true_type, const Extra &...extra) {
+        using member_type = detail::remove_cv_t<D>;
+        static_assert(std::is_arithmetic<member_type>::value
+                          && !detail::is_std_char_type<member_type>::value,
+                      "py::native_member() requires a member of arithmetic type or bool");
+        static_assert(detail::is_non_virtual_base_of<C, type>::value,
+                      "py::native_member() can not be used with members of virtual base classes");
+#if defined(PYPY_VERSION)
+        (void) name;
+        (void) pm;
+        (void) readonly;
+        detail::silence_unused_warnings(extra...);
+        return false;
+#else
+        // Only for the docstring
+        detail::function_record rec;
+        detail::process_attributes<Extra...>::init(extra..., &rec);
+        const bool has_doc
+            = rec.doc != nullptr && pybind11::options::show_user_defined_docstrings();
+        attr(name) = detail::make_native_member<member_type>(
+            *this, detail::member_offset<type>(pm), name, has_doc ? rec.doc : nullptr, readonly);
+        return true;
+#endif
+    }
+
+    template <typename D, typename... Extra>
+    bool def_native_static(const char *, D *, bool, std::false_type, const Extra &...) {
+        return false;
+    }
+
+    template <typename D, typename... Extra>
+    bool def_native_static(const char *name,
+                           D *pm,
+                           bool readonly,
+                           std::true_type,
+                           const Extra &...extra) {
+        using member_type = detail::remove_cv_t<D>;
+        static_assert(std::is_arithmetic<member_type>::value
+                          && !detail::is_std_char_type<member_type>::value,
+                      "py::native_member() requires a static variable of arithmetic type or bool");
+#if defined(PYPY_VERSION)
+        (void) name;
+        (void) pm;
+        (void) readonly;
+        detail::silence_unused_warnings(extra...);
+        return false;
+#else
+        // Only for the docstring
+        detail::function_record rec;
+        detail::process_attributes<Extra...>::init(extra..., &rec);
+        const bool has_doc
+            = rec.doc != nullptr && pybind11::options::show_user_defined_docstrings();
+        attr(name) = detail::make_native_static_member<D>(
+            *this, pm, name, has_doc ? rec.doc : nullptr, readonly);
+        return true;
+#endif
     }
+
+    static detail::function_record *get_function_record(handle h) {
+        return detail::get_function_record(h);
+    }
+};
+
+PYBIND11_NAMESPACE_BEGIN(detail)
+
+/// The object that exports the buffer of `memoryview::from_owned()` and `from_shared()`. Every
+/// view of the buffer references it, so `owner` lives until the last of them is released.
+struct owned_buffer {
+    std::shared_ptr<void> owner;
+    void *ptr;
+    std::string format;
+    ssize_t itemsize;
+    ssize_t size;
+    bool readonly;
 };
 
+inline memoryview owned_memoryview(owned_buffer &&buffer) {
+    // Module-local, so that every extension module registers its own; this also happens again
+    // after the interpreter is restarted
+    if (get_type_info(typeid(owned_buffer)) == nullptr) {
+        class_<owned_buffer>(
+            handle(), "pybind11_owned_buffer", module_local(), buffer_protocol())
+            .def_buffer([](owned_buffer &self, Py_buffer *view, int /* flags */) {
+                view->buf = self.ptr;
+                view->itemsize = self.itemsize;
+                view->format = const_cast<char *>(self.format.c_str());
+                view->ndim = 1;
+                view->shape = &self.size;
+                view->strides = &self.itemsize;
+                view->readonly = self.readonly ? 1 : 0;
+            });
+    }
+    auto exporter = reinterpret_steal<object>(
+        make_caster<owned_buffer>::cast(std::move(buffer), return_value_policy::move, handle()));
+    if (!exporter) {
+        throw error_already_set();
+    }
+    PyObject *result = PyMemoryView_FromObject(exporter.ptr());
+    if (result == nullptr) {
+        throw error_already_set();
+    }
+    return reinterpret_steal<memoryview>(result);
+}
+
+PYBIND11_NAMESPACE_END(detail)
+
+template <typename T, typename Deleter>
+memoryview
+memoryview::from_owned(std::unique_ptr<T[], Deleter> data, ssize_t size, bool readonly) {
+    T *ptr = data.get();
+    // Takes over the deleter, which is called with `ptr` even if this throws
+    std::shared_ptr<void> owner(data.release(), std::move(data.get_deleter()));
+    return detail::owned_memoryview({std::move(owner),
+                                     ptr,
+                                     format_descriptor<T>::format(),
+                                     static_cast<ssize_t>(sizeof(T)),
+                                     size,
+                                     readonly});
+}
+
+inline memoryview
+memoryview::from_shared(std::shared_ptr<void> owner, void *ptr, ssize_t size, bool readonly) {
+    return detail::owned_memoryview({std::move(owner), ptr, "B", 1, size, readonly});
+}
+
 /// Binds an existing constructor taking arguments Args...
 template <typename... Args>
 detail::initimpl::constructor<Args...> init() {
@@ -1933,6 +4013,16 @@ Ret init(CFunc &&c, AFunc &&a) {
     return {std::forward<CFunc>(c), std::forward<AFunc>(a)};
 }
 
+/// Binds a factory function which constructs the instance in the uninitialized memory it is
+/// given as first argument, e.g. `py::init_inplace([](void *mem, int n) { new (mem) T(n); })`,
+/// without moving a returned value. The memory is inside the Python object for classes with
+/// `py::inline_storage`, and otherwise is allocated with `::operator new(sizeof(T))` (so `T`
+/// must not have a class-specific `operator new` or `delete`).
+template <typename Func, typename Ret = detail::initimpl::inplace_factory<Func>>
+Ret init_inplace(Func &&f) {
+    return {std::forward<Func>(f)};
+}
+
 /// Binds pickling functions `__getstate__` and `__setstate__` and ensures that the type
 /// returned by `__getstate__` is the same as the argument accepted by `__setstate__`.
 template <typename GetState, typename SetState>
@@ -1943,7 +4033,8 @@ detail::initimpl::pickle_factory<GetState, SetState> pickle(GetState &&g, SetSta
 PYBIND11_NAMESPACE_BEGIN(detail)
 
 inline str enum_name(handle arg) {
-    dict entries = arg.get_type().attr("__entries");
+    static interned_str entries_attr("__entries");
+    dict entries = arg.get_type().attr(entries_attr);
     for (auto kv : entries) {
         if (handle(kv.second[int_(0)]).equal(arg)) {
             return pybind11::str(kv.first);
@@ -1962,8 +4053,9 @@ struct enum_base {
 
         m_base.attr("__repr__") = cpp_function(
             [](const object &arg) -> str {
+                static interned_str name_attr("__name__");
                 handle type = type::handle_of(arg);
-                object type_name = type.attr("__name__");
+                object type_name = type.attr(name_attr);
                 return pybind11::str("<{}.{}: {}>")
                     .format(std::move(type_name), enum_name(arg), int_(arg));
             },
@@ -1974,7 +4066,8 @@ struct enum_base {
 
         m_base.attr("__str__") = cpp_function(
             [](handle arg) -> str {
-                object type_name = type::handle_of(arg).attr("__name__");
+                static interned_str name_attr("__name__");
+                object type_name = type::handle_of(arg).attr(name_attr);
                 return pybind11::str("{}.{}").format(std::move(type_name), enum_name(arg));
             },
             name("name"),
@@ -2012,8 +4105,10 @@ struct enum_base {
 
         m_base.attr("__members__") = static_property(cpp_function(
                                                          [](handle arg) -> dict {
-                                                             dict entries = arg.attr("__entries"),
-                                                                  m;
+                                                             static interned_str entries_attr(
+                                                                 "__entries");
+                                                             dict entries = arg.attr(entries_attr);
+                                                             dict m;
                                                              for (auto kv : entries) {
                                                                  m[kv.first] = kv.second[int_(0)];
                                                              }
@@ -2163,6 +4258,145 @@ template <typename IntLike>
 using equivalent_integer_t =
     typename equivalent_integer<std::is_signed<IntLike>::value, sizeof(IntLike)>::type;
 
+#if !defined(PYPY_VERSION)
+/// The type slots of a `py::enum_` with `py::fast_enum()`. They read the values of instances of
+/// exactly the enum type and of Python integers, and otherwise call the generic slots which call
+/// the methods (e.g. for comparisons with other types, which depend on `py::arithmetic` and on
+/// whether the enum is convertible to its underlying type).
+template <typename Type, typename Scalar>
+struct fast_enum_slots {
+    static richcmpfunc generic_richcompare;
+    static hashfunc generic_hash;
+    static unaryfunc generic_int;
+    static unaryfunc generic_index;
+
+    static bool get(PyObject *obj, Scalar &value) {
+        const auto *tinfo = get_type_info_cached<Type>();
+        if (tinfo == nullptr || Py_TYPE(obj) != tinfo->type) {
+            return false;
+        }
+        const void *ptr = reinterpret_cast<instance *>(obj)->get_value_and_holder().value_ptr();
+        if (ptr == nullptr) {
+            return false;
+        }
+        value = static_cast<Scalar>(*static_cast<const Type *>(ptr));
+        return true;
+    }
+
+    static bool get_int(PyObject *obj, Scalar &value) {
+        if (!PyLong_CheckExact(obj)) {
+            return false;
+        }
+        make_caster<Scalar> conv;
+        if (!conv.load(obj, false)) {
+            PyErr_Clear();
+            return false;
+        }
+        value = cast_op<Scalar>(conv);
+        return true;
+    }
+
+    template <typename T>
+    static PyObject *compare(T a, T b, int op) {
+        bool result = false;
+        switch (op) {
+            case Py_EQ:
+                result = a == b;
+                break;
+            case Py_NE:
+                result = a != b;
+                break;
+            case Py_LT:
+                result = a < b;
+                break;
+            case Py_LE:
+                result = a <= b;
+                break;
+            case Py_GT:
+                result = a > b;
+                break;
+            default:
+                result = a >= b;
+                break;
+        }
+        return handle(result ? Py_True : Py_False).inc_ref().ptr();
+    }
+
+    template <bool IsArithmetic, bool IsConvertible>
+    static PyObject *richcompare(PyObject *self, PyObject *other, int op) {
+        Scalar a, b;
+        if ((IsArithmetic || op == Py_EQ || op == Py_NE) && get(self, a)) {
+            if (get(other, b) || (IsConvertible && get_int(other, b))) {
+                return compare(a, b, op);
+            }
+            // Values of different types are never equal to values of an enum class
+            if (!IsConvertible && (op == Py_EQ || op == Py_NE)) {
+                return handle(op == Py_NE ? Py_True : Py_False).inc_ref().ptr();
+            }
+        }
+        return generic_richcompare(self, other, op);
+    }
+
+    static Py_hash_t hash(PyObject *self) {
+        Scalar value;
+        if (!get(self, value)) {
+            return generic_hash(self);
+        }
+        // Like the hash of the result of `__hash__`: the integer value if it fits
+        const bool fits
+            = std::is_signed<Scalar>::value
+                  ? static_cast<long long>(value) >= PY_SSIZE_T_MIN
+                        && static_cast<long long>(value) <= PY_SSIZE_T_MAX
+                  : static_cast<unsigned long long>(value)
+                        <= static_cast<unsigned long long>(PY_SSIZE_T_MAX);
+        if (fits) {
+            const auto h = static_cast<Py_hash_t>(value);
+            return h == -1 ? -2 : h;
+        }
+        auto h = PyLong_Type.tp_hash(int_(value).ptr());
+        return h == -1 ? -2 : h;
+    }
+
+    static PyObject *to_int(PyObject *self) {
+        Scalar value;
+        if (!get(self, value)) {
+            return generic_int(self);
+        }
+        return int_(value).release().ptr();
+    }
+
+    static PyObject *to_index(PyObject *self) {
+        Scalar value;
+        if (!get(self, value)) {
+            return generic_index(self);
+        }
+        return int_(value).release().ptr();
+    }
+
+    template <bool IsArithmetic, bool IsConvertible>
+    static void install(handle cls) {
+        auto *type = reinterpret_cast<PyTypeObject *>(cls.ptr());
+        generic_richcompare = type->tp_richcompare;
+        generic_hash = type->tp_hash;
+        generic_int = type->tp_as_number->nb_int;
+        generic_index = type->tp_as_number->nb_index;
+        type->tp_richcompare = &richcompare<IsArithmetic, IsConvertible>;
+        type->tp_hash = &hash;
+        type->tp_as_number->nb_int = &to_int;
+        type->tp_as_number->nb_index = &to_index;
+    }
+};
+
+template <typename Type, typename Scalar>
+richcmpfunc fast_enum_slots<Type, Scalar>::generic_richcompare = nullptr;
+template <typename Type, typename Scalar>
+hashfunc fast_enum_slots<Type, Scalar>::generic_hash = nullptr;
+template <typename Type, typename Scalar>
+unaryfunc fast_enum_slots<Type, Scalar>::generic_int = nullptr;
+template <typename Type, typename Scalar>
+unaryfunc fast_enum_slots<Type, Scalar>::generic_index = nullptr;
+#endif
+
 PYBIND11_NAMESPACE_END(detail)
 
 /// Binds C++ enumerations and enumeration classes to Python
@@ -2184,6 +4418,8 @@ public:
     template <typename... Extra>
     enum_(const handle &scope, const char *name, const Extra &...extra)
         : class_<Type>(scope, name, extra...), m_base(*this, scope) {
+        // The creation of the type itself is profiled as `class_`
+        detail::import_profile_scope profile_scope("enum_", name, scope);
         constexpr bool is_arithmetic = detail::any_of<std::is_same<arithmetic, Extra>...>::value;
         constexpr bool is_convertible = std::is_convertible<Type, Underlying>::value;
         m_base.init(is_arithmetic, is_convertible);
@@ -2201,6 +4437,17 @@ public:
             pybind11::name("__setstate__"),
             is_method(*this),
             arg("state"));
+
+        if (detail::any_of<std::is_same<fast_enum, Extra>...>::value) {
+#if PYBIND11_INTERNALS_VERSION > 5
+            auto *tinfo = detail::get_type_info((PyTypeObject *) this->m_ptr);
+            tinfo->enum_values = new detail::enum_value_table();
+#endif
+#if !defined(PYPY_VERSION)
+            detail::fast_enum_slots<Type, Scalar>::template install<is_arithmetic, is_convertible>(
+                *this);
+#endif
+        }
     }
 
     /// Export enumeration entries into the parent scope
@@ -2211,7 +4458,16 @@ public:
 
     /// Add an enumeration entry
     enum_ &value(char const *name, Type value, const char *doc = nullptr) {
-        m_base.value(name, pybind11::cast(value, return_value_policy::copy), doc);
+        object obj = pybind11::cast(value, return_value_policy::copy);
+        handle added = obj;
+        m_base.value(name, std::move(obj), doc);
+        auto *tinfo = detail::get_type_info((PyTypeObject *) this->m_ptr);
+        auto *values = detail::get_enum_values(tinfo);
+        if (values != nullptr && Py_TYPE(added.ptr()) == tinfo->type) {
+            // Borrowed: `__entries` keeps the object alive
+            values->insert(static_cast<std::uint64_t>(static_cast<Underlying>(value)),
+                           added.ptr());
+        }
         return *this;
     }
 
@@ -2221,6 +4477,13 @@ private:
 
 PYBIND11_NAMESPACE_BEGIN(detail)
 
+/// Weak reference callback of `keep_alive_impl`, bound to the patient: it releases the leaked
+/// weak reference, which in turn releases this callback and with it the patient
+extern "C" inline PyObject *keep_alive_release(PyObject *, PyObject *weakref) {
+    Py_DECREF(weakref);
+    Py_RETURN_NONE;
+}
+
 PYBIND11_NOINLINE void keep_alive_impl(handle nurse, handle patient) {
     if (!nurse || !patient) {
         pybind11_fail("Could not activate keep_alive!");
@@ -2229,6 +4492,7 @@ PYBIND11_NOINLINE void keep_alive_impl(handle nurse, handle patient) {
     if (patient.is_none() || nurse.is_none()) {
         return; /* Nothing to keep alive or nothing to be kept alive by */
     }
+    PYBIND11_TRACE(keep_alive, Py_TYPE(nurse.ptr())->tp_name, patient.ptr());
 
     auto tinfo = all_type_info(Py_TYPE(nurse.ptr()));
     if (!tinfo.empty()) {
@@ -2238,16 +4502,19 @@ PYBIND11_NOINLINE void keep_alive_impl(handle nurse, handle patient) {
     } else {
         /* Fall back to clever approach based on weak references taken from
          * Boost.Python. This is not used for pybind-registered types because
-         * the objects can be destroyed out-of-order in a GC pass. */
-        cpp_function disable_lifesupport([patient](handle weakref) {
-            patient.dec_ref();
-            weakref.dec_ref();
-        });
+         * the objects can be destroyed out-of-order in a GC pass. The callback
+         * is a plain builtin function that references the patient as its `self`. */
+        static PyMethodDef release_def
+            = {"keep_alive_release", keep_alive_release, METH_O, nullptr};
+        auto disable_lifesupport
+            = reinterpret_steal<object>(PyCFunction_New(&release_def, patient.ptr()));
+        if (!disable_lifesupport) {
+            throw error_already_set();
+        }
 
         weakref wr(nurse, disable_lifesupport);
 
-        patient.inc_ref(); /* reference patient and leak the weak reference */
-        (void) wr.release();
+        (void) wr.release(); /* leak the weak reference */
     }
 }
 
@@ -2271,28 +4538,38 @@ keep_alive_impl(size_t Nurse, size_t Patient, function_call &call, handle ret) {
 
 inline std::pair<decltype(internals::registered_types_py)::iterator, bool>
 all_type_info_get_cache(PyTypeObject *type) {
-    auto res = get_internals()
-                   .registered_types_py
+    auto res = with_internals([type](internals &internals) {
+        auto res = internals
+                       .registered_types_py
 #ifdef __cpp_lib_unordered_map_try_emplace
-                   .try_emplace(type);
+                       .try_emplace(type);
 #else
-                   .emplace(type, std::vector<detail::type_info *>());
+                       .emplace(type, std::vector<detail::type_info *>());
 #endif
+#if defined(Py_GIL_DISABLED)
+        // Populated right away, so that other threads never see the entry empty
+        if (res.second) {
+            all_type_info_populate(type, res.first->second);
+        }
+#endif
+        return res;
+    });
     if (res.second) {
         // New cache entry created; set up a weak reference to automatically remove it if the type
         // gets destroyed:
         weakref((PyObject *) type, cpp_function([type](handle wr) {
-                    get_internals().registered_types_py.erase(type);
-
-                    // TODO consolidate the erasure code in pybind11_meta_dealloc() in class.h
-                    auto &cache = get_internals().inactive_override_cache;
-                    for (auto it = cache.begin(), last = cache.end(); it != last;) {
-                        if (it->first == reinterpret_cast<PyObject *>(type)) {
-                            it = cache.erase(it);
-                        } else {
-                            ++it;
+                    with_internals([type](internals &internals) {
+                        internals.registered_types_py.erase(type);
+#if defined(PYBIND11_HAS_TYPE_INFO_SLOT)
+                        // Instances of the type can still be destroyed after this, e.g. when it
+                        // is part of a reference cycle
+                        if (auto *slot = all_type_info_slot(type)) {
+                            *slot = nullptr;
                         }
-                    }
+#endif
+
+                        clear_override_cache(internals, reinterpret_cast<PyObject *>(type));
+                    });
 
                     wr.dec_ref();
                 }))
@@ -2363,6 +4640,59 @@ public:
     result_type operator()(Iterator &it) const { return (*it).second; }
 };
 
+/// Advances the iterator of `s`; returns false when it is exhausted
+template <typename State>
+bool iterator_advance(State &s) {
+    if (!s.first_or_done) {
+        ++s.it;
+    } else {
+        s.first_or_done = false;
+    }
+    if (s.it == s.end) {
+        s.first_or_done = true;
+        return false;
+    }
+    return true;
+}
+
+#if !defined(PYPY_VERSION)
+/// Returns the state of an iterator instance, or nullptr with a `TypeError` set if it was created
+/// without it (e.g. by `type(it).__new__(type(it))`)
+template <typename State>
+State *get_iterator_state(PyObject *self) {
+    auto *state = static_cast<State *>(
+        reinterpret_cast<instance *>(self)->get_value_and_holder().value_ptr());
+    if (state == nullptr) {
+        PyErr_Format(PyExc_TypeError,
+                     "'%s' object is not initialized (its __init__ was not called)",
+                     Py_TYPE(self)->tp_name);
+    }
+    return state;
+}
+
+/// The `tp_iternext` slot of the iterator types of `make_iterator` and friends. It does what
+/// `__next__` does without going through the function dispatcher, and returns nullptr without
+/// setting `StopIteration` when the iterator is exhausted, like the iterators of built-in types.
+template <typename Access, return_value_policy Policy, typename ValueType, typename State>
+PyObject *iterator_next(PyObject *self) {
+    try {
+        auto *state = get_iterator_state<State>(self);
+        if (state == nullptr) {
+            return nullptr;
+        }
+        auto &s = *state;
+        if (!iterator_advance(s)) {
+            return nullptr;
+        }
+        ValueType value = Access()(s.it);
+        const auto policy = return_value_policy_override<ValueType>::policy(Policy);
+        return make_caster<ValueType>::cast(std::forward<ValueType>(value), policy, self).ptr();
+    } catch (...) {
+        return handle_active_exception();
+    }
+}
+#endif
+
 template <typename Access,
           return_value_policy Policy,
           typename Iterator,
@@ -2374,18 +4704,12 @@ iterator make_iterator_impl(Iterator first, Sentinel last, Extra &&...extra) {
     // TODO: state captures only the types of Extra, not the values
 
     if (!detail::get_type_info(typeid(state), false)) {
-        class_<state>(handle(), "iterator", pybind11::module_local())
-            .def("__iter__", [](state &s) -> state & { return s; })
+        class_<state> cls(handle(), "iterator", pybind11::module_local(), inline_storage());
+        cls.def("__iter__", [](state &s) -> state & { return s; })
             .def(
                 "__next__",
                 [](state &s) -> ValueType {
-                    if (!s.first_or_done) {
-                        ++s.it;
-                    } else {
-                        s.first_or_done = false;
-                    }
-                    if (s.it == s.end) {
-                        s.first_or_done = true;
+                    if (!iterator_advance(s)) {
                         throw stop_iteration();
                     }
                     return Access()(s.it);
@@ -2393,6 +4717,14 @@ iterator make_iterator_impl(Iterator first, Sentinel last, Extra &&...extra) {
                 },
                 std::forward<Extra>(extra)...,
                 Policy);
+#if !defined(PYPY_VERSION)
+        // Extra arguments (e.g. `py::keep_alive`) are only applied by `__next__`
+        if (sizeof...(Extra) == 0) {
+            auto *type = reinterpret_cast<PyTypeObject *>(cls.ptr());
+            type->tp_iter = PyObject_SelfIter;
+            type->tp_iternext = &iterator_next<Access, Policy, ValueType, state>;
+        }
+#endif
     }
 
     return cast(state{first, last, true});
@@ -2485,7 +4817,11 @@ void implicitly_convertible() {
         ~set_flag() { flag = false; }
     };
     auto implicit_caster = [](PyObject *obj, PyTypeObject *type) -> PyObject * {
+#if defined(Py_GIL_DISABLED) || defined(PYBIND11_HAS_SUBINTERPRETER_SUPPORT)
+        thread_local bool currently_used = false;
+#else
         static bool currently_used = false;
+#endif
         if (currently_used) { // implicit conversions are non-reentrant
             return nullptr;
         }
@@ -2510,8 +4846,10 @@ void implicitly_convertible() {
 }
 
 inline void register_exception_translator(ExceptionTranslator &&translator) {
-    detail::get_internals().registered_exception_translators.push_front(
-        std::forward<ExceptionTranslator>(translator));
+    detail::with_internals([&](detail::internals &internals) {
+        internals.registered_exception_translators.push_front(
+            std::forward<ExceptionTranslator>(translator));
+    });
 }
 
 /**
@@ -2521,8 +4859,10 @@ inline void register_exception_translator(ExceptionTranslator &&translator) {
  * the exception.
  */
 inline void register_local_exception_translator(ExceptionTranslator &&translator) {
-    detail::get_local_internals().registered_exception_translators.push_front(
-        std::forward<ExceptionTranslator>(translator));
+    detail::with_internals([&](detail::internals &) {
+        detail::get_local_internals().registered_exception_translators.push_front(
+            std::forward<ExceptionTranslator>(translator));
+    });
 }
 
 /**
@@ -2670,6 +5010,15 @@ inline const char *error_already_set::what() const noexcept {
 
 PYBIND11_NAMESPACE_BEGIN(detail)
 
+#if PYBIND11_INTERNALS_VERSION > 5
+/// Whether the instance dict of `self` (if it has one) shadows the attribute `name`
+inline bool instance_dict_contains(handle self, const char *name) {
+    PyObject **dict_ptr = _PyObject_GetDictPtr(self.ptr());
+    return dict_ptr != nullptr && *dict_ptr != nullptr
+           && dict_getitemstring(*dict_ptr, name) != nullptr;
+}
+#endif
+
 inline function
 get_type_override(const void *this_ptr, const type_info *this_type, const char *name) {
     handle self = get_object_handle(this_ptr, this_type);
@@ -2679,18 +5028,89 @@ get_type_override(const void *this_ptr, const type_info *this_type, const char *
     handle type = type::handle_of(self);
     auto key = std::make_pair(type.ptr(), name);
 
+#if PYBIND11_INTERNALS_VERSION > 5 && !defined(Py_GIL_DISABLED)
+    /* Cache what the lookup below finds for each type and name, for as long as the type is not
+       modified, to avoid many costly Python dictionary lookups */
+    auto *tp = (PyTypeObject *) type.ptr();
+    auto &cache = get_internals().override_cache;
+    function override;
+    auto it = cache.find(key);
+    if (it != cache.end() && it->second.version_tag == valid_version_tag(tp)) {
+        if (it->second.function == nullptr) {
+            return function();
+        }
+        if (!instance_dict_contains(self, name)) {
+            override = reinterpret_steal<function>(PyMethod_New(it->second.function, self.ptr()));
+            if (!override) {
+                throw error_already_set();
+            }
+        }
+    }
+    if (!override) {
+        override = getattr(self, name, function());
+        if (override.is_cpp_function()) {
+#    if defined(PYPY_VERSION)
+            // Without version tags this has to be trusted forever, as it was before
+            cache[key] = override_cache_entry{};
+#    else
+            if (auto tag = valid_version_tag(tp)) {
+                cache[key] = override_cache_entry{tag, nullptr};
+            }
+#    endif
+            return function();
+        }
+#    if !defined(PYPY_VERSION)
+        // Only plain Python methods found on the type can be bound again without `getattr`
+        auto tag = valid_version_tag(tp);
+        if (override && tag != 0 && tp->tp_getattro == PyObject_GenericGetAttr
+            && PyMethod_Check(override.ptr()) && PyMethod_GET_SELF(override.ptr()) == self.ptr()
+            && PyFunction_Check(PyMethod_GET_FUNCTION(override.ptr()))
+            && !instance_dict_contains(self, name)) {
+            cache[key] = override_cache_entry{tag, PyMethod_GET_FUNCTION(override.ptr())};
+        }
+#    endif
+    }
+#elif PYBIND11_INTERNALS_VERSION > 5
+    /* Without the GIL, only methods that are not overridden are cached: another thread could
+       free a function borrowed from the type at any time */
+    auto *tp = (PyTypeObject *) type.ptr();
+    const bool not_overridden = with_internals([&](internals &internals) {
+        auto it = internals.override_cache.find(key);
+        return it != internals.override_cache.end() && it->second.function == nullptr
+               && it->second.version_tag == valid_version_tag(tp);
+    });
+    if (not_overridden) {
+        return function();
+    }
+
+    function override = getattr(self, name, function());
+    if (override.is_cpp_function()) {
+        if (auto tag = valid_version_tag(tp)) {
+            with_internals([&](internals &internals) {
+                internals.override_cache[key] = override_cache_entry{tag, nullptr};
+            });
+        }
+        return function();
+    }
+#else
     /* Cache functions that aren't overridden in Python to avoid
        many costly Python dictionary lookups below */
-    auto &cache = get_internals().inactive_override_cache;
-    if (cache.find(key) != cache.end()) {
+    const bool not_overridden = with_internals([&](internals &internals) {
+        return internals.inactive_override_cache.find(key)
+               != internals.inactive_override_cache.end();
+    });
+    if (not_overridden) {
         return function();
     }
 
     function override = getattr(self, name, function());
     if (override.is_cpp_function()) {
-        cache.insert(std::move(key));
+        with_internals([&](internals &internals) {
+            internals.inactive_override_cache.insert(std::move(key));
+        });
         return function();
     }
+#endif
 
     /* Don't call dispatch code if invoked from overridden function.
        Unfortunately this doesn't work on PyPy. */
@@ -14,6 +14,7 @@
 
 #include <assert.h>
 #include <cstddef>
+#include <cstring>
 #include <exception>
 #include <frameobject.h>
 #include <iterator>
@@ -44,6 +45,34 @@ class type;
 struct arg;
 struct arg_v;
 
+/** \rst
+    The name of an attribute which is interned into a Python string the first time it is used and
+    then reused for as long as the interpreter lives, so that lookups neither create a new string
+    nor hash it again. It is meant to be a function-local ``static``:
+
+    .. code-block:: cpp
+
+        static py::interned_str name_attr("name");
+        py::object name = obj.attr(name_attr);
+
+    The string is made again after the interpreter is restarted. In any other interpreter than
+    the one it was first used in, every call of `get()` interns it anew.
+\endrst */
+class interned_str {
+public:
+    explicit constexpr interned_str(const char *value) : m_value(value) {}
+
+    const char *value() const { return m_value; }
+
+    /// Returns the interned Python string. Requires the GIL.
+    object get() const;
+
+private:
+    const char *m_value;
+    mutable PyObject *m_str = nullptr;
+    mutable size_t m_generation = 0;
+};
+
 PYBIND11_NAMESPACE_BEGIN(detail)
 class args_proxy;
 bool isinstance_generic(handle obj, const std::type_info &tp);
@@ -111,6 +140,8 @@ public:
     obj_attr_accessor attr(object &&key) const;
     /// See above (the only difference is that the key is provided as a string literal)
     str_attr_accessor attr(const char *key) const;
+    /// See above (the only difference is that the key is only converted to a string once)
+    obj_attr_accessor attr(const interned_str &key) const;
 
     /** \rst
         Matches * unpacking in Python, e.g. to unpack arguments out of a ``tuple``
@@ -484,11 +515,12 @@ struct error_fetch_and_normalize {
     //     Immediate normalization is long-established behavior (starting with
     //     https://github.com/pybind/pybind11/commit/135ba8deafb8bf64a15b24d1513899eb600e2011
     //     from Sep 2016) and safest. Normalization could be deferred, but this could mask
-    //     errors elsewhere, the performance gain is very minor in typical situations
-    //     (usually the dominant bottleneck is EH unwinding), and the implementation here
-    //     would be more complex.
+    //     errors elsewhere, and a failed normalization could then no longer be reported by
+    //     throwing (what() is noexcept).
     // Starting with Python 3.12, PyErr_Fetch() normalizes exceptions immediately.
     // Any errors during normalization are tracked under __notes__.
+    // Everything else, including the name of the exception type, is only looked up when the
+    // error string is needed, so that errors which are caught and handled in C++ are cheap.
     explicit error_fetch_and_normalize(const char *called) {
         PyErr_Fetch(&m_type.ptr(), &m_value.ptr(), &m_trace.ptr());
         if (!m_type) {
@@ -496,21 +528,13 @@ struct error_fetch_and_normalize {
                           + " called while "
                             "Python error indicator not set.");
         }
+#if PY_VERSION_HEX < 0x030C0000
         const char *exc_type_name_orig = detail::obj_class_name(m_type.ptr());
         if (exc_type_name_orig == nullptr) {
             pybind11_fail("Internal error: " + std::string(called)
                           + " failed to obtain the name "
                             "of the original active exception type.");
         }
-        m_lazy_error_string = exc_type_name_orig;
-#if PY_VERSION_HEX >= 0x030C0000
-        // The presence of __notes__ is likely due to exception normalization
-        // errors, although that is not necessarily true, therefore insert a
-        // hint only:
-        if (PyObject_HasAttrString(m_value.ptr(), "__notes__")) {
-            m_lazy_error_string += "[WITH __notes__]";
-        }
-#else
         // PyErr_NormalizeException() may change the exception type if there are cascading
         // failures. This can potentially be extremely confusing.
         PyErr_NormalizeException(&m_type.ptr(), &m_value.ptr(), &m_trace.ptr());
@@ -525,18 +549,16 @@ struct error_fetch_and_normalize {
                           + " failed to obtain the name "
                             "of the normalized active exception type.");
         }
-#    if defined(PYPY_VERSION_NUM) && PYPY_VERSION_NUM < 0x07030a00
         // This behavior runs the risk of masking errors in the error handling, but avoids a
         // conflict with PyPy, which relies on the normalization here to change OSError to
         // FileNotFoundError (https://github.com/pybind/pybind11/issues/4075).
-        m_lazy_error_string = exc_type_name_norm;
-#    else
-        if (exc_type_name_norm != m_lazy_error_string) {
+#    if !defined(PYPY_VERSION_NUM) || PYPY_VERSION_NUM >= 0x07030a00
+        if (std::strcmp(exc_type_name_norm, exc_type_name_orig) != 0) {
             std::string msg = std::string(called)
                               + ": MISMATCH of original and normalized "
                                 "active exception types: ";
             msg += "ORIGINAL ";
-            msg += m_lazy_error_string;
+            msg += exc_type_name_orig;
             msg += " REPLACED BY ";
             msg += exc_type_name_norm;
             msg += ": " + format_value_and_trace();
@@ -674,6 +696,16 @@ struct error_fetch_and_normalize {
 
     std::string const &error_string() const {
         if (!m_lazy_error_string_completed) {
+            const char *exc_type_name = detail::obj_class_name(m_type.ptr());
+            m_lazy_error_string = exc_type_name != nullptr ? exc_type_name : "<UNNAMED TYPE>";
+#if PY_VERSION_HEX >= 0x030C0000
+            // The presence of __notes__ is likely due to exception normalization
+            // errors, although that is not necessarily true, therefore insert a
+            // hint only:
+            if (PyObject_HasAttrString(m_value.ptr(), "__notes__")) {
+                m_lazy_error_string += "[WITH __notes__]";
+            }
+#endif
             m_lazy_error_string += ": " + format_value_and_trace();
             m_lazy_error_string_completed = true;
         }
@@ -897,6 +929,53 @@ inline object getattr(handle obj, const char *name, handle default_) {
     return reinterpret_borrow<object>(default_);
 }
 
+#ifdef PYBIND11_HAS_OPTIONAL
+PYBIND11_NAMESPACE_BEGIN(detail)
+// `result` is the return value of `PyObject_GetOptionalAttr()`
+inline std::optional<object> optional_attr(int result, PyObject *attr) {
+    if (result < 0) {
+        throw error_already_set();
+    }
+    if (result == 0) {
+        return std::nullopt;
+    }
+    return reinterpret_steal<object>(attr);
+}
+// `attr` is the return value of `PyObject_GetAttr()`
+inline std::optional<object> optional_attr(PyObject *attr) {
+    if (attr != nullptr) {
+        return reinterpret_steal<object>(attr);
+    }
+    if (!PyErr_ExceptionMatches(PyExc_AttributeError)) {
+        throw error_already_set();
+    }
+    PyErr_Clear();
+    return std::nullopt;
+}
+PYBIND11_NAMESPACE_END(detail)
+
+/// Like `getattr`, but returns `std::nullopt` if the object has no such attribute, without
+/// creating an `error_already_set` for the `AttributeError` (or, with Python 3.13, the
+/// `AttributeError` itself). Other errors are still thrown.
+inline std::optional<object> try_getattr(handle obj, handle name) {
+#    if PY_VERSION_HEX >= 0x030D0000 && !defined(PYPY_VERSION)
+    PyObject *attr = nullptr;
+    return detail::optional_attr(PyObject_GetOptionalAttr(obj.ptr(), name.ptr(), &attr), attr);
+#    else
+    return detail::optional_attr(PyObject_GetAttr(obj.ptr(), name.ptr()));
+#    endif
+}
+
+inline std::optional<object> try_getattr(handle obj, const char *name) {
+#    if PY_VERSION_HEX >= 0x030D0000 && !defined(PYPY_VERSION)
+    PyObject *attr = nullptr;
+    return detail::optional_attr(PyObject_GetOptionalAttrString(obj.ptr(), name, &attr), attr);
+#    else
+    return detail::optional_attr(PyObject_GetAttrString(obj.ptr(), name));
+#    endif
+}
+#endif
+
 inline void setattr(handle obj, handle name, handle value) {
     if (PyObject_SetAttr(obj.ptr(), name.ptr(), value.ptr()) != 0) {
         throw error_already_set();
@@ -1012,6 +1091,12 @@ public:
         return obj.contains(key);
     }
 
+    /// Calls the accessed object like `object_api::operator()`. Attributes that have not been
+    /// looked up yet are called as methods, without creating a bound method object.
+    template <return_value_policy policy = return_value_policy::automatic_reference,
+              typename... Args>
+    object operator()(Args &&...args) const;
+
     // NOLINTNEXTLINE(google-explicit-constructor)
     operator object() const { return get_cache(); }
     PyObject *ptr() const { return get_cache().ptr(); }
@@ -1591,7 +1676,8 @@ public:
 
     template <typename... Args>
     str format(Args &&...args) const {
-        return attr("format")(std::forward<Args>(args)...);
+        static interned_str format_attr("format");
+        return attr(format_attr)(std::forward<Args>(args)...);
     }
 
 private:
@@ -2038,6 +2124,13 @@ public:
             pybind11_fail("Could not allocate tuple object!");
         }
     }
+    /// Makes a tuple of the elements of the forward iterator range [first, last), each converted
+    /// with the caster of its type and `policy`. Throws `cast_error` if one cannot be converted.
+    template <typename Iterator>
+    static tuple from_range(Iterator first,
+                            Iterator last,
+                            return_value_policy policy = return_value_policy::automatic_reference);
+
     size_t size() const { return (size_t) PyTuple_Size(m_ptr); }
     bool empty() const { return size() == 0; }
     detail::tuple_accessor operator[](size_t index) const { return {*this, index}; }
@@ -2072,6 +2165,14 @@ public:
               typename collector = detail::deferred_t<detail::unpacking_collector<>, Args...>>
     explicit dict(Args &&...args) : dict(collector(std::forward<Args>(args)...).kwargs()) {}
 
+    /// Makes a dict of the pairs in the forward iterator range [first, last), with the `first` and
+    /// `second` of each converted with the casters of their types and `policy`. Throws
+    /// `cast_error` if one cannot be converted.
+    template <typename Iterator>
+    static dict from_pairs(Iterator first,
+                           Iterator last,
+                           return_value_policy policy = return_value_policy::automatic_reference);
+
     size_t size() const { return (size_t) PyDict_Size(m_ptr); }
     bool empty() const { return size() == 0; }
     detail::dict_iterator begin() const { return {*this, 0}; }
@@ -2127,6 +2228,13 @@ public:
             pybind11_fail("Could not allocate list object!");
         }
     }
+    /// Makes a list of the elements of the forward iterator range [first, last), each converted
+    /// with the caster of its type and `policy`. Throws `cast_error` if one cannot be converted.
+    template <typename Iterator>
+    static list from_range(Iterator first,
+                           Iterator last,
+                           return_value_policy policy = return_value_policy::automatic_reference);
+
     size_t size() const { return (size_t) PyList_Size(m_ptr); }
     bool empty() const { return size() == 0; }
     detail::list_accessor operator[](size_t index) const { return {*this, index}; }
@@ -2215,10 +2323,77 @@ public:
     PYBIND11_OBJECT_CVT(staticmethod, object, detail::PyStaticMethod_Check, PyStaticMethod_New)
 };
 
+/**
+ * A buffer exported by a Python object, released on destruction. Unlike `buffer_info`, it
+ * allocates nothing: the `Py_buffer` is stored inline, and the shape and strides are read from
+ * it (valid for as long as the view exists). For exporters that do not give strides, such as
+ * ctypes, C-contiguous strides are computed as needed.
+ */
+class buffer_view {
+public:
+    /// Requests a (writable) buffer from `obj`; throws `error_already_set` if there is none
+    explicit buffer_view(handle obj, bool writable = false) {
+        int flags = PyBUF_STRIDES | PyBUF_FORMAT;
+        if (writable) {
+            flags |= PyBUF_WRITABLE;
+        }
+        if (PyObject_GetBuffer(obj.ptr(), &m_view, flags) != 0) {
+            throw error_already_set();
+        }
+    }
+
+    buffer_view(const buffer_view &) = delete;
+    buffer_view &operator=(const buffer_view &) = delete;
+
+    buffer_view(buffer_view &&other) noexcept : m_view(other.m_view) {
+        other.m_view.obj = nullptr;
+    }
+
+    buffer_view &operator=(buffer_view &&other) noexcept {
+        if (this != &other) {
+            PyBuffer_Release(&m_view);
+            m_view = other.m_view;
+            other.m_view.obj = nullptr;
+        }
+        return *this;
+    }
+
+    ~buffer_view() { PyBuffer_Release(&m_view); }
+
+    void *ptr() const { return m_view.buf; }
+    ssize_t itemsize() const { return m_view.itemsize; }
+    /// The struct-module style format of the items
+    const char *format() const { return m_view.format != nullptr ? m_view.format : "B"; }
+    ssize_t ndim() const { return m_view.ndim; }
+    ssize_t shape(ssize_t dim) const { return m_view.shape[dim]; }
+    ssize_t strides(ssize_t dim) const {
+        if (m_view.strides != nullptr) {
+            return m_view.strides[dim];
+        }
+        ssize_t stride = m_view.itemsize;
+        for (ssize_t i = dim + 1; i < m_view.ndim; ++i) {
+            stride *= m_view.shape[i];
+        }
+        return stride;
+    }
+    /// Total number of items
+    ssize_t size() const { return m_view.itemsize != 0 ? m_view.len / m_view.itemsize : 0; }
+    ssize_t nbytes() const { return m_view.len; }
+    bool readonly() const { return m_view.readonly != 0; }
+
+    const Py_buffer *view() const { return &m_view; }
+
+private:
+    Py_buffer m_view{};
+};
+
 class buffer : public object {
 public:
     PYBIND11_OBJECT_DEFAULT(buffer, object, PyObject_CheckBuffer)
 
+    /// Like `request()`, without allocating; see `buffer_view`
+    buffer_view view(bool writable = false) const { return buffer_view(*this, writable); }
+
     buffer_info request(bool writable = false) const {
         int flags = PyBUF_STRIDES | PyBUF_FORMAT;
         if (writable) {
@@ -2349,6 +2524,29 @@ public:
         return from_memory(const_cast<char *>(mem.data()), static_cast<ssize_t>(mem.size()), true);
     }
 #endif
+
+    /** \rst
+        Creates a one-dimensional ``memoryview`` of the ``size`` elements of ``data``, which it
+        takes ownership of: the memory is freed once this view, the views made from it (e.g.
+        slices) and all other consumers of its buffer (e.g. NumPy arrays) are gone.
+
+        The format is ``format_descriptor<T>::format()``.
+     \endrst */
+    template <typename T, typename Deleter>
+    static memoryview
+    from_owned(std::unique_ptr<T[], Deleter> data, ssize_t size, bool readonly = false);
+
+    /** \rst
+        Creates a ``memoryview`` of the ``size`` bytes at ``ptr``, which keeps ``owner`` alive
+        for as long as the buffer is in use, like `from_owned()`. ``ptr`` usually points into
+        memory that ``owner`` manages.
+     \endrst */
+    static memoryview
+    from_shared(std::shared_ptr<void> owner, void *ptr, ssize_t size, bool readonly = false);
+
+    static memoryview from_shared(std::shared_ptr<void> owner, const void *ptr, ssize_t size) {
+        return from_shared(std::move(owner), const_cast<void *>(ptr), size, true);
+    }
 };
 
 /// @cond DUPLICATE
@@ -2463,13 +2661,18 @@ str_attr_accessor object_api<D>::attr(const char *key) const {
     return {derived(), key};
 }
 template <typename D>
+obj_attr_accessor object_api<D>::attr(const interned_str &key) const {
+    return {derived(), key.get()};
+}
+template <typename D>
 args_proxy object_api<D>::operator*() const {
     return args_proxy(derived().ptr());
 }
 template <typename D>
 template <typename T>
 bool object_api<D>::contains(T &&item) const {
-    return attr("__contains__")(std::forward<T>(item)).template cast<bool>();
+    static interned_str contains_attr("__contains__");
+    return attr(contains_attr)(std::forward<T>(item)).template cast<bool>();
 }
 
 template <typename D>
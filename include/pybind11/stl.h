@@ -12,6 +12,9 @@
 #include "pybind11.h"
 #include "detail/common.h"
 
+#include <array>
+#include <cstdint>
+#include <cstring>
 #include <deque>
 #include <list>
 #include <map>
@@ -32,23 +35,18 @@
 #    include <variant>
 #endif
 
+#if defined(PYBIND11_HAS_SPAN)
+#    include <span>
+#endif
+
+#if defined(PYBIND11_HAS_EXPECTED)
+#    include <expected>
+#    include <string>
+#endif
+
 PYBIND11_NAMESPACE_BEGIN(PYBIND11_NAMESPACE)
 PYBIND11_NAMESPACE_BEGIN(detail)
 
-/// Extracts an const lvalue reference or rvalue reference for U based on the type of T (e.g. for
-/// forwarding a container element).  Typically used indirect via forwarded_type(), below.
-template <typename T, typename U>
-using forwarded_type = conditional_t<std::is_lvalue_reference<T>::value,
-                                     remove_reference_t<U> &,
-                                     remove_reference_t<U> &&>;
-
-/// Forwards a value U as rvalue or lvalue according to whether T is rvalue or lvalue; typically
-/// used for forwarding a container's elements.
-template <typename T, typename U>
-constexpr forwarded_type<T, U> forward_like(U &&u) {
-    return std::forward<detail::forwarded_type<T, U>>(std::forward<U>(u));
-}
-
 // Checks if a container has a STL style reserve method.
 // This will only return true for a `reserve()` with a `void` return.
 template <typename C>
@@ -74,7 +72,17 @@ public:
         auto s = reinterpret_borrow<anyset>(src);
         value.clear();
         reserve_maybe(s, &value);
+#if !defined(PYPY_VERSION) && PY_VERSION_HEX < 0x030D0000
+        // Walks the hash table directly rather than creating an iterator. Loading an entry can
+        // run arbitrary code that may modify the set, so each entry gets a new reference.
+        Py_ssize_t pos = 0;
+        PyObject *key = nullptr;
+        Py_hash_t hash = 0;
+        while (_PySet_NextEntry(s.ptr(), &pos, &key, &hash) != 0) {
+            auto entry = reinterpret_borrow<object>(key);
+#else
         for (auto entry : s) {
+#endif
             key_conv conv;
             if (!conv.load(entry, convert)) {
                 return false;
@@ -136,24 +144,15 @@ public:
 
     template <typename T>
     static handle cast(T &&src, return_value_policy policy, handle parent) {
-        dict d;
         return_value_policy policy_key = policy;
         return_value_policy policy_value = policy;
         if (!std::is_lvalue_reference<T>::value) {
             policy_key = return_value_policy_override<Key>::policy(policy_key);
             policy_value = return_value_policy_override<Value>::policy(policy_value);
         }
-        for (auto &&kv : src) {
-            auto key = reinterpret_steal<object>(
-                key_conv::cast(detail::forward_like<T>(kv.first), policy_key, parent));
-            auto value = reinterpret_steal<object>(
-                value_conv::cast(detail::forward_like<T>(kv.second), policy_value, parent));
-            if (!key || !value) {
-                return handle();
-            }
-            d[std::move(key)] = std::move(value);
-        }
-        return d.release();
+        return cast_dict<Key, Value>(
+                   forwarding_begin<T>(src), src.size(), policy_key, policy_value, parent)
+            .release();
     }
 
     PYBIND11_TYPE_CASTER(Type,
@@ -166,12 +165,18 @@ struct list_caster {
     using value_conv = make_caster<Value>;
 
     bool load(handle src, bool convert) {
+        if (PyList_CheckExact(src.ptr()) || PyTuple_CheckExact(src.ptr())) {
+            return load_list_or_tuple(src, convert);
+        }
         if (!isinstance<sequence>(src) || isinstance<bytes>(src) || isinstance<str>(src)) {
             return false;
         }
+        if (load_buffer(src)) {
+            return true;
+        }
         auto s = reinterpret_borrow<sequence>(src);
         value.clear();
-        reserve_maybe(s, &value);
+        reserve_maybe(s.size(), &value);
         for (auto it : s) {
             value_conv conv;
             if (!conv.load(it, convert)) {
@@ -183,11 +188,72 @@ struct list_caster {
     }
 
 private:
+    // Exact lists and tuples are indexed directly instead of going through the iterator protocol
+    bool load_list_or_tuple(handle src, bool convert) {
+        value.clear();
+        reserve_maybe(static_cast<size_t>(PySequence_Fast_GET_SIZE(src.ptr())), &value);
+        // The size is checked again every time: loading an element can run arbitrary code, which
+        // may also modify a list (hence the new reference to the element, too)
+        for (ssize_t i = 0; i < PySequence_Fast_GET_SIZE(src.ptr()); ++i) {
+            auto item = reinterpret_borrow<object>(PySequence_Fast_GET_ITEM(src.ptr(), i));
+            value_conv conv;
+            if (!conv.load(item, convert)) {
+                return false;
+            }
+            value.push_back(cast_op<Value &&>(std::move(conv)));
+        }
+        return true;
+    }
+
+    // Sequences of numbers that expose them through the buffer protocol (NumPy arrays,
+    // `array.array`, `memoryview`) are copied from the buffer, if its item type matches exactly,
+    // instead of converting every element to a Python number and back. This includes
+    // `std::complex` elements when `pybind11/complex.h` is included.
+    template <typename T = Value,
+              enable_if_t<is_fmt_numeric<T>::value && !std::is_same<T, bool>::value, int> = 0>
+    bool load_buffer(handle src) {
+        if (!PyObject_CheckBuffer(src.ptr())) {
+            return false;
+        }
+        auto *view = new Py_buffer();
+        if (PyObject_GetBuffer(src.ptr(), view, PyBUF_FORMAT | PyBUF_STRIDES) != 0) {
+            delete view;
+            PyErr_Clear();
+            return false;
+        }
+        buffer_info info(view);
+        if (info.ndim != 1 || !info.item_type_is_equivalent_to<T>()) {
+            return false;
+        }
+        const auto size = static_cast<size_t>(info.shape[0]);
+        const auto stride = info.strides[0];
+        const auto *data = static_cast<const char *>(info.ptr);
+        value.clear();
+        if (stride == static_cast<ssize_t>(sizeof(T))
+            && reinterpret_cast<std::uintptr_t>(data) % alignof(T) == 0) {
+            const auto *first = reinterpret_cast<const T *>(data);
+            value.assign(first, first + size);
+            return true;
+        }
+        reserve_maybe(size, &value);
+        for (size_t i = 0; i < size; ++i) {
+            T element;
+            std::memcpy(&element, data + static_cast<ssize_t>(i) * stride, sizeof(T));
+            value.push_back(element);
+        }
+        return true;
+    }
+    template <typename T = Value,
+              enable_if_t<!is_fmt_numeric<T>::value || std::is_same<T, bool>::value, int> = 0>
+    bool load_buffer(handle) {
+        return false;
+    }
+
     template <typename T = Type, enable_if_t<has_reserve_method<T>::value, int> = 0>
-    void reserve_maybe(const sequence &s, Type *) {
-        value.reserve(s.size());
+    void reserve_maybe(size_t size, Type *) {
+        value.reserve(size);
     }
-    void reserve_maybe(const sequence &, void *) {}
+    void reserve_maybe(size_t, void *) {}
 
 public:
     template <typename T>
@@ -195,17 +261,8 @@ public:
         if (!std::is_lvalue_reference<T>::value) {
             policy = return_value_policy_override<Value>::policy(policy);
         }
-        list l(src.size());
-        ssize_t index = 0;
-        for (auto &&value : src) {
-            auto value_ = reinterpret_steal<object>(
-                value_conv::cast(detail::forward_like<T>(value), policy, parent));
-            if (!value_) {
-                return handle();
-            }
-            PyList_SET_ITEM(l.ptr(), index++, value_.release().ptr()); // steals a reference
-        }
-        return l.release();
+        return cast_sequence<list, Value>(forwarding_begin<T>(src), src.size(), policy, parent)
+            .release();
     }
 
     PYBIND11_TYPE_CASTER(Type, const_name("List[") + value_conv::name + const_name("]"));
@@ -259,17 +316,8 @@ public:
 
     template <typename T>
     static handle cast(T &&src, return_value_policy policy, handle parent) {
-        list l(src.size());
-        ssize_t index = 0;
-        for (auto &&value : src) {
-            auto value_ = reinterpret_steal<object>(
-                value_conv::cast(detail::forward_like<T>(value), policy, parent));
-            if (!value_) {
-                return handle();
-            }
-            PyList_SET_ITEM(l.ptr(), index++, value_.release().ptr()); // steals a reference
-        }
-        return l.release();
+        return cast_sequence<list, Value>(forwarding_begin<T>(src), src.size(), policy, parent)
+            .release();
     }
 
     PYBIND11_TYPE_CASTER(ArrayType,
@@ -382,6 +430,60 @@ struct visit_helper {
     }
 };
 
+/// Remembers, for the exact Python types most recently loaded into one variant type, which
+/// alternative accepted them without conversions. Only class alternatives are recorded: whether
+/// their casters accept an object depends on its type alone, and they are the expensive ones to
+/// try. Entries are tied to the version tag of the Python type, so they can never apply to a
+/// modified type or to a new type allocated at the same address.
+class variant_dispatch_cache {
+public:
+    static constexpr size_t capacity = 8;
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    size_t find(PyTypeObject *type) const {
+#if defined(Py_GIL_DISABLED)
+        // Threads would race on the entries without the GIL
+        (void) type;
+        return npos;
+#else
+        // ... and so would subinterpreters with a GIL of their own
+        const unsigned int tag = in_main_interpreter() ? valid_version_tag(type) : 0;
+        if (tag != 0) {
+            for (const auto &e : m_entries) {
+                if (e.type == type && e.version_tag == tag) {
+                    return e.index;
+                }
+            }
+        }
+        return npos;
+#endif
+    }
+
+    void remember(PyTypeObject *type, size_t index) {
+#if defined(Py_GIL_DISABLED)
+        (void) type;
+        (void) index;
+#else
+        const unsigned int tag = in_main_interpreter() ? valid_version_tag(type) : 0;
+        if (tag != 0) {
+            m_entries[m_next] = {type, tag, index};
+            m_next = (m_next + 1) % capacity;
+        }
+#endif
+    }
+
+private:
+    // An aggregate, so that C++11 can brace-initialize it; `m_entries{}` zeroes them all.
+    struct entry {
+        PyTypeObject *type;
+        unsigned int version_tag;
+        size_t index;
+    };
+
+    std::array<entry, capacity> m_entries{};
+    size_t m_next = 0;
+};
+
 /// Generic variant caster
 template <typename Variant>
 struct variant_caster;
@@ -390,27 +492,52 @@ template <template <typename...> class V, typename... Ts>
 struct variant_caster<V<Ts...>> {
     static_assert(sizeof...(Ts) > 0, "Variant must consist of at least one alternative.");
 
-    template <typename U, typename... Us>
-    bool load_alternative(handle src, bool convert, type_list<U, Us...>) {
+    template <typename U>
+    bool load_alternative(handle src, bool convert) {
         auto caster = make_caster<U>();
         if (caster.load(src, convert)) {
             value = cast_op<U>(std::move(caster));
             return true;
         }
-        return load_alternative(src, convert, type_list<Us...>{});
+        return false;
     }
 
-    bool load_alternative(handle, bool, type_list<>) { return false; }
-
     bool load(handle src, bool convert) {
+        using loader = bool (variant_caster::*)(handle, bool);
+        static const loader loaders[] = {&variant_caster::load_alternative<Ts>...};
+        static const bool is_class[] = {uses_generic_load<make_caster<Ts>>::value...};
+        static variant_dispatch_cache cache;
+        constexpr size_t n = sizeof...(Ts);
+
+        // The class alternatives before the one that took this exact type last time rejected it
+        // then and will again, so they are skipped. The others still come first, since whether
+        // they accept an object can depend on its value.
+        auto *type = Py_TYPE(src.ptr());
+        const size_t hint = cache.find(type);
+
         // Do a first pass without conversions to improve constructor resolution.
         // E.g. `py::int_(1).cast<variant<double, int>>()` needs to fill the `int`
         // slot of the variant. Without two-pass loading `double` would be filled
         // because it appears first and a conversion is possible.
-        if (convert && load_alternative(src, false, type_list<Ts...>{})) {
-            return true;
+        for (size_t i = 0; i < n; ++i) {
+            if (hint != variant_dispatch_cache::npos && i < hint && is_class[i]) {
+                continue;
+            }
+            if ((this->*loaders[i])(src, false)) {
+                if (is_class[i] && i != hint) {
+                    cache.remember(type, i);
+                }
+                return true;
+            }
+        }
+        if (convert) {
+            for (size_t i = 0; i < n; ++i) {
+                if ((this->*loaders[i])(src, true)) {
+                    return true;
+                }
+            }
         }
-        return load_alternative(src, convert, type_list<Ts...>{});
+        return false;
     }
 
     template <typename Variant>
@@ -433,8 +560,136 @@ template <>
 struct type_caster<std::monostate> : public void_caster<std::monostate> {};
 #endif
 
+#if defined(PYBIND11_HAS_SPAN)
+/// Borrows the memory of any object that exports a one-dimensional, contiguous buffer with
+/// exactly the item type `T` (NumPy arrays, `array.array`, `memoryview`, also `bytes` for
+/// `std::span<const std::uint8_t>`), instead of copying it. The buffer is held until the bound
+/// function returns, through `loader_life_support`, so the span must not be kept beyond that.
+/// `std::span<T>` requires a writable buffer; read-only ones only load into `std::span<const T>`.
+/// Returning a span copies its elements into a `list`.
+template <typename T>
+struct type_caster<std::span<T>> {
+    using value_type = remove_cv_t<T>;
+    using value_conv = make_caster<value_type>;
+
+    bool load(handle src, bool) {
+        if (!PyObject_CheckBuffer(src.ptr())) {
+            return false;
+        }
+        // The memoryview owns the exported buffer and releases it when it is destroyed
+        auto view_obj = reinterpret_steal<object>(PyMemoryView_FromObject(src.ptr()));
+        if (!view_obj) {
+            PyErr_Clear();
+            return false;
+        }
+        Py_buffer *view = PyMemoryView_GET_BUFFER(view_obj.ptr());
+        if (view->ndim != 1 || (!std::is_const<T>::value && view->readonly)) {
+            return false;
+        }
+        const buffer_info info(view, /*ownview=*/false);
+        if (!info.item_type_is_equivalent_to<value_type>()) {
+            return false;
+        }
+        const auto size = static_cast<size_t>(info.shape[0]);
+        // Empty buffers may come with any pointer, e.g. a dummy unaligned one from `array.array`
+        if (size == 0) {
+            value = std::span<T>();
+            return true;
+        }
+        if ((size > 1 && info.strides[0] != info.itemsize)
+            || reinterpret_cast<std::uintptr_t>(info.ptr) % alignof(value_type) != 0) {
+            return false;
+        }
+        loader_life_support::add_patient(view_obj);
+        value = std::span<T>(static_cast<T *>(info.ptr), size);
+        return true;
+    }
+
+    template <typename Span>
+    static handle cast(Span &&src, return_value_policy policy, handle parent) {
+        list l(src.size());
+        ssize_t index = 0;
+        for (auto &&element : src) {
+            auto element_ = reinterpret_steal<object>(value_conv::cast(element, policy, parent));
+            if (!element_) {
+                return handle();
+            }
+            PyList_SET_ITEM(l.ptr(), index++, element_.release().ptr()); // steals a reference
+        }
+        return l.release();
+    }
+
+    PYBIND11_TYPE_CASTER(std::span<T>, const_name("Buffer"));
+};
+#endif
+
+#if defined(PYBIND11_HAS_EXPECTED)
+/// The Python exception type raised for errors of type `E` (see `register_expected_error`)
+template <typename E>
+handle &expected_error_type() {
+    static handle type;
+    return type;
+}
+
+/// Raises an error of a `std::expected` as the exception registered for its type, with the
+/// `what()` or `message()` of the error, or else the error converted to Python, as its value.
+template <typename E>
+void raise_expected_error(const E &e) {
+    object value;
+    if constexpr (std::is_base_of_v<std::exception, E>) {
+        value = str(e.what());
+    } else if constexpr (requires { std::string(e.message()); }) {
+        value = str(std::string(e.message()));
+    } else {
+        value = reinterpret_steal<object>(
+            make_caster<E>::cast(e, return_value_policy::copy, handle()));
+        if (!value) {
+            return;
+        }
+    }
+    handle type = expected_error_type<E>();
+    error(type ? type : handle(PyExc_RuntimeError), std::move(value)).restore();
+}
+
+/// Returns the value of a `std::expected`, or raises its error without throwing a C++ exception,
+/// like `py::result<T>`.
+template <typename T, typename E>
+struct type_caster<std::expected<T, E>> {
+    using value_conv = make_caster<conditional_t<std::is_void_v<T>, void_type, T>>;
+    static constexpr auto name = value_conv::name;
+
+    template <typename Expected>
+    static handle cast(Expected &&src, return_value_policy policy, handle parent) {
+        if (!src.has_value()) {
+            raise_expected_error(src.error());
+            return handle();
+        }
+        if constexpr (std::is_void_v<T>) {
+            return none().release();
+        } else {
+            return value_conv::cast(*std::forward<Expected>(src),
+                                    return_value_policy_override<T>::policy(policy),
+                                    parent);
+        }
+    }
+};
+
+template <typename T, typename E>
+struct casts_to_error<type_caster<std::expected<T, E>>> : std::true_type {};
+#endif
+
 PYBIND11_NAMESPACE_END(detail)
 
+#if defined(PYBIND11_HAS_EXPECTED)
+/// Registers the Python exception type raised for the errors of type `E` that bound functions
+/// return in a `std::expected<T, E>`, instead of `RuntimeError`. Like other registrations of
+/// exception translators, this is local to the extension module.
+template <typename E>
+void register_expected_error(handle type) {
+    detail::expected_error_type<E>() = type.inc_ref();
+}
+#endif
+
 inline std::ostream &operator<<(std::ostream &os, const handle &obj) {
 #ifdef PYBIND11_HAS_STRING_VIEW
     os << str(obj).cast<std::string_view>();
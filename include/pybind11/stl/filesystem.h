@@ -10,6 +10,8 @@
 #include "../cast.h"
 #include "../pytypes.h"
 
+#include <cstring>
+#include <cwchar>
 #include <string>
 
 #ifdef __has_include
@@ -52,21 +54,89 @@ private:
         return PyUnicode_FromWideChar(w.c_str(), ssize_t(w.size()));
     }
 
-public:
-    static handle cast(const T &path, return_value_policy, handle) {
-        if (auto py_str = unicode_from_fs_native(path.native())) {
-            return module_::import("pathlib")
-                .attr("Path")(reinterpret_steal<object>(py_str))
-                .release();
+    // The type and the encoding are cached as long as the interpreter lives, in plain statics
+    // without a guard: the imports may release the GIL, and must not run while other threads
+    // could be blocked on a static initializer.
+
+    /// `pathlib.Path`, imported on first use in each interpreter
+    static object path_type() {
+        static PyObject *cached = nullptr;
+        static size_t cached_generation = 0;
+        const size_t generation = interpreter_lifetime::get().current();
+        if (generation != 0 && generation == cached_generation) {
+            return reinterpret_borrow<object>(cached);
         }
-        return nullptr;
+        object type = module_::import("pathlib").attr("Path");
+        if (generation != 0) {
+            // Not released: the type of an earlier generation may have been freed with its
+            // interpreter
+            cached = type.inc_ref().ptr();
+            cached_generation = generation;
+        }
+        return type;
     }
 
-    bool load(handle handle, bool) {
+    /// Whether the file system encoding is UTF-8, so that `str` objects can be converted with
+    /// their cached UTF-8 representation instead of encoding them to `bytes` first
+    static bool fs_encoding_is_utf8() {
+        static bool cached = false;
+        static size_t cached_generation = 0;
+        const size_t generation = interpreter_lifetime::get().current();
+        if (generation != 0 && generation == cached_generation) {
+            return cached;
+        }
+        const bool result
+            = module_::import("sys").attr("getfilesystemencoding")().cast<std::string>()
+              == "utf-8";
+        if (generation != 0) {
+            cached = result;
+            cached_generation = generation;
+        }
+        return result;
+    }
+
+    // Fast path for exact `str` objects. Returns false, without an error set, for strings it
+    // can not convert directly (with lone surrogates or null characters, or with a file system
+    // encoding other than UTF-8), which are then converted by `load_fspath()`.
+    static bool load_str(handle src, T &path) {
+        if constexpr (std::is_same_v<typename T::value_type, char>) {
+            if (!fs_encoding_is_utf8()) {
+                return false;
+            }
+            ssize_t size = 0;
+            const char *data = PyUnicode_AsUTF8AndSize(src.ptr(), &size);
+            if (data == nullptr) {
+                PyErr_Clear();
+                return false;
+            }
+            if (std::memchr(data, '\0', static_cast<size_t>(size)) != nullptr) {
+                return false;
+            }
+            path = std::string(data, static_cast<size_t>(size));
+            return true;
+        } else if constexpr (std::is_same_v<typename T::value_type, wchar_t>) {
+            ssize_t size = 0;
+            wchar_t *data = PyUnicode_AsWideCharString(src.ptr(), &size);
+            if (data == nullptr) {
+                PyErr_Clear();
+                return false;
+            }
+            const bool ok = std::wcslen(data) == static_cast<size_t>(size);
+            if (ok) {
+                path = std::wstring(data, static_cast<size_t>(size));
+            }
+            PyMem_Free(data);
+            return ok;
+        } else {
+            return false;
+        }
+    }
+
+    static bool load_fspath(handle src, T &path) {
         // PyUnicode_FSConverter and PyUnicode_FSDecoder normally take care of
         // calling PyOS_FSPath themselves, but that's broken on PyPy (PyPy
         // issue #3168) so we do it ourselves instead.
-        PyObject *buf = PyOS_FSPath(handle.ptr());
+        PyObject *buf = PyOS_FSPath(src.ptr());
         if (!buf) {
             PyErr_Clear();
             return false;
@@ -77,14 +147,14 @@ public:
                 if (auto *c_str = PyBytes_AsString(native)) {
                     // AsString returns a pointer to the internal buffer, which
                     // must not be free'd.
-                    value = c_str;
+                    path = c_str;
                 }
             }
         } else if constexpr (std::is_same_v<typename T::value_type, wchar_t>) {
             if (PyUnicode_FSDecoder(buf, &native) != 0) {
                 if (auto *c_str = PyUnicode_AsWideCharString(native, nullptr)) {
                     // AsWideCharString returns a new string that must be free'd.
-                    value = c_str; // Copies the string.
+                    path = c_str; // Copies the string.
                     PyMem_Free(c_str);
                 }
             }
@@ -98,6 +168,23 @@ public:
         return true;
     }
 
+public:
+    static handle cast(const T &path, return_value_policy, handle) {
+        if (auto py_str = reinterpret_steal<object>(unicode_from_fs_native(path.native()))) {
+            return PyObject_CallFunctionObjArgs(path_type().ptr(), py_str.ptr(), nullptr);
+        }
+        return nullptr;
+    }
+
+    bool load(handle src, bool) {
+        // `str` is by far the most common argument, and is converted without creating `bytes`
+        // (also for every element of a `std::vector<std::filesystem::path>`)
+        if (PyUnicode_CheckExact(src.ptr()) && load_str(src, value)) {
+            return true;
+        }
+        return load_fspath(src, value);
+    }
+
     PYBIND11_TYPE_CASTER(T, const_name("os.PathLike"));
 };
 
@@ -0,0 +1,274 @@
+/*
+    pybind11/stl/staged.h: Conversion of nested STL containers in two phases, the second of which
+    does not need the GIL
+
+    Copyright (c) 2024 The pybind Community.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE file.
+*/
+
+#pragma once
+
+#include "../stl.h"
+
+#include <cstring>
+#include <deque>
+#include <list>
+#include <map>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+PYBIND11_NAMESPACE_BEGIN(PYBIND11_NAMESPACE)
+
+/** \rst
+    An argument of type ``T`` (nested ``std::vector``, ``std::deque``, ``std::list``,
+    ``std::map``, ``std::unordered_map``, ``std::pair`` and ``std::tuple`` of numbers and
+    strings) that is converted in two phases: when the arguments are loaded, the numbers and
+    strings are only copied out of the Python objects into a flat buffer, and the C++ containers
+    are built from that buffer when the function is called. With
+    ``py::call_guard<py::gil_scoped_release>()``, the second phase, with all its allocations, runs
+    without the GIL.
+\endrst */
+template <typename T>
+class staged {
+public:
+    staged() = default;
+    explicit staged(T value) : value_(std::move(value)) {}
+
+    T &get() { return value_; }
+    const T &get() const { return value_; }
+    T &operator*() { return value_; }
+    const T &operator*() const { return value_; }
+    T *operator->() { return &value_; }
+    const T *operator->() const { return &value_; }
+
+private:
+    T value_;
+};
+
+PYBIND11_NAMESPACE_BEGIN(detail)
+
+/// The flat buffer of a staged argument: values are appended as raw bytes, sizes of containers
+/// and strings before their contents
+class staging_buffer {
+public:
+    template <typename T>
+    void put(const T &value) {
+        put_bytes(&value, sizeof(T));
+    }
+    void put_bytes(const void *data, size_t size) {
+        const auto *first = static_cast<const unsigned char *>(data);
+        bytes.insert(bytes.end(), first, first + size);
+    }
+    void clear() { bytes.clear(); }
+    const unsigned char *data() const { return bytes.data(); }
+
+private:
+    std::vector<unsigned char> bytes;
+};
+
+/// Reads the values of a `staging_buffer` back in the order they were put
+class staging_reader {
+public:
+    explicit staging_reader(const unsigned char *pos) : pos(pos) {}
+
+    template <typename T>
+    T take() {
+        T value;
+        std::memcpy(&value, pos, sizeof(T));
+        pos += sizeof(T);
+        return value;
+    }
+    const char *take_bytes(size_t size) {
+        const auto *first = reinterpret_cast<const char *>(pos);
+        pos += size;
+        return first;
+    }
+
+private:
+    const unsigned char *pos;
+};
+
+/// Copies a value of type `T` out of a Python object (`extract`, with the GIL) and builds it from
+/// the copy (`build`, without touching any Python object)
+template <typename T, typename SFINAE = void>
+struct stager {
+    static_assert(!std::is_same<T, T>::value,
+                  "py::staged<T> only supports nested std::vector, std::deque, std::list, "
+                  "std::map, std::unordered_map, std::pair and std::tuple of numbers and strings");
+};
+
+template <typename T>
+struct stager<T, enable_if_t<std::is_arithmetic<T>::value>> {
+    static bool extract(handle src, bool convert, staging_buffer &buf) {
+        make_caster<T> conv;
+        if (!conv.load(src, convert)) {
+            return false;
+        }
+        buf.put(cast_op<T>(conv));
+        return true;
+    }
+    static T build(staging_reader &reader) { return reader.take<T>(); }
+};
+
+template <typename CharT, typename Traits, typename Alloc>
+struct stager<std::basic_string<CharT, Traits, Alloc>> {
+    using type = std::basic_string<CharT, Traits, Alloc>;
+
+    static bool extract(handle src, bool convert, staging_buffer &buf) {
+        make_caster<type> conv;
+        if (!conv.load(src, convert)) {
+            return false;
+        }
+        const type &str = cast_op<const type &>(conv);
+        buf.put(str.size());
+        buf.put_bytes(str.data(), str.size() * sizeof(CharT));
+        return true;
+    }
+    static type build(staging_reader &reader) {
+        const auto size = reader.take<size_t>();
+        const char *chars = reader.take_bytes(size * sizeof(CharT));
+        type str(size, CharT());
+        if (size != 0) {
+            std::memcpy(&str[0], chars, size * sizeof(CharT));
+        }
+        return str;
+    }
+};
+
+template <typename Type, typename Value>
+struct sequence_stager {
+    static bool extract(handle src, bool convert, staging_buffer &buf) {
+        if (!isinstance<sequence>(src) || isinstance<bytes>(src) || isinstance<str>(src)) {
+            return false;
+        }
+        auto s = reinterpret_borrow<sequence>(src);
+        buf.put(s.size());
+        for (auto it : s) {
+            if (!stager<Value>::extract(it, convert, buf)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    static Type build(staging_reader &reader) {
+        const auto size = reader.take<size_t>();
+        Type result;
+        reserve_maybe(result, size, &result);
+        for (size_t i = 0; i < size; ++i) {
+            result.push_back(stager<Value>::build(reader));
+        }
+        return result;
+    }
+
+private:
+    template <typename T = Type, enable_if_t<has_reserve_method<T>::value, int> = 0>
+    static void reserve_maybe(Type &result, size_t size, Type *) {
+        result.reserve(size);
+    }
+    static void reserve_maybe(Type &, size_t, void *) {}
+};
+
+template <typename Type, typename Key, typename Value>
+struct map_stager {
+    static bool extract(handle src, bool convert, staging_buffer &buf) {
+        if (!isinstance<dict>(src)) {
+            return false;
+        }
+        auto d = reinterpret_borrow<dict>(src);
+        buf.put(d.size());
+        for (auto it : d) {
+            if (!stager<Key>::extract(it.first, convert, buf)
+                || !stager<Value>::extract(it.second, convert, buf)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    static Type build(staging_reader &reader) {
+        const auto size = reader.take<size_t>();
+        Type result;
+        for (size_t i = 0; i < size; ++i) {
+            // Two statements, so that the key is read before the value
+            auto key = stager<Key>::build(reader);
+            result.emplace(std::move(key), stager<Value>::build(reader));
+        }
+        return result;
+    }
+};
+
+template <typename Type, typename... Ts>
+struct tuple_stager {
+    static bool extract(handle src, bool convert, staging_buffer &buf) {
+        if (!isinstance<sequence>(src) || isinstance<str>(src)) {
+            return false;
+        }
+        auto s = reinterpret_borrow<sequence>(src);
+        return s.size() == sizeof...(Ts)
+               && extract_impl(s, convert, buf, make_index_sequence<sizeof...(Ts)>{});
+    }
+    static Type build(staging_reader &reader) {
+        // The elements of a braced initializer list are evaluated in order
+        return Type{stager<Ts>::build(reader)...};
+    }
+
+private:
+    template <size_t... Is>
+    static bool
+    extract_impl(const sequence &s, bool convert, staging_buffer &buf, index_sequence<Is...>) {
+        bool ok = true;
+        PYBIND11_EXPAND_SIDE_EFFECTS(ok = ok && stager<Ts>::extract(s[Is], convert, buf));
+        return ok;
+    }
+};
+
+template <typename T, typename Alloc>
+struct stager<std::vector<T, Alloc>> : sequence_stager<std::vector<T, Alloc>, T> {};
+template <typename T, typename Alloc>
+struct stager<std::deque<T, Alloc>> : sequence_stager<std::deque<T, Alloc>, T> {};
+template <typename T, typename Alloc>
+struct stager<std::list<T, Alloc>> : sequence_stager<std::list<T, Alloc>, T> {};
+template <typename Key, typename Value, typename Compare, typename Alloc>
+struct stager<std::map<Key, Value, Compare, Alloc>>
+    : map_stager<std::map<Key, Value, Compare, Alloc>, Key, Value> {};
+template <typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+struct stager<std::unordered_map<Key, Value, Hash, Equal, Alloc>>
+    : map_stager<std::unordered_map<Key, Value, Hash, Equal, Alloc>, Key, Value> {};
+template <typename T1, typename T2>
+struct stager<std::pair<T1, T2>> : tuple_stager<std::pair<T1, T2>, T1, T2> {};
+template <typename... Ts>
+struct stager<std::tuple<Ts...>> : tuple_stager<std::tuple<Ts...>, Ts...> {};
+
+template <typename T>
+class type_caster<staged<T>> {
+public:
+    bool load(handle src, bool convert) {
+        buffer.clear();
+        return stager<T>::extract(src, convert, buffer);
+    }
+
+    static handle cast(const staged<T> &src, return_value_policy policy, handle parent) {
+        return make_caster<T>::cast(*src, policy, parent);
+    }
+
+    template <typename>
+    using cast_op_type = staged<T>;
+
+    // NOLINTNEXTLINE(google-explicit-constructor)
+    operator staged<T>() const {
+        staging_reader reader(buffer.data());
+        return staged<T>(stager<T>::build(reader));
+    }
+
+    static constexpr auto name = make_caster<T>::name;
+
+private:
+    staging_buffer buffer;
+};
+
+PYBIND11_NAMESPACE_END(detail)
+PYBIND11_NAMESPACE_END(PYBIND11_NAMESPACE)
@@ -15,12 +15,22 @@
 #include "operators.h"
 
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <sstream>
 #include <type_traits>
 
 PYBIND11_NAMESPACE_BEGIN(PYBIND11_NAMESPACE)
+
+/// Annotation for `bind_vector`: slicing returns a view that refers to the elements of the vector,
+/// instead of a new vector with copies of them
+struct slice_view {};
+
 PYBIND11_NAMESPACE_BEGIN(detail)
 
+template <>
+struct process_attribute<slice_view> : process_attribute_default<slice_view> {};
+
 /* SFINAE helper class used by 'is_comparable */
 template <typename T>
 struct container_traits {
@@ -123,12 +133,111 @@ void vector_if_equal_operator(enable_if_t<is_comparable<Vector>::value, Class_>
         "Return true the container contains ``x``");
 }
 
+// Provide the buffer interface for vectors if we have data() and we have a format for it
+// GCC seems to have "void std::vector<bool>::data()" - doing SFINAE on the existence of data()
+// is insufficient, we need to check it returns an appropriate pointer
+template <typename Vector, typename = void>
+struct vector_has_data_and_format : std::false_type {};
+template <typename Vector>
+struct vector_has_data_and_format<
+    Vector,
+    enable_if_t<std::is_same<decltype(format_descriptor<typename Vector::value_type>::format(),
+                                      std::declval<Vector>().data()),
+                             typename Vector::value_type *>::value>> : std::true_type {};
+
+// Vectors of plain numbers, or of other trivially copyable types that have been bound with
+// `py::buffer_protocol()` (so that their format is known), can be filled straight from a
+// one-dimensional buffer with the same item type instead of element by element.
+template <typename Vector>
+using vector_bulk_copyable
+    = all_of<vector_has_data_and_format<Vector>,
+             std::is_trivially_copyable<typename Vector::value_type>,
+             std::is_default_constructible<typename Vector::value_type>,
+             negation<std::is_same<typename Vector::value_type, bool>>>;
+
+// Appends the contents of `src` to `v` if it is a matching buffer, otherwise returns false
+// without modifying `v`. `any_format` allows item types other than numbers.
+template <typename Vector, enable_if_t<vector_bulk_copyable<Vector>::value, int> = 0>
+bool vector_append_from_buffer(Vector &v, handle src, bool any_format) {
+    using T = typename Vector::value_type;
+    if ((!std::is_arithmetic<T>::value && !any_format) || !PyObject_CheckBuffer(src.ptr())) {
+        return false;
+    }
+    auto *view = new Py_buffer();
+    if (PyObject_GetBuffer(src.ptr(), view, PyBUF_FORMAT | PyBUF_STRIDES) != 0) {
+        delete view;
+        PyErr_Clear();
+        return false;
+    }
+    buffer_info info(view);
+    if (info.ndim != 1 || !info.template item_type_is_equivalent_to<T>()) {
+        return false;
+    }
+    const auto size = static_cast<size_t>(info.shape[0]);
+    if (size == 0) {
+        return true;
+    }
+    const auto stride = info.strides[0];
+    const auto *data = static_cast<const char *>(info.ptr);
+    // The buffer can be the memory of `v` itself (e.g. `v.extend(memoryview(v))`), which is
+    // invalidated as `v` grows, so copy it out first
+    const auto first_item = reinterpret_cast<std::uintptr_t>(data);
+    const auto last_item
+        = reinterpret_cast<std::uintptr_t>(data + static_cast<ssize_t>(size - 1) * stride);
+    const auto storage = reinterpret_cast<std::uintptr_t>(v.data());
+    if ((std::min)(first_item, last_item) < storage + v.capacity() * sizeof(T)
+        && storage < (std::max)(first_item, last_item) + sizeof(T)) {
+        Vector copy;
+        vector_append_from_buffer(copy, src, any_format);
+        v.insert(v.end(), copy.begin(), copy.end());
+        return true;
+    }
+    if (stride == static_cast<ssize_t>(sizeof(T))
+        && reinterpret_cast<std::uintptr_t>(data) % alignof(T) == 0) {
+        const auto *first = reinterpret_cast<const T *>(data);
+        v.insert(v.end(), first, first + size);
+        return true;
+    }
+    const size_t old_size = v.size();
+    v.resize(old_size + size);
+    for (size_t i = 0; i < size; ++i) {
+        std::memcpy(v.data() + old_size + i, data + static_cast<ssize_t>(i) * stride, sizeof(T));
+    }
+    return true;
+}
+template <typename Vector, enable_if_t<!vector_bulk_copyable<Vector>::value, int> = 0>
+bool vector_append_from_buffer(Vector &, handle, bool) {
+    return false;
+}
+
+template <typename Vector, typename Class_>
+void vector_if_bulk_copyable(enable_if_t<vector_bulk_copyable<Vector>::value, Class_> &cl,
+                             bool any_format) {
+    cl.def(
+        "assign_from_buffer",
+        [any_format](Vector &v, const buffer &b) {
+            Vector contents;
+            if (!vector_append_from_buffer(contents, b, any_format)) {
+                throw type_error("Only 1D buffers with a matching format can be copied to a "
+                                 "vector");
+            }
+            v.swap(contents);
+        },
+        arg("b"),
+        "Replace the contents of the list with those of a 1D buffer of the same item type");
+}
+template <typename Vector, typename Class_>
+void vector_if_bulk_copyable(enable_if_t<!vector_bulk_copyable<Vector>::value, Class_> &,
+                             bool) {}
+
 // Vector modifiers -- requires a copyable vector_type:
 // (Technically, some of these (pop and __delitem__) don't actually require copyability, but it
 // seems silly to allow deletion but not insertion, so include them here too.)
 template <typename Vector, typename Class_>
 void vector_modifiers(
-    enable_if_t<is_copy_constructible<typename Vector::value_type>::value, Class_> &cl) {
+    enable_if_t<is_copy_constructible<typename Vector::value_type>::value, Class_> &cl,
+    bool any_format,
+    bool slice_views) {
     using T = typename Vector::value_type;
     using SizeType = typename Vector::size_type;
     using DiffType = typename Vector::difference_type;
@@ -149,8 +258,11 @@ void vector_modifiers(
         arg("x"),
         "Add an item to the end of the list");
 
-    cl.def(init([](const iterable &it) {
+    cl.def(init([any_format](const iterable &it) {
         auto v = std::unique_ptr<Vector>(new Vector());
+        if (vector_append_from_buffer(*v, it, any_format)) {
+            return v.release();
+        }
         v->reserve(len_hint(it));
         for (handle h : it) {
             v->push_back(h.cast<T>());
@@ -169,7 +281,10 @@ void vector_modifiers(
 
     cl.def(
         "extend",
-        [](Vector &v, const iterable &it) {
+        [any_format](Vector &v, const iterable &it) {
+            if (vector_append_from_buffer(v, it, any_format)) {
+                return;
+            }
             const size_t old_size = v.size();
             v.reserve(old_size + len_hint(it));
             try {
@@ -190,6 +305,8 @@ void vector_modifiers(
         arg("L"),
         "Extend the list by appending all the items in the given list");
 
+    vector_if_bulk_copyable<Vector, Class_>(cl, any_format);
+
     cl.def(
         "insert",
         [](Vector &v, DiffType i, const T &x) {
@@ -235,26 +352,28 @@ void vector_modifiers(
     });
 
     /// Slicing protocol
-    cl.def(
-        "__getitem__",
-        [](const Vector &v, const slice &slice) -> Vector * {
-            size_t start = 0, stop = 0, step = 0, slicelength = 0;
-
-            if (!slice.compute(v.size(), &start, &stop, &step, &slicelength)) {
-                throw error_already_set();
-            }
+    if (!slice_views) {
+        cl.def(
+            "__getitem__",
+            [](const Vector &v, const slice &slice) -> Vector * {
+                size_t start = 0, stop = 0, step = 0, slicelength = 0;
+
+                if (!slice.compute(v.size(), &start, &stop, &step, &slicelength)) {
+                    throw error_already_set();
+                }
 
-            auto *seq = new Vector();
-            seq->reserve((size_t) slicelength);
+                auto *seq = new Vector();
+                seq->reserve((size_t) slicelength);
 
-            for (size_t i = 0; i < slicelength; ++i) {
-                seq->push_back(v[start]);
-                start += step;
-            }
-            return seq;
-        },
-        arg("s"),
-        "Retrieve list elements using a slice object");
+                for (size_t i = 0; i < slicelength; ++i) {
+                    seq->push_back(v[start]);
+                    start += step;
+                }
+                return seq;
+            },
+            arg("s"),
+            "Retrieve list elements using a slice object");
+    }
 
     cl.def(
         "__setitem__",
@@ -402,18 +521,6 @@ auto vector_if_insertion_operator(Class_ &cl, std::string const &name)
         "Return the canonical string representation of this list.");
 }
 
-// Provide the buffer interface for vectors if we have data() and we have a format for it
-// GCC seems to have "void std::vector<bool>::data()" - doing SFINAE on the existence of data()
-// is insufficient, we need to check it returns an appropriate pointer
-template <typename Vector, typename = void>
-struct vector_has_data_and_format : std::false_type {};
-template <typename Vector>
-struct vector_has_data_and_format<
-    Vector,
-    enable_if_t<std::is_same<decltype(format_descriptor<typename Vector::value_type>::format(),
-                                      std::declval<Vector>().data()),
-                             typename Vector::value_type *>::value>> : std::true_type {};
-
 // [workaround(intel)] Separate function required here
 // Workaround as the Intel compiler does not compile the enable_if_t part below
 // (tested with icc (ICC) 2021.1 Beta 20200827)
@@ -483,6 +590,123 @@ void vector_buffer(Class_ &cl) {
         cl, detail::any_of<std::is_same<Args, buffer_protocol>...>{});
 }
 
+/// The elements `start`, `start + step`, ... of a bound vector, as returned by slicing it when
+/// it is bound with `py::slice_view()`. Positions are checked against the current size of the
+/// vector on every access, since it may have shrunk since the view was created.
+template <typename Vector>
+struct vector_slice {
+    using SizeType = typename Vector::size_type;
+
+    Vector *vector;
+    ssize_t start;
+    ssize_t step;
+    ssize_t length;
+
+    SizeType position(ssize_t i) const {
+        if (i < 0) {
+            i += length;
+        }
+        if (i < 0 || i >= length) {
+            throw index_error();
+        }
+        const ssize_t pos = start + i * step;
+        if (pos < 0 || static_cast<SizeType>(pos) >= vector->size()) {
+            throw index_error("the vector no longer contains all elements of the slice");
+        }
+        return static_cast<SizeType>(pos);
+    }
+
+    vector_slice subslice(const slice &slice) const {
+        ssize_t sub_start = 0, sub_stop = 0, sub_step = 0, sub_length = 0;
+        if (!slice.compute(length, &sub_start, &sub_stop, &sub_step, &sub_length)) {
+            throw error_already_set();
+        }
+        return {vector, start + sub_start * step, step * sub_step, sub_length};
+    }
+};
+
+template <typename Vector, typename Class_>
+void vector_slice_assignment(
+    enable_if_t<is_copy_assignable<typename Vector::value_type>::value, Class_> &cl) {
+    using T = typename Vector::value_type;
+    cl.def("__setitem__", [](const vector_slice<Vector> &s, ssize_t i, const T &value) {
+        (*s.vector)[s.position(i)] = value;
+    });
+}
+template <typename Vector, typename Class_>
+void vector_slice_assignment(
+    enable_if_t<!is_copy_assignable<typename Vector::value_type>::value, Class_> &) {}
+
+// With `py::buffer_protocol()`, slice views expose their elements as a strided buffer
+template <typename Vector>
+class_<vector_slice<Vector>>
+vector_slice_class(handle scope, const std::string &name, bool local, std::true_type) {
+    using View = vector_slice<Vector>;
+    using T = typename Vector::value_type;
+    class_<View> cl(scope, name.c_str(), pybind11::module_local(local), buffer_protocol());
+    cl.def_buffer([](View &s) -> buffer_info {
+        T *first = s.vector->data();
+        if (s.length > 0) {
+            // Both ends have to be within the vector, the elements in between then are as well
+            const ssize_t last = s.start + (s.length - 1) * s.step;
+            const auto size = static_cast<ssize_t>(s.vector->size());
+            if (s.start >= size || last >= size || last < 0) {
+                throw buffer_error("the vector no longer contains all elements of the slice");
+            }
+            first += s.start;
+        }
+        return buffer_info(first,
+                           static_cast<ssize_t>(sizeof(T)),
+                           format_descriptor<T>::format(),
+                           1,
+                           {s.length},
+                           {s.step * static_cast<ssize_t>(sizeof(T))});
+    });
+    return cl;
+}
+template <typename Vector>
+class_<vector_slice<Vector>>
+vector_slice_class(handle scope, const std::string &name, bool local, std::false_type) {
+    return class_<vector_slice<Vector>>(scope, name.c_str(), pybind11::module_local(local));
+}
+
+template <typename Vector, typename Class_, typename... Args>
+void vector_slice_view_impl(
+    Class_ &cl, handle scope, const std::string &name, bool local, std::true_type) {
+    using View = vector_slice<Vector>;
+    using T = typename Vector::value_type;
+    using Reference = conditional_t<vector_needs_copy<Vector>::value, T, T &>;
+
+    if (!detail::get_type_info(typeid(View))) {
+        using Buffer = any_of<std::is_same<Args, buffer_protocol>...>;
+        auto view_cl
+            = vector_slice_class<Vector>(scope, "SliceView[" + name + "]", local, Buffer{});
+        view_cl.def("__len__", [](const View &s) { return s.length; });
+        view_cl.def(
+            "__getitem__",
+            [](const View &s, ssize_t i) -> Reference { return (*s.vector)[s.position(i)]; },
+            return_value_policy::reference_internal);
+        view_cl.def(
+            "__getitem__",
+            [](const View &s, const slice &slice) { return s.subslice(slice); },
+            arg("s"),
+            keep_alive<0, 1>() /* Essential: keep the vector alive while the view exists */
+        );
+        vector_slice_assignment<Vector, class_<View>>(view_cl);
+    }
+
+    cl.def(
+        "__getitem__",
+        [](Vector &v, const slice &slice) {
+            return View{&v, 0, 1, static_cast<ssize_t>(v.size())}.subslice(slice);
+        },
+        arg("s"),
+        keep_alive<0, 1>(), /* Essential: keep the vector alive while the view exists */
+        "Return a view of the list elements selected by a slice object");
+}
+template <typename Vector, typename Class_, typename... Args>
+void vector_slice_view_impl(Class_ &, handle, const std::string &, bool, std::false_type) {}
+
 PYBIND11_NAMESPACE_END(detail)
 
 //
@@ -514,8 +738,13 @@ class_<Vector, holder_type> bind_vector(handle scope, std::string const &name, A
     // Register stream insertion operator (if possible)
     detail::vector_if_insertion_operator<Vector, Class_>(cl, name);
 
+    // Slicing returns views if a slice_view() is passed in, otherwise copies
+    using slice_views = detail::any_of<std::is_same<Args, slice_view>...>;
+    detail::vector_slice_view_impl<Vector, Class_, Args...>(cl, scope, name, local, slice_views{});
+
     // Modifiers require copyable vector value type
-    detail::vector_modifiers<Vector, Class_>(cl);
+    detail::vector_modifiers<Vector, Class_>(
+        cl, detail::args_any_are_buffer<Args...>(), slice_views::value);
 
     // Accessor and iterator; return by value if copyable, otherwise we return by ref + keep-alive
     detail::vector_accessor<Vector, Class_>(cl);
@@ -645,6 +874,62 @@ auto map_if_insertion_operator(Class_ &cl, std::string const &name)
         "Return the canonical string representation of this map.");
 }
 
+// Numbers that `memoryview.cast()` accepts the format of
+template <typename T>
+using is_memoryview_number
+    = bool_constant<std::is_arithmetic<T>::value && !std::is_same<T, long double>::value>;
+
+// Copies the numbers selected by `get` from all items of `m` into a new `bytearray`, and returns
+// a memoryview of it with their native format, which `numpy.asarray()` can wrap without copying.
+template <typename T, typename Map, typename Get>
+object map_numbers_to_memoryview(const Map &m, Get get) {
+    auto bytes = reinterpret_steal<object>(
+        PyByteArray_FromStringAndSize(nullptr, static_cast<ssize_t>(m.size() * sizeof(T))));
+    if (!bytes) {
+        throw error_already_set();
+    }
+    char *out = PyByteArray_AS_STRING(bytes.ptr());
+    for (const auto &kv : m) {
+        const T number = get(kv);
+        std::memcpy(out, &number, sizeof(T));
+        out += sizeof(T);
+    }
+    return memoryview(bytes).attr("cast")(format_descriptor<T>::format());
+}
+
+template <typename Map, typename Class_>
+void map_if_number_keys(
+    enable_if_t<is_memoryview_number<typename Map::key_type>::value, Class_> &cl) {
+    using KeyType = typename Map::key_type;
+    cl.def(
+        "keys_array",
+        [](const Map &m) {
+            return map_numbers_to_memoryview<KeyType>(
+                m, [](const typename Map::value_type &kv) { return kv.first; });
+        },
+        "Return a copy of all keys as a memoryview, in the order of iteration");
+}
+template <typename Map, typename Class_>
+void map_if_number_keys(
+    enable_if_t<!is_memoryview_number<typename Map::key_type>::value, Class_> &) {}
+
+template <typename Map, typename Class_>
+void map_if_number_values(
+    enable_if_t<is_memoryview_number<remove_cv_t<typename Map::mapped_type>>::value, Class_> &cl) {
+    using MappedType = remove_cv_t<typename Map::mapped_type>;
+    cl.def(
+        "values_array",
+        [](const Map &m) {
+            return map_numbers_to_memoryview<MappedType>(
+                m, [](const typename Map::value_type &kv) { return kv.second; });
+        },
+        "Return a copy of all values as a memoryview, in the order of iteration");
+}
+template <typename Map, typename Class_>
+void map_if_number_values(
+    enable_if_t<!is_memoryview_number<remove_cv_t<typename Map::mapped_type>>::value, Class_> &) {
+}
+
 template <typename KeyType>
 struct keys_view {
     virtual size_t len() = 0;
@@ -845,7 +1130,194 @@ class_<Map, holder_type> bind_map(handle scope, const std::string &name, Args &&
 
     cl.def("__len__", &Map::size);
 
+    // Bulk export, converting all items in one go rather than one `__next__` call at a time
+    cl.def(
+        "to_dict",
+        [](handle self) {
+            const auto &m = self.cast<const Map &>();
+#if !defined(PYPY_VERSION) && PY_VERSION_HEX < 0x030D0000
+            // Sized for all items up front, so that it is not resized while being filled
+            auto d = reinterpret_steal<dict>(_PyDict_NewPresized(static_cast<ssize_t>(m.size())));
+            if (!d) {
+                throw error_already_set();
+            }
+#else
+            dict d;
+#endif
+            for (const auto &kv : m) {
+                // Like `__getitem__`, values are references into the map
+                auto key = reinterpret_steal<object>(detail::make_caster<KeyType>::cast(
+                    kv.first, return_value_policy::reference_internal, self));
+                auto value = reinterpret_steal<object>(detail::make_caster<MappedType>::cast(
+                    kv.second, return_value_policy::reference_internal, self));
+                if (!key || !value || PyDict_SetItem(d.ptr(), key.ptr(), value.ptr()) != 0) {
+                    throw error_already_set();
+                }
+            }
+            return d;
+        },
+        "Return a dict with all items of the map");
+    detail::map_if_number_keys<Map, Class_>(cl);
+    detail::map_if_number_values<Map, Class_>(cl);
+
     return cl;
 }
 
+//
+// Read-only views
+//
+
+PYBIND11_NAMESPACE_BEGIN(detail)
+
+/* As for `iterator_state`, the policy is a template argument only because each combination
+ * needs its own py::class_ registration.
+ */
+template <typename Sequence, return_value_policy Policy>
+struct sequence_view_state {
+    const Sequence *sequence;
+};
+
+template <typename Map, return_value_policy Policy>
+struct mapping_view_state {
+    const Map *map;
+};
+
+PYBIND11_NAMESPACE_END(detail)
+
+/// Makes a read-only Python sequence that refers to `seq` instead of copying it into a `list`:
+/// elements are only converted when they are accessed. If given, `parent` (usually the instance
+/// owning `seq`) is kept alive for as long as the view exists; this also works in property
+/// getters, where `py::keep_alive<0, 1>()` cannot be applied.
+template <return_value_policy Policy = return_value_policy::reference_internal, typename Sequence>
+object make_sequence_view(const Sequence &seq, handle parent = handle()) {
+    using state = detail::sequence_view_state<Sequence, Policy>;
+    using SizeType = typename Sequence::size_type;
+    using DiffType = typename Sequence::difference_type;
+    // Not `const T &` for proxies like `std::vector<bool>`, which are then returned by value
+    using Reference = typename Sequence::const_reference;
+
+    if (!detail::get_type_info(typeid(state), false)) {
+        class_<state>(handle(), "sequence_view", pybind11::module_local())
+            .def("__len__", [](const state &s) { return s.sequence->size(); })
+            .def(
+                "__getitem__",
+                [](const state &s, DiffType i) -> Reference {
+                    const auto n = static_cast<DiffType>(s.sequence->size());
+                    if (i < 0) {
+                        i += n;
+                    }
+                    if (i < 0 || i >= n) {
+                        throw index_error();
+                    }
+                    return (*s.sequence)[static_cast<SizeType>(i)];
+                },
+                Policy)
+            .def(
+                "__getitem__",
+                [](const state &s, const slice &slice) {
+                    size_t start = 0, stop = 0, step = 0, slicelength = 0;
+                    if (!slice.compute(s.sequence->size(), &start, &stop, &step, &slicelength)) {
+                        throw error_already_set();
+                    }
+                    list result(slicelength);
+                    for (size_t i = 0; i < slicelength; ++i, start += step) {
+                        // Slices are new lists, so there is nothing to keep a reference into
+                        result[i] = cast((*s.sequence)[static_cast<SizeType>(start)],
+                                         return_value_policy::copy);
+                    }
+                    return result;
+                })
+            .def(
+                "__iter__",
+                [](const state &s) {
+                    return make_iterator<Policy>(s.sequence->begin(), s.sequence->end());
+                },
+                keep_alive<0, 1>() /* Essential: keep view alive while iterator exists */
+            );
+    }
+
+    object result = cast(state{&seq});
+    if (parent) {
+        detail::keep_alive_impl(result, parent);
+    }
+    return result;
+}
+
+/// Makes a read-only Python mapping that refers to `map` instead of copying it into a `dict`,
+/// with lookups going through `map.find()`. `parent` is kept alive as for `make_sequence_view`.
+template <return_value_policy Policy = return_value_policy::reference_internal, typename Map>
+object make_mapping_view(const Map &map, handle parent = handle()) {
+    using state = detail::mapping_view_state<Map, Policy>;
+    using KeyType = typename Map::key_type;
+    using MappedType = typename Map::mapped_type;
+
+    if (!detail::get_type_info(typeid(state), false)) {
+        class_<state>(handle(), "mapping_view", pybind11::module_local())
+            .def("__len__", [](const state &s) { return s.map->size(); })
+            .def(
+                "__getitem__",
+                [](const state &s, const KeyType &k) -> const MappedType & {
+                    auto it = s.map->find(k);
+                    if (it == s.map->end()) {
+                        throw key_error();
+                    }
+                    return it->second;
+                },
+                Policy)
+            // Fallback for when the object is not of the key type
+            .def("__getitem__",
+                 [](const state &, const object &k) -> object { throw key_error(str(k)); })
+            .def(
+                "get",
+                [](const object &self, const KeyType &k, const object &default_) -> object {
+                    const auto &s = self.cast<const state &>();
+                    auto it = s.map->find(k);
+                    if (it == s.map->end()) {
+                        return default_;
+                    }
+                    return cast(it->second, Policy, self);
+                },
+                arg("key"),
+                arg("default") = none())
+            .def(
+                "get",
+                [](const state &, const object &, const object &default_) { return default_; },
+                arg("key"),
+                arg("default") = none())
+            .def("__contains__",
+                 [](const state &s, const KeyType &k) { return s.map->find(k) != s.map->end(); })
+            .def("__contains__", [](const state &, const object &) { return false; })
+            .def(
+                "__iter__",
+                [](const state &s) {
+                    return make_key_iterator<Policy>(s.map->begin(), s.map->end());
+                },
+                keep_alive<0, 1>())
+            .def(
+                "keys",
+                [](const state &s) {
+                    return make_key_iterator<Policy>(s.map->begin(), s.map->end());
+                },
+                keep_alive<0, 1>())
+            .def(
+                "values",
+                [](const state &s) {
+                    return make_value_iterator<Policy>(s.map->begin(), s.map->end());
+                },
+                keep_alive<0, 1>())
+            .def(
+                "items",
+                [](const state &s) {
+                    return make_iterator<Policy>(s.map->begin(), s.map->end());
+                },
+                keep_alive<0, 1>());
+    }
+
+    object result = cast(state{&map});
+    if (parent) {
+        detail::keep_alive_impl(result, parent);
+    }
+    return result;
+}
+
 PYBIND11_NAMESPACE_END(PYBIND11_NAMESPACE)
@@ -0,0 +1,47 @@
+"""
+Runtime helpers for extension modules, which are not part of the stable interface of pybind11.
+"""
+
+import sys
+from typing import Any, Callable, Dict, Iterator
+
+__all__ = ("dispatch_stats", "enable_dispatch_stats", "reset_dispatch_stats")
+
+_DISPATCH_STATS_HOOK = "__pybind11_dispatch_stats__"
+
+
+def _dispatch_stats_hooks() -> Iterator[Callable[..., Dict[str, Dict[str, Any]]]]:
+    # Every module compiled with PYBIND11_DISPATCH_STATS has a hook in its namespace
+    for module in list(sys.modules.values()):
+        hook = getattr(module, "__dict__", {}).get(_DISPATCH_STATS_HOOK)
+        if hook is not None:
+            yield hook
+
+
+def enable_dispatch_stats(enable: bool = True) -> None:
+    """
+    Switches the collection of dispatch statistics on or off in all imported extension modules
+    compiled with ``PYBIND11_DISPATCH_STATS``.
+    """
+    for hook in _dispatch_stats_hooks():
+        hook(enable)
+
+
+def reset_dispatch_stats() -> None:
+    """
+    Discards the dispatch statistics collected so far by all imported extension modules.
+    """
+    for hook in _dispatch_stats_hooks():
+        hook(reset=True)
+
+
+def dispatch_stats() -> Dict[str, Dict[str, Any]]:
+    """
+    Returns the dispatch statistics of all imported extension modules compiled with
+    ``PYBIND11_DISPATCH_STATS``, as a dict mapping the qualified signature of each overload to
+    its ``calls``, ``overload_misses``, ``conversion_passes``, ``load_time`` and ``call_time``.
+    """
+    result: Dict[str, Dict[str, Any]] = {}
+    for hook in _dispatch_stats_hooks():
+        result.update(hook())
+    return result
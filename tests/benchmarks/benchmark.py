@@ -0,0 +1,164 @@
+"""Runs the pybind11 microbenchmarks and reports the time per operation.
+
+The benchmarks use the ``pybind11_benchmarks`` module, which is built by the ``benchmark`` CMake
+target (that also runs this script). The results are printed as a table, and can be written to
+a JSON file with ``--output`` to compare them across builds and releases.
+"""
+
+import argparse
+import json
+import os
+import platform
+import re
+import subprocess
+import sys
+import timeit
+
+import pybind11_benchmarks as m
+
+# (group, name, statement, setup, operations per execution of the statement)
+BENCHMARKS = [
+    ("call", "0 args", "f()", "f = m.call_0", 1),
+    ("call", "1 arg", "f(1)", "f = m.call_1", 1),
+    ("call", "4 args", "f(1, 2, 3, 4)", "f = m.call_4", 1),
+    ("call", "kwargs", "f(1, c=4)", "f = m.call_kwargs", 1),
+    ("call", "*args", "f(1, 2, 3, 4)", "f = m.call_args", 1),
+    ("call", "overloads, first", "f('')", "f = m.call_overloaded", 1),
+    ("call", "overloads, last", "f(1)", "f = m.call_overloaded", 1),
+    ("call", "method", "g()", "g = m.Object(1).get", 1),
+    ("call", "without gil", "f()", "f = m.call_without_gil", 1),
+    ("object", "construct and destroy", "C()", "C = m.Object", 1),
+    ("object", "construct with arg", "C(1)", "C = m.Object", 1),
+    ("object", "return by value", "f(1)", "f = m.make_object", 1),
+    ("object", "pass instance", "f(o)", "f = m.take_object; o = m.Object(1)", 1),
+    ("object", "pass derived instance", "f(o)", "f = m.take_derived; o = m.Derived(1)", 1),
+    ("object", "read attribute", "o.value", "o = m.Object(1)", 1),
+    ("object", "write attribute", "o.value = 2", "o = m.Object(1)", 1),
+    ("object", "read property", "o.prop", "o = m.Object(1)", 1),
+    ("cast", "str", "f(s)", "f = m.string_roundtrip; s = 'x' * 32", 1),
+    ("cast", "list[float] (1000) in", "f(v)", "f = m.vector_sum; v = [1.0] * 1000", 1),
+    ("cast", "list[float] (1000) out", "f(1000)", "f = m.make_vector", 1),
+    (
+        "cast",
+        "list[list[int]] (100x10) in",
+        "f(v)",
+        "f = m.nested_vector_size; v = [list(range(10))] * 100",
+        1,
+    ),
+    (
+        "cast",
+        "dict[str, int] (100)",
+        "f(d)",
+        "f = m.map_roundtrip; d = {str(i): i for i in range(100)}",
+        1,
+    ),
+    (
+        "cast",
+        "numpy (1000)",
+        "f(a)",
+        "import numpy as np; f = m.array_sum; a = np.ones(1000)",
+        1,
+    ),
+    (
+        "cast",
+        "numpy, converted (1000)",
+        "f(a)",
+        "import numpy as np; f = m.array_sum; a = np.ones(1000, dtype=np.float32)",
+        1,
+    ),
+    (
+        "cast",
+        "eigen (10x10) in",
+        "f(a)",
+        "import numpy as np; f = m.eigen_sum; a = np.ones((10, 10))",
+        1,
+    ),
+    (
+        "cast",
+        "eigen ref (10x10) in",
+        "f(a)",
+        "import numpy as np; f = m.eigen_ref_sum; a = np.asfortranarray(np.ones((10, 10)))",
+        1,
+    ),
+    ("cast", "eigen (10x10) out", "f(10)", "import numpy; f = m.make_eigen", 1),
+    ("callback", "py::function", "f(g, 1000)", "f = m.call_python; g = lambda i: i", 1000),
+    (
+        "callback",
+        "std::function",
+        "f(g, 1000)",
+        "f = m.call_std_function; g = lambda i: i",
+        1000,
+    ),
+    ("gil", "release and acquire", "f(1000)", "f = m.gil_release_acquire", 1000),
+    ("gil", "acquire while held", "f(1000)", "f = m.gil_acquire_held", 1000),
+]
+
+
+def time_per_op(stmt, setup, ops, min_time, repeat):
+    timer = timeit.Timer(stmt, setup, globals={"m": m})
+    number, _ = timer.autorange()
+    # Scale up to the requested minimum time per repetition
+    number = max(number, int(number * min_time / 0.2))
+    best = min(timer.repeat(repeat=repeat, number=number))
+    return best / number / ops
+
+
+def time_import(repeat):
+    code = (
+        "import time; t = time.perf_counter(); import pybind11_benchmarks; "
+        "print(time.perf_counter() - t)"
+    )
+    env = dict(os.environ)
+    env["PYTHONPATH"] = os.pathsep.join(
+        [os.path.dirname(m.__file__), env.get("PYTHONPATH", "")]
+    )
+    times = []
+    for _ in range(repeat):
+        out = subprocess.check_output([sys.executable, "-c", code], env=env)
+        times.append(float(out))
+    return min(times)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--output", help="write the results to this JSON file")
+    parser.add_argument("--filter", help="only run benchmarks matching this regex")
+    parser.add_argument("--repeat", type=int, default=5, help="repetitions (best is used)")
+    parser.add_argument(
+        "--min-time", type=float, default=0.2, help="minimum seconds per repetition"
+    )
+    args = parser.parse_args()
+
+    results = []
+    benchmarks = [*BENCHMARKS, ("import", "module", None, None, 1)]
+    for group, name, stmt, setup, ops in benchmarks:
+        full_name = f"{group}/{name}"
+        if args.filter and not re.search(args.filter, full_name):
+            continue
+        try:
+            if stmt is None:
+                seconds = time_import(args.repeat)
+            else:
+                seconds = time_per_op(stmt, setup, ops, args.min_time, args.repeat)
+        except (ImportError, AttributeError) as e:
+            # NumPy or Eigen is not available
+            print(f"{full_name:<45} skipped ({e})")
+            continue
+        print(f"{full_name:<45} {seconds * 1e9:12.1f} ns")
+        results.append({"group": group, "name": name, "ns_per_op": seconds * 1e9})
+
+    if args.output:
+        context = {
+            "python": sys.version,
+            "implementation": platform.python_implementation(),
+            "platform": platform.platform(),
+            "machine": platform.machine(),
+            "module": m.__file__,
+        }
+        with open(args.output, "w") as f:
+            json.dump({"context": context, "benchmarks": results}, f, indent=2)
+            f.write("\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,128 @@
+/*
+    tests/benchmarks/pybind11_benchmarks.cpp -- bindings measured by benchmark.py
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE file.
+*/
+
+#include <pybind11/functional.h>
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#if defined(PYBIND11_TEST_EIGEN)
+#    include <pybind11/eigen/matrix.h>
+#endif
+
+#include <map>
+#include <numeric>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace py = pybind11;
+
+namespace {
+
+// The functions are kept trivial, so that the timings are dominated by the overhead of pybind11
+
+struct Object {
+    Object() = default;
+    explicit Object(int value) : value(value) {}
+    int get() const { return value; }
+    void set(int v) { value = v; }
+    int value = 0;
+};
+
+struct Derived : Object {
+    using Object::Object;
+};
+
+} // namespace
+
+PYBIND11_MODULE(pybind11_benchmarks, m, py::mod_gil_not_used()) {
+    m.doc() = "pybind11 microbenchmark module";
+
+    // Call overhead
+    m.def("call_0", []() {});
+    m.def("call_1", [](int) {});
+    m.def("call_4", [](int, int, int, int) {});
+    m.def(
+        "call_kwargs",
+        [](int a, int b, int c) { return a + b + c; },
+        py::arg("a"),
+        py::arg("b") = 2,
+        py::arg("c") = 3);
+    m.def("call_args", [](const py::args &args) { return args.size(); });
+    m.def("call_overloaded", [](const std::string &) { return 0; });
+    m.def("call_overloaded", [](const Object &) { return 1; });
+    m.def("call_overloaded", [](double) { return 2; });
+    m.def("call_overloaded", [](int) { return 3; });
+
+    // Construction, destruction and member access
+    py::class_<Object>(m, "Object")
+        .def(py::init<>())
+        .def(py::init<int>())
+        .def("get", &Object::get)
+        .def_readwrite("value", &Object::value)
+        .def_property("prop", &Object::get, &Object::set);
+    py::class_<Derived, Object>(m, "Derived").def(py::init<int>());
+    m.def("make_object", [](int value) { return Object(value); });
+    m.def("take_object", [](const Object &o) { return o.value; });
+    m.def("take_derived", [](const Object &o) { return o.value; });
+
+    // Casters
+    m.def("string_roundtrip", [](const std::string &s) { return s; });
+    m.def("vector_sum", [](const std::vector<double> &v) {
+        return std::accumulate(v.begin(), v.end(), 0.0);
+    });
+    m.def("make_vector", [](size_t n) { return std::vector<double>(n, 1.0); });
+    m.def("nested_vector_size", [](const std::vector<std::vector<int>> &v) {
+        size_t size = 0;
+        for (const auto &inner : v) {
+            size += inner.size();
+        }
+        return size;
+    });
+    m.def("map_roundtrip", [](const std::map<std::string, int> &map) { return map; });
+    m.def("array_sum", [](const py::array_t<double, py::array::c_style> &a) {
+        const double *data = a.data();
+        return std::accumulate(data, data + a.size(), 0.0);
+    });
+#if defined(PYBIND11_TEST_EIGEN)
+    m.attr("has_eigen") = true;
+    m.def("eigen_sum", [](const Eigen::MatrixXd &mat) { return mat.sum(); });
+    m.def("eigen_ref_sum",
+          [](const Eigen::Ref<const Eigen::MatrixXd> &mat) { return mat.sum(); });
+    m.def("make_eigen", [](Eigen::Index n) { return Eigen::MatrixXd::Ones(n, n).eval(); });
+#else
+    m.attr("has_eigen") = false;
+#endif
+
+    // Callbacks into Python
+    m.def("call_python", [](const py::function &f, int n) {
+        for (int i = 0; i < n; ++i) {
+            f(i);
+        }
+    });
+    m.def("call_std_function", [](const std::function<int(int)> &f, int n) {
+        int sum = 0;
+        for (int i = 0; i < n; ++i) {
+            sum += f(i);
+        }
+        return sum;
+    });
+
+    // GIL handling, looped in C++ since it cannot be observed from Python
+    m.def("gil_release_acquire", [](int n) {
+        for (int i = 0; i < n; ++i) {
+            py::gil_scoped_release release;
+        }
+    });
+    m.def("gil_acquire_held", [](int n) {
+        for (int i = 0; i < n; ++i) {
+            py::gil_scoped_acquire acquire;
+        }
+    });
+    m.def("call_without_gil", []() {}, py::call_guard<py::gil_scoped_release>());
+}
@@ -90,6 +90,9 @@ extern "C" PYBIND11_EXPORT PyObject *PyInit_cross_module_gil_utils() {
     PyObject *m = PyModule_Create(&moduledef);
 
     if (m != nullptr) {
+#ifdef Py_GIL_DISABLED
+        PyUnstable_Module_SetGIL(m, Py_MOD_GIL_NOT_USED);
+#endif
         static_assert(sizeof(&gil_acquire) == sizeof(void *),
                       "Function pointer must have the same size as void*");
         ADD_FUNCTION("gil_acquire_funcaddr", gil_acquire)
@@ -40,6 +40,9 @@ struct PyModuleDef moduledef = {
 extern "C" PYBIND11_EXPORT PyObject *PyInit_cross_module_interleaved_error_already_set() {
     PyObject *m = PyModule_Create(&moduledef);
     if (m != nullptr) {
+#ifdef Py_GIL_DISABLED
+        PyUnstable_Module_SetGIL(m, Py_MOD_GIL_NOT_USED);
+#endif
         static_assert(sizeof(&interleaved_error_already_set) == sizeof(void *),
                       "Function pointer must have the same size as void *");
         PyModule_AddObject(
@@ -24,12 +24,16 @@ Cflags: -I${{includedir}}
 
 
 main_headers = {
+    "include/pybind11/async.h",
     "include/pybind11/attr.h",
+    "include/pybind11/bool_numpy.h",
     "include/pybind11/buffer_info.h",
     "include/pybind11/cast.h",
     "include/pybind11/chrono.h",
+    "include/pybind11/chrono_numpy.h",
     "include/pybind11/common.h",
     "include/pybind11/complex.h",
+    "include/pybind11/complex_numpy.h",
     "include/pybind11/eigen.h",
     "include/pybind11/embed.h",
     "include/pybind11/eval.h",
@@ -52,6 +56,9 @@ detail_headers = {
     "include/pybind11/detail/descr.h",
     "include/pybind11/detail/init.h",
     "include/pybind11/detail/internals.h",
+    "include/pybind11/detail/instance_map.h",
+    "include/pybind11/detail/small_vector.h",
+    "include/pybind11/detail/tracing.h",
     "include/pybind11/detail/type_caster_base.h",
     "include/pybind11/detail/typeid.h",
 }
@@ -64,6 +71,7 @@ eigen_headers = {
 
 stl_headers = {
     "include/pybind11/stl/filesystem.h",
+    "include/pybind11/stl/staged.h",
 }
 
 cmake_files = {
@@ -85,6 +93,7 @@ py_files = {
     "__main__.py",
     "_version.py",
     "commands.py",
+    "detail.py",
     "py.typed",
     "setup_helpers.py",
 }
@@ -0,0 +1,76 @@
+/*
+    tests/pybind11_compact_dispatch_tests.cpp -- module compiled with PYBIND11_COMPACT_DISPATCH
+
+    Copyright (c) 2024 The pybind Community.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE file.
+*/
+
+#define PYBIND11_COMPACT_DISPATCH
+
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace py = pybind11;
+
+namespace {
+
+struct Pet {
+    explicit Pet(int age) : age(age) {}
+    int age;
+};
+
+struct Dog : Pet {
+    using Pet::Pet;
+};
+
+struct Owner {
+    std::shared_ptr<Pet> pet;
+};
+
+} // namespace
+
+PYBIND11_MODULE(pybind11_compact_dispatch_tests, m) {
+    py::class_<Pet>(m, "Pet").def(py::init<int>()).def_readonly("age", &Pet::age);
+    py::class_<Dog, Pet>(m, "Dog").def(py::init<int>());
+    py::implicitly_convertible<int, Pet>();
+
+    py::class_<Owner>(m, "Owner")
+        .def(py::init<>())
+        .def("adopt", [](Owner &owner, int age) { owner.pet = std::make_shared<Pet>(age); })
+        .def("pet_age", [](const Owner &owner) { return owner.pet ? owner.pet->age : -1; });
+
+    m.def("add", [](int a, int b) { return a + b; });
+    m.def("overloaded", [](int) { return "int"; });
+    m.def("overloaded", [](double) { return "float"; });
+    m.def("overloaded", [](const std::string &) { return "str"; });
+    m.def(
+        "greet",
+        [](const std::string &name, int times) {
+            std::string result;
+            for (int i = 0; i < times; ++i) {
+                result += "Hello " + name + "! ";
+            }
+            return result;
+        },
+        py::arg("name"),
+        py::arg("times") = 1);
+    m.def("ages", [](const Pet &a, const Pet *b, Pet &c) {
+        return std::vector<int>{a.age, b != nullptr ? b->age : -1, c.age};
+    });
+    m.def("total_age", [](const std::vector<Pet *> &pets) {
+        int total = 0;
+        for (const auto *pet : pets) {
+            total += pet->age;
+        }
+        return total;
+    });
+    m.def("count_args", [](int first, const py::args &args, const py::kwargs &kwargs) {
+        return first + static_cast<int>(args.size() + kwargs.size());
+    });
+}
@@ -0,0 +1,31 @@
+/*
+    tests/pybind11_dispatch_stats_tests.cpp -- module compiled with PYBIND11_DISPATCH_STATS
+
+    Copyright (c) 2024 The pybind Community.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE file.
+*/
+
+#include <pybind11/detail/common.h>
+
+// The statistics rely on the GIL (and this module is built without them otherwise)
+#if !defined(Py_GIL_DISABLED)
+#    define PYBIND11_DISPATCH_STATS
+#endif
+
+#include <pybind11/pybind11.h>
+
+namespace py = pybind11;
+
+PYBIND11_MODULE(pybind11_dispatch_stats_tests, m) {
+#if defined(PYBIND11_DISPATCH_STATS)
+    m.def("enable_dispatch_stats", &py::enable_dispatch_stats, py::arg("enable") = true);
+    m.def("reset_dispatch_stats", &py::reset_dispatch_stats);
+    m.def("dispatch_stats", &py::dispatch_stats);
+#endif
+
+    m.def("add", [](int a, int b) { return a + b; });
+    m.def("overloaded", [](int) { return "int"; });
+    m.def("overloaded", [](double) { return "float"; });
+}
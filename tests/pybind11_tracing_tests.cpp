@@ -0,0 +1,107 @@
+/*
+    tests/pybind11_tracing_tests.cpp -- module compiled with PYBIND11_TRACING
+
+    Copyright (c) 2024 The pybind Community.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE file.
+*/
+
+#define PYBIND11_TRACING
+
+#include <pybind11/pybind11.h>
+
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace py = pybind11;
+
+namespace {
+
+const char *event_name(py::trace_event event) {
+    switch (event) {
+        case py::trace_event::function_entry:
+            return "function_entry";
+        case py::trace_event::function_exit:
+            return "function_exit";
+        case py::trace_event::overload_failed:
+            return "overload_failed";
+        case py::trace_event::implicit_conversion:
+            return "implicit_conversion";
+        case py::trace_event::instance_registered:
+            return "instance_registered";
+        case py::trace_event::keep_alive:
+            return "keep_alive";
+        case py::trace_event::gil_acquire:
+            return "gil_acquire";
+        case py::trace_event::gil_release:
+            return "gil_release";
+    }
+    return "unknown";
+}
+
+// The hook may be called without the GIL, so the events are guarded by a mutex of their own
+std::mutex &events_mutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+std::vector<std::pair<std::string, std::string>> &events() {
+    static auto *events = new std::vector<std::pair<std::string, std::string>>();
+    return *events;
+}
+
+void record_event(py::trace_event event, const char *name, const void *) {
+    std::lock_guard<std::mutex> lock(events_mutex());
+    events().emplace_back(event_name(event), name != nullptr ? name : "");
+}
+
+struct Pet {
+    explicit Pet(int age) : age(age) {}
+    int age;
+};
+
+struct Owner {};
+
+} // namespace
+
+PYBIND11_MODULE(pybind11_tracing_tests, m) {
+    m.def("start_tracing", []() {
+        {
+            std::lock_guard<std::mutex> lock(events_mutex());
+            events().clear();
+        }
+        py::set_trace_hook(&record_event);
+    });
+    // Returns the events since `start_tracing()` as (event, name) tuples
+    m.def("stop_tracing", []() {
+        py::set_trace_hook(nullptr);
+        std::vector<std::pair<std::string, std::string>> recorded;
+        {
+            std::lock_guard<std::mutex> lock(events_mutex());
+            recorded.swap(events());
+        }
+        py::list result;
+        for (const auto &event : recorded) {
+            result.append(py::make_tuple(event.first, event.second));
+        }
+        return result;
+    });
+
+    m.def("add", [](int a, int b) { return a + b; });
+    m.def("overloaded", [](int) { return "int"; });
+    m.def("overloaded", [](double) { return "float"; });
+
+    py::class_<Pet>(m, "Pet").def(py::init<int>()).def_readonly("age", &Pet::age);
+    py::implicitly_convertible<int, Pet>();
+    m.def("pet_age", [](const Pet &pet) { return pet.age; });
+
+    py::class_<Owner>(m, "Owner")
+        .def(py::init<>())
+        .def(
+            "adopt", [](Owner &, const Pet &) {}, py::keep_alive<1, 2>());
+
+    m.def("release_gil", []() { py::gil_scoped_release release; });
+}
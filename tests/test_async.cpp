@@ -7,8 +7,20 @@
     BSD-style license that can be found in the LICENSE file.
 */
 
+#include <pybind11/async.h>
+
 #include "pybind11_tests.h"
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
 TEST_SUBMODULE(async_module, m) {
     struct DoesNotSupportAsync {};
     py::class_<DoesNotSupportAsync>(m, "DoesNotSupportAsync").def(py::init<>());
@@ -22,4 +34,95 @@ TEST_SUBMODULE(async_module, m) {
             f.attr("set_result")(5);
             return f.attr("__await__")();
         });
+
+    m.def_async("add", [](int a, int b) { return a + b; });
+    m.def_async("concat", [](const std::string &a, std::string b) { return a + b; });
+    m.def_async("do_nothing", []() {});
+    m.def_async("throw_runtime_error", []() -> int { throw std::runtime_error("from C++"); });
+    m.def_async("make_instance", []() { return SupportsAsync{}; });
+
+    // Blocks its thread until `release()` is called, which only works if neither the event loop
+    // nor the GIL are blocked meanwhile
+    struct gate {
+        std::mutex mutex;
+        std::condition_variable opened;
+        bool is_open = false;
+    };
+    static auto *wait_gate = new gate();
+    m.def_async("wait_for_release", []() {
+        std::unique_lock<std::mutex> lock(wait_gate->mutex);
+        bool released = wait_gate->opened.wait_for(
+            lock, std::chrono::seconds(10), []() { return wait_gate->is_open; });
+        wait_gate->is_open = false;
+        return released;
+    });
+    m.def("release", []() {
+        {
+            std::lock_guard<std::mutex> lock(wait_gate->mutex);
+            wait_gate->is_open = true;
+        }
+        wait_gate->opened.notify_all();
+    });
+
+    // Runs each call on a thread of its own
+    class counting_executor : public py::executor {
+    public:
+        void submit(std::function<void()> task) override {
+            ++submitted;
+            std::thread(std::move(task)).detach();
+        }
+        std::atomic<int> submitted{0};
+    };
+    static auto *executor = new counting_executor();
+    m.def_async(
+        "add_on_executor", [](int a, int b) { return a + b; }, py::async_executor(*executor));
+    m.def("executor_submissions", []() { return executor->submitted.load(); });
+
+    // test_python_executor
+    m.def("executor_map", [](const py::function &fn, int num_threads, int calls_per_thread) {
+        std::vector<int> results(static_cast<size_t>(num_threads * calls_per_thread));
+        {
+            py::gil_scoped_release release;
+            py::python_executor exec;
+            std::vector<std::thread> threads;
+            for (int t = 0; t < num_threads; ++t) {
+                threads.emplace_back([&, t]() {
+                    std::vector<std::future<int>> futures;
+                    for (int i = 0; i < calls_per_thread; ++i) {
+                        futures.push_back(exec.call<int>(fn, t * calls_per_thread + i));
+                    }
+                    for (int i = 0; i < calls_per_thread; ++i) {
+                        results[static_cast<size_t>(t * calls_per_thread + i)]
+                            = futures[static_cast<size_t>(i)].get();
+                    }
+                });
+            }
+            for (auto &thread : threads) {
+                thread.join();
+            }
+        }
+        py::list list;
+        for (int result : results) {
+            list.append(result);
+        }
+        return list;
+    });
+    m.def("executor_drain", [](const py::function &fn, int num_calls) {
+        py::python_executor exec(/*own_thread=*/false);
+        std::vector<std::future<void>> futures;
+        {
+            py::gil_scoped_release release;
+            std::thread([&]() {
+                for (int i = 0; i < num_calls; ++i) {
+                    futures.push_back(exec.call(fn, i));
+                }
+                futures.push_back(exec.submit([]() {}));
+            }).join();
+        }
+        auto count = exec.drain();
+        for (auto &future : futures) {
+            future.get();
+        }
+        return count;
+    });
 }
@@ -22,3 +22,63 @@ def test_await(event_loop):
 def test_await_missing(event_loop):
     with pytest.raises(TypeError):
         event_loop.run_until_complete(get_await_result(m.DoesNotSupportAsync()))
+
+
+async def call(f, *args):
+    return await f(*args)
+
+
+def test_def_async(event_loop):
+    assert event_loop.run_until_complete(call(m.add, 1, 2)) == 3
+    assert event_loop.run_until_complete(call(m.concat, "a", "b")) == "ab"
+    assert event_loop.run_until_complete(call(m.do_nothing)) is None
+    assert isinstance(
+        event_loop.run_until_complete(call(m.make_instance)), m.SupportsAsync
+    )
+
+
+def test_def_async_gather(event_loop):
+    async def gather():
+        return await asyncio.gather(*(m.add(i, i) for i in range(20)))
+
+    assert event_loop.run_until_complete(gather()) == [2 * i for i in range(20)]
+
+
+def test_def_async_exception(event_loop):
+    with pytest.raises(RuntimeError, match="from C\\+\\+"):
+        event_loop.run_until_complete(call(m.throw_runtime_error))
+
+
+def test_def_async_releases_loop_and_gil(event_loop):
+    async def wait_and_release():
+        future = m.wait_for_release()
+        await asyncio.sleep(0.01)
+        m.release()
+        return await future
+
+    assert event_loop.run_until_complete(wait_and_release()) is True
+
+
+def test_def_async_executor(event_loop):
+    before = m.executor_submissions()
+    assert event_loop.run_until_complete(call(m.add_on_executor, 2, 3)) == 5
+    assert m.executor_submissions() == before + 1
+
+
+def test_def_async_without_running_loop():
+    with pytest.raises(RuntimeError):
+        m.add(1, 2)
+
+
+def test_python_executor():
+    assert m.executor_map(lambda x: x * 2, 4, 25) == [x * 2 for x in range(100)]
+
+    seen = []
+    assert m.executor_drain(seen.append, 5) == 6
+    assert seen == [0, 1, 2, 3, 4]
+
+    def fail(x):
+        raise ValueError(f"no {x}")
+
+    with pytest.raises(ValueError, match="no 0"):
+        m.executor_drain(fail, 1)
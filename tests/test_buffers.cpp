@@ -238,6 +238,84 @@ TEST_SUBMODULE(buffers, m) {
         .def_readwrite("readonly", &BufferReadOnlySelect::readonly)
         .def_buffer(&BufferReadOnlySelect::get_buffer_info);
 
+    // test_filled_buffer
+    struct FilledBuffer {
+        int16_t values[2][3] = {{1, 2, 3}, {4, 5, 6}};
+        py::ssize_t shape[2] = {2, 3};
+        py::ssize_t strides[2] = {3 * sizeof(int16_t), sizeof(int16_t)};
+        bool readonly = false;
+        int exports = 0;
+    };
+    py::class_<FilledBuffer>(m, "FilledBuffer", py::buffer_protocol())
+        .def(py::init<>())
+        .def_readwrite("readonly", &FilledBuffer::readonly)
+        .def_readonly("exports", &FilledBuffer::exports)
+        .def_buffer(
+            [](FilledBuffer &self, Py_buffer *view, int) {
+                view->buf = self.values;
+                view->itemsize = sizeof(int16_t);
+                view->format = const_cast<char *>(py::buffer_format<int16_t>());
+                view->ndim = 2;
+                view->shape = self.shape;
+                view->strides = self.strides;
+                view->readonly = self.readonly ? 1 : 0;
+                ++self.exports;
+            },
+            [](FilledBuffer &self, Py_buffer *) { --self.exports; });
+    struct DerivedFilledBuffer : FilledBuffer {};
+    py::class_<DerivedFilledBuffer, FilledBuffer>(m, "DerivedFilledBuffer").def(py::init<>());
+
+    // test_buffer_view
+    m.def("get_buffer_view", [](const py::buffer &buffer, bool writable) {
+        py::buffer_view view = buffer.view(writable);
+        py::list shape;
+        py::list strides;
+        for (py::ssize_t i = 0; i < view.ndim(); ++i) {
+            shape.append(view.shape(i));
+            strides.append(view.strides(i));
+        }
+        return py::make_tuple(view.itemsize(),
+                              view.size(),
+                              view.format(),
+                              view.ndim(),
+                              shape,
+                              strides,
+                              view.readonly(),
+                              view.nbytes());
+    });
+
+    // test_buffer_flags
+    struct StridedBuffer {
+        int32_t values[6] = {0, 1, 2, 3, 4, 5};
+    };
+    py::class_<StridedBuffer>(m, "StridedBuffer", py::buffer_protocol())
+        .def(py::init<>())
+        .def_buffer([](StridedBuffer &self) {
+            return py::buffer_info(self.values,
+                                   std::vector<py::ssize_t>{3},
+                                   std::vector<py::ssize_t>{2 * sizeof(int32_t)});
+        });
+    m.def("request_buffer", [](const py::object &obj, int flags) {
+        Py_buffer view;
+        if (PyObject_GetBuffer(obj.ptr(), &view, flags) != 0) {
+            throw py::error_already_set();
+        }
+        auto to_list = [&view](const py::ssize_t *values) -> py::object {
+            if (values == nullptr) {
+                return py::none();
+            }
+            return py::cast(std::vector<py::ssize_t>(values, values + view.ndim));
+        };
+        auto result = py::make_tuple(view.ndim,
+                                     to_list(view.shape),
+                                     to_list(view.strides),
+                                     view.format != nullptr ? py::object(py::str(view.format))
+                                                            : py::object(py::none()),
+                                     view.len);
+        PyBuffer_Release(&view);
+        return result;
+    });
+
     // Expose buffer_info for testing.
     py::class_<py::buffer_info>(m, "buffer_info")
         .def(py::init<>())
@@ -219,3 +219,86 @@ def test_ctypes_from_buffer():
         assert cinfo.shape == pyinfo.shape
         assert cinfo.strides == pyinfo.strides
         assert not cinfo.readonly
+
+
+def test_filled_buffer():
+    for cls in [m.FilledBuffer, m.DerivedFilledBuffer]:
+        buf = cls()
+        view = memoryview(buf)
+        assert view.format == "h"
+        assert view.shape == (2, 3)
+        assert view.strides == (6, 2)
+        assert view.nbytes == 12
+        assert view.tolist() == [[1, 2, 3], [4, 5, 6]]
+        assert not view.readonly
+        view[1, 2] = 7
+        assert memoryview(buf)[1, 2] == 7
+
+        info = m.get_buffer_info(buf)
+        assert info.shape == [2, 3]
+        assert info.strides == [6, 2]
+
+        buf.readonly = True
+        assert memoryview(buf).readonly
+        with pytest.raises(BufferError):
+            m.get_buffer_view(buf, True)
+
+        # The release callback is called for every export, including refused ones
+        del view, info
+        pytest.gc_collect()
+        assert buf.exports == 0
+        view = memoryview(buf)
+        assert buf.exports == 1
+        view.release()
+        assert buf.exports == 0
+
+
+def test_buffer_view():
+    data = bytearray(b"0123456789")
+    assert m.get_buffer_view(data, True) == (1, 10, "B", 1, [10], [1], False, 10)
+    assert m.get_buffer_view(b"abc", False)[6]
+    with pytest.raises(BufferError):
+        m.get_buffer_view(b"abc", True)
+
+    # ctypes arrays give no strides
+    int2d = ((ctypes.c_int * 5) * 3)()
+    size = ctypes.sizeof(ctypes.c_int)
+    view = m.get_buffer_view(int2d, False)
+    assert view[:2] == (size, 15)
+    assert view[3:7] == (2, [3, 5], [5 * size, size], False)
+
+
+PyBUF_SIMPLE = 0
+PyBUF_FORMAT = 0x0004
+PyBUF_ND = 0x0008
+PyBUF_STRIDES = 0x0010 | PyBUF_ND
+PyBUF_C_CONTIGUOUS = 0x0020 | PyBUF_STRIDES
+PyBUF_F_CONTIGUOUS = 0x0040 | PyBUF_STRIDES
+PyBUF_ANY_CONTIGUOUS = 0x0080 | PyBUF_STRIDES
+
+
+def test_buffer_flags():
+    for obj in [m.FilledBuffer(), m.Matrix(2, 3)]:
+        itemsize = memoryview(obj).itemsize
+        size = itemsize * 6
+        assert m.request_buffer(obj, PyBUF_SIMPLE) == (1, None, None, None, size)
+        assert m.request_buffer(obj, PyBUF_ND) == (2, [2, 3], None, None, size)
+        assert m.request_buffer(obj, PyBUF_STRIDES | PyBUF_FORMAT)[2:4] == (
+            [3 * itemsize, itemsize],
+            memoryview(obj).format,
+        )
+        assert m.request_buffer(obj, PyBUF_C_CONTIGUOUS)[0] == 2
+        assert m.request_buffer(obj, PyBUF_ANY_CONTIGUOUS)[0] == 2
+        with pytest.raises(BufferError, match="Fortran-contiguous"):
+            m.request_buffer(obj, PyBUF_F_CONTIGUOUS)
+
+    strided = m.StridedBuffer()
+    assert memoryview(strided).tolist() == [0, 2, 4]
+    assert m.request_buffer(strided, PyBUF_STRIDES) == (1, [3], [8], None, 12)
+    for flags in [PyBUF_SIMPLE, PyBUF_ND, PyBUF_C_CONTIGUOUS]:
+        with pytest.raises(BufferError, match="C-contiguous"):
+            m.request_buffer(strided, flags)
+    with pytest.raises(BufferError, match="Contiguous"):
+        m.request_buffer(strided, PyBUF_ANY_CONTIGUOUS)
+    with pytest.raises(BufferError):
+        struct.unpack("3i", strided)
@@ -138,6 +138,10 @@ TEST_SUBMODULE(builtin_casters, m) {
 
     // test_bytes_to_string
     m.def("strlen", [](char *s) { return strlen(s); });
+    m.def("overwrite_first", [](char *s) {
+        s[0] = '_';
+        return std::string(s);
+    });
     m.def("string_length", [](const std::string &s) { return s.length(); });
 
 #ifdef PYBIND11_HAS_U8STRING
@@ -233,6 +237,9 @@ TEST_SUBMODULE(builtin_casters, m) {
     m.def("u32_str", [](std::uint32_t v) { return std::to_string(v); });
     m.def("i64_str", [](std::int64_t v) { return std::to_string(v); });
     m.def("u64_str", [](std::uint64_t v) { return std::to_string(v); });
+    m.def("i8_str", [](std::int8_t v) { return std::to_string(v); });
+    m.def("u8_str", [](std::uint8_t v) { return std::to_string(v); });
+    m.def("double_passthrough", [](double v) { return v; });
 
     // test_int_convert
     m.def("int_passthrough", [](int arg) { return arg; });
@@ -388,5 +395,17 @@ TEST_SUBMODULE(builtin_casters, m) {
     m.def("takes_const_ref_wrap",
           [](std::reference_wrapper<const ConstRefCasted> x) { return x.get().tag; });
 
+    // test_interned
+    m.def("interned_parity",
+          [](int i) -> py::interned<std::string> { return std::string(i % 2 ? "odd" : "even"); });
+    m.def("interned_literal", []() -> py::interned<const char *> { return "literal"; });
+    m.def("interned_null", []() -> py::interned<const char *> { return nullptr; });
+#ifdef PYBIND11_HAS_STRING_VIEW
+    m.def("interned_view", [](int i) -> py::interned<std::string_view> {
+        static const std::string names[] = {"alpha", "beta"};
+        return std::string_view(names[i]);
+    });
+#endif
+
     PYBIND11_WARNING_POP
 }
@@ -9,6 +9,9 @@ from pybind11_tests import builtin_casters as m
 
 def test_simple_string():
     assert m.string_roundtrip("const char *") == "const char *"
+    # Long ASCII strings are copied without decoding; a late non-ASCII byte must be noticed
+    for s in ("x" * 1000, "x" * 1000 + "\u00e9", "\u00e9" + "x" * 7, "x" * 15 + "\u00ff"):
+        assert m.string_roundtrip(s) == s
 
 
 def test_unicode_conversion():
@@ -133,6 +136,15 @@ def test_bytes_to_string():
     assert m.string_length("💩".encode()) == 4
 
 
+def test_mutable_char_pointer():
+    # A `char *` argument may be modified, so it points to a copy of the string rather than to
+    # the buffer of the (immutable, here interned) str
+    s = "hello"
+    assert m.overwrite_first(s) == "_ello"
+    assert s == "".join(["hel", "lo"])
+    assert m.string_roundtrip(s) == "hello"
+
+
 def test_bytearray_to_string():
     """Tests the ability to pass bytearray to C++ string-accepting functions"""
     assert m.string_length(bytearray(b"Hi")) == 2
@@ -245,6 +257,36 @@ def test_integer_casting():
     assert "incompatible function arguments" in str(excinfo.value)
 
 
+def test_exact_int_and_float_casting():
+    """Exact ints and floats take a shortcut, which must give the same results"""
+    assert m.i8_str(127) == "127"
+    assert m.i8_str(-128) == "-128"
+    assert m.u8_str(255) == "255"
+    for f, value in [(m.i8_str, 128), (m.i8_str, -129), (m.u8_str, 256), (m.u8_str, -1)]:
+        with pytest.raises(TypeError):
+            f(value)
+    # Larger than a compact int, larger than a long long, and at the limits
+    assert m.i64_str(2**40) == str(2**40)
+    assert m.i64_str(-(2**63)) == str(-(2**63))
+    assert m.u64_str(2**63) == str(2**63)
+    assert m.u64_str(2**64 - 1) == str(2**64 - 1)
+    with pytest.raises(TypeError):
+        m.i64_str(2**63)
+    with pytest.raises(TypeError):
+        m.u64_str(2**64)
+
+    class IntSubclass(int):
+        pass
+
+    class FloatSubclass(float):
+        pass
+
+    assert m.i32_str(IntSubclass(7)) == "7"
+    assert m.double_passthrough(0.25) == 0.25
+    assert m.double_passthrough(FloatSubclass(0.5)) == 0.5
+    assert m.double_passthrough(3) == 3.0
+
+
 def test_int_convert():
     class Int:
         def __int__(self):
@@ -526,3 +568,20 @@ def test_const_ref_caster():
     assert m.takes_const_ptr(x) == 5
     assert m.takes_const_ref(x) == 4
     assert m.takes_const_ref_wrap(x) == 4
+
+
+def test_interned(doc):
+    odd = m.interned_parity(1)
+    assert odd == "odd"
+    assert m.interned_parity(3) is odd
+    assert m.interned_parity(2) is m.interned_parity(4)
+    assert sys.intern("odd") is odd
+    assert doc(m.interned_parity) == "interned_parity(arg0: int) -> str"
+
+    assert m.interned_literal() == "literal"
+    assert m.interned_literal() is m.interned_literal()
+    assert m.interned_null() is None
+
+    if hasattr(m, "interned_view"):
+        assert m.interned_view(1) == "beta"
+        assert m.interned_view(1) is m.interned_view(1)
@@ -67,6 +67,11 @@ TEST_SUBMODULE(call_policies, m) {
         "free_function", [](Parent *, Child *) {}, py::keep_alive<1, 2>());
     m.def(
         "invalid_arg_index", [] {}, py::keep_alive<0, 1>());
+    // A nurse that is not a pybind11 instance
+    m.def(
+        "keep_alive_object",
+        [](const py::object &, const py::object &) {},
+        py::keep_alive<1, 2>());
 
 #if !defined(PYPY_VERSION)
     // test_alive_gc
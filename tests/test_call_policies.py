@@ -116,6 +116,31 @@ def test_keep_alive_return_value(capture):
 
 # https://foss.heptapod.net/pypy/pypy/-/issues/2447
 @pytest.mark.xfail("env.PYPY", reason="_PyObject_GetDictPtr is unimplemented")
+def test_keep_alive_multiple_patients():
+    n_inst = ConstructorStats.detail_reg_inst()
+    p = m.Parent()
+    for _ in range(3):
+        p.addChildKeepAlive(m.Child())
+    assert ConstructorStats.detail_reg_inst() == n_inst + 4
+    del p
+    pytest.gc_collect()
+    assert ConstructorStats.detail_reg_inst() == n_inst
+
+
+def test_keep_alive_non_pybind11_nurse():
+    class Nurse:
+        pass
+
+    n_inst = ConstructorStats.detail_reg_inst()
+    nurse = Nurse()
+    m.keep_alive_object(nurse, m.Child())
+    m.keep_alive_object(nurse, m.Child())
+    assert ConstructorStats.detail_reg_inst() == n_inst + 2
+    del nurse
+    pytest.gc_collect()
+    assert ConstructorStats.detail_reg_inst() == n_inst
+
+
 def test_alive_gc(capture):
     n_inst = ConstructorStats.detail_reg_inst()
     p = m.ParentGC()
@@ -75,6 +75,21 @@ TEST_SUBMODULE(callbacks, m) {
         return f(**kwargs, "x"_a = 1); // duplicate keyword after **
     });
 
+    m.def("test_duplicate_keywords", [](const py::function &f) {
+        return f("x"_a = 1, "x"_a = 2); // duplicate keyword without unpacking
+    });
+
+    m.def("test_keyword_names", [](const py::function &f, const std::string &name) {
+        // The same argument types with different keyword names
+        return f(py::arg(name.c_str()) = 1);
+    });
+
+    m.def("test_method_call", [](const py::object &obj) {
+        return py::make_tuple(obj.attr("method")(1, "y"_a = 2),
+                              obj.attr(py::str("method"))(3),
+                              obj.attr("attribute")(4));
+    });
+
     m.def("test_arg_conversion_error1",
           [](const py::function &f) { f(234, UnregisteredType(), "kw"_a = 567); });
 
@@ -209,6 +224,41 @@ TEST_SUBMODULE(callbacks, m) {
         .def(py::init<>())
         .def("triple", [](CppBoundMethodTest &, int val) { return 3 * val; });
 
+    // test_direct_cpp_callbacks
+    struct DirectCallError {};
+    struct CppCallbackTarget {
+        int calls = 0;
+    };
+    py::class_<CppCallbackTarget>(m, "CppCallbackTarget")
+        .def(py::init<>())
+        .def_readonly("calls", &CppCallbackTarget::calls)
+        .def("append",
+             [](CppCallbackTarget &self, int i, const std::string &s) {
+                 ++self.calls;
+                 return s + std::to_string(i);
+             })
+        .def("add", [](CppCallbackTarget &, int i, int j) { return std::to_string(i + j); })
+        .def("fail", [](CppCallbackTarget &, int) -> int { throw DirectCallError(); })
+        .def("count_then_fail",
+             [](CppCallbackTarget &self, int, const std::string &) -> std::string {
+                 ++self.calls;
+                 throw py::reference_cast_error();
+             });
+    m.def("call_twice", [](const std::function<std::string(int, std::string)> &f) {
+        return f(1, "a") + f(2, "b");
+    });
+    // A C++ exception only reaches the caller as such when the call does not go through Python
+    m.def("how_callback_throws", [](const std::function<int(int)> &f) -> std::string {
+        try {
+            f(1);
+        } catch (const DirectCallError &) {
+            return "directly";
+        } catch (const py::error_already_set &) {
+            return "through Python";
+        }
+        return "not at all";
+    });
+
     // This checks that builtin functions can be passed as callbacks
     // rather than throwing RuntimeError due to trying to extract as capsule
     m.def("test_sum_builtin",
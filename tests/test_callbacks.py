@@ -45,6 +45,28 @@ def test_bound_method_callback():
     assert m.test_callback3(z.triple) == "func(43) = 129"
 
 
+def test_direct_cpp_callbacks():
+    # Bound methods of pybind11 classes are called straight from C++
+    target = m.CppCallbackTarget()
+    assert m.call_twice(target.append) == "a1b2"
+    assert target.calls == 2
+    assert m.how_callback_throws(target.fail) == "directly"
+    assert m.how_callback_throws(m.CppCallbackTarget.fail) == "through Python"
+    assert m.how_callback_throws(lambda x: x) == "not at all"
+
+    # Calls that do not match the function go through Python, which reports the error
+    with pytest.raises(TypeError) as excinfo:
+        m.call_twice(target.add)
+    assert "incompatible function arguments" in str(excinfo.value)
+
+    # A function called directly that throws a `reference_cast_error` itself reports the same
+    # error, without being called again through Python
+    target = m.CppCallbackTarget()
+    with pytest.raises(TypeError, match="incompatible function arguments"):
+        m.call_twice(target.count_then_fail)
+    assert target.calls == 1
+
+
 def test_keyword_args_and_generalized_unpacking():
     def f(*args, **kwargs):
         return args, kwargs
@@ -69,6 +91,28 @@ def test_keyword_args_and_generalized_unpacking():
         m.test_unpacking_error2(f)
     assert "Got multiple values for keyword argument" in str(excinfo.value)
 
+    with pytest.raises(TypeError) as excinfo:
+        m.test_duplicate_keywords(f)
+    assert "Got multiple values for keyword argument" in str(excinfo.value)
+
+    assert m.test_keyword_names(f, "a") == ((), {"a": 1})
+    assert m.test_keyword_names(f, "b") == ((), {"b": 1})
+    assert m.test_keyword_names(f, "b") == ((), {"b": 1})
+
+    class Methods:
+        def __init__(self):
+            self.attribute = lambda x: ("attribute", x)
+
+        def method(self, x, y=0):
+            return ("method", self, x, y)
+
+    obj = Methods()
+    assert m.test_method_call(obj) == (
+        ("method", obj, 1, 2),
+        ("method", obj, 3, 0),
+        ("attribute", 4),
+    )
+
     with pytest.raises(RuntimeError) as excinfo:
         m.test_arg_conversion_error1(f)
     assert str(excinfo.value) == "Unable to convert call argument " + (
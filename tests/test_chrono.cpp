@@ -8,11 +8,15 @@
     BSD-style license that can be found in the LICENSE file.
 */
 
-#include <pybind11/chrono.h>
+#include <pybind11/chrono_numpy.h>
+#include <pybind11/stl.h>
 
 #include "pybind11_tests.h"
 
+#include <algorithm>
 #include <chrono>
+#include <numeric>
+#include <vector>
 
 struct different_resolutions {
     using time_point_h = std::chrono::time_point<std::chrono::system_clock, std::chrono::hours>;
@@ -78,4 +82,48 @@ TEST_SUBMODULE(chrono, m) {
         .def_readwrite("timestamp_s", &different_resolutions::timestamp_s)
         .def_readwrite("timestamp_ms", &different_resolutions::timestamp_ms)
         .def_readwrite("timestamp_us", &different_resolutions::timestamp_us);
+
+    // test_utc_time_point
+    using utc_time = py::utc_time_point<std::chrono::microseconds>;
+    m.def("utc_roundtrip", [](utc_time t) { return t; });
+    m.def("utc_from_seconds", [](int64_t s) {
+        return utc_time(utc_time::time_point(std::chrono::seconds(s)));
+    });
+    m.def("utc_to_seconds", [](utc_time t) {
+        return std::chrono::duration_cast<std::chrono::seconds>(t.time_since_epoch()).count();
+    });
+
+    // test_time_point_arrays
+    using timestamps = py::chrono_array<std::vector<timestamp>>;
+    m.def("time_points_roundtrip", [](const timestamps &v) { return v; });
+    m.def("time_points_from_nanoseconds", [](const std::vector<int64_t> &ns) {
+        std::vector<timestamp> result;
+        for (auto n : ns) {
+            result.emplace_back(timespan(n));
+        }
+        return py::as_chrono_array(std::move(result));
+    });
+    m.def("durations_total",
+          [](const py::chrono_array<std::vector<std::chrono::microseconds>> &v) {
+              return std::accumulate(v->begin(), v->end(), std::chrono::microseconds(0)).count();
+          });
+    m.def("durations_in_seconds", [](int64_t n) {
+        return py::as_chrono_array(
+            std::vector<std::chrono::seconds>(static_cast<size_t>(n), std::chrono::seconds(n)));
+    });
+    // Without py::chrono_array, vectors are still converted by stl.h
+    m.def("time_points_list", [](const std::vector<timestamp> &v) { return v; });
+    m.def("float_durations_roundtrip",
+          [](const std::vector<std::chrono::duration<double>> &v) { return v; });
+#if defined(PYBIND11_HAS_SPAN)
+    m.def("time_points_span_latest", [](py::chrono_array<std::span<const timestamp>> s) {
+        return std::max_element(s->begin(), s->end())->time_since_epoch().count();
+    });
+    m.def("durations_span_double",
+          [](py::chrono_array<std::span<std::chrono::microseconds>> s) {
+              for (auto &d : *s) {
+                  d *= 2;
+              }
+          });
+#endif
 }
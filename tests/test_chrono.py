@@ -203,3 +203,83 @@ def test_chrono_different_resolutions():
     resolutions.timestamp_s = time
     resolutions.timestamp_ms = time
     resolutions.timestamp_us = time
+
+
+def test_utc_time_point():
+    time = m.utc_from_seconds(86400 * 365 + 3661)
+    assert time == datetime.datetime(1971, 1, 1, 1, 1, 1, tzinfo=datetime.timezone.utc)
+    assert m.utc_from_seconds(-1) == datetime.datetime(
+        1969, 12, 31, 23, 59, 59, tzinfo=datetime.timezone.utc
+    )
+    assert m.utc_to_seconds(datetime.datetime(1970, 1, 2)) == 86400
+    assert m.utc_to_seconds(datetime.date(2000, 3, 1)) == 951868800
+    # Aware datetimes are converted to UTC
+    cet = datetime.timezone(datetime.timedelta(hours=1))
+    assert m.utc_to_seconds(datetime.datetime(1970, 1, 1, 1, tzinfo=cet)) == 0
+
+    now = datetime.datetime.now(datetime.timezone.utc)
+    assert m.utc_roundtrip(now) == now
+    assert m.utc_roundtrip(datetime.datetime(1, 1, 1)).year == 1
+    assert m.utc_roundtrip(datetime.datetime(9999, 12, 31)).year == 9999
+
+
+def test_time_point_lists():
+    # Plain vectors are still lists, and py::chrono_array loads any sequence
+    time = datetime.datetime(2024, 1, 1)
+    assert m.time_points_list([time]) == [time]
+    seconds = [datetime.timedelta(seconds=1.5), 2.0]
+    assert m.float_durations_roundtrip(seconds) == [
+        datetime.timedelta(seconds=1.5),
+        datetime.timedelta(seconds=2),
+    ]
+    assert m.durations_total(tuple(datetime.timedelta(microseconds=i) for i in range(4))) == 6
+    with pytest.raises(TypeError):
+        m.durations_total("123")
+
+
+def test_time_point_arrays():
+    np = pytest.importorskip("numpy")
+
+    times = m.time_points_from_nanoseconds([0, 1500, -1])
+    assert isinstance(times, np.ndarray)
+    assert times.dtype == np.dtype("M8[ns]")
+    assert times.tolist() == [0, 1500, -1]
+
+    times = np.array(["2024-01-01T00:00:00.000000001", "1969-07-20T20:17"], dtype="M8[ns]")
+    np.testing.assert_array_equal(m.time_points_roundtrip(times), times)
+    # Coarser units are converted, without losing precision
+    days = np.array(["2024-01-01", "2024-02-29"], dtype="M8[D]")
+    np.testing.assert_array_equal(m.time_points_roundtrip(days), days.astype("M8[ns]"))
+    # Lists of datetimes are still converted element by element
+    assert m.time_points_roundtrip([datetime.datetime(2024, 1, 1)]).dtype == times.dtype
+
+    durations = np.array([1, 2, 3], dtype="m8[us]")
+    assert m.durations_total(durations) == 6
+    assert m.durations_total(np.array([1, 2], dtype="m8[s]")) == 3000000
+    assert m.durations_total([datetime.timedelta(microseconds=5)]) == 5
+    with pytest.raises(TypeError):
+        m.durations_total(np.array([1], dtype="m8[ns]"))
+    with pytest.raises(TypeError):
+        m.durations_total(np.zeros((2, 2), dtype="m8[us]"))
+
+    seconds = m.durations_in_seconds(3)
+    assert seconds.dtype == np.dtype("m8[s]")
+    assert seconds.tolist() == [datetime.timedelta(seconds=3)] * 3
+    assert m.durations_in_seconds(0).shape == (0,)
+
+
+@pytest.mark.skipif(not hasattr(m, "time_points_span_latest"), reason="no <span>")
+def test_time_point_spans():
+    np = pytest.importorskip("numpy")
+
+    times = np.array([5, 9, 2], dtype="M8[ns]")
+    assert m.time_points_span_latest(times) == 9
+    with pytest.raises(TypeError):
+        m.time_points_span_latest(times.astype("M8[us]"))
+
+    durations = np.array([1, 2], dtype="m8[us]")
+    m.durations_span_double(durations)
+    assert durations.tolist() == [datetime.timedelta(microseconds=2)] * 2
+    durations.flags.writeable = False
+    with pytest.raises(TypeError):
+        m.durations_span_double(durations)
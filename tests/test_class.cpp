@@ -20,6 +20,7 @@
 #include "local_bindings.h"
 #include "pybind11_tests.h"
 
+#include <stdexcept>
 #include <utility>
 
 PYBIND11_WARNING_DISABLE_MSVC(4324)
@@ -170,6 +171,13 @@ TEST_SUBMODULE(class_, m) {
     });
     m.def("return_none", []() -> BaseClass * { return nullptr; });
 
+    // A derived class that is only registered after it was returned through a base pointer
+    struct DerivedClass3 : BaseClass {};
+    m.def("return_class_3", []() -> BaseClass * { return new DerivedClass3(); });
+    m.def("register_class_3", [](py::module_ scope) {
+        py::class_<DerivedClass3>(scope, "DerivedClass3").def(py::init<>());
+    });
+
     // test_isinstance
     m.def("check_instances", [](const py::list &l) {
         return py::make_tuple(py::isinstance<py::tuple>(l[0]),
@@ -238,6 +246,9 @@ TEST_SUBMODULE(class_, m) {
         .def_static("make", &MyDerived::make)
         .def_static("make2", &MyDerived::make);
 
+    // test_memory_stats
+    m.def("memory_stats", &py::memory_stats);
+
     // test_implicit_conversion_life_support
     struct ConvertibleFromUserType {
         int i;
@@ -256,6 +267,18 @@ TEST_SUBMODULE(class_, m) {
         const auto &r = o.cast<const ConvertibleFromUserType &>();
         return r.i;
     });
+    m.def("implicitly_convert_list", [](const py::list &l) {
+        // More temporaries than fit inline in the life support frame
+        std::vector<const ConvertibleFromUserType *> converted;
+        for (auto item : l) {
+            converted.push_back(&item.cast<const ConvertibleFromUserType &>());
+        }
+        int sum = 0;
+        for (const auto *r : converted) {
+            sum += r->i;
+        }
+        return sum;
+    });
     m.add_object("implicitly_convert_variable_fail", [&] {
         auto f = [](PyObject *, PyObject *args) -> PyObject * {
             auto o = py::reinterpret_borrow<py::tuple>(args)[0];
@@ -480,6 +503,9 @@ TEST_SUBMODULE(class_, m) {
           [](const StringWrapper &) -> NotRegistered { return {}; });
     py::class_<StringWrapper>(m, "StringWrapper").def(py::init<std::string>());
     py::implicitly_convertible<std::string, StringWrapper>();
+    // The signature in the error message is generated while the cast error is pending
+    m.def(
+        "return_not_registered", [](int) -> NotRegistered { return {}; }, py::arg("x") = 1);
 
 #if defined(PYBIND11_CPP17)
     struct alignas(1024) Aligned {
@@ -515,6 +541,135 @@ TEST_SUBMODULE(class_, m) {
     struct Empty {};
     py::class_<Empty>(m, "Empty").def(py::init<>());
 
+    // test_many_registered_instances
+    m.def(
+        "same_empty", [](Empty *e) { return e; }, py::return_value_policy::reference);
+
+    // test_no_instance_registry, test_inline_storage
+    m.attr("PYBIND11_INTERNALS_VERSION") = PYBIND11_INTERNALS_VERSION;
+
+    // test_no_instance_registry
+    struct NoRegistry {
+        int value = 0;
+    };
+    static NoRegistry noRegistry;
+    py::class_<NoRegistry>(m, "NoRegistry", py::no_instance_registry())
+        .def(py::init<>())
+        .def_readwrite("value", &NoRegistry::value);
+    m.def(
+        "same_no_registry",
+        [](NoRegistry *r) { return r; },
+        py::return_value_policy::reference);
+    m.def(
+        "static_no_registry", []() { return &noRegistry; }, py::return_value_policy::reference);
+
+    // test_no_gc
+    struct NoGC {
+        int value = 0;
+    };
+    py::class_<NoGC>(m, "NoGC", py::no_gc()).def(py::init<>());
+    m.def("no_gc_dynamic_attr", []() {
+        struct NoGCDynamicAttr {};
+        auto mod = py::module_::import("__main__");
+        py::class_<NoGCDynamicAttr>(mod, "NoGCDynamicAttr", py::no_gc(), py::dynamic_attr());
+    });
+
+    // test_slots
+    struct Slotted {
+        int value = 0;
+    };
+    struct SlottedDerived : Slotted {};
+    struct SlottedInline {
+        int value = 0;
+    };
+    py::class_<Slotted>(m, "Slotted", py::slots({"tag", "weight"}))
+        .def(py::init<>())
+        .def_readwrite("value", &Slotted::value);
+    py::class_<SlottedDerived, Slotted>(m, "SlottedDerived", py::slots({"extra"}))
+        .def(py::init<>());
+    py::class_<SlottedInline>(m, "SlottedInline", py::inline_storage(), py::slots({"tag"}))
+        .def(py::init<>())
+        .def_readwrite("value", &SlottedInline::value);
+
+    // test_inline_storage
+    struct InlineStored {
+        explicit InlineStored(int v) : value(std::to_string(v)) { ++alive(); }
+        InlineStored(const InlineStored &other) : value(other.value) { ++alive(); }
+        InlineStored(InlineStored &&other) noexcept : value(std::move(other.value)) { ++alive(); }
+        ~InlineStored() { --alive(); }
+        static int &alive() {
+            static int count = 0;
+            return count;
+        }
+        std::string value;
+    };
+    struct InlineStoredDerived : InlineStored {
+        using InlineStored::InlineStored;
+        int extra = 1;
+    };
+    py::class_<InlineStored>(m, "InlineStored", py::inline_storage())
+        .def(py::init<int>())
+        .def(py::init([](const std::string &value) {
+            InlineStored s(0);
+            s.value = value;
+            return s;
+        }))
+        .def(py::init_inplace([](void *mem, int a, int b) { new (mem) InlineStored(a + b); }))
+        .def_readwrite("value", &InlineStored::value)
+        .def("stored_inline", [](py::handle self) {
+            auto *inst = reinterpret_cast<py::detail::instance *>(self.ptr());
+            auto v_h = inst->get_value_and_holder(py::detail::get_type_info(typeid(InlineStored)));
+            return v_h.value_ptr() == py::detail::inline_value_ptr(inst, v_h.type);
+        });
+    py::class_<InlineStoredDerived, InlineStored>(m, "InlineStoredDerived")
+        .def(py::init<int>())
+        .def(py::init_inplace([](void *mem, int a, int b) {
+            if (a < 0) {
+                throw std::invalid_argument("negative a");
+            }
+            new (mem) InlineStoredDerived(a * b);
+        }))
+        .def_readwrite("extra", &InlineStoredDerived::extra);
+    m.def("make_inline_stored", [](int v) { return InlineStored(v); });
+    m.def("copy_inline_stored", [](const InlineStored &s) { return s; });
+    m.def("inline_stored_alive", []() { return InlineStored::alive(); });
+
+    // test_fast_init
+    struct FastPoint {
+        FastPoint(double x, double y) : x(x), y(y) {
+            if (x < 0) {
+                throw std::invalid_argument("negative x");
+            }
+        }
+        double x, y;
+    };
+    py::class_<FastPoint>(m, "FastPoint", py::is_final())
+        .def(py::init<double, double>(), py::fast_init(), py::arg("x"), py::arg("y"))
+        .def_readonly("x", &FastPoint::x)
+        .def_readonly("y", &FastPoint::y);
+    struct FastOverloaded {
+        int value;
+    };
+    py::class_<FastOverloaded>(m, "FastOverloaded", py::is_final())
+        .def(py::init<int>(), py::fast_init())
+        .def(py::init([](const std::string &s) { return FastOverloaded{std::stoi(s)}; }))
+        .def_readonly("value", &FastOverloaded::value);
+    m.def("has_fast_init", [](const py::type &type) {
+#if defined(PYBIND11_HAS_VECTORCALL)
+        return ((PyTypeObject *) type.ptr())->tp_vectorcall != nullptr;
+#else
+        (void) type;
+        return false;
+#endif
+    });
+    m.def("vectorcall_supported", []() {
+#if defined(PYBIND11_HAS_VECTORCALL)
+        return true;
+#else
+        return false;
+#endif
+    });
+
     // test_base_and_derived_nested_scope
     struct BaseWithNested {
         struct Nested {};
@@ -555,6 +710,12 @@ TEST_SUBMODULE(class_, m) {
     });
 
     test_class::pr4220_tripped_over_this::bind_empty0(m);
+
+    // test_signature_names_later_class
+    struct BoundLater {};
+    m.def("takes_bound_later", [](const BoundLater &) {});
+    m.def("takes_bound_later", [](const BoundLater &, int) {});
+    py::class_<BoundLater>(m, "BoundLater");
 }
 
 template <int N>
@@ -1,3 +1,6 @@
+import gc
+import weakref
+
 import pytest
 
 import env
@@ -217,6 +220,14 @@ def test_automatic_upcasting():
     assert type(m.return_class_n(1)).__name__ == "DerivedClass1"
 
 
+def test_automatic_upcasting_late_registration():
+    assert type(m.return_class_3()).__name__ == "BaseClass"
+    assert type(m.return_class_3()).__name__ == "BaseClass"
+    m.register_class_3(m)
+    assert type(m.return_class_3()).__name__ == "DerivedClass3"
+    assert type(m.return_class_n(1)).__name__ == "DerivedClass1"
+
+
 def test_isinstance():
     objects = [(), {}, m.Pet("Polly", "parrot")] + [m.Dog("Molly")] * 4
     expected = (True, True, True, True, True, False, False)
@@ -254,10 +265,27 @@ def test_override_static():
     assert isinstance(d2, m.MyDerived)
 
 
+def test_memory_stats():
+    stats = m.memory_stats()
+    assert stats["registered_types_py"]["size"] > 0
+    assert stats["registered_types_cpp"]["size"] > 0
+    assert stats["function_records"]["size"] > 0
+    assert stats["function_records"]["bytes"] > 0
+    assert stats["docstrings"]["bytes"] > 0
+
+    instances = stats["registered_instances"]["size"]
+    objects = [UserType(i) for i in range(10)]
+    assert m.memory_stats()["registered_instances"]["size"] == instances + 10
+    del objects
+    pytest.gc_collect()
+    assert m.memory_stats()["registered_instances"]["size"] == instances
+
+
 def test_implicit_conversion_life_support():
     """Ensure the lifetime of temporary objects created for implicit conversions"""
     assert m.implicitly_convert_argument(UserType(5)) == 5
     assert m.implicitly_convert_variable(UserType(5)) == 5
+    assert m.implicitly_convert_list([UserType(i) for i in range(100)]) == sum(range(100))
 
     assert "outside a bound function" in m.implicitly_convert_variable_fail(UserType(5))
 
@@ -389,6 +417,13 @@ def test_error_after_conversions():
     )
 
 
+def test_return_value_error_signature():
+    with pytest.raises(TypeError) as exc_info:
+        m.return_not_registered()
+    assert "(x: int = 1) -> " in str(exc_info.value)
+    assert "Unregistered type" in str(exc_info.value.__cause__)
+
+
 def test_aligned():
     if hasattr(m, "Aligned"):
         p = m.Aligned().ptr()
@@ -438,6 +473,209 @@ def test_multiple_instances_with_same_pointer():
     # and just completes without crashing, we're good.
 
 
+def test_many_registered_instances():
+    n = 2000
+    instances = [m.Empty() for _ in range(n)]
+    assert all(m.same_empty(e) is e for e in instances)
+    # Unregister every other one (mixing up the entries of the instance registry)
+    del instances[::2]
+    assert all(m.same_empty(e) is e for e in instances)
+    instances += [m.Empty() for _ in range(n)]
+    assert all(m.same_empty(e) is e for e in instances)
+
+
+def test_no_instance_registry():
+    # The annotation is ignored with older internals versions
+    registered = m.PYBIND11_INTERNALS_VERSION <= 5
+    n_inst = ConstructorStats.detail_reg_inst()
+    instances = [m.NoRegistry() for _ in range(10)]
+    assert ConstructorStats.detail_reg_inst() == n_inst + (10 if registered else 0)
+
+    # Without the registry, the same C++ object is wrapped by a new Python object every time
+    obj = instances[0]
+    obj.value = 42
+    other = m.same_no_registry(obj)
+    assert (other is obj) == registered
+    assert other.value == 42
+    static = m.static_no_registry()
+    assert (m.static_no_registry() is static) == registered
+    m.static_no_registry().value = 7
+    assert m.static_no_registry().value == 7
+
+    del instances, obj, other, static
+    assert ConstructorStats.detail_reg_inst() == n_inst
+
+
+@pytest.mark.skipif("env.PYPY", reason="PyPy has no gc.is_tracked()")
+def test_no_gc():
+    assert not gc.is_tracked(m.NoGC())
+
+    # Python subclasses have a __dict__ and are garbage collected as usual
+    class PyNoGC(m.NoGC):
+        pass
+
+    assert gc.is_tracked(PyNoGC())
+
+    with pytest.raises(RuntimeError) as excinfo:
+        m.no_gc_dynamic_attr()
+    assert 'type "NoGCDynamicAttr" has a __dict__' in str(excinfo.value)
+
+
+def test_slots():
+    s = m.Slotted()
+    assert not hasattr(s, "__dict__")
+    with pytest.raises(AttributeError):
+        s.tag  # noqa: B018
+    s.tag = "a"
+    s.weight = 1.5
+    s.value = 3
+    assert (s.tag, s.weight, s.value) == ("a", 1.5, 3)
+    del s.tag
+    assert not hasattr(s, "tag")
+    with pytest.raises(AttributeError):
+        s.other = 1
+
+    d = m.SlottedDerived()
+    d.tag, d.extra, d.value = "b", "c", 4
+    assert (d.tag, d.extra, d.value) == ("b", "c", 4)
+    i = m.SlottedInline()
+    i.tag, i.value = "d", 5
+    assert (i.tag, i.value) == ("d", 5)
+
+    class PySlotted(m.Slotted):
+        pass
+
+    p = PySlotted()
+    p.tag, p.other = "e", "f"
+    assert (p.tag, p.other) == ("e", "f")
+
+    # The values are released with the instance, and cycles through them are collected
+    class Value:
+        pass
+
+    holder = m.Slotted()
+    value = Value()
+    ref = weakref.ref(value)
+    holder.weight = value
+    del value, holder
+    assert ref() is None
+
+    cycle = m.SlottedDerived()
+    cycle.extra = cycle
+    ref = weakref.ref(cycle)
+    del cycle
+    gc.collect()
+    assert ref() is None
+
+    # The slots of a Python subclass are visited by Python, and only those of the bound classes
+    # by pybind11
+    class PyOwnSlots(m.SlottedDerived):
+        __slots__ = ("own",)
+
+    cycle = PyOwnSlots()
+    cycle.own, cycle.tag, cycle.extra = cycle, cycle, Value()
+    ref = weakref.ref(cycle)
+    extra_ref = weakref.ref(cycle.extra)
+    del cycle
+    gc.collect()
+    assert ref() is None
+    assert extra_ref() is None
+
+
+def test_inline_storage():
+    # The annotation is ignored with older internals versions
+    inline = m.PYBIND11_INTERNALS_VERSION > 5
+    alive = m.inline_stored_alive()
+    a = m.InlineStored(1)
+    assert a.stored_inline() == inline
+    b = m.make_inline_stored(2)
+    assert b.stored_inline() == inline
+    c = m.copy_inline_stored(b)
+    assert c.stored_inline() == inline
+    assert c.value == "2"
+    a.value = "changed"
+    assert a.value == "changed"
+    assert m.inline_stored_alive() == alive + 3
+
+    class PyInlineStored(m.InlineStored):
+        def __init__(self):
+            super().__init__(5)
+            self.extra = 3
+
+    d = PyInlineStored()
+    assert d.stored_inline() == inline
+    assert d.value == "5"
+    assert d.extra == 3
+    e = m.InlineStoredDerived(6)
+    assert e.value == "6"
+    assert e.extra == 1
+    assert m.inline_stored_alive() == alive + 5
+
+    # Factories returning by value and in-place factories construct inside the instance too
+    f = m.InlineStored("factory")
+    assert f.stored_inline() == inline
+    assert f.value == "factory"
+    g = m.InlineStored(2, 3)
+    assert g.stored_inline() == inline
+    assert g.value == "5"
+    # Without inline storage, in-place factories construct in memory that the holder frees
+    h = m.InlineStoredDerived(2, 3)
+    assert h.value == "6"
+    assert h.extra == 1
+    with pytest.raises(ValueError, match="^negative a$"):
+        m.InlineStoredDerived(-2, 3)
+    assert m.inline_stored_alive() == alive + 8
+
+    del a, b, c, d, e, f, g, h
+    pytest.gc_collect()
+    assert m.inline_stored_alive() == alive
+
+
+def test_fast_init():
+    assert m.has_fast_init(m.FastPoint) == m.vectorcall_supported()
+    assert not m.has_fast_init(m.FastOverloaded)
+    assert not m.has_fast_init(m.InlineStored)
+
+    n_inst = ConstructorStats.detail_reg_inst()
+    p = m.FastPoint(1, 2.5)
+    assert (p.x, p.y) == (1.0, 2.5)
+    assert ConstructorStats.detail_reg_inst() == n_inst + 1
+    # Keyword arguments and conversion errors go through the usual dispatcher
+    p = m.FastPoint(3, y=4)
+    assert (p.x, p.y) == (3.0, 4.0)
+    with pytest.raises(TypeError) as excinfo:
+        m.FastPoint("a", 2)
+    assert "__init__(): incompatible constructor arguments" in str(excinfo.value)
+    with pytest.raises(TypeError):
+        m.FastPoint(1)
+    with pytest.raises(ValueError) as excinfo:
+        m.FastPoint(-1, 2)
+    assert str(excinfo.value) == "negative x"
+    del p
+    assert ConstructorStats.detail_reg_inst() == n_inst
+
+    assert m.FastOverloaded(3).value == 3
+    assert m.FastOverloaded("4").value == 4
+
+
+def test_recycled_instances():
+    # Destroyed instances are pooled for reuse, which must not leak any of their state
+    alive = m.inline_stored_alive()
+    for i in range(100):
+        a = m.InlineStored(i)
+        assert a.value == str(i)
+        r = weakref.ref(a)
+        a.value = "x"
+        del a
+        assert r() is None
+    b = [m.InlineStored(i) for i in range(100)]
+    assert len({id(x) for x in b}) == 100
+    assert [x.value for x in b] == [str(i) for i in range(100)]
+    del b
+    pytest.gc_collect()
+    assert m.inline_stored_alive() == alive
+
+
 # https://github.com/pybind/pybind11/issues/1624
 def test_base_and_derived_nested_scope():
     assert issubclass(m.DerivedWithNested, m.BaseWithNested)
@@ -483,3 +721,16 @@ def test_pr4220_tripped_over_this():
         m.Empty0().get_msg()
         == "This is really only meant to exercise successful compilation."
     )
+
+
+def test_signature_names_later_class():
+    # Docstrings are generated when the module is initialized, so the class bound after the
+    # function is named as in Python
+    assert m.takes_bound_later.__doc__ == (
+        "takes_bound_later(*args, **kwargs)\n"
+        "Overloaded function.\n"
+        "\n"
+        "1. takes_bound_later(arg0: pybind11_tests.class_.BoundLater) -> None\n"
+        "\n"
+        "2. takes_bound_later(arg0: pybind11_tests.class_.BoundLater, arg1: int) -> None\n"
+    )
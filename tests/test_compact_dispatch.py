@@ -0,0 +1,40 @@
+import pytest
+
+import pybind11_compact_dispatch_tests as m
+
+
+def test_builtin_arguments():
+    assert m.add(1, 2) == 3
+    assert m.greet("Alice") == "Hello Alice! "
+    assert m.greet("Bob", times=2) == "Hello Bob! Hello Bob! "
+    with pytest.raises(TypeError, match="incompatible function arguments"):
+        m.add(1, "2")
+
+
+def test_overloads():
+    assert m.overloaded(1) == "int"
+    # The int overload fails without conversion, and is passed over in the first pass
+    assert m.overloaded(1.5) == "float"
+    assert m.overloaded("x") == "str"
+
+
+def test_class_arguments():
+    # Loaded by the shared loader of bound classes, including a subclass and an implicit
+    # conversion
+    assert m.ages(m.Pet(1), m.Dog(2), m.Pet(3)) == [1, 2, 3]
+    assert m.ages(4, None, m.Dog(5)) == [4, -1, 5]
+    with pytest.raises(TypeError):
+        m.ages(m.Pet(1), m.Pet(2), "3")
+    assert m.total_age([m.Pet(1), m.Dog(2)]) == 3
+
+    owner = m.Owner()
+    assert owner.pet_age() == -1
+    owner.adopt(7)
+    assert owner.pet_age() == 7
+    with pytest.raises(TypeError):
+        m.Owner.pet_age(m.Pet(1))
+
+
+def test_args_and_kwargs():
+    assert m.count_args(1) == 1
+    assert m.count_args(1, 2, 3, a=4) == 4
@@ -149,6 +149,15 @@ TEST_SUBMODULE(constants_and_functions, m) {
             py::arg_v("z", default_value));
     });
 
+    // test_function_record_reuse
+    m.def("make_adders", [](int count) {
+        py::list adders;
+        for (int i = 0; i < count; ++i) {
+            adders.append(py::cpp_function([i](int x) { return x + i; }, py::arg("x")));
+        }
+        return adders;
+    });
+
     // test noexcept(true) lambda (#4565)
     m.def("l1", []() noexcept(true) { return 0; });
 }
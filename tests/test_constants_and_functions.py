@@ -52,5 +52,15 @@ def test_function_record_leaks():
         m.register_with_raising_repr(m, RaisingRepr())
 
 
+def test_function_record_reuse():
+    # More functions than fit in a block of records, freed and then created again
+    for _ in range(3):
+        adders = m.make_adders(150)
+        assert [f(1) for f in adders] == list(range(1, 151))
+        assert adders[7].__doc__.startswith("(x: int) -> int")
+        del adders
+        pytest.gc_collect()
+
+
 def test_noexcept_lambda():
     assert m.l1() == 0
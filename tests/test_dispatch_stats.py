@@ -0,0 +1,53 @@
+import pytest
+
+import pybind11_dispatch_stats_tests as m
+
+pytestmark = pytest.mark.skipif(
+    not hasattr(m, "dispatch_stats"), reason="PYBIND11_DISPATCH_STATS is not supported"
+)
+
+ADD = "pybind11_dispatch_stats_tests.add(arg0: int, arg1: int) -> int"
+OVERLOADED_INT = "pybind11_dispatch_stats_tests.overloaded(arg0: int) -> str"
+OVERLOADED_FLOAT = "pybind11_dispatch_stats_tests.overloaded(arg0: float) -> str"
+
+
+def test_dispatch_stats():
+    m.enable_dispatch_stats()
+    m.reset_dispatch_stats()
+    for _ in range(3):
+        assert m.add(1, 2) == 3
+    assert m.overloaded(1.5) == "float"
+    assert m.overloaded(1) == "int"
+    m.enable_dispatch_stats(False)
+    assert m.add(1, 2) == 3
+
+    stats = m.dispatch_stats()
+    assert stats[ADD]["calls"] == 3
+    assert stats[ADD]["overload_misses"] == 0
+    assert stats[ADD]["load_time"] >= 0
+    assert stats[ADD]["call_time"] >= 0
+    # The int overload is tried first and can not load a float without conversion
+    assert stats[OVERLOADED_INT]["calls"] == 1
+    assert stats[OVERLOADED_INT]["overload_misses"] == 1
+    assert stats[OVERLOADED_FLOAT]["calls"] == 1
+    assert stats[OVERLOADED_FLOAT]["conversion_passes"] == 0
+
+    m.reset_dispatch_stats()
+    assert ADD not in m.dispatch_stats()
+
+
+def test_dispatch_stats_hook():
+    # The hook that `pybind11.detail.dispatch_stats()` calls in every module
+    hook = m.__pybind11_dispatch_stats__
+    hook(True, reset=True)
+    m.add(2, 3)
+    assert hook(False)[ADD]["calls"] == 1
+    assert hook(reset=True) == {}
+
+    detail = pytest.importorskip("pybind11.detail")
+    detail.enable_dispatch_stats()
+    m.add(2, 3)
+    detail.enable_dispatch_stats(False)
+    assert detail.dispatch_stats()[ADD]["calls"] == 1
+    detail.reset_dispatch_stats()
+    assert ADD not in detail.dispatch_stats()
@@ -339,6 +339,35 @@ TEST_SUBMODULE(eigen_matrix, m) {
           [mat]() -> SparseMatrixC { return Eigen::SparseView<Eigen::MatrixXf>(mat); });
     m.def("sparse_copy_r", [](const SparseMatrixR &m) -> SparseMatrixR { return m; });
     m.def("sparse_copy_c", [](const SparseMatrixC &m) -> SparseMatrixC { return m; });
+    // test_sparse_zero_copy
+    struct SparseHolder {
+        SparseMatrixR mat;
+    };
+    py::class_<SparseHolder>(m, "SparseHolder")
+        .def(py::init([mat]() {
+            return SparseHolder{SparseMatrixR(Eigen::SparseView<Eigen::MatrixXf>(mat))};
+        }))
+        .def(
+            "mat",
+            [](SparseHolder &h) -> SparseMatrixR & { return h.mat; },
+            py::return_value_policy::reference_internal)
+        .def_readonly("const_mat", &SparseHolder::mat)
+        .def(
+            "mat_copy",
+            [](const SparseHolder &h) -> const SparseMatrixR & { return h.mat; },
+            py::return_value_policy::copy)
+        .def("sum", [](const SparseHolder &h) { return h.mat.sum(); });
+    m.def("sparse_map_sum", [](const Eigen::Map<const SparseMatrixR> &m) { return m.sum(); });
+    m.def("sparse_map_scale", [](Eigen::Map<SparseMatrixR> m, float factor) {
+        for (Eigen::Index i = 0; i < m.nonZeros(); ++i) {
+            m.valuePtr()[i] *= factor;
+        }
+    });
+    m.def(
+        "sparse_map_view",
+        [](const Eigen::Map<SparseMatrixC> &m) { return m; },
+        py::keep_alive<0, 1>());
+
     // test_partially_fixed
     m.def("partial_copy_four_rm_r", [](const FourRowMatrixR &m) -> FourRowMatrixR { return m; });
     m.def("partial_copy_four_rm_c", [](const FourColMatrixR &m) -> FourColMatrixR { return m; });
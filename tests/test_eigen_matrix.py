@@ -43,6 +43,18 @@ def test_dense():
     assert_equal_ref(m.dense_copy_c(m.dense_r()))
 
 
+def test_large_copies():
+    # Copies of more than a megabyte are made with the GIL released
+    a = np.arange(2048 * 1024, dtype=np.float32).reshape(2048, 1024)
+    for src in (a, a.T, np.asfortranarray(a), a[::2, ::2], a[::-1]):
+        np.testing.assert_array_equal(m.dense_copy_r(src), src)
+        np.testing.assert_array_equal(m.dense_copy_c(src), src)
+    np.testing.assert_array_equal(m.dense_copy_r(a.astype(np.float64)), a)
+    v = a.ravel()
+    np.testing.assert_array_equal(m.double_col(v[::2]), 2 * v[::2])
+    np.testing.assert_array_equal(m.double_row(v[::2]), 2 * v[::2])
+
+
 def test_partially_fixed():
     ref2 = np.array([[0.0, 1, 2, 3], [4, 5, 6, 7], [8, 9, 10, 11], [12, 13, 14, 15]])
     np.testing.assert_array_equal(m.partial_copy_four_rm_r(ref2), ref2)
@@ -747,6 +759,41 @@ def test_sparse():
     assert_sparse_equal_ref(m.sparse_copy_c(m.sparse_r()))
 
 
+def test_sparse_zero_copy():
+    pytest.importorskip("scipy")
+    holder = m.SparseHolder()
+    total = holder.sum()
+
+    # reference_internal views the matrix held in C++; copies do not
+    view = holder.mat()
+    assert_sparse_equal_ref(view)
+    view.data[:] *= 2
+    assert holder.sum() == 2 * total
+    const_view = holder.const_mat
+    assert np.shares_memory(const_view.data, view.data)
+    assert not const_view.data.flags.writeable
+    copy = holder.mat_copy()
+    copy.data[:] = 0
+    assert holder.sum() == 2 * total
+
+    # Maps of matching SciPy matrices write through to them
+    mat = m.sparse_r()
+    m.sparse_map_scale(mat, 0.5)
+    np.testing.assert_array_equal(mat.toarray(), ref / 2)
+    assert m.sparse_map_sum(mat) == ref.sum() / 2
+    for other in [mat.astype(np.float64), mat.tocsc(), ref]:
+        with pytest.raises(TypeError):
+            m.sparse_map_scale(other, 2.0)
+    # ... while maps of const matrices convert
+    assert m.sparse_map_sum(ref) == ref.sum()
+    assert m.sparse_map_sum(mat.astype(np.float64)) == ref.sum() / 2
+
+    csc = m.sparse_c()
+    csc_view = m.sparse_map_view(csc)
+    assert np.shares_memory(csc_view.data, csc.data)
+    assert_sparse_equal_ref(csc_view)
+
+
 def test_sparse_signature(doc):
     pytest.importorskip("scipy")
     assert (
@@ -7,6 +7,9 @@
 
 #include <pybind11/eigen/tensor.h>
 
+#include <cstdint>
+#include <utility>
+
 PYBIND11_NAMESPACE_BEGIN(eigen_tensor_test)
 
 namespace py = pybind11;
@@ -141,6 +144,19 @@ void init_tensor_module(pybind11::module &m) {
         []() -> Eigen::Tensor<double, 3, Options> { return get_tensor<Options>(); },
         py::return_value_policy::move);
 
+    m.def(
+        "move_const_tensor_copy",
+        // NOLINTNEXTLINE(readability-const-return-type)
+        []() -> const Eigen::Tensor<double, 3, Options> { return get_tensor<Options>(); });
+
+    // Returns the moved tensor along with the address of its storage, which the resulting
+    // array should share instead of copying.
+    m.def("move_tensor_zero_copy", []() {
+        Eigen::Tensor<double, 3, Options> tensor = get_tensor<Options>();
+        auto address = reinterpret_cast<std::uintptr_t>(tensor.data());
+        return std::make_pair(std::move(tensor), address);
+    });
+
     m.def(
         "move_const_tensor",
         []() -> const Eigen::Tensor<double, 3, Options> & { return get_const_tensor<Options>(); },
@@ -106,6 +106,18 @@ def test_convert_tensor_to_py(m, func_name):
     assert_equal_tensor_ref(getattr(m, func_name)(), writeable=writeable)
 
 
+@pytest.mark.parametrize("m", submodules)
+def test_move_tensor_to_py(m):
+    arr = m.move_const_tensor_copy()
+    assert_equal_tensor_ref(arr)
+    assert not arr.flags.owndata
+
+    arr, address = m.move_tensor_zero_copy()
+    assert_equal_tensor_ref(arr)
+    assert not arr.flags.owndata
+    assert arr.__array_interface__["data"][0] == address
+
+
 @pytest.mark.parametrize("m", submodules)
 def test_bad_cpp_to_python_casts(m):
     with pytest.raises(
@@ -1,4 +1,10 @@
 #include <pybind11/embed.h>
+#include <pybind11/operators.h>
+
+#ifndef PYBIND11_HAS_FILESYSTEM_IS_OPTIONAL
+#    define PYBIND11_HAS_FILESYSTEM_IS_OPTIONAL
+#endif
+#include <pybind11/stl/filesystem.h>
 
 // Silence MSVC C++17 deprecation warning from Catch regarding std::uncaught_exceptions (up to
 // catch 2.0.1; this should be fixed in the next catch release after 2.0.1).
@@ -71,8 +77,71 @@ PYBIND11_EMBEDDED_MODULE(trampoline_module, m) {
         .def("func", &test_override_cache_helper::func);
 }
 
+struct NativeMembers {
+    int value = 1;
+    static int shared;
+};
+int NativeMembers::shared = 2;
+
+PYBIND11_EMBEDDED_MODULE(native_member_module, m) {
+    py::class_<NativeMembers>(m, "NativeMembers")
+        .def(py::init<>())
+        .def_readwrite("value", &NativeMembers::value, py::native_member())
+        .def_readwrite_static("shared", &NativeMembers::shared, py::native_member());
+}
+
+struct Vector2 {
+    int x, y;
+    Vector2 operator+(const Vector2 &v) const { return {x + v.x, y + v.y}; }
+    Vector2 &operator+=(const Vector2 &v) {
+        x += v.x;
+        y += v.y;
+        return *this;
+    }
+    bool operator==(const Vector2 &v) const { return x == v.x && y == v.y; }
+    bool operator!=(const Vector2 &v) const { return !(*this == v); }
+};
+
+PYBIND11_EMBEDDED_MODULE(operator_module, m) {
+    py::class_<Vector2>(m, "Vector2")
+        .def(py::init<int, int>())
+        .def_readonly("x", &Vector2::x)
+        .def_readonly("y", &Vector2::y)
+        .def(py::self + py::self)
+        .def(py::self += py::self)
+        .def(py::self == py::self)
+        .def(py::self != py::self);
+}
+
 PYBIND11_EMBEDDED_MODULE(throw_exception, ) { throw std::runtime_error("C++ Error"); }
 
+PYBIND11_EMBEDDED_PYTHON_MODULE(embedded_helpers, R"(
+import widget_module
+
+def add_twice(i, j):
+    return widget_module.add(widget_module.add(i, j), j)
+)");
+
+#if defined(PYBIND11_HAS_SUBINTERPRETER_SUPPORT)
+struct Counter {
+    int value = 0;
+};
+struct LocalTag {};
+
+PYBIND11_EMBEDDED_MODULE(per_interpreter_module,
+                         m,
+                         py::multiple_interpreters::per_interpreter_gil()) {
+    py::class_<Counter>(m, "Counter")
+        .def(py::init<>())
+        .def("add", [](Counter &self, int i) { self.value += i; })
+        .def_readonly("value", &Counter::value);
+    py::class_<LocalTag>(m, "LocalTag", py::module_local()).def(py::init<>());
+    m.def("counter_value", [](const Counter &counter) { return counter.value; });
+    m.def("internals_at",
+          []() { return reinterpret_cast<uintptr_t>(&py::detail::get_internals()); });
+}
+#endif
+
 PYBIND11_EMBEDDED_MODULE(throw_error_already_set, ) {
     auto d = py::dict();
     d["missing"].cast<py::object>();
@@ -153,6 +222,15 @@ TEST_CASE("Import error handling") {
     REQUIRE(locals["message"].cast<std::string>() == "'missing'");
 }
 
+TEST_CASE("Embedded Python modules") {
+    auto helpers = py::module_::import("embedded_helpers");
+    REQUIRE(helpers.attr("add_twice")(1, 2).cast<int>() == 5);
+    REQUIRE(helpers.attr("__spec__").attr("origin").cast<std::string>()
+            == "<embedded embedded_helpers>");
+    REQUIRE_THROWS_WITH(py::module_::import("embedded_helpers.missing"),
+                        Catch::Contains("ModuleNotFoundError"));
+}
+
 TEST_CASE("There can be only one interpreter") {
     static_assert(std::is_move_constructible<py::scoped_interpreter>::value, "");
     static_assert(!std::is_move_assignable<py::scoped_interpreter>::value, "");
@@ -184,6 +262,37 @@ TEST_CASE("Custom PyConfig") {
     py::initialize_interpreter();
 }
 
+TEST_CASE("interpreter_options") {
+    py::finalize_interpreter();
+    py::add_embedded_python_module("embedded_pkg", "from . import sub\n", true);
+    py::add_embedded_python_module("embedded_pkg.sub", "value = 42\n");
+    {
+        py::startup_timings timings;
+        py::interpreter_options options;
+        options.import_site = false;
+        options.preload_modules = {"widget_module"};
+        options.timings = &timings;
+        py::scoped_interpreter guard{options};
+
+        auto modules = py::module_::import("sys").attr("modules");
+        REQUIRE_FALSE(modules.contains("site"));
+        REQUIRE(modules.contains("widget_module"));
+        REQUIRE(timings.interpreter.count() > 0);
+        REQUIRE(timings.preload.count() > 0);
+        REQUIRE(timings.total() >= timings.interpreter + timings.preload);
+
+        REQUIRE(py::module_::import("embedded_pkg").attr("sub").attr("value").cast<int>() == 42);
+    }
+    {
+        py::interpreter_options options;
+        options.isolated = true;
+        py::scoped_interpreter guard{options};
+        REQUIRE(py::module_::import("sys").attr("flags").attr("isolated").cast<int>() == 1);
+        REQUIRE(py::module_::import("embedded_pkg.sub").attr("value").cast<int>() == 42);
+    }
+    py::initialize_interpreter();
+}
+
 TEST_CASE("scoped_interpreter with PyConfig_InitIsolatedConfig and argv") {
     py::finalize_interpreter();
     {
@@ -334,6 +443,8 @@ TEST_CASE("Subinterpreter") {
     REQUIRE(has_state_dict_internals_obj());
     REQUIRE(has_pybind11_internals_static());
 
+    auto main_internals = reinterpret_cast<uintptr_t>(*py::detail::get_internals_pp());
+
     /// Create and switch to a subinterpreter.
     auto *main_tstate = PyThreadState_Get();
     auto *sub_tstate = Py_NewInterpreter();
@@ -353,6 +464,10 @@ TEST_CASE("Subinterpreter") {
         // Function bindings should still work.
         REQUIRE(m.attr("add")(1, 2).cast<int>() == 3);
     }
+    // The module uses single-phase initialization: it is copied from the main interpreter, and
+    // its types stay registered in the main internals
+    REQUIRE_FALSE(has_state_dict_internals_obj());
+    REQUIRE(reinterpret_cast<uintptr_t>(*py::detail::get_internals_pp()) == main_internals);
 
     // Restore main interpreter.
     Py_EndInterpreter(sub_tstate);
@@ -362,6 +477,70 @@ TEST_CASE("Subinterpreter") {
     REQUIRE(py::hasattr(py::module_::import("widget_module"), "extension_module_tag"));
 }
 
+#if defined(PYBIND11_HAS_SUBINTERPRETER_SUPPORT)
+TEST_CASE("Subinterpreters with a GIL of their own") {
+    constexpr int num_interpreters = 3;
+    const auto main_internals = reinterpret_cast<uintptr_t>(&py::detail::get_internals());
+
+    std::vector<py::subinterpreter> subs;
+    for (int i = 0; i < num_interpreters; ++i) {
+        subs.push_back(py::subinterpreter::create());
+    }
+    REQUIRE(subs[0].id() != subs[1].id());
+
+    // Modules without the option can only be imported into those sharing the GIL
+    {
+        py::subinterpreter_scoped_activate activate(subs[0]);
+        REQUIRE_THROWS_AS(py::module_::import("widget_module"), py::error_already_set);
+    }
+
+    std::vector<int> values(num_interpreters);
+    std::vector<int> rejected(num_interpreters);
+    std::vector<uintptr_t> internals(num_interpreters);
+    {
+        py::gil_scoped_release release;
+        std::vector<std::thread> threads;
+        for (int i = 0; i < num_interpreters; ++i) {
+            threads.emplace_back([&, i]() {
+                py::subinterpreter_scoped_activate activate(subs[static_cast<size_t>(i)]);
+                auto m = py::module_::import("per_interpreter_module");
+                auto counter = m.attr("Counter")();
+                for (int j = 0; j < 1000; ++j) {
+                    counter.attr("add")(i + 1);
+                }
+                values[static_cast<size_t>(i)] = counter.attr("value").cast<int>();
+                // Failing to load a module-local (or any other) type looks for a foreign
+                // module-local loader
+                auto tag = m.attr("LocalTag")();
+                for (int j = 0; j < 100; ++j) {
+                    try {
+                        m.attr("counter_value")(tag);
+                    } catch (const py::error_already_set &) {
+                        ++rejected[static_cast<size_t>(i)];
+                    }
+                }
+                internals[static_cast<size_t>(i)] = m.attr("internals_at")().cast<uintptr_t>();
+            });
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+    }
+
+    for (int i = 0; i < num_interpreters; ++i) {
+        REQUIRE(values[static_cast<size_t>(i)] == 1000 * (i + 1));
+        REQUIRE(rejected[static_cast<size_t>(i)] == 100);
+        REQUIRE(internals[static_cast<size_t>(i)] != main_internals);
+    }
+    REQUIRE(internals[0] != internals[1]);
+    REQUIRE(reinterpret_cast<uintptr_t>(&py::detail::get_internals()) == main_internals);
+
+    // Ends them
+    subs.clear();
+    REQUIRE(py::module_::import("widget_module").attr("add")(1, 2).cast<int>() == 3);
+}
+#endif
+
 TEST_CASE("Execution frame") {
     // When the interpreter is embedded, there is no execution frame, but `py::exec`
     // should still function by using reasonable globals: `__main__.__dict__`.
@@ -486,3 +665,100 @@ TEST_CASE("make_iterator can be called before then after finalizing an interpret
 
     py::initialize_interpreter();
 }
+
+TEST_CASE("Interned strings and keyword names are made again after a restart") {
+    static py::interned_str name("pybind11_interned_across_restarts");
+    auto sys_intern = [] {
+        return py::module_::import("sys").attr("intern")(py::str(name.value()));
+    };
+    auto make_dict = [] { return py::module_::import("builtins").attr("dict")("key"_a = 1); };
+
+    REQUIRE(name.get().is(sys_intern()));
+    REQUIRE(name.get().is(name.get()));
+    REQUIRE(make_dict()["key"].cast<int>() == 1);
+
+    py::finalize_interpreter();
+    py::initialize_interpreter();
+
+    REQUIRE(name.get().is(sys_intern()));
+    REQUIRE(make_dict()["key"].cast<int>() == 1);
+}
+
+TEST_CASE("Strings of py::interned are made again after a restart") {
+    auto check = [] {
+        const std::string value = "pybind11_interned_across_restarts";
+        auto first = py::cast(py::interned<std::string>(value));
+        REQUIRE(first.cast<std::string>() == value);
+        REQUIRE(first.is(py::cast(py::interned<std::string>(value))));
+        auto literal = py::cast(py::interned<const char *>("pybind11_interned_literal"));
+        REQUIRE(literal.cast<std::string>() == "pybind11_interned_literal");
+    };
+    check();
+
+    py::finalize_interpreter();
+    py::initialize_interpreter();
+
+    check();
+}
+
+#ifdef PYBIND11_HAS_FILESYSTEM
+TEST_CASE("Paths are cast to the pathlib.Path of each interpreter") {
+    auto check = [] {
+        auto path = py::cast(std::filesystem::path("foo/bar"));
+        REQUIRE(py::isinstance(path, py::module_::import("pathlib").attr("Path")));
+        REQUIRE(path.cast<std::filesystem::path>() == std::filesystem::path("foo/bar"));
+        REQUIRE(py::str("foo/bar").cast<std::filesystem::path>()
+                == std::filesystem::path("foo/bar"));
+    };
+    check();
+
+    py::finalize_interpreter();
+    py::initialize_interpreter();
+
+    check();
+}
+#endif
+
+TEST_CASE("Native member descriptors are made again after a restart") {
+    auto check = [] {
+        auto cls = py::module_::import("native_member_module").attr("NativeMembers");
+        auto obj = cls();
+        REQUIRE(obj.attr("value").cast<int>() == 1);
+        obj.attr("value") = 3;
+        REQUIRE(obj.attr("value").cast<int>() == 3);
+        NativeMembers::shared = 2;
+        REQUIRE(cls.attr("shared").cast<int>() == 2);
+        cls.attr("shared") = 4;
+        REQUIRE(NativeMembers::shared == 4);
+    };
+    check();
+
+    py::finalize_interpreter();
+    py::initialize_interpreter();
+
+    check();
+}
+
+TEST_CASE("Operators of a class bound again after a restart") {
+    // The second binding of the class uses the operator methods rather than the fast slots
+    auto check = [] {
+        auto vector2 = py::module_::import("operator_module").attr("Vector2");
+        auto locals = py::dict("Vector2"_a = vector2);
+        py::exec(R"(
+            a = Vector2(1, 2)
+            b = a + Vector2(3, 4)
+            b += a
+            result = (b.x, b.y, b == Vector2(5, 8), b != Vector2(5, 8))
+        )",
+                 py::globals(),
+                 locals);
+        REQUIRE(locals["result"].cast<std::tuple<int, int, bool, bool>>()
+                == std::make_tuple(5, 8, true, false));
+    };
+    check();
+
+    py::finalize_interpreter();
+    py::initialize_interpreter();
+
+    check();
+}
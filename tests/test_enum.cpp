@@ -130,4 +130,35 @@ TEST_SUBMODULE(enums, m) {
     py::enum_<ScopedBoolEnum>(m, "ScopedBoolEnum")
         .value("FALSE", ScopedBoolEnum::FALSE)
         .value("TRUE", ScopedBoolEnum::TRUE);
+
+    // test_fast_enum
+    m.attr("PYBIND11_INTERNALS_VERSION") = PYBIND11_INTERNALS_VERSION;
+    enum FastUnscopedEnum { FOne = 1, FTwo, FThree };
+    py::enum_<FastUnscopedEnum>(m, "FastUnscopedEnum", py::arithmetic(), py::fast_enum())
+        .value("FOne", FOne)
+        .value("FTwo", FTwo)
+        .value("FThree", FThree);
+    m.def("fast_unscoped", [](int i) { return static_cast<FastUnscopedEnum>(i); });
+    m.def("fast_unscoped_roundtrip", [](FastUnscopedEnum e) { return e; });
+
+    enum class FastScopedEnum { Two = 2, Three, AliasOfTwo = 2 };
+    py::enum_<FastScopedEnum>(m, "FastScopedEnum", py::fast_enum())
+        .value("Two", FastScopedEnum::Two)
+        .value("Three", FastScopedEnum::Three)
+        .value("AliasOfTwo", FastScopedEnum::AliasOfTwo);
+    m.def("fast_scoped", [](int i) { return static_cast<FastScopedEnum>(i); });
+
+    enum class FastSparseEnum : std::uint64_t { Zero = 0, Big = 1ULL << 63, Max = ~0ULL };
+    py::enum_<FastSparseEnum>(m, "FastSparseEnum", py::fast_enum())
+        .value("Zero", FastSparseEnum::Zero)
+        .value("Big", FastSparseEnum::Big)
+        .value("Max", FastSparseEnum::Max);
+    m.def("fast_sparse", [](std::uint64_t i) { return static_cast<FastSparseEnum>(i); });
+
+    enum class FastNegativeEnum : short { MinusFive = -5, MinusOne = -1, Seven = 7 };
+    py::enum_<FastNegativeEnum>(m, "FastNegativeEnum", py::fast_enum())
+        .value("MinusFive", FastNegativeEnum::MinusFive)
+        .value("MinusOne", FastNegativeEnum::MinusOne)
+        .value("Seven", FastNegativeEnum::Seven);
+    m.def("fast_negative", [](short i) { return static_cast<FastNegativeEnum>(i); });
 }
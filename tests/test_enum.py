@@ -1,5 +1,7 @@
 # ruff: noqa: SIM201 SIM300 SIM202
 
+import operator
+
 import pytest
 
 from pybind11_tests import enums as m
@@ -264,3 +266,67 @@ def test_docstring_signatures():
         for attr in enum_type.__dict__.values():
             # Issue #2623/PR #2637: Add argument names to enum_ methods
             assert "arg0" not in (attr.__doc__ or "")
+
+
+def test_fast_enum():
+    # Registered values are returned as the objects of the enum type, if the internals have
+    # room for them
+    cached = m.PYBIND11_INTERNALS_VERSION > 5
+
+    def check_same(a, b):
+        assert a == b
+        assert (a is b) == cached
+
+    check_same(m.fast_unscoped(2), m.FastUnscopedEnum.FTwo)
+    check_same(m.fast_unscoped_roundtrip(m.FastUnscopedEnum.FThree), m.FastUnscopedEnum.FThree)
+    assert m.fast_unscoped(7) is not m.fast_unscoped(7)
+    assert m.fast_unscoped(7) == 7
+    check_same(m.fast_scoped(2), m.FastScopedEnum.Two)
+    check_same(m.FastScopedEnum.AliasOfTwo, m.FastScopedEnum.Two)
+    check_same(m.fast_sparse(0), m.FastSparseEnum.Zero)
+    check_same(m.fast_sparse(2**63), m.FastSparseEnum.Big)
+    check_same(m.fast_sparse(2**64 - 1), m.FastSparseEnum.Max)
+    check_same(m.fast_negative(-5), m.FastNegativeEnum.MinusFive)
+    check_same(m.fast_negative(-1), m.FastNegativeEnum.MinusOne)
+    check_same(m.fast_negative(7), m.FastNegativeEnum.Seven)
+
+    # Like the methods
+    assert int(m.FastSparseEnum.Max) == 2**64 - 1
+    assert hash(m.FastSparseEnum.Max) == hash(2**64 - 1)
+    assert hash(m.FastSparseEnum.Big) == hash(2**63)
+    assert operator.index(m.FastNegativeEnum.MinusFive) == -5
+    assert hash(m.FastNegativeEnum.MinusOne) == -2
+    assert hash(m.FastNegativeEnum.Seven) == 7
+    assert m.FastNegativeEnum.MinusFive.value == -5
+
+    assert m.FastScopedEnum.Two == m.FastScopedEnum.Two
+    assert m.FastScopedEnum.Two != m.FastScopedEnum.Three
+    assert m.FastScopedEnum.Two != 2
+    assert m.FastScopedEnum.Two != m.ScopedEnum.Two
+    with pytest.raises(TypeError):
+        assert m.FastScopedEnum.Two < m.FastScopedEnum.Three
+    assert {m.FastScopedEnum.Two: 1}[m.fast_scoped(2)] == 1
+
+    # The same results as without py::fast_enum()
+    ops = [operator.eq, operator.ne, operator.lt, operator.le, operator.gt, operator.ge]
+    others = [1, 2, 3, -1, 2**70, 2.0, 2.5, None, "2"]
+
+    def outcome(op, a, b):
+        try:
+            return op(a, b)
+        except TypeError:
+            return TypeError
+
+    for value in [1, 2, 3]:
+        fast = m.FastUnscopedEnum(value)
+        slow = m.UnscopedEnum(value)
+        assert hash(fast) == hash(slow)
+        assert int(fast) == int(slow)
+        for op in ops:
+            for other in others:
+                assert outcome(op, fast, other) == outcome(op, slow, other)
+                assert outcome(op, other, fast) == outcome(op, other, slow)
+            for other in [1, 2, 3]:
+                expected = outcome(op, slow, m.UnscopedEnum(other))
+                assert outcome(op, fast, m.FastUnscopedEnum(other)) == expected
+            assert outcome(op, fast, slow) == outcome(op, slow, slow)
@@ -96,6 +96,36 @@ TEST_SUBMODULE(eval_, m) {
         return global;
     });
 
+    // test_compiled_code
+    m.def("sum_compiled", [](int count) {
+        auto code = py::compile("x * 2");
+        int total = 0;
+        for (int i = 0; i < count; ++i) {
+            py::dict local;
+            local["x"] = i;
+            total += py::eval(code, py::dict(), local).cast<int>();
+        }
+        return total;
+    });
+    m.def("exec_compiled", []() {
+        auto code = py::compile<py::eval_statements>(R"(
+            def triple(x):
+                return 3 * x
+            result = triple(value)
+            )");
+        py::dict global;
+        global["value"] = 14;
+        py::eval(code, global);
+        return global["result"];
+    });
+    m.def("eval_cached", [](const py::str &expr, int x) {
+        py::dict local;
+        local["x"] = x;
+        return py::eval(expr, py::dict(), local);
+    });
+    m.def("eval_file_expr",
+          [](const py::str &filename) { return py::eval_file<py::eval_expr>(filename); });
+
     // test_eval_closure
     m.def("test_eval_closure", []() {
         py::dict global;
@@ -25,6 +25,33 @@ def test_eval_file():
     assert m.test_eval_file_failure()
 
 
+def test_compiled_code():
+    assert m.sum_compiled(10) == 90
+    assert m.exec_compiled() == 42
+
+    # Evaluating a string again runs the code compiled the first time
+    assert [m.eval_cached("x + 1", x) for x in range(5)] == [1, 2, 3, 4, 5]
+    assert m.eval_cached("x * x", 7) == 49
+    with pytest.raises(SyntaxError):
+        m.eval_cached("x +", 1)
+
+
+@pytest.mark.xfail("env.PYPY", raises=RuntimeError)
+def test_eval_file_cache(tmp_path):
+    path = tmp_path / "expr.py"
+    path.write_text("1 + 1")
+    assert m.eval_file_expr(str(path)) == 2
+    assert m.eval_file_expr(str(path)) == 2
+
+    # Compiled again when the file changes
+    path.write_text("40 + 2")
+    assert m.eval_file_expr(str(path)) == 42
+    stat = os.stat(path)
+    path.write_text("40 + 3")
+    os.utime(path, ns=(stat.st_atime_ns, stat.st_mtime_ns + 1_000_000_000))
+    assert m.eval_file_expr(str(path)) == 43
+
+
 def test_eval_empty_globals():
     assert "__builtins__" in m.eval_empty_globals(None)
 
@@ -344,4 +344,29 @@ TEST_SUBMODULE(exceptions, m) {
         // function returns None instead of int, should give a useful error message
         fn().cast<int>();
     });
+
+    // test_result
+    m.def("result_double", [](int i) -> py::result<int> {
+        if (i < 0) {
+            return py::error(PyExc_KeyError, py::int_(i));
+        }
+        return 2 * i;
+    });
+    m.def("result_tuple_key",
+          []() -> py::result<int> { return py::error(PyExc_KeyError, py::make_tuple(1, 2)); });
+    m.def("result_message", [](const std::string &s) -> py::result<std::string> {
+        if (s.empty()) {
+            return py::error(PyExc_ValueError, "empty string");
+        }
+        return s + s;
+    });
+    m.def(
+        "result_keep_alive",
+        [](const py::object &o, bool fail) -> py::result<py::object> {
+            if (fail) {
+                return py::error(PyExc_ValueError, "failed");
+            }
+            return o;
+        },
+        py::keep_alive<0, 1>());
 }
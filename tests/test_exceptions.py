@@ -190,6 +190,27 @@ def test_custom(msg):
     assert msg(excinfo.value) == "this is a helper-defined translated exception"
 
 
+
+def test_custom_repeated(msg):
+    # Exceptions of the same type are translated the same way every time, including ones that
+    # are delegated to another translator or fall through to the default one
+    for _ in range(3):
+        with pytest.raises(m.MyException) as excinfo:
+            m.throws1()
+        assert msg(excinfo.value) == "this error should go to a custom type"
+        with pytest.raises(m.MyException) as excinfo:
+            m.throws4()
+        assert msg(excinfo.value) == "this error is rethrown"
+        with pytest.raises(RuntimeError) as excinfo:
+            m.throws_logic_error()
+        assert (
+            msg(excinfo.value)
+            == "this error should fall through to the standard handler"
+        )
+        with pytest.raises(m.MyException5_1):
+            m.throws5_1()
+
+
 def test_nested_throws(capture):
     """Tests nested (e.g. C++ -> Python -> C++) exception handling"""
 
@@ -411,3 +432,27 @@ def test_fn_cast_int_exception():
     assert str(excinfo.value).startswith(
         "Unable to cast Python instance of type <class 'NoneType'> to C++ type"
     )
+
+
+def test_result():
+    assert m.result_double(21) == 42
+    with pytest.raises(KeyError) as excinfo:
+        m.result_double(-1)
+    assert excinfo.value.args == (-1,)
+    assert excinfo.value.__cause__ is None
+    with pytest.raises(KeyError) as excinfo:
+        m.result_tuple_key()
+    assert excinfo.value.args == ((1, 2),)
+
+    assert m.result_message("ab") == "abab"
+    with pytest.raises(ValueError, match="^empty string$"):
+        m.result_message("")
+    assert m.result_message.__doc__.startswith("result_message(arg0: str) -> str")
+
+    class Weakrefable:
+        pass
+
+    o = Weakrefable()
+    assert m.result_keep_alive(o, False) is o
+    with pytest.raises(ValueError, match="^failed$"):
+        m.result_keep_alive(o, True)
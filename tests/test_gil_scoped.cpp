@@ -115,6 +115,39 @@ TEST_SUBMODULE(gil_scoped, m) {
         py::gil_scoped_acquire gil_acquired_inner;
         return py::str(obj);
     });
+    m.def("test_callback_batch", [](const std::function<int(int)> &func, int n) {
+        py::gil_scoped_release gil_released;
+        int total = 0;
+        {
+            py::gil_scoped_callback_batch batch;
+            for (int i = 0; i < n; ++i) {
+                total += func(i);
+            }
+            // Releasing the GIL suspends the batch, so the callback has to acquire it again
+            py::gil_scoped_release gil_released_in_batch;
+            total += func(n);
+        }
+        total += func(n + 1);
+        return total;
+    });
+    m.def("test_gil_scoped_thread_state", [](const py::object &func, int n) {
+        int kept = 0;
+        {
+            py::gil_scoped_release gil_released;
+            std::thread([&func, n, &kept]() {
+                py::gil_scoped_thread_state thread_state;
+                for (int i = 0; i < n; ++i) {
+                    py::gil_scoped_acquire gil_acquired;
+                    func(i);
+                    // The dict of the thread state is empty again if it was made anew
+                    auto dict = py::reinterpret_borrow<py::dict>(PyThreadState_GetDict());
+                    kept += static_cast<int>(dict.contains("marker"));
+                    dict["marker"] = i;
+                }
+            }).join();
+        }
+        return kept;
+    });
     m.def("test_multi_acquire_release_cross_module", [](unsigned bits) {
         py::set internals_ids;
         internals_ids.add(PYBIND11_INTERNALS_ID);
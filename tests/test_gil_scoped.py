@@ -101,6 +101,14 @@ def test_nested_acquire():
     assert m.test_nested_acquire(0xAB) == "171"
 
 
+def test_callback_batch():
+    assert m.test_callback_batch(lambda i: i, 4) == 15
+
+
+def test_gil_scoped_thread_state():
+    assert m.test_gil_scoped_thread_state(lambda i: i, 5) == 4
+
+
 def test_multi_acquire_release_cross_module():
     for bits in range(16 * 8):
         internals_ids = m.test_multi_acquire_release_cross_module(bits)
@@ -126,6 +134,8 @@ ALL_BASIC_TESTS = (
     test_cross_module_gil_nested_pybind11_acquired,
     test_release_acquire,
     test_nested_acquire,
+    test_callback_batch,
+    test_gil_scoped_thread_state,
     test_multi_acquire_release_cross_module,
 )
 
@@ -16,6 +16,7 @@
 #include <mutex>
 #include <string>
 #include <thread>
+#include <vector>
 
 void noisy_function(const std::string &msg, bool flush) {
 
@@ -118,6 +119,54 @@ TEST_SUBMODULE(iostream, m) {
         std::cerr << emsg << std::flush;
     });
 
+    m.def("captured_buffered_threads", [](const std::string &msg, int num_threads) {
+        py::scoped_buffered_ostream_redirect redir;
+        py::gil_scoped_release release;
+        std::vector<std::thread> threads;
+        for (int i = 0; i < num_threads; ++i) {
+            threads.emplace_back([&msg]() {
+                for (int j = 0; j < 100; ++j) {
+                    std::cout << msg + "\n" << std::flush;
+                }
+            });
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+    });
+
+    // Writes one byte at a time, so that the background thread sees incomplete UTF-8
+    m.def("captured_buffered_bytewise", [](const std::string &msg) {
+        py::buffered_redirect_options options;
+        options.flush_threshold = 1;
+        py::scoped_buffered_ostream_redirect redir(
+            std::cout, py::module_::import("sys").attr("stdout"), options);
+        py::gil_scoped_release release;
+        for (char c : msg) {
+            std::cout.put(c);
+        }
+    });
+
+    // Returns whether the output reaches `pyostream` before the end of the scope
+    m.def("buffered_flushes_in_background",
+          [](const std::string &msg, const py::object &pyostream) {
+              py::buffered_redirect_options options;
+              options.flush_threshold = 0;
+              options.flush_interval = std::chrono::milliseconds(1);
+              py::scoped_buffered_ostream_redirect redir(std::cout, pyostream, options);
+              std::cout << msg << std::endl;
+              for (int i = 0; i < 5000; ++i) {
+                  {
+                      py::gil_scoped_release release;
+                      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                  }
+                  if (!pyostream.attr("getvalue")().cast<std::string>().empty()) {
+                      return true;
+                  }
+              }
+              return false;
+          });
+
     py::class_<TestThread>(m, "TestThread")
         .def(py::init<>())
         .def("stop", &TestThread::stop)
@@ -289,3 +289,24 @@ def test_threading():
 
         # if a thread segfaults, we don't get here
         assert True
+
+
+def test_buffered_threads(capsys):
+    m.captured_buffered_threads("line", 4)
+    stdout, stderr = capsys.readouterr()
+    assert stdout == "line\n" * 400
+    assert not stderr
+
+
+def test_buffered_utf8(capsys):
+    msg = "1" + "\u07FF\uFFFF\U0010FFFF" * 500
+    m.captured_buffered_bytewise(msg)
+    stdout, stderr = capsys.readouterr()
+    assert stdout == msg
+    assert not stderr
+
+
+def test_buffered_background_flush():
+    stream = StringIO()
+    assert m.buffered_flushes_in_background("early", stream)
+    assert stream.getvalue() == "early\n"
@@ -42,6 +42,23 @@ TEST_SUBMODULE(kwargs_and_defaults, m) {
     m.def("kw_func_udl", kw_func, "x"_a, "y"_a = 300);
     m.def("kw_func_udl_z", kw_func, "x"_a, "y"_a = 0);
 
+    // More arguments than `function_call` stores inline
+    m.def(
+        "kw_func_many",
+        [](int a, int b, int c, int d, int e, int f, int g, int h, int i, int j) {
+            return a + 2 * b + 3 * c + 4 * d + 5 * e + 6 * f + 7 * g + 8 * h + 9 * i + 10 * j;
+        },
+        "a"_a,
+        "b"_a,
+        "c"_a,
+        "d"_a,
+        "e"_a,
+        "f"_a,
+        "g"_a,
+        "h"_a,
+        "i"_a = 0,
+        "j"_a = 0);
+
     // test_args_and_kwargs
     m.def("args_function", [](py::args args) -> py::tuple {
         PYBIND11_WARNING_PUSH
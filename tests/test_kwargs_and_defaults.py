@@ -52,6 +52,15 @@ def test_named_arguments():
     assert m.kw_func_udl(x=5, y=10) == "x=5, y=10"
     assert m.kw_func_udl_z(x=5) == "x=5, y=0"
 
+    assert m.kw_func_many(*range(1, 11)) == 385
+    assert m.kw_func_many(1, 1, 1, 1, 1, 1, 1, 1) == 36
+    assert m.kw_func_many(1, 1, 1, 1, 1, 1, 1, 1, j=1, i=1) == 55
+
+    # Keyword names that are not interned are matched by value
+    x, j = "".join(["x"]), "".join(["j"])
+    assert m.kw_func1(**{x: 5, "y": 10}) == "x=5, y=10"
+    assert m.kw_func_many(1, 1, 1, 1, 1, 1, 1, 1, **{j: 2}) == 56
+
 
 def test_arg_and_kwargs():
     args = "arg1_value", "arg2_value", 3
@@ -375,15 +384,14 @@ def test_args_refcount():
     )
     assert refcount(myval) == expected
 
+    # The arguments of a call are passed to the dispatcher as an array (`METH_FASTCALL`), so a
+    # new tuple is constructed for the `py::args`, which holds an extra reference to each item.
     exp3 = refcount(myval, myval, myval)
-    assert m.args_refcount(myval, myval, myval) == (exp3, exp3, exp3)
+    assert m.args_refcount(myval, myval, myval) == (exp3 + 3, exp3 + 3, exp3 + 3)
     assert refcount(myval) == expected
 
-    # This function takes the first arg as a `py::object` and the rest as a `py::args`.  Unlike the
-    # previous case, when we have both positional and `py::args` we need to construct a new tuple
-    # for the `py::args`; in the previous case, we could simply inc_ref and pass on Python's input
-    # tuple without having to inc_ref the individual elements, but here we can't, hence the extra
-    # refs.
+    # This function takes the first arg as a `py::object` and the rest as a `py::args`, which
+    # also gets a new tuple.
     assert m.mixed_args_refcount(myval, myval, myval) == (exp3 + 3, exp3 + 3, exp3 + 3)
 
     assert m.class_default_argument() == "<class 'decimal.Decimal'>"
@@ -20,6 +20,35 @@ def test_load_external():
     assert "incompatible function arguments" in str(excinfo.value)
 
 
+def test_load_external_repeated():
+    """Failed loads of external `py::module_local` types are remembered per Python type, until
+    the type is modified"""
+    import pybind11_cross_module_tests as cm
+
+    for _ in range(3):
+        with pytest.raises(TypeError):
+            m.load_external1(cm.ExternalType2(12))
+        with pytest.raises(TypeError):
+            m.load_external1(object())
+        assert m.load_external2(cm.ExternalType2(22)) == 22
+        assert m.load_external1(cm.ExternalType1(11)) == 11
+
+    (local_id,) = (
+        name for name in vars(cm.ExternalType1) if name.startswith("__pybind11_module_local")
+    )
+
+    class Shadowed(cm.ExternalType1):
+        pass
+
+    # Hide the loader of ExternalType1 behind that of ExternalType2
+    setattr(Shadowed, local_id, getattr(cm.ExternalType2, local_id))
+    for _ in range(3):
+        with pytest.raises(TypeError):
+            m.load_external1(Shadowed(13))
+    delattr(Shadowed, local_id)
+    assert m.load_external1(Shadowed(13)) == 13
+
+
 def test_local_bindings():
     """Tests that duplicate `py::module_local` class bindings work across modules"""
 
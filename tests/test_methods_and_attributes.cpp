@@ -11,6 +11,27 @@
 #include "constructor_stats.h"
 #include "pybind11_tests.h"
 
+#include <cstdint>
+#include <string>
+
+// test_overload_cache: a caster derived from type_caster_base which only loads even values
+struct OverloadCacheEven {
+    int value;
+};
+
+namespace pybind11 {
+namespace detail {
+template <>
+class type_caster<OverloadCacheEven> : public type_caster_base<OverloadCacheEven> {
+public:
+    bool load(handle src, bool convert) {
+        return type_caster_base<OverloadCacheEven>::load(src, convert) && value != nullptr
+               && static_cast<OverloadCacheEven *>(value)->value % 2 == 0;
+    }
+};
+} // namespace detail
+} // namespace pybind11
+
 #if !defined(PYBIND11_OVERLOAD_CAST)
 template <typename... Args>
 using overload_cast_ = pybind11::detail::overload_cast_impl<Args...>;
@@ -209,6 +230,28 @@ void add_bindings(py::module &m) {
 } // namespace exercise_is_setter
 } // namespace pybind11_tests
 
+// test_native_members
+struct NativeMembers {
+    double d = 1.5;
+    int i = 2;
+    bool b = true;
+    std::uint8_t small = 3;
+    const long long ro = 4;
+};
+
+struct NativePadding {
+    int pad[3] = {};
+};
+
+// NativeMembers is not the first base, so its members are not at the same offsets
+struct NativeDerived : NativePadding, NativeMembers {};
+
+// test_native_static_members
+struct NativeStatics {};
+int native_static_counter = 1;
+const double native_static_scale = 0.25;
+int native_static_version = 3;
+
 TEST_SUBMODULE(methods_and_attributes, m) {
     // test_methods_and_attributes
     py::class_<ExampleMandA> emna(m, "ExampleMandA");
@@ -377,6 +420,24 @@ TEST_SUBMODULE(methods_and_attributes, m) {
     m.def(
         "overload_order", [](int) { return 4; }, py::prepend{});
 
+    // test_overload_cache
+    struct OverloadCacheA {};
+    struct OverloadCacheB {};
+    py::class_<OverloadCacheA>(m, "OverloadCacheA").def(py::init<>());
+    py::class_<OverloadCacheB>(m, "OverloadCacheB").def(py::init<>());
+    m.def("overload_cache", [](std::int8_t) { return "int8"; });
+    m.def("overload_cache", [](const OverloadCacheA &) { return "A"; });
+    m.def("overload_cache", [](const OverloadCacheA &, const OverloadCacheB &) { return "AB"; });
+    m.def("overload_cache", [](const OverloadCacheB &) { return "B"; });
+    m.def("overload_cache", [](std::int64_t) { return "int64"; });
+    py::class_<OverloadCacheEven>(m, "OverloadCacheEven").def(py::init<int>());
+    m.def("overload_cache_even", [](const OverloadCacheEven &) { return "even"; });
+    m.def("overload_cache_even", [](const py::object &) { return "other"; });
+    m.def("overload_cache_prepend", [m]() mutable {
+        m.def(
+            "overload_cache", [](const OverloadCacheB &) { return "prepended B"; }, py::prepend());
+    });
+
 #if !defined(PYPY_VERSION)
     // test_dynamic_attributes
     class DynamicClass {
@@ -490,4 +551,37 @@ TEST_SUBMODULE(methods_and_attributes, m) {
         .def("func4", &RValueRefParam::func4);
 
     pybind11_tests::exercise_is_setter::add_bindings(m);
+
+    // test_native_members
+    py::class_<NativeMembers>(m, "NativeMembers")
+        .def(py::init<>())
+        .def_readwrite("d", &NativeMembers::d, py::native_member(), "A double")
+        .def_readwrite("i", &NativeMembers::i, py::native_member())
+        .def_readwrite("b", &NativeMembers::b, py::native_member())
+        .def_readwrite("small", &NativeMembers::small, py::native_member())
+        .def_readonly("ro", &NativeMembers::ro, py::native_member());
+    py::class_<NativeDerived, NativeMembers>(m, "NativeDerived", py::multiple_inheritance())
+        .def(py::init<>())
+        .def_readwrite("i2", &NativeDerived::i, py::native_member());
+    m.def("native_members_state", [](const NativeMembers &n) {
+        return std::to_string(n.d) + " " + std::to_string(n.i) + " " + std::to_string(n.b) + " "
+               + std::to_string(n.small) + " " + std::to_string(n.ro);
+    });
+
+    // test_native_static_members
+    py::class_<NativeStatics>(m, "NativeStatics")
+        .def(py::init<>())
+        .def_readwrite_static("counter", &native_static_counter, py::native_member(), "A counter")
+        .def_readonly_static("scale", &native_static_scale, py::native_member())
+        .def_readonly_static("version", &native_static_version, py::static_constant());
+    m.def("native_statics_state", []() {
+        return std::to_string(native_static_counter) + " " + std::to_string(native_static_version);
+    });
+    m.def("native_statics_set_version", [](int version) { native_static_version = version; });
+
+    // test_reference_cast_error_in_body
+    m.def("append_then_fail", [](py::list &calls) {
+        calls.append(calls.size());
+        throw py::reference_cast_error();
+    });
 }
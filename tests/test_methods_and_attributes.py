@@ -516,6 +516,34 @@ def test_overload_ordering():
     assert "4. (arg0: int) -> int" in str(err.value)
 
 
+def test_overload_cache():
+    a, b = m.OverloadCacheA(), m.OverloadCacheB()
+
+    class DerivedB(m.OverloadCacheB):
+        pass
+
+    for _ in range(3):
+        assert m.overload_cache(b) == "B"
+        assert m.overload_cache(a) == "A"
+        assert m.overload_cache(a, b) == "AB"
+        assert m.overload_cache(DerivedB()) == "B"
+        # Matching integer overloads depends on the value, not just the type
+        assert m.overload_cache(1000) == "int64"
+        assert m.overload_cache(1) == "int8"
+        assert m.overload_cache(-1000) == "int64"
+        with pytest.raises(TypeError):
+            m.overload_cache(b, a)
+
+    # A custom caster deciding by the value is not skipped when the type was cached
+    for _ in range(3):
+        assert m.overload_cache_even(m.OverloadCacheEven(1)) == "other"
+        assert m.overload_cache_even(m.OverloadCacheEven(2)) == "even"
+
+    m.overload_cache_prepend()
+    assert m.overload_cache(b) == "prepended B"
+    assert m.overload_cache(a) == "A"
+
+
 def test_rvalue_ref_param():
     r = m.RValueRefParam()
     assert r.func1("123") == 3
@@ -531,3 +559,89 @@ def test_is_setter():
     assert isinstance(setter_return, int)
     assert setter_return == 100
     assert fld.int_value == 100
+
+
+def test_native_members():
+    n = m.NativeMembers()
+    assert (n.d, n.i, n.b, n.small, n.ro) == (1.5, 2, True, 3, 4)
+    n.d = 2
+    n.i = -5
+    n.b = False
+    n.small = 255
+    assert m.native_members_state(n) == "2.000000 -5 0 255 4"
+    assert (n.d, n.i, n.b, n.small) == (2.0, -5, False, 255)
+
+    # Values are converted like function arguments
+    with pytest.raises(TypeError):
+        n.i = 1.5
+    with pytest.raises(TypeError):
+        n.small = 256
+    with pytest.raises(TypeError):
+        n.d = "1"
+    with pytest.raises(AttributeError):
+        n.ro = 1
+    with pytest.raises(AttributeError):
+        del n.d
+    assert m.NativeMembers.d.__doc__ == "A double"
+    if not env.PYPY:
+        descr = m.NativeMembers.__dict__["i"]
+        assert type(descr).__name__ == "pybind11_native_member"
+        assert descr.__name__ == "i"
+        assert descr.__objclass__ is m.NativeMembers
+        with pytest.raises(TypeError):
+            descr.__get__(object())
+
+    # Members of a base class at another address
+    d = m.NativeDerived()
+    d.i2 = 7
+    assert d.i == 7
+    d.d = 0.5
+    assert m.native_members_state(d) == "0.500000 7 1 3 4"
+
+    class PyDerived(m.NativeMembers):
+        pass
+
+    p = PyDerived()
+    p.small = 9
+    assert p.small == 9
+    assert m.native_members_state(p) == "1.500000 2 1 9 4"
+
+
+def test_native_static_members():
+    assert m.NativeStatics.counter == 1
+    m.NativeStatics.counter = 5
+    assert m.native_statics_state() == "5 3"
+    n = m.NativeStatics()
+    assert n.counter == 5
+    n.counter = 6
+    assert m.NativeStatics.counter == 6
+    with pytest.raises(TypeError):
+        m.NativeStatics.counter = 1.5
+    assert m.NativeStatics.counter == 6
+
+    assert m.NativeStatics.scale == 0.25
+    with pytest.raises(AttributeError):
+        m.NativeStatics.scale = 1.0
+    with pytest.raises(AttributeError):
+        n.scale = 1.0
+
+    if not env.PYPY:
+        descr = m.NativeStatics.__dict__["counter"]
+        assert type(descr).__name__ == "pybind11_native_static_member"
+        assert descr.__doc__ == "A counter"
+        assert repr(descr).startswith("<native static member 'counter'")
+
+    # A constant is a plain entry of the class dictionary, converted once
+    assert m.NativeStatics.__dict__["version"] == 3
+    m.native_statics_set_version(4)
+    assert m.NativeStatics.version == 3
+    assert m.native_statics_state() == "6 4"
+
+
+def test_reference_cast_error_in_body():
+    # A `reference_cast_error` thrown by the function itself is reported like a failure to load
+    # the arguments, but the function (and its side effects) is not run again
+    calls = []
+    with pytest.raises(TypeError, match="incompatible function arguments"):
+        m.append_then_fail(calls)
+    assert calls == [0]
@@ -122,4 +122,70 @@ TEST_SUBMODULE(modules, m) {
     });
 
     m.def("def_submodule", [](py::module_ m, const char *name) { return m.def_submodule(name); });
+
+    // test_lazy_bindings
+    struct LazyPet {
+        std::string name;
+    };
+    struct LazyDog {};
+    static int lazy_calls = 0;
+    m.def_lazy<LazyPet>("LazyPet", [](py::module_ &m) {
+        ++lazy_calls;
+        py::class_<LazyPet>(m, "LazyPet")
+            .def(py::init<std::string>())
+            .def_readonly("name", &LazyPet::name);
+    });
+    m.def_lazy<LazyDog>("LazyDog", [](py::module_ &m) {
+        ++lazy_calls;
+        py::class_<LazyDog>(m, "LazyDog");
+    });
+    m.def_lazy_submodule(
+        "lazy_sub",
+        [](py::module_ &sub) {
+            ++lazy_calls;
+            sub.def("func", []() { return "lazy_sub.func()"; });
+        },
+        "A lazily created submodule");
+    static bool lazy_failed = false;
+    m.def_lazy("lazy_flaky", [](py::module_ &m) {
+        if (!lazy_failed) {
+            lazy_failed = true;
+            throw std::runtime_error("lazy_flaky fails once");
+        }
+        m.def("lazy_flaky", []() { return 42; });
+    });
+    struct LazyCat {};
+    static bool lazy_cat_failed = false;
+    m.def_lazy<LazyCat>("LazyCat", [](py::module_ &m) {
+        if (!lazy_cat_failed) {
+            lazy_cat_failed = true;
+            throw std::runtime_error("LazyCat fails once");
+        }
+        py::class_<LazyCat>(m, "LazyCat");
+    });
+    m.def("lazy_calls", []() { return lazy_calls; });
+    // Returns py::object, so that defining it does not create LazyDog for its signature
+    m.def("make_lazy_dog", []() { return py::cast(LazyDog{}); });
+    m.def("make_lazy_cat", []() { return py::cast(LazyCat{}); });
+    // A module with a pending lazy binding, which must not keep it alive
+    m.def("make_lazy_module", []() {
+        auto module = py::reinterpret_borrow<py::module_>(
+            py::module_::import("types").attr("ModuleType")("lazy_module"));
+        module.def_lazy("never", [](py::module_ &) {});
+        return module;
+    });
+
+    // test_def_batched
+    m.def_batched("batched_add", [](int a, int b) { return a + b; });
+    m.def_batched("batched_square", [](double x) { return x * x; });
+    m.def_batched("batched_check", [](int i) {
+        if (i < 0) {
+            throw std::invalid_argument("negative");
+        }
+        return i;
+    });
+    m.def_batched("batched_append_then_fail", [](py::list &calls) {
+        calls.append(calls.size());
+        throw py::reference_cast_error();
+    });
 }
@@ -1,8 +1,14 @@
 import builtins
+import os
+import subprocess
+import sys
+import sysconfig
+import weakref
 
 import pytest
 
 import env
+import pybind11_tests
 from pybind11_tests import ConstructorStats
 from pybind11_tests import modules as m
 from pybind11_tests.modules import subsubmodule as ms
@@ -114,3 +120,99 @@ def test_def_submodule_failures():
     # Meant to trigger PyImport_AddModule() failure:
     with pytest.raises(UnicodeDecodeError):
         m.def_submodule(sm, malformed_utf8)
+
+
+def test_import_profile():
+    # The environment variable is only read once, so the module is imported in a new process
+    env = dict(os.environ, PYBIND11_PROFILE_IMPORT="1")
+    env["PYTHONPATH"] = os.pathsep.join(
+        [os.path.dirname(pybind11_tests.__file__), env.get("PYTHONPATH", "")]
+    )
+    result = subprocess.run(
+        [sys.executable, "-c", "import pybind11_tests"],
+        env=env,
+        stderr=subprocess.PIPE,
+        check=True,
+        universal_newlines=True,
+    )
+    lines = result.stderr.splitlines()
+    header = "pybind11: import profile of pybind11_tests ("
+    assert any(line.startswith(header) for line in lines)
+    entries = [line.split(None, 3) for line in lines if line[:1] == " "]
+    assert all(float(entry[0]) <= float(entry[1]) for entry in entries if len(entry) == 4)
+    assert any(entry[3].startswith("class_ ") for entry in entries if len(entry) == 4)
+
+
+@pytest.mark.skipif(
+    not sysconfig.get_config_var("Py_GIL_DISABLED"),
+    reason="requires a free-threaded build",
+)
+def test_gil_not_used():
+    # Importing pybind11_tests (declared with py::mod_gil_not_used()) must not re-enable the GIL
+    assert not sys._is_gil_enabled()
+
+
+@pytest.mark.skipif(sys.version_info < (3, 7), reason="requires module __getattr__")
+def test_lazy_bindings():
+    assert m.lazy_calls() == 0
+    assert {"LazyPet", "LazyDog", "lazy_sub", "lazy_flaky"} <= set(dir(m))
+    assert "LazyPet" not in vars(m)
+
+    pet = m.LazyPet("Molly")
+    assert pet.name == "Molly"
+    assert type(pet) is vars(m)["LazyPet"]
+    assert m.lazy_calls() == 1
+
+    # Casting a C++ type creates the binding registering it
+    dog = m.make_lazy_dog()
+    assert m.lazy_calls() == 2
+    assert type(dog) is m.LazyDog
+    assert m.lazy_calls() == 2
+
+    assert m.lazy_sub.func() == "lazy_sub.func()"
+    assert m.lazy_sub.__doc__ == "A lazily created submodule"
+    assert m.lazy_sub.__name__ == m.__name__ + ".lazy_sub"
+    assert m.lazy_calls() == 3
+
+    # A binding whose init fails is created again next time
+    with pytest.raises(RuntimeError, match="lazy_flaky fails once"):
+        m.lazy_flaky  # noqa: B018
+    assert m.lazy_flaky() == 42
+
+    with pytest.raises(AttributeError, match="has no attribute 'lazy_missing'"):
+        m.lazy_missing  # noqa: B018
+    assert not {"LazyPet", "LazyDog", "lazy_sub", "lazy_flaky"} - set(vars(m))
+
+    # A type whose binding fails is registered by the next attempt
+    with pytest.raises(RuntimeError, match="LazyCat fails once"):
+        m.make_lazy_cat()
+    assert type(m.make_lazy_cat()).__name__ == "LazyCat"
+
+    # Pending bindings do not keep their module alive
+    module = m.make_lazy_module()
+    assert "never" in dir(module)
+    ref = weakref.ref(module)
+    del module
+    pytest.gc_collect()
+    assert ref() is None
+
+
+def test_def_batched():
+    assert m.batched_add([(1, 2), (3, 4), (5, 6)]) == [3, 7, 11]
+    assert m.batched_add(iter([])) == []
+    assert m.batched_square([1, 2.5]) == [1.0, 6.25]
+    assert m.batched_square((x,) for x in range(3)) == [0.0, 1.0, 4.0]
+
+    # Items whose arguments do not load are reported by the dispatcher as usual
+    with pytest.raises(TypeError, match="incompatible function arguments"):
+        m.batched_add([(1, 2), ("a", 2)])
+    with pytest.raises(TypeError, match="incompatible function arguments"):
+        m.batched_add([(1, 2, 3)])
+    with pytest.raises(ValueError, match="negative"):
+        m.batched_check([1, -1])
+
+    # The function is called once for an item, also if it throws a `reference_cast_error` itself
+    calls = []
+    with pytest.raises(TypeError, match="incompatible function arguments"):
+        m.batched_append_then_fail([calls])
+    assert calls == [0]
@@ -78,6 +78,25 @@ struct I801B2 {
 struct I801C : I801B1, I801B2 {};
 struct I801D : I801C {}; // Indirect MI
 
+// test_mi_base_casts
+struct CastBase0 {
+    int v0 = 0;
+};
+struct CastBase1 {
+    int v1 = 1;
+};
+struct CastBase2 : CastBase0 {
+    int v2 = 2;
+};
+struct CastDerived : CastBase1, CastBase2 {
+    CastDerived() {
+        v0 = 10;
+        v1 = 11;
+        v2 = 12;
+    }
+};
+struct CastMostDerived : CastDerived {};
+
 } // namespace
 
 TEST_SUBMODULE(multiple_inheritance, m) {
@@ -338,4 +357,25 @@ TEST_SUBMODULE(multiple_inheritance, m) {
         .def("get_f_e", &MVF::get_f_e)
         .def("get_f_f", &MVF::get_f_f)
         .def_readwrite("f", &MVF::f);
+
+    // test_mi_base_casts
+    // Upcasts to bases at various offsets, through the base casts precomputed for the derived
+    // types with PYBIND11_INTERNALS_VERSION 6 and by loading each derived type in turn otherwise
+    py::class_<CastBase0>(m, "CastBase0");
+    py::class_<CastBase1>(m, "CastBase1");
+    py::class_<CastBase2, CastBase0>(m, "CastBase2");
+    py::class_<CastDerived, CastBase1, CastBase2>(m, "CastDerived").def(py::init<>());
+    py::class_<CastMostDerived, CastDerived>(m, "CastMostDerived").def(py::init<>());
+    m.def("cast_base0", [](const CastBase0 &b) { return b.v0; });
+    m.def("cast_base1", [](const CastBase1 &b) { return b.v1; });
+    m.def("cast_base2", [](const CastBase2 *b) { return b->v2; });
+
+    // test_registered_types
+    m.def("registered_type_names", [](const py::type &t) {
+        py::list names;
+        for (auto *tinfo : py::detail::all_type_info((PyTypeObject *) t.ptr())) {
+            names.append(py::handle((PyObject *) tinfo->type).attr("__name__"));
+        }
+        return names;
+    });
 }
@@ -491,3 +491,50 @@ def test_python_inherit_from_mi():
     assert o.g == 7
 
     assert o.get_g_g() == 7
+
+
+def test_mi_base_casts():
+    class PyDerived(m.CastMostDerived):
+        pass
+
+    for cls in (m.CastDerived, m.CastMostDerived, PyDerived):
+        o = cls()
+        for _ in range(2):
+            assert m.cast_base0(o) == 10
+            assert m.cast_base1(o) == 11
+            assert m.cast_base2(o) == 12
+
+
+def test_registered_types():
+    """Tests the registered C++ bases found for Python types, which are cached per type"""
+    assert m.registered_type_names(m.Base1) == ["Base1"]
+    assert m.registered_type_names(m.MVF) == ["MVF"]
+    assert m.registered_type_names(int) == []
+
+    class PyBase1(m.Base1):
+        pass
+
+    class PyMI(PyBase1, m.Base2):
+        def __init__(self, i, j):
+            m.Base1.__init__(self, i)
+            m.Base2.__init__(self, j)
+
+    for _ in range(2):
+        assert m.registered_type_names(PyBase1) == ["Base1"]
+        assert m.registered_type_names(PyMI) == ["Base1", "Base2"]
+        assert PyMI(1, 2).bar() == 2
+
+    # Types in a reference cycle with their instances can be destroyed before the instances, and
+    # new types may reuse their memory
+    for i in range(10):
+
+        class Cycle(m.Base2, m.Base1):
+            def __init__(self, i):
+                m.Base2.__init__(self, i)
+                m.Base1.__init__(self, i + 1)
+
+        Cycle.instance = Cycle(i)
+        assert m.registered_type_names(Cycle) == ["Base2", "Base1"]
+        assert Cycle.instance.foo() == i + 1
+        del Cycle
+        pytest.gc_collect()
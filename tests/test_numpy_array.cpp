@@ -7,12 +7,19 @@
     BSD-style license that can be found in the LICENSE file.
 */
 
+#include <pybind11/bool_numpy.h>
+#include <pybind11/complex_numpy.h>
 #include <pybind11/numpy.h>
 #include <pybind11/stl.h>
 
 #include "pybind11_tests.h"
 
+#include <algorithm>
+#include <bitset>
 #include <cstdint>
+#include <list>
+#include <memory>
+#include <numeric>
 #include <utility>
 
 // Size / dtype checks.
@@ -159,6 +166,27 @@ py::handle auxiliaries(T &&r, T2 &&r2) {
 // note: declaration at local scope would create a dangling reference!
 static int data_i = 42;
 
+// An allocator that keeps track of the bytes it has handed out, for array_t::allocate()
+static size_t counting_allocator_bytes = 0;
+
+template <typename T>
+struct CountingAllocator {
+    using value_type = T;
+
+    CountingAllocator() = default;
+    template <typename U>
+    explicit CountingAllocator(const CountingAllocator<U> &) {}
+
+    T *allocate(size_t n) {
+        counting_allocator_bytes += n * sizeof(T);
+        return std::allocator<T>().allocate(n);
+    }
+    void deallocate(T *p, size_t n) {
+        counting_allocator_bytes -= n * sizeof(T);
+        std::allocator<T>().deallocate(p, n);
+    }
+};
+
 TEST_SUBMODULE(numpy_array, sm) {
     try {
         py::module_::import("numpy");
@@ -229,6 +257,14 @@ TEST_SUBMODULE(numpy_array, sm) {
                          a);
     });
 
+    // test_copy_data
+    sm.def("copy_data", [](const py::array &a) {
+        return py::array(a.dtype(),
+                         {a.shape(), a.shape() + a.ndim()},
+                         {a.strides(), a.strides() + a.ndim()},
+                         a.data());
+    });
+
     // test_numpy_view
     struct ArrayClass {
         int data[2] = {1, 2};
@@ -304,6 +340,11 @@ TEST_SUBMODULE(numpy_array, sm) {
     sm.def("overloaded5", [](const py::array_t<unsigned int> &) { return "unsigned int"; });
     sm.def("overloaded5", [](const py::array_t<double> &) { return "double"; });
 
+    // The dtype of an array decides whether `array_t` loads it, so an overload taking one is
+    // not skipped for arrays once another overload was picked for `numpy.ndarray`
+    sm.def("overloaded6", [](const py::array_t<double, 0> &) { return "double"; });
+    sm.def("overloaded6", [](const py::array &) { return "array"; });
+
     // test_greedy_string_overload
     // Issue 685: ndarray shouldn't go to std::string overload
     sm.def("issue685", [](const std::string &) { return "string"; });
@@ -413,6 +454,57 @@ TEST_SUBMODULE(numpy_array, sm) {
 
     sm.def("array_auxiliaries2", [](py::array_t<double> a) { return auxiliaries(a, a); });
 
+    // test_array_unchecked_contiguous
+    sm.def("proxy_init3_contiguous", [](double start) {
+        py::array_t<double, py::array::c_style> a({3, 3, 3});
+        auto r = a.mutable_unchecked<3, py::array::c_style>();
+        for (py::ssize_t i = 0; i < r.shape(0); i++) {
+            for (py::ssize_t j = 0; j < r.shape(1); j++) {
+                for (py::ssize_t k = 0; k < r.shape(2); k++) {
+                    r(i, j, k) = start++;
+                }
+            }
+        }
+        return a;
+    });
+    sm.def("proxy_init3F_contiguous", [](double start) {
+        py::array_t<double, py::array::f_style> a({3, 3, 3});
+        auto r = a.mutable_unchecked<3, py::array::f_style>();
+        for (py::ssize_t k = 0; k < r.shape(2); k++) {
+            for (py::ssize_t j = 0; j < r.shape(1); j++) {
+                for (py::ssize_t i = 0; i < r.shape(0); i++) {
+                    r(i, j, k) = start++;
+                }
+            }
+        }
+        return a;
+    });
+    // Returns the elements in memory order, and the element at (1, 2) along with its offset
+    sm.def("proxy_contiguous_elements", [](const py::array_t<double> &a, bool f_order) {
+        auto elements = [](const double *begin, const double *end, const double *at12) {
+            // A list rather than a `std::vector<double>`, which is bound with `py::bind_vector`
+            // in another test
+            py::list values;
+            for (const auto *p = begin; p != end; ++p) {
+                values.append(*p);
+            }
+            return py::make_tuple(values, *at12, std::distance(begin, at12));
+        };
+        if (f_order) {
+            auto r = a.unchecked<2, py::array::f_style>();
+            return elements(r.begin(), r.end(), r.data(1, 2));
+        }
+        auto r = a.unchecked<2, py::array::c_style>();
+        return elements(r.begin(), r.end(), r.data(1, 2));
+    });
+    sm.def("proxy_contiguous_scale", [](py::array_t<double> a, double v) {
+        auto r = a.mutable_unchecked<1, py::array::c_style>();
+        for (auto &x : r) {
+            x *= v;
+        }
+        r[0] += static_cast<double>(r.size());
+    });
+
     // test_array_failures
     // Issue #785: Uninformative "Unknown internal error" exception when constructing array from
     // empty object:
@@ -516,6 +608,17 @@ TEST_SUBMODULE(numpy_array, sm) {
         [](const py::array_t<double, py::array::forcecast | py::array::f_style> &) {},
         "a"_a.noconvert());
 
+    // test_argument_exact_match
+    sm.def(
+        "pass_double_noconvert",
+        [](const py::array_t<double> &a) { return a; },
+        "a"_a.noconvert());
+    sm.def(
+        "pass_int64_c_style_noconvert",
+        [](const py::array_t<std::int64_t, py::array::c_style> &a) { return a; },
+        "a"_a.noconvert());
+    sm.def("pass_double", [](const py::array_t<double> &a) { return a; });
+
     // Check that types returns correct npy format descriptor
     sm.def("test_fmt_desc_float", [](const py::array_t<float> &) {});
     sm.def("test_fmt_desc_double", [](const py::array_t<double> &) {});
@@ -549,4 +652,180 @@ TEST_SUBMODULE(numpy_array, sm) {
 
     sm.def("return_array_pyobject_ptr_from_list",
            [](const py::list &objs) -> py::array_t<PyObject *> { return objs; });
+
+    // test_array_allocate
+    sm.def("allocate_array", [](const std::vector<py::ssize_t> &shape, bool f_order) {
+        if (f_order) {
+            return py::array_t<double>(py::array_t<double, py::array::f_style>::allocate(
+                shape, CountingAllocator<char>()));
+        }
+        auto a = py::array_t<double>::allocate(shape, CountingAllocator<double>());
+        std::iota(a.mutable_data(), a.mutable_data() + a.size(), 0.0);
+        return a;
+    });
+    sm.def("counting_allocator_bytes", []() { return counting_allocator_bytes; });
+
+#if defined(PYBIND11_NUMPY_HAS_MMAP)
+    // test_array_mmap
+    sm.def("mmap_array",
+           [](const std::string &path,
+              std::vector<py::ssize_t> shape,
+              const std::string &mode,
+              py::ssize_t offset,
+              const std::string &advice) {
+               auto m = mode == "r+"  ? py::mmap_mode::read_write
+                        : mode == "c" ? py::mmap_mode::copy_on_write
+                                      : py::mmap_mode::read_only;
+               auto a = advice == "sequential" ? py::mmap_advice::sequential
+                        : advice == "random"   ? py::mmap_advice::random
+                                               : py::mmap_advice::normal;
+               return py::array_t<std::int32_t>::mmap(path, std::move(shape), m, offset, a);
+           });
+    sm.def("mmap_array_f", [](const std::string &path, std::vector<py::ssize_t> shape) {
+        return py::array_t<double, py::array::f_style>::mmap(path, std::move(shape));
+    });
+#endif
+
+    // test_nditer
+    sm.def("nditer_chunks", [](const py::array &a, const py::array &b) {
+        py::list chunks;
+        py::nditer<2>({a, b}).for_each([&chunks](const py::nditer<2>::chunk &c) {
+            chunks.append(py::make_tuple(c.size, c.strides[0], c.strides[1]));
+        });
+        return chunks;
+    });
+    sm.def("nditer_add", [](const py::array_t<double> &a, const py::array_t<double> &b) {
+        py::array_t<double> out(py::nditer<2>({a, b}).shape());
+        py::nditer<3>({a, b, out}).for_each_without_gil([](const py::nditer<3>::chunk &c) {
+            for (py::ssize_t i = 0; i < c.size; ++i) {
+                c.at<2, double>(i) = c.at<0, double>(i) + c.at<1, double>(i);
+            }
+        });
+        return out;
+    });
+
+    // test_array_aligned
+    sm.def("aligned_array", [](const std::vector<py::ssize_t> &shape, bool huge_pages) {
+        if (huge_pages) {
+            py::array_t<float> a(shape, py::aligned<64>(true));
+            std::fill(a.mutable_data(), a.mutable_data() + a.size(), 1.0f);
+            return a;
+        }
+        py::array_t<float, py::array::f_style> a(shape, py::aligned<256>());
+        std::fill(a.mutable_data(), a.mutable_data() + a.size(), 2.0f);
+        return py::array_t<float>(a);
+    });
+
+    // test_array_from_vector, test_array_from_unique_ptr
+    sm.def("array_from_vector", [](const std::vector<py::ssize_t> &shape, bool f_order) {
+        std::vector<double> v(6);
+        std::iota(v.begin(), v.end(), 0.0);
+        const auto address = reinterpret_cast<std::uintptr_t>(v.data());
+        if (f_order) {
+            return py::make_tuple(
+                py::array_t<double, py::array::f_style>::from_vector(std::move(v), shape),
+                address);
+        }
+        if (shape.empty()) {
+            return py::make_tuple(py::array_t<double>::from_vector(std::move(v)), address);
+        }
+        return py::make_tuple(py::array_t<double>::from_vector(std::move(v), shape), address);
+    });
+    static int deleted_unique_ptrs = 0;
+    struct CountingArrayDeleter {
+        void operator()(int *p) const {
+            delete[] p;
+            ++deleted_unique_ptrs;
+        }
+    };
+    sm.def("array_from_unique_ptr", [](bool transposed) {
+        std::unique_ptr<int[], CountingArrayDeleter> data(new int[6]{0, 1, 2, 3, 4, 5});
+        if (transposed) {
+            return py::array_t<int>::from_unique_ptr(
+                std::move(data), {3, 2}, {sizeof(int), 3 * sizeof(int)});
+        }
+        return py::array_t<int>::from_unique_ptr(std::move(data), {2, 3});
+    });
+    sm.def("deleted_unique_ptrs", []() { return deleted_unique_ptrs; });
+
+    // test_chunked_iterator
+    struct ChunkSource {
+        std::vector<double> values;
+        std::list<int> ints;
+    };
+    py::class_<ChunkSource>(sm, "ChunkSource")
+        .def(py::init([](int n) {
+            ChunkSource s;
+            for (int i = 0; i < n; ++i) {
+                s.values.push_back(i);
+                s.ints.push_back(i);
+            }
+            return s;
+        }))
+        .def(
+            "chunks",
+            [](ChunkSource &s, ssize_t size) { return py::make_chunked_iterator(s.values, size); },
+            py::keep_alive<0, 1>())
+        .def(
+            "views",
+            [](ChunkSource &s, ssize_t size) {
+                return py::make_chunked_iterator<py::return_value_policy::reference_internal>(
+                    s.values, size);
+            },
+            py::keep_alive<0, 1>())
+        .def(
+            "const_views",
+            [](const ChunkSource &s, ssize_t size) {
+                return py::make_chunked_iterator<py::return_value_policy::reference_internal>(
+                    s.values, size);
+            },
+            py::keep_alive<0, 1>())
+        .def(
+            "int_chunks",
+            [](ChunkSource &s, ssize_t size) { return py::make_chunked_iterator(s.ints, size); },
+            py::keep_alive<0, 1>());
+
+    // test_complex_vector
+    sm.def("complex_spectrum", [](size_t n) {
+        std::vector<std::complex<double>> bins(n);
+        for (size_t i = 0; i < n; i++) {
+            bins[i] = std::complex<double>(static_cast<double>(i), -static_cast<double>(i));
+        }
+        return bins;
+    });
+    auto complex_sum = [](const std::vector<std::complex<double>> &bins) {
+        return std::accumulate(bins.begin(), bins.end(), std::complex<double>());
+    };
+    sm.def("complex_sum", complex_sum);
+    sm.def("complex_sum_noconvert", complex_sum, py::arg().noconvert());
+    sm.def("complex_float_pass_through",
+           [](const std::vector<std::complex<float>> &bins) { return bins; });
+
+    // test_bool_mask
+    using Mask = py::bool_array<std::vector<bool>>;
+    using Bits10 = py::bool_array<std::bitset<10>>;
+    sm.def("mask_every", [](size_t n, size_t step) {
+        std::vector<bool> mask(n);
+        for (size_t i = 0; i < n; i += step) {
+            mask[i] = true;
+        }
+        return py::as_bool_array(std::move(mask));
+    });
+    // Without py::bool_array, std::vector<bool> is still converted by stl.h
+    sm.def("mask_every_list", [](size_t n, size_t step) {
+        std::vector<bool> mask(n);
+        for (size_t i = 0; i < n; i += step) {
+            mask[i] = true;
+        }
+        return mask;
+    });
+    sm.def("mask_count",
+           [](const Mask &mask) { return std::count(mask->begin(), mask->end(), true); });
+    sm.def("bitset_flip", [](Bits10 bits) {
+        bits->flip();
+        return bits;
+    });
+    sm.def("pack_mask", [](const Mask &mask) { return py::pack_bits(*mask); });
+    sm.def("pack_bitset", [](const Bits10 &bits) { return py::pack_bits(*bits); });
+    sm.def("unpack_mask", &py::unpack_bits, py::arg("packed"), py::arg("count") = -1);
 }
@@ -244,6 +244,22 @@ def test_wrap():
     assert_references(a1m, a2, a1)
 
 
+@pytest.mark.parametrize("size", [4, 1 << 20])
+def test_copy_data(size):
+    # Copies of more than a megabyte are made with the GIL released
+    a = np.arange(2 * size, dtype=np.float64).reshape(2, size)
+    objects = np.array(["x", "y"] * size, dtype=object)
+    for src in (a, np.asfortranarray(a), a[:, ::2], objects):
+        copy = m.copy_data(src)
+        assert copy.dtype == src.dtype
+        assert copy.shape == src.shape
+        if src.flags.c_contiguous or src.flags.f_contiguous:
+            assert copy.strides == src.strides
+        assert copy.flags.owndata
+        assert not np.shares_memory(copy, src)
+        np.testing.assert_array_equal(copy, src)
+
+
 def test_numpy_view(capture):
     with capture:
         ac = m.ArrayClass()
@@ -372,6 +388,10 @@ def test_overload_resolution(msg):
     assert m.overloaded5(np.array([1], dtype="uintc")) == "unsigned int"
     assert m.overloaded5(np.array([1], dtype="float32")) == "unsigned int"
 
+    assert m.overloaded6(np.array([1], dtype="int64")) == "array"
+    assert m.overloaded6(np.array([1], dtype="float64")) == "double"
+    assert m.overloaded6(np.array([1], dtype="int64")) == "array"
+
 
 def test_greedy_string_overload():
     """Tests fix for #685 - ndarray shouldn't go to std::string overload"""
@@ -419,6 +439,41 @@ def test_array_unchecked_dyn_dims():
     assert m.proxy_auxiliaries2_dyn(z1) == m.array_auxiliaries2(z1)
 
 
+def test_array_unchecked_contiguous(msg):
+    expect_c = np.ndarray(shape=(3, 3, 3), buffer=np.array(range(3, 30)), dtype="int")
+    assert np.all(m.proxy_init3_contiguous(3.0) == expect_c)
+    assert np.all(m.proxy_init3F_contiguous(3.0) == np.transpose(expect_c))
+
+    z = np.arange(12.0).reshape(3, 4)
+    assert m.proxy_contiguous_elements(z, False) == (list(range(12)), 6.0, 6)
+    zf = np.asfortranarray(z)
+    assert m.proxy_contiguous_elements(zf, True) == (
+        [0, 4, 8, 1, 5, 9, 2, 6, 10, 3, 7, 11],
+        6.0,
+        7,
+    )
+
+    # The layout is checked once, when the proxy is created
+    with pytest.raises(ValueError) as excinfo:
+        m.proxy_contiguous_elements(zf, False)
+    assert msg(excinfo.value) == "array is not C-contiguous"
+    with pytest.raises(ValueError) as excinfo:
+        m.proxy_contiguous_elements(z, True)
+    assert msg(excinfo.value) == "array is not Fortran-contiguous"
+    with pytest.raises(ValueError) as excinfo:
+        m.proxy_contiguous_elements(np.arange(4.0), False)
+    assert (
+        msg(excinfo.value) == "array has incorrect number of dimensions: 1; expected 2"
+    )
+
+    v = np.arange(5.0)
+    m.proxy_contiguous_scale(v, 2)
+    np.testing.assert_array_equal(v, [5, 2, 4, 6, 8])
+    with pytest.raises(ValueError) as excinfo:
+        m.proxy_contiguous_scale(np.arange(10.0)[::2], 2)
+    assert msg(excinfo.value) == "array is not C-contiguous"
+
+
 def test_array_failure():
     with pytest.raises(ValueError) as excinfo:
         m.array_fail_test()
@@ -579,6 +634,35 @@ def test_argument_conversions(forcecast, contiguity, noconvert):
                         function(array)
 
 
+def test_argument_exact_match():
+    a = np.zeros((2, 3))
+    assert m.pass_double_noconvert(a) is a
+    assert m.pass_double(a) is a
+    t = a.T
+    assert m.pass_double_noconvert(t) is t
+
+    # Equivalent dtypes with another type number are accepted as they are
+    i = np.zeros(3, dtype="q" if np.dtype("q").itemsize == 8 else "l")
+    assert m.pass_int64_c_style_noconvert(i) is i
+    with pytest.raises(TypeError, match="incompatible function arguments"):
+        m.pass_int64_c_style_noconvert(np.zeros((2, 3), dtype=np.int64).T)
+
+    # The byte order is part of the dtype
+    swapped = np.zeros(3, dtype=np.dtype("f8").newbyteorder())
+    with pytest.raises(TypeError, match="incompatible function arguments"):
+        m.pass_double_noconvert(swapped)
+    converted = m.pass_double(swapped)
+    assert converted.dtype.isnative
+    assert converted is not swapped
+
+    # Subclasses are converted to plain arrays
+    class Sub(np.ndarray):
+        pass
+
+    sub = a.view(Sub)
+    assert type(m.pass_double(sub)) is np.ndarray
+
+
 @pytest.mark.xfail("env.PYPY")
 def test_dtype_refcount_leak():
     from sys import getrefcount
@@ -666,3 +750,254 @@ def test_return_array_pyobject_ptr_cpp_loop(return_array_pyobject_ptr, unwrap):
     assert isinstance(arr_from_list, np.ndarray)
     assert arr_from_list.dtype == np.dtype("O")
     assert unwrap(arr_from_list) == [6, "seven", -8.0]
+
+
+def test_array_allocate():
+    assert m.counting_allocator_bytes() == 0
+    a = m.allocate_array([3, 4], False)
+    assert m.counting_allocator_bytes() == 3 * 4 * 8
+    assert a.flags.c_contiguous
+    assert a.flags.writeable
+    assert not a.flags.owndata
+    np.testing.assert_array_equal(a, np.arange(12.0).reshape(3, 4))
+
+    # Views keep the memory alive
+    view = a[1:, ::2]
+    del a
+    pytest.gc_collect()
+    assert m.counting_allocator_bytes() == 3 * 4 * 8
+    assert view.tolist() == [[4.0, 6.0], [8.0, 10.0]]
+    del view
+    pytest.gc_collect()
+    assert m.counting_allocator_bytes() == 0
+
+    b = m.allocate_array([2, 5, 3], True)
+    assert b.shape == (2, 5, 3)
+    assert b.flags.f_contiguous
+    assert m.counting_allocator_bytes() == 2 * 5 * 3 * 8
+    del b
+    pytest.gc_collect()
+    assert m.counting_allocator_bytes() == 0
+
+    # Nothing is allocated for empty arrays, and NumPy rejects invalid shapes
+    assert m.allocate_array([0, 3], False).shape == (0, 3)
+    assert m.counting_allocator_bytes() == 0
+    with pytest.raises(ValueError):
+        m.allocate_array([2, -1], False)
+
+
+@pytest.mark.skipif(not hasattr(m, "mmap_array"), reason="no mmap support")
+def test_array_mmap(tmp_path):
+    path = tmp_path / "data.bin"
+    data = np.arange(4096 + 12, dtype=np.int32)
+    data.tofile(path)
+
+    a = m.mmap_array(str(path), [3, 4], "r", 0, "normal")
+    np.testing.assert_array_equal(a, data[:12].reshape(3, 4))
+    assert not a.flags.writeable
+    with pytest.raises(ValueError):
+        a[0, 0] = 1
+
+    # Offsets need not be multiples of the page size
+    b = m.mmap_array(str(path), [4, 3], "r", 4 * 4097, "sequential")
+    np.testing.assert_array_equal(b, data[4097:4109].reshape(4, 3))
+
+    c = m.mmap_array(str(path), [12], "c", 0, "random")
+    c[:] = -1
+    assert np.fromfile(path, dtype=np.int32)[0] == 0
+
+    w = m.mmap_array(str(path), [12], "r+", 4, "normal")
+    w[0] = 42
+    del w, a, c
+    pytest.gc_collect()
+    assert np.fromfile(path, dtype=np.int32)[1] == 42
+
+    f = m.mmap_array_f(str(path), [2, 3])
+    assert f.flags.f_contiguous
+    np.testing.assert_array_equal(f.ravel(order="F"), data[:12].view(np.float64))
+
+    assert m.mmap_array(str(path), [0, 5], "r", 0, "normal").shape == (0, 5)
+    with pytest.raises(ValueError, match="too small"):
+        m.mmap_array(str(path), [4109], "r", 0, "normal")
+    with pytest.raises(ValueError, match="too small"):
+        m.mmap_array(str(path), [1], "r", 1 << 20, "normal")
+    with pytest.raises(FileNotFoundError):
+        m.mmap_array(str(tmp_path / "missing.bin"), [1], "r", 0, "normal")
+
+
+def test_nditer():
+    c = np.zeros((3, 4))
+    f = np.asfortranarray(c)
+    # Contiguous operands are visited in one chunk, whatever their order
+    assert m.nditer_chunks(c, c) == [(12, 8, 8)]
+    assert m.nditer_chunks(f, f) == [(12, 8, 8)]
+    assert m.nditer_chunks(c, np.zeros(())) == [(12, 8, 0)]
+    # Otherwise, the chunks follow the layout of the first operand
+    assert m.nditer_chunks(c, f) == [(4, 8, 24)] * 3
+    assert m.nditer_chunks(f, c) == [(3, 8, 32)] * 4
+    assert m.nditer_chunks(c, np.zeros(4)) == [(4, 8, 8)] * 3
+    assert m.nditer_chunks(c, np.zeros((3, 1))) == [(4, 8, 0)] * 3
+    assert m.nditer_chunks(c[:, ::2], c[::-1, 1::2]) == [(2, 16, 16)] * 3
+    assert m.nditer_chunks(np.zeros(()), np.zeros((1, 1))) == [(1, 0, 0)]
+    assert m.nditer_chunks(np.zeros((0, 3)), np.zeros(3)) == []
+    with pytest.raises(ValueError, match="could not be broadcast"):
+        m.nditer_chunks(np.zeros(3), np.zeros(4))
+
+    x = np.arange(12.0).reshape(3, 4)
+    for a, b in [
+        (x, x),
+        (x, x[0]),
+        (x[:, :1], x),
+        (np.asfortranarray(x), x[::-1, ::-1]),
+        (x.T, np.arange(3.0)),
+        (2.0, x),
+        (x.astype(int), x[::2]),
+    ]:
+        np.testing.assert_array_equal(m.nditer_add(a, b), np.add(a, b))
+
+
+def test_array_aligned():
+    a = m.aligned_array([5, 7], False)
+    assert a.__array_interface__["data"][0] % 256 == 0
+    assert a.flags.f_contiguous
+    np.testing.assert_array_equal(a, np.full((5, 7), 2.0))
+
+    b = m.aligned_array([1000], True)
+    assert b.__array_interface__["data"][0] % (1 << 21) == 0
+    np.testing.assert_array_equal(b, np.ones(1000))
+
+    assert m.aligned_array([0, 3], False).shape == (0, 3)
+
+
+def test_array_from_vector():
+    a, address = m.array_from_vector([], False)
+    assert a.shape == (6,)
+    assert a.__array_interface__["data"][0] == address
+    assert a.flags.writeable
+    np.testing.assert_array_equal(a, np.arange(6.0))
+
+    a, address = m.array_from_vector([2, 3], False)
+    assert a.__array_interface__["data"][0] == address
+    np.testing.assert_array_equal(a, np.arange(6.0).reshape(2, 3))
+    a, address = m.array_from_vector([2, 3], True)
+    assert a.__array_interface__["data"][0] == address
+    assert a.flags.f_contiguous
+    np.testing.assert_array_equal(a, np.arange(6.0).reshape(3, 2).T)
+
+    with pytest.raises(ValueError, match="does not match"):
+        m.array_from_vector([4, 2], False)
+
+
+def test_array_from_unique_ptr():
+    start = m.deleted_unique_ptrs()
+    a = m.array_from_unique_ptr(False)
+    np.testing.assert_array_equal(a, [[0, 1, 2], [3, 4, 5]])
+    b = m.array_from_unique_ptr(True)
+    np.testing.assert_array_equal(b, [[0, 3], [1, 4], [2, 5]])
+    view = a[1]
+    del a, b
+    pytest.gc_collect()
+    assert m.deleted_unique_ptrs() == start + 1
+    assert view.tolist() == [3, 4, 5]
+    del view
+    pytest.gc_collect()
+    assert m.deleted_unique_ptrs() == start + 2
+
+
+def test_chunked_iterator():
+    src = m.ChunkSource(10)
+    chunks = list(src.chunks(4))
+    assert [c.tolist() for c in chunks] == [[0, 1, 2, 3], [4, 5, 6, 7], [8, 9]]
+    assert all(c.dtype == np.float64 and c.flags.owndata for c in chunks)
+    assert [c.tolist() for c in src.int_chunks(3)] == [[0, 1, 2], [3, 4, 5], [6, 7, 8], [9]]
+    assert list(src.chunks(10))[0].tolist() == list(range(10))
+    assert list(m.ChunkSource(0).chunks(4)) == []
+
+    it = src.chunks(100)
+    assert iter(it) is it
+    next(it)
+    for _ in range(3):
+        with pytest.raises(StopIteration):
+            next(it)
+
+    views = list(src.views(6))
+    assert [v.tolist() for v in views] == [[0, 1, 2, 3, 4, 5], [6, 7, 8, 9]]
+    assert not views[0].flags.owndata
+    assert views[0].flags.writeable
+    views[0][0] = 42
+    assert next(src.chunks(1)).tolist() == [42]
+    const_views = list(src.const_views(5))
+    assert not const_views[0].flags.writeable
+    with pytest.raises(ValueError):
+        const_views[0][0] = 1
+    # The views keep the source alive
+    del src
+    pytest.gc_collect()
+    assert views[1].tolist() == [6, 7, 8, 9]
+
+    with pytest.raises(ValueError, match="chunk_size must be positive"):
+        m.ChunkSource(1).chunks(0)
+
+    it_type = type(m.ChunkSource(1).chunks(1))
+    with pytest.raises(TypeError):
+        next(it_type.__new__(it_type))
+
+
+def test_complex_vector():
+    a = m.complex_spectrum(4)
+    assert a.dtype == np.complex128
+    assert a.tolist() == [0j, 1 - 1j, 2 - 2j, 3 - 3j]
+    assert m.complex_spectrum(0).shape == (0,)
+
+    assert m.complex_sum(a) == 6 - 6j
+    assert m.complex_sum(a[::2]) == 2 - 2j
+    assert m.complex_sum(a.astype(np.complex64)) == 6 - 6j
+    assert m.complex_sum(np.arange(4.0)) == 6
+    assert m.complex_sum([1j, 2, 3 + 1j]) == 5 + 2j
+
+    assert m.complex_sum_noconvert(a) == 6 - 6j
+    with pytest.raises(TypeError):
+        m.complex_sum_noconvert(a.astype(np.complex64))
+    with pytest.raises(TypeError):
+        m.complex_sum(np.zeros((2, 2), dtype=np.complex128))
+
+    b = m.complex_float_pass_through(a)
+    assert b.dtype == np.complex64
+    assert b.tolist() == a.tolist()
+    assert "numpy.ndarray[numpy.complex64]" in m.complex_float_pass_through.__doc__
+
+
+def test_bool_mask():
+    mask = m.mask_every(10, 3)
+    assert mask.dtype == np.bool_
+    assert mask.tolist() == [i % 3 == 0 for i in range(10)]
+    assert m.mask_every_list(10, 3) == mask.tolist()
+
+    assert m.mask_count(mask) == 4
+    assert m.mask_count(mask[::2]) == 2
+    assert m.mask_count(np.array([0, 2, 0, 255], dtype=np.uint8)) == 2
+    assert m.mask_count(b"\x00\x01\x01") == 2
+    assert m.mask_count(np.array([0.0, 0.5, 1.0])) == 2
+    assert m.mask_count([True, False, True]) == 2
+    with pytest.raises(TypeError):
+        m.mask_count(np.zeros((2, 2), dtype=np.bool_))
+
+    flipped = m.bitset_flip(np.arange(10) % 2 == 0)
+    assert flipped.tolist() == [i % 2 == 1 for i in range(10)]
+    assert m.bitset_flip([False] * 10).all()
+    with pytest.raises(TypeError):
+        m.bitset_flip([False] * 9)
+
+
+def test_pack_bits():
+    mask = m.mask_every(21, 2)
+    packed = m.pack_mask(mask)
+    assert packed.dtype == np.uint8
+    np.testing.assert_array_equal(packed, np.packbits(mask))
+    np.testing.assert_array_equal(m.pack_bitset(mask[:10]), np.packbits(mask[:10]))
+    assert m.pack_mask([]).shape == (0,)
+
+    np.testing.assert_array_equal(m.unpack_mask(packed, 21), mask)
+    np.testing.assert_array_equal(m.unpack_mask(packed), np.unpackbits(packed) != 0)
+    with pytest.raises(ValueError, match="3 bytes do not hold 25 bits"):
+        m.unpack_mask(packed, 25)
@@ -605,10 +605,40 @@ TEST_SUBMODULE(numpy_dtypes, m) {
     auto f_simple_pass_thru = [](SimpleStruct s) { return s; };
     m.def("f_simple_pass_thru_vectorized", py::vectorize(f_simple_pass_thru));
 
+    // test_array_t_load
+    m.def(
+        "pass_array_simple_noconvert",
+        [](const py::array_t<SimpleStruct> &a) { return a; },
+        py::arg().noconvert());
+    m.def("pass_array_simple", [](const py::array_t<SimpleStruct> &a) { return a; });
+
     // test_register_dtype
     m.def("register_dtype",
           []() { PYBIND11_NUMPY_DTYPE(SimpleStruct, bool_, uint_, float_, ldbl_); });
 
     // test_str_leak
     m.def("dtype_wrapper", [](const py::object &d) { return py::dtype::from_args(d); });
+
+    // test_unchecked_field
+    m.def("sum_uint_field", [](const py::array_t<SimpleStruct> &a) {
+        auto r = a.unchecked_field<1>(&SimpleStruct::uint_);
+        uint64_t sum = 0;
+        for (py::ssize_t i = 0; i < r.shape(0); i++) {
+            sum += r(i);
+        }
+        return sum;
+    });
+    m.def("scale_float_field", [](py::array_t<SimpleStruct> a, float factor) {
+        auto r = a.mutable_unchecked_field<1>(&SimpleStruct::float_);
+        for (py::ssize_t i = 0; i < r.shape(0); i++) {
+            r(i) *= factor;
+        }
+    });
+    m.def("field_out_of_range",
+          [](const py::array &a) { a.unchecked_field<double, 1>(a.itemsize()); });
+
+    // test_columns
+    m.def("to_columns", [](const py::array &a) { return py::to_columns(a); });
+    m.def("from_columns_simple",
+          [](const py::dict &columns) { return py::from_columns<SimpleStruct>(columns); });
 }
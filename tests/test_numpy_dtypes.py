@@ -416,6 +416,28 @@ def test_cls_and_dtype_conversion(simple_dtype):
     np.testing.assert_array_equal(m.f_simple_vectorized(s_array), [20])
 
 
+def test_array_t_load(simple_dtype):
+    # Arrays of the registered dtype, or of an equivalent one, are passed as they are
+    arr = m.create_rec_simple(3)
+    assert m.pass_array_simple_noconvert(arr) is arr
+    assert m.pass_array_simple(arr) is arr
+    equivalent = np.zeros(2, dtype=simple_dtype)
+    assert equivalent.dtype is not arr.dtype
+    assert m.pass_array_simple_noconvert(equivalent) is equivalent
+
+    # Subclasses are still converted to plain arrays, without copying the data
+    class Sub(np.ndarray):
+        pass
+
+    sub = arr.view(Sub)
+    result = m.pass_array_simple(sub)
+    assert type(result) is np.ndarray
+    assert np.shares_memory(result, arr)
+
+    with pytest.raises(TypeError):
+        m.pass_array_simple_noconvert(np.zeros(2, dtype="f8"))
+
+
 def test_register_dtype():
     with pytest.raises(RuntimeError) as excinfo:
         m.register_dtype()
@@ -438,3 +460,33 @@ def test_str_leak():
 
 def test_compare_buffer_info():
     assert all(m.compare_buffer_info())
+
+
+def test_unchecked_field():
+    arr = m.create_rec_simple(4)
+    assert m.sum_uint_field(arr) == 0 + 1 + 2 + 3
+    m.scale_float_field(arr, 2.0)
+    assert arr["float_"].tolist() == [0.0, 3.0, 6.0, 9.0]
+
+    with pytest.raises(ValueError) as excinfo:
+        m.field_out_of_range(arr)
+    assert "does not fit" in str(excinfo.value)
+
+
+def test_columns(simple_dtype):
+    arr = m.create_rec_simple(3)
+    columns = m.to_columns(arr)
+    assert list(columns) == ["bool_", "uint_", "float_", "ldbl_"]
+    assert columns["uint_"].tolist() == [0, 1, 2]
+    assert columns["float_"].flags.c_contiguous
+
+    columns["uint_"][:] = [7, 8, 9]
+    assert arr["uint_"].tolist() == [0, 1, 2]
+
+    back = m.from_columns_simple(columns)
+    assert back.dtype == simple_dtype
+    assert back["uint_"].tolist() == [7, 8, 9]
+    assert back["float_"].tolist() == [0.0, 1.5, 3.0]
+
+    columns["uint_"] = [1.0, 2.0, 3.0]
+    assert m.from_columns_simple(columns)["uint_"].tolist() == [1, 2, 3]
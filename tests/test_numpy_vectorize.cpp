@@ -104,4 +104,21 @@ TEST_SUBMODULE(numpy_vectorize, m) {
           });
 
     m.def("add_to", py::vectorize([](NonPODClass &x, int a) { x.value += a; }));
+
+    // test_vectorize_strided
+    m.def("vectorized_strided_func",
+          py::vectorize([](double x, float y, int z) { return x * y + z; }));
+
+    // test_vectorize_parallel
+    m.def("vectorized_parallel_func",
+          py::vectorize([](double x, double y) { return x * y + 1.0; }, py::parallel(4)));
+    m.def("vectorized_parallel_throws",
+          py::vectorize(
+              [](int x) {
+                  if (x == 12345) {
+                      throw std::domain_error("12345");
+                  }
+                  return x;
+              },
+              py::parallel()));
 }
@@ -264,3 +264,49 @@ def test_vectorized_noreturn():
     assert x.value == 11
     m.add_to(x, [[1, 1], [2, 3]])
     assert x.value == 18
+
+
+def test_vectorize_strided():
+    f = m.vectorized_strided_func
+    x = np.arange(120, dtype=float).reshape(4, 5, 6)
+    y = np.arange(60, dtype=np.float32).reshape(5, 12)[:, ::2]
+    z = np.arange(4, dtype=np.int32).reshape(4, 1, 1)
+
+    # Contiguous inputs without singletons, with and without a broadcast scalar
+    np.testing.assert_array_equal(f(x, x, x.astype(np.int32)), x * x + x)
+    np.testing.assert_array_equal(f(x, 2, 1), x * 2 + 1)
+
+    # Strided, reversed and transposed inputs, and broadcasting along the last dimension
+    np.testing.assert_array_equal(f(x, y, z), x * y + z)
+    np.testing.assert_array_equal(f(x[:, ::-2], y[::-2], 3), x[:, ::-2] * y[::-2] + 3)
+    np.testing.assert_array_equal(f(x[..., :1], y, z), x[..., :1] * y + z)
+    np.testing.assert_array_equal(f(x.T, x.T[::-1], 1), x.T * x.T[::-1] + 1)
+
+    # Threads that start or end within a row
+    a = np.linspace(0, 1, 3 * 10007 * 3).reshape(3, 10007, 3)[:, :, ::2]
+    b = np.arange(10007, dtype=float)[::-1].reshape(10007, 1)
+    np.testing.assert_array_equal(m.vectorized_parallel_func(a, b), a * b + 1)
+
+
+def test_vectorize_parallel():
+    x = np.arange(100000, dtype=float)
+    y = np.linspace(-1, 1, 100000)
+    np.testing.assert_array_equal(m.vectorized_parallel_func(x, y), x * y + 1)
+
+    # Broadcasting, and Fortran order
+    a = np.arange(400, dtype=float).reshape(400, 1)
+    b = np.arange(300, dtype=float)
+    np.testing.assert_array_equal(m.vectorized_parallel_func(a, b), a * b + 1)
+    c = np.asfortranarray(np.arange(120000, dtype=float).reshape(300, 400))
+    result = m.vectorized_parallel_func(c, c)
+    assert result.flags.f_contiguous
+    np.testing.assert_array_equal(result, c * c + 1)
+
+    # Small inputs are not split
+    assert m.vectorized_parallel_func(2.0, 3.0) == 7
+
+    # Exceptions from any of the threads are propagated
+    ints = np.arange(100000)
+    np.testing.assert_array_equal(m.vectorized_parallel_throws(ints[:12345]), ints[:12345])
+    with pytest.raises(ValueError, match="12345"):
+        m.vectorized_parallel_throws(ints)
@@ -14,6 +14,7 @@
 #include "pybind11_tests.h"
 
 #include <functional>
+#include <stdexcept>
 
 class Vector2 {
 public:
@@ -132,6 +133,28 @@ struct hash<HashMe> {
 // Not a good abs function, but easy to test.
 std::string abs(const Vector2 &) { return "abs(Vector2)"; }
 
+struct SlotInt {
+    int value;
+    SlotInt operator+(const SlotInt &o) const { return {value + o.value}; }
+    SlotInt operator+(int i) const { return {value + i}; }
+    friend SlotInt operator+(int i, const SlotInt &o) { return {i + o.value}; }
+    SlotInt operator/(const SlotInt &o) const {
+        if (o.value == 0) {
+            throw std::domain_error("division by zero");
+        }
+        return {value / o.value};
+    }
+    SlotInt &operator+=(const SlotInt &o) {
+        value += o.value;
+        return *this;
+    }
+    SlotInt operator-() const { return {-value}; }
+    bool operator==(const SlotInt &o) const { return value == o.value; }
+    bool operator<(const SlotInt &o) const { return value < o.value; }
+};
+
+struct SlotIntOverridden : SlotInt {};
+
 // clang 7.0.0 and Apple LLVM 10.0.1 introduce `-Wself-assign-overloaded` to
 // `-Wall`, which is used here for overloading (e.g. `py::self += py::self `).
 // Here, we suppress the warning
@@ -182,6 +205,51 @@ TEST_SUBMODULE(operators, m) {
 
     m.attr("Vector") = m.attr("Vector2");
 
+    // test_operator_slots
+    py::class_<SlotInt>(m, "SlotInt")
+        .def(py::init<int>())
+        .def_readonly("value", &SlotInt::value)
+        .def(py::self + py::self)
+        .def(py::self + int())
+        .def(int() + py::self)
+        .def(py::self / py::self)
+        .def(py::self += py::self)
+        .def(-py::self)
+        .def(py::self == py::self)
+        .def(py::self < py::self);
+
+    // Another overload first, which the slot must not bypass
+    py::class_<SlotIntOverridden>(m, "SlotIntOverridden")
+        .def(py::init([](int value) { return SlotIntOverridden{{value}}; }))
+        .def("__add__",
+             [](const SlotIntOverridden &, const SlotIntOverridden &) { return "overridden"; })
+        .def(py::self + py::self)
+        .def(-py::self)
+        .def("__neg__", [](const SlotIntOverridden &, int) { return "never called"; });
+
+    // Which slots of `type` differ from those of `reference`, a Python class with the same methods
+    m.def("fast_operator_slots", [](const py::type &type, const py::type &reference) {
+        auto *t = reinterpret_cast<PyTypeObject *>(type.ptr());
+        auto *r = reinterpret_cast<PyTypeObject *>(reference.ptr());
+        py::list slots;
+        if (t->tp_as_number->nb_add != r->tp_as_number->nb_add) {
+            slots.append("nb_add");
+        }
+        if (t->tp_as_number->nb_true_divide != r->tp_as_number->nb_true_divide) {
+            slots.append("nb_true_divide");
+        }
+        if (t->tp_as_number->nb_inplace_add != r->tp_as_number->nb_inplace_add) {
+            slots.append("nb_inplace_add");
+        }
+        if (t->tp_as_number->nb_negative != r->tp_as_number->nb_negative) {
+            slots.append("nb_negative");
+        }
+        if (t->tp_richcompare != r->tp_richcompare) {
+            slots.append("tp_richcompare");
+        }
+        return slots;
+    });
+
     // test_operators_notimplemented
     // #393: need to return NotSupported to ensure correct arithmetic operator behavior
     py::class_<C1>(m, "C1").def(py::init<>()).def(py::self + py::self);
@@ -1,5 +1,6 @@
 import pytest
 
+import env
 from pybind11_tests import ConstructorStats
 from pybind11_tests import operators as m
 
@@ -91,6 +92,79 @@ def test_operators_notimplemented():
     assert c1 + c2 == 12
 
 
+def test_operator_slots():
+    class Generic:
+        def __add__(self, other):
+            pass
+
+        __truediv__ = __iadd__ = __neg__ = __eq__ = __add__
+
+    expected = ["nb_add", "nb_true_divide", "nb_inplace_add", "nb_negative", "tp_richcompare"]
+    assert m.fast_operator_slots(m.SlotInt, Generic) == ([] if env.PYPY else expected)
+    # `__add__` has another overload first, and `__neg__` is defined again after the operator
+    overridden = m.fast_operator_slots(m.SlotIntOverridden, Generic)
+    assert "nb_add" not in overridden
+    assert "nb_negative" not in overridden
+
+    a, b = m.SlotInt(6), m.SlotInt(3)
+    assert (a + b).value == 9
+    assert (a + 1).value == 7
+    assert (1 + a).value == 7
+    assert (a / b).value == 2
+    assert (-a).value == -6
+    assert a == m.SlotInt(6)
+    assert a != b
+    assert b < a
+    assert a > b
+    assert not a < b
+    with pytest.raises(ValueError, match="division by zero"):
+        a / m.SlotInt(0)
+    with pytest.raises(TypeError):
+        a + "x"
+    with pytest.raises(TypeError):
+        a < 1
+
+    c = a
+    a += b
+    assert a is c
+    assert a.value == 9
+
+    x, y = m.SlotIntOverridden(1), m.SlotIntOverridden(2)
+    assert x + y == "overridden"
+    assert (-x).value == -1
+
+
+def test_operator_slots_fallback():
+    class Sub(m.SlotInt):
+        def __add__(self, other):
+            return "Sub.__add__"
+
+        def __neg__(self):
+            return "Sub.__neg__"
+
+        def __eq__(self, other):
+            return "Sub.__eq__"
+
+    class Plain(m.SlotInt):
+        pass
+
+    class Other:
+        def __radd__(self, other):
+            return "Other.__radd__"
+
+    a = m.SlotInt(1)
+    assert Sub(1) + Sub(2) == "Sub.__add__"
+    assert Sub(1) + a == "Sub.__add__"
+    assert (a + Sub(2)).value == 3
+    assert -Sub(1) == "Sub.__neg__"
+    assert (Sub(1) == a) == "Sub.__eq__"
+    assert (a == Sub(1)) == "Sub.__eq__"
+    assert (Plain(1) + Plain(2)).value == 3
+    assert (-Plain(1)).value == -1
+    assert Plain(1) == Plain(1)
+    assert a + Other() == "Other.__radd__"
+
+
 def test_nested():
     """#328: first member in a class can't be used in operators"""
 
@@ -10,9 +10,12 @@
 
 #include "pybind11_tests.h"
 
+#include <cstring>
 #include <memory>
 #include <stdexcept>
+#include <string>
 #include <utility>
+#include <vector>
 
 namespace exercise_trampoline {
 
@@ -129,6 +132,42 @@ TEST_SUBMODULE(pickling, m) {
                 return p;
             }));
 
+    // test_roundtrip_with_buffers
+    struct PickleableBuffer {
+        std::string name;
+        std::shared_ptr<std::vector<double>> values;
+    };
+    py::class_<PickleableBuffer>(m, "PickleableBuffer")
+        .def(py::init([](const std::string &name, size_t size) {
+            PickleableBuffer p{name, std::make_shared<std::vector<double>>(size)};
+            for (size_t i = 0; i < size; ++i) {
+                (*p.values)[i] = static_cast<double>(i) / 2;
+            }
+            return p;
+        }))
+        .def_readonly("name", &PickleableBuffer::name)
+        .def("values",
+             [](const PickleableBuffer &p) {
+                 return py::list::from_range(p.values->begin(), p.values->end());
+             })
+        .def(py::pickle(
+            [](const PickleableBuffer &p) {
+                // Shares the values, which protocol 5 can pickle out-of-band
+                auto size = static_cast<py::ssize_t>(p.values->size() * sizeof(double));
+                return py::make_tuple(
+                    p.name, py::memoryview::from_shared(p.values, p.values->data(), size, true));
+            },
+            [](const py::tuple &t) {
+                if (t.size() != 2) {
+                    throw std::runtime_error("Invalid state!");
+                }
+                auto info = t[1].cast<py::buffer>().request();
+                auto size = static_cast<size_t>(info.size * info.itemsize);
+                auto values = std::make_shared<std::vector<double>>(size / sizeof(double));
+                std::memcpy(values->data(), info.ptr, values->size() * sizeof(double));
+                return PickleableBuffer{t[0].cast<std::string>(), std::move(values)};
+            }));
+
 #if !defined(PYPY_VERSION)
     // test_roundtrip_with_dict
     class PickleableWithDict {
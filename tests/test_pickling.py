@@ -1,3 +1,4 @@
+import copy
 import pickle
 import re
 
@@ -35,6 +36,29 @@ def test_roundtrip(cls_name):
     assert p2.extra2() == p.extra2()
 
 
+def test_roundtrip_with_buffers():
+    p = m.PickleableBuffer("values", 1000)
+    for protocol in range(2, pickle.HIGHEST_PROTOCOL + 1):
+        p2 = pickle.loads(pickle.dumps(p, protocol))
+        assert p2.name == "values"
+        assert p2.values() == p.values()
+    p2 = copy.deepcopy(p)
+    assert p2.values() == p.values()
+
+
+@pytest.mark.skipif(pickle.HIGHEST_PROTOCOL < 5, reason="needs pickle protocol 5")
+def test_roundtrip_with_out_of_band_buffers():
+    p = m.PickleableBuffer("values", 1000)
+    buffers = []
+    data = pickle.dumps(p, 5, buffer_callback=buffers.append)
+    assert len(data) < 1000
+    assert len(buffers) == 1
+    assert buffers[0].raw().nbytes == 8000
+    p2 = pickle.loads(data, buffers=buffers)
+    assert p2.name == "values"
+    assert p2.values() == p.values()
+
+
 @pytest.mark.xfail("env.PYPY")
 @pytest.mark.parametrize("cls_name", ["PickleableWithDict", "PickleableWithDictNew"])
 def test_roundtrip_with_dict(cls_name):
@@ -9,7 +9,14 @@
 
 #include "pybind11_tests.h"
 
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
 #include <utility>
+#include <vector>
 
 namespace external {
 namespace detail {
@@ -98,6 +105,19 @@ void m_defs(py::module_ &m) {
 
 } // namespace handle_from_move_only_type_with_operator_PyObject
 
+namespace owned_memory {
+
+bool freed = false;
+
+struct FlaggingDeleter {
+    void operator()(std::int32_t *ptr) const {
+        delete[] ptr;
+        freed = true;
+    }
+};
+
+} // namespace owned_memory
+
 TEST_SUBMODULE(pytypes, m) {
     m.def("obj_class_name", [](py::handle obj) { return py::detail::obj_class_name(obj.ptr()); });
 
@@ -619,6 +639,20 @@ TEST_SUBMODULE(pytypes, m) {
         return py::memoryview::from_buffer(buf, 1, "B", {3}, {});
     });
 
+    m.def("test_memoryview_from_owned", []() {
+        owned_memory::freed = false;
+        std::unique_ptr<std::int32_t[], owned_memory::FlaggingDeleter> data(
+            new std::int32_t[4]{1, 2, 3, 4});
+        return py::memoryview::from_owned(std::move(data), 4);
+    });
+    m.def("owned_memory_freed", []() { return owned_memory::freed; });
+    m.def("test_memoryview_from_shared", []() {
+        auto payload = std::make_shared<std::string>("payload");
+        const void *data = payload->data();
+        auto size = static_cast<py::ssize_t>(payload->size());
+        return py::memoryview::from_shared(std::move(payload), data, size);
+    });
+
     m.def("test_memoryview_from_buffer_nullptr", []() {
         return py::memoryview::from_buffer(static_cast<void *>(nullptr), 1, "B", {}, {});
     });
@@ -820,4 +854,83 @@ TEST_SUBMODULE(pytypes, m) {
         a >>= b;
         return a;
     });
+
+    // test_interned_str
+    m.def("interned_str_twice", []() {
+        static py::interned_str value("pybind11_interned_str");
+        return py::make_tuple(value.get(), value.get());
+    });
+    m.def("get_interned_attr", [](const py::object &o) {
+        static py::interned_str attr_name("interned_attr");
+        return o.attr(attr_name);
+    });
+    m.def("set_interned_attr", [](const py::object &o, const py::object &value) {
+        static py::interned_str attr_name("interned_attr");
+        o.attr(attr_name) = value;
+    });
+
+    // test_from_range
+    m.def("list_from_range", []() {
+        std::vector<int> values{1, 2, 3};
+        return py::list::from_range(values.begin(), values.end());
+    });
+    m.def("tuple_from_moved_range", []() {
+        std::vector<std::string> values{"a", "b"};
+        return py::tuple::from_range(std::make_move_iterator(values.begin()),
+                                     std::make_move_iterator(values.end()));
+    });
+    m.def("dict_from_pairs", []() {
+        std::map<std::string, double> values{{"x", 1.5}, {"y", 2.5}};
+        return py::dict::from_pairs(values.begin(), values.end());
+    });
+    m.def("empty_from_range", []() {
+        std::vector<int> values;
+        return py::make_tuple(py::list::from_range(values.begin(), values.end()),
+                              py::tuple::from_range(values.begin(), values.end()));
+    });
+    m.def("list_from_unregistered_range", []() {
+        std::vector<UnregisteredType> values(2);
+        return py::list::from_range(values.begin(), values.end());
+    });
+
+#ifdef PYBIND11_HAS_OPTIONAL
+    // test_try_cast, test_try_getattr
+    m.attr("has_optional") = true;
+    struct TryCastClass {
+        int value;
+    };
+    py::class_<TryCastClass>(m, "TryCastClass").def(py::init<int>());
+    m.def("try_cast_int", [](const py::handle &h) -> py::object {
+        if (auto i = py::try_cast<int>(h)) {
+            return py::int_(*i);
+        }
+        return py::none();
+    });
+    m.def("try_cast_str", [](const py::handle &h) -> py::object {
+        if (auto s = py::try_cast<py::str>(h)) {
+            return *s;
+        }
+        return py::none();
+    });
+    m.def("try_cast_class", [](const py::handle &h) -> py::object {
+        if (auto c = py::try_cast<TryCastClass>(h)) {
+            return py::int_(c->value);
+        }
+        return py::none();
+    });
+    m.def("try_cast_class_ptr", [](const py::handle &h) -> py::object {
+        if (auto c = py::try_cast<TryCastClass *>(h)) {
+            return *c != nullptr ? py::object(py::int_((*c)->value)) : py::str("nullptr");
+        }
+        return py::none();
+    });
+    m.def("try_getattr", [](const py::handle &h, const py::str &name) -> py::object {
+        auto by_handle = py::try_getattr(h, name);
+        auto by_string = py::try_getattr(h, std::string(name).c_str());
+        if (by_handle.has_value() != by_string.has_value()) {
+            throw std::runtime_error("try_getattr overloads disagree");
+        }
+        return by_handle ? *by_handle : py::none();
+    });
+#endif
 }
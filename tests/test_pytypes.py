@@ -663,6 +663,30 @@ def test_memoryview_from_memory():
     assert bytes(view) == b"\xff\xe1\xab\x37"
 
 
+def test_memoryview_from_owned():
+    view = m.test_memoryview_from_owned()
+    assert view.format == "i"
+    assert view.readonly is False
+    assert view.tolist() == [1, 2, 3, 4]
+    view[0] = 5
+    tail = view[1:]
+    del view
+    pytest.gc_collect()
+    # The slice still uses the memory
+    assert not m.owned_memory_freed()
+    assert tail.tolist() == [2, 3, 4]
+    del tail
+    pytest.gc_collect()
+    assert m.owned_memory_freed()
+
+
+def test_memoryview_from_shared():
+    view = m.test_memoryview_from_shared()
+    assert view.readonly is True
+    assert view.format == "B"
+    assert bytes(view) == b"payload"
+
+
 def test_builtin_functions():
     assert m.get_len(list(range(42))) == 42
     with pytest.raises(TypeError) as exc_info:
@@ -896,3 +920,60 @@ def test_inplace_lshift(a, b):
 def test_inplace_rshift(a, b):
     expected = a >> b
     assert m.inplace_rshift(a, b) == expected
+
+
+def test_interned_str():
+    first, second = m.interned_str_twice()
+    assert first == "pybind11_interned_str"
+    assert first is second
+    assert first is sys.intern("pybind11_interned_str")
+
+    class Holder:
+        pass
+
+    h = Holder()
+    m.set_interned_attr(h, 5)
+    assert h.interned_attr == 5
+    assert m.get_interned_attr(h) == 5
+    with pytest.raises(AttributeError):
+        m.get_interned_attr(Holder())
+
+
+def test_from_range():
+    assert m.list_from_range() == [1, 2, 3]
+    assert m.tuple_from_moved_range() == ("a", "b")
+    assert m.dict_from_pairs() == {"x": 1.5, "y": 2.5}
+    assert m.empty_from_range() == ([], ())
+
+    with pytest.raises(RuntimeError) as excinfo:
+        m.list_from_unregistered_range()
+    assert "Unable to convert an element of the range" in str(excinfo.value)
+
+
+@pytest.mark.skipif(not hasattr(m, "has_optional"), reason="no <optional>")
+def test_try_cast():
+    assert m.try_cast_int(5) == 5
+    assert m.try_cast_int("5") is None
+    assert m.try_cast_int(2**70) is None
+    assert m.try_cast_str("s") == "s"
+    assert m.try_cast_str(5) is None
+    assert m.try_cast_class(m.TryCastClass(3)) == 3
+    assert m.try_cast_class(None) is None
+    assert m.try_cast_class(3) is None
+    assert m.try_cast_class_ptr(m.TryCastClass(4)) == 4
+    assert m.try_cast_class_ptr(None) == "nullptr"
+
+
+@pytest.mark.skipif(not hasattr(m, "has_optional"), reason="no <optional>")
+def test_try_getattr():
+    class Probe:
+        present = 1
+
+        @property
+        def failing(self):
+            raise ValueError("failing property")
+
+    assert m.try_getattr(Probe(), "present") == 1
+    assert m.try_getattr(Probe(), "missing") is None
+    with pytest.raises(ValueError, match="^failing property$"):
+        m.try_getattr(Probe(), "failing")
@@ -15,6 +15,8 @@
 #include "pybind11_tests.h"
 
 #include <algorithm>
+#include <map>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -578,4 +580,71 @@ TEST_SUBMODULE(sequences_and_iterators, m) {
             "__iter__",
             [](const CArrayHolder &v) { return py::make_iterator(v.values, v.values + 3); },
             py::keep_alive<0, 1>());
+
+    // test_special_method_slots
+    struct IntMap {
+        std::map<int, int> items;
+        py::object hash = py::int_(0);
+    };
+    py::class_<IntMap>(m, "IntMap")
+        .def(py::init<>())
+        .def("__len__", [](const IntMap &d) { return d.items.size(); })
+        .def("__getitem__",
+             [](const IntMap &d, int key) {
+                 auto it = d.items.find(key);
+                 if (it == d.items.end()) {
+                     throw py::key_error(std::to_string(key));
+                 }
+                 return it->second;
+             })
+        .def("__getitem__", [](const IntMap &, const py::slice &) { return "slice"; })
+        .def("__setitem__", [](IntMap &d, int key, int value) { d.items[key] = value; })
+        .def("__delitem__",
+             [](IntMap &d, int key) {
+                 if (d.items.erase(key) == 0) {
+                     throw py::key_error(std::to_string(key));
+                 }
+             })
+        .def("__contains__", [](const IntMap &d, int key) { return d.items.count(key) != 0; })
+        .def("__hash__", [](const IntMap &d) { return d.hash; })
+        .def_readwrite("hash", &IntMap::hash);
+
+    struct NegativeLength {};
+    py::class_<NegativeLength>(m, "NegativeLength")
+        .def(py::init<>())
+        .def("__len__", [](const NegativeLength &) { return -1; });
+
+    // The slots of `type` which call pybind11 functions directly
+    m.def("special_method_slots", [](const py::type &type) {
+        py::list slots;
+#if defined(PYBIND11_HAS_VECTORCALL)
+        auto *t = reinterpret_cast<PyTypeObject *>(type.ptr());
+        if (t->tp_as_sequence->sq_length == &py::detail::pybind11_sq_length) {
+            slots.append("sq_length");
+        }
+        if (t->tp_as_mapping->mp_length == &py::detail::pybind11_mp_length) {
+            slots.append("mp_length");
+        }
+        if (t->tp_as_mapping->mp_subscript == &py::detail::pybind11_mp_subscript) {
+            slots.append("mp_subscript");
+        }
+        if (t->tp_as_mapping->mp_ass_subscript == &py::detail::pybind11_mp_ass_subscript) {
+            slots.append("mp_ass_subscript");
+        }
+        if (t->tp_as_sequence->sq_contains == &py::detail::pybind11_sq_contains) {
+            slots.append("sq_contains");
+        }
+        if (t->tp_hash == &py::detail::pybind11_tp_hash) {
+            slots.append("tp_hash");
+        }
+#else
+        (void) type;
+#endif
+        return slots;
+    });
+
+    // test_iterator_slots
+    m.def("same_iternext", [](const py::handle &a, const py::handle &b) {
+        return Py_TYPE(a.ptr())->tp_iternext == Py_TYPE(b.ptr())->tp_iternext;
+    });
 }
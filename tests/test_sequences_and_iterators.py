@@ -1,6 +1,9 @@
+import sys
+
 import pytest
 from pytest import approx  # noqa: PT013
 
+import env
 from pybind11_tests import ConstructorStats
 from pybind11_tests import sequences_and_iterators as m
 
@@ -244,9 +247,107 @@ def test_iterator_rvp():
     assert not isinstance(m.make_iterator_1(), type(m.make_iterator_2()))
 
 
+def test_uninitialized_iterator():
+    it_type = type(m.make_iterator_1())
+    it = it_type.__new__(it_type)
+    with pytest.raises(TypeError):
+        next(it)
+
+
 def test_carray_iterator():
     """#4100: Check for proper iterator overload with C-Arrays"""
     args_gt = [float(i) for i in range(3)]
     arr_h = m.CArrayHolder(*args_gt)
     args = list(arr_h)
     assert args_gt == args
+
+
+def test_special_method_slots():
+    expected = [
+        "sq_length",
+        "mp_length",
+        "mp_subscript",
+        "mp_ass_subscript",
+        "sq_contains",
+        "tp_hash",
+    ]
+    direct = not env.PYPY and sys.version_info >= (3, 9)
+    assert m.special_method_slots(m.IntMap) == (expected if direct else [])
+
+    d = m.IntMap()
+    assert len(d) == 0
+    d[1] = 10
+    d[2] = 20
+    assert len(d) == 2
+    assert d[1] == 10
+    assert d[1:2] == "slice"
+    with pytest.raises(KeyError):
+        d[3]
+    with pytest.raises(TypeError):
+        d["x"]
+    with pytest.raises(TypeError):
+        d[3] = "x"
+    assert 1 in d
+    assert 3 not in d
+    with pytest.raises(TypeError):
+        assert "x" in d
+    del d[1]
+    assert 1 not in d
+    with pytest.raises(KeyError):
+        del d[1]
+
+    d.hash = 1234
+    assert hash(d) == 1234
+    d.hash = -1
+    assert hash(d) == -2
+    d.hash = 2**70
+    assert hash(d) == hash(2**70)
+    d.hash = "x"
+    with pytest.raises(TypeError, match="__hash__ method should return an integer"):
+        hash(d)
+
+    with pytest.raises(ValueError, match="should return >= 0"):
+        len(m.NegativeLength())
+
+    class Sub(m.IntMap):
+        def __len__(self):
+            return 42
+
+        def __getitem__(self, key):
+            return -key
+
+    s = Sub()
+    assert len(s) == 42
+    assert s[5] == -5
+    s[1] = 1
+    assert 1 in s
+
+
+def test_iterator_slots():
+    class Generic:
+        def __next__(self):
+            raise StopIteration
+
+    it = m.IntPairs([(1, 2), (3, 4)]).simple_iterator()
+    extras = m.IntPairs([(1, 2), (3, 4)])._make_iterator_extras()
+    # Iterators with extra arguments step through __next__
+    assert m.same_iternext(extras, Generic())
+    assert m.same_iternext(it, Generic()) == env.PYPY
+    assert iter(it) is it
+    assert next(it) == (1, 2)
+    assert it.__next__() == (3, 4)
+    for _ in range(3):
+        with pytest.raises(StopIteration):
+            next(it)
+    with pytest.raises(StopIteration):
+        it.__next__()
+    assert list(extras) == [(1, 2), (3, 4)]
+
+    def raising():
+        yield 1
+        raise ValueError("from the generator")
+
+    it = m.iterator_passthrough(raising())
+    assert next(it) == 1
+    with pytest.raises(ValueError, match="from the generator"):
+        next(it)
@@ -260,6 +260,58 @@ struct ElementList {
     std::vector<std::shared_ptr<ElementBase>> l;
 };
 
+// test_holder_copies
+// Simple custom holder that works like shared_ptr and counts its copies
+template <typename T>
+class copy_counting_ptr {
+    std::shared_ptr<T> impl;
+
+public:
+    copy_counting_ptr() = default;
+    explicit copy_counting_ptr(T *p) : impl(p) {}
+    copy_counting_ptr(const copy_counting_ptr &other) : impl(other.impl) { ++copies(); }
+    copy_counting_ptr(copy_counting_ptr &&) noexcept = default;
+    copy_counting_ptr &operator=(const copy_counting_ptr &other) {
+        impl = other.impl;
+        ++copies();
+        return *this;
+    }
+    copy_counting_ptr &operator=(copy_counting_ptr &&) noexcept = default;
+    ~copy_counting_ptr() = default;
+    T *get() const { return impl.get(); }
+    static int &copies() {
+        static int count = 0;
+        return count;
+    }
+};
+
+struct HeldByCopyCountingHolder {};
+
+// test_intrusive_holder
+struct IntrusiveCounted {
+    explicit IntrusiveCounted(int value) : value(value) { ++alive(); }
+    IntrusiveCounted(const IntrusiveCounted &) = delete;
+    ~IntrusiveCounted() { --alive(); }
+    static int &alive() {
+        static int count = 0;
+        return count;
+    }
+    int value;
+    int refs = 0;
+};
+
+void intrusive_ptr_add_ref(IntrusiveCounted *p) { ++p->refs; }
+void intrusive_ptr_release(IntrusiveCounted *p) {
+    if (--p->refs == 0) {
+        delete p;
+    }
+}
+
+py::intrusive_holder<IntrusiveCounted> &kept_intrusive() {
+    static py::intrusive_holder<IntrusiveCounted> kept;
+    return kept;
+}
+
 } // namespace
 
 // ref<T> is a wrapper for 'Object' which uses intrusive reference counting
@@ -283,6 +335,7 @@ PYBIND11_DECLARE_HOLDER_TYPE(T, huge_unique_ptr<T>);
 PYBIND11_DECLARE_HOLDER_TYPE(T, custom_unique_ptr<T>);
 PYBIND11_DECLARE_HOLDER_TYPE(T, shared_ptr_with_addressof_operator<T>);
 PYBIND11_DECLARE_HOLDER_TYPE(T, unique_ptr_with_addressof_operator<T>);
+PYBIND11_DECLARE_HOLDER_TYPE(T, copy_counting_ptr<T>);
 
 TEST_SUBMODULE(smart_ptr, m) {
     // Please do not interleave `struct` and `class` definitions with bindings code,
@@ -467,4 +520,30 @@ TEST_SUBMODULE(smart_ptr, m) {
             }
             return list;
         });
+
+    // test_holder_copies
+    using CopyCountingHolder = copy_counting_ptr<HeldByCopyCountingHolder>;
+    py::class_<HeldByCopyCountingHolder, CopyCountingHolder>(m, "HeldByCopyCountingHolder")
+        .def(py::init<>())
+        .def_static("copies", []() { return CopyCountingHolder::copies(); })
+        .def_static("make",
+                    []() { return CopyCountingHolder(new HeldByCopyCountingHolder()); })
+        .def_static("by_const_ref",
+                    [](const CopyCountingHolder &p) { return p.get() != nullptr; })
+        // NOLINTNEXTLINE(performance-unnecessary-value-param)
+        .def_static("by_value", [](CopyCountingHolder p) { return p.get() != nullptr; });
+
+    // test_intrusive_holder
+    py::class_<IntrusiveCounted, py::intrusive_holder<IntrusiveCounted>>(m, "IntrusiveCounted")
+        .def(py::init<int>())
+        .def_readonly("value", &IntrusiveCounted::value)
+        .def_readonly("refs", &IntrusiveCounted::refs)
+        .def_static("alive", []() { return IntrusiveCounted::alive(); })
+        .def_static("make",
+                    [](int value) {
+                        return py::intrusive_holder<IntrusiveCounted>(new IntrusiveCounted(value));
+                    })
+        .def_static("keep",
+                    [](const py::intrusive_holder<IntrusiveCounted> &p) { kept_intrusive() = p; })
+        .def_static("kept_raw", []() { return kept_intrusive().get(); });
 }
@@ -313,3 +313,40 @@ def test_shared_ptr_gc():
     pytest.gc_collect()
     for i, v in enumerate(el.get()):
         assert i == v.value()
+
+
+def test_holder_copies():
+    cls = m.HeldByCopyCountingHolder
+    copies = cls.copies()
+    a = cls.make()  # The returned holder is moved into the instance
+    assert cls.copies() == copies
+    assert cls.by_const_ref(a)  # The holder of the instance is borrowed
+    assert cls.copies() == copies
+    assert cls.by_value(a)
+    assert cls.copies() == copies + 1
+
+
+def test_intrusive_holder():
+    cls = m.IntrusiveCounted
+    alive = cls.alive()
+    a = cls(1)
+    assert a.refs == 1
+    b = cls.make(2)
+    assert b.value == 2
+    assert b.refs == 1
+    cls.keep(b)
+    assert b.refs == 2
+    del b
+    pytest.gc_collect()
+    assert cls.alive() == alive + 2
+
+    # A new instance for the raw pointer takes another reference
+    c = cls.kept_raw()
+    assert c.value == 2
+    assert c.refs == 2
+    assert cls.kept_raw() is c
+    cls.keep(None)
+    assert c.refs == 1
+    del a, c
+    pytest.gc_collect()
+    assert cls.alive() == alive
@@ -16,8 +16,13 @@
 #    define PYBIND11_HAS_FILESYSTEM_IS_OPTIONAL
 #endif
 #include <pybind11/stl/filesystem.h>
+#include <pybind11/stl/staged.h>
 
+#include <deque>
+#include <map>
+#include <stdexcept>
 #include <string>
+#include <tuple>
 #include <vector>
 
 #if defined(PYBIND11_TEST_BOOST)
@@ -167,10 +172,58 @@ struct type_caster<ReferenceSensitiveOptional<T>>
 } // namespace detail
 } // namespace PYBIND11_NAMESPACE
 
+// A `UserType` with an even value. Its caster only accepts some of the instances of a class, so
+// a variant must still try it before a class alternative that took the same type before.
+struct EvenUserType {
+    int value;
+};
+
+namespace PYBIND11_NAMESPACE {
+namespace detail {
+template <>
+struct type_caster<EvenUserType> {
+    PYBIND11_TYPE_CASTER(EvenUserType, const_name("EvenUserType"));
+
+    bool load(handle src, bool) {
+        if (!isinstance<UserType>(src) || src.cast<const UserType &>().value() % 2 != 0) {
+            return false;
+        }
+        value.value = src.cast<const UserType &>().value();
+        return true;
+    }
+
+    static handle cast(const EvenUserType &src, return_value_policy, handle) {
+        return int_(src.value).release();
+    }
+};
+} // namespace detail
+} // namespace PYBIND11_NAMESPACE
+
 TEST_SUBMODULE(stl, m) {
     // test_vector
     m.def("cast_vector", []() { return std::vector<int>{1}; });
     m.def("load_vector", [](const std::vector<int> &v) { return v.at(0) == 1 && v.at(1) == 2; });
+    // Not std::vector<double>, which test_stl_binders binds with py::bind_vector
+    m.def("echo_double_deque", [](const std::deque<double> &v) { return v; });
+    m.def("echo_int_vector", [](const std::vector<int> &v) { return v; });
+
+#if defined(PYBIND11_HAS_SPAN)
+    // test_span
+    m.def("span_sum", [](std::span<const double> s) {
+        double total = 0;
+        for (double d : s) {
+            total += d;
+        }
+        return total;
+    });
+    m.def("span_double_in_place", [](std::span<int> s) {
+        for (int &i : s) {
+            i *= 2;
+        }
+    });
+    m.def("span_echo", [](std::span<const int> s) { return s; });
+    m.def("span_byte_count", [](std::span<const std::uint8_t> s) { return s.size(); });
+#endif
     // `std::vector<bool>` is special because it returns proxy objects instead of references
     m.def("cast_bool_vector", []() { return std::vector<bool>{true, false}; });
     m.def("load_bool_vector",
@@ -426,10 +479,43 @@ TEST_SUBMODULE(stl, m) {
         .def_property_readonly("access_by_ref", &opt_refsensitive_props::access_by_ref)
         .def_property_readonly("access_by_copy", &opt_refsensitive_props::access_by_copy);
 
+#ifdef PYBIND11_HAS_EXPECTED
+    // test_expected
+    m.attr("has_expected") = true;
+    struct ExpectedError {
+        std::string reason;
+        std::string message() const { return "expected: " + reason; }
+    };
+    py::register_expected_error<ExpectedError>(PyExc_LookupError);
+    m.def("expected_int", [](int i) -> std::expected<int, ExpectedError> {
+        if (i < 0) {
+            return std::unexpected(ExpectedError{"negative"});
+        }
+        return i;
+    });
+    m.def("expected_void", [](bool fail) -> std::expected<void, std::runtime_error> {
+        if (fail) {
+            return std::unexpected(std::runtime_error("failed"));
+        }
+        return {};
+    });
+    m.def("expected_int_error", [](int i) -> std::expected<std::string, int> {
+        return std::unexpected(i);
+    });
+#endif
+
 #ifdef PYBIND11_HAS_FILESYSTEM
     // test_fs_path
     m.attr("has_filesystem") = true;
     m.def("parent_path", [](const std::filesystem::path &p) { return p.parent_path(); });
+    m.def("parent_paths", [](const std::vector<std::filesystem::path> &paths) {
+        std::vector<std::filesystem::path> result;
+        result.reserve(paths.size());
+        for (const auto &p : paths) {
+            result.push_back(p.parent_path());
+        }
+        return result;
+    });
 #endif
 
 #ifdef PYBIND11_TEST_VARIANT
@@ -443,6 +529,8 @@ TEST_SUBMODULE(stl, m) {
         result_type operator()(const std::string &) { return "std::string"; }
         result_type operator()(double) { return "double"; }
         result_type operator()(std::nullptr_t) { return "std::nullptr_t"; }
+        result_type operator()(const UserType &) { return "UserType"; }
+        result_type operator()(const EvenUserType &) { return "EvenUserType"; }
 #    if defined(PYBIND11_HAS_VARIANT)
         result_type operator()(std::monostate) { return "std::monostate"; }
 #    endif
@@ -455,6 +543,12 @@ TEST_SUBMODULE(stl, m) {
     m.def("load_variant_2pass", [](variant<double, int> v) {
         return py::detail::visit_helper<variant>::call(visitor(), v);
     });
+    m.def("load_class_variant", [](const variant<int, std::string, UserType> &v) {
+        return py::detail::visit_helper<variant>::call(visitor(), v);
+    });
+    m.def("load_even_variant", [](const variant<EvenUserType, UserType> &v) {
+        return py::detail::visit_helper<variant>::call(visitor(), v);
+    });
     m.def("cast_variant", []() {
         using V = variant<int, std::string>;
         return py::make_tuple(V(5), V("Hello"));
@@ -500,6 +594,15 @@ TEST_SUBMODULE(stl, m) {
     m.def(
         "stl_pass_by_pointer", [](std::vector<int> *v) { return *v; }, "v"_a = nullptr);
 
+    // test_vector_of_strings
+    m.def("concat_strings", [](const std::deque<std::string> &v) {
+        std::string result;
+        for (const auto &s : v) {
+            result += s + "|";
+        }
+        return result;
+    });
+
     // #1258: pybind11/stl.h converts string to vector<string>
     m.def("func_with_string_or_vector_string_arg_overload",
           [](const std::vector<std::string> &) { return 1; });
@@ -548,4 +651,29 @@ TEST_SUBMODULE(stl, m) {
         []() { return new std::vector<bool>(4513); },
         // Without explicitly specifying `take_ownership`, this function leaks.
         py::return_value_policy::take_ownership);
+
+    // test_staged
+    m.def(
+        "staged_dot",
+        [](const py::staged<std::vector<std::vector<std::pair<int, double>>>> &rows) {
+            double sum = 0;
+            for (const auto &row : *rows) {
+                for (const auto &entry : row) {
+                    sum += entry.first * entry.second;
+                }
+            }
+            return std::make_pair(sum, PyGILState_Check() != 0);
+        },
+        py::call_guard<py::gil_scoped_release>());
+    m.def("staged_records",
+          [](py::staged<std::map<std::string, std::tuple<int, std::string, std::deque<float>>>>
+                 records) {
+              std::string result;
+              for (const auto &record : *records) {
+                  result += record.first + ":" + std::to_string(std::get<0>(record.second)) + ":"
+                            + std::get<1>(record.second) + ":"
+                            + std::to_string(std::get<2>(record.second).size()) + ";";
+              }
+              return result;
+          });
 }
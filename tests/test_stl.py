@@ -1,6 +1,10 @@
+import array
+import collections
+import sys
+
 import pytest
 
-from pybind11_tests import ConstructorStats, UserType
+from pybind11_tests import ConstructorStats, IncType, UserType
 from pybind11_tests import stl as m
 
 
@@ -235,6 +239,22 @@ def test_reference_sensitive_optional():
     assert int(props.access_by_copy) == 42
 
 
+@pytest.mark.skipif(not hasattr(m, "has_expected"), reason="no <expected>")
+def test_expected():
+    assert m.expected_int(3) == 3
+    with pytest.raises(LookupError, match="^expected: negative$"):
+        m.expected_int(-1)
+
+    assert m.expected_void(False) is None
+    with pytest.raises(RuntimeError, match="^failed$"):
+        m.expected_void(True)
+
+    with pytest.raises(RuntimeError) as excinfo:
+        m.expected_int_error(7)
+    assert excinfo.value.args == (7,)
+    assert m.expected_int_error.__doc__.startswith("expected_int_error(arg0: int) -> str")
+
+
 @pytest.mark.skipif(not hasattr(m, "has_filesystem"), reason="no <filesystem>")
 def test_fs_path():
     from pathlib import Path
@@ -252,6 +272,20 @@ def test_fs_path():
     assert m.parent_path(b"foo/bar") == Path("foo")
     assert m.parent_path(PseudoStrPath()) == Path("foo")
     assert m.parent_path(PseudoBytesPath()) == Path("foo")
+    assert m.parent_path("f\u00f6\u00f6/bar") == Path("f\u00f6\u00f6")
+    with pytest.raises(TypeError):
+        m.parent_path("foo\0/bar")
+    if sys.getfilesystemencodeerrors() == "surrogateescape":
+        # Not valid UTF-8, converted through the codec of the file system encoding
+        assert m.parent_path("\udcff/bar") == Path("\udcff")
+
+    assert m.parent_paths(["foo/bar", Path("a/b"), b"x/y", PseudoStrPath()]) == [
+        Path("foo"),
+        Path("a"),
+        Path("x"),
+        Path("foo"),
+    ]
+    assert m.parent_paths(()) == []
 
 
 @pytest.mark.skipif(not hasattr(m, "load_variant"), reason="no <variant>")
@@ -271,6 +305,32 @@ def test_variant(doc):
     )
 
 
+@pytest.mark.skipif(not hasattr(m, "load_variant"), reason="no <variant>")
+def test_variant_class_alternatives():
+    class PyUserType(UserType):
+        pass
+
+    # Repeated loads of the same types go through the dispatch cache
+    for _ in range(3):
+        assert m.load_class_variant(UserType(1)) == "UserType"
+        assert m.load_class_variant(IncType(1)) == "UserType"
+        assert m.load_class_variant(PyUserType(1)) == "UserType"
+        assert m.load_class_variant(1) == "int"
+        assert m.load_class_variant("1") == "std::string"
+
+    # A remembered class alternative does not take precedence over an earlier alternative that
+    # accepts only some of the values of the same type
+    for _ in range(3):
+        assert m.load_even_variant(UserType(1)) == "UserType"
+        assert m.load_even_variant(UserType(2)) == "EvenUserType"
+
+    # Modifying a type invalidates its entry: now the `int` alternative comes first
+    PyUserType.__index__ = lambda self: 5  # noqa: ARG005
+    assert m.load_class_variant(PyUserType(1)) == "int"
+    with pytest.raises(TypeError):
+        m.load_class_variant(1.5)
+
+
 @pytest.mark.skipif(
     not hasattr(m, "load_monostate_variant"), reason="no std::monostate"
 )
@@ -362,6 +422,70 @@ def test_stl_ownership():
     assert cstats.alive() == 0
 
 
+def test_vector_from_buffer():
+    """Numbers exposed through the buffer protocol are copied directly"""
+    d = array.array("d", [0.5, 1.5, 2.5, 3.5])
+    assert m.echo_double_deque(d) == [0.5, 1.5, 2.5, 3.5]
+    assert m.echo_double_deque(memoryview(d)[::2]) == [0.5, 2.5]
+    assert m.echo_double_deque(memoryview(d)[3:3]) == []
+    # Unaligned data
+    raw = bytearray(1) + bytearray(d)
+    assert m.echo_double_deque(memoryview(raw)[1:].cast("d")) == [0.5, 1.5, 2.5, 3.5]
+    i = array.array("i", [1, 2, 3])
+    assert m.echo_int_vector(i) == [1, 2, 3]
+    assert m.echo_int_vector(memoryview(i)[::-1]) == [3, 2, 1]
+    # Other item types still go through the elements, with the usual conversions
+    assert m.echo_double_deque(i) == [1.0, 2.0, 3.0]
+    with pytest.raises(TypeError):
+        m.echo_int_vector(d)
+
+
+@pytest.mark.skipif(not hasattr(m, "span_sum"), reason="no <span>")
+def test_span():
+    d = array.array("d", [0.5, 1.5, 2.5])
+    assert m.span_sum(d) == 4.5
+    assert m.span_sum(memoryview(d)) == 4.5
+    assert m.span_sum(memoryview(d)[1:]) == 4.0
+    assert m.span_sum(array.array("d")) == 0
+
+    i = array.array("i", [1, 2, 3])
+    m.span_double_in_place(i)
+    assert i.tolist() == [2, 4, 6]
+    assert m.span_echo(i) == [2, 4, 6]
+    assert m.span_byte_count(b"abcd") == 4
+    assert m.span_byte_count(bytearray(3)) == 3
+
+    # Read-only buffers only load into spans of const elements
+    with pytest.raises(TypeError):
+        m.span_double_in_place(memoryview(i).toreadonly())
+    assert m.span_echo(memoryview(i).toreadonly()) == [2, 4, 6]
+
+    # No copies are made, so the buffer has to match exactly
+    with pytest.raises(TypeError):
+        m.span_sum(i)
+    with pytest.raises(TypeError):
+        m.span_sum(memoryview(d)[::2])
+    with pytest.raises(TypeError):
+        m.span_sum([0.5, 1.5])
+    with pytest.raises(TypeError):
+        m.span_sum(memoryview(bytearray(1) + bytearray(d))[1:].cast("d"))
+
+    # The buffer is released again once the call returns
+    b = bytearray(4)
+    m.span_byte_count(b)
+    b.append(0)
+
+
+def test_vector_of_strings():
+    words = ["a", "\u00e9t\u00e9", "", "\U0001f600", "bc" * 100]
+    expected = "".join(w + "|" for w in words)
+    assert m.concat_strings(words) == expected
+    assert m.concat_strings(tuple(words)) == expected
+    assert m.concat_strings(collections.deque(words)) == expected
+    with pytest.raises(TypeError):
+        m.concat_strings(["a", 1])
+
+
 def test_array_cast_sequence():
     assert m.array_cast_sequence((1, 2, 3)) == [1, 2, 3]
 
@@ -379,3 +503,25 @@ def test_return_vector_bool_raw_ptr():
     v = m.return_vector_bool_raw_ptr()
     assert isinstance(v, list)
     assert len(v) == 4513
+
+
+def test_staged():
+    rows = [[(1, 0.5), (2, 1.5)], [], [(3, 2.0)]]
+    assert m.staged_dot(rows) == (9.5, False)
+    assert m.staged_dot(()) == (0.0, False)
+    assert (
+        m.staged_dot.__doc__
+        == "staged_dot(arg0: List[List[Tuple[int, float]]]) -> Tuple[float, bool]\n"
+    )
+
+    with pytest.raises(TypeError):
+        m.staged_dot([[(1, 0.5, 2)]])
+    with pytest.raises(TypeError):
+        m.staged_dot([["ab"]])
+    with pytest.raises(TypeError):
+        m.staged_dot([[(1, "x")]])
+
+    records = {"a": (1, "x", [1.0, 2.0]), "bcd": (22, "", ())}
+    assert m.staged_records(records) == "a:1:x:2;bcd:22::0;"
+    with pytest.raises(TypeError):
+        m.staged_records([("a", (1, "x", []))])
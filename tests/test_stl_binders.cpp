@@ -12,6 +12,7 @@
 
 #include "pybind11_tests.h"
 
+#include <cstdint>
 #include <deque>
 #include <map>
 #include <unordered_map>
@@ -112,8 +113,15 @@ TEST_SUBMODULE(stl_binders, m) {
     // test_vector_int
     py::bind_vector<std::vector<unsigned int>>(m, "VectorInt", py::buffer_protocol());
 
+    // test_vector_from_buffer
+    py::bind_vector<std::vector<double>>(m, "VectorDouble");
+
+    // test_vector_slice_view (std::vector<float> is converted with stl.h in other test files)
+    py::bind_vector<std::vector<std::int16_t>>(
+        m, "VectorInt16", py::buffer_protocol(), py::slice_view());
+
     // test_vector_custom
-    py::class_<El>(m, "El").def(py::init<int>());
+    py::class_<El>(m, "El").def(py::init<int>()).def_readonly("a", &El::a);
     py::bind_vector<std::vector<El>>(m, "VectorEl");
     py::bind_vector<std::vector<std::vector<El>>>(m, "VectorVectorEl");
 
@@ -173,6 +181,30 @@ TEST_SUBMODULE(stl_binders, m) {
     py::bind_map<MutuallyRecursiveContainerPairMV>(m, "MutuallyRecursiveContainerPairMV");
     py::bind_vector<MutuallyRecursiveContainerPairVM>(m, "MutuallyRecursiveContainerPairVM");
 
+    // test_stl_views
+    struct ViewTables {
+        std::vector<El> elements{El(1), El(2), El(3)};
+        std::vector<bool> flags{true, false, true};
+        std::map<std::string, int> ids{{"a", 1}, {"b", 2}};
+    };
+    py::class_<ViewTables>(m, "ViewTables")
+        .def(py::init<>())
+        .def_property_readonly("elements",
+                               [](const py::object &self) {
+                                   const auto &t = self.cast<const ViewTables &>();
+                                   return py::make_sequence_view(t.elements, self);
+                               })
+        .def_property_readonly("flags",
+                               [](const py::object &self) {
+                                   const auto &t = self.cast<const ViewTables &>();
+                                   return py::make_sequence_view(t.flags, self);
+                               })
+        .def(
+            "ids",
+            [](const ViewTables &t) { return py::make_mapping_view(t.ids); },
+            py::keep_alive<0, 1>())
+        .def("set_id", [](ViewTables &t, const std::string &k, int v) { t.ids[k] = v; });
+
     // The rest depends on numpy:
     try {
         py::module_::import("numpy");
@@ -1,3 +1,5 @@
+import array
+
 import pytest
 
 from pybind11_tests import stl_binders as m
@@ -119,11 +121,92 @@ def test_vector_buffer_numpy():
     )
     assert len(v) == 3
 
+    # Structured arrays are copied in bulk too
+    v.extend(np.asarray(m.get_vectorstruct()))
+    assert len(v) == 5
+    assert v[4].x == 30
+    v.assign_from_buffer(np.asarray(m.get_vectorstruct())[::-1])
+    assert [e.x for e in v] == [30, 5]
+
     b = np.array([1, 2, 3, 4], dtype=np.uint8)
     v = m.VectorUChar(b[::2])
     assert v[1] == 3
 
 
+def test_vector_from_buffer():
+    d = array.array("d", [0.5, 1.5, 2.5, 3.5])
+    v = m.VectorDouble(d)
+    assert list(v) == [0.5, 1.5, 2.5, 3.5]
+    v.extend(memoryview(d)[::2])
+    assert list(v) == [0.5, 1.5, 2.5, 3.5, 0.5, 2.5]
+    v.extend(array.array("d"))
+    assert len(v) == 6
+    # Unaligned data
+    raw = bytearray(1) + bytearray(d)
+    v.assign_from_buffer(memoryview(raw)[1:].cast("d"))
+    assert list(v) == [0.5, 1.5, 2.5, 3.5]
+
+    # Other item types are still converted element by element, but cannot be assigned
+    v.extend(array.array("i", [1, 2]))
+    assert list(v) == [0.5, 1.5, 2.5, 3.5, 1.0, 2.0]
+    with pytest.raises(TypeError):
+        v.assign_from_buffer(array.array("i", [1, 2]))
+    with pytest.raises(TypeError):
+        v.assign_from_buffer(memoryview(bytes(16)).cast("d", [2, 1]))
+    assert len(v) == 6
+
+    u = m.VectorInt([1, 2])
+    u.extend(array.array("I", [3, 4]))
+    u.assign_from_buffer(u)
+    assert list(u) == [1, 2, 3, 4]
+    # Extending a vector with its own memory, which moves while the vector grows
+    for _ in range(4):
+        u.extend(memoryview(u))
+    assert list(u) == [1, 2, 3, 4] * 16
+    u.extend(memoryview(u)[::-2])
+    assert list(u)[64:] == [4, 2] * 16
+
+
+def test_vector_slice_view():
+    v = m.VectorInt16([0, 1, 2, 3, 4, 5, 6, 7])
+    w = v[2:6]
+    assert type(w).__name__ == "SliceView[VectorInt16]"
+    assert len(w) == 4
+    assert list(w) == [2, 3, 4, 5]
+    assert w[-1] == 5
+    with pytest.raises(IndexError):
+        w[4]
+
+    # Writes go through to the vector
+    w[0] = 20
+    assert v[2] == 20
+
+    # Views of views, also with negative steps
+    r = v[::-2]
+    assert list(r) == [7, 5, 3, 1]
+    assert list(r[1:3]) == [5, 3]
+    assert list(v[3:0:-1][::2]) == [3, 1]
+    assert len(v[5:2]) == 0
+
+    # The buffer protocol is strided as well
+    mv = memoryview(r)
+    assert mv.strides == (-4,)
+    assert mv.tolist() == [7, 5, 3, 1]
+    assert memoryview(v[8:]).tolist() == []
+
+    # The vector stays alive, but accesses past its current end are rejected
+    del v
+    pytest.gc_collect()
+    assert list(w) == [20, 3, 4, 5]
+    u = m.VectorInt16([1, 2, 3])
+    tail = u[1:]
+    u.clear()
+    with pytest.raises(IndexError):
+        tail[0]
+    with pytest.raises(BufferError):
+        memoryview(tail)
+
+
 def test_vector_bool():
     import pybind11_cross_module_tests as cm
 
@@ -337,6 +420,78 @@ def test_map_view_types():
     assert type(unordered_map_string_double_const.items()) is items_type
 
 
+def test_stl_views():
+    tables = m.ViewTables()
+    elements = tables.elements
+    assert len(elements) == 3
+    assert [e.a for e in elements] == [1, 2, 3]
+    assert elements[-1].a == 3
+    assert [e.a for e in elements[::2]] == [1, 3]
+    with pytest.raises(IndexError):
+        elements[3]
+
+    # Elements are references into the C++ vector, not copies
+    assert elements[0] is elements[0]
+
+    flags = tables.flags
+    assert list(flags) == [True, False, True]
+    assert flags[1] is False
+    assert True in flags
+
+    ids = tables.ids()
+    assert len(ids) == 2
+    assert ids["a"] == 1
+    assert "b" in ids
+    assert "c" not in ids
+    assert 1 not in ids
+    assert ids.get("c") is None
+    assert ids.get("c", 7) == 7
+    assert ids.get(5, 7) == 7
+    with pytest.raises(KeyError):
+        ids["c"]
+    with pytest.raises(KeyError):
+        ids[5]
+    assert list(ids) == ["a", "b"]
+    assert list(ids.values()) == [1, 2]
+    assert dict(ids.items()) == {"a": 1, "b": 2}
+
+    # The views see later changes, and keep their owner alive
+    tables.set_id("c", 3)
+    assert ids["c"] == 3
+    del tables
+    pytest.gc_collect()
+    assert [e.a for e in elements] == [1, 2, 3]
+    assert list(flags) == [True, False, True]
+    assert dict(ids.items()) == {"a": 1, "b": 2, "c": 3}
+
+
+def test_map_bulk_export():
+    mm = m.MapStringDouble()
+    assert mm.to_dict() == {}
+    mm["a"] = 1
+    mm["b"] = 2.5
+    d = mm.to_dict()
+    assert type(d) is dict
+    assert d == {"a": 1.0, "b": 2.5}
+    values = mm.values_array()
+    assert values.format == "d"
+    assert values.tolist() == [1.0, 2.5]
+    assert len(m.MapStringDouble().values_array()) == 0
+    # String keys can only be exported to a dict
+    assert not hasattr(mm, "keys_array")
+
+    mnc = m.get_mnc(3)
+    assert mnc.keys_array().tolist() == [1, 2, 3]
+    assert not hasattr(mnc, "values_array")
+    d = mnc.to_dict()
+    assert [v.value for v in d.values()] == [10, 20, 30]
+    # Values are references into the map, which they keep alive
+    d[1].value = 11
+    del mnc
+    pytest.gc_collect()
+    assert d[1].value == 11
+
+
 def test_recursive_vector():
     recursive_vector = m.RecursiveVector()
     recursive_vector.append(m.RecursiveVector())
@@ -61,6 +61,10 @@ TEST_SUBMODULE(thread, m) {
         },
         py::call_guard<py::gil_scoped_release>());
 
+    // Returns the registered Python instance; exercises the instance map from many threads.
+    m.def("same_instance", [](IntStruct &in) -> IntStruct & { return in; },
+          py::return_value_policy::reference);
+
     // NOTE: std::string_view also uses loader_life_support to ensure that
     // the string contents remain alive, but that's a C++ 17 feature.
 }
@@ -40,3 +40,16 @@ def test_implicit_conversion_no_gil():
         x.start()
     for x in [c, b, a]:
         x.join()
+
+
+def test_registered_instances():
+    def fn(expected, _):
+        for i in range(100):
+            s = m.IntStruct(expected * 100 + i)
+            assert m.same_instance(s) is s
+
+    threads = [Thread(fn) for _ in range(4)]
+    for x in threads:
+        x.start()
+    for x in threads:
+        x.join()
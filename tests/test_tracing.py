@@ -0,0 +1,48 @@
+import pybind11_tracing_tests as m
+
+
+def names(events, kind):
+    # Without the calls starting and stopping the tracing
+    return [
+        name
+        for event, name in events
+        if event == kind and name not in ("start_tracing", "stop_tracing")
+    ]
+
+
+def test_function_events():
+    m.start_tracing()
+    assert m.add(1, 2) == 3
+    assert m.overloaded(1.5) == "float"
+    events = m.stop_tracing()
+    assert names(events, "function_entry") == ["add", "overloaded"]
+    assert names(events, "function_exit") == ["add", "overloaded"]
+    # The int overload is tried first and can not load a float without conversion
+    assert names(events, "overload_failed") == ["overloaded"]
+
+
+def test_instance_events():
+    m.start_tracing()
+    assert m.pet_age(3) == 3
+    owner = m.Owner()
+    owner.adopt(m.Pet(4))
+    events = m.stop_tracing()
+    assert any("Pet" in name for name in names(events, "implicit_conversion"))
+    assert any("Pet" in name for name in names(events, "instance_registered"))
+    assert any("Owner" in name for name in names(events, "keep_alive"))
+
+
+def test_gil_events():
+    m.start_tracing()
+    m.release_gil()
+    events = m.stop_tracing()
+    kinds = [event for event, _ in events if event.startswith("gil_")]
+    assert kinds == ["gil_release", "gil_acquire"]
+
+
+def test_no_events_without_hook():
+    m.start_tracing()
+    m.stop_tracing()
+    assert m.add(1, 2) == 3
+    m.start_tracing()
+    assert names(m.stop_tracing(), "function_entry") == []
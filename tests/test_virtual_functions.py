@@ -288,6 +288,25 @@ def test_recursive_dispatch_issue():
     assert store.result == 6
 
 
+def test_override_modified_later():
+    """Override lookups are cached, but must see later changes to the class and instance"""
+
+    class Modified(m.ExampleVirt):
+        def run(self, value):
+            return value + 1
+
+    a = Modified(10)
+    assert m.runExampleVirt(a, 1) == 2
+    assert m.runExampleVirt(a, 1) == 2
+    Modified.run = lambda self, value: value + 2
+    assert m.runExampleVirt(a, 1) == 3
+    a.run = lambda value: value + 3
+    assert m.runExampleVirt(a, 1) == 4
+    del a.run
+    assert m.runExampleVirt(a, 1) == 3
+    assert m.runExampleVirt(Modified(10), 1) == 3
+
+
 def test_override_ref():
     """#392/397: overriding reference-returning functions"""
     o = m.OverrideTest("asdf")
@@ -0,0 +1,182 @@
+"""Attributes the code size of an extension module to the pybind11 templates it instantiates.
+
+Usage:
+    python codesize.py [--top N] [--json out.json] [--nm nm] module.so [objects.o ...]
+
+The symbols of the shared library (or, without one, of the object files) are grouped into the
+instantiations of ``cpp_function::initialize<...>`` (one per bound function, including its
+dispatcher), the type casters, the rest of pybind11, and everything else. The object files are
+also searched for inline and template functions (weak symbols) that are compiled in more than
+one translation unit: the linker keeps only one copy, but each was compiled separately.
+
+Both need symbol sizes, i.e. the library must not be stripped (build with ``RelWithDebInfo`` or
+``Debug``) and the objects must not be LTO bitcode (configure with
+``-DCMAKE_INTERPROCEDURAL_OPTIMIZATION=OFF``). The ``codesize`` target of the test suite runs
+this script on ``pybind11_tests``. Requires ``nm`` from binutils or LLVM.
+"""
+
+import argparse
+import collections
+import json
+import re
+import subprocess
+import sys
+
+INITIALIZE = "pybind11::cpp_function::initialize<"
+CASTER = re.compile(r"pybind11::detail::(\w*caster\w*|argument_loader)<")
+# Demangled template functions start with their return type
+PYBIND11 = re.compile(r"(?:\S+ )?pybind11::")
+# Address, size, type and name; symbols without a size have no second column
+NM_LINE = re.compile(r"[0-9a-fA-F]+ ([0-9a-fA-F]+) (\w) (.*)$")
+CODE_TYPES = set("tTwW")
+WEAK_TYPES = set("wW")
+
+
+def read_symbols(nm, path):
+    """Yields (name, type, size) for the defined symbols with a size in ``path``."""
+    out = subprocess.run(
+        [nm, "--defined-only", "--print-size", "--demangle", path],
+        stdout=subprocess.PIPE,
+        check=True,
+        universal_newlines=True,
+    ).stdout
+    for line in out.splitlines():
+        match = NM_LINE.match(line)
+        if match:
+            yield match.group(3), match.group(2), int(match.group(1), 16)
+
+
+def bracket_end(name, start):
+    """Returns the index after the bracket closing the one at ``name[start]``."""
+    depth = 0
+    for i in range(start, len(name)):
+        if name[i] in "<(":
+            depth += 1
+        elif name[i] in ">)":
+            depth -= 1
+            if depth == 0:
+                return i + 1
+    return len(name)
+
+
+def classify(name):
+    """Returns the category of a symbol and the instantiation it belongs to."""
+    i = name.find(INITIALIZE)
+    if i >= 0:
+        end = bracket_end(name, i + len(INITIALIZE) - 1)
+        if name[end : end + 1] == "(":
+            end = bracket_end(name, end)
+        return "cpp_function::initialize", name[i:end]
+    match = CASTER.search(name)
+    if match:
+        return "casters", name[match.start() : bracket_end(name, match.end() - 1)]
+    if PYBIND11.match(name):
+        return "other pybind11", name.split("(", 1)[0]
+    return "other", name.split("(", 1)[0]
+
+
+def attribute(symbols):
+    """Sums the code size per category and per instantiation."""
+    categories = collections.Counter()
+    instantiations = collections.defaultdict(lambda: [0, 0])
+    for name, size in symbols.items():
+        category, key = classify(name)
+        categories[category] += size
+        entry = instantiations[category, key]
+        entry[0] += size
+        entry[1] += 1
+    return categories, instantiations
+
+
+def shorten(text, width):
+    return text if len(text) <= width else text[: width - 3] + "..."
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("files", nargs="+", help="a shared library and/or object files")
+    parser.add_argument("--top", type=int, default=20, help="entries shown per table")
+    parser.add_argument("--width", type=int, default=150, help="maximum width of a name")
+    parser.add_argument("--json", help="also write the full results to this file")
+    parser.add_argument("--nm", default="nm", help="the nm executable")
+    args = parser.parse_args()
+
+    objects = [f for f in args.files if f.endswith((".o", ".obj"))]
+    libraries = [f for f in args.files if f not in objects]
+
+    # The size of each code symbol, counting the copies of a template in several objects once
+    code = {}
+    # The size of each weak symbol in each object defining it
+    weak = collections.defaultdict(dict)
+    for path in libraries or objects:
+        for name, kind, size in read_symbols(args.nm, path):
+            if kind in CODE_TYPES:
+                code[name] = max(code.get(name, 0), size)
+    for path in objects:
+        for name, kind, size in read_symbols(args.nm, path):
+            if kind in WEAK_TYPES:
+                # Constructors and destructors have several symbols with the same name
+                weak[name][path] = max(weak[name].get(path, 0), size)
+
+    if not code:
+        sys.exit(
+            "Error: no symbol sizes found; the library must not be stripped, and the objects "
+            "must not be LTO bitcode"
+        )
+
+    total = sum(code.values())
+    categories, instantiations = attribute(code)
+    print(f"Code size: {total} bytes in {len(code)} symbols")
+    for category, size in categories.most_common():
+        count = sum(1 for c, _ in instantiations if c == category)
+        print(f"  {category:<26} {size:>10} bytes {size / total:6.1%} {count:>7} entries")
+
+    for category in ("cpp_function::initialize", "casters"):
+        entries = sorted(
+            ((size, n, key) for (c, key), (size, n) in instantiations.items() if c == category),
+            reverse=True,
+        )
+        print(f"\nLargest {category} instantiations:")
+        print(f"  {'bytes':>8} {'symbols':>7}  instantiation")
+        for size, n, key in entries[: args.top]:
+            print(f"  {size:>8} {n:>7}  {shorten(key, args.width)}")
+
+    # The bytes compiled again for each additional translation unit defining the same body
+    duplicates = []
+    for name, per_object in weak.items():
+        size = max(per_object.values())
+        if len(per_object) > 1 and size > 0:
+            duplicates.append((size * (len(per_object) - 1), len(per_object), size, name))
+    duplicates.sort(reverse=True)
+    if objects:
+        wasted = sum(d[0] for d in duplicates)
+        print(
+            f"\nInline and template functions compiled in several of the {len(objects)} objects: "
+            f"{len(duplicates)} symbols, {wasted} bytes of duplicated code"
+        )
+        print(f"  {'extra':>8} {'objects':>7} {'bytes':>8}  symbol")
+        for extra, n, size, name in duplicates[: args.top]:
+            print(f"  {extra:>8} {n:>7} {size:>8}  {shorten(name, args.width)}")
+
+    if args.json:
+        result = {
+            "total": total,
+            "categories": dict(categories),
+            "instantiations": [
+                {"category": c, "name": key, "bytes": size, "symbols": n}
+                for (c, key), (size, n) in sorted(
+                    instantiations.items(), key=lambda item: -item[1][0]
+                )
+            ],
+            "duplicates": [
+                {"name": name, "objects": n, "bytes": size, "extra_bytes": extra}
+                for extra, n, size, name in duplicates
+            ],
+        }
+        with open(args.json, "w") as f:
+            json.dump(result, f, indent=2)
+            f.write("\n")
+
+
+if __name__ == "__main__":
+    main()